@@ -239,6 +239,83 @@ extern "C" {
 
 // #line 7 "ev.c"
 ////////////////////////////////////////////////////////////////////////////////
+// FILE:    ev/allocator_internal.h
+// SIZE:    2215
+// SHA-256: 99ff3cc68a117e95fe601fd7ceb8c4e96167f91db86be80ea26288eddd025c60
+////////////////////////////////////////////////////////////////////////////////
+// #line 1 "ev/allocator_internal.h"
+#ifndef __EV_ALLOCATOR_INTERNAL_H__
+#define __EV_ALLOCATOR_INTERNAL_H__
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Allocate memory from global allocator.
+ * @param[in] type  Memory category.
+ * @param[in] size  Memory size.
+ * @return          Memory address, or NULL if failure. Use #ev_free() to
+ *   release it.
+ */
+EV_LOCAL void *ev__malloc(ev_allocator_type_t type, size_t size);
+
+/**
+ * @brief Allocate zero-initialized memory from global allocator.
+ * @param[in] type  Memory category.
+ * @param[in] nmemb Number of elements.
+ * @param[in] size  Element size.
+ * @return          Memory address, or NULL if failure. Use #ev_free() to
+ *   release it.
+ */
+EV_LOCAL void *ev__calloc(ev_allocator_type_t type, size_t nmemb, size_t size);
+
+/**
+ * @brief Duplicate string by global allocator.
+ * @param[in] type  Memory category.
+ * @param[in] str   String to duplicate.
+ * @return          Duplicated string, or NULL if failure. Use #ev_free() to
+ *   release it.
+ */
+EV_LOCAL char *ev__strdup_ext(ev_allocator_type_t type, const char *str);
+
+/**
+ * @brief Allocate memory from loop local allocator.
+ * @param[in] loop  Event loop. If NULL or the loop does not have a local
+ *   allocator, the global allocator is used.
+ * @param[in] type  Memory category.
+ * @param[in] size  Memory size.
+ * @return          Memory address, or NULL if failure.
+ */
+EV_LOCAL void *ev__loop_malloc(ev_loop_t *loop, ev_allocator_type_t type,
+                               size_t size);
+
+/**
+ * @brief Allocate zero-initialized memory from loop local allocator.
+ * @see ev__loop_malloc()
+ * @param[in] loop  Event loop.
+ * @param[in] type  Memory category.
+ * @param[in] nmemb Number of elements.
+ * @param[in] size  Element size.
+ * @return          Memory address, or NULL if failure.
+ */
+EV_LOCAL void *ev__loop_calloc(ev_loop_t *loop, ev_allocator_type_t type,
+                               size_t nmemb, size_t size);
+
+/**
+ * @brief Release memory allocated by #ev__loop_malloc() or
+ *   #ev__loop_calloc().
+ * @param[in] loop  Event loop. Must be the same one used for allocate.
+ * @param[in] ptr   Memory address.
+ */
+EV_LOCAL void ev__loop_free(ev_loop_t *loop, void *ptr);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
+
+// #line 8 "ev.c"
+////////////////////////////////////////////////////////////////////////////////
 // FILE:    ev/assert_internal.h
 // SIZE:    1706
 // SHA-256: 427a0c0d9101908de67717a2facc7388994953797b06d53b1683dda2f3284567
@@ -305,7 +382,7 @@ EV_LOCAL void ev__assertion_failure(const char* exp, const char* file, int line,
 #endif
 #endif
 
-// #line 8 "ev.c"
+// #line 9 "ev.c"
 ////////////////////////////////////////////////////////////////////////////////
 // FILE:    ev/async_internal.h
 // SIZE:    657
@@ -339,7 +416,7 @@ EV_LOCAL void ev__async_exit_force(ev_async_t *handle);
 #endif
 #endif
 
-// #line 9 "ev.c"
+// #line 10 "ev.c"
 ////////////////////////////////////////////////////////////////////////////////
 // FILE:    ev/atomic_internal.h
 // SIZE:    221
@@ -362,11 +439,73 @@ EV_LOCAL void ev__atomic_exit(void);
 #endif
 #endif
 
-// #line 10 "ev.c"
+// #line 11 "ev.c"
+////////////////////////////////////////////////////////////////////////////////
+// FILE:    ev/dns_internal.h
+// SIZE:    1742
+// SHA-256: c4d46e09be607171e69969f437fc01b9f7867df3362cdc4ca6ad24701e22fee6
+////////////////////////////////////////////////////////////////////////////////
+// #line 1 "ev/dns_internal.h"
+#ifndef __EV_DNS_INTERNAL_H__
+#define __EV_DNS_INTERNAL_H__
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Resolver cache entry.
+ *
+ * An entry is shared by every request with the same arguments. While the
+ * lookup is in progress, new requests wait in \p wait_queue.
+ */
+typedef struct ev_getaddrinfo_entry
+{
+    ev_map_node_t  node;       /**< #ev_loop_t::dns::cache */
+    ev_list_node_t age;        /**< #ev_loop_t::dns::age */
+    ev_work_t      token;      /**< Thread pool token */
+    ev_list_t      wait_queue; /**< #ev_getaddrinfo_t::node. Waiting requests */
+    ev_loop_t     *loop;       /**< Event loop */
+
+    const char *host;     /**< Host name, stored after this structure */
+    const char *service;  /**< Service name, stored after this structure */
+    int         flags;    /**< #addrinfo::ai_flags */
+    int         family;   /**< #addrinfo::ai_family */
+    int         socktype; /**< #addrinfo::ai_socktype */
+    int         protocol; /**< #addrinfo::ai_protocol */
+
+    struct addrinfo *res;     /**< Lookup result */
+    int              status;  /**< #ev_errno_t, system error in thread pool */
+    int              pending; /**< Lookup is in progress */
+    int              cached;  /**< Entry is in cache */
+    size_t           refcnt;  /**< Reference count */
+    uint64_t         expire;  /**< Expire time */
+} ev_getaddrinfo_entry_t;
+
+/**
+ * @brief Initialize resolver context.
+ * @param[out] loop Event loop
+ */
+EV_LOCAL void ev__init_dns(ev_loop_t *loop);
+
+/**
+ * @brief Release resolver cache.
+ *
+ * Entries still referenced by requests are released when the requests finish.
+ *
+ * @param[in] loop  Event loop
+ */
+EV_LOCAL void ev__exit_dns(ev_loop_t *loop);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
+
+// #line 12 "ev.c"
 ////////////////////////////////////////////////////////////////////////////////
 // FILE:    ev/handle_internal.h
-// SIZE:    4036
-// SHA-256: 41b14a8f0d8cbb8cc9907aa2d0c27af34b45f0fd7c46e356be64dffcff190d78
+// SIZE:    4484
+// SHA-256: 002ef9bec06ef0d37e0b77bf5a630ec856a277a2b4754860e12a46ae067b2bbc
 ////////////////////////////////////////////////////////////////////////////////
 // #line 1 "ev/handle_internal.h"
 #ifndef __EV_HANDLE_INTERNAL_H__
@@ -381,6 +520,7 @@ typedef enum ev_handle_flag
     EV_HANDLE_CLOSING           = 0x01 << 0x00,     /**< 1. Handle is going to close */
     EV_HANDLE_CLOSED            = 0x01 << 0x01,     /**< 2. Handle is closed */
     EV_HANDLE_ACTIVE            = 0x01 << 0x02,     /**< 4. Handle is busy */
+    EV_HANDLE_INPLACE           = 0x01 << 0x03,     /**< 8. Handle memory is owned by user */
 
     /* #EV_ROLE_EV_TCP */
     EV_HANDLE_TCP_LISTING       = 0x01 << 0x08,     /**< 256. This is a listen socket and is listening */
@@ -394,10 +534,15 @@ typedef enum ev_handle_flag
     EV_HANDLE_UDP_CONNECTED     = 0x01 << 0x09,     /**< 512. This socket is connected */
     EV_HANDLE_UDP_BOUND         = 0x01 << 0x0A,     /**< 1024. Socket is bond to address */
     EV_HANDLE_UDP_BYPASS_IOCP   = 0x01 << 0x0B,     /**< 2048. FILE_SKIP_SET_EVENT_ON_HANDLE | FILE_SKIP_COMPLETION_PORT_ON_SUCCESS */
+    EV_HANDLE_UDP_NO_GSO        = 0x01 << 0x0C,     /**< 4096. UDP_SEGMENT rejected by route, send segments one by one */
 
     /* #EV_ROLE_EV_PIPE */
     EV_HANDLE_PIPE_IPC          = 0x01 << 0x08,     /**< 256. This pipe is support IPC */
     EV_HANDLE_PIPE_STREAMING    = 0x01 << 0x09,     /**< 512. This pipe is initialized by #ev_stream_t */
+
+    /* #EV_ROLE_EV_SHM_CHANNEL */
+    EV_HANDLE_SHM_CHANNEL_SENDER = 0x01 << 0x08,    /**< 256. Opened by #ev_shm_channel_open() */
+    EV_HANDLE_SHM_CHANNEL_BROKEN = 0x01 << 0x09,    /**< 512. Ring is corrupted, stop receiving */
 } ev_handle_flag_t;
 
 /**
@@ -481,11 +626,11 @@ EV_LOCAL size_t ev__process_endgame(ev_loop_t* loop);
 #endif
 #endif
 
-// #line 11 "ev.c"
+// #line 13 "ev.c"
 ////////////////////////////////////////////////////////////////////////////////
 // FILE:    ev/loop_internal.h
-// SIZE:    3692
-// SHA-256: 7fe057f7482c9dfdd6f873d3c1a03209f4d21189d5ce97f09a1c106c071521ac
+// SIZE:    4314
+// SHA-256: dac4c43c20a2e4a03efb6b95105a819afc323a4aa8ceaab4368ccf61637d20ea
 ////////////////////////////////////////////////////////////////////////////////
 // #line 1 "ev/loop_internal.h"
 #ifndef __EV_LOOP_INTERNAL_H__
@@ -497,6 +642,7 @@ extern "C" {
 typedef enum ev_ipc_frame_flag
 {
     EV_IPC_FRAME_FLAG_INFORMATION = 1,
+    EV_IPC_FRAME_FLAG_HANDLE = 2, /**< Frame carries a handle (Unix) */
 } ev_ipc_frame_flag_t;
 
 /**
@@ -532,6 +678,21 @@ struct ev_loop
         ev_list_t   work_queue; /**< Work queue */
     } threadpool;
 
+    struct
+    {
+        ev_map_t  cache;    /**< #ev_getaddrinfo_entry_t::node. Resolver cache */
+        ev_list_t age;      /**< #ev_getaddrinfo_entry_t::age. Oldest first */
+        size_t    cache_sz; /**< Number of cache entries */
+        uint64_t  ttl;      /**< TTL of resolved names */
+        uint64_t  neg_ttl;  /**< TTL of names that do not exist */
+    } dns;
+
+    struct
+    {
+        ev_loop_realloc_fn fn;  /**< Loop local allocator, NULL for global */
+        void              *arg; /**< User defined argument */
+    } allocator;
+
     struct
     {
         unsigned b_stop : 1; /**< Flag: need to stop */
@@ -633,7 +794,7 @@ EV_LOCAL void ev__poll(ev_loop_t *loop, uint32_t timeout);
 #endif
 #endif
 
-// #line 12 "ev.c"
+// #line 14 "ev.c"
 ////////////////////////////////////////////////////////////////////////////////
 // FILE:    ev/fs_internal.h
 // SIZE:    3915
@@ -763,7 +924,7 @@ EV_LOCAL int ev__fs_remove(const char* path, int recursive);
 #endif
 #endif
 
-// #line 13 "ev.c"
+// #line 15 "ev.c"
 ////////////////////////////////////////////////////////////////////////////////
 // FILE:    ev/misc_internal.h
 // SIZE:    767
@@ -805,11 +966,11 @@ EV_LOCAL void ev__backend_shutdown(void);
 #endif
 #endif
 
-// #line 14 "ev.c"
+// #line 16 "ev.c"
 ////////////////////////////////////////////////////////////////////////////////
 // FILE:    ev/pipe_internal.h
-// SIZE:    3341
-// SHA-256: 667e85a7dfe0d5005204802b13581dea97d718d58eaa23117b184787c2688fa3
+// SIZE:    3504
+// SHA-256: 7720500a7dc91f379d87a53b69765898b6a669a1975e288d1f98f451bcbfe849
 ////////////////////////////////////////////////////////////////////////////////
 // #line 1 "ev/pipe_internal.h"
 #ifndef __EV_PIPE_INTERNAL_H__
@@ -828,10 +989,9 @@ typedef struct ev_pipe_write_req
     void            *ucb_arg; /**< User defined argument. */
     struct
     {
-        ev_role_t role; /**< The type of handle to send */
-        union {
-            ev_os_socket_t os_socket; /**< A EV handle instance */
-        } u;
+        ev_role_t      role; /**< The type of handles to send */
+        size_t         num;  /**< Number of handles to send */
+        ev_os_socket_t os_socket[EV_PIPE_IPC_HANDLE_MAX]; /**< Handles */
     } handle;
     EV_PIPE_WRITE_BACKEND backend; /**< Backend */
 } ev_pipe_write_req_t;
@@ -880,32 +1040,34 @@ EV_LOCAL int ev__pipe_write_init(ev_pipe_write_req_t *req, ev_buf_t *bufs,
  * ownership of \p iov_bufs, so you cannot modify or free \p iov_bufs until \p
  * callback is called.
  *
- *   + Need to transfer a handle to peer.<br>
- *     In this case you should set the type of handle via \p handle_role and
- * pass the address of the handle via \p handle_addr. \p req does not take the
- * ownership of the handle, but the handle should not be closed or destroy until
- * \p callback is called.
+ *   + Need to transfer handles to peer.<br>
+ *     In this case you should set the type of handles via \p handle_role and
+ * pass the address list of handles via \p handle_addrs. \p req does not take
+ * the ownership of the handles, but the handles should not be closed or destroy
+ * until \p callback is called.
  *
  * @param[out] req          A write request to be initialized
  * @param[in] cb            Write complete callback
  * @param[in] arg           User defined argument.
  * @param[in] bufs          Buffer list
  * @param[in] nbuf          Buffer list size
- * @param[in] handle_role   The type of handle to send
- * @param[in] handle_addr   The address of handle to send
+ * @param[in] handle_role   The type of handles to send
+ * @param[in] handle_addrs  The address list of handles to send
+ * @param[in] handle_num    Number of handles
  * @return                  #ev_errno_t
  */
 EV_LOCAL int ev__pipe_write_init_ext(ev_pipe_write_req_t *req,
                                      ev_pipe_write_cb cb, void *arg,
                                      ev_buf_t *bufs, size_t nbuf,
-                                     ev_role_t handle_role, void *handle_addr);
+                                     ev_role_t handle_role, void **handle_addrs,
+                                     size_t handle_num);
 
 #ifdef __cplusplus
 }
 #endif
 #endif
 
-// #line 15 "ev.c"
+// #line 17 "ev.c"
 ////////////////////////////////////////////////////////////////////////////////
 // FILE:    ev/ringbuffer.h
 // SIZE:    7166
@@ -1119,7 +1281,275 @@ EV_LOCAL ring_buffer_token_t* ring_buffer_next(const ring_buffer_t* handler,
 #endif
 #endif
 
-// #line 16 "ev.c"
+// #line 18 "ev.c"
+////////////////////////////////////////////////////////////////////////////////
+// FILE:    ev/shm_channel_internal.h
+// SIZE:    471
+// SHA-256: d218928a0c739e399815b0f26eaffca936dab8d74616c5b4d7e7269bbdb7b903
+////////////////////////////////////////////////////////////////////////////////
+// #line 1 "ev/shm_channel_internal.h"
+#ifndef __EV_SHM_CHANNEL_INTERNAL_H__
+#define __EV_SHM_CHANNEL_INTERNAL_H__
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Get doorbell of receiving channel to share with peer.
+ * @param[in] chan  Channel created by #ev_shm_channel_init().
+ * @param[out] fd   Doorbell
+ * @return          #ev_errno_t
+ */
+EV_LOCAL int ev__shm_channel_doorbell(ev_shm_channel_t *chan,
+                                      ev_os_socket_t   *fd);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
+
+// #line 19 "ev.c"
+////////////////////////////////////////////////////////////////////////////////
+// FILE:    ev/tcp_internal.h
+// SIZE:    7592
+// SHA-256: 982f568646e940c6a0aa7b21b608848151fa699e52fa2752b3b2ec33283e417f
+////////////////////////////////////////////////////////////////////////////////
+// #line 1 "ev/tcp_internal.h"
+#ifndef __EV_TCP_INTERNAL_H__
+#define __EV_TCP_INTERNAL_H__
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Default number of connections accepted in one round by
+ *   #ev_tcp_accept_start().
+ */
+#define EV_TCP_ACCEPT_BUDGET    64
+
+/**
+ * @brief Number of #ev_tcp_opt_t.
+ */
+#define EV_TCP_OPT_CNT          9
+
+/**
+ * @brief Socket options of #ev_tcp_t.
+ */
+typedef struct ev_tcp_opts
+{
+    unsigned mask;                 /**< Bit set of options set by user */
+    unsigned pending;              /**< Bit set of options not applied yet */
+    int      val[EV_TCP_OPT_CNT];  /**< Option values */
+} ev_tcp_opts_t;
+
+/**
+ * @brief Handle recycling state for #ev_tcp_t.
+ *
+ * A connection handle uses #ev_tcp_recycle_t::owner and
+ * #ev_tcp_recycle_t::node, a listen socket uses the rest.
+ */
+typedef struct ev_tcp_recycle
+{
+    ev_tcp_t      *owner; /**< Listen socket this handle is returned to */
+    ev_list_node_t node;  /**< Node for #ev_tcp_recycle_t::idle_queue or
+                             #ev_tcp_recycle_t::busy_queue */
+
+    ev_list_t idle_queue; /**< (#ev_tcp_recycle_t::node) Closed handles */
+    ev_list_t busy_queue; /**< (#ev_tcp_recycle_t::node) Handles in use */
+    size_t    capacity;   /**< Max size of idle_queue */
+} ev_tcp_recycle_t;
+
+/**
+ * @brief Acquire request of #ev_tcp_pool_acquire().
+ */
+typedef struct ev_tcp_pool_req
+{
+    ev_list_node_t node; /**< Node for #ev_tcp_pool_host_t::wait_queue or
+                            #ev_tcp_pool::cancel_queue */
+    ev_tcp_pool_cb cb;   /**< Acquire callback */
+    void          *arg;  /**< User defined argument */
+    int            stat; /**< Failure to report */
+} ev_tcp_pool_req_t;
+
+/**
+ * @brief State of pooled connection.
+ */
+typedef enum ev_tcp_pool_state
+{
+    EV_TCP_POOL_BUSY = 0,   /**< Handed out to user */
+    EV_TCP_POOL_CONNECTING, /**< Connecting for an acquire */
+    EV_TCP_POOL_READY,      /**< Waiting to be handed out */
+    EV_TCP_POOL_IDLE,       /**< Kept in pool */
+} ev_tcp_pool_state_t;
+
+/**
+ * @brief Connection pool state for #ev_tcp_t.
+ */
+typedef struct ev_tcp_pool_link
+{
+    struct ev_tcp_pool_host *host;  /**< Owner, NULL if not from a pool */
+    ev_tcp_pool_state_t      state; /**< Connection state */
+    ev_list_node_t           node;  /**< Node for
+                                       #ev_tcp_pool_host_t::idle_queue or
+                                       #ev_tcp_pool_host_t::busy_queue */
+    ev_list_node_t           rnode; /**< Node for #ev_tcp_pool::ready_queue */
+    uint64_t                 since; /**< Time in milliseconds it becomes idle */
+    ev_tcp_pool_req_t       *req;   /**< Acquire to finish, if connecting or
+                                       ready */
+} ev_tcp_pool_link_t;
+
+/**
+ * @brief Connections to one peer address.
+ */
+typedef struct ev_tcp_pool_host
+{
+    ev_map_node_t           node;    /**< Node for #ev_tcp_pool::hosts */
+    struct ev_tcp_pool     *pool;    /**< Pool */
+    struct sockaddr_storage addr;    /**< Peer address */
+    size_t                  addr_sz; /**< Peer address size */
+
+    ev_list_t idle_queue; /**< (#ev_tcp_pool_link_t::node) Idle connections,
+                             newest at back */
+    ev_list_t busy_queue; /**< (#ev_tcp_pool_link_t::node) Connections not
+                             idle */
+    ev_list_t wait_queue; /**< (#ev_tcp_pool_req_t::node) Acquires waiting
+                             for a free slot */
+} ev_tcp_pool_host_t;
+
+struct ev_tcp_pool
+{
+    ev_loop_t         *loop;     /**< Event loop */
+    ev_tcp_pool_opts_t opts;     /**< Options */
+    ev_map_t           hosts;    /**< (#ev_tcp_pool_host_t::node) Hosts */
+    size_t             idle_cnt; /**< Idle connections of all hosts */
+    int                closing;  /**< #ev_tcp_pool_exit() is called */
+    int                timer_cnt; /**< Timers not closed yet */
+
+    ev_list_t ready_queue;  /**< (#ev_tcp_pool_link_t::rnode) Connections to
+                               hand out */
+    ev_list_t cancel_queue; /**< (#ev_tcp_pool_req_t::node) Acquires to
+                               cancel once the pool is closed */
+
+    ev_timer_t *ready_timer; /**< Hands out ready connections */
+    ev_timer_t *idle_timer;  /**< Closes expired idle connections */
+};
+
+struct ev_tcp_sampler
+{
+    ev_timer_t        *timer; /**< Sample timer */
+    ev_tcp_sampler_cb  cb;    /**< Sampler callback */
+    void              *arg;   /**< User defined argument. */
+    ev_tcp_info_stat_t stat;  /**< Statistics of last round */
+};
+
+/**
+ * @brief Reset \p sock and link it to \p loop.
+ * @note Platform related.
+ * @param[in] loop  Event loop
+ * @param[in] sock  TCP handle
+ */
+EV_LOCAL void ev__tcp_init(ev_loop_t *loop, ev_tcp_t *sock);
+
+/**
+ * @brief Get native level and name of socket option.
+ * @note Platform related.
+ * @param[in] opt       Option
+ * @param[out] level    Option level
+ * @param[out] name     Option name
+ * @return              #ev_errno_t. #EV_ENOSYS if not supported.
+ */
+EV_LOCAL int ev__tcp_opt_native(ev_tcp_opt_t opt, int *level, int *name);
+
+/**
+ * @brief Set int socket option.
+ * @note Platform related.
+ * @return  #ev_errno_t
+ */
+EV_LOCAL int ev__tcp_setsockopt(ev_os_socket_t sock, int level, int name,
+                                int val);
+
+/**
+ * @brief Get int socket option.
+ * @note Platform related.
+ * @return  #ev_errno_t
+ */
+EV_LOCAL int ev__tcp_getsockopt(ev_os_socket_t sock, int level, int name,
+                                int *val);
+
+/**
+ * @brief Check whether an idle connection is still usable.
+ * @note Platform related.
+ * @param[in] sock  Connected socket
+ * @return          #EV_SUCCESS if nothing is received, #EV_EOF if peer closed
+ *                  the connection, #EV_EPROTO if data is received, or
+ *                  #ev_errno_t.
+ */
+EV_LOCAL int ev__tcp_probe(ev_os_socket_t sock);
+
+/**
+ * @brief Initialize socket options.
+ * @param[in] sock  TCP handle
+ */
+EV_LOCAL void ev__tcp_opts_init(ev_tcp_t *sock);
+
+/**
+ * @brief Apply pending socket options.
+ * @param[in] sock      TCP handle with valid socket.
+ * @param[in] listen    Non-zero to apply listen socket only options.
+ * @return              #ev_errno_t
+ */
+EV_LOCAL int ev__tcp_opts_apply(ev_tcp_t *sock, int listen);
+
+/**
+ * @brief Give socket options of listen socket to accepted connection.
+ *
+ * Errors are ignored as the options are known good on \p lisn.
+ *
+ * @param[in] conn      Accepted connection.
+ * @param[in] lisn      Listen socket.
+ * @param[in] by_kernel Non-zero if the kernel already copied options that it
+ *                      can inherit.
+ */
+EV_LOCAL void ev__tcp_opts_inherit(ev_tcp_t *conn, ev_tcp_t *lisn,
+                                   int by_kernel);
+
+/**
+ * @brief Initialize recycling state.
+ * @param[in] sock  TCP handle
+ */
+EV_LOCAL void ev__tcp_recycle_init(ev_tcp_t *sock);
+
+/**
+ * @brief Give closed handle back to its listen socket.
+ * @param[in] sock  TCP handle that has finished closing.
+ * @return          Non-zero if \p sock is taken and must not be freed.
+ */
+EV_LOCAL int ev__tcp_recycle(ev_tcp_t *sock);
+
+/**
+ * @brief Initialize connection pool state.
+ * @param[in] sock  TCP handle
+ */
+EV_LOCAL void ev__tcp_pool_link_init(ev_tcp_t *sock);
+
+/**
+ * @brief Remove closed handle from its connection pool.
+ * @param[in] sock  TCP handle that has finished closing.
+ */
+EV_LOCAL void ev__tcp_pool_unlink(ev_tcp_t *sock);
+
+/**
+ * @brief Release all kept handles and detach handles in use.
+ * @param[in] lisn  Listen socket that has finished closing.
+ */
+EV_LOCAL void ev__tcp_recycle_exit(ev_tcp_t *lisn);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
+
+// #line 20 "ev.c"
 ////////////////////////////////////////////////////////////////////////////////
 // FILE:    ev/threadpool.h
 // SIZE:    4459
@@ -1266,11 +1696,11 @@ EV_LOCAL void ev__threadpool_wakeup(ev_loop_t *loop);
 #endif
 #endif
 
-// #line 17 "ev.c"
+// #line 21 "ev.c"
 ////////////////////////////////////////////////////////////////////////////////
 // FILE:    ev/timer_internal.h
-// SIZE:    950
-// SHA-256: e146c81688cdaced6a8d99c02ef2b6d6f1471018f57f07fee48588f6e521f1bb
+// SIZE:    1199
+// SHA-256: bd66e9a4bf2c358cb4267ea7a061866eb370a725db7fb675080b7a0cbac42688
 ////////////////////////////////////////////////////////////////////////////////
 // #line 1 "ev/timer_internal.h"
 #ifndef __EV_TIMER_INTERNAL_H__
@@ -1301,6 +1731,14 @@ struct ev_timer
     } attr;
 };
 
+struct ev_idle_timer
+{
+    ev_timer_t timer;   /**< Expire timer */
+    ev_list_t  queue;   /**< #ev_idle_token_t::node. Ordered by last activity */
+    uint64_t   timeout; /**< Idle timeout */
+    int        closing; /**< Manager is closing */
+};
+
 /**
  * @brief Initialize timer context.
  * @param[out] loop Event loop
@@ -1319,7 +1757,7 @@ EV_LOCAL size_t ev__process_timer(ev_loop_t *loop);
 #endif
 #endif
 
-// #line 18 "ev.c"
+// #line 22 "ev.c"
 ////////////////////////////////////////////////////////////////////////////////
 // FILE:    ev/log.h
 // SIZE:    1247
@@ -1377,11 +1815,11 @@ EV_LOCAL void ev__dump_hex(const void* data, size_t size, size_t width);
 #endif
 #endif
 
-// #line 19 "ev.c"
+// #line 23 "ev.c"
 ////////////////////////////////////////////////////////////////////////////////
 // FILE:    ev/udp_internal.h
-// SIZE:    2409
-// SHA-256: bb8ef03cf6461c6ce077c2155320f3cc910b5ab89e5555bb85afd7f62396a8c2
+// SIZE:    2665
+// SHA-256: 9bbec6b51d048a8e7f5acad804f140f06a2932fc7e4949f29f138d94df20cead
 ////////////////////////////////////////////////////////////////////////////////
 // #line 1 "ev/udp_internal.h"
 #ifndef __EV_UDP_INTERNAL_H__
@@ -1390,6 +1828,16 @@ EV_LOCAL void ev__dump_hex(const void* data, size_t size, size_t width);
 extern "C" {
 #endif
 
+/**
+ * @brief Max payload of one UDP datagram.
+ */
+#define EV_UDP_GSO_MAX_SIZE     65507
+
+/**
+ * @brief Max segments of one GSO send.
+ */
+#define EV_UDP_GSO_MAX_SEGMENTS 64
+
 /**
  * @brief Read request token for UDP socket.
  */
@@ -1412,6 +1860,7 @@ typedef struct ev_udp_write
     ev_write_t           base;       /**< Base request */
     ev_udp_write_cb      usr_cb;     /**< User callback */
     void                *usr_cb_arg; /**< User defined argument */
+    size_t               seg_size;   /**< GSO segment size, 0 if not segmented */
     EV_UDP_WRITE_BACKEND backend;    /**< Backend */
 } ev_udp_write_t;
 
@@ -1462,7 +1911,7 @@ EV_LOCAL int ev__udp_send(ev_udp_t *udp, ev_udp_write_t *req,
 #endif
 #endif
 
-// #line 20 "ev.c"
+// #line 24 "ev.c"
 
 #if defined(_WIN32)
 
@@ -1978,7 +2427,7 @@ EV_LOCAL void ev__winapi_init(void);
 #endif
 #endif
 
-// #line 24 "ev.c"
+// #line 28 "ev.c"
 ////////////////////////////////////////////////////////////////////////////////
 // FILE:    ev/win/winsock.h
 // SIZE:    2168
@@ -2064,7 +2513,7 @@ EV_LOCAL int ev__ntstatus_to_winsock_error(NTSTATUS status);
 #endif
 #endif
 
-// #line 25 "ev.c"
+// #line 29 "ev.c"
 ////////////////////////////////////////////////////////////////////////////////
 // FILE:    ev/win/async_win.h
 // SIZE:    147
@@ -2082,7 +2531,7 @@ extern "C" {
 #endif
 #endif
 
-// #line 26 "ev.c"
+// #line 30 "ev.c"
 ////////////////////////////////////////////////////////////////////////////////
 // FILE:    ev/win/fs_win.h
 // SIZE:    914
@@ -2123,7 +2572,7 @@ EV_LOCAL int ev__fs_readdir_w(const WCHAR* path, ev_readdir_w_cb cb, void* arg);
 #endif
 #endif
 
-// #line 27 "ev.c"
+// #line 31 "ev.c"
 ////////////////////////////////////////////////////////////////////////////////
 // FILE:    ev/win/time_win.h
 // SIZE:    219
@@ -2146,7 +2595,7 @@ void ev__time_init_win(void);
 #endif
 #endif
 
-// #line 28 "ev.c"
+// #line 32 "ev.c"
 ////////////////////////////////////////////////////////////////////////////////
 // FILE:    ev/win/udp_win.h
 // SIZE:    143
@@ -2164,7 +2613,7 @@ extern "C" {
 #endif
 #endif
 
-// #line 29 "ev.c"
+// #line 33 "ev.c"
 ////////////////////////////////////////////////////////////////////////////////
 // FILE:    ev/win/loop_win.h
 // SIZE:    1491
@@ -2230,7 +2679,7 @@ EV_LOCAL int ev__ipv6only_win(SOCKET sock, int opt);
 #endif
 #endif
 
-// #line 30 "ev.c"
+// #line 34 "ev.c"
 ////////////////////////////////////////////////////////////////////////////////
 // FILE:    ev/win/process_win.h
 // SIZE:    151
@@ -2248,7 +2697,7 @@ extern "C" {
 #endif
 #endif
 
-// #line 31 "ev.c"
+// #line 35 "ev.c"
 ////////////////////////////////////////////////////////////////////////////////
 // FILE:    ev/win/pipe_win.h
 // SIZE:    145
@@ -2266,7 +2715,7 @@ extern "C" {
 #endif
 #endif
 
-// #line 32 "ev.c"
+// #line 36 "ev.c"
 ////////////////////////////////////////////////////////////////////////////////
 // FILE:    ev/win/shmem_win.h
 // SIZE:    486
@@ -2299,7 +2748,7 @@ struct ev_shmem
 #endif
 #endif
 
-// #line 33 "ev.c"
+// #line 37 "ev.c"
 ////////////////////////////////////////////////////////////////////////////////
 // FILE:    ev/win/misc_win.h
 // SIZE:    1419
@@ -2351,7 +2800,7 @@ EV_LOCAL void ev__fatal_syscall(const char *file, int line, DWORD errcode,
 
 #endif
 
-// #line 34 "ev.c"
+// #line 38 "ev.c"
 ////////////////////////////////////////////////////////////////////////////////
 // FILE:    ev/win/threadpool_win.h
 // SIZE:    270
@@ -2372,11 +2821,11 @@ EV_LOCAL void ev__threadpool_exit_win(ev_loop_t* loop);
 #endif
 #endif
 
-// #line 35 "ev.c"
+// #line 39 "ev.c"
 ////////////////////////////////////////////////////////////////////////////////
 // FILE:    ev/win/tcp_win.h
-// SIZE:    3451
-// SHA-256: 802e0aa6574a8841dd1f7cbe69d0413258c3f817a2e1404531a85e075bc64c4e
+// SIZE:    3777
+// SHA-256: 1f6ea1510ea7f36d29023e725a1fbd5448ab78a2c9a7d42cc8dd108037001403
 ////////////////////////////////////////////////////////////////////////////////
 // #line 1 "ev/win/tcp_win.h"
 #ifndef __EV_TCP_WIN_INTERNAL_H__
@@ -2403,6 +2852,8 @@ typedef struct ev_tcp_backend
                 a_queue; /**< (#ev_tcp_backend::u::accept::node) Accept queue */
             ev_list_t a_queue_done; /**< (#ev_tcp_backend::u::accept::node)
                                        Accept done queue */
+            ev_tcp_accept_cb on_conn;     /**< Connection callback */
+            void            *on_conn_arg; /**< User defined argument */
         } listen;
         struct
         {
@@ -2438,11 +2889,14 @@ typedef struct ev_tcp_backend
 
 struct ev_tcp
 {
-    ev_handle_t      base;      /**< Base object */
-    ev_tcp_close_cb  close_cb;  /**< User close callback */
-    void            *close_arg; /**< User defined argument. */
-    ev_os_socket_t   sock;      /**< Socket handle */
-    ev_tcp_backend_t backend;   /**< Platform related implementation */
+    ev_handle_t        base;      /**< Base object */
+    ev_tcp_close_cb    close_cb;  /**< User close callback */
+    void              *close_arg; /**< User defined argument. */
+    ev_os_socket_t     sock;      /**< Socket handle */
+    ev_tcp_recycle_t   recycle;   /**< Handle recycling */
+    ev_tcp_opts_t      opts;      /**< Socket options */
+    ev_tcp_pool_link_t pool;      /**< Connection pool */
+    ev_tcp_backend_t   backend;   /**< Platform related implementation */
 };
 
 /**
@@ -2487,12 +2941,12 @@ EV_LOCAL int ev__tcp_open_win(ev_tcp_t *tcp, SOCKET fd);
 #endif
 #endif
 
-// #line 36 "ev.c"
+// #line 40 "ev.c"
 
 ////////////////////////////////////////////////////////////////////////////////
 // FILE:    ev/win/async_win.c
-// SIZE:    2078
-// SHA-256: f99598e05a6c5193a28466eb266541536ae754c8e8be771b8a06aeae0266627a
+// SIZE:    2904
+// SHA-256: ef43042c883ea759ac9d220b7719f14c2082a7a09512cf07a5adc3899296109c
 ////////////////////////////////////////////////////////////////////////////////
 // #line 1 "ev/win/async_win.c"
 #include <assert.h>
@@ -2509,9 +2963,13 @@ static void _async_on_iocp_win(ev_iocp_t* iocp, size_t transferred, void* arg)
 static void _ev_async_on_close_win(ev_handle_t* handle)
 {
     ev_async_t* async = EV_CONTAINER_OF(handle, ev_async_t, base);
+    ev_loop_t* loop = async->base.loop;
     ev_async_cb close_cb = async->close_cb;
     void* close_arg = async->close_arg;
-    ev_free(async);
+    if (!(async->base.data.flags & EV_HANDLE_INPLACE))
+    {
+        ev__loop_free(loop, async);
+    }
 
     if (close_cb != NULL)
     {
@@ -2532,7 +2990,10 @@ static void _ev_asyc_exit_win(ev_async_t* handle, ev_async_cb close_cb,
     else
     {
         ev__handle_exit(&handle->base, NULL);
-        ev_free(handle);
+        if (!(handle->base.data.flags & EV_HANDLE_INPLACE))
+        {
+            ev__loop_free(handle->base.loop, handle);
+        }
     }
 }
 
@@ -2541,24 +3002,48 @@ EV_LOCAL void ev__async_exit_force(ev_async_t* handle)
     _ev_asyc_exit_win(handle, NULL, NULL);
 }
 
+static void _ev_async_init_win(ev_loop_t* loop, ev_async_t* handle,
+    ev_async_cb activate_cb, void* activate_arg)
+{
+    handle->activate_cb = activate_cb;
+    handle->activate_arg = activate_arg;
+    handle->close_cb = NULL;
+    handle->close_arg = NULL;
+    handle->backend.async_sent = 0;
+
+    ev__iocp_init(&handle->backend.io, _async_on_iocp_win, NULL);
+    ev__handle_init(loop, &handle->base, EV_ROLE_EV_ASYNC);
+    ev__handle_active(&handle->base);
+}
+
+size_t ev_async_size(void)
+{
+    return sizeof(ev_async_t);
+}
+
 int ev_async_init(ev_loop_t *loop, ev_async_t **handle,
     ev_async_cb activate_cb, void *activate_arg)
 {
-    ev_async_t* new_handle = ev_malloc(sizeof(ev_async_t));
+    ev_async_t* new_handle =
+        ev__loop_malloc(loop, EV_ALLOCATOR_TYPE_MISC, sizeof(ev_async_t));
     if (new_handle == NULL)
     {
         return EV_ENOMEM;
     }
 
-    new_handle->activate_cb = activate_cb;
-    new_handle->activate_arg = activate_arg;
-    new_handle->close_cb = NULL;
-    new_handle->close_arg = NULL;
-    new_handle->backend.async_sent = 0;
+    _ev_async_init_win(loop, new_handle, activate_cb, activate_arg);
+
+    *handle = new_handle;
+    return 0;
+}
+
+int ev_async_init_inplace(ev_loop_t *loop, ev_async_t **handle,
+    ev_async_cb activate_cb, void *activate_arg, void *mem)
+{
+    ev_async_t* new_handle = mem;
 
-    ev__iocp_init(&new_handle->backend.io, _async_on_iocp_win, NULL);
-    ev__handle_init(loop, &new_handle->base, EV_ROLE_EV_ASYNC);
-    ev__handle_active(&new_handle->base);
+    _ev_async_init_win(loop, new_handle, activate_cb, activate_arg);
+    new_handle->base.data.flags |= EV_HANDLE_INPLACE;
 
     *handle = new_handle;
     return 0;
@@ -2578,7 +3063,7 @@ void ev_async_wakeup(ev_async_t* handle)
     }
 }
 
-// #line 38 "ev.c"
+// #line 42 "ev.c"
 ////////////////////////////////////////////////////////////////////////////////
 // FILE:    ev/win/fs_win.c
 // SIZE:    25863
@@ -3499,7 +3984,7 @@ void ev_file_munmap(ev_file_map_t* view)
     view->size = 0;
 }
 
-// #line 39 "ev.c"
+// #line 43 "ev.c"
 ////////////////////////////////////////////////////////////////////////////////
 // FILE:    ev/win/loop_win.c
 // SIZE:    3740
@@ -3667,7 +4152,7 @@ EV_LOCAL int ev__ipv6only_win(SOCKET sock, int opt)
     return 0;
 }
 
-// #line 40 "ev.c"
+// #line 44 "ev.c"
 ////////////////////////////////////////////////////////////////////////////////
 // FILE:    ev/win/misc_win.c
 // SIZE:    8944
@@ -3895,7 +4380,7 @@ EV_LOCAL void ev__backend_shutdown(void)
 {
 }
 
-// #line 41 "ev.c"
+// #line 45 "ev.c"
 ////////////////////////////////////////////////////////////////////////////////
 // FILE:    ev/win/mutex_win.c
 // SIZE:    749
@@ -3948,7 +4433,7 @@ int ev_mutex_try_enter(ev_mutex_t *handle)
     return EV_EBUSY;
 }
 
-// #line 42 "ev.c"
+// #line 46 "ev.c"
 ////////////////////////////////////////////////////////////////////////////////
 // FILE:    ev/win/once_win.c
 // SIZE:    445
@@ -3974,11 +4459,11 @@ void ev_once_execute(ev_once_t* guard, ev_once_cb cb)
     }
 }
 
-// #line 43 "ev.c"
+// #line 47 "ev.c"
 ////////////////////////////////////////////////////////////////////////////////
 // FILE:    ev/win/pipe_win.c
-// SIZE:    42909
-// SHA-256: 1516dd61b78f2b427d88aaa8030e85cf01a9a4a747b8e2fffe45064f93898280
+// SIZE:    44370
+// SHA-256: 425af4eb4de7745b0130601c9c6f344a221ea630e531d3590f0c84bc789da478
 ////////////////////////////////////////////////////////////////////////////////
 // #line 1 "ev/win/pipe_win.c"
 #include <stdio.h>
@@ -4124,7 +4609,7 @@ static void _ev_pipe_w_user_callback_win(ev_pipe_write_req_t *req, ssize_t size)
 
     _ev_pipe_smart_deactive_win(pipe);
     ev__write_exit(&req->base);
-    ev_free(req);
+    ev__loop_free(pipe->base.loop, req);
 
     ucb(pipe, size, arg);
 }
@@ -4203,11 +4688,15 @@ static void _ev_pipe_abort(ev_pipe_t *pipe, int stat)
 static void _ev_pipe_on_close_win(ev_handle_t *handle)
 {
     ev_pipe_t *pipe = EV_CONTAINER_OF(handle, ev_pipe_t, base);
+    ev_loop_t *loop = pipe->base.loop;
     ev_pipe_cb close_cb = pipe->close_cb;
     void      *close_arg = pipe->close_arg;
 
     _ev_pipe_abort(pipe, EV_ECANCELED);
-    ev_free(pipe);
+    if (!(pipe->base.data.flags & EV_HANDLE_INPLACE))
+    {
+        ev__loop_free(loop, pipe);
+    }
 
     if (close_cb != NULL)
     {
@@ -4630,14 +5119,16 @@ static int _ev_pipe_on_ipc_mode_read_information(ev_pipe_t          *pipe,
             req = _ev_pipe_on_ipc_mode_read_mount_next(pipe);
         }
         assert(req != NULL);
-        req->handle.os_socket = WSASocketW(
+        req->handle.os_socket[0] = WSASocketW(
             FROM_PROTOCOL_INFO, FROM_PROTOCOL_INFO, FROM_PROTOCOL_INFO,
             &ipc_info->data.as_protocol_info, 0, WSA_FLAG_OVERLAPPED);
-        if (req->handle.os_socket == INVALID_SOCKET)
+        if (req->handle.os_socket[0] == INVALID_SOCKET)
         {
             int errcode = WSAGetLastError();
             return ev__translate_sys_error(errcode);
         }
+        req->handle.num = 1;
+        req->handle.pos = 0;
         break;
 
     default:
@@ -4844,7 +5335,7 @@ static int _ev_pipe_ipc_mode_write_data(ev_pipe_t           *pipe,
 
     assert(pipe->backend.ipc_mode.wio.sending.w_req == NULL);
 
-    if (req->handle.role != EV_ROLE_UNKNOWN)
+    if (req->handle.num != 0)
     {
         flags |= EV_IPC_FRAME_FLAG_INFORMATION;
 
@@ -4857,7 +5348,7 @@ static int _ev_pipe_ipc_mode_write_data(ev_pipe_t           *pipe,
         memset(&ipc_info, 0, sizeof(ipc_info));
         ipc_info.type = EV_PIPE_WIN_IPC_INFO_TYPE_PROTOCOL_INFO;
 
-        if (WSADuplicateSocketW(req->handle.u.os_socket, target_pid,
+        if (WSADuplicateSocketW(req->handle.os_socket[0], target_pid,
                                 &ipc_info.data.as_protocol_info))
         {
             int err = WSAGetLastError();
@@ -5364,28 +5855,50 @@ int ev_pipe_make(ev_os_pipe_t fds[2], int rflags, int wflags)
     return _ev_pipe_make_win(fds, rflags, wflags, buffer);
 }
 
-int ev_pipe_init(ev_loop_t *loop, ev_pipe_t **pipe, int ipc)
+static void _ev_pipe_init_win(ev_loop_t *loop, ev_pipe_t *pipe, int ipc)
 {
-    ev_pipe_t *new_pipe = ev_malloc(sizeof(ev_pipe_t));
-    if (new_pipe == NULL)
-    {
-        return EV_ENOMEM;
-    }
-
-    ev__handle_init(loop, &new_pipe->base, EV_ROLE_EV_PIPE);
-    new_pipe->close_cb = NULL;
-    new_pipe->pipfd = EV_OS_PIPE_INVALID;
-    new_pipe->base.data.flags |= ipc ? EV_HANDLE_PIPE_IPC : 0;
+    ev__handle_init(loop, &pipe->base, EV_ROLE_EV_PIPE);
+    pipe->close_cb = NULL;
+    pipe->pipfd = EV_OS_PIPE_INVALID;
+    pipe->base.data.flags |= ipc ? EV_HANDLE_PIPE_IPC : 0;
 
     if (ipc)
     {
-        _ev_pipe_init_as_ipc(new_pipe);
+        _ev_pipe_init_as_ipc(pipe);
     }
     else
     {
-        _ev_pipe_init_as_data(new_pipe);
+        _ev_pipe_init_as_data(pipe);
+    }
+}
+
+size_t ev_pipe_size(void)
+{
+    return sizeof(ev_pipe_t);
+}
+
+int ev_pipe_init(ev_loop_t *loop, ev_pipe_t **pipe, int ipc)
+{
+    ev_pipe_t *new_pipe =
+        ev__loop_malloc(loop, EV_ALLOCATOR_TYPE_PIPE, sizeof(ev_pipe_t));
+    if (new_pipe == NULL)
+    {
+        return EV_ENOMEM;
     }
 
+    _ev_pipe_init_win(loop, new_pipe, ipc);
+
+    *pipe = new_pipe;
+    return 0;
+}
+
+int ev_pipe_init_inplace(ev_loop_t *loop, ev_pipe_t **pipe, int ipc, void *mem)
+{
+    ev_pipe_t *new_pipe = mem;
+
+    _ev_pipe_init_win(loop, new_pipe, ipc);
+    new_pipe->base.data.flags |= EV_HANDLE_INPLACE;
+
     *pipe = new_pipe;
     return 0;
 }
@@ -5452,26 +5965,27 @@ int ev_pipe_open(ev_pipe_t *pipe, ev_os_pipe_t handle)
     return 0;
 }
 
-int ev_pipe_write_ex(ev_pipe_t *pipe, ev_buf_t *bufs, size_t nbuf,
-                     ev_role_t handle_role, void *handle_addr,
-                     ev_pipe_write_cb cb, void *arg)
+int ev_pipe_write_handles(ev_pipe_t *pipe, ev_buf_t *bufs, size_t nbuf,
+                          ev_role_t handle_role, void **handle_addrs,
+                          size_t handle_num, ev_pipe_write_cb cb, void *arg)
 {
     if (pipe->pipfd == EV_OS_PIPE_INVALID)
     {
         return EV_EBADF;
     }
 
-    ev_pipe_write_req_t *req = ev_malloc(sizeof(ev_pipe_write_req_t));
+    ev_pipe_write_req_t *req = ev__loop_malloc(
+        pipe->base.loop, EV_ALLOCATOR_TYPE_PIPE, sizeof(ev_pipe_write_req_t));
     if (req == NULL)
     {
         return EV_ENOMEM;
     }
 
     int ret = ev__pipe_write_init_ext(req, cb, arg, bufs, nbuf, handle_role,
-                                      handle_addr);
+                                      handle_addrs, handle_num);
     if (ret != 0)
     {
-        ev_free(req);
+        ev__loop_free(pipe->base.loop, req);
         return ret;
     }
 
@@ -5491,12 +6005,29 @@ int ev_pipe_write_ex(ev_pipe_t *pipe, ev_buf_t *bufs, size_t nbuf,
     {
         ev__write_exit(&req->base);
         _ev_pipe_smart_deactive_win(pipe);
-        ev_free(req);
+        ev__loop_free(pipe->base.loop, req);
     }
 
     return ret;
 }
 
+int ev_pipe_set_watermark(ev_pipe_t *pipe, size_t low, size_t high,
+                          ev_pipe_watermark_cb cb, void *arg)
+{
+    (void)pipe;
+    (void)low;
+    (void)high;
+    (void)cb;
+    (void)arg;
+    return EV_ENOSYS;
+}
+
+ssize_t ev_pipe_write_queue_size(ev_pipe_t *pipe)
+{
+    (void)pipe;
+    return EV_ENOSYS;
+}
+
 int ev_pipe_read(ev_pipe_t *pipe, ev_pipe_read_req_t *req, ev_buf_t *bufs,
                  size_t nbuf, ev_pipe_read_cb cb)
 {
@@ -5535,7 +6066,7 @@ int ev_pipe_accept(ev_pipe_t *pipe, ev_pipe_read_req_t *req,
                    ev_role_t handle_role, void *handle_addr)
 {
     (void)pipe;
-    if (req->handle.os_socket == EV_OS_SOCKET_INVALID)
+    if (req->handle.pos >= req->handle.num)
     {
         return EV_ENOENT;
     }
@@ -5545,18 +6076,29 @@ int ev_pipe_accept(ev_pipe_t *pipe, ev_pipe_read_req_t *req,
         return EV_EINVAL;
     }
 
-    int ret = ev__tcp_open_win((ev_tcp_t *)handle_addr, req->handle.os_socket);
-    req->handle.os_socket = EV_OS_SOCKET_INVALID;
+    int ret = ev__tcp_open_win((ev_tcp_t *)handle_addr,
+                               req->handle.os_socket[req->handle.pos]);
+    req->handle.os_socket[req->handle.pos] = EV_OS_SOCKET_INVALID;
+    req->handle.pos++;
 
     return ret;
 }
 
+void ev_pipe_discard(ev_pipe_read_req_t *req)
+{
+    for (; req->handle.pos < req->handle.num; req->handle.pos++)
+    {
+        closesocket(req->handle.os_socket[req->handle.pos]);
+        req->handle.os_socket[req->handle.pos] = EV_OS_SOCKET_INVALID;
+    }
+}
+
 void ev_pipe_close(ev_os_pipe_t fd)
 {
     CloseHandle(fd);
 }
 
-// #line 44 "ev.c"
+// #line 48 "ev.c"
 ////////////////////////////////////////////////////////////////////////////////
 // FILE:    ev/win/process_win.c
 // SIZE:    16212
@@ -6205,7 +6747,7 @@ error:
     return ev__translate_sys_error(err);
 }
 
-// #line 45 "ev.c"
+// #line 49 "ev.c"
 ////////////////////////////////////////////////////////////////////////////////
 // FILE:    ev/win/sem_win.c
 // SIZE:    1358
@@ -6286,7 +6828,7 @@ int ev_sem_try_wait(ev_sem_t *sem)
     EV_ABORT("ret:%lu, GetLastError:%lu", ret, errcode);
 }
 
-// #line 46 "ev.c"
+// #line 50 "ev.c"
 ////////////////////////////////////////////////////////////////////////////////
 // FILE:    ev/win/shdlib_win.c
 // SIZE:    1764
@@ -6364,7 +6906,60 @@ int ev_dlsym(ev_shdlib_t* lib, const char* name, void** ptr)
     return 0;
 }
 
-// #line 47 "ev.c"
+// #line 51 "ev.c"
+////////////////////////////////////////////////////////////////////////////////
+// FILE:    ev/win/shm_channel_win.c
+// SIZE:    995
+// SHA-256: 162b8d047c0923faa0d4da13e312a7c1f0184cfb43b6fe807538fe96909facf0
+////////////////////////////////////////////////////////////////////////////////
+// #line 1 "ev/win/shm_channel_win.c"
+int ev_shm_channel_init(ev_loop_t *loop, ev_shm_channel_t **chan,
+                        const char *key, size_t size,
+                        ev_shm_channel_recv_cb cb, void *arg)
+{
+    (void)loop;
+    (void)chan;
+    (void)key;
+    (void)size;
+    (void)cb;
+    (void)arg;
+    return EV_ENOSYS;
+}
+
+int ev_shm_channel_open(ev_loop_t *loop, ev_shm_channel_t **chan,
+                        const char *key)
+{
+    (void)loop;
+    (void)chan;
+    (void)key;
+    return EV_ENOSYS;
+}
+
+void ev_shm_channel_exit(ev_shm_channel_t *chan, ev_shm_channel_cb close_cb,
+                         void *close_arg)
+{
+    (void)chan;
+    (void)close_cb;
+    (void)close_arg;
+}
+
+int ev_shm_channel_send(ev_shm_channel_t *chan, const void *data, size_t size)
+{
+    (void)chan;
+    (void)data;
+    (void)size;
+    return EV_ENOSYS;
+}
+
+EV_LOCAL int ev__shm_channel_doorbell(ev_shm_channel_t *chan,
+                                      ev_os_socket_t   *fd)
+{
+    (void)chan;
+    (void)fd;
+    return EV_ENOSYS;
+}
+
+// #line 52 "ev.c"
 ////////////////////////////////////////////////////////////////////////////////
 // FILE:    ev/win/shmem_win.c
 // SIZE:    2574
@@ -6490,11 +7085,11 @@ void ev_shmem_exit(ev_shmem_t* shm)
     ev_free(shm);
 }
 
-// #line 48 "ev.c"
+// #line 53 "ev.c"
 ////////////////////////////////////////////////////////////////////////////////
 // FILE:    ev/win/tcp_win.c
-// SIZE:    23772
-// SHA-256: 78bf65731466c5b10cd84f84fbdba72e98e1561efd9c8b37bea117317f01201e
+// SIZE:    31614
+// SHA-256: 1d6c52a41c64a7a417a992b0219f90ab13620e7c42d3b2ee5068440868cef257
 ////////////////////////////////////////////////////////////////////////////////
 // #line 1 "ev/win/tcp_win.c"
 #include <WinSock2.h>
@@ -6615,7 +7210,7 @@ static void _ev_tcp_w_user_callback_win(ev_tcp_t *sock, ev_tcp_write_req_t *req,
     _ev_tcp_smart_deactive_win(sock);
     ev__write_exit(&req->base);
     req->write_cb(sock, size, req->write_arg);
-    ev_free(req);
+    ev__loop_free(sock->base.loop, req);
 }
 
 static void _ev_tcp_r_user_callbak_win(ev_tcp_t *sock, ev_tcp_read_req_t *req,
@@ -6624,7 +7219,7 @@ static void _ev_tcp_r_user_callbak_win(ev_tcp_t *sock, ev_tcp_read_req_t *req,
     _ev_tcp_smart_deactive_win(sock);
     ev__read_exit(&req->base);
     req->read_cb(sock, size, req->read_arg);
-    ev_free(req);
+    ev__loop_free(sock->base.loop, req);
 }
 
 static void _ev_tcp_cleanup_stream(ev_tcp_t *sock)
@@ -6701,11 +7296,22 @@ static void _ev_tcp_on_close_win(ev_handle_t *handle)
         _ev_tcp_cleanup_connect(sock);
     }
 
+    ev__tcp_pool_unlink(sock);
+    ev__tcp_recycle_exit(sock);
+
+    /* Caller owned memory may be released in close callback */
+    ev_loop_t *loop = sock->base.loop;
+    int        inplace = sock->base.data.flags & EV_HANDLE_INPLACE;
+    int        recycled = ev__tcp_recycle(sock);
     if (sock->close_cb != NULL)
     {
         sock->close_cb(sock, sock->close_arg);
     }
-    ev_free(sock);
+
+    if (!recycled && !inplace)
+    {
+        ev__loop_free(loop, sock);
+    }
 }
 
 static int _ev_tcp_get_connectex(ev_tcp_t *sock, LPFN_CONNECTEX *fn)
@@ -6756,6 +7362,13 @@ static int _ev_tcp_setup_sock(ev_tcp_t *sock, int af, int with_iocp)
     sock->sock = os_sock;
     sock->backend.af = af;
 
+    if ((ret = ev__tcp_opts_apply(sock, 0)) != 0)
+    {
+        sock->sock = EV_OS_SOCKET_INVALID;
+        closesocket(os_sock);
+        return ret;
+    }
+
     return 0;
 
 err:
@@ -6771,6 +7384,8 @@ static void _ev_tcp_setup_listen_win(ev_tcp_t *sock)
 {
     ev_list_init(&sock->backend.u.listen.a_queue);
     ev_list_init(&sock->backend.u.listen.a_queue_done);
+    sock->backend.u.listen.on_conn = NULL;
+    sock->backend.u.listen.on_conn_arg = NULL;
     sock->base.data.flags |= EV_HANDLE_TCP_LISTING;
 }
 
@@ -6904,6 +7519,11 @@ static void _ev_tcp_on_accept_win(ev_tcp_t *conn, size_t transferred)
             ? 0
             : ev__translate_sys_error(ev__ntstatus_to_winsock_error(
                   (NTSTATUS)conn->backend.io.overlapped.Internal));
+    if (conn->backend.u.accept.stat == 0)
+    {
+        /* AcceptEx() sockets do not inherit options from listen socket */
+        ev__tcp_opts_inherit(conn, lisn, 0);
+    }
     _ev_tcp_submit_stream_todo(conn);
 }
 
@@ -7042,21 +7662,46 @@ static int _ev_tcp_init_read_req_win(ev_tcp_t *sock, ev_tcp_read_req_t *req,
     return 0;
 }
 
+EV_LOCAL void ev__tcp_init(ev_loop_t *loop, ev_tcp_t *tcp)
+{
+    ev__handle_init(loop, &tcp->base, EV_ROLE_EV_TCP);
+    tcp->close_cb = NULL;
+    tcp->sock = EV_OS_SOCKET_INVALID;
+    ev__tcp_opts_init(tcp);
+    ev__tcp_recycle_init(tcp);
+    ev__tcp_pool_link_init(tcp);
+
+    tcp->backend.af = AF_INET6;
+    ev__iocp_init(&tcp->backend.io, _ev_tcp_on_iocp, tcp);
+    memset(&tcp->backend.mask, 0, sizeof(tcp->backend.mask));
+}
+
+size_t ev_tcp_size(void)
+{
+    return sizeof(ev_tcp_t);
+}
+
 int ev_tcp_init(ev_loop_t *loop, ev_tcp_t **tcp)
 {
-    ev_tcp_t *new_tcp = ev_malloc(sizeof(ev_tcp_t));
+    ev_tcp_t *new_tcp =
+        ev__loop_malloc(loop, EV_ALLOCATOR_TYPE_TCP, sizeof(ev_tcp_t));
     if (new_tcp == NULL)
     {
         return EV_ENOMEM;
     }
 
-    ev__handle_init(loop, &new_tcp->base, EV_ROLE_EV_TCP);
-    new_tcp->close_cb = NULL;
-    new_tcp->sock = EV_OS_SOCKET_INVALID;
+    ev__tcp_init(loop, new_tcp);
+
+    *tcp = new_tcp;
+    return 0;
+}
+
+int ev_tcp_init_inplace(ev_loop_t *loop, ev_tcp_t **tcp, void *mem)
+{
+    ev_tcp_t *new_tcp = mem;
 
-    new_tcp->backend.af = AF_INET6;
-    ev__iocp_init(&new_tcp->backend.io, _ev_tcp_on_iocp, new_tcp);
-    memset(&new_tcp->backend.mask, 0, sizeof(new_tcp->backend.mask));
+    ev__tcp_init(loop, new_tcp);
+    new_tcp->base.data.flags |= EV_HANDLE_INPLACE;
 
     *tcp = new_tcp;
     return 0;
@@ -7123,6 +7768,10 @@ int ev_tcp_listen(ev_tcp_t *sock, int backlog)
     }
 
     int ret;
+    if ((ret = ev__tcp_opts_apply(sock, 1)) != 0)
+    {
+        return ret;
+    }
     if ((ret = listen(sock->sock, backlog)) == SOCKET_ERROR)
     {
         return ev__translate_sys_error(WSAGetLastError());
@@ -7166,6 +7815,7 @@ int ev_tcp_accept(ev_tcp_t *lisn, ev_tcp_t *conn, ev_tcp_accept_cb cb,
     if (ret)
     {
         conn->backend.u.accept.stat = 0;
+        ev__tcp_opts_inherit(conn, lisn, 0);
         ev_list_push_back(&lisn->backend.u.listen.a_queue_done,
                           &conn->backend.u.accept.node);
         _ev_tcp_submit_stream_todo(conn);
@@ -7193,6 +7843,118 @@ err:
     return ret;
 }
 
+static int _ev_tcp_auto_accept_post_win(ev_tcp_t *lisn, ev_tcp_accept_cb cb)
+{
+    int       ret;
+    ev_tcp_t *conn;
+    if ((ret = ev_tcp_init_accept(lisn, &conn)) != 0)
+    {
+        return ret;
+    }
+    if ((ret = ev_tcp_accept(lisn, conn, cb, NULL)) != 0)
+    {
+        ev_tcp_exit(conn, NULL, NULL);
+        return ret;
+    }
+    return 0;
+}
+
+static void _ev_tcp_on_auto_accept_win(ev_tcp_t *lisn, ev_tcp_t *conn,
+                                       int stat, void *arg)
+{
+    (void)arg;
+    ev_tcp_accept_cb on_conn = lisn->backend.u.listen.on_conn;
+
+    if (stat != 0 || on_conn == NULL)
+    {
+        ev_tcp_exit(conn, NULL, NULL);
+        conn = NULL;
+    }
+    if (on_conn == NULL || stat == EV_ECANCELED)
+    {
+        return;
+    }
+
+    on_conn(lisn, conn, stat, lisn->backend.u.listen.on_conn_arg);
+
+    /* might be close in callback */
+    if (ev__handle_is_closing(&lisn->base) ||
+        lisn->backend.u.listen.on_conn == NULL)
+    {
+        return;
+    }
+
+    int ret = _ev_tcp_auto_accept_post_win(lisn, _ev_tcp_on_auto_accept_win);
+    if (ret != 0)
+    {
+        lisn->backend.u.listen.on_conn(lisn, NULL, ret,
+                                       lisn->backend.u.listen.on_conn_arg);
+    }
+}
+
+int ev_tcp_accept_start(ev_tcp_t *lisn, size_t budget, ev_tcp_accept_cb cb,
+                        void *arg)
+{
+    size_t i;
+    int    ret;
+
+    if (cb == NULL || !(lisn->base.data.flags & EV_HANDLE_TCP_LISTING))
+    {
+        return EV_EINVAL;
+    }
+    if (lisn->backend.u.listen.on_conn != NULL)
+    {
+        return EV_EALREADY;
+    }
+
+    lisn->backend.u.listen.on_conn = cb;
+    lisn->backend.u.listen.on_conn_arg = arg;
+
+    /*
+     * There is no readiness to drain on IOCP. Keep \p budget AcceptEx() in
+     * flight instead, so a burst of connections completes without waiting
+     * for a new accept to be posted.
+     */
+    budget = budget != 0 ? budget : EV_TCP_ACCEPT_BUDGET;
+    for (i = 0; i < budget; i++)
+    {
+        ret = _ev_tcp_auto_accept_post_win(lisn, _ev_tcp_on_auto_accept_win);
+        if (ret != 0)
+        {
+            if (i == 0)
+            {
+                lisn->backend.u.listen.on_conn = NULL;
+                lisn->backend.u.listen.on_conn_arg = NULL;
+                return ret;
+            }
+            break;
+        }
+    }
+
+    return 0;
+}
+
+int ev_tcp_accept_stop(ev_tcp_t *lisn)
+{
+    if (!(lisn->base.data.flags & EV_HANDLE_TCP_LISTING))
+    {
+        return EV_EINVAL;
+    }
+
+    /* Pending AcceptEx() cannot be revoked, connections from them are closed */
+    lisn->backend.u.listen.on_conn = NULL;
+    lisn->backend.u.listen.on_conn_arg = NULL;
+    return 0;
+}
+
+int ev_tcp_get_info(ev_tcp_t *sock, ev_tcp_info_t *info)
+{
+    /* SIO_TCP_INFO does not report congestion window nor delivery rate */
+    (void)sock;
+    (void)info;
+    return EV_ENOSYS;
+}
+
 int ev_tcp_getsockname(ev_tcp_t *sock, struct sockaddr *name, size_t *len)
 {
     int ret;
@@ -7289,7 +8051,8 @@ int ev_tcp_write(ev_tcp_t *sock, ev_buf_t *bufs, size_t nbuf,
                  ev_tcp_write_cb cb, void *arg)
 {
     int                 ret;
-    ev_tcp_write_req_t *req = ev_malloc(sizeof(ev_tcp_write_req_t));
+    ev_tcp_write_req_t *req = ev__loop_malloc(
+        sock->base.loop, EV_ALLOCATOR_TYPE_TCP, sizeof(ev_tcp_write_req_t));
     if (req == NULL)
     {
         return EV_ENOMEM;
@@ -7298,7 +8061,7 @@ int ev_tcp_write(ev_tcp_t *sock, ev_buf_t *bufs, size_t nbuf,
     ret = _ev_tcp_init_write_req_win(sock, req, bufs, nbuf, cb, arg);
     if (ret != 0)
     {
-        ev_free(req);
+        ev__loop_free(sock->base.loop, req);
         return ret;
     }
 
@@ -7324,18 +8087,88 @@ int ev_tcp_write(ev_tcp_t *sock, ev_buf_t *bufs, size_t nbuf,
     if ((ret = WSAGetLastError()) != WSA_IO_PENDING)
     {
         _ev_tcp_smart_deactive_win(sock);
-        ev_free(req);
+        ev__loop_free(sock->base.loop, req);
         return ev__translate_sys_error(ret);
     }
 
     return 0;
 }
 
+int ev_tcp_sendfile(ev_tcp_t *sock, ev_file_t *file, int64_t offset,
+                    size_t len, ev_tcp_write_cb cb, void *arg)
+{
+    /* TransmitFile() is not wired into the IOCP write queue yet */
+    (void)sock;
+    (void)file;
+    (void)offset;
+    (void)len;
+    (void)cb;
+    (void)arg;
+    return EV_ENOSYS;
+}
+
+ssize_t ev_tcp_try_write(ev_tcp_t *sock, ev_buf_t *bufs, size_t nbuf)
+{
+    /*
+     * Overlapped sockets cannot do a nonblocking send without IOCP, so there
+     * is no fast path on Windows.
+     */
+    (void)sock;
+    (void)bufs;
+    (void)nbuf;
+    return EV_ENOSYS;
+}
+
+int ev_tcp_set_watermark(ev_tcp_t *sock, size_t low, size_t high,
+                         ev_tcp_watermark_cb cb, void *arg)
+{
+    /* Writes are handed to IOCP as a whole, there is no queue to watch */
+    (void)sock;
+    (void)low;
+    (void)high;
+    (void)cb;
+    (void)arg;
+    return EV_ENOSYS;
+}
+
+ssize_t ev_tcp_write_queue_size(ev_tcp_t *sock)
+{
+    (void)sock;
+    return EV_ENOSYS;
+}
+
+int ev_tcp_pipe_to_ex(ev_role_t src_role, void *src, ev_role_t dst_role,
+                      void *dst, const ev_tcp_pipe_opts_t *opts)
+{
+    /* There is no splice(2) counterpart to move data between sockets */
+    (void)src_role;
+    (void)src;
+    (void)dst_role;
+    (void)dst;
+    (void)opts;
+    return EV_ENOSYS;
+}
+
+int ev_tcp_pipe_to(ev_tcp_t *src, ev_tcp_t *dst,
+                   const ev_tcp_pipe_opts_t *opts)
+{
+    return ev_tcp_pipe_to_ex(EV_ROLE_EV_TCP, src, EV_ROLE_EV_TCP, dst, opts);
+}
+
+int ev_tcp_set_zerocopy(ev_tcp_t *sock, int enable)
+{
+    /* There is no MSG_ZEROCOPY counterpart for IOCP sockets */
+    (void)sock;
+    (void)enable;
+    return EV_ENOSYS;
+}
+
 int ev_tcp_read(ev_tcp_t *sock, ev_buf_t *bufs, size_t nbuf, ev_tcp_read_cb cb,
                 void *arg)
 {
     int                ret;
-    ev_tcp_read_req_t *req = ev_malloc(sizeof(ev_tcp_read_req_t));
+    ev_tcp_read_req_t *req = ev__loop_malloc(
+        sock->base.loop, EV_ALLOCATOR_TYPE_TCP, sizeof(ev_tcp_read_req_t));
     if (req == NULL)
     {
         return EV_ENOMEM;
@@ -7343,7 +8176,7 @@ int ev_tcp_read(ev_tcp_t *sock, ev_buf_t *bufs, size_t nbuf, ev_tcp_read_cb cb,
 
     if ((ret = _ev_tcp_init_read_req_win(sock, req, bufs, nbuf, cb, arg)) != 0)
     {
-        ev_free(req);
+        ev__loop_free(sock->base.loop, req);
         return ret;
     }
 
@@ -7371,7 +8204,7 @@ int ev_tcp_read(ev_tcp_t *sock, ev_buf_t *bufs, size_t nbuf, ev_tcp_read_cb cb,
     if ((ret = WSAGetLastError()) != WSA_IO_PENDING)
     {
         _ev_tcp_smart_deactive_win(sock);
-        ev_free(req);
+        ev__loop_free(sock->base.loop, req);
         return ev__translate_sys_error(ret);
     }
 
@@ -7386,10 +8219,84 @@ EV_LOCAL int ev__tcp_open_win(ev_tcp_t *tcp, SOCKET fd)
         _ev_tcp_setup_stream_win(tcp);
     }
 
+    return ev__tcp_opts_apply(tcp, 0);
+}
+
+EV_LOCAL int ev__tcp_opt_native(ev_tcp_opt_t opt, int *level, int *name)
+{
+    switch (opt)
+    {
+    case EV_TCP_OPT_NODELAY:
+        *level = IPPROTO_TCP;
+        *name = TCP_NODELAY;
+        return 0;
+    case EV_TCP_OPT_KEEPALIVE:
+        *level = SOL_SOCKET;
+        *name = SO_KEEPALIVE;
+        return 0;
+    case EV_TCP_OPT_SNDBUF:
+        *level = SOL_SOCKET;
+        *name = SO_SNDBUF;
+        return 0;
+    case EV_TCP_OPT_RCVBUF:
+        *level = SOL_SOCKET;
+        *name = SO_RCVBUF;
+        return 0;
+#if defined(TCP_FASTOPEN)
+    case EV_TCP_OPT_FASTOPEN:
+        *level = IPPROTO_TCP;
+        *name = TCP_FASTOPEN;
+        return 0;
+#endif
+    default:
+        return EV_ENOSYS;
+    }
+}
+
+EV_LOCAL int ev__tcp_setsockopt(ev_os_socket_t sock, int level, int name,
+                                int val)
+{
+    if (setsockopt(sock, level, name, (char *)&val, sizeof(val)) != 0)
+    {
+        return ev__translate_sys_error(WSAGetLastError());
+    }
     return 0;
 }
 
-// #line 49 "ev.c"
+EV_LOCAL int ev__tcp_getsockopt(ev_os_socket_t sock, int level, int name,
+                                int *val)
+{
+    int len = sizeof(*val);
+    if (getsockopt(sock, level, name, (char *)val, &len) != 0)
+    {
+        return ev__translate_sys_error(WSAGetLastError());
+    }
+    return 0;
+}
+
+EV_LOCAL int ev__tcp_probe(ev_os_socket_t sock)
+{
+    /* Socket is in nonblocking mode, see _ev_tcp_setup_sock() */
+    char c;
+    int  ret = recv(sock, &c, 1, MSG_PEEK);
+    if (ret == 0)
+    {
+        return EV_EOF;
+    }
+    if (ret > 0)
+    {
+        return EV_EPROTO;
+    }
+
+    int err = WSAGetLastError();
+    if (err == WSAEWOULDBLOCK)
+    {
+        return 0;
+    }
+    return ev__translate_sys_error(err);
+}
+
+// #line 54 "ev.c"
 ////////////////////////////////////////////////////////////////////////////////
 // FILE:    ev/win/thread_win.c
 // SIZE:    4563
@@ -7597,7 +8504,7 @@ void *ev_thread_key_get(ev_thread_key_t *key)
     return val;
 }
 
-// #line 50 "ev.c"
+// #line 55 "ev.c"
 ////////////////////////////////////////////////////////////////////////////////
 // FILE:    ev/win/threadpool_win.c
 // SIZE:    545
@@ -7629,7 +8536,7 @@ EV_LOCAL void ev__threadpool_exit_win(ev_loop_t* loop)
     (void)loop;
 }
 
-// #line 51 "ev.c"
+// #line 56 "ev.c"
 ////////////////////////////////////////////////////////////////////////////////
 // FILE:    ev/win/time_win.c
 // SIZE:    1385
@@ -7694,11 +8601,11 @@ uint64_t ev_hrtime(void)
     return _ev_hrtime_win(EV__NANOSEC);
 #undef EV__NANOSEC
 }
-// #line 52 "ev.c"
+// #line 57 "ev.c"
 ////////////////////////////////////////////////////////////////////////////////
 // FILE:    ev/win/udp_win.c
-// SIZE:    24654
-// SHA-256: 032b22f706399b5476b3b5f5e638801a494973dcb5c56e67fa479191cdef2eae
+// SIZE:    28230
+// SHA-256: bd37389e6092a8d1c0e10723c66ee0078dd3b3faade56baca11fb1866a063113
 ////////////////////////////////////////////////////////////////////////////////
 // #line 1 "ev/win/udp_win.c"
 #include <assert.h>
@@ -7782,10 +8689,14 @@ err:
 static void _ev_udp_on_close_win(ev_handle_t* handle)
 {
     ev_udp_t* udp = EV_CONTAINER_OF(handle, ev_udp_t, base);
+    ev_loop_t* loop = udp->base.loop;
     ev_udp_cb close_cb = udp->close_cb;
     void     *close_arg = udp->close_arg;
 
-    ev_free(udp);
+    if (!(udp->base.data.flags & EV_HANDLE_INPLACE))
+    {
+        ev__loop_free(loop, udp);
+    }
     if (close_cb != NULL)
     {
         close_cb(udp, close_arg);
@@ -8043,7 +8954,7 @@ static void _ev_udp_w_user_callback_win(ev_udp_write_t* req, ssize_t size)
     ev__handle_exit(&req->handle, NULL);
 
     req->usr_cb(udp, size, req->usr_cb_arg);
-    ev_free(req);
+    ev__loop_free(udp->base.loop, req);
 }
 
 static void _ev_udp_r_user_callback_win(ev_udp_read_t* req, const struct sockaddr* addr, ssize_t size)
@@ -8055,7 +8966,7 @@ static void _ev_udp_r_user_callback_win(ev_udp_read_t* req, const struct sockadd
     ev__handle_exit(&req->handle, NULL);
 
     req->usr_cb(udp, addr, size, req->usr_cb_arg);
-    ev_free(req);
+    ev__loop_free(udp->base.loop, req);
 }
 
 static void _ev_udp_on_send_complete_win(ev_udp_t* udp, ev_udp_write_t* req)
@@ -8148,6 +9059,12 @@ static int _ev_udp_maybe_bind_win(ev_udp_t* udp, const struct sockaddr* addr, un
         return EV_EALREADY;
     }
 
+    /* Winsock has no load balanced port sharing */
+    if (flags & EV_UDP_REUSEPORT)
+    {
+        return EV_ENOSYS;
+    }
+
     if ((flags & EV_UDP_IPV6_ONLY) && addr->sa_family != AF_INET6)
     {
         return EV_EINVAL;
@@ -8238,6 +9155,12 @@ EV_LOCAL int ev__udp_send(ev_udp_t* udp, ev_udp_write_t* req,
 {
     int ret, err;
 
+    /* UDP_SEND_MSG_SIZE is not supported yet */
+    if (req->seg_size != 0)
+    {
+        return EV_ENOSYS;
+    }
+
     if (!(udp->base.data.flags & EV_HANDLE_UDP_BOUND))
     {
         if (addr == NULL)
@@ -8279,35 +9202,68 @@ EV_LOCAL int ev__udp_send(ev_udp_t* udp, ev_udp_write_t* req,
     return ev__translate_sys_error(err);
 }
 
-int ev_udp_init(ev_loop_t* loop, ev_udp_t** udp, int domain)
+static int _ev_udp_init_win(ev_loop_t* loop, ev_udp_t* udp, int domain)
 {
     int err;
-    ev_udp_t *new_udp = ev_malloc(sizeof(ev_udp_t));
-    if (new_udp == NULL)
-    {
-        return EV_ENOMEM;
-    }
 
-    new_udp->sock = EV_OS_SOCKET_INVALID;
-    new_udp->close_cb = NULL;
-    new_udp->close_arg = NULL;
-    ev_list_init(&new_udp->send_list);
-    ev_list_init(&new_udp->recv_list);
-    ev__handle_init(loop, &new_udp->base, EV_ROLE_EV_UDP);
+    udp->sock = EV_OS_SOCKET_INVALID;
+    udp->close_cb = NULL;
+    udp->close_arg = NULL;
+    ev_list_init(&udp->send_list);
+    ev_list_init(&udp->recv_list);
+    ev__handle_init(loop, &udp->base, EV_ROLE_EV_UDP);
 
-    new_udp->backend.fn_wsarecv = WSARecv;
-    new_udp->backend.fn_wsarecvfrom = WSARecvFrom;
+    udp->backend.fn_wsarecv = WSARecv;
+    udp->backend.fn_wsarecvfrom = WSARecvFrom;
 
     if (domain != AF_UNSPEC)
     {
-        if ((err = _ev_udp_maybe_deferred_socket_win(new_udp, domain)) != 0)
+        if ((err = _ev_udp_maybe_deferred_socket_win(udp, domain)) != 0)
         {
-            ev__handle_exit(&new_udp->base, NULL);
-            ev_free(new_udp);
+            ev__handle_exit(&udp->base, NULL);
             return err;
         }
     }
 
+    return 0;
+}
+
+size_t ev_udp_size(void)
+{
+    return sizeof(ev_udp_t);
+}
+
+int ev_udp_init(ev_loop_t* loop, ev_udp_t** udp, int domain)
+{
+    int err;
+    ev_udp_t *new_udp =
+        ev__loop_malloc(loop, EV_ALLOCATOR_TYPE_UDP, sizeof(ev_udp_t));
+    if (new_udp == NULL)
+    {
+        return EV_ENOMEM;
+    }
+
+    if ((err = _ev_udp_init_win(loop, new_udp, domain)) != 0)
+    {
+        ev__loop_free(loop, new_udp);
+        return err;
+    }
+
+    *udp = new_udp;
+    return 0;
+}
+
+int ev_udp_init_inplace(ev_loop_t* loop, ev_udp_t** udp, int domain, void* mem)
+{
+    int err;
+    ev_udp_t* new_udp = mem;
+
+    if ((err = _ev_udp_init_win(loop, new_udp, domain)) != 0)
+    {
+        return err;
+    }
+    new_udp->base.data.flags |= EV_HANDLE_INPLACE;
+
     *udp = new_udp;
     return 0;
 }
@@ -8658,7 +9614,137 @@ int ev_udp_set_ttl(ev_udp_t* udp, int ttl)
     return 0;
 }
 
-// #line 53 "ev.c"
+int ev_udp_recv_batch_start(ev_udp_t* udp, size_t batch, size_t msg_size,
+    ev_udp_recv_batch_cb cb, void* arg)
+{
+    /* Winsock has no recvmmsg() equivalent */
+    (void)udp;
+    (void)batch;
+    (void)msg_size;
+    (void)cb;
+    (void)arg;
+    return EV_ENOSYS;
+}
+
+int ev_udp_recv_batch_stop(ev_udp_t* udp)
+{
+    (void)udp;
+    return EV_ENOSYS;
+}
+
+int ev_udp_recv_start(ev_udp_t* udp, size_t nbuf, size_t buf_size,
+    ev_udp_recv_ring_cb cb, void* arg)
+{
+    /* Not implemented yet, use #ev_udp_recv() */
+    (void)udp;
+    (void)nbuf;
+    (void)buf_size;
+    (void)cb;
+    (void)arg;
+    return EV_ENOSYS;
+}
+
+int ev_udp_recv_stop(ev_udp_t* udp)
+{
+    (void)udp;
+    return EV_ENOSYS;
+}
+
+void ev_udp_recv_release(ev_udp_t* udp, ev_udp_datagram_t* msg)
+{
+    (void)udp;
+    (void)msg;
+}
+
+int ev_udp_set_recv_info(ev_udp_t* udp, unsigned flags)
+{
+    /* WSARecvMsg is not used yet */
+    (void)udp;
+    (void)flags;
+    return EV_ENOSYS;
+}
+
+const ev_udp_recv_info_t* ev_udp_recv_info(ev_udp_t* udp)
+{
+    (void)udp;
+    return NULL;
+}
+
+static int _ev_udp_opt_native_win(ev_udp_t* udp, ev_udp_opt_t opt,
+    int* level, int* name)
+{
+    (void)udp;
+    *level = SOL_SOCKET;
+    switch (opt)
+    {
+    case EV_UDP_OPT_SNDBUF:
+        *name = SO_SNDBUF;
+        return 0;
+    case EV_UDP_OPT_RCVBUF:
+        *name = SO_RCVBUF;
+        return 0;
+    default:
+        /* IP_TOS is ignored unless qWAVE is used */
+        return EV_ENOSYS;
+    }
+}
+
+int ev_udp_setopt(ev_udp_t* udp, ev_udp_opt_t opt, int val)
+{
+    int ret, level, name;
+    if ((ret = _ev_udp_opt_native_win(udp, opt, &level, &name)) != 0)
+    {
+        return ret;
+    }
+
+    if (setsockopt(udp->sock, level, name, (char*)&val, sizeof(val)) != 0)
+    {
+        ret = WSAGetLastError();
+        return ev__translate_sys_error(ret);
+    }
+    return 0;
+}
+
+int ev_udp_getopt(ev_udp_t* udp, ev_udp_opt_t opt, int* val)
+{
+    int ret, level, name;
+    if ((ret = _ev_udp_opt_native_win(udp, opt, &level, &name)) != 0)
+    {
+        return ret;
+    }
+
+    int len = sizeof(*val);
+    if (getsockopt(udp->sock, level, name, (char*)val, &len) != 0)
+    {
+        ret = WSAGetLastError();
+        return ev__translate_sys_error(ret);
+    }
+    return 0;
+}
+
+int ev_udp_set_reuseport_cbpf(ev_udp_t* udp, const void* insns, size_t ninsn)
+{
+    (void)udp;
+    (void)insns;
+    (void)ninsn;
+    return EV_ENOSYS;
+}
+
+int ev_udp_set_reuseport_cpu(ev_udp_t* udp, unsigned group_size)
+{
+    (void)udp;
+    (void)group_size;
+    return EV_ENOSYS;
+}
+
+int ev_udp_set_gro(ev_udp_t* udp, int on)
+{
+    (void)udp;
+    (void)on;
+    return EV_ENOSYS;
+}
+
+// #line 58 "ev.c"
 ////////////////////////////////////////////////////////////////////////////////
 // FILE:    ev/win/winapi.c
 // SIZE:    594
@@ -8692,7 +9778,7 @@ EV_LOCAL void ev__winapi_init(void)
 #undef GET_NTDLL_FUNC
 }
 
-// #line 54 "ev.c"
+// #line 59 "ev.c"
 ////////////////////////////////////////////////////////////////////////////////
 // FILE:    ev/win/winsock.c
 // SIZE:    9169
@@ -9078,7 +10164,7 @@ EV_LOCAL int ev__ntstatus_to_winsock_error(NTSTATUS status)
     }
 }
 
-// #line 55 "ev.c"
+// #line 60 "ev.c"
 
 #else
 
@@ -9117,11 +10203,11 @@ EV_LOCAL void ev__async_pend(int rfd);
 #endif
 #endif
 
-// #line 59 "ev.c"
+// #line 64 "ev.c"
 ////////////////////////////////////////////////////////////////////////////////
 // FILE:    ev/unix/io_unix.h
-// SIZE:    2857
-// SHA-256: cdff01bf63730f8c3a8494580da79bd59b744441b8d88a2309823f4f5145d826
+// SIZE:    4518
+// SHA-256: faad6ea84cd8b2f40d5e1955f009175b7814b2c1e3471a53aeb7232fc468e489
 ////////////////////////////////////////////////////////////////////////////////
 // #line 1 "ev/unix/io_unix.h"
 #ifndef __EV_IO_UNIX_H__
@@ -9214,6 +10300,51 @@ EV_LOCAL ssize_t ev__writev_unix(int fd, ev_buf_t* iov, int iovcnt);
  */
 EV_LOCAL ssize_t ev__write_unix(int fd, void* buffer, size_t size);
 
+/**
+ * @brief Send \p count bytes of \p in_fd starting at \p offset to \p out_fd.
+ * @return #EV_EAGAIN: try again; 0: end of file; >0: send size; <0 errno
+ */
+EV_LOCAL ssize_t ev__sendfile_unix(int out_fd, int in_fd, int64_t offset, size_t count);
+
+/**
+ * @brief Move \p count bytes from \p fd_in to \p fd_out by splice(2).
+ *
+ * One of \p fd_in and \p fd_out must be a pipe.
+ *
+ * @return #EV_EAGAIN: try again; 0: end of file; >0: move size; <0 errno
+ */
+EV_LOCAL ssize_t ev__splice_unix(int fd_in, int fd_out, size_t count);
+
+/**
+ * @brief Same as #ev__writev_unix(), but send with MSG_ZEROCOPY.
+ *
+ * Fallback to #ev__writev_unix() if MSG_ZEROCOPY is not available.
+ *
+ * @return 0: try again; >0: write size; <0 errno
+ */
+EV_LOCAL ssize_t ev__sendmsg_zerocopy_unix(int fd, ev_buf_t* iov, int iovcnt);
+
+/**
+ * @brief Read next zerocopy completion from error queue of \p fd.
+ *
+ * Completions are not guaranteed to arrive in order, nor to be contiguous.
+ *
+ * @param[in] fd    Socket
+ * @param[out] lo   Sequence number of the first completed zerocopy send.
+ * @param[out] hi   Sequence number of the last completed zerocopy send.
+ * @return          1: got a completion; 0: none; <0 errno
+ */
+EV_LOCAL int ev__zerocopy_notify_unix(int fd, uint32_t* lo, uint32_t* hi);
+
+/**
+ * @brief Account \p write_size bytes as sent for \p req.
+ * @param[in] req           Write request
+ * @param[in] write_size    Bytes sent, must not exceed the pending size.
+ * @return                  + #EV_SUCCESS: \p req send finish
+ *                          + #EV_EAGAIN: \p req not send finish
+ */
+EV_LOCAL int ev__finalize_send_req_unix(ev_write_t* req, size_t write_size);
+
 /**
  * @brief Write \p req to \p fd
  * @param[in] fd    File to write
@@ -9232,7 +10363,40 @@ EV_LOCAL int ev__send_unix(int fd, ev_write_t* req,
 #endif
 #endif
 
-// #line 60 "ev.c"
+// #line 65 "ev.c"
+////////////////////////////////////////////////////////////////////////////////
+// FILE:    ev/unix/pipe_unix.h
+// SIZE:    618
+// SHA-256: bdff101de90d79731c42525f9251209d2aaef08a2cfe9386e5683b8dda82c9b4
+////////////////////////////////////////////////////////////////////////////////
+// #line 1 "ev/unix/pipe_unix.h"
+#ifndef __EV_PIPE_UNIX_H__
+#define __EV_PIPE_UNIX_H__
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Get stream of data mode pipe.
+ * @param[in] pipe      Pipe handle
+ * @param[out] stream   Stream of \p pipe
+ * @return              #ev_errno_t. #EV_ENOSYS if \p pipe is in IPC mode.
+ */
+EV_LOCAL int ev__pipe_data_stream_unix(ev_pipe_t *pipe,
+                                       ev_nonblock_stream_t **stream);
+
+/**
+ * @brief Deactive \p pipe if there is no pending IO.
+ * @param[in] pipe      Pipe handle
+ */
+EV_LOCAL void ev__pipe_smart_deactive_unix(ev_pipe_t *pipe);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
+
+// #line 66 "ev.c"
 ////////////////////////////////////////////////////////////////////////////////
 // FILE:    ev/unix/process_unix.h
 // SIZE:    269
@@ -9257,11 +10421,11 @@ EV_LOCAL void ev__exit_process_unix(void);
 #endif
 #endif
 
-// #line 61 "ev.c"
+// #line 67 "ev.c"
 ////////////////////////////////////////////////////////////////////////////////
 // FILE:    ev/unix/tcp_unix.h
-// SIZE:    2129
-// SHA-256: 8dcb4803fb619bae0d09ad0a6334c13cf149a1475b62f9ef69aa9c7cf20a2483
+// SIZE:    3139
+// SHA-256: 04f421a3055fb8f46aaf2e1f75ad480efd780c4f8ee13398758a51f6024d48a8
 ////////////////////////////////////////////////////////////////////////////////
 // #line 1 "ev/unix/tcp_unix.h"
 #ifndef __EV_TCP_UNIX_H__
@@ -9280,6 +10444,9 @@ typedef struct ev_tcp_backend
         {
             ev_nonblock_io_t io;           /**< IO object */
             ev_list_t        accept_queue; /**< Accept queue */
+            ev_tcp_accept_cb on_conn;      /**< Connection callback */
+            void            *on_conn_arg;  /**< User defined argument */
+            size_t           budget;       /**< Max accepts per event */
         } listen;
         struct
         {
@@ -9296,15 +10463,32 @@ typedef struct ev_tcp_backend
             int               stat; /**< Connect result */
         } client;
     } u;
+
+    ev_list_t w_done; /**< (#ev_write_t::node) Write requests finished
+                         without waiting, callbacks are deferred to backlog */
+    ev_list_t zc_queue; /**< (#ev_write_t::node) Write requests sent by
+                           MSG_ZEROCOPY, waiting for the kernel to release
+                           buffers */
+
+    struct
+    {
+        ev_tcp_watermark_cb cb;   /**< Watermark callback */
+        void               *arg;  /**< User defined argument */
+        size_t              low;  /**< Low watermark */
+        size_t              high; /**< High watermark */
+    } watermark;
 } ev_tcp_backend_t;
 
 struct ev_tcp
 {
-    ev_handle_t      base;      /**< Base object */
-    ev_tcp_close_cb  close_cb;  /**< User close callback */
-    void            *close_arg; /**< User defined argument. */
-    ev_os_socket_t   sock;      /**< Socket handle */
-    ev_tcp_backend_t backend;   /**< Platform related implementation */
+    ev_handle_t        base;      /**< Base object */
+    ev_tcp_close_cb    close_cb;  /**< User close callback */
+    void              *close_arg; /**< User defined argument. */
+    ev_os_socket_t     sock;      /**< Socket handle */
+    ev_tcp_recycle_t   recycle;   /**< Handle recycling */
+    ev_tcp_opts_t      opts;      /**< Socket options */
+    ev_tcp_pool_link_t pool;      /**< Connection pool */
+    ev_tcp_backend_t   backend;   /**< Platform related implementation */
 };
 
 typedef struct ev_tcp_write_req
@@ -9339,11 +10523,11 @@ EV_LOCAL int ev__tcp_open(ev_tcp_t *tcp, int fd);
 #endif
 #endif
 
-// #line 62 "ev.c"
+// #line 68 "ev.c"
 ////////////////////////////////////////////////////////////////////////////////
 // FILE:    ev/unix/loop_unix.h
-// SIZE:    500
-// SHA-256: 0800aa4e762d2d9f4162cc09a74bebaa04fecd3dae37b8a1ac329182dd92e8f7
+// SIZE:    579
+// SHA-256: d134093dcf2b4e33941c52721726a5a5c5bad8b8620ce8c636bb9094f3b250e7
 ////////////////////////////////////////////////////////////////////////////////
 // #line 1 "ev/unix/loop_unix.h"
 #ifndef __EV_LOOP_UNIX_H__
@@ -9356,6 +10540,7 @@ typedef struct ev_loop_unix_ctx
 {
     clockid_t           hwtime_clock_id;    /**< Clock id */
     int                 iovmax;             /**< The limits instead of readv/writev */
+    int                 udp_gso;            /**< Kernel support UDP_SEGMENT */
 }ev_loop_unix_ctx_t;
 
 /**
@@ -9373,7 +10558,77 @@ EV_LOCAL void ev__init_once_unix(void);
 #endif
 #endif
 
-// #line 63 "ev.c"
+// #line 69 "ev.c"
+////////////////////////////////////////////////////////////////////////////////
+// FILE:    ev/unix/shm_channel_unix.h
+// SIZE:    1922
+// SHA-256: 1b99b5efcb5e40e82a289422bb748216b6bb42482cb5185b1d984465be63d372
+////////////////////////////////////////////////////////////////////////////////
+// #line 1 "ev/unix/shm_channel_unix.h"
+#ifndef __EV_SHM_CHANNEL_UNIX_H__
+#define __EV_SHM_CHANNEL_UNIX_H__
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Ring header at the beginning of shared memory.
+ *
+ * \p head and \p tail are free running byte positions. They are placed in
+ * different cache lines so sender and receiver do not contend.
+ */
+typedef struct ev_shm_channel_hdr
+{
+    uint32_t magic;    /**< #EV_SHM_CHANNEL_MAGIC, set after initialized */
+    uint32_t capacity; /**< Ring size, power of 2 */
+
+    union {
+        ev_atomic64_t v;
+        uint8_t       _align[64];
+    } head; /**< Write position, only changed by sender */
+
+    union {
+        ev_atomic64_t v;
+        uint8_t       _align[64];
+    } tail; /**< Read position, only changed by receiver */
+
+    ev_atomic32_t waiting; /**< Receiver is waiting for doorbell */
+} ev_shm_channel_hdr_t;
+
+struct ev_shm_channel
+{
+    ev_handle_t            base;      /**< Base object */
+    ev_shmem_t            *shm;       /**< Shared memory */
+    ev_shm_channel_hdr_t  *hdr;       /**< Ring header */
+    uint8_t               *ring;      /**< Ring data */
+    size_t                 capacity;  /**< Ring size, not read from header */
+    ev_shm_channel_recv_cb recv_cb;   /**< Receive callback */
+    void                  *recv_arg;  /**< Receive argument */
+    ev_shm_channel_cb      close_cb;  /**< Close callback */
+    void                  *close_arg; /**< Close argument */
+
+    /**
+     * @brief Doorbell.
+     * Receiver polls evtfd[0] and shares evtfd[1], sender only has evtfd[1].
+     */
+    int              evtfd[2];
+    ev_nonblock_io_t io; /**< Doorbell watcher of receiver */
+};
+
+/**
+ * @brief Attach doorbell received from peer.
+ * @param[in] chan  Channel opened by #ev_shm_channel_open().
+ * @param[in] fd    Doorbell
+ * @return          #ev_errno_t
+ */
+EV_LOCAL int ev__shm_channel_attach_unix(ev_shm_channel_t *chan, int fd);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
+
+// #line 70 "ev.c"
 ////////////////////////////////////////////////////////////////////////////////
 // FILE:    ev/unix/shmem_unix.h
 // SIZE:    529
@@ -9411,11 +10666,11 @@ struct ev_shmem
 #endif
 #endif
 
-// #line 64 "ev.c"
+// #line 71 "ev.c"
 ////////////////////////////////////////////////////////////////////////////////
 // FILE:    ev/unix/stream_unix.h
-// SIZE:    1796
-// SHA-256: 9b706c88ae8e57a461ee12ee041bf7c37ffec9dfe4d567408a62f9908c7ba6fe
+// SIZE:    6580
+// SHA-256: 4ef79fd5232ad9eeb4bfed35e35bbe6951631d8f57d70dae7fd44b837842a578
 ////////////////////////////////////////////////////////////////////////////////
 // #line 1 "ev/unix/stream_unix.h"
 #ifndef __EV_STREAM_UNIX_H__
@@ -9424,6 +10679,72 @@ struct ev_shmem
 extern "C" {
 #endif
 
+/**
+ * @brief Write request that sends a range of a file by sendfile(2).
+ *
+ * #ev_write_t::bufs is always NULL, which tells the stream to take the data
+ * from #ev_nonblock_stream_file_t::fd instead of memory.
+ */
+typedef struct ev_nonblock_stream_file
+{
+    ev_write_t                  base;       /**< Base request */
+    int                         fd;         /**< File to send */
+    int64_t                     offset;     /**< Offset of next byte to send */
+} ev_nonblock_stream_file_t;
+
+typedef struct ev_nonblock_splice ev_nonblock_splice_t;
+
+/**
+ * @brief Splice finish callback.
+ * @param[in] req       Splice request
+ * @param[in] stat      0 if source reaches end of file and all data is moved,
+ *                      otherwise #ev_errno_t.
+ */
+typedef void (*ev_stream_splice_cb)(ev_nonblock_splice_t* req, int stat);
+
+/**
+ * @brief Move data from one stream to another through a kernel pipe.
+ *
+ * Data never enters user space. At most #ev_nonblock_splice_t::capacity bytes
+ * are buffered in the pipe, the source is not read until the destination
+ * takes some of them, so a slow destination throttles a fast source.
+ */
+struct ev_nonblock_splice
+{
+    ev_nonblock_stream_t*       src;        /**< Source stream */
+    ev_nonblock_stream_t*       dst;        /**< Destination stream */
+    int                         pipefd[2];  /**< Kernel buffer */
+    size_t                      capacity;   /**< Max bytes buffered in pipe */
+    size_t                      buffered;   /**< Bytes buffered in pipe */
+    uint64_t                    size;       /**< Bytes moved to destination */
+
+    struct
+    {
+        unsigned                src_eof : 1;    /**< Source reaches end of file */
+        unsigned                pipe_full : 1;  /**< Pipe is out of space */
+        unsigned                canceled : 1;   /**< One of the streams is aborted */
+    }flags;
+
+    ev_stream_splice_cb         cb;         /**< Finish callback */
+};
+
+/**
+ * @brief Initialize file write request.
+ * @param[out] req      Write request
+ * @param[in] fd        File to send
+ * @param[in] offset    Offset of first byte to send
+ * @param[in] len       Number of bytes to send
+ */
+EV_LOCAL void ev__nonblock_stream_file_init(ev_nonblock_stream_file_t* req,
+    int fd, int64_t offset, size_t len);
+
+/**
+ * @brief Check whether \p req is a #ev_nonblock_stream_file_t.
+ * @param[in] req       Write request
+ * @return              bool
+ */
+EV_LOCAL int ev__nonblock_stream_is_file(const ev_write_t* req);
+
 /**
  * @brief Initialize stream.
  * @param[in] loop      Event loop
@@ -9449,6 +10770,62 @@ EV_LOCAL void ev__nonblock_stream_exit(ev_nonblock_stream_t* stream);
  */
 EV_LOCAL int ev__nonblock_stream_write(ev_nonblock_stream_t* stream, ev_write_t* req);
 
+/**
+ * @brief Write as much of \p bufs as possible without blocking.
+ * @param[in] stream    Stream handle
+ * @param[in] bufs      Buffer list
+ * @param[in] nbuf      Buffer number
+ * @return              Bytes written, #EV_EAGAIN if nothing is written or
+ *                      there are pending write requests, or #ev_errno_t.
+ */
+EV_LOCAL ssize_t ev__nonblock_stream_try_write(ev_nonblock_stream_t* stream, ev_buf_t* bufs, size_t nbuf);
+
+/**
+ * @brief Send data with MSG_ZEROCOPY.
+ *
+ * Write requests still complete once their data is queued to the socket. The
+ * owner must keep user buffers until \p cb reports that the kernel released
+ * them. Zerocopy sends are counted from 0, the first send that finished a
+ * request is at most #ev_nonblock_stream_t::zerocopy::seq_sent - 1 at the time
+ * the write callback is called.
+ *
+ * @param[in] stream    Stream handle
+ * @param[in] cb        Completion callback, or NULL to turn zerocopy off.
+ */
+EV_LOCAL void ev__nonblock_stream_zerocopy(ev_nonblock_stream_t* stream, ev_stream_zerocopy_cb cb);
+
+/**
+ * @brief Watch size of write queue.
+ *
+ * \p cb is called with non-zero when bytes not sent reach \p high, and then
+ * with zero once they drop to \p low.
+ *
+ * @param[in] stream    Stream handle
+ * @param[in] low       Low watermark
+ * @param[in] high      High watermark
+ * @param[in] cb        Watermark callback, or NULL to disable.
+ */
+EV_LOCAL void ev__nonblock_stream_watermark(ev_nonblock_stream_t* stream,
+    size_t low, size_t high, ev_stream_watermark_cb cb);
+
+/**
+ * @brief Move all data of \p src to \p dst by splice(2).
+ *
+ * While splicing, \p src does not accept read requests and \p dst does not
+ * accept write requests. \p cb is called once when \p src reaches end of
+ * file, either stream fails, or either stream exits.
+ *
+ * @param[out] req      Splice request, must be valid until \p cb is called.
+ * @param[in] src       Source stream
+ * @param[in] dst       Destination stream
+ * @param[in] capacity  Max bytes buffered in kernel, 0 to use default.
+ * @param[in] cb        Finish callback
+ * @return              #ev_errno_t
+ */
+EV_LOCAL int ev__nonblock_stream_splice(ev_nonblock_splice_t* req,
+    ev_nonblock_stream_t* src, ev_nonblock_stream_t* dst, size_t capacity,
+    ev_stream_splice_cb cb);
+
 /**
  * @brief Do stream read
  * @param[in] stream    Stream handle
@@ -9484,7 +10861,7 @@ EV_LOCAL void ev__nonblock_stream_cleanup(ev_nonblock_stream_t* stream, unsigned
 #endif
 #endif
 
-// #line 65 "ev.c"
+// #line 72 "ev.c"
 ////////////////////////////////////////////////////////////////////////////////
 // FILE:    ev/unix/work.h
 // SIZE:    231
@@ -9506,12 +10883,12 @@ EV_LOCAL void ev__exit_work(ev_loop_t* loop);
 #endif
 #endif
 
-// #line 66 "ev.c"
+// #line 73 "ev.c"
 
 ////////////////////////////////////////////////////////////////////////////////
 // FILE:    ev/unix/async_unix.c
-// SIZE:    4059
-// SHA-256: 300622294d822a10fbbcdbced3e884ebe9dc0a29f5fdc06323ddc5f62bcabe19
+// SIZE:    5161
+// SHA-256: 11c1812098b897cae0bb3a1ce2d1e54b7ece392704d81d7419fa4b71f8d5c310
 ////////////////////////////////////////////////////////////////////////////////
 // #line 1 "ev/unix/async_unix.c"
 #include <unistd.h>
@@ -9533,9 +10910,13 @@ static void _ev_async_on_close(ev_handle_t *handle)
 {
     ev_async_t *async = EV_CONTAINER_OF(handle, ev_async_t, base);
 
+    ev_loop_t  *loop = async->base.loop;
     ev_async_cb close_cb = async->close_cb;
     void       *close_arg = async->close_arg;
-    ev_free(async);
+    if (!(async->base.data.flags & EV_HANDLE_INPLACE))
+    {
+        ev__loop_free(loop, async);
+    }
 
     if (close_cb != NULL)
     {
@@ -9575,7 +10956,10 @@ static void _ev_async_exit(ev_async_t *handle, ev_async_cb close_cb,
     else
     {
         ev__handle_exit(&handle->base, NULL);
-        ev_free(handle);
+        if (!(handle->base.data.flags & EV_HANDLE_INPLACE))
+        {
+            ev__loop_free(handle->base.loop, handle);
+        }
     }
 }
 
@@ -9652,42 +11036,80 @@ EV_LOCAL void ev__async_pend(int rfd)
     }
 }
 
-int ev_async_init(ev_loop_t *loop, ev_async_t **handle, ev_async_cb activate_cb,
-                  void *activate_arg)
+static int _ev_async_init_unix(ev_loop_t *loop, ev_async_t *handle,
+                               ev_async_cb activate_cb, void *activate_arg)
 {
-    int         errcode;
-    ev_async_t *new_handle = ev_malloc(sizeof(ev_async_t));
-    if (new_handle == NULL)
-    {
-        return EV_ENOMEM;
-    }
+    int errcode;
 
-    new_handle->activate_cb = activate_cb;
-    new_handle->activate_arg = activate_arg;
-    new_handle->close_cb = NULL;
-    ev__handle_init(loop, &new_handle->base, EV_ROLE_EV_ASYNC);
+    handle->activate_cb = activate_cb;
+    handle->activate_arg = activate_arg;
+    handle->close_cb = NULL;
+    ev__handle_init(loop, &handle->base, EV_ROLE_EV_ASYNC);
 
-    errcode = ev__asyc_eventfd(new_handle->backend.pipfd);
+    errcode = ev__asyc_eventfd(handle->backend.pipfd);
     if (errcode != 0)
     {
         goto err_close_handle;
     }
 
-    ev__nonblock_io_init(&new_handle->backend.io, new_handle->backend.pipfd[0],
+    ev__nonblock_io_init(&handle->backend.io, handle->backend.pipfd[0],
                          _async_on_wakeup_unix, NULL);
-    ev__nonblock_io_add(loop, &new_handle->backend.io, EV_IO_IN);
-    ev__handle_active(&new_handle->base);
+    ev__nonblock_io_add(loop, &handle->backend.io, EV_IO_IN);
+    ev__handle_active(&handle->base);
 
-    *handle = new_handle;
     return 0;
 
 err_close_handle:
-    _async_close_pipe(new_handle);
-    ev__handle_exit(&new_handle->base, NULL);
-    ev_free(new_handle);
+    _async_close_pipe(handle);
+    ev__handle_exit(&handle->base, NULL);
     return errcode;
 }
 
+size_t ev_async_size(void)
+{
+    return sizeof(ev_async_t);
+}
+
+int ev_async_init(ev_loop_t *loop, ev_async_t **handle, ev_async_cb activate_cb,
+                  void *activate_arg)
+{
+    int         errcode;
+    ev_async_t *new_handle =
+        ev__loop_malloc(loop, EV_ALLOCATOR_TYPE_MISC, sizeof(ev_async_t));
+    if (new_handle == NULL)
+    {
+        return EV_ENOMEM;
+    }
+
+    errcode = _ev_async_init_unix(loop, new_handle, activate_cb, activate_arg);
+    if (errcode != 0)
+    {
+        ev__loop_free(loop, new_handle);
+        return errcode;
+    }
+
+    *handle = new_handle;
+    return 0;
+}
+
+int ev_async_init_inplace(ev_loop_t *loop, ev_async_t **handle,
+                          ev_async_cb activate_cb, void *activate_arg,
+                          void *mem)
+{
+    int         errcode;
+    ev_async_t *new_handle = mem;
+
+    errcode = _ev_async_init_unix(loop, new_handle, activate_cb, activate_arg);
+    if (errcode != 0)
+    {
+        return errcode;
+    }
+    new_handle->base.data.flags |= EV_HANDLE_INPLACE;
+
+    *handle = new_handle;
+    return 0;
+}
+
 void ev_async_exit(ev_async_t *handle, ev_async_cb close_cb, void *close_arg)
 {
     _ev_async_exit(handle, close_cb, close_arg);
@@ -9698,11 +11120,11 @@ void ev_async_wakeup(ev_async_t *handle)
     ev__async_post(handle->backend.pipfd[1]);
 }
 
-// #line 68 "ev.c"
+// #line 75 "ev.c"
 ////////////////////////////////////////////////////////////////////////////////
 // FILE:    ev/unix/fs_unix.c
-// SIZE:    11029
-// SHA-256: 6f59d9af229fa0353c639b421c6d27c4a75e19d092cab36d079f9f535bce19fc
+// SIZE:    11055
+// SHA-256: 76705b7a0b99eb98b29608b2aa5205fb66ce1027af8dd9c0eef1f0596954afdd
 ////////////////////////////////////////////////////////////////////////////////
 // #line 1 "ev/unix/fs_unix.c"
 #define _GNU_SOURCE
@@ -10061,7 +11483,7 @@ EV_LOCAL int ev__fs_readdir(const char* path, ev_fs_readdir_cb cb, void* arg)
 
 EV_LOCAL int ev__fs_mkdir(const char* path, int mode)
 {
-    char* dup_path = ev__strdup(path);
+    char* dup_path = ev__strdup_ext(EV_ALLOCATOR_TYPE_FS, path);
     if (dup_path == NULL)
     {
         return EV_ENOMEM;
@@ -10115,11 +11537,11 @@ void ev_file_munmap(ev_file_map_t* view)
     view->size = 0;
 }
 
-// #line 69 "ev.c"
+// #line 76 "ev.c"
 ////////////////////////////////////////////////////////////////////////////////
 // FILE:    ev/unix/io_unix.c
-// SIZE:    8754
-// SHA-256: 8878dae3342ae9e1c25e2efe760a4b14377439d35a6a14b854f769b0bae6d211
+// SIZE:    12514
+// SHA-256: c2881bd2adc0f8f838d4cd0b48b33c21e98af281780e77ea474e48ade6f6dbfc
 ////////////////////////////////////////////////////////////////////////////////
 // #line 1 "ev/unix/io_unix.c"
 #include <assert.h>
@@ -10128,8 +11550,12 @@ void ev_file_munmap(ev_file_map_t* view)
 #include <fcntl.h>
 #include <sys/ioctl.h>
 #include <sys/uio.h>
+#if defined(__linux__)
+#   include <sys/sendfile.h>
+#   include <linux/errqueue.h>
+#endif
 
-static int _ev_io_finalize_send_req_unix(ev_write_t* req, size_t write_size)
+EV_LOCAL int ev__finalize_send_req_unix(ev_write_t* req, size_t write_size)
 {
     req->size += write_size;
 
@@ -10525,6 +11951,164 @@ EV_LOCAL ssize_t ev__write_unix(int fd, void* buffer, size_t size)
     return ev__translate_sys_error(err);
 }
 
+EV_LOCAL ssize_t ev__sendfile_unix(int out_fd, int in_fd, int64_t offset, size_t count)
+{
+    ssize_t send_size;
+
+#if defined(__linux__)
+    off_t off = (off_t)offset;
+    do
+    {
+        send_size = sendfile(out_fd, in_fd, &off, count);
+    } while (send_size == -1 && errno == EINTR);
+#else
+    /* No portable sendfile(2), bounce through a small buffer */
+    char buf[64 * 1024];
+    if (count > sizeof(buf))
+    {
+        count = sizeof(buf);
+    }
+    do
+    {
+        send_size = pread(in_fd, buf, count, (off_t)offset);
+    } while (send_size == -1 && errno == EINTR);
+    if (send_size <= 0)
+    {
+        return send_size == 0 ? 0 : ev__translate_sys_error(errno);
+    }
+    do
+    {
+        send_size = write(out_fd, buf, send_size);
+    } while (send_size == -1 && errno == EINTR);
+#endif
+
+    if (send_size >= 0)
+    {
+        return send_size;
+    }
+
+    int err = errno;
+    if (err == EAGAIN || err == EWOULDBLOCK)
+    {
+        return EV_EAGAIN;
+    }
+
+    return ev__translate_sys_error(err);
+}
+
+EV_LOCAL ssize_t ev__splice_unix(int fd_in, int fd_out, size_t count)
+{
+#if defined(__linux__)
+    ssize_t ret;
+    do
+    {
+        ret = splice(fd_in, NULL, fd_out, NULL, count,
+            SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+    } while (ret == -1 && errno == EINTR);
+
+    if (ret >= 0)
+    {
+        return ret;
+    }
+
+    int err = errno;
+    if (err == EAGAIN || err == EWOULDBLOCK)
+    {
+        return EV_EAGAIN;
+    }
+
+    return ev__translate_sys_error(err);
+#else
+    (void)fd_in; (void)fd_out; (void)count;
+    return EV_ENOSYS;
+#endif
+}
+
+EV_LOCAL ssize_t ev__sendmsg_zerocopy_unix(int fd, ev_buf_t* iov, int iovcnt)
+{
+#if defined(MSG_ZEROCOPY)
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = (struct iovec*)iov;
+    msg.msg_iovlen = iovcnt;
+
+    ssize_t send_size;
+    do
+    {
+        send_size = sendmsg(fd, &msg, MSG_ZEROCOPY);
+    } while (send_size == -1 && errno == EINTR);
+
+    if (send_size >= 0)
+    {
+        return send_size;
+    }
+
+    int err = errno;
+    if (err == EAGAIN || err == EWOULDBLOCK)
+    {
+        return 0;
+    }
+
+    return ev__translate_sys_error(err);
+#else
+    return ev__writev_unix(fd, iov, iovcnt);
+#endif
+}
+
+EV_LOCAL int ev__zerocopy_notify_unix(int fd, uint32_t* lo, uint32_t* hi)
+{
+#if defined(SO_EE_ORIGIN_ZEROCOPY)
+    for (;;)
+    {
+        /* Room for #sock_extended_err and the offender address */
+        char control[128];
+        struct msghdr msg;
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof(control);
+
+        ssize_t ret;
+        do
+        {
+            ret = recvmsg(fd, &msg, MSG_ERRQUEUE);
+        } while (ret == -1 && errno == EINTR);
+
+        if (ret < 0)
+        {
+            int err = errno;
+            if (err == EAGAIN || err == EWOULDBLOCK)
+            {
+                return 0;
+            }
+            return ev__translate_sys_error(err);
+        }
+
+        struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+        for (; cmsg != NULL; cmsg = CMSG_NXTHDR(&msg, cmsg))
+        {
+            if (!(cmsg->cmsg_level == IPPROTO_IP && cmsg->cmsg_type == IP_RECVERR)
+                && !(cmsg->cmsg_level == IPPROTO_IPV6 && cmsg->cmsg_type == IPV6_RECVERR))
+            {
+                continue;
+            }
+
+            struct sock_extended_err* serr = (struct sock_extended_err*)CMSG_DATA(cmsg);
+            if (serr->ee_errno == 0 && serr->ee_origin == SO_EE_ORIGIN_ZEROCOPY)
+            {
+                *lo = serr->ee_info;
+                *hi = serr->ee_data;
+                return 1;
+            }
+        }
+    }
+#else
+    (void)fd;
+    (void)lo;
+    (void)hi;
+    return 0;
+#endif
+}
+
 EV_LOCAL int ev__send_unix(int fd, ev_write_t* req,
     ssize_t(*do_write)(int fd, struct iovec* iov, int iovcnt, void* arg), void* arg)
 {
@@ -10547,14 +12131,14 @@ EV_LOCAL int ev__send_unix(int fd, ev_write_t* req,
         return write_size;
     }
 
-    return _ev_io_finalize_send_req_unix(req, (size_t)write_size);
+    return ev__finalize_send_req_unix(req, (size_t)write_size);
 }
 
-// #line 70 "ev.c"
+// #line 77 "ev.c"
 ////////////////////////////////////////////////////////////////////////////////
 // FILE:    ev/unix/loop_unix.c
-// SIZE:    4177
-// SHA-256: 331beb7e207b61cc9699b689b8ed3bfb01612064d435cd3e8c752e2a5494ac21
+// SIZE:    4537
+// SHA-256: 23c9d74234f2845203fb9c1a90b44b6080ec5b9aef28fc668128993f92d49fb3
 ////////////////////////////////////////////////////////////////////////////////
 // #line 1 "ev/unix/loop_unix.c"
 #include <assert.h>
@@ -10562,14 +12146,7 @@ EV_LOCAL int ev__send_unix(int fd, ev_write_t* req,
 #include <errno.h>
 #include <limits.h>
 #include <sys/eventfd.h>
-
-#if defined(__PASE__)
-/* on IBMi PASE the control message length can not exceed 256. */
-#   define EV__CMSG_FD_COUNT 60
-#else
-#   define EV__CMSG_FD_COUNT 64
-#endif
-#define EV__CMSG_FD_SIZE (EV__CMSG_FD_COUNT * sizeof(int))
+#include <netinet/udp.h>
 
 ev_loop_unix_ctx_t g_ev_loop_unix_ctx;
 
@@ -10635,6 +12212,24 @@ static void _ev_init_iovmax(void)
 #endif
 }
 
+static void _ev_init_udp_gso(void)
+{
+    g_ev_loop_unix_ctx.udp_gso = 0;
+#if defined(UDP_SEGMENT)
+    int sock = socket(AF_INET, SOCK_DGRAM, 0);
+    if (sock < 0)
+    {
+        return;
+    }
+
+    int       val = 0;
+    socklen_t len = sizeof(val);
+    g_ev_loop_unix_ctx.udp_gso =
+        getsockopt(sock, SOL_UDP, UDP_SEGMENT, &val, &len) == 0;
+    close(sock);
+#endif
+}
+
 static void _ev_check_layout_unix(void)
 {
     ENSURE_LAYOUT(ev_buf_t, data, size, struct iovec, iov_base, iov_len);
@@ -10645,6 +12240,7 @@ static void _ev_init_once_unix(void)
     _ev_check_layout_unix();
     _ev_init_hwtime();
     _ev_init_iovmax();
+    _ev_init_udp_gso();
     ev__init_process_unix();
 }
 
@@ -10659,12 +12255,18 @@ EV_LOCAL int ev__loop_init_backend(ev_loop_t* loop)
     ev__init_once_unix();
     ev__init_io(loop);
     ev__init_work(loop);
+    loop->backend.emfile_fd = -1;
 
     return 0;
 }
 
 EV_LOCAL void ev__loop_exit_backend(ev_loop_t* loop)
 {
+    if (loop->backend.emfile_fd != -1)
+    {
+        close(loop->backend.emfile_fd);
+        loop->backend.emfile_fd = -1;
+    }
     ev__exit_work(loop);
     ev__exit_io(loop);
 }
@@ -10730,7 +12332,7 @@ EV_LOCAL void ev__poll(ev_loop_t* loop, uint32_t timeout)
     }
 }
 
-// #line 71 "ev.c"
+// #line 78 "ev.c"
 ////////////////////////////////////////////////////////////////////////////////
 // FILE:    ev/unix/misc_unix.c
 // SIZE:    356
@@ -10760,7 +12362,7 @@ void ev__backend_shutdown(void)
     ev__exit_process_unix();
 }
 
-// #line 72 "ev.c"
+// #line 79 "ev.c"
 ////////////////////////////////////////////////////////////////////////////////
 // FILE:    ev/unix/misc_random_unix.c
 // SIZE:    7547
@@ -11122,7 +12724,7 @@ EV_LOCAL int ev__random(void* buf, size_t len)
 
 #endif
 
-// #line 73 "ev.c"
+// #line 80 "ev.c"
 ////////////////////////////////////////////////////////////////////////////////
 // FILE:    ev/unix/mutex_unix.c
 // SIZE:    2029
@@ -11254,7 +12856,7 @@ int ev_mutex_try_enter(ev_mutex_t *handle)
     return EV_EBUSY;
 }
 
-// #line 74 "ev.c"
+// #line 81 "ev.c"
 ////////////////////////////////////////////////////////////////////////////////
 // FILE:    ev/unix/once_unix.c
 // SIZE:    157
@@ -11271,11 +12873,11 @@ void ev_once_execute(ev_once_t* guard, ev_once_cb cb)
     }
 }
 
-// #line 75 "ev.c"
+// #line 82 "ev.c"
 ////////////////////////////////////////////////////////////////////////////////
 // FILE:    ev/unix/pipe_unix.c
-// SIZE:    27171
-// SHA-256: a9b15c67084d259e78d7fcdbe6e78cae9ae2d2ab4816c8e22a806ce2f4fd25a0
+// SIZE:    35598
+// SHA-256: 2faf6f45b6fbee27012443691a22fbd32f90786737fa57992c098b18bc3c8759
 ////////////////////////////////////////////////////////////////////////////////
 // #line 1 "ev/unix/pipe_unix.c"
 #define _GNU_SOURCE
@@ -11284,7 +12886,30 @@ void ev_once_execute(ev_once_t* guard, ev_once_cb cb)
 #include <unistd.h>
 #include <string.h>
 
-typedef char ev_ipc_msghdr[CMSG_SPACE(sizeof(int))];
+/**
+ * @brief Receive buffer size for IPC mode.
+ *
+ * Small frames are parsed from this buffer in batch, larger frame data is read
+ * into user buffer directly.
+ */
+#define EV_PIPE_IPC_RBUF_SIZE (64 * 1024)
+
+/**
+ * @brief Maximum buffers packed into one sendmsg() in IPC mode. Each frame
+ *   takes one more buffer for its header.
+ */
+#define EV_PIPE_IPC_WIOV_MAX  64
+
+typedef char ev_ipc_msghdr[CMSG_SPACE(sizeof(int) * EV_PIPE_IPC_HANDLE_MAX)];
+
+static void _ev_pipe_close_fds_unix(const int *fds, size_t num)
+{
+    size_t i;
+    for (i = 0; i < num; i++)
+    {
+        close(fds[i]);
+    }
+}
 
 static void _ev_pipe_close_unix(ev_pipe_t *pipe)
 {
@@ -11298,9 +12923,13 @@ static void _ev_pipe_close_unix(ev_pipe_t *pipe)
 static void _ev_pipe_on_close_unix(ev_handle_t *handle)
 {
     ev_pipe_t *pipe_handle = EV_CONTAINER_OF(handle, ev_pipe_t, base);
+    ev_loop_t *loop = pipe_handle->base.loop;
     ev_pipe_cb close_cb = pipe_handle->close_cb;
     void      *close_arg = pipe_handle->close_arg;
-    ev_free(pipe_handle);
+    if (!(pipe_handle->base.data.flags & EV_HANDLE_INPLACE))
+    {
+        ev__loop_free(loop, pipe_handle);
+    }
 
     if (close_cb != NULL)
     {
@@ -11322,7 +12951,6 @@ static void _ev_pipe_smart_deactive(ev_pipe_t *pipe)
         io_sz += ev_list_size(&pipe->backend.ipc_mode.rio.rqueue);
         io_sz += pipe->backend.ipc_mode.rio.curr.reading != NULL ? 1 : 0;
         io_sz += ev_list_size(&pipe->backend.ipc_mode.wio.wqueue);
-        io_sz += pipe->backend.ipc_mode.wio.curr.writing != NULL ? 1 : 0;
     }
     else
     {
@@ -11343,7 +12971,7 @@ static void _ev_pipe_w_user_callback_unix(ev_pipe_t           *pipe,
     _ev_pipe_smart_deactive(pipe);
     ev__write_exit(&req->base);
     req->ucb(pipe, size, req->ucb_arg);
-    ev_free(req);
+    ev__loop_free(pipe->base.loop, req);
 }
 
 static void _ev_pipe_r_user_callback_unix(ev_pipe_t          *pipe,
@@ -11374,20 +13002,51 @@ static void _ev_pipe_on_data_mode_read_unix(ev_nonblock_stream_t *stream,
     _ev_pipe_r_user_callback_unix(pipe_handle, r_req, size);
 }
 
-static int _ev_pipe_on_ipc_mode_io_read_remain(ev_pipe_t *pipe)
+/**
+ * @brief Move read cursor of current request forward by \p size bytes.
+ */
+static void _ev_pipe_ipc_mode_advance_rio_unix(ev_pipe_t *pipe, size_t size)
 {
-    assert(pipe->backend.ipc_mode.rio.curr.reading != NULL);
+    ev_pipe_read_req_t *req = pipe->backend.ipc_mode.rio.curr.reading;
 
-    ev_buf_t bufs[EV_IOV_MAX];
-    size_t   target_size = pipe->backend.ipc_mode.rio.curr.data_remain_size;
+    pipe->backend.ipc_mode.rio.curr.data_remain_size -= size;
+    req->base.data.size += size;
+
+    while (size > 0 &&
+           pipe->backend.ipc_mode.rio.curr.buf_idx < req->base.data.nbuf)
+    {
+        size_t left_size =
+            req->base.data.bufs[pipe->backend.ipc_mode.rio.curr.buf_idx].size -
+            pipe->backend.ipc_mode.rio.curr.buf_pos;
+
+        if (left_size > size)
+        {
+            pipe->backend.ipc_mode.rio.curr.buf_pos += size;
+            break;
+        }
+
+        size -= left_size;
+        pipe->backend.ipc_mode.rio.curr.buf_idx++;
+        pipe->backend.ipc_mode.rio.curr.buf_pos = 0;
+    }
+}
+
+/**
+ * @brief Get unfilled part of current request, limited to remain frame data.
+ * @return  Number of buffers.
+ */
+static size_t _ev_pipe_ipc_mode_rio_bufs_unix(ev_pipe_t *pipe, ev_buf_t *bufs,
+                                              size_t nbuf)
+{
     ev_pipe_read_req_t *req = pipe->backend.ipc_mode.rio.curr.reading;
+    size_t target_size = pipe->backend.ipc_mode.rio.curr.data_remain_size;
 
     size_t buf_idx = pipe->backend.ipc_mode.rio.curr.buf_idx;
     size_t buf_pos = pipe->backend.ipc_mode.rio.curr.buf_pos;
 
     size_t idx;
-    for (idx = 0; idx < ARRAY_SIZE(bufs) && target_size > 0 &&
-                  buf_idx < req->base.data.nbuf;
+    for (idx = 0;
+         idx < nbuf && target_size > 0 && buf_idx < req->base.data.nbuf;
          idx++, buf_idx++)
     {
         bufs[idx].data = (uint8_t *)req->base.data.bufs[buf_idx].data + buf_pos;
@@ -11399,53 +13058,50 @@ static int _ev_pipe_on_ipc_mode_io_read_remain(ev_pipe_t *pipe)
         buf_pos = 0;
     }
 
-    ssize_t read_size = ev__readv_unix(pipe->pipfd, bufs, idx);
-    if (read_size < 0)
-    {
-        return read_size;
-    }
+    return idx;
+}
 
-    pipe->backend.ipc_mode.rio.curr.data_remain_size -= read_size;
-    req->base.data.size += read_size;
+/**
+ * @brief Copy buffered frame data into current request.
+ */
+static void _ev_pipe_ipc_mode_copy_data_unix(ev_pipe_t *pipe)
+{
+    ev_buf_t bufs[EV_IOV_MAX];
+    size_t   nbuf = _ev_pipe_ipc_mode_rio_bufs_unix(pipe, bufs, ARRAY_SIZE(bufs));
 
-    /* no data remain */
-    if (pipe->backend.ipc_mode.rio.curr.data_remain_size == 0)
-    {
-        goto callback;
-    }
+    const uint8_t *data =
+        pipe->backend.ipc_mode.rio.buffer + pipe->backend.ipc_mode.rio.pos;
+    size_t data_size =
+        pipe->backend.ipc_mode.rio.len - pipe->backend.ipc_mode.rio.pos;
 
-    /* move cursor */
-    while (read_size > 0 &&
-           pipe->backend.ipc_mode.rio.curr.buf_idx < req->base.data.nbuf)
+    size_t i;
+    size_t copy_size = 0;
+    for (i = 0; i < nbuf && copy_size < data_size; i++)
     {
-        size_t left_size =
-            req->base.data.bufs[pipe->backend.ipc_mode.rio.curr.buf_idx].size -
-            pipe->backend.ipc_mode.rio.curr.buf_pos;
+        size_t n = EV_MIN(bufs[i].size, data_size - copy_size);
+        memcpy(bufs[i].data, data + copy_size, n);
+        copy_size += n;
+    }
 
-        if (left_size > (size_t)read_size)
-        {
-            pipe->backend.ipc_mode.rio.curr.buf_pos += read_size;
-            break;
-        }
+    pipe->backend.ipc_mode.rio.pos += copy_size;
+    _ev_pipe_ipc_mode_advance_rio_unix(pipe, copy_size);
+}
 
-        read_size -= left_size;
-        pipe->backend.ipc_mode.rio.curr.buf_idx++;
-        pipe->backend.ipc_mode.rio.curr.buf_pos = 0;
-        continue;
-    }
+/**
+ * @brief Read frame data into current request directly.
+ * @return  Read size, 0 if try again, or #ev_errno_t.
+ */
+static ssize_t _ev_pipe_ipc_mode_read_data_unix(ev_pipe_t *pipe)
+{
+    ev_buf_t bufs[EV_IOV_MAX];
+    size_t   nbuf = _ev_pipe_ipc_mode_rio_bufs_unix(pipe, bufs, ARRAY_SIZE(bufs));
 
-    /* Buffer is full */
-    if (pipe->backend.ipc_mode.rio.curr.buf_idx >= req->base.data.nbuf)
+    ssize_t read_size = ev__readv_unix(pipe->pipfd, bufs, nbuf);
+    if (read_size > 0)
     {
-        goto callback;
+        _ev_pipe_ipc_mode_advance_rio_unix(pipe, read_size);
     }
-
-    return 0;
-
-callback:
-    pipe->backend.ipc_mode.rio.curr.reading = NULL;
-    _ev_pipe_r_user_callback_unix(pipe, req, req->base.data.size);
-    return 0;
+    return read_size;
 }
 
 static ssize_t _ev_pipe_recvmsg_unix(ev_pipe_t *pipe, struct msghdr *msg)
@@ -11504,128 +13160,223 @@ static ssize_t _ev_pipe_recvmsg_unix(ev_pipe_t *pipe, struct msghdr *msg)
     return rc;
 }
 
-static void _ev_stream_do_read_parser_msghdr(ev_pipe_read_req_t *req,
-                                             struct msghdr      *msg)
+/**
+ * @brief Keep received handles until their frame header is parsed.
+ *
+ * The kernel never merges data after a message carrying descriptors into one
+ * read, and such frame is always sent alone, so at most one list of handles
+ * can wait.
+ */
+static int _ev_pipe_ipc_mode_parser_msghdr_unix(ev_pipe_t     *pipe,
+                                                struct msghdr *msg)
 {
     struct cmsghdr *cmsg = CMSG_FIRSTHDR(msg);
     if (cmsg == NULL)
     {
-        return;
+        return 0;
     }
 
-    void *pv = CMSG_DATA(cmsg);
-    int  *pi = pv;
-    req->handle.os_socket = *pi;
-
+    void  *pv = CMSG_DATA(cmsg);
+    int   *pi = pv;
+    size_t num = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
     assert(CMSG_NXTHDR(msg, cmsg) == NULL);
+
+    /* Peer never sends more than #EV_PIPE_IPC_HANDLE_MAX handles */
+    if ((msg->msg_flags & MSG_CTRUNC) ||
+        pipe->backend.ipc_mode.rio.fd_num != 0)
+    {
+        _ev_pipe_close_fds_unix(pi, num);
+        return EV_EPIPE;
+    }
+    memcpy(pipe->backend.ipc_mode.rio.fds, pi, num * sizeof(int));
+    pipe->backend.ipc_mode.rio.fd_num = num;
+
+    return 0;
 }
 
-static int _ev_pipe_on_ipc_mode_io_read_first(ev_pipe_t *pipe)
+/**
+ * @brief Receive as much as possible into receive buffer.
+ * @return  Read size, 0 if try again, or #ev_errno_t.
+ */
+static ssize_t _ev_pipe_ipc_mode_recv_unix(ev_pipe_t *pipe)
 {
-    void *buffer = (uint8_t *)pipe->backend.ipc_mode.rio.buffer +
-                   pipe->backend.ipc_mode.rio.curr.head_read_size;
-    size_t buffer_size = sizeof(pipe->backend.ipc_mode.rio.buffer) -
-                         pipe->backend.ipc_mode.rio.curr.head_read_size;
+    uint8_t *buffer = pipe->backend.ipc_mode.rio.buffer;
+    size_t   data_size =
+        pipe->backend.ipc_mode.rio.len - pipe->backend.ipc_mode.rio.pos;
 
-    if (pipe->backend.ipc_mode.rio.curr.head_read_size == 0)
+    /* Only a partial frame header may be left */
+    if (pipe->backend.ipc_mode.rio.pos != 0)
     {
-        struct msghdr msg;
-        ev_ipc_msghdr cmsg_space;
-        struct iovec  iov = { buffer, buffer_size };
-
-        /* ipc uses recvmsg */
-        msg.msg_flags = 0;
-        msg.msg_iov = &iov;
-        msg.msg_iovlen = 1;
-        msg.msg_name = NULL;
-        msg.msg_namelen = 0;
-        /* Set up to receive a descriptor even if one isn't in the message */
-        msg.msg_controllen = sizeof(cmsg_space);
-        msg.msg_control = cmsg_space;
-
-        ssize_t read_size = _ev_pipe_recvmsg_unix(pipe, &msg);
-        if (read_size <= 0)
-        { /* Error or EOF */
-            return read_size;
-        }
-        assert(read_size <= (ssize_t)sizeof(pipe->backend.ipc_mode.rio.buffer));
-
-        _ev_stream_do_read_parser_msghdr(
-            pipe->backend.ipc_mode.rio.curr.reading, &msg);
-        pipe->backend.ipc_mode.rio.curr.head_read_size += read_size;
+        memmove(buffer, buffer + pipe->backend.ipc_mode.rio.pos, data_size);
+        pipe->backend.ipc_mode.rio.pos = 0;
+        pipe->backend.ipc_mode.rio.len = data_size;
     }
-    else
+
+    /*
+     * Finish a partial frame header before reading more, so handle from next
+     * message cannot arrive before the waiting one is taken.
+     */
+    size_t buffer_size = EV_PIPE_IPC_RBUF_SIZE - data_size;
+    if (data_size != 0 && pipe->backend.ipc_mode.rio.curr.data_remain_size == 0)
     {
-        ssize_t read_size = read(pipe->pipfd, buffer, buffer_size);
-        if (read_size == 0)
-        {
-            return EV_EOF;
-        }
-        if (read_size < 0)
-        {
-            int err = errno;
-            if (err == EAGAIN)
-            { /* try again */
-                return 0;
-            }
-            return ev__translate_sys_error(err);
-        }
-        pipe->backend.ipc_mode.rio.curr.head_read_size += read_size;
+        buffer_size = sizeof(ev_ipc_frame_hdr_t) - data_size;
     }
 
-    /* If frame header not read complete, try again */
-    if (pipe->backend.ipc_mode.rio.curr.head_read_size <
-        sizeof(ev_ipc_frame_hdr_t))
+    struct msghdr msg;
+    ev_ipc_msghdr cmsg_space;
+    struct iovec  iov = { buffer + data_size, buffer_size };
+
+    /* ipc uses recvmsg */
+    msg.msg_flags = 0;
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_name = NULL;
+    msg.msg_namelen = 0;
+    /* Set up to receive a descriptor even if one isn't in the message */
+    msg.msg_controllen = sizeof(cmsg_space);
+    msg.msg_control = cmsg_space;
+
+    ssize_t read_size = _ev_pipe_recvmsg_unix(pipe, &msg);
+    if (read_size == EV_EAGAIN)
     {
         return 0;
     }
+    if (read_size == 0)
+    {
+        return EV_EOF;
+    }
+    if (read_size < 0)
+    {
+        return read_size;
+    }
+
+    pipe->backend.ipc_mode.rio.len += read_size;
+
+    int ret = _ev_pipe_ipc_mode_parser_msghdr_unix(pipe, &msg);
+    return ret != 0 ? ret : read_size;
+}
+
+/**
+ * @brief Parse buffered frame header for current request.
+ */
+static int _ev_pipe_ipc_mode_parse_frame_hdr_unix(ev_pipe_t *pipe)
+{
+    const uint8_t *buffer =
+        pipe->backend.ipc_mode.rio.buffer + pipe->backend.ipc_mode.rio.pos;
 
     /* A invalid frame header means something wrong in the transmission link */
-    if (!ev__ipc_check_frame_hdr(pipe->backend.ipc_mode.rio.buffer,
-                                 sizeof(ev_ipc_frame_hdr_t)))
+    if (!ev__ipc_check_frame_hdr(buffer, sizeof(ev_ipc_frame_hdr_t)))
     {
         return EV_EPIPE;
     }
 
-    ev_ipc_frame_hdr_t *hdr =
-        (ev_ipc_frame_hdr_t *)pipe->backend.ipc_mode.rio.buffer;
-    pipe->backend.ipc_mode.rio.curr.data_remain_size = hdr->hdr_dtsz;
+    ev_ipc_frame_hdr_t hdr;
+    memcpy(&hdr, buffer, sizeof(hdr));
+    pipe->backend.ipc_mode.rio.pos += sizeof(hdr);
+    pipe->backend.ipc_mode.rio.curr.data_remain_size = hdr.hdr_dtsz;
 
-    /* No data remain to read means peer send a empty package */
-    if (pipe->backend.ipc_mode.rio.curr.data_remain_size == 0)
+    if (hdr.hdr_flags & EV_IPC_FRAME_FLAG_HANDLE)
     {
         ev_pipe_read_req_t *req = pipe->backend.ipc_mode.rio.curr.reading;
-        pipe->backend.ipc_mode.rio.curr.reading = NULL;
-        _ev_pipe_r_user_callback_unix(pipe, req, req->base.data.size);
+        memcpy(req->handle.os_socket, pipe->backend.ipc_mode.rio.fds,
+               pipe->backend.ipc_mode.rio.fd_num * sizeof(int));
+        req->handle.num = pipe->backend.ipc_mode.rio.fd_num;
+        req->handle.pos = 0;
+        pipe->backend.ipc_mode.rio.fd_num = 0;
     }
 
-    /* Process to read body */
-    return _ev_pipe_on_ipc_mode_io_read_remain(pipe);
+    return 0;
 }
 
 static int _ev_pipe_on_ipc_mode_io_read_unix(ev_pipe_t *pipe)
 {
-    if (pipe->backend.ipc_mode.rio.curr.data_remain_size != 0)
+    ssize_t ret;
+
+    for (;;)
     {
-        return _ev_pipe_on_ipc_mode_io_read_remain(pipe);
-    }
+        if (pipe->backend.ipc_mode.rio.curr.reading == NULL)
+        {
+            ev_list_node_t *it =
+                ev_list_pop_front(&pipe->backend.ipc_mode.rio.rqueue);
+            if (it == NULL)
+            {
+                return 0;
+            }
 
-    assert(pipe->backend.ipc_mode.rio.curr.reading == NULL);
+            pipe->backend.ipc_mode.rio.curr.reading =
+                EV_CONTAINER_OF(it, ev_pipe_read_req_t, base.node);
+            pipe->backend.ipc_mode.rio.curr.buf_idx = 0;
+            pipe->backend.ipc_mode.rio.curr.buf_pos = 0;
+        }
 
-    ev_list_node_t *it = ev_list_pop_front(&pipe->backend.ipc_mode.rio.rqueue);
-    assert(it != NULL);
+        size_t data_size =
+            pipe->backend.ipc_mode.rio.len - pipe->backend.ipc_mode.rio.pos;
+        if (pipe->backend.ipc_mode.rio.curr.data_remain_size == 0)
+        {
+            /* If frame header not read complete, try again */
+            if (data_size < sizeof(ev_ipc_frame_hdr_t))
+            {
+                if ((ret = _ev_pipe_ipc_mode_recv_unix(pipe)) <= 0)
+                {
+                    return ret;
+                }
+                continue;
+            }
 
-    pipe->backend.ipc_mode.rio.curr.reading =
-        EV_CONTAINER_OF(it, ev_pipe_read_req_t, base.node);
-    pipe->backend.ipc_mode.rio.curr.head_read_size = 0;
-    pipe->backend.ipc_mode.rio.curr.buf_idx = 0;
-    pipe->backend.ipc_mode.rio.curr.buf_pos = 0;
+            if ((ret = _ev_pipe_ipc_mode_parse_frame_hdr_unix(pipe)) != 0)
+            {
+                return ret;
+            }
+            data_size -= sizeof(ev_ipc_frame_hdr_t);
+        }
+
+        /* Empty package is finished without reading */
+        if (pipe->backend.ipc_mode.rio.curr.data_remain_size != 0)
+        {
+            if (data_size != 0)
+            {
+                _ev_pipe_ipc_mode_copy_data_unix(pipe);
+            }
+            else if (pipe->backend.ipc_mode.rio.curr.data_remain_size >=
+                     EV_PIPE_IPC_RBUF_SIZE)
+            {
+                /* Large data bypass receive buffer */
+                if ((ret = _ev_pipe_ipc_mode_read_data_unix(pipe)) <= 0)
+                {
+                    return ret;
+                }
+            }
+            else
+            {
+                if ((ret = _ev_pipe_ipc_mode_recv_unix(pipe)) <= 0)
+                {
+                    return ret;
+                }
+                continue;
+            }
+        }
 
-    return _ev_pipe_on_ipc_mode_io_read_first(pipe);
+        ev_pipe_read_req_t *req = pipe->backend.ipc_mode.rio.curr.reading;
+        if (pipe->backend.ipc_mode.rio.curr.data_remain_size != 0 &&
+            pipe->backend.ipc_mode.rio.curr.buf_idx < req->base.data.nbuf)
+        {
+            continue;
+        }
+
+        /* Frame finished or buffer is full */
+        pipe->backend.ipc_mode.rio.curr.reading = NULL;
+        _ev_pipe_r_user_callback_unix(pipe, req, req->base.data.size);
+
+        /* Pipe closed in callback */
+        if (pipe->pipfd == EV_OS_PIPE_INVALID)
+        {
+            return 0;
+        }
+    }
 }
 
-static ssize_t _ev_pipe_sendmsg_unix(int fd, int fd_to_send, struct iovec *iov,
-                                     int iovcnt)
+static ssize_t _ev_pipe_sendmsg_unix(int fd, const int *fds_to_send,
+                                     size_t nfd, struct iovec *iov, int iovcnt)
 {
     struct msghdr   msg;
     struct cmsghdr *cmsg;
@@ -11638,20 +13389,19 @@ static ssize_t _ev_pipe_sendmsg_unix(int fd, int fd_to_send, struct iovec *iov,
     msg.msg_iov = iov;
     msg.msg_iovlen = iovcnt;
     msg.msg_flags = 0;
+    msg.msg_control = NULL;
+    msg.msg_controllen = 0;
 
-    msg.msg_control = msg_ctrl_hdr;
-    msg.msg_controllen = sizeof(msg_ctrl_hdr);
-
-    cmsg = CMSG_FIRSTHDR(&msg);
-    cmsg->cmsg_level = SOL_SOCKET;
-    cmsg->cmsg_type = SCM_RIGHTS;
-    cmsg->cmsg_len = CMSG_LEN(sizeof(fd_to_send));
-
-    /* silence aliasing warning */
+    if (nfd != 0)
     {
-        void *pv = CMSG_DATA(cmsg);
-        int  *pi = pv;
-        *pi = fd_to_send;
+        msg.msg_control = msg_ctrl_hdr;
+        msg.msg_controllen = CMSG_SPACE(sizeof(int) * nfd);
+
+        cmsg = CMSG_FIRSTHDR(&msg);
+        cmsg->cmsg_level = SOL_SOCKET;
+        cmsg->cmsg_type = SCM_RIGHTS;
+        cmsg->cmsg_len = CMSG_LEN(sizeof(int) * nfd);
+        memcpy(CMSG_DATA(cmsg), fds_to_send, sizeof(int) * nfd);
     }
 
     ssize_t n;
@@ -11673,186 +13423,164 @@ static ssize_t _ev_pipe_sendmsg_unix(int fd, int fd_to_send, struct iovec *iov,
     return ev__translate_sys_error(err);
 }
 
-static int _ev_pipe_on_ipc_mode_io_write_remain_body_unix(ev_pipe_t *pipe)
+/**
+ * @brief Append unsent part of \p req to \p iov.
+ * @param[in] req       Write request
+ * @param[out] iov      Buffer list
+ * @param[in] niov      Buffer list capacity
+ * @param[in,out] size  Total size of appended buffers is added
+ * @return              Number of appended buffers
+ */
+static size_t _ev_pipe_ipc_mode_fill_iov_unix(ev_pipe_write_req_t *req,
+                                              ev_buf_t *iov, size_t niov,
+                                              size_t *size)
 {
-    ev_buf_t             bufs[EV_IOV_MAX];
-    ev_pipe_write_req_t *req = pipe->backend.ipc_mode.wio.curr.writing;
-    assert(req != NULL);
-
-    size_t buf_idx = pipe->backend.ipc_mode.wio.curr.buf_idx;
-    size_t buf_pos = pipe->backend.ipc_mode.wio.curr.buf_pos;
+    size_t idx = 0;
+    size_t skip = req->backend.sent;
 
-    size_t idx;
-    for (idx = 0; idx < ARRAY_SIZE(bufs) && buf_idx < req->base.nbuf;
-         idx++, buf_idx++)
+    if (skip < sizeof(req->backend.hdr))
     {
-        bufs[idx].data = (uint8_t *)req->base.bufs[buf_idx].data + buf_pos;
-        bufs[idx].size = req->base.bufs[buf_idx].size - buf_pos;
-        buf_pos = 0;
+        iov[idx].data = (uint8_t *)&req->backend.hdr + skip;
+        iov[idx].size = sizeof(req->backend.hdr) - skip;
+        *size += iov[idx].size;
+        idx++;
+        skip = 0;
     }
-
-    ssize_t write_size = ev__writev_unix(pipe->pipfd, bufs, idx);
-    if (write_size < 0)
+    else
     {
-        return write_size;
+        skip -= sizeof(req->backend.hdr);
     }
 
-    req->base.size += write_size;
-    while (write_size > 0)
+    size_t i;
+    for (i = 0; i < req->base.nbuf && idx < niov; i++)
     {
-        size_t left_size =
-            req->base.bufs[pipe->backend.ipc_mode.wio.curr.buf_idx].size -
-            pipe->backend.ipc_mode.wio.curr.buf_pos;
-        if (left_size > (size_t)write_size)
+        ev_buf_t *buf = &req->base.bufs[i];
+        if (skip >= buf->size)
         {
-            pipe->backend.ipc_mode.wio.curr.buf_pos += write_size;
-            write_size = 0;
-            break;
+            skip -= buf->size;
+            continue;
         }
 
-        write_size -= left_size;
-        pipe->backend.ipc_mode.wio.curr.buf_idx++;
-        pipe->backend.ipc_mode.wio.curr.buf_pos = 0;
-    }
-
-    /* send finish */
-    if (pipe->backend.ipc_mode.wio.curr.buf_idx >= req->base.nbuf)
-    {
-        pipe->backend.ipc_mode.wio.curr.writing = NULL;
-        _ev_pipe_w_user_callback_unix(pipe, req, req->base.size);
+        iov[idx].data = (uint8_t *)buf->data + skip;
+        iov[idx].size = buf->size - skip;
+        *size += iov[idx].size;
+        idx++;
+        skip = 0;
     }
 
-    return 0;
+    return idx;
 }
 
-static int _ev_pipe_on_ipc_mode_io_write_remain_head_unix(ev_pipe_t *pipe)
+static size_t _ev_pipe_ipc_mode_frame_left_unix(ev_pipe_write_req_t *req)
 {
-    EV_LOG_TRACE("pipe(%p) send remain header", pipe);
-
-    const size_t buffer_pos = pipe->backend.ipc_mode.wio.curr.head_send_size;
-    void        *buffer = pipe->backend.ipc_mode.wio.buffer + buffer_pos;
-    size_t       buffer_size =
-        pipe->backend.ipc_mode.wio.curr.head_send_capacity - buffer_pos;
+    return sizeof(req->backend.hdr) + req->base.capacity - req->backend.sent;
+}
 
-    ssize_t send_size = ev__write_unix(pipe->pipfd, buffer, buffer_size);
-    if (send_size < 0)
+/**
+ * @brief Move fully sent requests from write queue to \p done.
+ */
+static void _ev_pipe_ipc_mode_commit_wio_unix(ev_pipe_t *pipe, size_t size,
+                                              ev_list_t *done)
+{
+    ev_list_node_t *it;
+    while ((it = ev_list_begin(&pipe->backend.ipc_mode.wio.wqueue)) != NULL)
     {
-        return send_size;
-    }
-    pipe->backend.ipc_mode.wio.curr.head_send_size += send_size;
+        ev_pipe_write_req_t *req =
+            EV_CONTAINER_OF(it, ev_pipe_write_req_t, base.node);
+        size_t left_size = _ev_pipe_ipc_mode_frame_left_unix(req);
+        if (size < left_size)
+        {
+            req->backend.sent += size;
+            break;
+        }
 
-    /* try again */
-    if ((size_t)send_size < buffer_size)
-    {
-        return 0;
+        size -= left_size;
+        req->backend.sent += left_size;
+        req->base.size = req->base.capacity;
+        ev_list_erase(&pipe->backend.ipc_mode.wio.wqueue, it);
+        ev_list_push_back(done, it);
     }
-
-    /* Write body */
-    return _ev_pipe_on_ipc_mode_io_write_remain_body_unix(pipe);
 }
 
-static int _ev_pipe_on_ipc_mode_io_write_remain_unix(ev_pipe_t *pipe)
+static int _ev_pipe_on_ipc_mode_io_write_unix(ev_pipe_t *pipe)
 {
-    if (pipe->backend.ipc_mode.wio.curr.head_send_size <
-        pipe->backend.ipc_mode.wio.curr.head_send_capacity)
-    {
-        return _ev_pipe_on_ipc_mode_io_write_remain_head_unix(pipe);
-    }
+    int             ret = 0;
+    ev_list_t       done = EV_LIST_INIT;
+    ev_list_node_t *it;
+    ev_buf_t        iov[EV_PIPE_IPC_WIOV_MAX];
 
-    return _ev_pipe_on_ipc_mode_io_write_remain_body_unix(pipe);
-}
+    while ((it = ev_list_begin(&pipe->backend.ipc_mode.wio.wqueue)) != NULL)
+    {
+        ev_pipe_write_req_t *first =
+            EV_CONTAINER_OF(it, ev_pipe_write_req_t, base.node);
+        size_t nfd = first->handle.num;
 
-static int _ev_pipe_ipc_mode_write_new_frame_unix(ev_pipe_t *pipe)
-{
-    ev_pipe_write_req_t *req = pipe->backend.ipc_mode.wio.curr.writing;
+        /* Pack as many frames as possible into one message */
+        size_t niov = 0;
+        size_t size = 0;
+        for (; it != NULL && niov < ARRAY_SIZE(iov); it = ev_list_next(it))
+        {
+            ev_pipe_write_req_t *req =
+                EV_CONTAINER_OF(it, ev_pipe_write_req_t, base.node);
+            if (req != first && req->handle.num != 0)
+            {
+                break;
+            }
 
-    ev_ipc_frame_hdr_t frame_hdr;
-    ev__ipc_init_frame_hdr(&frame_hdr, 0, 0, req->base.capacity);
-    memcpy(pipe->backend.ipc_mode.wio.buffer, &frame_hdr, sizeof(frame_hdr));
-    pipe->backend.ipc_mode.wio.curr.head_send_capacity = sizeof(frame_hdr);
+            size_t left_size = _ev_pipe_ipc_mode_frame_left_unix(req);
+            size_t fill_size = 0;
+            niov += _ev_pipe_ipc_mode_fill_iov_unix(
+                req, iov + niov, ARRAY_SIZE(iov) - niov, &fill_size);
+            size += fill_size;
 
-    ssize_t send_size;
-    if (req->handle.role == EV_ROLE_EV_TCP)
-    {
-        struct iovec iov = {
-            pipe->backend.ipc_mode.wio.buffer,
-            pipe->backend.ipc_mode.wio.curr.head_send_capacity
-        };
+            if (fill_size < left_size || nfd != 0)
+            {
+                break;
+            }
+        }
 
-        send_size = _ev_pipe_sendmsg_unix(pipe->pipfd, req->handle.u.os_socket,
-                                          &iov, 1);
-        if (send_size >= 0)
+        ssize_t send_size =
+            _ev_pipe_sendmsg_unix(pipe->pipfd, first->handle.os_socket, nfd,
+                                  (struct iovec *)iov, (int)niov);
+        if (send_size < 0)
+        { /* send_size is error code */
+            EV_LOG_ERROR("pipe(%p) data send failed, err:%d", pipe,
+                         (int)send_size);
+            ret = (int)send_size;
+            break;
+        }
+        if (send_size > 0 && nfd != 0)
         {
-            req->handle.role = EV_ROLE_UNKNOWN;
-            req->handle.u.os_socket = EV_OS_SOCKET_INVALID;
+            first->handle.role = EV_ROLE_UNKNOWN;
+            first->handle.num = 0;
         }
-    }
-    else
-    {
-        send_size =
-            ev__write_unix(pipe->pipfd, pipe->backend.ipc_mode.wio.buffer,
-                           pipe->backend.ipc_mode.wio.curr.head_send_capacity);
-    }
 
-    if (send_size == 0)
-    { /* If data not send, try again */
-        EV_LOG_TRACE("pipe(%p) data not send, try again", pipe);
-        ev_list_push_front(&pipe->backend.ipc_mode.wio.wqueue, &req->base.node);
-        pipe->backend.ipc_mode.wio.curr.writing = NULL;
-        return 0;
-    }
-    else if (send_size < 0)
-    { /* send_size is error code */
-        EV_LOG_ERROR("pipe(%p) data send failed, err:%d", pipe, send_size);
-        return send_size;
-    }
+        _ev_pipe_ipc_mode_commit_wio_unix(pipe, send_size, &done);
 
-    pipe->backend.ipc_mode.wio.curr.head_send_size = send_size;
+        /* If data not send, try again */
+        if ((size_t)send_size < size)
+        {
+            break;
+        }
+    }
 
-    /* try again to send frame header */
-    if ((size_t)send_size < pipe->backend.ipc_mode.wio.curr.head_send_capacity)
+    while ((it = ev_list_pop_front(&done)) != NULL)
     {
-        EV_LOG_TRACE("pipe(%p) frame header remain %zu bytes", pipe,
-                     pipe->backend.ipc_mode.wio.curr.head_send_capacity -
-                         send_size);
-        return 0;
+        ev_pipe_write_req_t *req =
+            EV_CONTAINER_OF(it, ev_pipe_write_req_t, base.node);
+        _ev_pipe_w_user_callback_unix(pipe, req, req->base.size);
     }
 
-    return _ev_pipe_on_ipc_mode_io_write_remain_unix(pipe);
-}
-
-static void _ev_pipe_ipc_mode_reset_wio_curr_cnt(ev_pipe_t *pipe)
-{
-    pipe->backend.ipc_mode.wio.curr.head_send_size = 0;
-    pipe->backend.ipc_mode.wio.curr.head_send_capacity = 0;
-    pipe->backend.ipc_mode.wio.curr.buf_idx = 0;
-    pipe->backend.ipc_mode.wio.curr.buf_pos = 0;
+    return ret;
 }
 
 static void _ev_pipe_ipc_mode_reset_rio_curr_cnt(ev_pipe_t *pipe)
 {
-    pipe->backend.ipc_mode.rio.curr.head_read_size = 0;
     pipe->backend.ipc_mode.rio.curr.data_remain_size = 0;
     pipe->backend.ipc_mode.rio.curr.buf_idx = 0;
     pipe->backend.ipc_mode.rio.curr.buf_pos = 0;
 }
 
-static int _ev_pipe_on_ipc_mode_io_write_unix(ev_pipe_t *pipe)
-{
-    if (pipe->backend.ipc_mode.wio.curr.writing != NULL)
-    {
-        return _ev_pipe_on_ipc_mode_io_write_remain_unix(pipe);
-    }
-
-    ev_list_node_t *it = ev_list_pop_front(&pipe->backend.ipc_mode.wio.wqueue);
-    assert(it != NULL);
-    pipe->backend.ipc_mode.wio.curr.writing =
-        EV_CONTAINER_OF(it, ev_pipe_write_req_t, base.node);
-    _ev_pipe_ipc_mode_reset_wio_curr_cnt(pipe);
-
-    return _ev_pipe_ipc_mode_write_new_frame_unix(pipe);
-}
-
 static void _ev_pipe_ipc_mode_cancel_all_rio_unix(ev_pipe_t *pipe, int stat)
 {
     ev_list_node_t *it;
@@ -11875,16 +13603,31 @@ static void _ev_pipe_ipc_mode_cancel_all_wio_unix(ev_pipe_t *pipe, int stat)
     }
 }
 
+static void _ev_pipe_ipc_mode_exit_rio_unix(ev_pipe_t *pipe)
+{
+    ev__loop_free(pipe->base.loop, pipe->backend.ipc_mode.rio.buffer);
+    pipe->backend.ipc_mode.rio.buffer = NULL;
+
+    _ev_pipe_close_fds_unix(pipe->backend.ipc_mode.rio.fds,
+                            pipe->backend.ipc_mode.rio.fd_num);
+    pipe->backend.ipc_mode.rio.fd_num = 0;
+}
+
 static void _ev_pipe_abort_unix(ev_pipe_t *pipe, int stat)
 {
     if (pipe->base.data.flags & EV_HANDLE_PIPE_IPC)
     {
-        ev__nonblock_io_del(pipe->base.loop, &pipe->backend.ipc_mode.io,
-                            EV_IO_IN | EV_IO_OUT);
-        _ev_pipe_close_unix(pipe);
+        if (pipe->base.data.flags & EV_HANDLE_PIPE_STREAMING)
+        {
+            ev__nonblock_io_del(pipe->base.loop, &pipe->backend.ipc_mode.io,
+                                EV_IO_IN | EV_IO_OUT);
+            _ev_pipe_close_unix(pipe);
+            _ev_pipe_ipc_mode_exit_rio_unix(pipe);
+            pipe->base.data.flags &= ~EV_HANDLE_PIPE_STREAMING;
 
-        _ev_pipe_ipc_mode_cancel_all_rio_unix(pipe, stat);
-        _ev_pipe_ipc_mode_cancel_all_wio_unix(pipe, stat);
+            _ev_pipe_ipc_mode_cancel_all_rio_unix(pipe, stat);
+            _ev_pipe_ipc_mode_cancel_all_wio_unix(pipe, stat);
+        }
     }
     else
     {
@@ -11897,6 +13640,17 @@ static void _ev_pipe_abort_unix(ev_pipe_t *pipe, int stat)
     }
 }
 
+static void _ev_pipe_ipc_mode_on_read_done_unix(ev_pipe_t *pipe)
+{
+    if (ev_list_size(&pipe->backend.ipc_mode.rio.rqueue) == 0 &&
+        pipe->backend.ipc_mode.rio.curr.reading == NULL)
+    {
+        pipe->backend.ipc_mode.mask.rio_pending = 0;
+        ev__nonblock_io_del(pipe->base.loop, &pipe->backend.ipc_mode.io,
+                            EPOLLIN);
+    }
+}
+
 static void _ev_pipe_on_ipc_mode_io_unix(ev_nonblock_io_t *io, unsigned evts,
                                          void *arg)
 {
@@ -11911,13 +13665,7 @@ static void _ev_pipe_on_ipc_mode_io_unix(ev_nonblock_io_t *io, unsigned evts,
         {
             goto err;
         }
-        if (ev_list_size(&pipe->backend.ipc_mode.rio.rqueue) == 0 &&
-            pipe->backend.ipc_mode.rio.curr.reading == NULL)
-        {
-            pipe->backend.ipc_mode.mask.rio_pending = 0;
-            ev__nonblock_io_del(pipe->base.loop, &pipe->backend.ipc_mode.io,
-                                EPOLLIN);
-        }
+        _ev_pipe_ipc_mode_on_read_done_unix(pipe);
     }
     if (evts & (EPOLLOUT | EPOLLERR))
     {
@@ -11925,8 +13673,7 @@ static void _ev_pipe_on_ipc_mode_io_unix(ev_nonblock_io_t *io, unsigned evts,
         {
             goto err;
         }
-        if (ev_list_size(&pipe->backend.ipc_mode.wio.wqueue) == 0 &&
-            pipe->backend.ipc_mode.wio.curr.writing == NULL)
+        if (ev_list_size(&pipe->backend.ipc_mode.wio.wqueue) == 0)
         {
             pipe->backend.ipc_mode.mask.wio_pending = 0;
             ev__nonblock_io_del(pipe->base.loop, &pipe->backend.ipc_mode.io,
@@ -11940,8 +13687,38 @@ err:
     _ev_pipe_abort_unix(pipe, ret);
 }
 
-static void _ev_pipe_init_as_ipc_mode_unix(ev_pipe_t *pipe)
+/**
+ * @brief Deliver frames left in receive buffer, which will not wake up poll.
+ */
+static void _ev_pipe_on_ipc_mode_read_backlog_unix(ev_handle_t *handle)
+{
+    int        ret;
+    ev_pipe_t *pipe = EV_CONTAINER_OF(handle, ev_pipe_t, base);
+    if (pipe->pipfd == EV_OS_PIPE_INVALID)
+    {
+        return;
+    }
+
+    if ((ret = _ev_pipe_on_ipc_mode_io_read_unix(pipe)) != 0)
+    {
+        _ev_pipe_abort_unix(pipe, ret);
+        return;
+    }
+    _ev_pipe_ipc_mode_on_read_done_unix(pipe);
+}
+
+static int _ev_pipe_init_as_ipc_mode_unix(ev_pipe_t *pipe)
 {
+    pipe->backend.ipc_mode.rio.buffer = ev__loop_malloc(
+        pipe->base.loop, EV_ALLOCATOR_TYPE_PIPE, EV_PIPE_IPC_RBUF_SIZE);
+    if (pipe->backend.ipc_mode.rio.buffer == NULL)
+    {
+        return EV_ENOMEM;
+    }
+    pipe->backend.ipc_mode.rio.pos = 0;
+    pipe->backend.ipc_mode.rio.len = 0;
+    pipe->backend.ipc_mode.rio.fd_num = 0;
+
     ev__nonblock_io_init(&pipe->backend.ipc_mode.io, pipe->pipfd,
                          _ev_pipe_on_ipc_mode_io_unix, NULL);
     memset(&pipe->backend.ipc_mode.mask, 0,
@@ -11951,9 +13728,9 @@ static void _ev_pipe_init_as_ipc_mode_unix(ev_pipe_t *pipe)
     pipe->backend.ipc_mode.rio.curr.reading = NULL;
     ev_list_init(&pipe->backend.ipc_mode.rio.rqueue);
 
-    _ev_pipe_ipc_mode_reset_wio_curr_cnt(pipe);
-    pipe->backend.ipc_mode.wio.curr.writing = NULL;
     ev_list_init(&pipe->backend.ipc_mode.wio.wqueue);
+
+    return 0;
 }
 
 static void _ev_pipe_ipc_mode_want_write_unix(ev_pipe_t *pipe)
@@ -11969,6 +13746,11 @@ static void _ev_pipe_ipc_mode_want_write_unix(ev_pipe_t *pipe)
 
 static void _ev_pipe_ipc_mode_want_read_unix(ev_pipe_t *pipe)
 {
+    if (pipe->backend.ipc_mode.rio.len != pipe->backend.ipc_mode.rio.pos)
+    {
+        ev__backlog_submit(&pipe->base, _ev_pipe_on_ipc_mode_read_backlog_unix);
+    }
+
     if (pipe->backend.ipc_mode.mask.rio_pending)
     {
         return;
@@ -11986,6 +13768,12 @@ static int _ev_pipe_write_ipc_mode_unix(ev_pipe_t           *pipe,
         return EV_E2BIG;
     }
 
+    uint8_t flags =
+        req->handle.num != 0 ? EV_IPC_FRAME_FLAG_HANDLE : 0;
+    ev__ipc_init_frame_hdr(&req->backend.hdr, flags, 0,
+                           (uint32_t)req->base.capacity);
+    req->backend.sent = 0;
+
     ev_list_push_back(&pipe->backend.ipc_mode.wio.wqueue, &req->base.node);
     _ev_pipe_ipc_mode_want_write_unix(pipe);
 
@@ -12103,18 +13891,40 @@ int ev_pipe_make(ev_os_pipe_t fds[2], int rflags, int wflags)
     return _ev_pipe_make_pipe(fds, rflags, wflags);
 }
 
+static void _ev_pipe_init_unix(ev_loop_t *loop, ev_pipe_t *pipe, int ipc)
+{
+    ev__handle_init(loop, &pipe->base, EV_ROLE_EV_PIPE);
+    pipe->close_cb = NULL;
+    pipe->pipfd = EV_OS_PIPE_INVALID;
+    pipe->base.data.flags |= ipc ? EV_HANDLE_PIPE_IPC : 0;
+}
+
+size_t ev_pipe_size(void)
+{
+    return sizeof(ev_pipe_t);
+}
+
 int ev_pipe_init(ev_loop_t *loop, ev_pipe_t **pipe, int ipc)
 {
-    ev_pipe_t *new_pipe = ev_malloc(sizeof(ev_pipe_t));
+    ev_pipe_t *new_pipe =
+        ev__loop_malloc(loop, EV_ALLOCATOR_TYPE_PIPE, sizeof(ev_pipe_t));
     if (new_pipe == NULL)
     {
         return EV_ENOMEM;
     }
 
-    ev__handle_init(loop, &new_pipe->base, EV_ROLE_EV_PIPE);
-    new_pipe->close_cb = NULL;
-    new_pipe->pipfd = EV_OS_PIPE_INVALID;
-    new_pipe->base.data.flags |= ipc ? EV_HANDLE_PIPE_IPC : 0;
+    _ev_pipe_init_unix(loop, new_pipe, ipc);
+
+    *pipe = new_pipe;
+    return 0;
+}
+
+int ev_pipe_init_inplace(ev_loop_t *loop, ev_pipe_t **pipe, int ipc, void *mem)
+{
+    ev_pipe_t *new_pipe = mem;
+
+    _ev_pipe_init_unix(loop, new_pipe, ipc);
+    new_pipe->base.data.flags |= EV_HANDLE_INPLACE;
 
     *pipe = new_pipe;
     return 0;
@@ -12148,42 +13958,115 @@ int ev_pipe_open(ev_pipe_t *pipe, ev_os_pipe_t handle)
     }
 
     pipe->pipfd = handle;
-    pipe->base.data.flags |= EV_HANDLE_PIPE_STREAMING;
 
     if (pipe->base.data.flags & EV_HANDLE_PIPE_IPC)
     {
-        _ev_pipe_init_as_ipc_mode_unix(pipe);
+        if ((ret = _ev_pipe_init_as_ipc_mode_unix(pipe)) != 0)
+        {
+            pipe->pipfd = EV_OS_PIPE_INVALID;
+            return ret;
+        }
     }
     else
     {
         ev__nonblock_stream_init(
             pipe->base.loop, &pipe->backend.data_mode.stream, handle,
             _ev_pipe_on_data_mode_write_unix, _ev_pipe_on_data_mode_read_unix);
+        pipe->backend.data_mode.wm_cb = NULL;
+        pipe->backend.data_mode.wm_arg = NULL;
     }
+    pipe->base.data.flags |= EV_HANDLE_PIPE_STREAMING;
 
     return 0;
 }
 
-int ev_pipe_write_ex(ev_pipe_t *pipe, ev_buf_t *bufs, size_t nbuf,
-                     ev_role_t handle_role, void *handle_addr,
-                     ev_pipe_write_cb cb, void *arg)
+static void _ev_pipe_on_data_mode_watermark_unix(ev_nonblock_stream_t *stream,
+                                                 int                   high)
+{
+    ev_pipe_t *pipe =
+        EV_CONTAINER_OF(stream, ev_pipe_t, backend.data_mode.stream);
+    pipe->backend.data_mode.wm_cb(pipe, high, pipe->backend.data_mode.wm_arg);
+}
+
+int ev_pipe_set_watermark(ev_pipe_t *pipe, size_t low, size_t high,
+                          ev_pipe_watermark_cb cb, void *arg)
 {
     if (pipe->pipfd == EV_OS_PIPE_INVALID)
     {
         return EV_EBADF;
     }
-
-    ev_pipe_write_req_t *req = ev_malloc(sizeof(ev_pipe_write_req_t));
-    if (req == NULL)
+    if (pipe->base.data.flags & EV_HANDLE_PIPE_IPC)
     {
-        return EV_ENOMEM;
+        return EV_ENOSYS;
+    }
+    if (low > high)
+    {
+        return EV_EINVAL;
+    }
+
+    pipe->backend.data_mode.wm_cb = cb;
+    pipe->backend.data_mode.wm_arg = arg;
+    ev__nonblock_stream_watermark(
+        &pipe->backend.data_mode.stream, low, high,
+        cb != NULL ? _ev_pipe_on_data_mode_watermark_unix : NULL);
+    return 0;
+}
+
+EV_LOCAL int ev__pipe_data_stream_unix(ev_pipe_t *pipe,
+                                       ev_nonblock_stream_t **stream)
+{
+    if (pipe->pipfd == EV_OS_PIPE_INVALID)
+    {
+        return EV_EBADF;
+    }
+    if (pipe->base.data.flags & EV_HANDLE_PIPE_IPC)
+    {
+        return EV_ENOSYS;
+    }
+
+    *stream = &pipe->backend.data_mode.stream;
+    return 0;
+}
+
+EV_LOCAL void ev__pipe_smart_deactive_unix(ev_pipe_t *pipe)
+{
+    _ev_pipe_smart_deactive(pipe);
+}
+
+ssize_t ev_pipe_write_queue_size(ev_pipe_t *pipe)
+{
+    if (pipe->pipfd == EV_OS_PIPE_INVALID)
+    {
+        return EV_EBADF;
+    }
+    if (pipe->base.data.flags & EV_HANDLE_PIPE_IPC)
+    {
+        return EV_ENOSYS;
+    }
+    return (ssize_t)pipe->backend.data_mode.stream.pending.w_size;
+}
+
+int ev_pipe_write_handles(ev_pipe_t *pipe, ev_buf_t *bufs, size_t nbuf,
+                          ev_role_t handle_role, void **handle_addrs,
+                          size_t handle_num, ev_pipe_write_cb cb, void *arg)
+{
+    if (pipe->pipfd == EV_OS_PIPE_INVALID)
+    {
+        return EV_EBADF;
+    }
+
+    ev_pipe_write_req_t *req = ev__loop_malloc(
+        pipe->base.loop, EV_ALLOCATOR_TYPE_PIPE, sizeof(ev_pipe_write_req_t));
+    if (req == NULL)
+    {
+        return EV_ENOMEM;
     }
 
     int ret = ev__pipe_write_init_ext(req, cb, arg, bufs, nbuf, handle_role,
-                                      handle_addr);
+                                      handle_addrs, handle_num);
     if (ret != 0)
     {
-        ev_free(req);
+        ev__loop_free(pipe->base.loop, req);
         return ret;
     }
 
@@ -12206,7 +14089,7 @@ int ev_pipe_write_ex(ev_pipe_t *pipe, ev_buf_t *bufs, size_t nbuf,
         /* The final state must be non-active. */
         ev__handle_deactive(&pipe->base);
 
-        ev_free(req);
+        ev__loop_free(pipe->base.loop, req);
     }
 
     return ret;
@@ -12252,18 +14135,54 @@ int ev_pipe_read(ev_pipe_t *pipe, ev_pipe_read_req_t *req, ev_buf_t *bufs,
 int ev_pipe_accept(ev_pipe_t *pipe, ev_pipe_read_req_t *req,
                    ev_role_t handle_role, void *handle_addr)
 {
-    if (!(pipe->base.data.flags & EV_HANDLE_PIPE_IPC) ||
-        handle_role != EV_ROLE_EV_TCP || handle_addr == NULL)
+    if (!(pipe->base.data.flags & EV_HANDLE_PIPE_IPC) || handle_addr == NULL)
     {
         return EV_EINVAL;
     }
-    if (req->handle.os_socket == EV_OS_SOCKET_INVALID)
+    if (req->handle.pos >= req->handle.num)
     {
         return EV_ENOENT;
     }
 
-    ev_tcp_t *tcp = handle_addr;
-    return ev__tcp_open(tcp, req->handle.os_socket);
+    int ret;
+    int taken;
+    int fd = req->handle.os_socket[req->handle.pos];
+    switch (handle_role)
+    {
+    case EV_ROLE_EV_TCP:
+        ret = ev__tcp_open(handle_addr, fd);
+        /* Socket stays with handle if only its options failed */
+        taken = ret == 0 || ((ev_tcp_t *)handle_addr)->sock == fd;
+        break;
+
+    case EV_ROLE_EV_SHM_CHANNEL:
+        ret = ev__shm_channel_attach_unix(handle_addr, fd);
+        taken = ret == 0;
+        break;
+
+    default:
+        ret = EV_EINVAL;
+        taken = 0;
+        break;
+    }
+
+    /* Ownership is moved to accepted handle */
+    if (taken)
+    {
+        req->handle.os_socket[req->handle.pos] = EV_OS_SOCKET_INVALID;
+        req->handle.pos++;
+    }
+
+    return ret;
+}
+
+void ev_pipe_discard(ev_pipe_read_req_t *req)
+{
+    for (; req->handle.pos < req->handle.num; req->handle.pos++)
+    {
+        close(req->handle.os_socket[req->handle.pos]);
+        req->handle.os_socket[req->handle.pos] = EV_OS_SOCKET_INVALID;
+    }
 }
 
 void ev_pipe_close(ev_os_pipe_t fd)
@@ -12274,7 +14193,7 @@ void ev_pipe_close(ev_os_pipe_t fd)
     }
 }
 
-// #line 76 "ev.c"
+// #line 83 "ev.c"
 ////////////////////////////////////////////////////////////////////////////////
 // FILE:    ev/unix/process_unix.c
 // SIZE:    16851
@@ -13012,7 +14931,7 @@ error:
     return errcode;
 }
 
-// #line 77 "ev.c"
+// #line 84 "ev.c"
 ////////////////////////////////////////////////////////////////////////////////
 // FILE:    ev/unix/sem_unix.c
 // SIZE:    963
@@ -13094,7 +15013,7 @@ int ev_sem_try_wait(ev_sem_t *sem)
     return 0;
 }
 
-// #line 78 "ev.c"
+// #line 85 "ev.c"
 ////////////////////////////////////////////////////////////////////////////////
 // FILE:    ev/unix/shdlib_unix.c
 // SIZE:    963
@@ -13157,5007 +15076,8588 @@ int ev_dlsym(ev_shdlib_t* lib, const char* name, void** ptr)
     return EV_ENOENT;
 }
 
-// #line 79 "ev.c"
+// #line 86 "ev.c"
 ////////////////////////////////////////////////////////////////////////////////
-// FILE:    ev/unix/shmem_unix.c
-// SIZE:    3093
-// SHA-256: f13db8acf9960186196074e8a3c2158625f391024e76b40bbc991cd012a11d4e
+// FILE:    ev/unix/shm_channel_unix.c
+// SIZE:    10291
+// SHA-256: 52a9b971186a4f790c037a28625beccd50f13f81bd1457b8c8976c62483dc6a0
 ////////////////////////////////////////////////////////////////////////////////
-// #line 1 "ev/unix/shmem_unix.c"
-#include <assert.h>
-#include <sys/mman.h>
-#include <sys/stat.h> /* For mode constants */
-#include <fcntl.h>    /* For O_* constants */
-#include <stdio.h>
+// #line 1 "ev/unix/shm_channel_unix.c"
 #include <string.h>
-#include <unistd.h>
 
-static int s_ev_shm_init(ev_shmem_t *shm, const char *key, size_t size)
+#define EV_SHM_CHANNEL_MAGIC    0x45565343
+
+/**
+ * @brief Length prefix marking the rest of ring is unused, the next message
+ *   starts at the beginning of ring.
+ */
+#define EV_SHM_CHANNEL_WRAP     UINT32_MAX
+
+#define EV_SHM_CHANNEL_MIN_SIZE 64
+#define EV_SHM_CHANNEL_MAX_SIZE ((size_t)1 << 30)
+
+/**
+ * @brief Messages handled in one wakeup before yielding to other handles.
+ */
+#define EV_SHM_CHANNEL_RECV_BATCH 1024
+
+static size_t _ev_shm_channel_record_size(size_t size)
 {
-    int err;
-    shm->size = size;
+    return EV_ALIGN_SIZE(sizeof(uint32_t) + size, sizeof(uint64_t));
+}
 
-    int ret = snprintf(shm->backend.name, sizeof(shm->backend.name), "%s", key);
-    if (ret >= (int)sizeof(shm->backend.name))
+static int _ev_shm_channel_is_closing(ev_shm_channel_t *chan)
+{
+    return ev__handle_is_closing(&chan->base);
+}
+
+static void _ev_shm_channel_on_close_unix(ev_handle_t *handle)
+{
+    ev_shm_channel_t *chan = EV_CONTAINER_OF(handle, ev_shm_channel_t, base);
+    ev_shm_channel_cb close_cb = chan->close_cb;
+    void             *close_arg = chan->close_arg;
+
+    ev_shmem_exit(chan->shm);
+    ev__loop_free(chan->base.loop, chan);
+
+    if (close_cb != NULL)
     {
-        return EV_ENOMEM;
+        close_cb(chan, close_arg);
     }
-    memset(&shm->backend.mask, 0, sizeof(shm->backend.mask));
+}
 
-    shm->backend.map_file =
-        shm_open(key, O_RDWR | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR);
-    if (shm->backend.map_file == -1)
+static void _ev_shm_channel_drain_unix(ev_shm_channel_t *chan);
+
+static void _ev_shm_channel_on_backlog_unix(ev_handle_t *handle)
+{
+    ev_shm_channel_t *chan = EV_CONTAINER_OF(handle, ev_shm_channel_t, base);
+    if (!_ev_shm_channel_is_closing(chan))
     {
-        err = errno;
-        goto err_shm_open;
+        _ev_shm_channel_drain_unix(chan);
     }
+}
 
-    if (ftruncate(shm->backend.map_file, size) != 0)
+/**
+ * @brief Stop receiving from a channel whose ring is corrupted.
+ */
+static void _ev_shm_channel_break_unix(ev_shm_channel_t *chan)
+{
+    chan->base.data.flags |= EV_HANDLE_SHM_CHANNEL_BROKEN;
+    ev__nonblock_io_del(chan->base.loop, &chan->io, EV_IO_IN);
+    ev__handle_deactive(&chan->base);
+
+    chan->recv_cb(chan, NULL, EV_EPROTO, chan->recv_arg);
+}
+
+static void _ev_shm_channel_drain_unix(ev_shm_channel_t *chan)
+{
+    ev_shm_channel_hdr_t *hdr = chan->hdr;
+    const size_t          capacity = chan->capacity;
+    const uint64_t        mask = capacity - 1;
+    uint64_t              tail = (uint64_t)ev_atomic64_load(&hdr->tail.v);
+    uint64_t              head;
+
+    if (chan->base.data.flags & EV_HANDLE_SHM_CHANNEL_BROKEN)
     {
-        err = errno;
-        goto err_ftruncate;
+        return;
     }
 
-    shm->addr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED,
-                     shm->backend.map_file, 0);
-    if (shm->addr == NULL)
+    size_t cnt = 0;
+    for (;;)
     {
-        err = errno;
-        goto err_ftruncate;
+        if ((head = (uint64_t)ev_atomic64_load(&hdr->head.v)) == tail)
+        {
+            /* Ask sender to ring doorbell, then check again for a racing one */
+            ev_atomic32_store(&hdr->waiting, 1);
+            if ((uint64_t)ev_atomic64_load(&hdr->head.v) == tail)
+            {
+                return;
+            }
+            ev_atomic32_store(&hdr->waiting, 0);
+            continue;
+        }
+
+        if (cnt++ >= EV_SHM_CHANNEL_RECV_BATCH)
+        {
+            ev__backlog_submit(&chan->base, _ev_shm_channel_on_backlog_unix);
+            return;
+        }
+
+        size_t   pos = (size_t)(tail & mask);
+        uint32_t size;
+        memcpy(&size, chan->ring + pos, sizeof(size));
+        if (size == EV_SHM_CHANNEL_WRAP)
+        {
+            if (head - tail < capacity - pos)
+            {
+                _ev_shm_channel_break_unix(chan);
+                return;
+            }
+            tail += capacity - pos;
+            ev_atomic64_store(&hdr->tail.v, tail);
+            continue;
+        }
+
+        /* Ring is writable by peer, never trust the length prefix */
+        size_t record_size = _ev_shm_channel_record_size(size);
+        if (record_size > capacity / 2 || pos + record_size > capacity ||
+            head - tail < record_size)
+        {
+            _ev_shm_channel_break_unix(chan);
+            return;
+        }
+
+        /* Space is released after callback, so data stay valid inside it */
+        chan->recv_cb(chan, chan->ring + pos + sizeof(size), (ssize_t)size,
+                      chan->recv_arg);
+        tail += record_size;
+        ev_atomic64_store(&hdr->tail.v, tail);
+
+        if (_ev_shm_channel_is_closing(chan))
+        {
+            return;
+        }
     }
+}
 
-    return 0;
+static void _ev_shm_channel_on_doorbell_unix(ev_nonblock_io_t *io,
+                                             unsigned evts, void *arg)
+{
+    (void)evts;
+    (void)arg;
+    ev_shm_channel_t *chan = EV_CONTAINER_OF(io, ev_shm_channel_t, io);
 
-err_ftruncate:
-    close(shm->backend.map_file);
-err_shm_open:
-    return ev__translate_sys_error(err);
+    ev__async_pend(chan->evtfd[0]);
+    _ev_shm_channel_drain_unix(chan);
 }
 
-static int s_ev_shm_open(ev_shmem_t *shm, const char *key)
+static ev_shm_channel_t *_ev_shm_channel_new(ev_loop_t *loop)
 {
-    int err;
-    int ret = snprintf(shm->backend.name, sizeof(shm->backend.name), "%s", key);
-    if (ret >= (int)sizeof(shm->backend.name))
+    ev_shm_channel_t *chan =
+        ev__loop_malloc(loop, EV_ALLOCATOR_TYPE_MISC, sizeof(ev_shm_channel_t));
+    if (chan == NULL)
     {
-        return EV_ENOMEM;
+        return NULL;
     }
-    memset(&shm->backend.mask, 0, sizeof(shm->backend.mask));
 
-    shm->backend.mask.is_open = 1;
-    shm->backend.map_file = shm_open(key, O_RDWR, 0);
-    if (shm->backend.map_file == -1)
+    memset(chan, 0, sizeof(*chan));
+    chan->evtfd[0] = -1;
+    chan->evtfd[1] = -1;
+
+    return chan;
+}
+
+static void _ev_shm_channel_layout(ev_shm_channel_t *chan)
+{
+    chan->hdr = ev_shmem_addr(chan->shm);
+    chan->ring = (uint8_t *)chan->hdr + sizeof(ev_shm_channel_hdr_t);
+}
+
+int ev_shm_channel_init(ev_loop_t *loop, ev_shm_channel_t **chan,
+                        const char *key, size_t size,
+                        ev_shm_channel_recv_cb cb, void *arg)
+{
+    int    ret;
+    size_t capacity = EV_SHM_CHANNEL_MIN_SIZE;
+
+    if (size > EV_SHM_CHANNEL_MAX_SIZE || cb == NULL)
     {
-        err = errno;
-        goto err_shm_open;
+        return EV_EINVAL;
+    }
+    while (capacity < size)
+    {
+        capacity <<= 1;
     }
 
-    struct stat statbuf;
-    if (fstat(shm->backend.map_file, &statbuf) != 0)
+    ev_shm_channel_t *new_chan = _ev_shm_channel_new(loop);
+    if (new_chan == NULL)
     {
-        err = errno;
-        goto err_fstat;
+        return EV_ENOMEM;
     }
-    shm->size = statbuf.st_size;
 
-    shm->addr = mmap(NULL, shm->size, PROT_READ | PROT_WRITE, MAP_SHARED,
-                     shm->backend.map_file, 0);
-    if (shm->addr == NULL)
+    ret = ev_shmem_init(&new_chan->shm, key,
+                        sizeof(ev_shm_channel_hdr_t) + capacity);
+    if (ret != 0)
     {
-        err = errno;
-        goto err_fstat;
+        goto err_free;
+    }
+
+    if ((ret = ev__asyc_eventfd(new_chan->evtfd)) != 0)
+    {
+        goto err_shmem;
     }
 
+    _ev_shm_channel_layout(new_chan);
+    new_chan->capacity = capacity;
+    new_chan->hdr->capacity = (uint32_t)capacity;
+    ev_atomic64_init(&new_chan->hdr->head.v, 0);
+    ev_atomic64_init(&new_chan->hdr->tail.v, 0);
+    ev_atomic32_init(&new_chan->hdr->waiting, 1);
+    new_chan->hdr->magic = EV_SHM_CHANNEL_MAGIC;
+
+    new_chan->recv_cb = cb;
+    new_chan->recv_arg = arg;
+
+    ev__handle_init(loop, &new_chan->base, EV_ROLE_EV_SHM_CHANNEL);
+    ev__nonblock_io_init(&new_chan->io, new_chan->evtfd[0],
+                         _ev_shm_channel_on_doorbell_unix, NULL);
+    ev__nonblock_io_add(loop, &new_chan->io, EV_IO_IN);
+    ev__handle_active(&new_chan->base);
+
+    *chan = new_chan;
     return 0;
 
-err_fstat:
-    close(shm->backend.map_file);
-err_shm_open:
-    return ev__translate_sys_error(err);
+err_shmem:
+    ev_shmem_exit(new_chan->shm);
+err_free:
+    ev__loop_free(loop, new_chan);
+    return ret;
 }
 
-int ev_shmem_init(ev_shmem_t **shm, const char *key, size_t size)
+int ev_shm_channel_open(ev_loop_t *loop, ev_shm_channel_t **chan,
+                        const char *key)
 {
-    ev_shmem_t *handle = ev_malloc(sizeof(ev_shmem_t));
-    if (handle == NULL)
+    int               ret;
+    ev_shm_channel_t *new_chan = _ev_shm_channel_new(loop);
+    if (new_chan == NULL)
     {
         return EV_ENOMEM;
     }
 
-    int ret = s_ev_shm_init(handle, key, size);
-    if (ret != 0)
+    if ((ret = ev_shmem_open(&new_chan->shm, key)) != 0)
     {
-        ev_free(handle);
-        return ret;
+        goto err_free;
     }
 
-    *shm = handle;
+    _ev_shm_channel_layout(new_chan);
+    size_t   shm_size = ev_shmem_size(new_chan->shm);
+    uint32_t capacity = new_chan->hdr->capacity;
+    if (shm_size < sizeof(ev_shm_channel_hdr_t) ||
+        new_chan->hdr->magic != EV_SHM_CHANNEL_MAGIC || capacity == 0 ||
+        (capacity & (capacity - 1)) != 0 ||
+        shm_size - sizeof(ev_shm_channel_hdr_t) < capacity)
+    {
+        ret = EV_EINVAL;
+        goto err_shmem;
+    }
+    new_chan->capacity = capacity;
+
+    ev__handle_init(loop, &new_chan->base, EV_ROLE_EV_SHM_CHANNEL);
+    new_chan->base.data.flags |= EV_HANDLE_SHM_CHANNEL_SENDER;
+
+    *chan = new_chan;
     return 0;
+
+err_shmem:
+    ev_shmem_exit(new_chan->shm);
+err_free:
+    ev__loop_free(loop, new_chan);
+    return ret;
 }
 
-int ev_shmem_open(ev_shmem_t **shm, const char *key)
+void ev_shm_channel_exit(ev_shm_channel_t *chan, ev_shm_channel_cb close_cb,
+                         void *close_arg)
 {
-    ev_shmem_t *handle = ev_malloc(sizeof(ev_shmem_t));
-    if (handle == NULL)
+    chan->close_cb = close_cb;
+    chan->close_arg = close_arg;
+
+    if (!(chan->base.data.flags & EV_HANDLE_SHM_CHANNEL_SENDER))
     {
-        return EV_ENOMEM;
+        ev__nonblock_io_del(chan->base.loop, &chan->io, EV_IO_IN);
+        ev__handle_deactive(&chan->base);
     }
 
-    int ret = s_ev_shm_open(handle, key);
-    if (ret != 0)
+    size_t i;
+    for (i = 0; i < ARRAY_SIZE(chan->evtfd); i++)
     {
-        ev_free(handle);
-        return ret;
+        if (chan->evtfd[i] != -1)
+        {
+            ev__async_eventfd_close(chan->evtfd[i]);
+            chan->evtfd[i] = -1;
+        }
     }
 
-    *shm = handle;
-    return 0;
+    /* Shared memory is unmapped in close callback */
+    ev__handle_exit(&chan->base, _ev_shm_channel_on_close_unix);
 }
 
-void ev_shmem_exit(ev_shmem_t *shm)
+int ev_shm_channel_send(ev_shm_channel_t *chan, const void *data, size_t size)
 {
-    if (!shm->backend.mask.is_open)
+    ev_shm_channel_hdr_t *hdr = chan->hdr;
+
+    if (!(chan->base.data.flags & EV_HANDLE_SHM_CHANNEL_SENDER))
     {
-        shm_unlink(shm->backend.name);
+        return EV_EINVAL;
+    }
+    if (chan->evtfd[1] == -1)
+    {
+        return EV_ENOTCONN;
     }
 
-    int ret = munmap(shm->addr, shm->size);
-    assert(ret == 0);
-    (void)ret;
-
-    close(shm->backend.map_file);
-    ev_free(shm);
-}
-
-// #line 80 "ev.c"
-////////////////////////////////////////////////////////////////////////////////
-// FILE:    ev/unix/stream_unix.c
-// SIZE:    6160
-// SHA-256: f671a1c513eede33d980a7b1547d8d85eafa337fdd58de40e494003593a35c1d
-////////////////////////////////////////////////////////////////////////////////
-// #line 1 "ev/unix/stream_unix.c"
-
-static ssize_t _ev_stream_do_write_writev_unix(int fd, struct iovec* iov, int iovcnt, void* arg)
-{
-    (void)arg;
-    return ev__writev_unix(fd, (ev_buf_t*)iov, iovcnt);
-}
-
-static int _ev_stream_do_write_once(ev_nonblock_stream_t* stream, ev_write_t* req)
-{
-    return ev__send_unix(stream->io.data.fd, req, _ev_stream_do_write_writev_unix, NULL);
-}
-
-static int _ev_stream_do_read_once(ev_nonblock_stream_t* stream, ev_read_t* req, size_t* size)
-{
-    int iovcnt = req->data.nbuf;
-    if (iovcnt > g_ev_loop_unix_ctx.iovmax)
+    /* Limited to half of ring so wrapping always fits */
+    size_t record_size = _ev_shm_channel_record_size(size);
+    if (record_size > chan->capacity / 2)
     {
-        iovcnt = g_ev_loop_unix_ctx.iovmax;
+        return EV_E2BIG;
     }
 
-    ssize_t read_size;
-    read_size = ev__readv_unix(stream->io.data.fd, req->data.bufs, iovcnt);
-    if (read_size >= 0)
+    uint64_t head = (uint64_t)ev_atomic64_load(&hdr->head.v);
+    uint64_t tail = (uint64_t)ev_atomic64_load(&hdr->tail.v);
+    size_t   pos = (size_t)(head & (chan->capacity - 1));
+    size_t   contig_size = chan->capacity - pos;
+    size_t   need_size = record_size;
+    if (contig_size < record_size)
     {
-        *size = read_size;
-        return 0;
+        need_size += contig_size;
     }
-    return read_size;
-}
-
-static void _ev_stream_do_write(ev_nonblock_stream_t* stream)
-{
-    ssize_t ret;
-    ev_list_node_t* it;
-    ev_write_t* req;
 
-    while ((it = ev_list_pop_front(&stream->pending.w_queue)) != NULL)
+    if (chan->capacity - (head - tail) < need_size)
     {
-        req = EV_CONTAINER_OF(it, ev_write_t, node);
-        if ((ret = _ev_stream_do_write_once(stream, req)) == 0)
-        {
-            stream->callbacks.w_cb(stream, req, req->size);
-            continue;
-        }
-
-        /* Unsuccess operation should restore list */
-        ev_list_push_front(&stream->pending.w_queue, it);
-
-        if (ret == EV_EAGAIN)
-        {
-            break;
-        }
-        goto err;
+        return EV_EAGAIN;
     }
 
-    return;
-
-err:
-    while ((it = ev_list_pop_front(&stream->pending.w_queue)) != NULL)
+    if (contig_size < record_size)
     {
-        req = EV_CONTAINER_OF(it, ev_write_t, node);
-        ret = ret < 0 ? ret : (ssize_t)req->size;
-        stream->callbacks.w_cb(stream, req, ret);
+        uint32_t wrap = EV_SHM_CHANNEL_WRAP;
+        memcpy(chan->ring + pos, &wrap, sizeof(wrap));
+        head += contig_size;
+        pos = 0;
     }
-}
-
-static void _ev_stream_do_read(ev_nonblock_stream_t* stream)
-{
-    int ret;
-    ev_list_node_t* it = ev_list_pop_front(&stream->pending.r_queue);
-    ev_read_t* req = EV_CONTAINER_OF(it, ev_read_t, node);
 
-    size_t r_size = 0;
-    ret = _ev_stream_do_read_once(stream, req, &r_size);
-    req->data.size += r_size;
+    uint32_t size32 = (uint32_t)size;
+    memcpy(chan->ring + pos, &size32, sizeof(size32));
+    memcpy(chan->ring + pos + sizeof(size32), data, size);
+    ev_atomic64_store(&hdr->head.v, head + record_size);
 
-    if (ret == 0)
+    /* Only ring doorbell once for each wait */
+    if (ev_atomic32_exchange(&hdr->waiting, 0) != 0)
     {
-        stream->callbacks.r_cb(stream, req, req->data.size);
-        return;
+        ev__async_post(chan->evtfd[1]);
     }
 
-    ev_list_push_front(&stream->pending.r_queue, it);
+    return 0;
+}
 
-    if (ret == EV_EAGAIN)
+EV_LOCAL int ev__shm_channel_doorbell(ev_shm_channel_t *chan,
+                                      ev_os_socket_t   *fd)
+{
+    if (chan->base.data.role != EV_ROLE_EV_SHM_CHANNEL ||
+        (chan->base.data.flags & EV_HANDLE_SHM_CHANNEL_SENDER))
     {
-        return;
+        return EV_EINVAL;
     }
 
-    /* If error, cleanup all pending read requests */
-    while ((it = ev_list_pop_front(&stream->pending.r_queue)) != NULL)
-    {
-        req = EV_CONTAINER_OF(it, ev_read_t, node);
-        stream->callbacks.r_cb(stream, req, ret);
-    }
+    *fd = chan->evtfd[1];
+    return 0;
 }
 
-static void _ev_stream_cleanup_r(ev_nonblock_stream_t* stream, int errcode)
+EV_LOCAL int ev__shm_channel_attach_unix(ev_shm_channel_t *chan, int fd)
 {
-    ev_list_node_t* it;
-    while ((it = ev_list_pop_front(&stream->pending.r_queue)) != NULL)
+    if (!(chan->base.data.flags & EV_HANDLE_SHM_CHANNEL_SENDER))
     {
-        ev_read_t* req = EV_CONTAINER_OF(it, ev_read_t, node);
-        stream->callbacks.r_cb(stream, req, errcode);
+        return EV_EINVAL;
     }
-}
-
-static void _ev_stream_cleanup_w(ev_nonblock_stream_t* stream, int errcode)
-{
-    ev_list_node_t* it;
-    while ((it = ev_list_pop_front(&stream->pending.w_queue)) != NULL)
+    if (chan->evtfd[1] != -1)
     {
-        ev_write_t* req = EV_CONTAINER_OF(it, ev_write_t, node);
-        stream->callbacks.w_cb(stream, req, errcode);
+        return EV_EEXIST;
     }
+
+    chan->evtfd[1] = fd;
+    return 0;
 }
 
-static void _ev_nonblock_stream_on_io(ev_nonblock_io_t* io, unsigned evts, void* arg)
+// #line 87 "ev.c"
+////////////////////////////////////////////////////////////////////////////////
+// FILE:    ev/unix/shmem_unix.c
+// SIZE:    3093
+// SHA-256: f13db8acf9960186196074e8a3c2158625f391024e76b40bbc991cd012a11d4e
+////////////////////////////////////////////////////////////////////////////////
+// #line 1 "ev/unix/shmem_unix.c"
+#include <assert.h>
+#include <sys/mman.h>
+#include <sys/stat.h> /* For mode constants */
+#include <fcntl.h>    /* For O_* constants */
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+static int s_ev_shm_init(ev_shmem_t *shm, const char *key, size_t size)
 {
-    (void)arg;
-    ev_nonblock_stream_t* stream = EV_CONTAINER_OF(io, ev_nonblock_stream_t, io);
+    int err;
+    shm->size = size;
 
-    if (evts & EPOLLOUT)
+    int ret = snprintf(shm->backend.name, sizeof(shm->backend.name), "%s", key);
+    if (ret >= (int)sizeof(shm->backend.name))
     {
-        _ev_stream_do_write(stream);
-        if (ev_list_size(&stream->pending.w_queue) == 0)
-        {
-            ev__nonblock_io_del(stream->loop, &stream->io, EV_IO_OUT);
-            stream->flags.io_reg_w = 0;
-        }
+        return EV_ENOMEM;
     }
+    memset(&shm->backend.mask, 0, sizeof(shm->backend.mask));
 
-    else if (evts & (EPOLLIN | EPOLLHUP))
+    shm->backend.map_file =
+        shm_open(key, O_RDWR | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR);
+    if (shm->backend.map_file == -1)
     {
-        _ev_stream_do_read(stream);
-        if (ev_list_size(&stream->pending.r_queue) == 0)
-        {
-            ev__nonblock_io_del(stream->loop, &stream->io, EV_IO_IN);
-            stream->flags.io_reg_r = 0;
-        }
+        err = errno;
+        goto err_shm_open;
     }
-}
-
-EV_LOCAL void ev__nonblock_stream_init(ev_loop_t* loop,
-    ev_nonblock_stream_t* stream, int fd, ev_stream_write_cb wcb,
-    ev_stream_read_cb rcb)
-{
-    stream->loop = loop;
 
-    stream->flags.io_abort = 0;
-    stream->flags.io_reg_r = 0;
-    stream->flags.io_reg_w = 0;
+    if (ftruncate(shm->backend.map_file, size) != 0)
+    {
+        err = errno;
+        goto err_ftruncate;
+    }
 
-    ev__nonblock_io_init(&stream->io, fd, _ev_nonblock_stream_on_io, NULL);
+    shm->addr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED,
+                     shm->backend.map_file, 0);
+    if (shm->addr == NULL)
+    {
+        err = errno;
+        goto err_ftruncate;
+    }
 
-    ev_list_init(&stream->pending.w_queue);
-    ev_list_init(&stream->pending.r_queue);
+    return 0;
 
-    stream->callbacks.w_cb = wcb;
-    stream->callbacks.r_cb = rcb;
+err_ftruncate:
+    close(shm->backend.map_file);
+err_shm_open:
+    return ev__translate_sys_error(err);
 }
 
-EV_LOCAL void ev__nonblock_stream_exit(ev_nonblock_stream_t* stream)
+static int s_ev_shm_open(ev_shmem_t *shm, const char *key)
 {
-    ev__nonblock_stream_abort(stream);
-    ev__nonblock_stream_cleanup(stream, EV_IO_IN | EV_IO_OUT);
-    stream->loop = NULL;
-    stream->callbacks.w_cb = NULL;
-    stream->callbacks.r_cb = NULL;
-}
+    int err;
+    int ret = snprintf(shm->backend.name, sizeof(shm->backend.name), "%s", key);
+    if (ret >= (int)sizeof(shm->backend.name))
+    {
+        return EV_ENOMEM;
+    }
+    memset(&shm->backend.mask, 0, sizeof(shm->backend.mask));
 
-EV_LOCAL int ev__nonblock_stream_write(ev_nonblock_stream_t* stream, ev_write_t* req)
-{
-    if (stream->flags.io_abort)
+    shm->backend.mask.is_open = 1;
+    shm->backend.map_file = shm_open(key, O_RDWR, 0);
+    if (shm->backend.map_file == -1)
     {
-        return EV_EBADF;
+        err = errno;
+        goto err_shm_open;
     }
 
-    if (!stream->flags.io_reg_w)
+    struct stat statbuf;
+    if (fstat(shm->backend.map_file, &statbuf) != 0)
     {
-        ev__nonblock_io_add(stream->loop, &stream->io, EV_IO_OUT);
-        stream->flags.io_reg_w = 1;
+        err = errno;
+        goto err_fstat;
+    }
+    shm->size = statbuf.st_size;
+
+    shm->addr = mmap(NULL, shm->size, PROT_READ | PROT_WRITE, MAP_SHARED,
+                     shm->backend.map_file, 0);
+    if (shm->addr == NULL)
+    {
+        err = errno;
+        goto err_fstat;
     }
 
-    ev_list_push_back(&stream->pending.w_queue, &req->node);
     return 0;
+
+err_fstat:
+    close(shm->backend.map_file);
+err_shm_open:
+    return ev__translate_sys_error(err);
 }
 
-EV_LOCAL int ev__nonblock_stream_read(ev_nonblock_stream_t* stream, ev_read_t* req)
+int ev_shmem_init(ev_shmem_t **shm, const char *key, size_t size)
 {
-    if (stream->flags.io_abort)
+    ev_shmem_t *handle = ev_malloc(sizeof(ev_shmem_t));
+    if (handle == NULL)
     {
-        return EV_EBADF;
+        return EV_ENOMEM;
     }
 
-    if (!stream->flags.io_reg_r)
+    int ret = s_ev_shm_init(handle, key, size);
+    if (ret != 0)
     {
-        ev__nonblock_io_add(stream->loop, &stream->io, EV_IO_IN);
-        stream->flags.io_reg_r = 1;
+        ev_free(handle);
+        return ret;
     }
 
-    ev_list_push_back(&stream->pending.r_queue, &req->node);
+    *shm = handle;
     return 0;
 }
 
-EV_LOCAL size_t ev__nonblock_stream_size(ev_nonblock_stream_t* stream, unsigned evts)
+int ev_shmem_open(ev_shmem_t **shm, const char *key)
 {
-    size_t ret = 0;
-    if (evts & EV_IO_IN)
+    ev_shmem_t *handle = ev_malloc(sizeof(ev_shmem_t));
+    if (handle == NULL)
     {
-        ret += ev_list_size(&stream->pending.r_queue);
+        return EV_ENOMEM;
     }
-    if (evts & EV_IO_OUT)
+
+    int ret = s_ev_shm_open(handle, key);
+    if (ret != 0)
     {
-        ret += ev_list_size(&stream->pending.w_queue);
+        ev_free(handle);
+        return ret;
     }
-    return ret;
+
+    *shm = handle;
+    return 0;
 }
 
-EV_LOCAL void ev__nonblock_stream_abort(ev_nonblock_stream_t* stream)
+void ev_shmem_exit(ev_shmem_t *shm)
 {
-    if (!stream->flags.io_abort)
+    if (!shm->backend.mask.is_open)
     {
-        ev__nonblock_io_del(stream->loop, &stream->io, EV_IO_IN | EV_IO_OUT);
-        stream->flags.io_abort = 1;
+        shm_unlink(shm->backend.name);
     }
-}
 
-EV_LOCAL void ev__nonblock_stream_cleanup(ev_nonblock_stream_t* stream, unsigned evts)
-{
-    if (evts & EV_IO_OUT)
-    {
-        _ev_stream_cleanup_w(stream, EV_ECANCELED);
-    }
+    int ret = munmap(shm->addr, shm->size);
+    assert(ret == 0);
+    (void)ret;
 
-    if (evts & EV_IO_IN)
-    {
-        _ev_stream_cleanup_r(stream, EV_ECANCELED);
-    }
+    close(shm->backend.map_file);
+    ev_free(shm);
 }
 
-// #line 81 "ev.c"
+// #line 88 "ev.c"
 ////////////////////////////////////////////////////////////////////////////////
-// FILE:    ev/unix/tcp_unix.c
-// SIZE:    14926
-// SHA-256: 04268b60c965a3638d69bfcf4d5c33b8a20a443d28d5e9bbc1f967e22ea41f45
+// FILE:    ev/unix/stream_unix.c
+// SIZE:    24628
+// SHA-256: a9ade91a849648fd91a287e2333313c8c950660cf493aa8256e42ce195e24062
 ////////////////////////////////////////////////////////////////////////////////
-// #line 1 "ev/unix/tcp_unix.c"
-#include <sys/uio.h>
-#include <assert.h>
+// #line 1 "ev/unix/stream_unix.c"
+
+#include <fcntl.h>
+#include <limits.h>
 #include <unistd.h>
 
-static void _ev_tcp_close_fd(ev_tcp_t *sock)
+/**
+ * @brief Max number of iovec gathered for one write.
+ */
+#define EV_STREAM_WRITEV_MAX    1024
+
+/**
+ * @brief Default kernel buffer of splice, same as default pipe size on Linux.
+ */
+#define EV_STREAM_SPLICE_CAPACITY   (64 * 1024)
+
+/**
+ * @brief Gather buffers of queued write requests into \p iov.
+ * @return  Number of buffers gathered.
+ */
+static int _ev_stream_gather_write(ev_nonblock_stream_t* stream, ev_buf_t* iov, int iovmax)
 {
-    if (sock->sock != EV_OS_SOCKET_INVALID)
+    int iovcnt = 0;
+    ev_list_node_t* it = ev_list_begin(&stream->pending.w_queue);
+
+    for (; it != NULL && iovcnt < iovmax; it = ev_list_next(it))
     {
-        close(sock->sock);
-        sock->sock = EV_OS_SOCKET_INVALID;
+        ev_write_t* req = EV_CONTAINER_OF(it, ev_write_t, node);
+        if (ev__nonblock_stream_is_file(req))
+        {
+            break;
+        }
+
+        size_t nbuf = req->nbuf;
+        if (nbuf > (size_t)(iovmax - iovcnt))
+        {
+            nbuf = iovmax - iovcnt;
+        }
+
+        memcpy(&iov[iovcnt], req->bufs, sizeof(ev_buf_t) * nbuf);
+        iovcnt += (int)nbuf;
     }
+
+    return iovcnt;
 }
 
-static void _ev_tcp_cleanup_listen_queue(ev_tcp_t *s_sock, int stat)
+/**
+ * @brief Watch error queue only while zerocopy sends are outstanding.
+ */
+static void _ev_stream_zerocopy_watch(ev_nonblock_stream_t* stream)
 {
-    ev_list_node_t *it;
-    while ((it = ev_list_pop_front(&s_sock->backend.u.listen.accept_queue)) !=
-           NULL)
+    int busy = stream->zerocopy.seq_sent != stream->zerocopy.seq_done;
+
+    if (busy && !stream->flags.io_reg_e && !stream->flags.io_abort)
     {
-        ev_tcp_t *c_sock =
-            EV_CONTAINER_OF(it, ev_tcp_t, backend.u.accept.accept_node);
-        c_sock->backend.u.accept.cb(s_sock, c_sock, stat,
-                                    c_sock->backend.u.accept.arg);
+        ev__nonblock_io_add(stream->loop, &stream->io, EPOLLERR);
+        stream->flags.io_reg_e = 1;
+    }
+    else if (!busy && stream->flags.io_reg_e)
+    {
+        ev__nonblock_io_del(stream->loop, &stream->io, EPOLLERR);
+        stream->flags.io_reg_e = 0;
     }
 }
 
-static void _ev_tcp_connect_callback_once(ev_tcp_t *sock, int stat)
-{
-    ev_tcp_connect_cb bak_cb = sock->backend.u.client.cb;
-    void             *cb_arg = sock->backend.u.client.arg;
-    sock->backend.u.client.cb = NULL;
-    sock->backend.u.client.arg = NULL;
-    bak_cb(sock, stat, cb_arg);
-}
-
-static void _ev_tcp_on_close(ev_handle_t *handle)
+static ssize_t _ev_stream_writev(ev_nonblock_stream_t* stream, ev_buf_t* iov, int iovcnt)
 {
-    ev_tcp_t *sock = EV_CONTAINER_OF(handle, ev_tcp_t, base);
+    if (stream->zerocopy.cb == NULL)
+    {
+        return ev__writev_unix(stream->io.data.fd, iov, iovcnt);
+    }
 
-    if (sock->base.data.flags & EV_HANDLE_TCP_STREAMING)
+    ssize_t ret = ev__sendmsg_zerocopy_unix(stream->io.data.fd, iov, iovcnt);
+    if (ret > 0)
     {
-        ev__nonblock_stream_exit(&sock->backend.u.stream);
-        sock->base.data.flags &= ~EV_HANDLE_TCP_STREAMING;
+        stream->zerocopy.seq_sent++;
+        _ev_stream_zerocopy_watch(stream);
     }
+    return ret;
+}
 
-    if (sock->base.data.flags & EV_HANDLE_TCP_LISTING)
+/**
+ * @brief Compare sequence numbers that may wrap around.
+ * @return  Negative if \p a is before \p b.
+ */
+static int32_t _ev_stream_zerocopy_cmp(uint32_t a, uint32_t b)
+{
+    return (int32_t)(a - b);
+}
+
+/**
+ * @brief Make sure there is room for one more pending range.
+ */
+static int _ev_stream_zerocopy_reserve(ev_nonblock_stream_t* stream)
+{
+    if (stream->zerocopy.range_num < stream->zerocopy.range_cap)
     {
-        _ev_tcp_cleanup_listen_queue(sock, EV_ECANCELED);
-        sock->base.data.flags &= ~EV_HANDLE_TCP_LISTING;
+        return 0;
     }
 
-    if (sock->base.data.flags & EV_HANDLE_TCP_CONNECTING)
+    size_t cap = stream->zerocopy.range_cap != 0 ?
+        stream->zerocopy.range_cap * 2 : 8;
+    ev_stream_zerocopy_range_t* ranges = ev__loop_malloc(stream->loop,
+        EV_ALLOCATOR_TYPE_TCP, sizeof(ev_stream_zerocopy_range_t) * cap);
+    if (ranges == NULL)
     {
-        _ev_tcp_connect_callback_once(sock, EV_ECANCELED);
-        sock->base.data.flags &= ~EV_HANDLE_TCP_CONNECTING;
+        return EV_ENOMEM;
     }
 
-    if (sock->close_cb != NULL)
+    if (stream->zerocopy.ranges != NULL)
     {
-        sock->close_cb(sock, sock->close_arg);
+        memcpy(ranges, stream->zerocopy.ranges,
+            sizeof(ev_stream_zerocopy_range_t) * stream->zerocopy.range_num);
+        ev__loop_free(stream->loop, stream->zerocopy.ranges);
     }
-    ev_free(sock);
+    stream->zerocopy.ranges = ranges;
+    stream->zerocopy.range_cap = cap;
+    return 0;
 }
 
-static void _ev_tcp_smart_deactive(ev_tcp_t *sock)
+/**
+ * @brief Record completion of sends [\p lo, \p hi].
+ *
+ * seq_done only moves forward, and only over sends that are all completed.
+ * Ranges after a gap are kept until the gap is closed.
+ */
+static void _ev_stream_zerocopy_complete(ev_nonblock_stream_t* stream,
+    uint32_t lo, uint32_t hi)
 {
-    if (sock->base.data.flags & EV_HANDLE_TCP_LISTING)
+    size_t i, j;
+    ev_stream_zerocopy_range_t* ranges = stream->zerocopy.ranges;
+    uint32_t done = stream->zerocopy.seq_done;
+
+    /* Already counted */
+    if (_ev_stream_zerocopy_cmp(hi, done) < 0)
     {
-        size_t size = ev_list_size(&sock->backend.u.listen.accept_queue);
-        if (size != 0)
-        {
-            return;
-        }
+        return;
     }
-    else if (sock->base.data.flags & EV_HANDLE_TCP_ACCEPTING)
+
+    /* Insert sorted by start, room is reserved by caller */
+    for (i = stream->zerocopy.range_num; i > 0; i--)
     {
-        if (sock->backend.u.accept.cb != NULL)
+        if (_ev_stream_zerocopy_cmp(ranges[i - 1].lo, lo) <= 0)
         {
-            return;
+            break;
         }
+        ranges[i] = ranges[i - 1];
     }
-    else if (sock->base.data.flags & EV_HANDLE_TCP_CONNECTING)
+    ranges[i].lo = lo;
+    ranges[i].hi = hi;
+    stream->zerocopy.range_num++;
+
+    /* Merge overlapping and adjacent ranges */
+    for (i = 0, j = 1; j < stream->zerocopy.range_num; j++)
     {
-        if (sock->backend.u.client.cb != NULL)
+        if (_ev_stream_zerocopy_cmp(ranges[j].lo, ranges[i].hi + 1) <= 0)
         {
-            return;
+            if (_ev_stream_zerocopy_cmp(ranges[j].hi, ranges[i].hi) > 0)
+            {
+                ranges[i].hi = ranges[j].hi;
+            }
+            continue;
         }
+        ranges[++i] = ranges[j];
     }
-    else if (sock->base.data.flags & EV_HANDLE_TCP_STREAMING)
+    stream->zerocopy.range_num = i + 1;
+
+    /* Advance over the leading range if there is no gap before it */
+    if (_ev_stream_zerocopy_cmp(ranges[0].lo, done) <= 0)
     {
-        size_t io_sz = ev__nonblock_stream_size(&sock->backend.u.stream,
-                                                EV_IO_IN | EV_IO_OUT);
-        if (io_sz != 0)
-        {
-            return;
-        }
+        stream->zerocopy.seq_done = ranges[0].hi + 1;
+        stream->zerocopy.range_num--;
+        memmove(ranges, ranges + 1,
+            sizeof(ev_stream_zerocopy_range_t) * stream->zerocopy.range_num);
     }
-
-    ev__handle_deactive(&sock->base);
 }
 
-static void _ev_tcp_on_connect(ev_tcp_t *sock)
+static void _ev_stream_do_zerocopy(ev_nonblock_stream_t* stream)
 {
-    int       ret;
-    socklen_t result_len = sizeof(ret);
-
-    ev__nonblock_io_del(sock->base.loop, &sock->backend.u.client.io, EV_IO_OUT);
+    uint32_t lo, hi;
+    uint32_t seq_done = stream->zerocopy.seq_done;
 
-    /* Get connect result */
-    if (getsockopt(sock->sock, SOL_SOCKET, SO_ERROR, &ret, &result_len) < 0)
+    /* Notification is only read if it can be recorded */
+    while (_ev_stream_zerocopy_reserve(stream) == 0 &&
+        ev__zerocopy_notify_unix(stream->io.data.fd, &lo, &hi) > 0)
     {
-        sock->backend.u.client.stat = ev__translate_sys_error(errno);
-        goto fin;
+        _ev_stream_zerocopy_complete(stream, lo, hi);
     }
 
-    /* Result is in `result` */
-    sock->backend.u.client.stat = ev__translate_sys_error(ret);
-
-fin:
-    sock->base.data.flags &= ~EV_HANDLE_TCP_CONNECTING;
-    _ev_tcp_connect_callback_once(sock, sock->backend.u.client.stat);
-    _ev_tcp_smart_deactive(sock);
-}
+    if (stream->zerocopy.seq_done == seq_done)
+    {
+        return;
+    }
 
-static void _ev_tcp_w_user_callback_unix(ev_tcp_t           *sock,
-                                         ev_tcp_write_req_t *req, ssize_t size)
-{
-    _ev_tcp_smart_deactive(sock);
-    ev__write_exit(&req->base);
-    req->write_cb(sock, size, req->write_arg);
-    ev_free(req);
+    _ev_stream_zerocopy_watch(stream);
+    stream->zerocopy.cb(stream, stream->zerocopy.seq_done);
 }
 
-static void _ev_tcp_r_user_callback_unix(ev_tcp_t *sock, ev_tcp_read_req_t *req,
-                                         ssize_t size)
+static void _ev_stream_check_watermark(ev_nonblock_stream_t* stream)
 {
-    _ev_tcp_smart_deactive(sock);
-    ev__read_exit(&req->base);
-    req->read_cb(sock, size, req->read_arg);
-    ev_free(req);
-}
+    if (stream->watermark.cb == NULL || stream->flags.io_abort)
+    {
+        return;
+    }
 
-static void _on_tcp_write_done(ev_nonblock_stream_t *stream, ev_write_t *req,
-                               ssize_t size)
-{
-    ev_tcp_t *sock = EV_CONTAINER_OF(stream, ev_tcp_t, backend.u.stream);
-    ev_tcp_write_req_t *w_req = EV_CONTAINER_OF(req, ev_tcp_write_req_t, base);
-    _ev_tcp_w_user_callback_unix(sock, w_req, size);
+    if (!stream->watermark.is_high && stream->pending.w_size >= stream->watermark.high)
+    {
+        stream->watermark.is_high = 1;
+        stream->watermark.cb(stream, 1);
+    }
+    else if (stream->watermark.is_high && stream->pending.w_size <= stream->watermark.low)
+    {
+        stream->watermark.is_high = 0;
+        stream->watermark.cb(stream, 0);
+    }
 }
 
-static void _on_tcp_read_done(ev_nonblock_stream_t *stream, ev_read_t *req,
-                              ssize_t size)
+/**
+ * @brief Send file request at the head of queue.
+ *
+ * If the file is shorter than requested, \p req is finished with less data
+ * than its capacity, and the rest of queue is not affected.
+ *
+ * @return  #EV_SUCCESS if \p req is finished, #EV_EAGAIN if socket buffer is
+ *          full, or #ev_errno_t.
+ */
+static int _ev_stream_do_sendfile(ev_nonblock_stream_t* stream, ev_nonblock_stream_file_t* req, ev_list_t* done)
 {
-    ev_tcp_t *sock = EV_CONTAINER_OF(stream, ev_tcp_t, backend.u.stream);
-
-    ev_tcp_read_req_t *r_req = EV_CONTAINER_OF(req, ev_tcp_read_req_t, base);
-    _ev_tcp_r_user_callback_unix(sock, r_req, size);
-}
+    while (req->base.size < req->base.capacity)
+    {
+        ssize_t ret = ev__sendfile_unix(stream->io.data.fd, req->fd, req->offset,
+            req->base.capacity - req->base.size);
+        if (ret < 0)
+        {
+            return (int)ret;
+        }
+        if (ret == 0)
+        {
+            stream->pending.w_size -= req->base.capacity - req->base.size;
+            break;
+        }
 
-static void _ev_tcp_accept_user_callback_unix(ev_tcp_t *acpt, ev_tcp_t *conn,
-                                              int ret)
-{
-    conn->base.data.flags &= ~EV_HANDLE_TCP_ACCEPTING;
-    _ev_tcp_smart_deactive(conn);
-    _ev_tcp_smart_deactive(acpt);
+        req->offset += ret;
+        req->base.size += ret;
+        stream->pending.w_size -= ret;
+    }
 
-    ev_tcp_accept_cb bak_cb = conn->backend.u.accept.cb;
-    void            *cb_arg = conn->backend.u.accept.arg;
-    conn->backend.u.accept.cb = NULL;
-    conn->backend.u.accept.arg = NULL;
-    bak_cb(acpt, conn, ret, cb_arg);
+    ev_list_erase(&stream->pending.w_queue, &req->base.node);
+    ev_list_push_back(done, &req->base.node);
+    return 0;
 }
 
-static void _ev_tcp_on_accept(ev_tcp_t *acpt)
+/**
+ * @brief Distribute \p write_size bytes over queued write requests.
+ *
+ * Finished requests are moved into \p done in order.
+ *
+ * @return  #EV_SUCCESS if all bytes are consumed by finished requests,
+ *          #EV_EAGAIN if the head request is left partially sent.
+ */
+static int _ev_stream_finalize_write(ev_nonblock_stream_t* stream, size_t write_size, ev_list_t* done)
 {
-    ev_list_node_t *it =
-        ev_list_pop_front(&acpt->backend.u.listen.accept_queue);
-    if (it == NULL)
+    ev_list_node_t* it;
+    while ((it = ev_list_begin(&stream->pending.w_queue)) != NULL)
     {
-        EV_ABORT("empty accept queue");
-    }
-
-    ev_tcp_t *conn =
-        EV_CONTAINER_OF(it, ev_tcp_t, backend.u.accept.accept_node);
-    _ev_tcp_close_fd(conn);
+        ev_write_t* req = EV_CONTAINER_OF(it, ev_write_t, node);
+        size_t left = req->capacity - req->size;
 
-    do
-    {
-        conn->sock = accept(acpt->sock, NULL, NULL);
-    } while (conn->sock == -1 && errno == EINTR);
+        /* Gathered data never cover a file request */
+        if (ev__nonblock_stream_is_file(req) && left != 0)
+        {
+            break;
+        }
 
-    int ret = conn->sock >= 0 ? 0 : ev__translate_sys_error(errno);
-    if (ret == 0)
-    { /* Set non-block mode */
-        if ((ret = ev__nonblock(conn->sock, 1)) != 0)
+        if (write_size < left)
         {
-            _ev_tcp_close_fd(conn);
+            /* Zero bytes written means the socket buffer is full */
+            if (write_size == 0)
+            {
+                return EV_EAGAIN;
+            }
+            return ev__finalize_send_req_unix(req, write_size);
         }
+
+        ev__finalize_send_req_unix(req, left);
+        write_size -= left;
+
+        ev_list_erase(&stream->pending.w_queue, it);
+        ev_list_push_back(done, it);
     }
 
-    _ev_tcp_accept_user_callback_unix(acpt, conn, ret);
+    return 0;
+}
 
-    /* might be close in callback */
-    if (ev__handle_is_closing(&acpt->base))
+static int _ev_stream_do_read_once(ev_nonblock_stream_t* stream, ev_read_t* req, size_t* size)
+{
+    int iovcnt = req->data.nbuf;
+    if (iovcnt > g_ev_loop_unix_ctx.iovmax)
     {
-        return;
+        iovcnt = g_ev_loop_unix_ctx.iovmax;
     }
-    if (ev_list_size(&acpt->backend.u.listen.accept_queue) == 0)
+
+    ssize_t read_size;
+    read_size = ev__readv_unix(stream->io.data.fd, req->data.bufs, iovcnt);
+    if (read_size >= 0)
     {
-        ev__nonblock_io_del(acpt->base.loop, &acpt->backend.u.listen.io,
-                            EV_IO_IN);
+        *size = read_size;
+        return 0;
     }
+    return read_size;
 }
 
-static void _ev_tcp_on_server_event(ev_nonblock_io_t *io, unsigned evts,
-                                    void *arg)
+static void _ev_stream_do_write(ev_nonblock_stream_t* stream)
 {
-    (void)evts;
-    (void)arg;
-    ev_tcp_t *sock = EV_CONTAINER_OF(io, ev_tcp_t, backend.u.listen.io);
-
-    _ev_tcp_on_accept(sock);
+    ssize_t ret;
+    ev_list_node_t* it;
+    ev_write_t* req;
+    ev_buf_t iov[EV_STREAM_WRITEV_MAX];
+    ev_list_t done = EV_LIST_INIT;
+
+    int iovmax = g_ev_loop_unix_ctx.iovmax;
+    if (iovmax > EV_STREAM_WRITEV_MAX)
+    {
+        iovmax = EV_STREAM_WRITEV_MAX;
+    }
+
+    /*
+     * Send buffers of as many queued requests as possible in one syscall, and
+     * keep going until the queue is drained or the socket buffer is full.
+     */
+    do
+    {
+        if ((it = ev_list_begin(&stream->pending.w_queue)) == NULL)
+        {
+            ret = 0;
+            break;
+        }
+
+        req = EV_CONTAINER_OF(it, ev_write_t, node);
+        if (ev__nonblock_stream_is_file(req))
+        {
+            ev_nonblock_stream_file_t* file_req =
+                EV_CONTAINER_OF(req, ev_nonblock_stream_file_t, base);
+            ret = _ev_stream_do_sendfile(stream, file_req, &done);
+            continue;
+        }
+
+        int iovcnt = _ev_stream_gather_write(stream, iov, iovmax);
+        if (iovcnt == 0)
+        {
+            /* Empty requests at head */
+            ret = _ev_stream_finalize_write(stream, 0, &done);
+            continue;
+        }
+
+        if ((ret = _ev_stream_writev(stream, iov, iovcnt)) < 0)
+        {
+            if (ret == EV_ENOBUFS)
+            {
+                ret = EV_EAGAIN;
+            }
+            break;
+        }
+
+        stream->pending.w_size -= ret;
+        ret = _ev_stream_finalize_write(stream, (size_t)ret, &done);
+    } while (ret == 0 && ev_list_size(&stream->pending.w_queue) != 0);
+
+    while ((it = ev_list_pop_front(&done)) != NULL)
+    {
+        req = EV_CONTAINER_OF(it, ev_write_t, node);
+
+        /* Only a file request is finished short, when the file ends early */
+        stream->callbacks.w_cb(stream, req,
+            req->size == req->capacity ? (ssize_t)req->size : EV_EOF);
+    }
+
+    if (ret >= 0 || ret == EV_EAGAIN)
+    {
+        _ev_stream_check_watermark(stream);
+        return;
+    }
+
+    stream->pending.w_size = 0;
+    while ((it = ev_list_pop_front(&stream->pending.w_queue)) != NULL)
+    {
+        req = EV_CONTAINER_OF(it, ev_write_t, node);
+        stream->callbacks.w_cb(stream, req, ret);
+    }
+    _ev_stream_check_watermark(stream);
 }
 
-static void _ev_tcp_on_client_event(ev_nonblock_io_t *io, unsigned evts,
-                                    void *arg)
+static void _ev_stream_do_read(ev_nonblock_stream_t* stream)
 {
-    (void)evts;
-    (void)arg;
-    ev_tcp_t *sock = EV_CONTAINER_OF(io, ev_tcp_t, backend.u.client.io);
+    int ret;
+    ev_list_node_t* it = ev_list_pop_front(&stream->pending.r_queue);
+    ev_read_t* req = EV_CONTAINER_OF(it, ev_read_t, node);
 
-    _ev_tcp_on_connect(sock);
+    size_t r_size = 0;
+    ret = _ev_stream_do_read_once(stream, req, &r_size);
+    req->data.size += r_size;
+
+    if (ret == 0)
+    {
+        stream->callbacks.r_cb(stream, req, req->data.size);
+        return;
+    }
+
+    ev_list_push_front(&stream->pending.r_queue, it);
+
+    if (ret == EV_EAGAIN)
+    {
+        return;
+    }
+
+    /* If error, cleanup all pending read requests */
+    while ((it = ev_list_pop_front(&stream->pending.r_queue)) != NULL)
+    {
+        req = EV_CONTAINER_OF(it, ev_read_t, node);
+        stream->callbacks.r_cb(stream, req, ret);
+    }
 }
 
-/**
- * @return #ev_errno_t
- */
-static int _ev_tcp_setup_fd(ev_tcp_t *sock, int domain, int is_server,
-                            int *new_fd)
+static void _ev_stream_cleanup_r(ev_nonblock_stream_t* stream, int errcode)
 {
-    int ret = 0;
-    int tmp_new_fd = 0;
-    if (sock->sock != EV_OS_SOCKET_INVALID)
+    ev_list_node_t* it;
+    while ((it = ev_list_pop_front(&stream->pending.r_queue)) != NULL)
     {
-        goto fin;
+        ev_read_t* req = EV_CONTAINER_OF(it, ev_read_t, node);
+        stream->callbacks.r_cb(stream, req, errcode);
     }
+}
 
-    if ((sock->sock = socket(domain, SOCK_STREAM, 0)) == EV_OS_SOCKET_INVALID)
+static void _ev_stream_cleanup_w(ev_nonblock_stream_t* stream, int errcode)
+{
+    ev_list_node_t* it;
+    stream->pending.w_size = 0;
+    while ((it = ev_list_pop_front(&stream->pending.w_queue)) != NULL)
     {
-        ret = ev__translate_sys_error(errno);
-        goto fin;
+        ev_write_t* req = EV_CONTAINER_OF(it, ev_write_t, node);
+        stream->callbacks.w_cb(stream, req, errcode);
     }
+}
 
-    if ((ret = ev__nonblock(sock->sock, 1)) != 0)
+static void _ev_stream_want(ev_nonblock_stream_t* stream, unsigned evt, int want)
+{
+    unsigned reg = evt == EV_IO_IN ? stream->flags.io_reg_r : stream->flags.io_reg_w;
+    if (stream->flags.io_abort || !want == !reg)
     {
-        goto err_nonblock;
+        return;
     }
 
-    tmp_new_fd = 1;
-    if (is_server)
+    if (want)
     {
-        ev__nonblock_io_init(&sock->backend.u.listen.io, sock->sock,
-                             _ev_tcp_on_server_event, NULL);
+        ev__nonblock_io_add(stream->loop, &stream->io, evt);
     }
     else
     {
-        ev__nonblock_io_init(&sock->backend.u.client.io, sock->sock,
-                             _ev_tcp_on_client_event, NULL);
+        ev__nonblock_io_del(stream->loop, &stream->io, evt);
     }
 
-    goto fin;
-
-err_nonblock:
-    _ev_tcp_close_fd(sock);
-fin:
-    if (new_fd != NULL)
+    if (evt == EV_IO_IN)
     {
-        *new_fd = tmp_new_fd;
+        stream->flags.io_reg_r = want ? 1 : 0;
+    }
+    else
+    {
+        stream->flags.io_reg_w = want ? 1 : 0;
     }
-    return ret;
 }
 
-static int _ev_tcp_is_listening(ev_tcp_t *sock)
+/**
+ * @brief Register IO events that queued requests and splices are waiting for.
+ */
+static void _ev_stream_update_io(ev_nonblock_stream_t* stream)
 {
-    return sock->base.data.flags & EV_HANDLE_TCP_LISTING;
+    ev_nonblock_splice_t* in = stream->splice.as_src;
+    ev_nonblock_splice_t* out = stream->splice.as_dst;
+
+    int want_in = ev_list_size(&stream->pending.r_queue) != 0 ||
+        (in != NULL && !in->flags.canceled && !in->flags.src_eof &&
+        !in->flags.pipe_full && in->buffered < in->capacity);
+    int want_out = ev_list_size(&stream->pending.w_queue) != 0 ||
+        (out != NULL && !out->flags.canceled && out->buffered != 0);
+
+    _ev_stream_want(stream, EV_IO_IN, want_in);
+    _ev_stream_want(stream, EV_IO_OUT, want_out);
 }
 
-static void _ev_tcp_to_connect(ev_handle_t *handle)
+static void _ev_stream_splice_finish(ev_nonblock_splice_t* req, int stat)
 {
-    ev_tcp_t *sock = EV_CONTAINER_OF(handle, ev_tcp_t, base);
+    req->src->splice.as_src = NULL;
+    req->dst->splice.as_dst = NULL;
+    _ev_stream_update_io(req->src);
+    _ev_stream_update_io(req->dst);
 
-    sock->base.data.flags &= ~EV_HANDLE_TCP_CONNECTING;
-    _ev_tcp_connect_callback_once(sock, 0);
+    close(req->pipefd[0]);
+    close(req->pipefd[1]);
+    req->pipefd[0] = -1;
+    req->pipefd[1] = -1;
+
+    req->cb(req, stat);
 }
 
-static void _ev_tcp_setup_stream_once(ev_tcp_t *sock)
+/**
+ * @brief Move data from source into pipe.
+ * @return  #EV_SUCCESS, or #ev_errno_t if source failed.
+ */
+static int _ev_stream_splice_fill(ev_nonblock_splice_t* req)
 {
-    if (sock->base.data.flags & EV_HANDLE_TCP_STREAMING)
+    ssize_t ret;
+    while (!req->flags.src_eof && req->buffered < req->capacity)
     {
-        return;
+        ret = ev__splice_unix(req->src->io.data.fd, req->pipefd[1],
+            req->capacity - req->buffered);
+        if (ret == 0)
+        {
+            req->flags.src_eof = 1;
+            break;
+        }
+        if (ret < 0)
+        {
+            if (ret != EV_EAGAIN)
+            {
+                return (int)ret;
+            }
+            /*
+             * Either source is drained or pipe runs out of slots before
+             * reaching capacity. Stop watching source until pipe is drained
+             * in the latter case, or a readable source wakes us for nothing.
+             */
+            req->flags.pipe_full = req->buffered != 0;
+            break;
+        }
+        req->buffered += ret;
     }
-    ev__nonblock_stream_init(sock->base.loop, &sock->backend.u.stream,
-                             sock->sock, _on_tcp_write_done, _on_tcp_read_done);
-    sock->base.data.flags |= EV_HANDLE_TCP_STREAMING;
+    return 0;
 }
 
-int ev_tcp_init(ev_loop_t *loop, ev_tcp_t **sock)
+/**
+ * @brief Move data from pipe into destination.
+ * @return  #EV_SUCCESS, or #ev_errno_t if destination failed.
+ */
+static int _ev_stream_splice_drain(ev_nonblock_splice_t* req)
 {
-    ev_tcp_t *new_sock = ev_malloc(sizeof(ev_tcp_t));
-    if (new_sock == NULL)
+    ssize_t ret;
+    while (req->buffered != 0)
     {
-        return EV_ENOMEM;
+        ret = ev__splice_unix(req->pipefd[0], req->dst->io.data.fd, req->buffered);
+        if (ret == EV_EAGAIN || ret == 0)
+        {
+            break;
+        }
+        if (ret < 0)
+        {
+            return (int)ret;
+        }
+        req->buffered -= ret;
+        req->size += ret;
+        req->flags.pipe_full = 0;
     }
-
-    ev__handle_init(loop, &new_sock->base, EV_ROLE_EV_TCP);
-    new_sock->close_cb = NULL;
-    new_sock->close_arg = NULL;
-    new_sock->sock = EV_OS_SOCKET_INVALID;
-
-    *sock = new_sock;
     return 0;
 }
 
-void ev_tcp_exit(ev_tcp_t *sock, ev_tcp_close_cb cb, void *arg)
+static void _ev_stream_splice_run(ev_nonblock_splice_t* req)
 {
-    /* Stop all pending IO actions */
-    if (sock->base.data.flags & EV_HANDLE_TCP_STREAMING)
+    int ret;
+    if (req->flags.canceled)
     {
-        ev__nonblock_stream_abort(&sock->backend.u.stream);
+        return;
     }
-    if (sock->base.data.flags & EV_HANDLE_TCP_LISTING)
+
+    if ((ret = _ev_stream_splice_fill(req)) != 0 ||
+        (ret = _ev_stream_splice_drain(req)) != 0)
     {
-        ev__nonblock_io_del(sock->base.loop, &sock->backend.u.listen.io,
-                            EV_IO_IN);
+        _ev_stream_splice_finish(req, ret);
+        return;
     }
-    if (sock->base.data.flags & EV_HANDLE_TCP_CONNECTING)
+
+    if (req->flags.src_eof && req->buffered == 0)
     {
-        ev__nonblock_io_del(sock->base.loop, &sock->backend.u.client.io,
-                            EV_IO_OUT);
+        _ev_stream_splice_finish(req, 0);
+        return;
     }
 
-    /* Close fd */
-    _ev_tcp_close_fd(sock);
-
-    sock->close_cb = cb;
-    sock->close_arg = arg;
-    ev__handle_exit(&sock->base, _ev_tcp_on_close);
+    _ev_stream_update_io(req->src);
+    _ev_stream_update_io(req->dst);
 }
 
-int ev_tcp_bind(ev_tcp_t *tcp, const struct sockaddr *addr, size_t addrlen)
+static void _ev_stream_splice_cancel(ev_nonblock_splice_t* req)
 {
-    int ret;
-    int flag_new_fd;
-    if ((ret = _ev_tcp_setup_fd(tcp, addr->sa_family, 1, &flag_new_fd)) != 0)
+    if (req == NULL || req->flags.canceled)
     {
-        return ret;
+        return;
     }
+    req->flags.canceled = 1;
+    _ev_stream_update_io(req->src);
+    _ev_stream_update_io(req->dst);
+}
 
-    if ((ret = bind(tcp->sock, addr, addrlen)) != 0)
+static void _ev_nonblock_stream_on_io(ev_nonblock_io_t* io, unsigned evts, void* arg)
+{
+    (void)arg;
+    ev_nonblock_stream_t* stream = EV_CONTAINER_OF(io, ev_nonblock_stream_t, io);
+
+    if ((evts & EPOLLERR) && stream->zerocopy.cb != NULL)
     {
-        ret = ev__translate_sys_error(errno);
-        goto err_bind;
+        _ev_stream_do_zerocopy(stream);
+        if (stream->flags.io_abort)
+        {
+            return;
+        }
     }
-    tcp->base.data.flags |= EV_HABDLE_TCP_BOUND;
 
-    return 0;
+    if ((evts & (EPOLLIN | EPOLLHUP | EPOLLERR)) && stream->splice.as_src != NULL)
+    {
+        _ev_stream_splice_run(stream->splice.as_src);
+        if (stream->flags.io_abort)
+        {
+            return;
+        }
+    }
 
-err_bind:
-    if (flag_new_fd)
+    if ((evts & (EPOLLOUT | EPOLLERR)) && stream->splice.as_dst != NULL)
     {
-        _ev_tcp_close_fd(tcp);
+        _ev_stream_splice_run(stream->splice.as_dst);
+        if (stream->flags.io_abort)
+        {
+            return;
+        }
     }
-    return ret;
-}
 
-int ev_tcp_listen(ev_tcp_t *tcp, int backlog)
-{
-    if (_ev_tcp_is_listening(tcp))
+    if ((evts & EPOLLOUT) && ev_list_size(&stream->pending.w_queue) != 0)
     {
-        return EV_EADDRINUSE;
+        _ev_stream_do_write(stream);
     }
 
-    int ret;
-    if ((ret = listen(tcp->sock, backlog)) != 0)
+    else if ((evts & (EPOLLIN | EPOLLHUP)) && ev_list_size(&stream->pending.r_queue) != 0)
     {
-        return ev__translate_sys_error(errno);
+        _ev_stream_do_read(stream);
     }
 
-    ev_list_init(&tcp->backend.u.listen.accept_queue);
-    tcp->base.data.flags |= EV_HANDLE_TCP_LISTING;
+    _ev_stream_update_io(stream);
+}
 
-    return 0;
+EV_LOCAL void ev__nonblock_stream_file_init(ev_nonblock_stream_file_t* req,
+    int fd, int64_t offset, size_t len)
+{
+    req->base.bufs = NULL;
+    req->base.nbuf = 0;
+    req->base.size = 0;
+    req->base.capacity = len;
+    req->fd = fd;
+    req->offset = offset;
 }
 
-int ev_tcp_accept(ev_tcp_t *lisn, ev_tcp_t *conn, ev_tcp_accept_cb cb,
-                  void *arg)
+EV_LOCAL int ev__nonblock_stream_is_file(const ev_write_t* req)
 {
-    if (lisn == NULL || conn == NULL || cb == NULL)
-    {
-        return EV_EINVAL;
-    }
-    if (conn->base.data.flags & EV_HANDLE_TCP_ACCEPTING)
-    {
-        return EV_EINPROGRESS;
-    }
+    return req->bufs == NULL;
+}
 
-    conn->base.data.flags |= EV_HANDLE_TCP_ACCEPTING;
-    conn->backend.u.accept.cb = cb;
-    conn->backend.u.accept.arg = arg;
-    ev_list_push_back(&lisn->backend.u.listen.accept_queue,
-                      &conn->backend.u.accept.accept_node);
-    ev__nonblock_io_add(lisn->base.loop, &lisn->backend.u.listen.io, EV_IO_IN);
+EV_LOCAL void ev__nonblock_stream_init(ev_loop_t* loop,
+    ev_nonblock_stream_t* stream, int fd, ev_stream_write_cb wcb,
+    ev_stream_read_cb rcb)
+{
+    stream->loop = loop;
 
-    ev__handle_active(&lisn->base);
-    ev__handle_active(&conn->base);
+    stream->flags.io_abort = 0;
+    stream->flags.io_reg_r = 0;
+    stream->flags.io_reg_w = 0;
+    stream->flags.io_reg_e = 0;
 
-    return 0;
+    ev__nonblock_io_init(&stream->io, fd, _ev_nonblock_stream_on_io, NULL);
+
+    ev_list_init(&stream->pending.w_queue);
+    ev_list_init(&stream->pending.r_queue);
+    stream->pending.w_size = 0;
+
+    stream->callbacks.w_cb = wcb;
+    stream->callbacks.r_cb = rcb;
+
+    stream->zerocopy.cb = NULL;
+    stream->zerocopy.seq_sent = 0;
+    stream->zerocopy.seq_done = 0;
+    stream->zerocopy.ranges = NULL;
+    stream->zerocopy.range_num = 0;
+    stream->zerocopy.range_cap = 0;
+
+    stream->watermark.cb = NULL;
+    stream->watermark.low = 0;
+    stream->watermark.high = 0;
+    stream->watermark.is_high = 0;
+
+    stream->splice.as_src = NULL;
+    stream->splice.as_dst = NULL;
 }
 
-int ev_tcp_write(ev_tcp_t *sock, ev_buf_t *bufs, size_t nbuf,
-                 ev_tcp_write_cb cb, void *arg)
+EV_LOCAL void ev__nonblock_stream_watermark(ev_nonblock_stream_t* stream,
+    size_t low, size_t high, ev_stream_watermark_cb cb)
 {
-    if (sock->base.data.flags &
-        (EV_HANDLE_TCP_LISTING | EV_HANDLE_TCP_ACCEPTING |
-         EV_HANDLE_TCP_CONNECTING))
-    {
-        return EV_EINVAL;
-    }
+    stream->watermark.cb = cb;
+    stream->watermark.low = low;
+    stream->watermark.high = high;
+    stream->watermark.is_high = 0;
+    _ev_stream_check_watermark(stream);
+}
 
-    ev_tcp_write_req_t *req = ev_malloc(sizeof(ev_tcp_write_req_t));
-    if (req == NULL)
+EV_LOCAL int ev__nonblock_stream_splice(ev_nonblock_splice_t* req,
+    ev_nonblock_stream_t* src, ev_nonblock_stream_t* dst, size_t capacity,
+    ev_stream_splice_cb cb)
+{
+#if defined(__linux__)
+    if (src->flags.io_abort || dst->flags.io_abort)
     {
-        return EV_ENOMEM;
+        return EV_EBADF;
     }
-
-    req->write_cb = cb;
-    req->write_arg = arg;
-    int ret = ev__write_init(&req->base, bufs, nbuf);
-    if (ret != 0)
+    if (src->splice.as_src != NULL || ev_list_size(&src->pending.r_queue) != 0 ||
+        dst->splice.as_dst != NULL || ev_list_size(&dst->pending.w_queue) != 0)
     {
-        ev_free(req);
-        return ret;
+        return EV_EBUSY;
     }
 
-    _ev_tcp_setup_stream_once(sock);
-
-    ev__handle_active(&sock->base);
-    ret = ev__nonblock_stream_write(&sock->backend.u.stream, &req->base);
-
-    if (ret != 0)
+    if (pipe2(req->pipefd, O_NONBLOCK | O_CLOEXEC) != 0)
     {
-        _ev_tcp_smart_deactive(sock);
-        ev_free(req);
-        return ret;
+        return ev__translate_sys_error(errno);
     }
-    return 0;
-}
 
-int ev_tcp_read(ev_tcp_t *sock, ev_buf_t *bufs, size_t nbuf, ev_tcp_read_cb cb,
-                void *arg)
-{
-    if (sock->base.data.flags &
-        (EV_HANDLE_TCP_LISTING | EV_HANDLE_TCP_ACCEPTING |
-         EV_HANDLE_TCP_CONNECTING))
+    if (capacity == 0)
     {
-        return EV_EINVAL;
+        capacity = EV_STREAM_SPLICE_CAPACITY;
     }
 
-    ev_tcp_read_req_t *req = ev_malloc(sizeof(ev_tcp_read_req_t));
-    if (req == NULL)
+    /* Kernel may refuse to grow pipe beyond /proc/sys/fs/pipe-max-size */
+    int pipe_sz = fcntl(req->pipefd[1], F_GETPIPE_SZ);
+    if (pipe_sz > 0 && (size_t)pipe_sz < capacity)
     {
-        return EV_ENOMEM;
+        int new_sz = fcntl(req->pipefd[1], F_SETPIPE_SZ,
+            capacity > INT_MAX ? INT_MAX : (int)capacity);
+        if (new_sz > 0)
+        {
+            pipe_sz = new_sz;
+        }
     }
-
-    req->read_cb = cb;
-    req->read_arg = arg;
-    int ret = ev__read_init(&req->base, bufs, nbuf);
-    if (ret != 0)
+    if (pipe_sz > 0 && (size_t)pipe_sz < capacity)
     {
-        ev_free(req);
-        return ret;
+        capacity = pipe_sz;
     }
 
-    _ev_tcp_setup_stream_once(sock);
+    req->src = src;
+    req->dst = dst;
+    req->capacity = capacity;
+    req->buffered = 0;
+    req->size = 0;
+    req->flags.src_eof = 0;
+    req->flags.pipe_full = 0;
+    req->flags.canceled = 0;
+    req->cb = cb;
 
-    ev__handle_active(&sock->base);
-    ret = ev__nonblock_stream_read(&sock->backend.u.stream, &req->base);
+    src->splice.as_src = req;
+    dst->splice.as_dst = req;
+    _ev_stream_update_io(src);
 
-    if (ret != 0)
-    {
-        _ev_tcp_smart_deactive(sock);
-        ev_free(req);
-        return ret;
-    }
     return 0;
+#else
+    (void)req; (void)src; (void)dst; (void)capacity; (void)cb;
+    return EV_ENOSYS;
+#endif
 }
 
-int ev_tcp_getsockname(ev_tcp_t *sock, struct sockaddr *name, size_t *len)
+EV_LOCAL void ev__nonblock_stream_zerocopy(ev_nonblock_stream_t* stream, ev_stream_zerocopy_cb cb)
 {
-    socklen_t socklen = *len;
-    if (getsockname(sock->sock, name, &socklen) != 0)
+    stream->zerocopy.cb = cb;
+}
+
+EV_LOCAL void ev__nonblock_stream_exit(ev_nonblock_stream_t* stream)
+{
+    ev__nonblock_stream_abort(stream);
+    ev__nonblock_stream_cleanup(stream, EV_IO_IN | EV_IO_OUT);
+    if (stream->zerocopy.ranges != NULL)
     {
-        return ev__translate_sys_error(errno);
+        ev__loop_free(stream->loop, stream->zerocopy.ranges);
+        stream->zerocopy.ranges = NULL;
+        stream->zerocopy.range_num = 0;
+        stream->zerocopy.range_cap = 0;
     }
-
-    *len = (size_t)socklen;
-    return 0;
+    stream->loop = NULL;
+    stream->callbacks.w_cb = NULL;
+    stream->callbacks.r_cb = NULL;
 }
 
-int ev_tcp_getpeername(ev_tcp_t *sock, struct sockaddr *name, size_t *len)
+EV_LOCAL int ev__nonblock_stream_write(ev_nonblock_stream_t* stream, ev_write_t* req)
 {
-    int       ret;
-    socklen_t socklen = *len;
+    if (stream->flags.io_abort)
+    {
+        return EV_EBADF;
+    }
+    if (stream->splice.as_dst != NULL)
+    {
+        return EV_EBUSY;
+    }
 
-    if ((ret = getpeername(sock->sock, name, &socklen)) != 0)
+    if (!stream->flags.io_reg_w)
     {
-        return ev__translate_sys_error(errno);
+        ev__nonblock_io_add(stream->loop, &stream->io, EV_IO_OUT);
+        stream->flags.io_reg_w = 1;
     }
 
-    *len = socklen;
+    ev_list_push_back(&stream->pending.w_queue, &req->node);
+    stream->pending.w_size += req->capacity - req->size;
+    _ev_stream_check_watermark(stream);
+
     return 0;
 }
 
-int ev_tcp_connect(ev_tcp_t *sock, struct sockaddr *addr, size_t size,
-                   ev_tcp_connect_cb cb, void *arg)
+EV_LOCAL ssize_t ev__nonblock_stream_try_write(ev_nonblock_stream_t* stream, ev_buf_t* bufs, size_t nbuf)
 {
-    int        ret;
-    ev_loop_t *loop = sock->base.loop;
-
-    if (sock->base.data.flags & EV_HANDLE_TCP_CONNECTING)
+    if (stream->flags.io_abort)
     {
-        return EV_EINPROGRESS;
+        return EV_EBADF;
     }
-    if (sock->base.data.flags &
-        (EV_HANDLE_TCP_LISTING | EV_HANDLE_TCP_ACCEPTING |
-         EV_HANDLE_TCP_STREAMING))
+    if (stream->splice.as_dst != NULL)
     {
-        return EV_EINVAL;
+        return EV_EBUSY;
     }
 
-    if ((ret = _ev_tcp_setup_fd(sock, addr->sa_family, 0, NULL)) != 0)
+    /* Data must not overtake queued requests */
+    if (ev_list_size(&stream->pending.w_queue) != 0)
     {
-        return ret;
+        return EV_EAGAIN;
     }
 
-    sock->backend.u.client.cb = cb;
-    sock->backend.u.client.arg = arg;
-    sock->base.data.flags |= EV_HANDLE_TCP_CONNECTING;
+    int iovcnt = nbuf > (size_t)g_ev_loop_unix_ctx.iovmax ?
+        g_ev_loop_unix_ctx.iovmax : (int)nbuf;
 
-    if ((ret = connect(sock->sock, addr, size)) == 0)
-    { /* Connect success immediately */
-        sock->backend.u.client.stat = 0;
-        ev__backlog_submit(&sock->base, _ev_tcp_to_connect);
-        return 0;
+    ssize_t ret = ev__writev_unix(stream->io.data.fd, bufs, iovcnt);
+    if (ret == EV_ENOBUFS)
+    {
+        return EV_EAGAIN;
     }
-
-    if (errno != EINPROGRESS)
+    if (ret != 0)
     {
-        sock->base.data.flags &= ~EV_HANDLE_TCP_CONNECTING;
-        ret = ev__translate_sys_error(errno);
-        goto err;
+        return ret;
     }
 
-    ev__handle_active(&sock->base);
-    ev__nonblock_io_add(loop, &sock->backend.u.client.io, EV_IO_OUT);
-
+    /* Nothing is written, either socket buffer is full or \p bufs is empty */
+    size_t i;
+    for (i = 0; i < nbuf; i++)
+    {
+        if (bufs[i].size != 0)
+        {
+            return EV_EAGAIN;
+        }
+    }
     return 0;
-
-err:
-    _ev_tcp_close_fd(sock);
-    ev__handle_deactive(&sock->base);
-    return ret;
 }
 
-EV_LOCAL int ev__tcp_open(ev_tcp_t *tcp, int fd)
+EV_LOCAL int ev__nonblock_stream_read(ev_nonblock_stream_t* stream, ev_read_t* req)
 {
-    int busy_flags = EV_HANDLE_TCP_LISTING | EV_HANDLE_TCP_ACCEPTING |
-                     EV_HANDLE_TCP_STREAMING | EV_HANDLE_TCP_CONNECTING |
-                     EV_HABDLE_TCP_BOUND;
-    if (tcp->base.data.flags & busy_flags)
+    if (stream->flags.io_abort)
+    {
+        return EV_EBADF;
+    }
+    if (stream->splice.as_src != NULL)
     {
         return EV_EBUSY;
     }
 
-    tcp->sock = fd;
-    _ev_tcp_setup_stream_once(tcp);
+    if (!stream->flags.io_reg_r)
+    {
+        ev__nonblock_io_add(stream->loop, &stream->io, EV_IO_IN);
+        stream->flags.io_reg_r = 1;
+    }
 
+    ev_list_push_back(&stream->pending.r_queue, &req->node);
     return 0;
 }
 
-// #line 82 "ev.c"
-////////////////////////////////////////////////////////////////////////////////
-// FILE:    ev/unix/thread_unix.c
-// SIZE:    4496
-// SHA-256: 13b9aee2aa71d4bdf5bb081742e23eb63fe086866e1565ec37b028d1f83e50b9
-////////////////////////////////////////////////////////////////////////////////
-// #line 1 "ev/unix/thread_unix.c"
-#define _GNU_SOURCE
-#include <semaphore.h>
-#include <pthread.h>
-#include <unistd.h>
-#include <sys/syscall.h>
-
-struct ev_thread
-{
-    pthread_t thr;
-};
-
-struct ev_thread_key
-{
-    pthread_key_t tls; /**< Thread local storage */
-};
-
-typedef struct ev_thread_helper_unix
+EV_LOCAL size_t ev__nonblock_stream_size(ev_nonblock_stream_t* stream, unsigned evts)
 {
-    ev_thread_cb cb;
-    void        *arg;
-    sem_t        sem;
-} ev_thread_helper_unix_t;
+    size_t ret = 0;
+    if (evts & EV_IO_IN)
+    {
+        ret += ev_list_size(&stream->pending.r_queue);
+        ret += stream->splice.as_src != NULL ? 1 : 0;
+    }
+    if (evts & EV_IO_OUT)
+    {
+        ret += ev_list_size(&stream->pending.w_queue);
+        ret += stream->splice.as_dst != NULL ? 1 : 0;
+    }
+    return ret;
+}
 
-static void *_ev_thread_proxy_unix(void *arg)
+EV_LOCAL void ev__nonblock_stream_abort(ev_nonblock_stream_t* stream)
 {
-    ev_thread_helper_unix_t *p_helper = arg;
-    ev_thread_helper_unix_t  helper = *p_helper;
-
-    if (sem_post(&p_helper->sem) != 0)
+    if (!stream->flags.io_abort)
     {
-        EV_ABORT();
-    }
+        ev__nonblock_io_del(stream->loop, &stream->io, EV_IO_IN | EV_IO_OUT | EPOLLERR);
+        stream->flags.io_abort = 1;
+        stream->flags.io_reg_e = 0;
 
-    helper.cb(helper.arg);
-    return NULL;
+        /* Streams on the other side must stop splicing too */
+        _ev_stream_splice_cancel(stream->splice.as_src);
+        _ev_stream_splice_cancel(stream->splice.as_dst);
+    }
 }
 
-static int s_thread_init(ev_thread_t *thr, const ev_thread_opt_t *opt,
-                         ev_thread_cb cb, void *arg)
+EV_LOCAL void ev__nonblock_stream_cleanup(ev_nonblock_stream_t* stream, unsigned evts)
 {
-    int             err;
-    pthread_attr_t *attr = NULL;
-    pthread_attr_t  attr_storage;
-
-    if (opt != NULL && opt->flags.have_stack_size)
+    if (evts & EV_IO_OUT)
     {
-        if (pthread_attr_init(&attr_storage) != 0)
+        _ev_stream_cleanup_w(stream, EV_ECANCELED);
+        if (stream->splice.as_dst != NULL)
         {
-            err = errno;
-            return ev__translate_sys_error(err);
+            _ev_stream_splice_finish(stream->splice.as_dst, EV_ECANCELED);
         }
+    }
 
-        if (pthread_attr_setstacksize(&attr_storage, opt->stack_size) != 0)
-        {
-            err = errno;
-            goto err_fin;
-        }
-
-        attr = &attr_storage;
-    }
-
-    ev_thread_helper_unix_t helper;
-    helper.cb = cb;
-    helper.arg = arg;
-    if (sem_init(&helper.sem, 0, 0) != 0)
+    if (evts & EV_IO_IN)
     {
-        err = errno;
-        goto err_fin;
+        _ev_stream_cleanup_r(stream, EV_ECANCELED);
+        if (stream->splice.as_src != NULL)
+        {
+            _ev_stream_splice_finish(stream->splice.as_src, EV_ECANCELED);
+        }
     }
+}
 
-    if ((err = pthread_create(&thr->thr, attr, _ev_thread_proxy_unix,
-                              &helper)) != 0)
-    {
-        goto release_sem;
-    }
+// #line 89 "ev.c"
+////////////////////////////////////////////////////////////////////////////////
+// FILE:    ev/unix/tcp_unix.c
+// SIZE:    37831
+// SHA-256: 3331901c40da213442513dcf767a4555ad0f347d653bc0636a73b2086bf804d0
+////////////////////////////////////////////////////////////////////////////////
+// #line 1 "ev/unix/tcp_unix.c"
+#define _GNU_SOURCE
+#include <netinet/tcp.h>
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <assert.h>
+#include <unistd.h>
 
-    do
-    {
-        err = sem_wait(&helper.sem);
-    } while (err == -1 && errno == EINTR);
+/**
+ * @brief File send request token for TCP socket.
+ */
+typedef struct ev_tcp_sendfile_req
+{
+    ev_nonblock_stream_file_t base;      /**< Base object */
+    ev_tcp_write_cb           write_cb;  /**< User callback */
+    void                     *write_arg; /**< User defined argument. */
+} ev_tcp_sendfile_req_t;
 
-    err = err != 0 ? errno : 0;
+/**
+ * @brief Request token of #ev_tcp_pipe_to_ex().
+ */
+typedef struct ev_tcp_pipe_req
+{
+    ev_nonblock_splice_t base;     /**< Base object */
+    ev_loop_t           *loop;     /**< Event loop */
+    ev_role_t            src_role; /**< Type of source handle */
+    void                *src;      /**< Source handle */
+    ev_role_t            dst_role; /**< Type of destination handle */
+    void                *dst;      /**< Destination handle */
+    ev_tcp_pipe_cb       cb;       /**< User callback */
+    void                *arg;      /**< User defined argument. */
+} ev_tcp_pipe_req_t;
 
-release_sem:
-    sem_destroy(&helper.sem);
-err_fin:
-    if (attr != NULL)
+static void _ev_tcp_close_fd(ev_tcp_t *sock)
+{
+    if (sock->sock != EV_OS_SOCKET_INVALID)
     {
-        pthread_attr_destroy(attr);
+        close(sock->sock);
+        sock->sock = EV_OS_SOCKET_INVALID;
     }
-    return ev__translate_sys_error(err);
 }
 
-int ev_thread_init(ev_thread_t **thr, const ev_thread_opt_t *opt,
-                   ev_thread_cb cb, void *arg)
+static void _ev_tcp_cleanup_listen_queue(ev_tcp_t *s_sock, int stat)
 {
-    ev_thread_t *new_thread = ev_malloc(sizeof(ev_thread_t));
-    if (new_thread == NULL)
-    {
-        return EV_ENOMEM;
-    }
-
-    int ret = s_thread_init(new_thread, opt, cb, arg);
-    if (ret != 0)
+    ev_list_node_t *it;
+    while ((it = ev_list_pop_front(&s_sock->backend.u.listen.accept_queue)) !=
+           NULL)
     {
-        ev_free(new_thread);
-        return ret;
+        ev_tcp_t *c_sock =
+            EV_CONTAINER_OF(it, ev_tcp_t, backend.u.accept.accept_node);
+        c_sock->backend.u.accept.cb(s_sock, c_sock, stat,
+                                    c_sock->backend.u.accept.arg);
     }
+}
 
-    *thr = new_thread;
-    return 0;
+static void _ev_tcp_connect_callback_once(ev_tcp_t *sock, int stat)
+{
+    ev_tcp_connect_cb bak_cb = sock->backend.u.client.cb;
+    void             *cb_arg = sock->backend.u.client.arg;
+    sock->backend.u.client.cb = NULL;
+    sock->backend.u.client.arg = NULL;
+    bak_cb(sock, stat, cb_arg);
 }
 
-int ev_thread_exit(ev_thread_t *thr, unsigned long timeout)
+static void _ev_tcp_smart_deactive(ev_tcp_t *sock)
 {
-    int ret = EBUSY;
-    if (timeout == EV_INFINITE_TIMEOUT)
+    if (sock->base.data.flags & EV_HANDLE_TCP_LISTING)
     {
-        int err = pthread_join(thr->thr, NULL);
-        if (err == 0)
+        size_t size = ev_list_size(&sock->backend.u.listen.accept_queue);
+        if (size != 0 || sock->backend.u.listen.on_conn != NULL)
         {
-            ev_free(thr);
-            return 0;
+            return;
         }
-        return ev__translate_sys_error(err);
     }
-
-    const uint64_t t_start = ev_hrtime() / 1000000;
-    const uint64_t t_end = t_start + timeout;
-
-    uint64_t t_now;
-    while ((t_now = ev_hrtime() / 1000000) < t_end)
+    else if (sock->base.data.flags & EV_HANDLE_TCP_ACCEPTING)
     {
-        if ((ret = pthread_tryjoin_np(thr->thr, NULL)) == 0)
+        if (sock->backend.u.accept.cb != NULL)
         {
-            break;
+            return;
         }
-
-        uint64_t t_diff = t_end - t_now;
-        unsigned sleep_time = t_diff < 10 ? t_diff : 10;
-        ev_thread_sleep(sleep_time);
     }
-
-    /* try last time */
-    if (ret == EBUSY)
+    else if (sock->base.data.flags & EV_HANDLE_TCP_CONNECTING)
     {
-        ret = pthread_tryjoin_np(thr->thr, NULL);
+        if (sock->backend.u.client.cb != NULL)
+        {
+            return;
+        }
     }
-    if (ret == 0)
+    else if (sock->base.data.flags & EV_HANDLE_TCP_STREAMING)
     {
-        ev_free(thr);
-        return 0;
+        size_t io_sz = ev__nonblock_stream_size(&sock->backend.u.stream,
+                                                EV_IO_IN | EV_IO_OUT);
+        if (io_sz != 0 || ev_list_size(&sock->backend.w_done) != 0 ||
+            ev_list_size(&sock->backend.zc_queue) != 0)
+        {
+            return;
+        }
     }
 
-    return ret == EBUSY ? EV_ETIMEDOUT : ev__translate_sys_error(ret);
+    ev__handle_deactive(&sock->base);
 }
 
-ev_os_tid_t ev_thread_id(void)
+static void _ev_tcp_on_connect(ev_tcp_t *sock)
 {
-    return syscall(__NR_gettid);
-}
+    int       ret;
+    socklen_t result_len = sizeof(ret);
 
-void ev_thread_sleep(uint32_t timeout)
-{
-    struct timespec t_req, t_rem;
-    t_req.tv_sec = timeout / 1000;
-    t_req.tv_nsec = (timeout - t_req.tv_sec * 1000) * 1000 * 1000;
+    ev__nonblock_io_del(sock->base.loop, &sock->backend.u.client.io, EV_IO_OUT);
 
-    int ret;
-    while ((ret = nanosleep(&t_req, &t_rem)) != 0)
+    /* Get connect result */
+    if (getsockopt(sock->sock, SOL_SOCKET, SO_ERROR, &ret, &result_len) < 0)
     {
-        ret = errno;
-        if (ret != EINTR)
-        {
-            EV_ABORT();
-        }
-        t_req = t_rem;
+        sock->backend.u.client.stat = ev__translate_sys_error(errno);
+        goto fin;
     }
+
+    /* Result is in `result` */
+    sock->backend.u.client.stat = ev__translate_sys_error(ret);
+
+fin:
+    sock->base.data.flags &= ~EV_HANDLE_TCP_CONNECTING;
+    _ev_tcp_connect_callback_once(sock, sock->backend.u.client.stat);
+    _ev_tcp_smart_deactive(sock);
 }
 
-int ev_thread_key_init(ev_thread_key_t **key)
+static void _ev_tcp_w_user_callback_unix(ev_tcp_t           *sock,
+                                         ev_tcp_write_req_t *req, ssize_t size)
 {
-    ev_thread_key_t *new_key = ev_malloc(sizeof(ev_thread_key_t));
-    if (new_key == NULL)
+    _ev_tcp_smart_deactive(sock);
+    ev__write_exit(&req->base);
+    req->write_cb(sock, size, req->write_arg);
+    ev__loop_free(sock->base.loop, req);
+}
+
+static void _ev_tcp_r_user_callback_unix(ev_tcp_t *sock, ev_tcp_read_req_t *req,
+                                         ssize_t size)
+{
+    _ev_tcp_smart_deactive(sock);
+    ev__read_exit(&req->base);
+    req->read_cb(sock, size, req->read_arg);
+    ev__loop_free(sock->base.loop, req);
+}
+
+static void _on_tcp_write_done(ev_nonblock_stream_t *stream, ev_write_t *req,
+                               ssize_t size)
+{
+    ev_tcp_t *sock = EV_CONTAINER_OF(stream, ev_tcp_t, backend.u.stream);
+
+    if (ev__nonblock_stream_is_file(req))
     {
-        return EV_ENOMEM;
+        ev_tcp_sendfile_req_t *f_req =
+            EV_CONTAINER_OF(req, ev_tcp_sendfile_req_t, base.base);
+        _ev_tcp_smart_deactive(sock);
+        f_req->write_cb(sock, size, f_req->write_arg);
+        ev__loop_free(sock->base.loop, f_req);
+        return;
     }
 
-    int ret = pthread_key_create(&new_key->tls, NULL);
-    if (ret != 0)
+    ev_tcp_write_req_t *w_req = EV_CONTAINER_OF(req, ev_tcp_write_req_t, base);
+
+    /*
+     * The send that finished this request is the last one, so the buffer can
+     * be given back once every send issued so far is completed.
+     */
+    if (size >= 0 && stream->zerocopy.cb != NULL &&
+        stream->zerocopy.seq_sent != stream->zerocopy.seq_done)
     {
-        ev_free(new_key);
-        return ev__translate_sys_error(ret);
+        w_req->backend.zc_seq = stream->zerocopy.seq_sent;
+        ev_list_push_back(&sock->backend.zc_queue, &w_req->base.node);
+        return;
     }
 
-    *key = new_key;
-    return 0;
+    _ev_tcp_w_user_callback_unix(sock, w_req, size);
 }
 
-void ev_thread_key_exit(ev_thread_key_t *key)
+static void _on_tcp_zerocopy_done(ev_nonblock_stream_t *stream,
+                                  uint32_t              seq_done)
 {
-    int ret = pthread_key_delete(key->tls);
-    if (ret != 0)
+    ev_tcp_t *sock = EV_CONTAINER_OF(stream, ev_tcp_t, backend.u.stream);
+
+    ev_list_node_t *it;
+    while ((it = ev_list_begin(&sock->backend.zc_queue)) != NULL)
     {
-        EV_ABORT();
+        ev_tcp_write_req_t *req =
+            EV_CONTAINER_OF(it, ev_tcp_write_req_t, base.node);
+        if ((int32_t)(req->backend.zc_seq - seq_done) > 0)
+        {
+            break;
+        }
+        ev_list_erase(&sock->backend.zc_queue, it);
+        _ev_tcp_w_user_callback_unix(sock, req, req->base.size);
     }
-    ev_free(key);
 }
 
-void ev_thread_key_set(ev_thread_key_t *key, void *val)
+static void _ev_tcp_cleanup_zerocopy(ev_tcp_t *sock)
 {
-    int ret = pthread_setspecific(key->tls, val);
-    if (ret != 0)
+    ev_list_node_t *it;
+    while ((it = ev_list_pop_front(&sock->backend.zc_queue)) != NULL)
     {
-        EV_ABORT();
+        ev_tcp_write_req_t *req =
+            EV_CONTAINER_OF(it, ev_tcp_write_req_t, base.node);
+        _ev_tcp_w_user_callback_unix(sock, req, EV_ECANCELED);
     }
 }
 
-void *ev_thread_key_get(ev_thread_key_t *key)
+static void _ev_tcp_flush_write_done(ev_tcp_t *sock)
 {
-    return pthread_getspecific(key->tls);
+    ev_list_node_t *it;
+    while ((it = ev_list_pop_front(&sock->backend.w_done)) != NULL)
+    {
+        ev_tcp_write_req_t *req =
+            EV_CONTAINER_OF(it, ev_tcp_write_req_t, base.node);
+        _ev_tcp_w_user_callback_unix(sock, req,
+                                     req->backend.stat != 0 ?
+                                         req->backend.stat :
+                                         (ssize_t)req->base.size);
+    }
 }
 
-// #line 83 "ev.c"
-////////////////////////////////////////////////////////////////////////////////
-// FILE:    ev/unix/threadpool_unix.c
-// SIZE:    942
-// SHA-256: 10487ad39897977af6e2f63e4ac09366f191adc87e314b98c5ef22b3b7567044
-////////////////////////////////////////////////////////////////////////////////
-// #line 1 "ev/unix/threadpool_unix.c"
-
-static void _on_work_unix(ev_nonblock_io_t* io, unsigned evts, void* arg)
+static void _ev_tcp_on_write_backlog(ev_handle_t *handle)
 {
-    (void)evts; (void)arg;
-
-    ev_loop_t* loop = EV_CONTAINER_OF(io, ev_loop_t, backend.threadpool.io);
-    ev__async_pend(loop->backend.threadpool.evtfd[0]);
-
-    ev__threadpool_process(loop);
+    ev_tcp_t *sock = EV_CONTAINER_OF(handle, ev_tcp_t, base);
+    _ev_tcp_flush_write_done(sock);
 }
 
-EV_LOCAL void ev__threadpool_wakeup(ev_loop_t* loop)
+static void _ev_tcp_on_close(ev_handle_t *handle)
 {
-    ev__async_post(loop->backend.threadpool.evtfd[1]);
-}
+    ev_tcp_t *sock = EV_CONTAINER_OF(handle, ev_tcp_t, base);
 
-EV_LOCAL void ev__init_work(ev_loop_t* loop)
-{
-    ev__asyc_eventfd(loop->backend.threadpool.evtfd);
+    if (sock->base.data.flags & EV_HANDLE_TCP_STREAMING)
+    {
+        _ev_tcp_flush_write_done(sock);
+        _ev_tcp_cleanup_zerocopy(sock);
+        ev__nonblock_stream_exit(&sock->backend.u.stream);
+        sock->base.data.flags &= ~EV_HANDLE_TCP_STREAMING;
+    }
 
-    ev__nonblock_io_init(&loop->backend.threadpool.io, loop->backend.threadpool.evtfd[0], _on_work_unix, NULL);
-    ev__nonblock_io_add(loop, &loop->backend.threadpool.io, EV_IO_IN);
-}
-
-EV_LOCAL void ev__exit_work(ev_loop_t* loop)
-{
-    ev__async_eventfd_close(loop->backend.threadpool.evtfd[0]);
-    loop->backend.threadpool.evtfd[0] = -1;
-
-    ev__async_eventfd_close(loop->backend.threadpool.evtfd[1]);
-    loop->backend.threadpool.evtfd[1] = -1;
-}
-
-// #line 84 "ev.c"
-////////////////////////////////////////////////////////////////////////////////
-// FILE:    ev/unix/time_unix.c
-// SIZE:    284
-// SHA-256: 29005a6567d68fb9b141f64f08c5fb3e9d407a6e7e0727d9a850028c69a7a79c
-////////////////////////////////////////////////////////////////////////////////
-// #line 1 "ev/unix/time_unix.c"
-#include <time.h>
-
-uint64_t ev_hrtime(void)
-{
-    int errcode;
-    struct timespec t;
+    if (sock->base.data.flags & EV_HANDLE_TCP_LISTING)
+    {
+        _ev_tcp_cleanup_listen_queue(sock, EV_ECANCELED);
+        sock->base.data.flags &= ~EV_HANDLE_TCP_LISTING;
+    }
 
-    if (clock_gettime(g_ev_loop_unix_ctx.hwtime_clock_id, &t) != 0)
+    if (sock->base.data.flags & EV_HANDLE_TCP_CONNECTING)
     {
-        errcode = errno;
-        EV_ABORT("errno:%d", errcode);
+        _ev_tcp_connect_callback_once(sock, EV_ECANCELED);
+        sock->base.data.flags &= ~EV_HANDLE_TCP_CONNECTING;
     }
 
-    return t.tv_sec * (uint64_t) 1e9 + t.tv_nsec;
-}
+    ev__tcp_pool_unlink(sock);
+    ev__tcp_recycle_exit(sock);
 
-// #line 85 "ev.c"
-////////////////////////////////////////////////////////////////////////////////
-// FILE:    ev/unix/udp_unix.c
-// SIZE:    25305
-// SHA-256: 298ea14cda1db0fb3a256067c1c5a2da2af0f08d6c49ae3f17087f23c9f4bbb4
-////////////////////////////////////////////////////////////////////////////////
-// #line 1 "ev/unix/udp_unix.c"
-#include <unistd.h>
-#include <string.h>
+    /* Caller owned memory may be released in close callback */
+    ev_loop_t *loop = sock->base.loop;
+    int        inplace = sock->base.data.flags & EV_HANDLE_INPLACE;
+    int        recycled = ev__tcp_recycle(sock);
+    if (sock->close_cb != NULL)
+    {
+        sock->close_cb(sock, sock->close_arg);
+    }
 
-static void _ev_udp_close_unix(ev_udp_t *udp)
-{
-    if (udp->sock != EV_OS_SOCKET_INVALID)
+    if (!recycled && !inplace)
     {
-        ev__nonblock_io_del(udp->base.loop, &udp->backend.io,
-                            EPOLLIN | EPOLLOUT);
-        close(udp->sock);
-        udp->sock = EV_OS_SOCKET_INVALID;
+        ev__loop_free(loop, sock);
     }
 }
 
-static void _ev_udp_smart_deactive(ev_udp_t *udp)
+/**
+ * @brief Try to finish \p req without waiting for the socket to be writable.
+ *
+ * A failed send finishes \p req as well, the error is passed to its callback
+ * just like a queued request.
+ *
+ * @return  #EV_SUCCESS if \p req is finished, #EV_EAGAIN if the remaining
+ *          data need to be queued, or #ev_errno_t if the stream does not
+ *          accept writes.
+ */
+static int _ev_tcp_write_optimistic(ev_tcp_t *sock, ev_tcp_write_req_t *req)
 {
-    size_t io_sz = 0;
+    ssize_t write_size = ev__nonblock_stream_try_write(
+        &sock->backend.u.stream, req->base.bufs, req->base.nbuf);
 
-    io_sz += ev_list_size(&udp->send_list);
-    io_sz += ev_list_size(&udp->recv_list);
+    /* Same as ev__nonblock_stream_write(), stream state is checked first */
+    if (write_size == EV_EAGAIN || write_size == EV_EBADF ||
+        write_size == EV_EBUSY)
+    {
+        return (int)write_size;
+    }
 
-    if (io_sz == 0)
+    if (write_size < 0)
     {
-        ev__handle_deactive(&udp->base);
+        req->backend.stat = (int)write_size;
+    }
+    else if (ev__finalize_send_req_unix(&req->base, (size_t)write_size) != 0)
+    {
+        return EV_EAGAIN;
     }
+
+    /* Callback must not be called inside ev_tcp_write() */
+    ev_list_push_back(&sock->backend.w_done, &req->base.node);
+    ev__backlog_submit(&sock->base, _ev_tcp_on_write_backlog);
+
+    return 0;
 }
 
-static void _ev_udp_w_user_callback_unix(ev_udp_t *udp, ev_udp_write_t *req,
-                                         ssize_t size)
+static void _on_tcp_read_done(ev_nonblock_stream_t *stream, ev_read_t *req,
+                              ssize_t size)
 {
-    _ev_udp_smart_deactive(udp);
-    ev__write_exit(&req->base);
-    ev__handle_exit(&req->handle, NULL);
+    ev_tcp_t *sock = EV_CONTAINER_OF(stream, ev_tcp_t, backend.u.stream);
 
-    req->usr_cb(udp, size, req->usr_cb_arg);
-    ev_free(req);
+    ev_tcp_read_req_t *r_req = EV_CONTAINER_OF(req, ev_tcp_read_req_t, base);
+    _ev_tcp_r_user_callback_unix(sock, r_req, size);
 }
 
-static void _ev_udp_r_user_callback_unix(ev_udp_t *udp, ev_udp_read_t *req,
-                                         const struct sockaddr *addr,
-                                         ssize_t                size)
+static void _ev_tcp_accept_user_callback_unix(ev_tcp_t *acpt, ev_tcp_t *conn,
+                                              int ret)
 {
-    _ev_udp_smart_deactive(udp);
-    ev__read_exit(&req->base);
-    ev__handle_exit(&req->handle, NULL);
+    conn->base.data.flags &= ~EV_HANDLE_TCP_ACCEPTING;
+    _ev_tcp_smart_deactive(conn);
+    _ev_tcp_smart_deactive(acpt);
 
-    req->usr_cb(udp, addr, size, req->usr_cb_arg);
-    ev_free(req);
+    ev_tcp_accept_cb bak_cb = conn->backend.u.accept.cb;
+    void            *cb_arg = conn->backend.u.accept.arg;
+    conn->backend.u.accept.cb = NULL;
+    conn->backend.u.accept.arg = NULL;
+    bak_cb(acpt, conn, ret, cb_arg);
 }
 
-static void _ev_udp_cancel_all_w_unix(ev_udp_t *udp, int err)
+/**
+ * @brief Accept a nonblocking, close-on-exec connection.
+ * @return  Socket, or #ev_errno_t.
+ */
+static int _ev_tcp_accept_fd(int lisn_fd)
 {
-    ev_list_node_t *it;
-    while ((it = ev_list_pop_front(&udp->send_list)) != NULL)
+    int fd;
+#if defined(SOCK_NONBLOCK) && defined(SOCK_CLOEXEC)
+    do
     {
-        ev_udp_write_t *req = EV_CONTAINER_OF(it, ev_udp_write_t, base.node);
-        _ev_udp_w_user_callback_unix(udp, req, err);
-    }
-}
+        fd = accept4(lisn_fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    } while (fd == -1 && errno == EINTR);
 
-static void _ev_udp_cancel_all_r_unix(ev_udp_t *udp, int err)
-{
-    ev_list_node_t *it;
-    while ((it = ev_list_pop_front(&udp->recv_list)) != NULL)
+    return fd >= 0 ? fd : ev__translate_sys_error(errno);
+#else
+    int ret;
+    do
     {
-        ev_udp_read_t *req = EV_CONTAINER_OF(it, ev_udp_read_t, base.node);
-        _ev_udp_r_user_callback_unix(udp, req, NULL, err);
-    }
-}
+        fd = accept(lisn_fd, NULL, NULL);
+    } while (fd == -1 && errno == EINTR);
 
-static void _ev_udp_abort_unix(ev_udp_t *udp, int err)
-{
-    _ev_udp_close_unix(udp);
-    _ev_udp_cancel_all_w_unix(udp, err);
-    _ev_udp_cancel_all_r_unix(udp, err);
+    if (fd < 0)
+    {
+        return ev__translate_sys_error(errno);
+    }
+    if ((ret = ev__nonblock(fd, 1)) != 0 || (ret = ev__cloexec(fd, 1)) != 0)
+    {
+        close(fd);
+        return ret;
+    }
+    return fd;
+#endif
 }
 
-static void _ev_udp_on_close_unix(ev_handle_t *handle)
+static void _ev_tcp_on_accept_queue(ev_tcp_t *acpt)
 {
-    ev_udp_t *udp = EV_CONTAINER_OF(handle, ev_udp_t, base);
-    ev_udp_cb close_cb = udp->close_cb;
-    void     *close_arg = udp->close_arg;
+    ev_list_node_t *it =
+        ev_list_pop_front(&acpt->backend.u.listen.accept_queue);
 
-    _ev_udp_abort_unix(udp, EV_ECANCELED);
-    ev_free(udp);
+    ev_tcp_t *conn =
+        EV_CONTAINER_OF(it, ev_tcp_t, backend.u.accept.accept_node);
+    _ev_tcp_close_fd(conn);
 
-    if (close_cb != NULL)
+    int ret = _ev_tcp_accept_fd(acpt->sock);
+    if (ret >= 0)
     {
-        close_cb(udp, close_arg);
+        conn->sock = ret;
+        ret = 0;
+        ev__tcp_opts_inherit(conn, acpt, 1);
     }
+
+    _ev_tcp_accept_user_callback_unix(acpt, conn, ret);
 }
 
 /**
- * @return bool
+ * @brief Keep a spare fd so connections can still be taken off the backlog
+ *   when the process runs out of fds.
  */
-static int _ev_udp_is_connected_unix(ev_os_socket_t sock)
+static void _ev_tcp_reserve_emfile_fd(ev_loop_t *loop)
 {
-    struct sockaddr_storage addr;
-    socklen_t               addrlen = sizeof(addr);
-
-    if (getpeername(sock, (struct sockaddr *)&addr, &addrlen) != 0)
+    if (loop->backend.emfile_fd == -1)
     {
-        return 0;
+        loop->backend.emfile_fd = open("/", O_RDONLY | O_CLOEXEC);
     }
-    return addrlen > 0;
 }
 
-static int _ev_udp_set_flags_unix(ev_udp_t *udp, unsigned flags)
+/**
+ * @brief Drop pending connections of \p lisn after accept failed with
+ *   EMFILE or ENFILE.
+ *
+ * The listen socket is level triggered, the backlog would wake us up again
+ * and again with the same error. Release the spare fd, then accept and close
+ * connections until the backlog is empty.
+ */
+static void _ev_tcp_drop_backlog(ev_tcp_t *lisn)
 {
-    int err;
-    if (flags & EV_UDP_IPV6_ONLY)
+    ev_loop_t *loop = lisn->base.loop;
+    if (loop->backend.emfile_fd == -1)
     {
-        int yes = 1;
-        if (setsockopt(udp->sock, IPPROTO_IPV6, IPV6_V6ONLY, &yes,
-                       sizeof(yes)) == -1)
-        {
-            err = errno;
-            return ev__translate_sys_error(err);
-        }
+        return;
     }
 
-    if (flags & EV_UDP_REUSEADDR)
+    close(loop->backend.emfile_fd);
+    loop->backend.emfile_fd = -1;
+
+    int fd;
+    while ((fd = _ev_tcp_accept_fd(lisn->sock)) >= 0 ||
+           fd == EV_ECONNABORTED)
     {
-        if ((err = ev__reuse_unix(udp->sock)) != 0)
+        if (fd >= 0)
         {
-            return err;
+            close(fd);
         }
     }
 
-    return 0;
+    _ev_tcp_reserve_emfile_fd(loop);
 }
 
-static int _ev_udp_disconnect_unix(ev_udp_t *udp)
+/**
+ * @brief Accept connections until there is none left or budget is used up.
+ */
+static void _ev_tcp_on_accept_drain(ev_tcp_t *lisn)
 {
-    struct sockaddr addr;
-    memset(&addr, 0, sizeof(addr));
-    addr.sa_family = AF_UNSPEC;
-
-    int r;
-    do
+    size_t i;
+    for (i = 0; i < lisn->backend.u.listen.budget; i++)
     {
-        r = connect(udp->sock, &addr, sizeof(addr));
-    } while (r == -1 && errno == EINTR);
+        ev_tcp_t *conn = NULL;
+        int       ret = _ev_tcp_accept_fd(lisn->sock);
+        if (ret == EV_EAGAIN)
+        {
+            return;
+        }
+        if (ret == EV_ECONNABORTED)
+        { /* Peer is gone before we accept it, nothing to report. */
+            continue;
+        }
 
-    if (r == -1 && errno != EAFNOSUPPORT)
-    {
-        r = errno;
-        return ev__translate_sys_error(r);
-    }
+        if (ret >= 0)
+        {
+            int fd = ret;
+            if ((ret = ev_tcp_init_accept(lisn, &conn)) == 0)
+            {
+                conn->sock = fd;
+                ev__tcp_opts_inherit(conn, lisn, 1);
+            }
+            else
+            {
+                close(fd);
+            }
+        }
 
-    udp->base.data.flags &= ~EV_HANDLE_UDP_CONNECTED;
-    return 0;
+        lisn->backend.u.listen.on_conn(lisn, conn, ret,
+                                       lisn->backend.u.listen.on_conn_arg);
+        if (ev__handle_is_closing(&lisn->base))
+        {
+            return;
+        }
+        if (ret == EV_EMFILE || ret == EV_ENFILE)
+        {
+            _ev_tcp_drop_backlog(lisn);
+        }
+
+        /* Other errors are reported again next round. */
+        if (ret != 0 || lisn->backend.u.listen.on_conn == NULL)
+        {
+            return;
+        }
+    }
 }
 
-static ssize_t _ev_udp_sendmsg_unix(int fd, struct iovec *iov, int iovcnt,
-                                    void *arg)
+static void _ev_tcp_on_accept(ev_tcp_t *acpt)
 {
-    struct msghdr *p_hdr = arg;
-    p_hdr->msg_iov = iov;
-    p_hdr->msg_iovlen = iovcnt;
-
-    ssize_t write_size;
-    do
+    if (ev_list_size(&acpt->backend.u.listen.accept_queue) != 0)
     {
-        write_size = sendmsg(fd, p_hdr, 0);
-    } while (write_size < 0 && errno == EINTR);
-
-    if (write_size < 0)
+        _ev_tcp_on_accept_queue(acpt);
+    }
+    else if (acpt->backend.u.listen.on_conn != NULL)
     {
-        int err = errno;
-        return ev__translate_sys_error(err);
+        _ev_tcp_on_accept_drain(acpt);
     }
 
-    return write_size;
-}
-
-static int _ev_udp_do_sendmsg_unix(ev_udp_t *udp, ev_udp_write_t *req)
-{
-    struct msghdr hdr;
-    memset(&hdr, 0, sizeof(hdr));
-
-    if (req->backend.peer_addr.ss_family == AF_UNSPEC)
+    /* might be close in callback */
+    if (ev__handle_is_closing(&acpt->base))
     {
-        hdr.msg_name = NULL;
-        hdr.msg_namelen = 0;
+        return;
     }
-    else
+    if (ev_list_size(&acpt->backend.u.listen.accept_queue) == 0 &&
+        acpt->backend.u.listen.on_conn == NULL)
     {
-        hdr.msg_name = &req->backend.peer_addr;
-        hdr.msg_namelen =
-            ev__get_addr_len((struct sockaddr *)&req->backend.peer_addr);
+        ev__nonblock_io_del(acpt->base.loop, &acpt->backend.u.listen.io,
+                            EV_IO_IN);
     }
-
-    return ev__send_unix(udp->sock, &req->base, _ev_udp_sendmsg_unix, &hdr);
 }
 
-static int _ev_udp_on_io_write_unix(ev_udp_t *udp)
+static void _ev_tcp_on_server_event(ev_nonblock_io_t *io, unsigned evts,
+                                    void *arg)
 {
-    int             ret = 0;
-    ev_list_node_t *it;
-    while ((it = ev_list_begin(&udp->send_list)) != NULL)
-    {
-        ev_udp_write_t *req = EV_CONTAINER_OF(it, ev_udp_write_t, base.node);
-
-        if ((ret = _ev_udp_do_sendmsg_unix(udp, req)) != 0)
-        {
-            break;
-        }
-
-        ev_list_erase(&udp->send_list, it);
-        _ev_udp_w_user_callback_unix(udp, req, req->base.size);
-    }
+    (void)evts;
+    (void)arg;
+    ev_tcp_t *sock = EV_CONTAINER_OF(io, ev_tcp_t, backend.u.listen.io);
 
-    if (ret == EV_EAGAIN)
-    {
-        ret = 0;
-    }
-    return ret;
+    _ev_tcp_on_accept(sock);
 }
 
-static int _ev_udp_do_recvmsg_unix(ev_udp_t *udp, ev_udp_read_t *req)
+static void _ev_tcp_on_client_event(ev_nonblock_io_t *io, unsigned evts,
+                                    void *arg)
 {
-    struct msghdr hdr;
-    memset(&hdr, 0, sizeof(hdr));
-    memset(&req->addr, 0, sizeof(req->addr));
+    (void)evts;
+    (void)arg;
+    ev_tcp_t *sock = EV_CONTAINER_OF(io, ev_tcp_t, backend.u.client.io);
 
-    hdr.msg_name = &req->addr;
-    hdr.msg_namelen = sizeof(req->addr);
-    hdr.msg_iov = (struct iovec *)req->base.data.bufs;
-    hdr.msg_iovlen = req->base.data.nbuf;
+    _ev_tcp_on_connect(sock);
+}
 
-    ssize_t read_size;
-    do
+/**
+ * @return #ev_errno_t
+ */
+static int _ev_tcp_setup_fd(ev_tcp_t *sock, int domain, int is_server,
+                            int *new_fd)
+{
+    int ret = 0;
+    int tmp_new_fd = 0;
+    if (sock->sock != EV_OS_SOCKET_INVALID)
     {
-        read_size = recvmsg(udp->sock, &hdr, 0);
-    } while (read_size < 0 && errno == EINTR);
+        goto fin;
+    }
 
-    if (read_size < 0)
+    if ((sock->sock = socket(domain, SOCK_STREAM, 0)) == EV_OS_SOCKET_INVALID)
     {
-        int err = errno;
-        if (err == EAGAIN || err == EWOULDBLOCK)
-        {
-            return EV_EAGAIN;
-        }
-        return ev__translate_sys_error(err);
+        ret = ev__translate_sys_error(errno);
+        goto fin;
     }
 
-    req->base.data.size += read_size;
-    return 0;
-}
-
-static int _ev_udp_on_io_read_unix(ev_udp_t *udp)
-{
-    int             ret = 0;
-    ev_list_node_t *it;
-    while ((it = ev_list_begin(&udp->recv_list)) != NULL)
+    if ((ret = ev__nonblock(sock->sock, 1)) != 0)
     {
-        ev_udp_read_t *req = EV_CONTAINER_OF(it, ev_udp_read_t, base.node);
-
-        if ((ret = _ev_udp_do_recvmsg_unix(udp, req)) != 0)
-        {
-            break;
-        }
+        goto err_nonblock;
+    }
+    if ((ret = ev__tcp_opts_apply(sock, 0)) != 0)
+    {
+        goto err_nonblock;
+    }
 
-        ev_list_erase(&udp->recv_list, it);
-        _ev_udp_r_user_callback_unix(udp, req, (struct sockaddr *)&req->addr,
-                                     req->base.data.size);
+    tmp_new_fd = 1;
+    if (is_server)
+    {
+        ev__nonblock_io_init(&sock->backend.u.listen.io, sock->sock,
+                             _ev_tcp_on_server_event, NULL);
+    }
+    else
+    {
+        ev__nonblock_io_init(&sock->backend.u.client.io, sock->sock,
+                             _ev_tcp_on_client_event, NULL);
     }
 
-    if (ret == EV_EAGAIN)
+    goto fin;
+
+err_nonblock:
+    _ev_tcp_close_fd(sock);
+fin:
+    if (new_fd != NULL)
     {
-        ret = 0;
+        *new_fd = tmp_new_fd;
     }
     return ret;
 }
 
-static void _ev_udp_on_io_unix(ev_nonblock_io_t *io, unsigned evts, void *arg)
+static int _ev_tcp_is_listening(ev_tcp_t *sock)
 {
-    (void)arg;
-    int       ret;
-    ev_udp_t *udp = EV_CONTAINER_OF(io, ev_udp_t, backend.io);
+    return sock->base.data.flags & EV_HANDLE_TCP_LISTING;
+}
 
-    if (evts & EPOLLOUT)
-    {
-        if ((ret = _ev_udp_on_io_write_unix(udp)) != 0)
-        {
-            goto err;
-        }
+static void _ev_tcp_to_connect(ev_handle_t *handle)
+{
+    ev_tcp_t *sock = EV_CONTAINER_OF(handle, ev_tcp_t, base);
 
-        if (ev_list_size(&udp->send_list) == 0)
-        {
-            ev__nonblock_io_del(udp->base.loop, &udp->backend.io, EPOLLOUT);
-        }
-    }
+    sock->base.data.flags &= ~EV_HANDLE_TCP_CONNECTING;
+    _ev_tcp_connect_callback_once(sock, 0);
+}
 
-    if (evts & EPOLLIN)
-    {
-        if ((ret = _ev_udp_on_io_read_unix(udp)) != 0)
-        {
-            goto err;
-        }
+static void _on_tcp_watermark(ev_nonblock_stream_t *stream, int high)
+{
+    ev_tcp_t *sock = EV_CONTAINER_OF(stream, ev_tcp_t, backend.u.stream);
+    sock->backend.watermark.cb(sock, high, sock->backend.watermark.arg);
+}
 
-        if (ev_list_size(&udp->recv_list) == 0)
-        {
-            ev__nonblock_io_del(udp->base.loop, &udp->backend.io, EPOLLIN);
-        }
+static void _ev_tcp_setup_watermark(ev_tcp_t *sock)
+{
+    ev__nonblock_stream_watermark(
+        &sock->backend.u.stream, sock->backend.watermark.low,
+        sock->backend.watermark.high,
+        sock->backend.watermark.cb != NULL ? _on_tcp_watermark : NULL);
+}
+
+static void _ev_tcp_setup_stream_once(ev_tcp_t *sock)
+{
+    if (sock->base.data.flags & EV_HANDLE_TCP_STREAMING)
+    {
+        return;
     }
+    ev__nonblock_stream_init(sock->base.loop, &sock->backend.u.stream,
+                             sock->sock, _on_tcp_write_done, _on_tcp_read_done);
+    sock->base.data.flags |= EV_HANDLE_TCP_STREAMING;
+    _ev_tcp_setup_watermark(sock);
+}
 
-    return;
+EV_LOCAL void ev__tcp_init(ev_loop_t *loop, ev_tcp_t *sock)
+{
+    ev__handle_init(loop, &sock->base, EV_ROLE_EV_TCP);
+    sock->close_cb = NULL;
+    sock->close_arg = NULL;
+    sock->sock = EV_OS_SOCKET_INVALID;
+    ev_list_init(&sock->backend.w_done);
+    ev_list_init(&sock->backend.zc_queue);
+    memset(&sock->backend.watermark, 0, sizeof(sock->backend.watermark));
+    ev__tcp_opts_init(sock);
+    ev__tcp_recycle_init(sock);
+    ev__tcp_pool_link_init(sock);
+}
 
-err:
-    _ev_udp_abort_unix(udp, ret);
+size_t ev_tcp_size(void)
+{
+    return sizeof(ev_tcp_t);
 }
 
-static int _ev_udp_maybe_deferred_socket_unix(ev_udp_t *udp, int domain)
+int ev_tcp_init(ev_loop_t *loop, ev_tcp_t **sock)
 {
-    if (udp->sock != EV_OS_SOCKET_INVALID)
+    ev_tcp_t *new_sock =
+        ev__loop_malloc(loop, EV_ALLOCATOR_TYPE_TCP, sizeof(ev_tcp_t));
+    if (new_sock == NULL)
     {
-        return 0;
+        return EV_ENOMEM;
     }
 
-    if ((udp->sock = socket(domain, SOCK_DGRAM, 0)) < 0)
-    {
-        int ret = errno;
-        return ev__translate_sys_error(ret);
-    }
+    ev__tcp_init(loop, new_sock);
 
-    ev__nonblock_io_init(&udp->backend.io, udp->sock, _ev_udp_on_io_unix, NULL);
+    *sock = new_sock;
+    return 0;
+}
+
+int ev_tcp_init_inplace(ev_loop_t *loop, ev_tcp_t **sock, void *mem)
+{
+    ev_tcp_t *new_sock = mem;
+
+    ev__tcp_init(loop, new_sock);
+    new_sock->base.data.flags |= EV_HANDLE_INPLACE;
 
+    *sock = new_sock;
     return 0;
 }
 
-static int _ev_udp_do_connect_unix(ev_udp_t *udp, const struct sockaddr *addr)
+void ev_tcp_exit(ev_tcp_t *sock, ev_tcp_close_cb cb, void *arg)
 {
-    int       ret;
-    socklen_t addrlen = ev__get_addr_len(addr);
-    if (addrlen == (socklen_t)-1)
+    /* Stop all pending IO actions */
+    if (sock->base.data.flags & EV_HANDLE_TCP_STREAMING)
     {
-        return EV_EINVAL;
+        ev__nonblock_stream_abort(&sock->backend.u.stream);
     }
-
-    if ((ret = _ev_udp_maybe_deferred_socket_unix(udp, addr->sa_family)) != 0)
+    if (sock->base.data.flags & EV_HANDLE_TCP_LISTING)
     {
-        return ret;
+        ev__nonblock_io_del(sock->base.loop, &sock->backend.u.listen.io,
+                            EV_IO_IN);
     }
-
-    do
-    {
-        ret = connect(udp->sock, addr, addrlen);
-    } while (ret == -1 && errno == EINTR);
-
-    if (ret != 0)
+    if (sock->base.data.flags & EV_HANDLE_TCP_CONNECTING)
     {
-        ret = errno;
-        return ev__translate_sys_error(ret);
+        ev__nonblock_io_del(sock->base.loop, &sock->backend.u.client.io,
+                            EV_IO_OUT);
     }
 
-    udp->base.data.flags |= EV_HANDLE_UDP_CONNECTED;
-    return 0;
+    /* Close fd */
+    _ev_tcp_close_fd(sock);
+
+    sock->close_cb = cb;
+    sock->close_arg = arg;
+    ev__handle_exit(&sock->base, _ev_tcp_on_close);
 }
 
-static int _ev_udp_maybe_deferred_bind_unix(ev_udp_t *udp, int domain,
-                                            int flags)
+int ev_tcp_bind(ev_tcp_t *tcp, const struct sockaddr *addr, size_t addrlen)
 {
-    int ret = _ev_udp_maybe_deferred_socket_unix(udp, domain);
-    if (ret != 0)
+    int ret;
+    int flag_new_fd;
+    if ((ret = _ev_tcp_setup_fd(tcp, addr->sa_family, 1, &flag_new_fd)) != 0)
     {
         return ret;
     }
 
-    if (udp->base.data.flags & EV_HANDLE_UDP_BOUND)
+    if ((ret = bind(tcp->sock, addr, addrlen)) != 0)
     {
-        return 0;
+        ret = ev__translate_sys_error(errno);
+        goto err_bind;
     }
+    tcp->base.data.flags |= EV_HABDLE_TCP_BOUND;
 
-    struct sockaddr_storage addr;
-    struct sockaddr_in     *addr4 = (struct sockaddr_in *)&addr;
-    struct sockaddr_in6    *addr6 = (struct sockaddr_in6 *)&addr;
+    return 0;
 
-    switch (domain)
+err_bind:
+    if (flag_new_fd)
     {
-    case AF_INET: {
-        memset(addr4, 0, sizeof(*addr4));
-        addr4->sin_family = AF_INET;
-        addr4->sin_addr.s_addr = INADDR_ANY;
-        return ev_udp_bind(udp, (struct sockaddr *)addr4, flags);
+        _ev_tcp_close_fd(tcp);
     }
+    return ret;
+}
 
-    case AF_INET6: {
-        memset(addr6, 0, sizeof(*addr6));
-        addr6->sin6_family = AF_INET6;
-        addr6->sin6_addr = in6addr_any;
-        return ev_udp_bind(udp, (struct sockaddr *)addr6, flags);
+int ev_tcp_listen(ev_tcp_t *tcp, int backlog)
+{
+    if (_ev_tcp_is_listening(tcp))
+    {
+        return EV_EADDRINUSE;
     }
 
-    default:
-        break;
+    int ret;
+    if ((ret = ev__tcp_opts_apply(tcp, 1)) != 0)
+    {
+        return ret;
+    }
+    if ((ret = listen(tcp->sock, backlog)) != 0)
+    {
+        return ev__translate_sys_error(errno);
     }
 
-    EV_ABORT();
-}
+    ev_list_init(&tcp->backend.u.listen.accept_queue);
+    tcp->backend.u.listen.on_conn = NULL;
+    tcp->backend.u.listen.on_conn_arg = NULL;
+    tcp->backend.u.listen.budget = 0;
+    tcp->base.data.flags |= EV_HANDLE_TCP_LISTING;
+    _ev_tcp_reserve_emfile_fd(tcp->base.loop);
 
-static int _ev_udp_convert_interface_addr4_unix(
-    struct ip_mreq *dst, const struct sockaddr_in *multicast_addr,
-    const char *interface_addr)
-{
-    int ret;
-    memset(dst, 0, sizeof(*dst));
+    return 0;
+}
 
-    if (interface_addr != NULL)
+int ev_tcp_accept(ev_tcp_t *lisn, ev_tcp_t *conn, ev_tcp_accept_cb cb,
+                  void *arg)
+{
+    if (lisn == NULL || conn == NULL || cb == NULL)
     {
-        if ((ret = inet_pton(AF_INET, interface_addr,
-                             &dst->imr_interface.s_addr)) != 1)
-        {
-            int ret = errno;
-            return ev__translate_sys_error(ret);
-        }
+        return EV_EINVAL;
     }
-    else
+    if (conn->base.data.flags & EV_HANDLE_TCP_ACCEPTING)
     {
-        dst->imr_interface.s_addr = htonl(INADDR_ANY);
+        return EV_EINPROGRESS;
     }
 
-    dst->imr_multiaddr.s_addr = multicast_addr->sin_addr.s_addr;
+    conn->base.data.flags |= EV_HANDLE_TCP_ACCEPTING;
+    conn->backend.u.accept.cb = cb;
+    conn->backend.u.accept.arg = arg;
+    ev_list_push_back(&lisn->backend.u.listen.accept_queue,
+                      &conn->backend.u.accept.accept_node);
+    ev__nonblock_io_add(lisn->base.loop, &lisn->backend.u.listen.io, EV_IO_IN);
+
+    ev__handle_active(&lisn->base);
+    ev__handle_active(&conn->base);
 
     return 0;
 }
 
-static int _ev_udp_setmembership4_unix(ev_udp_t           *udp,
-                                       struct sockaddr_in *multicast_addr,
-                                       const char         *interface_addr,
-                                       ev_udp_membership_t membership)
+int ev_tcp_accept_start(ev_tcp_t *lisn, size_t budget, ev_tcp_accept_cb cb,
+                        void *arg)
 {
-    int ret;
+    if (cb == NULL || !_ev_tcp_is_listening(lisn))
+    {
+        return EV_EINVAL;
+    }
+    if (lisn->backend.u.listen.on_conn != NULL)
+    {
+        return EV_EALREADY;
+    }
 
-    struct ip_mreq mreq;
-    if ((ret = _ev_udp_convert_interface_addr4_unix(&mreq, multicast_addr,
-                                                    interface_addr)) != 0)
+    lisn->backend.u.listen.on_conn = cb;
+    lisn->backend.u.listen.on_conn_arg = arg;
+    lisn->backend.u.listen.budget = budget != 0 ? budget : EV_TCP_ACCEPT_BUDGET;
+    ev__nonblock_io_add(lisn->base.loop, &lisn->backend.u.listen.io, EV_IO_IN);
+    ev__handle_active(&lisn->base);
+
+    return 0;
+}
+
+int ev_tcp_accept_stop(ev_tcp_t *lisn)
+{
+    if (!_ev_tcp_is_listening(lisn))
     {
-        return ret;
+        return EV_EINVAL;
     }
 
-    int optname = membership == EV_UDP_ENTER_GROUP ? IP_ADD_MEMBERSHIP
-                                                   : IP_DROP_MEMBERSHIP;
-    if (setsockopt(udp->sock, IPPROTO_IP, optname, &mreq, sizeof(mreq)) != 0)
+    lisn->backend.u.listen.on_conn = NULL;
+    lisn->backend.u.listen.on_conn_arg = NULL;
+    if (ev_list_size(&lisn->backend.u.listen.accept_queue) == 0)
     {
-        ret = errno;
-        return ev__translate_sys_error(ret);
+        ev__nonblock_io_del(lisn->base.loop, &lisn->backend.u.listen.io,
+                            EV_IO_IN);
     }
+    _ev_tcp_smart_deactive(lisn);
 
     return 0;
 }
 
-static void _ev_udp_convert_interface_addr6_unix(
-    struct ipv6_mreq *dst, struct sockaddr_in6 *multicast_addr,
-    const char *interface_addr)
+int ev_tcp_write(ev_tcp_t *sock, ev_buf_t *bufs, size_t nbuf,
+                 ev_tcp_write_cb cb, void *arg)
 {
-    memset(dst, 0, sizeof(*dst));
-
-    if (interface_addr != 0)
+    if (sock->base.data.flags &
+        (EV_HANDLE_TCP_LISTING | EV_HANDLE_TCP_ACCEPTING |
+         EV_HANDLE_TCP_CONNECTING))
     {
-        struct sockaddr_in6 addr6;
-        ev_ipv6_addr(interface_addr, 0, &addr6);
+        return EV_EINVAL;
+    }
 
-        dst->ipv6mr_interface = addr6.sin6_scope_id;
+    ev_tcp_write_req_t *req = ev__loop_malloc(
+        sock->base.loop, EV_ALLOCATOR_TYPE_TCP, sizeof(ev_tcp_write_req_t));
+    if (req == NULL)
+    {
+        return EV_ENOMEM;
     }
-    else
+
+    req->write_cb = cb;
+    req->write_arg = arg;
+    req->backend.stat = 0;
+    int ret = ev__write_init(&req->base, bufs, nbuf);
+    if (ret != 0)
     {
-        dst->ipv6mr_interface = 0;
+        ev__loop_free(sock->base.loop, req);
+        return ret;
     }
-    dst->ipv6mr_multiaddr = multicast_addr->sin6_addr;
-}
 
-static int _ev_udp_setmembership6_unix(ev_udp_t            *udp,
-                                       struct sockaddr_in6 *multicast_addr,
-                                       const char          *interface_addr,
-                                       ev_udp_membership_t  membership)
-{
-    int              ret;
-    struct ipv6_mreq mreq;
-    _ev_udp_convert_interface_addr6_unix(&mreq, multicast_addr, interface_addr);
+    _ev_tcp_setup_stream_once(sock);
 
-    int optname = membership == EV_UDP_ENTER_GROUP ? IPV6_ADD_MEMBERSHIP
-                                                   : IPV6_DROP_MEMBERSHIP;
-    if (setsockopt(udp->sock, IPPROTO_IPV6, optname, &mreq, sizeof(mreq)) != 0)
+    ev__handle_active(&sock->base);
+    /* Zerocopy sends need the write queue to track completions */
+    if (sock->backend.u.stream.zerocopy.cb != NULL ||
+        (ret = _ev_tcp_write_optimistic(sock, req)) == EV_EAGAIN)
     {
-        ret = errno;
-        return ev__translate_sys_error(ret);
+        ret = ev__nonblock_stream_write(&sock->backend.u.stream, &req->base);
     }
 
+    if (ret != 0)
+    {
+        _ev_tcp_smart_deactive(sock);
+        ev__loop_free(sock->base.loop, req);
+        return ret;
+    }
     return 0;
 }
 
-static int _ev_udp_convert_source_interface_addr4_unix(
-    struct ip_mreq_source *dst, const char *interface_addr,
-    const struct sockaddr_in *multicast_addr,
-    const struct sockaddr_in *source_addr)
+int ev_tcp_sendfile(ev_tcp_t *sock, ev_file_t *file, int64_t offset,
+                    size_t len, ev_tcp_write_cb cb, void *arg)
 {
     int ret;
-    memset(dst, 0, sizeof(*dst));
-
-    if (interface_addr != NULL)
+    if (sock->base.data.flags &
+        (EV_HANDLE_TCP_LISTING | EV_HANDLE_TCP_ACCEPTING |
+         EV_HANDLE_TCP_CONNECTING))
     {
-        if ((ret = inet_pton(AF_INET, interface_addr,
-                             &dst->imr_interface.s_addr)) != 1)
-        {
-            ret = errno;
-            return ev__translate_sys_error(ret);
-        }
+        return EV_EINVAL;
     }
-    else
+    if (offset < 0)
     {
-        dst->imr_interface.s_addr = htonl(INADDR_ANY);
+        return EV_EINVAL;
+    }
+    if (sock->sock == EV_OS_SOCKET_INVALID)
+    {
+        return EV_ENOTCONN;
     }
 
-    dst->imr_multiaddr.s_addr = multicast_addr->sin_addr.s_addr;
-    dst->imr_sourceaddr.s_addr = source_addr->sin_addr.s_addr;
+    ev_tcp_sendfile_req_t *req = ev__loop_malloc(
+        sock->base.loop, EV_ALLOCATOR_TYPE_TCP, sizeof(ev_tcp_sendfile_req_t));
+    if (req == NULL)
+    {
+        return EV_ENOMEM;
+    }
+    req->write_cb = cb;
+    req->write_arg = arg;
+    ev__nonblock_stream_file_init(&req->base, file->file, offset, len);
 
-    return 0;
-}
+    _ev_tcp_setup_stream_once(sock);
 
-static int _ev_udp_set_source_membership4_unix(
-    ev_udp_t *udp, const struct sockaddr_in *multicast_addr,
-    const char *interface_addr, const struct sockaddr_in *source_addr,
-    ev_udp_membership_t membership)
-{
-    int ret = _ev_udp_maybe_deferred_bind_unix(udp, AF_INET, EV_UDP_REUSEADDR);
+    ev__handle_active(&sock->base);
+    ret = ev__nonblock_stream_write(&sock->backend.u.stream, &req->base.base);
     if (ret != 0)
     {
+        _ev_tcp_smart_deactive(sock);
+        ev__loop_free(sock->base.loop, req);
         return ret;
     }
+    return 0;
+}
 
-    struct ip_mreq_source mreq;
-    if ((ret = _ev_udp_convert_source_interface_addr4_unix(
-             &mreq, interface_addr, multicast_addr, source_addr)) != 0)
+ssize_t ev_tcp_try_write(ev_tcp_t *sock, ev_buf_t *bufs, size_t nbuf)
+{
+    if (sock->base.data.flags &
+        (EV_HANDLE_TCP_LISTING | EV_HANDLE_TCP_ACCEPTING |
+         EV_HANDLE_TCP_CONNECTING))
     {
-        return ret;
+        return EV_EINVAL;
     }
-
-    int optname = membership == EV_UDP_ENTER_GROUP ? IP_ADD_SOURCE_MEMBERSHIP
-                                                   : IP_DROP_SOURCE_MEMBERSHIP;
-    if (setsockopt(udp->sock, IPPROTO_IP, optname, &mreq, sizeof(mreq)) != 0)
+    if (sock->sock == EV_OS_SOCKET_INVALID)
     {
-        ret = errno;
-        return ev__translate_sys_error(ret);
+        return EV_EBADF;
     }
 
-    return 0;
+    _ev_tcp_setup_stream_once(sock);
+    return ev__nonblock_stream_try_write(&sock->backend.u.stream, bufs, nbuf);
 }
 
-static int _ev_udp_convert_source_interface_addr6_unix(
-    struct group_source_req *dst, const char *interface_addr,
-    const struct sockaddr_in6 *multicast_addr,
-    const struct sockaddr_in6 *source_addr)
+static int _ev_tcp_pipe_endpoint(ev_role_t role, void *addr,
+                                 ev_handle_t         **handle,
+                                 ev_nonblock_stream_t **stream)
 {
-    int                 ret;
-    struct sockaddr_in6 addr_6;
-
-    memset(dst, 0, sizeof(*dst));
-
-    if (interface_addr != NULL)
+    if (role == EV_ROLE_EV_TCP)
     {
-        if ((ret = ev_ipv6_addr(interface_addr, 0, &addr_6)) != 0)
+        ev_tcp_t *sock = addr;
+        if (sock->base.data.flags &
+            (EV_HANDLE_TCP_LISTING | EV_HANDLE_TCP_ACCEPTING |
+             EV_HANDLE_TCP_CONNECTING))
         {
-            return ret;
+            return EV_EINVAL;
         }
-        dst->gsr_interface = addr_6.sin6_scope_id;
+        if (sock->sock == EV_OS_SOCKET_INVALID)
+        {
+            return EV_EBADF;
+        }
+
+        _ev_tcp_setup_stream_once(sock);
+        *handle = &sock->base;
+        *stream = &sock->backend.u.stream;
+        return 0;
+    }
+
+    if (role == EV_ROLE_EV_PIPE)
+    {
+        ev_pipe_t *pipe = addr;
+        *handle = &pipe->base;
+        return ev__pipe_data_stream_unix(pipe, stream);
+    }
+
+    return EV_EINVAL;
+}
+
+static void _ev_tcp_pipe_smart_deactive(ev_role_t role, void *addr)
+{
+    if (role == EV_ROLE_EV_TCP)
+    {
+        _ev_tcp_smart_deactive(addr);
     }
     else
     {
-        dst->gsr_interface = 0;
+        ev__pipe_smart_deactive_unix(addr);
     }
+}
 
-    memcpy(&dst->gsr_group, multicast_addr, sizeof(*multicast_addr));
-    memcpy(&dst->gsr_source, source_addr, sizeof(*source_addr));
+static void _ev_tcp_on_pipe_done(ev_nonblock_splice_t *splice, int stat)
+{
+    ev_tcp_pipe_req_t *req = EV_CONTAINER_OF(splice, ev_tcp_pipe_req_t, base);
+    ev_tcp_pipe_cb     cb = req->cb;
+    void              *arg = req->arg;
+    void              *src = req->src;
+    void              *dst = req->dst;
+    uint64_t           size = req->base.size;
 
-    return 0;
+    _ev_tcp_pipe_smart_deactive(req->src_role, src);
+    _ev_tcp_pipe_smart_deactive(req->dst_role, dst);
+    ev__loop_free(req->loop, req);
+
+    if (cb != NULL)
+    {
+        cb(src, dst, size, stat, arg);
+    }
 }
 
-static int _ev_udp_set_source_membership6_unix(
-    ev_udp_t *udp, const struct sockaddr_in6 *multicast_addr,
-    const char *interface_addr, const struct sockaddr_in6 *source_addr,
-    ev_udp_membership_t membership)
+int ev_tcp_pipe_to_ex(ev_role_t src_role, void *src, ev_role_t dst_role,
+                      void *dst, const ev_tcp_pipe_opts_t *opts)
 {
-    int ret = _ev_udp_maybe_deferred_bind_unix(udp, AF_INET6, EV_UDP_REUSEADDR);
-    if (ret != 0)
+    int                   ret;
+    ev_handle_t          *src_handle, *dst_handle;
+    ev_nonblock_stream_t *src_stream, *dst_stream;
+
+    if ((ret = _ev_tcp_pipe_endpoint(src_role, src, &src_handle,
+                                     &src_stream)) != 0 ||
+        (ret = _ev_tcp_pipe_endpoint(dst_role, dst, &dst_handle,
+                                     &dst_stream)) != 0)
     {
         return ret;
     }
+    if (src_handle->loop != dst_handle->loop)
+    {
+        return EV_EINVAL;
+    }
 
-    struct group_source_req mreq;
-    if ((ret = _ev_udp_convert_source_interface_addr6_unix(
-             &mreq, interface_addr, multicast_addr, source_addr)) != 0)
+    ev_loop_t         *loop = src_handle->loop;
+    ev_tcp_pipe_req_t *req =
+        ev__loop_malloc(loop, EV_ALLOCATOR_TYPE_TCP, sizeof(ev_tcp_pipe_req_t));
+    if (req == NULL)
     {
-        return ret;
+        return EV_ENOMEM;
     }
 
-    int optname = membership == EV_UDP_ENTER_GROUP ? MCAST_JOIN_SOURCE_GROUP
-                                                   : MCAST_LEAVE_SOURCE_GROUP;
-    if (setsockopt(udp->sock, IPPROTO_IPV6, optname, &mreq, sizeof(mreq)) != 0)
+    req->loop = loop;
+    req->src_role = src_role;
+    req->src = src;
+    req->dst_role = dst_role;
+    req->dst = dst;
+    req->cb = opts != NULL ? opts->cb : NULL;
+    req->arg = opts != NULL ? opts->arg : NULL;
+
+    ret = ev__nonblock_stream_splice(&req->base, src_stream, dst_stream,
+                                     opts != NULL ? opts->capacity : 0,
+                                     _ev_tcp_on_pipe_done);
+    if (ret != 0)
     {
-        ret = errno;
-        return ev__translate_sys_error(ret);
+        ev__loop_free(loop, req);
+        return ret;
     }
 
+    ev__handle_active(src_handle);
+    ev__handle_active(dst_handle);
     return 0;
 }
 
-static int _ev_udp_set_ttl_unix(ev_udp_t *udp, int ttl, int option4,
-                                int option6)
+int ev_tcp_pipe_to(ev_tcp_t *src, ev_tcp_t *dst,
+                   const ev_tcp_pipe_opts_t *opts)
 {
-    int level;
-    int option;
-    if (udp->base.data.flags & EV_HANDLE_UDP_IPV6)
+    return ev_tcp_pipe_to_ex(EV_ROLE_EV_TCP, src, EV_ROLE_EV_TCP, dst, opts);
+}
+
+int ev_tcp_set_watermark(ev_tcp_t *sock, size_t low, size_t high,
+                         ev_tcp_watermark_cb cb, void *arg)
+{
+    if (low > high)
     {
-        level = IPPROTO_IPV6;
-        option = option6;
+        return EV_EINVAL;
     }
-    else
+
+    sock->backend.watermark.cb = cb;
+    sock->backend.watermark.arg = arg;
+    sock->backend.watermark.low = low;
+    sock->backend.watermark.high = high;
+
+    /* Otherwise applied once the stream is set up */
+    if (sock->base.data.flags & EV_HANDLE_TCP_STREAMING)
     {
-        level = IPPROTO_IP;
-        option = option4;
+        _ev_tcp_setup_watermark(sock);
     }
+    return 0;
+}
 
-    void     *optval = &ttl;
-    socklen_t optlen = sizeof(ttl);
-
-    /**
-     * On Solaris and derivatives such as SmartOS, the length of socket options
-     * is sizeof(int) for IPV6_MULTICAST_LOOP and sizeof(char) for
-     * IP_MULTICAST_LOOP, so hardcode the size of the option in the IPv6 case,
-     * and use the general uv__setsockopt_maybe_char call otherwise.
-     */
-#if defined(__sun) || defined(_AIX) || defined(__OpenBSD__) ||                 \
-    defined(__MVS__) || defined(__QNX__)
-    char char_val = ttl;
-    if (!(udp->base.data.flags & EV_HANDLE_UDP_IPV6))
-    {
-        optval = &char_val;
-        optlen = sizeof(char_val);
-    }
-#endif
-
-    if (setsockopt(udp->sock, level, option, optval, optlen) != 0)
-    {
-        int ret = errno;
-        return ev__translate_sys_error(ret);
-    }
-
-    return 0;
-}
-
-EV_LOCAL int ev__udp_recv(ev_udp_t *udp, ev_udp_read_t *req)
+ssize_t ev_tcp_write_queue_size(ev_tcp_t *sock)
 {
-    (void)req;
-    if (ev_list_size(&udp->recv_list) == 1)
+    if (!(sock->base.data.flags & EV_HANDLE_TCP_STREAMING))
     {
-        ev__nonblock_io_add(udp->base.loop, &udp->backend.io, EPOLLIN);
+        return 0;
     }
-
-    ev__handle_active(&udp->base);
-
-    return 0;
+    return (ssize_t)sock->backend.u.stream.pending.w_size;
 }
 
-EV_LOCAL int ev__udp_send(ev_udp_t *udp, ev_udp_write_t *req,
-                          const struct sockaddr *addr, socklen_t addrlen)
+int ev_tcp_set_zerocopy(ev_tcp_t *sock, int enable)
 {
-    int ret;
-
-    if (addr == NULL)
+#if defined(SO_ZEROCOPY) && defined(MSG_ZEROCOPY)
+    if (sock->base.data.flags &
+        (EV_HANDLE_TCP_LISTING | EV_HANDLE_TCP_ACCEPTING |
+         EV_HANDLE_TCP_CONNECTING))
     {
-        req->backend.peer_addr.ss_family = AF_UNSPEC;
+        return EV_EINVAL;
     }
-    else
+    if (sock->sock == EV_OS_SOCKET_INVALID)
     {
-        if ((ret = _ev_udp_maybe_deferred_bind_unix(udp, addr->sa_family, 0)) !=
-            0)
-        {
-            return ret;
-        }
+        return EV_EBADF;
+    }
 
-        if (addrlen == (socklen_t)-1)
+    _ev_tcp_setup_stream_once(sock);
+    ev_nonblock_stream_t *stream = &sock->backend.u.stream;
+
+    if (!enable)
+    {
+        if (stream->zerocopy.seq_sent != stream->zerocopy.seq_done ||
+            ev__nonblock_stream_size(stream, EV_IO_OUT) != 0)
         {
-            return EV_EINVAL;
+            return EV_EBUSY;
         }
-
-        memcpy(&req->backend.peer_addr, addr, addrlen);
+        ev__nonblock_stream_zerocopy(stream, NULL);
+        return 0;
     }
 
-    if (ev_list_size(&udp->send_list) == 1)
+    int opt = 1;
+    if (setsockopt(sock->sock, SOL_SOCKET, SO_ZEROCOPY, &opt, sizeof(opt)) != 0)
     {
-        ev__nonblock_io_add(udp->base.loop, &udp->backend.io, EPOLLOUT);
+        return ev__translate_sys_error(errno);
     }
-
-    ev__handle_active(&udp->base);
-
+    ev__nonblock_stream_zerocopy(stream, _on_tcp_zerocopy_done);
     return 0;
+#else
+    (void)sock;
+    (void)enable;
+    return EV_ENOSYS;
+#endif
 }
 
-int ev_udp_init(ev_loop_t *loop, ev_udp_t **udp, int domain)
+int ev_tcp_read(ev_tcp_t *sock, ev_buf_t *bufs, size_t nbuf, ev_tcp_read_cb cb,
+                void *arg)
 {
-    int err;
-    if (domain != AF_INET && domain != AF_INET6 && domain != AF_UNSPEC)
+    if (sock->base.data.flags &
+        (EV_HANDLE_TCP_LISTING | EV_HANDLE_TCP_ACCEPTING |
+         EV_HANDLE_TCP_CONNECTING))
     {
         return EV_EINVAL;
     }
 
-    ev_udp_t *new_udp = ev_malloc(sizeof(ev_udp_t));
-    if (new_udp == NULL)
+    ev_tcp_read_req_t *req = ev__loop_malloc(
+        sock->base.loop, EV_ALLOCATOR_TYPE_TCP, sizeof(ev_tcp_read_req_t));
+    if (req == NULL)
     {
         return EV_ENOMEM;
     }
 
-    new_udp->sock = EV_OS_SOCKET_INVALID;
-    if (domain != AF_UNSPEC)
+    req->read_cb = cb;
+    req->read_arg = arg;
+    int ret = ev__read_init(&req->base, bufs, nbuf);
+    if (ret != 0)
     {
-        if ((err = _ev_udp_maybe_deferred_socket_unix(new_udp, domain)) != 0)
-        {
-            ev_free(new_udp);
-            return err;
-        }
+        ev__loop_free(sock->base.loop, req);
+        return ret;
     }
 
-    ev__handle_init(loop, &new_udp->base, EV_ROLE_EV_UDP);
-    ev_list_init(&new_udp->send_list);
-    ev_list_init(&new_udp->recv_list);
+    _ev_tcp_setup_stream_once(sock);
 
-    *udp = new_udp;
+    ev__handle_active(&sock->base);
+    ret = ev__nonblock_stream_read(&sock->backend.u.stream, &req->base);
+
+    if (ret != 0)
+    {
+        _ev_tcp_smart_deactive(sock);
+        ev__loop_free(sock->base.loop, req);
+        return ret;
+    }
     return 0;
 }
 
-int ev_udp_open(ev_udp_t *udp, ev_os_socket_t sock)
-{
-    int err;
-    if (udp->sock != EV_OS_SOCKET_INVALID)
+#if defined(__linux__)
+
+/**
+ * @brief Layout of `struct tcp_info` since Linux 4.9.
+ *
+ * glibc stops at tcpi_total_retrans, while kernel only appends new fields, so
+ * the part we need is defined here. Fields beyond what the running kernel
+ * returns stay zero.
+ */
+typedef struct ev_tcp_info_linux
+{
+    uint8_t  tcpi_state;
+    uint8_t  tcpi_ca_state;
+    uint8_t  tcpi_retransmits;
+    uint8_t  tcpi_probes;
+    uint8_t  tcpi_backoff;
+    uint8_t  tcpi_options;
+    uint8_t  tcpi_wscale;
+    uint8_t  tcpi_flags;
+    uint32_t tcpi_rto;
+    uint32_t tcpi_ato;
+    uint32_t tcpi_snd_mss;
+    uint32_t tcpi_rcv_mss;
+    uint32_t tcpi_unacked;
+    uint32_t tcpi_sacked;
+    uint32_t tcpi_lost;
+    uint32_t tcpi_retrans;
+    uint32_t tcpi_fackets;
+    uint32_t tcpi_last_data_sent;
+    uint32_t tcpi_last_ack_sent;
+    uint32_t tcpi_last_data_recv;
+    uint32_t tcpi_last_ack_recv;
+    uint32_t tcpi_pmtu;
+    uint32_t tcpi_rcv_ssthresh;
+    uint32_t tcpi_rtt;
+    uint32_t tcpi_rttvar;
+    uint32_t tcpi_snd_ssthresh;
+    uint32_t tcpi_snd_cwnd;
+    uint32_t tcpi_advmss;
+    uint32_t tcpi_reordering;
+    uint32_t tcpi_rcv_rtt;
+    uint32_t tcpi_rcv_space;
+    uint32_t tcpi_total_retrans;
+    uint64_t tcpi_pacing_rate;
+    uint64_t tcpi_max_pacing_rate;
+    uint64_t tcpi_bytes_acked;
+    uint64_t tcpi_bytes_received;
+    uint32_t tcpi_segs_out;
+    uint32_t tcpi_segs_in;
+    uint32_t tcpi_notsent_bytes;
+    uint32_t tcpi_min_rtt;
+    uint32_t tcpi_data_segs_in;
+    uint32_t tcpi_data_segs_out;
+    uint64_t tcpi_delivery_rate;
+} ev_tcp_info_linux_t;
+
+int ev_tcp_get_info(ev_tcp_t *sock, ev_tcp_info_t *info)
+{
+    ev_tcp_info_linux_t raw;
+    socklen_t           len = sizeof(raw);
+
+    if (sock->sock == EV_OS_SOCKET_INVALID)
     {
-        return EV_EBUSY;
+        return EV_ENOTCONN;
     }
 
-    if ((err = ev__nonblock(sock, 1)) != 0)
+    memset(&raw, 0, sizeof(raw));
+    if (getsockopt(sock->sock, IPPROTO_TCP, TCP_INFO, &raw, &len) != 0)
     {
-        return err;
+        return ev__translate_sys_error(errno);
     }
 
-    if (_ev_udp_is_connected_unix(sock))
+    switch (raw.tcpi_state)
     {
-        udp->base.data.flags |= EV_HANDLE_UDP_CONNECTED;
+    case TCP_LISTEN:
+    case TCP_CLOSE:
+    case TCP_SYN_SENT:
+        return EV_ENOTCONN;
+    default:
+        break;
     }
 
+    info->rtt = raw.tcpi_rtt;
+    info->rtt_var = raw.tcpi_rttvar;
+    info->min_rtt = raw.tcpi_min_rtt;
+    info->snd_mss = raw.tcpi_snd_mss;
+    info->snd_cwnd = raw.tcpi_snd_cwnd;
+    info->unacked = raw.tcpi_unacked;
+    info->lost = raw.tcpi_lost;
+    info->total_retrans = raw.tcpi_total_retrans;
+    info->delivery_rate = raw.tcpi_delivery_rate;
+    info->bytes_acked = raw.tcpi_bytes_acked;
+    info->bytes_received = raw.tcpi_bytes_received;
+
     return 0;
 }
 
-void ev_udp_exit(ev_udp_t *udp, ev_udp_cb close_cb, void *close_arg)
+#else
+
+int ev_tcp_get_info(ev_tcp_t *sock, ev_tcp_info_t *info)
 {
-    _ev_udp_close_unix(udp);
-    udp->close_cb = close_cb;
-    udp->close_arg = close_arg;
-    ev__handle_exit(&udp->base, _ev_udp_on_close_unix);
+    (void)sock;
+    (void)info;
+    return EV_ENOSYS;
 }
 
-int ev_udp_bind(ev_udp_t *udp, const struct sockaddr *addr, unsigned flags)
+#endif
+
+int ev_tcp_getsockname(ev_tcp_t *sock, struct sockaddr *name, size_t *len)
+{
+    socklen_t socklen = *len;
+    if (getsockname(sock->sock, name, &socklen) != 0)
+    {
+        return ev__translate_sys_error(errno);
+    }
+
+    *len = (size_t)socklen;
+    return 0;
+}
+
+int ev_tcp_getpeername(ev_tcp_t *sock, struct sockaddr *name, size_t *len)
 {
     int       ret;
-    socklen_t addrlen = ev__get_addr_len(addr);
-    if (addrlen == (socklen_t)-1)
+    socklen_t socklen = *len;
+
+    if ((ret = getpeername(sock->sock, name, &socklen)) != 0)
     {
-        return EV_EINVAL;
+        return ev__translate_sys_error(errno);
     }
 
-    if ((ret = _ev_udp_maybe_deferred_socket_unix(udp, addr->sa_family)) != 0)
+    *len = socklen;
+    return 0;
+}
+
+int ev_tcp_connect(ev_tcp_t *sock, struct sockaddr *addr, size_t size,
+                   ev_tcp_connect_cb cb, void *arg)
+{
+    int        ret;
+    ev_loop_t *loop = sock->base.loop;
+
+    if (sock->base.data.flags & EV_HANDLE_TCP_CONNECTING)
     {
-        return ret;
+        return EV_EINPROGRESS;
+    }
+    if (sock->base.data.flags &
+        (EV_HANDLE_TCP_LISTING | EV_HANDLE_TCP_ACCEPTING |
+         EV_HANDLE_TCP_STREAMING))
+    {
+        return EV_EINVAL;
     }
 
-    if ((ret = _ev_udp_set_flags_unix(udp, flags)) != 0)
+    if ((ret = _ev_tcp_setup_fd(sock, addr->sa_family, 0, NULL)) != 0)
     {
         return ret;
     }
 
-    if (bind(udp->sock, addr, addrlen) < 0)
-    {
-        ret = errno;
-        if (ret == EAFNOSUPPORT)
-        {
-            return EV_EINVAL;
-        }
-        return ev__translate_sys_error(ret);
+    sock->backend.u.client.cb = cb;
+    sock->backend.u.client.arg = arg;
+    sock->base.data.flags |= EV_HANDLE_TCP_CONNECTING;
+
+    if ((ret = connect(sock->sock, addr, size)) == 0)
+    { /* Connect success immediately */
+        sock->backend.u.client.stat = 0;
+        ev__backlog_submit(&sock->base, _ev_tcp_to_connect);
+        return 0;
     }
 
-    if (addr->sa_family == AF_INET6)
+    if (errno != EINPROGRESS)
     {
-        udp->base.data.flags |= EV_HANDLE_UDP_IPV6;
+        sock->base.data.flags &= ~EV_HANDLE_TCP_CONNECTING;
+        ret = ev__translate_sys_error(errno);
+        goto err;
     }
 
-    udp->base.data.flags |= EV_HANDLE_UDP_BOUND;
+    ev__handle_active(&sock->base);
+    ev__nonblock_io_add(loop, &sock->backend.u.client.io, EV_IO_OUT);
+
     return 0;
+
+err:
+    _ev_tcp_close_fd(sock);
+    ev__handle_deactive(&sock->base);
+    return ret;
 }
 
-int ev_udp_connect(ev_udp_t *udp, const struct sockaddr *addr)
+EV_LOCAL int ev__tcp_open(ev_tcp_t *tcp, int fd)
 {
-    if (addr == NULL)
+    int busy_flags = EV_HANDLE_TCP_LISTING | EV_HANDLE_TCP_ACCEPTING |
+                     EV_HANDLE_TCP_STREAMING | EV_HANDLE_TCP_CONNECTING |
+                     EV_HABDLE_TCP_BOUND;
+    if (tcp->base.data.flags & busy_flags)
     {
-        if (!(udp->base.data.flags & EV_HANDLE_UDP_CONNECTED))
-        {
-            return EV_ENOTCONN;
-        }
-        return _ev_udp_disconnect_unix(udp);
+        return EV_EBUSY;
     }
 
-    return _ev_udp_do_connect_unix(udp, addr);
+    tcp->sock = fd;
+    _ev_tcp_setup_stream_once(tcp);
+
+    return ev__tcp_opts_apply(tcp, 0);
 }
 
-int ev_udp_getsockname(ev_udp_t *udp, struct sockaddr *name, size_t *len)
+EV_LOCAL int ev__tcp_opt_native(ev_tcp_opt_t opt, int *level, int *name)
 {
-    socklen_t wrap_len = *len;
-    if (getsockname(udp->sock, name, &wrap_len) != 0)
+    switch (opt)
     {
-        int err = errno;
-        return ev__translate_sys_error(err);
+    case EV_TCP_OPT_NODELAY:
+        *level = IPPROTO_TCP;
+        *name = TCP_NODELAY;
+        return 0;
+    case EV_TCP_OPT_KEEPALIVE:
+        *level = SOL_SOCKET;
+        *name = SO_KEEPALIVE;
+        return 0;
+    case EV_TCP_OPT_SNDBUF:
+        *level = SOL_SOCKET;
+        *name = SO_SNDBUF;
+        return 0;
+    case EV_TCP_OPT_RCVBUF:
+        *level = SOL_SOCKET;
+        *name = SO_RCVBUF;
+        return 0;
+#if defined(TCP_QUICKACK)
+    case EV_TCP_OPT_QUICKACK:
+        *level = IPPROTO_TCP;
+        *name = TCP_QUICKACK;
+        return 0;
+#endif
+#if defined(TCP_NOTSENT_LOWAT)
+    case EV_TCP_OPT_NOTSENT_LOWAT:
+        *level = IPPROTO_TCP;
+        *name = TCP_NOTSENT_LOWAT;
+        return 0;
+#endif
+#if defined(TCP_DEFER_ACCEPT)
+    case EV_TCP_OPT_DEFER_ACCEPT:
+        *level = IPPROTO_TCP;
+        *name = TCP_DEFER_ACCEPT;
+        return 0;
+#endif
+#if defined(TCP_FASTOPEN)
+    case EV_TCP_OPT_FASTOPEN:
+        *level = IPPROTO_TCP;
+        *name = TCP_FASTOPEN;
+        return 0;
+#endif
+#if defined(SO_BUSY_POLL)
+    case EV_TCP_OPT_BUSY_POLL:
+        *level = SOL_SOCKET;
+        *name = SO_BUSY_POLL;
+        return 0;
+#endif
+    default:
+        return EV_ENOSYS;
     }
-
-    *len = wrap_len;
-    return 0;
 }
 
-int ev_udp_getpeername(ev_udp_t *udp, struct sockaddr *name, size_t *len)
+EV_LOCAL int ev__tcp_setsockopt(ev_os_socket_t sock, int level, int name,
+                                int val)
 {
-    socklen_t wrap_len = *len;
-    if (getpeername(udp->sock, name, &wrap_len) != 0)
+    if (setsockopt(sock, level, name, &val, sizeof(val)) != 0)
     {
-        int err = errno;
-        return ev__translate_sys_error(err);
+        return ev__translate_sys_error(errno);
     }
-
-    *len = wrap_len;
     return 0;
 }
 
-int ev_udp_set_membership(ev_udp_t *udp, const char *multicast_addr,
-                          const char         *interface_addr,
-                          ev_udp_membership_t membership)
+EV_LOCAL int ev__tcp_getsockopt(ev_os_socket_t sock, int level, int name,
+                                int *val)
 {
-    int                     ret;
-    struct sockaddr_storage addr;
-
-    if (membership != EV_UDP_LEAVE_GROUP && membership != EV_UDP_ENTER_GROUP)
+    socklen_t len = sizeof(*val);
+    if (getsockopt(sock, level, name, val, &len) != 0)
     {
-        return EV_EINVAL;
+        return ev__translate_sys_error(errno);
     }
+    return 0;
+}
 
-    struct sockaddr_in *addr_4 = (struct sockaddr_in *)&addr;
-    memset(addr_4, 0, sizeof(*addr_4));
-
-    if (ev_ipv4_addr(multicast_addr, 0, addr_4) == 0)
+EV_LOCAL int ev__tcp_probe(ev_os_socket_t sock)
+{
+    char    c;
+    ssize_t ret;
+    do
     {
-        if ((ret = _ev_udp_maybe_deferred_bind_unix(udp, AF_INET,
-                                                    EV_UDP_REUSEADDR)) != 0)
-        {
-            return ret;
-        }
+        ret = recv(sock, &c, 1, MSG_PEEK | MSG_DONTWAIT);
+    } while (ret == -1 && errno == EINTR);
 
-        return _ev_udp_setmembership4_unix(udp, addr_4, interface_addr,
-                                           membership);
+    if (ret == 0)
+    {
+        return EV_EOF;
+    }
+    if (ret > 0)
+    {
+        return EV_EPROTO;
+    }
+    if (errno == EAGAIN || errno == EWOULDBLOCK)
+    {
+        return 0;
     }
+    return ev__translate_sys_error(errno);
+}
 
-    struct sockaddr_in6 *addr_6 = (struct sockaddr_in6 *)&addr;
-    memset(addr_6, 0, sizeof(*addr_6));
+// #line 90 "ev.c"
+////////////////////////////////////////////////////////////////////////////////
+// FILE:    ev/unix/thread_unix.c
+// SIZE:    4496
+// SHA-256: 13b9aee2aa71d4bdf5bb081742e23eb63fe086866e1565ec37b028d1f83e50b9
+////////////////////////////////////////////////////////////////////////////////
+// #line 1 "ev/unix/thread_unix.c"
+#define _GNU_SOURCE
+#include <semaphore.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/syscall.h>
 
-    if (ev_ipv6_addr(multicast_addr, 0, addr_6) == 0)
-    {
-        if ((ret = _ev_udp_maybe_deferred_bind_unix(udp, AF_INET6,
-                                                    EV_UDP_REUSEADDR)) != 0)
-        {
-            return ret;
-        }
+struct ev_thread
+{
+    pthread_t thr;
+};
 
-        return _ev_udp_setmembership6_unix(udp, addr_6, interface_addr,
-                                           membership);
-    }
+struct ev_thread_key
+{
+    pthread_key_t tls; /**< Thread local storage */
+};
 
-    return EV_EINVAL;
-}
+typedef struct ev_thread_helper_unix
+{
+    ev_thread_cb cb;
+    void        *arg;
+    sem_t        sem;
+} ev_thread_helper_unix_t;
 
-int ev_udp_set_source_membership(ev_udp_t *udp, const char *multicast_addr,
-                                 const char         *interface_addr,
-                                 const char         *source_addr,
-                                 ev_udp_membership_t membership)
+static void *_ev_thread_proxy_unix(void *arg)
 {
-    int                     ret;
-    struct sockaddr_storage mcast_addr;
-    struct sockaddr_storage src_addr;
+    ev_thread_helper_unix_t *p_helper = arg;
+    ev_thread_helper_unix_t  helper = *p_helper;
 
-    if (membership != EV_UDP_LEAVE_GROUP && membership != EV_UDP_ENTER_GROUP)
+    if (sem_post(&p_helper->sem) != 0)
     {
-        return EV_EINVAL;
+        EV_ABORT();
     }
 
-    struct sockaddr_in *mcast_addr_4 = (struct sockaddr_in *)&mcast_addr;
-    if ((ret = ev_ipv4_addr(multicast_addr, 0, mcast_addr_4)) == 0)
+    helper.cb(helper.arg);
+    return NULL;
+}
+
+static int s_thread_init(ev_thread_t *thr, const ev_thread_opt_t *opt,
+                         ev_thread_cb cb, void *arg)
+{
+    int             err;
+    pthread_attr_t *attr = NULL;
+    pthread_attr_t  attr_storage;
+
+    if (opt != NULL && opt->flags.have_stack_size)
     {
-        struct sockaddr_in *src_addr_4 = (struct sockaddr_in *)&src_addr;
-        if ((ret = ev_ipv4_addr(source_addr, 0, src_addr_4)) != 0)
+        if (pthread_attr_init(&attr_storage) != 0)
         {
-            return ret;
+            err = errno;
+            return ev__translate_sys_error(err);
         }
 
-        return _ev_udp_set_source_membership4_unix(
-            udp, mcast_addr_4, interface_addr, src_addr_4, membership);
-    }
-
-    struct sockaddr_in6 *mcast_addr_6 = (struct sockaddr_in6 *)&mcast_addr;
-    if ((ret = ev_ipv6_addr(multicast_addr, 0, mcast_addr_6)) == 0)
-    {
-        struct sockaddr_in6 *src_addr_6 = (struct sockaddr_in6 *)&src_addr;
-        if ((ret = ev_ipv6_addr(source_addr, 0, src_addr_6)) != 0)
+        if (pthread_attr_setstacksize(&attr_storage, opt->stack_size) != 0)
         {
-            return ret;
+            err = errno;
+            goto err_fin;
         }
 
-        return _ev_udp_set_source_membership6_unix(
-            udp, mcast_addr_6, interface_addr, src_addr_6, membership);
+        attr = &attr_storage;
     }
 
-    return ret;
-}
-
-int ev_udp_set_multicast_loop(ev_udp_t *udp, int on)
-{
-    return _ev_udp_set_ttl_unix(udp, on, IP_MULTICAST_LOOP,
-                                IPV6_MULTICAST_LOOP);
-}
-
-int ev_udp_set_multicast_ttl(ev_udp_t *udp, int ttl)
-{
-    return _ev_udp_set_ttl_unix(udp, ttl, IP_MULTICAST_TTL,
-                                IPV6_MULTICAST_HOPS);
-}
-
-int ev_udp_set_multicast_interface(ev_udp_t *udp, const char *interface_addr)
-{
-    int                     ret;
-    struct sockaddr_storage addr_st;
-    struct sockaddr_in     *addr_4 = (struct sockaddr_in *)&addr_st;
-    struct sockaddr_in6    *addr_6 = (struct sockaddr_in6 *)&addr_st;
-
-    int is_ipv6 = udp->base.data.flags & EV_HANDLE_UDP_IPV6;
-    if ((ret = ev__udp_interface_addr_to_sockaddr(&addr_st, interface_addr,
-                                                  is_ipv6)) != 0)
+    ev_thread_helper_unix_t helper;
+    helper.cb = cb;
+    helper.arg = arg;
+    if (sem_init(&helper.sem, 0, 0) != 0)
     {
-        return ret;
+        err = errno;
+        goto err_fin;
     }
 
-    int       level;
-    int       optname;
-    void     *optval;
-    socklen_t optlen;
-
-    if (addr_st.ss_family == AF_INET)
+    if ((err = pthread_create(&thr->thr, attr, _ev_thread_proxy_unix,
+                              &helper)) != 0)
     {
-        level = IPPROTO_IP;
-        optname = IP_MULTICAST_IF;
-        optval = &addr_4->sin_addr;
-        optlen = sizeof(addr_4->sin_addr);
+        goto release_sem;
     }
-    else if (addr_st.ss_family == AF_INET6)
+
+    do
     {
-        level = IPPROTO_IPV6;
-        optname = IPV6_MULTICAST_IF;
-        optval = &addr_6->sin6_scope_id;
-        optlen = sizeof(addr_6->sin6_scope_id);
+        err = sem_wait(&helper.sem);
+    } while (err == -1 && errno == EINTR);
+
+    err = err != 0 ? errno : 0;
+
+release_sem:
+    sem_destroy(&helper.sem);
+err_fin:
+    if (attr != NULL)
+    {
+        pthread_attr_destroy(attr);
     }
-    else
+    return ev__translate_sys_error(err);
+}
+
+int ev_thread_init(ev_thread_t **thr, const ev_thread_opt_t *opt,
+                   ev_thread_cb cb, void *arg)
+{
+    ev_thread_t *new_thread = ev_malloc(sizeof(ev_thread_t));
+    if (new_thread == NULL)
     {
-        EV_ABORT();
+        return EV_ENOMEM;
     }
 
-    if (setsockopt(udp->sock, level, optname, optval, optlen) != 0)
+    int ret = s_thread_init(new_thread, opt, cb, arg);
+    if (ret != 0)
     {
-        ret = errno;
-        return ev__translate_sys_error(ret);
+        ev_free(new_thread);
+        return ret;
     }
 
+    *thr = new_thread;
     return 0;
 }
 
-int ev_udp_set_broadcast(ev_udp_t *udp, int on)
+int ev_thread_exit(ev_thread_t *thr, unsigned long timeout)
 {
-    int err;
-    if (setsockopt(udp->sock, SOL_SOCKET, SO_BROADCAST, &on, sizeof(on)) != 0)
+    int ret = EBUSY;
+    if (timeout == EV_INFINITE_TIMEOUT)
     {
-        err = errno;
+        int err = pthread_join(thr->thr, NULL);
+        if (err == 0)
+        {
+            ev_free(thr);
+            return 0;
+        }
         return ev__translate_sys_error(err);
     }
 
-    return 0;
-}
+    const uint64_t t_start = ev_hrtime() / 1000000;
+    const uint64_t t_end = t_start + timeout;
 
-int ev_udp_set_ttl(ev_udp_t *udp, int ttl)
-{
-    if (ttl < 1 || ttl > 255)
+    uint64_t t_now;
+    while ((t_now = ev_hrtime() / 1000000) < t_end)
     {
-        return EV_EINVAL;
+        if ((ret = pthread_tryjoin_np(thr->thr, NULL)) == 0)
+        {
+            break;
+        }
+
+        uint64_t t_diff = t_end - t_now;
+        unsigned sleep_time = t_diff < 10 ? t_diff : 10;
+        ev_thread_sleep(sleep_time);
     }
 
-#if defined(__MVS__)
-    /* zOS does not support setting ttl for IPv4 */
-    if (!(udp->base.data.flags & EV_HANDLE_UDP_IPV6))
+    /* try last time */
+    if (ret == EBUSY)
     {
-        return EV_ENOTSUP;
+        ret = pthread_tryjoin_np(thr->thr, NULL);
+    }
+    if (ret == 0)
+    {
+        ev_free(thr);
+        return 0;
     }
-#endif
 
-    return _ev_udp_set_ttl_unix(udp, ttl, IP_TTL, IPV6_UNICAST_HOPS);
+    return ret == EBUSY ? EV_ETIMEDOUT : ev__translate_sys_error(ret);
 }
 
-// #line 86 "ev.c"
-
-#endif
-
-////////////////////////////////////////////////////////////////////////////////
-// FILE:    ev/assert.c
-// SIZE:    384
-// SHA-256: f8987454a05572d8a74466a1c47c51b6de945dbec63aa5d118450aa64e7c81e8
-////////////////////////////////////////////////////////////////////////////////
-// #line 1 "ev/assert.c"
-
-EV_LOCAL void ev__assertion_failure(const char* exp, const char* file, int line, const char* fmt, ...)
+ev_os_tid_t ev_thread_id(void)
 {
-    fprintf(stderr, "%s:%d: Assertion failed: %s", file, line, exp);
-    if (fmt != NULL)
-    {
-        fprintf(stderr, ": ");
-
-        va_list ap;
-        va_start(ap, fmt);
-        vfprintf(stderr, fmt, ap);
-        va_end(ap);
-    }
-    fprintf(stderr, "\n");
-    abort();
+    return syscall(__NR_gettid);
 }
 
-// #line 90 "ev.c"
-////////////////////////////////////////////////////////////////////////////////
-// FILE:    ev/allocator.c
-// SIZE:    1108
-// SHA-256: 7583da4a1d7824a4cbb65ddb514d7c8867985981fcb4e5354259cda679a6f88a
-////////////////////////////////////////////////////////////////////////////////
-// #line 1 "ev/allocator.c"
-#include <stdlib.h>
-#include <string.h>
-
-static void *_ev_realloc(void *ptr, size_t size)
+void ev_thread_sleep(uint32_t timeout)
 {
-    return realloc(ptr, size);
-}
+    struct timespec t_req, t_rem;
+    t_req.tv_sec = timeout / 1000;
+    t_req.tv_nsec = (timeout - t_req.tv_sec * 1000) * 1000 * 1000;
 
-static ev_realloc_fn s_allocator = _ev_realloc;
+    int ret;
+    while ((ret = nanosleep(&t_req, &t_rem)) != 0)
+    {
+        ret = errno;
+        if (ret != EINTR)
+        {
+            EV_ABORT();
+        }
+        t_req = t_rem;
+    }
+}
 
-int ev_replace_allocator(ev_realloc_fn  new_allocator,
-                         ev_realloc_fn *old_allocator)
+int ev_thread_key_init(ev_thread_key_t **key)
 {
-    if (new_allocator == NULL)
+    ev_thread_key_t *new_key = ev_malloc(sizeof(ev_thread_key_t));
+    if (new_key == NULL)
     {
-        return EV_EINVAL;
+        return EV_ENOMEM;
     }
 
-    if (old_allocator != NULL)
+    int ret = pthread_key_create(&new_key->tls, NULL);
+    if (ret != 0)
     {
-        *old_allocator = s_allocator;
+        ev_free(new_key);
+        return ev__translate_sys_error(ret);
     }
-    s_allocator = new_allocator;
 
+    *key = new_key;
     return 0;
 }
 
-void *ev_calloc(size_t nmemb, size_t size)
+void ev_thread_key_exit(ev_thread_key_t *key)
 {
-    const size_t alloc_size = size * nmemb;
-    void        *ptr = s_allocator(NULL, size * nmemb);
-    if (ptr != NULL)
+    int ret = pthread_key_delete(key->tls);
+    if (ret != 0)
     {
-        memset(ptr, 0, alloc_size);
+        EV_ABORT();
     }
-    return ptr;
+    ev_free(key);
 }
 
-void *ev_malloc(size_t size)
+void ev_thread_key_set(ev_thread_key_t *key, void *val)
 {
-    return s_allocator(NULL, size);
+    int ret = pthread_setspecific(key->tls, val);
+    if (ret != 0)
+    {
+        EV_ABORT();
+    }
 }
 
-void *ev_realloc(void *ptr, size_t size)
+void *ev_thread_key_get(ev_thread_key_t *key)
 {
-    return s_allocator(ptr, size);
+    return pthread_getspecific(key->tls);
 }
 
-void ev_free(void *ptr)
+// #line 91 "ev.c"
+////////////////////////////////////////////////////////////////////////////////
+// FILE:    ev/unix/threadpool_unix.c
+// SIZE:    942
+// SHA-256: 10487ad39897977af6e2f63e4ac09366f191adc87e314b98c5ef22b3b7567044
+////////////////////////////////////////////////////////////////////////////////
+// #line 1 "ev/unix/threadpool_unix.c"
+
+static void _on_work_unix(ev_nonblock_io_t* io, unsigned evts, void* arg)
 {
-    s_allocator(ptr, 0);
+    (void)evts; (void)arg;
+
+    ev_loop_t* loop = EV_CONTAINER_OF(io, ev_loop_t, backend.threadpool.io);
+    ev__async_pend(loop->backend.threadpool.evtfd[0]);
+
+    ev__threadpool_process(loop);
 }
 
-char *ev__strdup(const char *s)
+EV_LOCAL void ev__threadpool_wakeup(ev_loop_t* loop)
 {
-    size_t len = strlen(s) + 1;
-    char  *m = ev_malloc(len);
-    if (m == NULL)
-    {
-        return NULL;
-    }
-    return memcpy(m, s, len);
+    ev__async_post(loop->backend.threadpool.evtfd[1]);
 }
 
-// #line 91 "ev.c"
-////////////////////////////////////////////////////////////////////////////////
-// FILE:    ev/atomic.c
-// SIZE:    5881
-// SHA-256: 345bfc0849cfc67cee457944cbc074cb8f8a47dcef54cdd27806ddf1694d0e18
-////////////////////////////////////////////////////////////////////////////////
-// #line 1 "ev/atomic.c"
-#if defined(EV_ATOMIC_WIN32)
-
-EV_LOCAL void ev__atomic_exit(void)
+EV_LOCAL void ev__init_work(ev_loop_t* loop)
 {
+    ev__asyc_eventfd(loop->backend.threadpool.evtfd);
+
+    ev__nonblock_io_init(&loop->backend.threadpool.io, loop->backend.threadpool.evtfd[0], _on_work_unix, NULL);
+    ev__nonblock_io_add(loop, &loop->backend.threadpool.io, EV_IO_IN);
 }
 
-int ev_atomic32_compare_exchange_strong(volatile ev_atomic32_t* obj,
-    int32_t* expected, int32_t desired)
+EV_LOCAL void ev__exit_work(ev_loop_t* loop)
 {
-    int32_t previous = InterlockedCompareExchange(obj, desired, *expected);
-    if (previous == *expected)
-    {
-        return 1;
-    }
+    ev__async_eventfd_close(loop->backend.threadpool.evtfd[0]);
+    loop->backend.threadpool.evtfd[0] = -1;
 
-    *expected = previous;
-    return 0;
+    ev__async_eventfd_close(loop->backend.threadpool.evtfd[1]);
+    loop->backend.threadpool.evtfd[1] = -1;
 }
 
-int ev_atomic64_compare_exchange_strong(volatile ev_atomic64_t* obj,
-    int64_t* expected, int64_t desired)
+// #line 92 "ev.c"
+////////////////////////////////////////////////////////////////////////////////
+// FILE:    ev/unix/time_unix.c
+// SIZE:    284
+// SHA-256: 29005a6567d68fb9b141f64f08c5fb3e9d407a6e7e0727d9a850028c69a7a79c
+////////////////////////////////////////////////////////////////////////////////
+// #line 1 "ev/unix/time_unix.c"
+#include <time.h>
+
+uint64_t ev_hrtime(void)
 {
-    int64_t previous = InterlockedCompareExchange64(obj, desired, *expected);
-    if (previous == *expected)
+    int errcode;
+    struct timespec t;
+
+    if (clock_gettime(g_ev_loop_unix_ctx.hwtime_clock_id, &t) != 0)
     {
-        return 1;
+        errcode = errno;
+        EV_ABORT("errno:%d", errcode);
     }
 
-    *expected = previous;
-    return 0;
+    return t.tv_sec * (uint64_t) 1e9 + t.tv_nsec;
 }
 
-#elif defined(EV_ATOMIC_LOCK_SIMULATION)
-
-static ev_mutex_t s_atomic_lock;
+// #line 93 "ev.c"
+////////////////////////////////////////////////////////////////////////////////
+// FILE:    ev/unix/udp_unix.c
+// SIZE:    56838
+// SHA-256: 15eae17dbb5f491672083970cb9679c163d3210ea5bb14ab497070df8a493dbf
+////////////////////////////////////////////////////////////////////////////////
+// #line 1 "ev/unix/udp_unix.c"
+#define _GNU_SOURCE
+#include <sys/socket.h>
+#include <netinet/udp.h>
+#if defined(__linux__)
+#   include <linux/filter.h>
+#endif
+#include <unistd.h>
+#include <string.h>
+#include <limits.h>
 
-static void _ev_atomic_lock_init2(void)
+/**
+ * @brief Control message buffer for one received datagram.
+ */
+typedef union ev_udp_recv_cmsg
 {
-    ev_mutex_init(&s_atomic_lock, 0);
-}
+    char buf[CMSG_SPACE(sizeof(int)) +                 /* UDP_GRO */
+             CMSG_SPACE(sizeof(struct in6_pktinfo)) + /* IP(V6)_PKTINFO */
+             CMSG_SPACE(sizeof(struct timespec)) +    /* SO_TIMESTAMPNS */
+             CMSG_SPACE(sizeof(uint32_t))];           /* SO_RXQ_OVFL */
+    struct cmsghdr align; /**< Alignment */
+} ev_udp_recv_cmsg_t;
 
-static void _ev_atomic_lock_init_once(void)
+/**
+ * @brief Context of #ev_udp_set_recv_info().
+ */
+typedef struct ev_udp_recv_meta
 {
-    static ev_once_t token = EV_ONCE_INIT;
-    ev_once_execute(&token, _ev_atomic_lock_init2);
-}
+    unsigned           flags; /**< #ev_udp_recv_info_flags_t */
+    ev_udp_recv_info_t info;  /**< Ancillary data for #ev_udp_recv() */
+    ev_udp_recv_cmsg_t ctrl;  /**< Control message for #ev_udp_recv() */
+} ev_udp_recv_meta_t;
 
-EV_LOCAL void ev__atomic_exit(void)
-{
-    ev_mutex_exit(&s_atomic_lock);
-}
+/**
+ * @brief Context of #ev_udp_recv_batch_start().
+ *
+ * Arrays and payload buffers are allocated together after this structure.
+ */
+typedef struct ev_udp_recv_batch
+{
+    ev_udp_recv_batch_cb cb;       /**< Batch read callback */
+    void                *arg;      /**< User defined argument */
+    size_t               capacity; /**< Max datagrams per recvmmsg */
+    size_t               msg_size; /**< Buffer size of each datagram */
+    int                  busy;     /**< In callback */
+    int                  stopped;  /**< Stopped in callback */
+
+    struct sockaddr_storage *addrs; /**< Peer addresses */
+    struct mmsghdr          *hdrs;  /**< Message headers */
+    struct iovec            *iovs;  /**< Payload vectors */
+    ev_udp_datagram_t       *msgs;  /**< Datagrams for user */
+    ev_udp_recv_cmsg_t      *ctrls; /**< Control messages */
+    ev_udp_recv_info_t      *infos; /**< Ancillary data */
+    uint8_t                 *data;  /**< Payload buffers */
+} ev_udp_recv_batch_t;
 
-void ev_atomic32_init(volatile ev_atomic32_t* obj, int32_t desired)
+/**
+ * @brief Buffer slot of #ev_udp_recv_start().
+ */
+typedef struct ev_udp_recv_slot
 {
-    _ev_atomic_lock_init_once();
-    ev_atomic32_store(obj, desired);
-}
+    ev_list_node_t          node; /**< #ev_udp_recv_ring_t::free_list */
+    ev_udp_datagram_t       msg;  /**< Datagram for user */
+    struct sockaddr_storage addr; /**< Peer address */
+    ev_udp_recv_cmsg_t      ctrl; /**< Control message */
+    ev_udp_recv_info_t      info; /**< Ancillary data */
+} ev_udp_recv_slot_t;
 
-void ev_atomic64_init(volatile ev_atomic64_t* obj, int64_t desired)
+/**
+ * @brief Context of #ev_udp_recv_start().
+ *
+ * Slots and payload buffers are allocated together after this structure. The
+ * context outlives #ev_udp_recv_stop() until every borrowed buffer is
+ * returned.
+ */
+typedef struct ev_udp_recv_ring
 {
-    _ev_atomic_lock_init_once();
-    ev_atomic64_store(obj, desired);
-}
+    ev_udp_recv_ring_cb cb;        /**< Continuous read callback */
+    void               *arg;       /**< User defined argument */
+    size_t              buf_size;  /**< Size of each buffer */
+    size_t              borrowed;  /**< Buffers not in free list */
+    int                 busy;      /**< In callback */
+    int                 stopped;   /**< Stopped by user */
+    ev_list_t           free_list; /**< #ev_udp_recv_slot_t::node */
+} ev_udp_recv_ring_t;
 
-void ev_atomic32_store(volatile ev_atomic32_t* obj, int32_t desired)
+static void _ev_udp_close_unix(ev_udp_t *udp)
 {
-    ev_mutex_enter(&s_atomic_lock);
+    if (udp->sock != EV_OS_SOCKET_INVALID)
     {
-        *obj = desired;
+        ev__nonblock_io_del(udp->base.loop, &udp->backend.io,
+                            EPOLLIN | EPOLLOUT);
+        close(udp->sock);
+        udp->sock = EV_OS_SOCKET_INVALID;
     }
-    ev_mutex_leave(&s_atomic_lock);
 }
 
-void ev_atomic64_store(volatile ev_atomic64_t* obj, int64_t desired)
+static void _ev_udp_smart_deactive(ev_udp_t *udp)
 {
-    ev_mutex_enter(&s_atomic_lock);
-    {
-        *obj = desired;
-    }
-    ev_mutex_leave(&s_atomic_lock);
-}
+    size_t io_sz = 0;
 
-int32_t ev_atomic32_load(volatile ev_atomic32_t* obj)
-{
-    int32_t ret;
-    ev_mutex_enter(&s_atomic_lock);
+    io_sz += ev_list_size(&udp->send_list);
+    io_sz += ev_list_size(&udp->recv_list);
+    io_sz += udp->backend.rbatch != NULL;
+    io_sz += udp->backend.rring != NULL && !udp->backend.rring->stopped;
+
+    if (io_sz == 0)
     {
-        ret = *obj;
+        ev__handle_deactive(&udp->base);
     }
-    ev_mutex_leave(&s_atomic_lock);
-
-    return ret;
 }
 
-int64_t ev_atomic64_load(volatile ev_atomic64_t* obj)
+static void _ev_udp_w_user_callback_unix(ev_udp_t *udp, ev_udp_write_t *req,
+                                         ssize_t size)
 {
-    int64_t ret;
-    ev_mutex_enter(&s_atomic_lock);
-    {
-        ret = *obj;
-    }
-    ev_mutex_leave(&s_atomic_lock);
+    _ev_udp_smart_deactive(udp);
+    ev__write_exit(&req->base);
+    ev__handle_exit(&req->handle, NULL);
 
-    return ret;
+    req->usr_cb(udp, size, req->usr_cb_arg);
+    ev__loop_free(udp->base.loop, req);
 }
 
-int32_t ev_atomic32_exchange(volatile ev_atomic32_t* obj, int32_t desired)
+static void _ev_udp_r_user_callback_unix(ev_udp_t *udp, ev_udp_read_t *req,
+                                         const struct sockaddr *addr,
+                                         ssize_t                size)
 {
-    int32_t ret;
-    ev_mutex_enter(&s_atomic_lock);
-    {
-        ret = *obj;
-        *obj = desired;
-    }
-    ev_mutex_leave(&s_atomic_lock);
+    _ev_udp_smart_deactive(udp);
+    ev__read_exit(&req->base);
+    ev__handle_exit(&req->handle, NULL);
 
-    return ret;
+    req->usr_cb(udp, addr, size, req->usr_cb_arg);
+    ev__loop_free(udp->base.loop, req);
 }
 
-int64_t ev_atomic64_exchange(volatile ev_atomic64_t* obj, int64_t desired)
+static void _ev_udp_cancel_all_w_unix(ev_udp_t *udp, int err)
 {
-    int64_t ret;
-    ev_mutex_enter(&s_atomic_lock);
+    ev_list_node_t *it;
+    while ((it = ev_list_pop_front(&udp->send_list)) != NULL)
     {
-        ret = *obj;
-        *obj = desired;
+        ev_udp_write_t *req = EV_CONTAINER_OF(it, ev_udp_write_t, base.node);
+        _ev_udp_w_user_callback_unix(udp, req, err);
     }
-    ev_mutex_leave(&s_atomic_lock);
-
-    return ret;
 }
 
-int ev_atomic32_compare_exchange_strong(volatile ev_atomic32_t* obj,
-    int32_t* expected, int32_t desired)
+static void _ev_udp_cancel_all_r_unix(ev_udp_t *udp, int err)
 {
-    int ret;
-    ev_mutex_enter(&s_atomic_lock);
+    ev_list_node_t *it;
+    while ((it = ev_list_pop_front(&udp->recv_list)) != NULL)
     {
-        int32_t previous = *obj;
-        if (previous == *expected)
-        {
-            *obj = desired;
-            ret = 1;
-        }
-        else
-        {
-            *expected = previous;
-            ret = 0;
-        }
+        ev_udp_read_t *req = EV_CONTAINER_OF(it, ev_udp_read_t, base.node);
+        _ev_udp_r_user_callback_unix(udp, req, NULL, err);
     }
-    ev_mutex_leave(&s_atomic_lock);
-    return ret;
 }
 
-int ev_atomic64_compare_exchange_strong(volatile ev_atomic64_t* obj,
-    int64_t* expected, int64_t desired)
+/**
+ * @brief Detach batch receive context, it is released once it is not in use.
+ */
+static ev_udp_recv_batch_t *_ev_udp_recv_batch_detach_unix(ev_udp_t *udp)
 {
-    int ret;
-    ev_mutex_enter(&s_atomic_lock);
+    ev_udp_recv_batch_t *batch = udp->backend.rbatch;
+    udp->backend.rbatch = NULL;
+
+    if (batch->busy)
     {
-        int64_t previous = *obj;
-        if (previous == *expected)
-        {
-            *obj = desired;
-            ret = 1;
-        }
-        else
-        {
-            *expected = previous;
-            ret = 0;
-        }
+        batch->stopped = 1;
+        return batch;
     }
-    ev_mutex_leave(&s_atomic_lock);
-    return ret;
+    ev__loop_free(udp->base.loop, batch);
+    return NULL;
 }
 
-int32_t ev_atomic32_fetch_add(volatile ev_atomic32_t* obj, int32_t arg)
+static void _ev_udp_cancel_batch_r_unix(ev_udp_t *udp, int err)
 {
-    int32_t ret;
-    ev_mutex_enter(&s_atomic_lock);
+    ev_udp_recv_batch_t *batch = udp->backend.rbatch;
+    if (batch == NULL)
     {
-        ret = *obj;
-        *obj += arg;
+        return;
     }
-    ev_mutex_leave(&s_atomic_lock);
 
-    return ret;
+    ev_udp_recv_batch_cb cb = batch->cb;
+    void                *arg = batch->arg;
+    _ev_udp_recv_batch_detach_unix(udp);
+    _ev_udp_smart_deactive(udp);
+    cb(udp, NULL, 0, err, arg);
 }
 
-int64_t ev_atomic64_fetch_add(volatile ev_atomic64_t* obj, int64_t arg)
+/**
+ * @brief Release ring if it is stopped and no buffer is in use.
+ */
+static void _ev_udp_recv_ring_try_free_unix(ev_udp_t *udp)
 {
-    int64_t ret;
-    ev_mutex_enter(&s_atomic_lock);
+    ev_udp_recv_ring_t *ring = udp->backend.rring;
+    if (ring->stopped && !ring->busy && ring->borrowed == 0)
     {
-        ret = *obj;
-        *obj += arg;
+        udp->backend.rring = NULL;
+        ev__loop_free(udp->base.loop, ring);
     }
-    ev_mutex_leave(&s_atomic_lock);
-
-    return ret;
 }
 
-int32_t ev_atomic32_fetch_sub(volatile ev_atomic32_t* obj, int32_t arg)
+/**
+ * @brief Stop ring as #ev_udp_recv_stop() does and report \p err.
+ *
+ * Borrowed buffers stay valid, the ring is released once all of them are
+ * returned or the handle is closed.
+ */
+static void _ev_udp_cancel_ring_r_unix(ev_udp_t *udp, int err)
 {
-    int32_t ret;
-    ev_mutex_enter(&s_atomic_lock);
+    ev_udp_recv_ring_t *ring = udp->backend.rring;
+    if (ring == NULL || ring->stopped)
     {
-        ret = *obj;
-        *obj -= arg;
+        return;
     }
-    ev_mutex_leave(&s_atomic_lock);
 
-    return ret;
+    ev_udp_recv_ring_cb cb = ring->cb;
+    void               *arg = ring->arg;
+    ring->stopped = 1;
+    _ev_udp_recv_ring_try_free_unix(udp);
+
+    _ev_udp_smart_deactive(udp);
+    cb(udp, NULL, err, arg);
 }
 
-int64_t ev_atomic64_fetch_sub(volatile ev_atomic64_t* obj, int64_t arg)
+static void _ev_udp_abort_unix(ev_udp_t *udp, int err)
 {
-    int64_t ret;
-    ev_mutex_enter(&s_atomic_lock);
-    {
-        ret = *obj;
-        *obj -= arg;
-    }
-    ev_mutex_leave(&s_atomic_lock);
-
-    return ret;
+    _ev_udp_close_unix(udp);
+    _ev_udp_cancel_all_w_unix(udp, err);
+    _ev_udp_cancel_all_r_unix(udp, err);
+    _ev_udp_cancel_batch_r_unix(udp, err);
+    _ev_udp_cancel_ring_r_unix(udp, err);
 }
 
-int32_t ev_atomic32_fetch_or(volatile ev_atomic32_t* obj, int32_t arg)
+static void _ev_udp_on_close_unix(ev_handle_t *handle)
 {
-    int32_t ret;
-    ev_mutex_enter(&s_atomic_lock);
+    ev_udp_t *udp = EV_CONTAINER_OF(handle, ev_udp_t, base);
+    ev_loop_t *loop = udp->base.loop;
+    ev_udp_cb  close_cb = udp->close_cb;
+    void      *close_arg = udp->close_arg;
+
+    _ev_udp_abort_unix(udp, EV_ECANCELED);
+    if (udp->backend.rring != NULL)
     {
-        ret = *obj;
-        *obj |= arg;
+        /* Borrowed buffers die with the handle */
+        ev__loop_free(loop, udp->backend.rring);
+        udp->backend.rring = NULL;
+    }
+    if (udp->backend.rmeta != NULL)
+    {
+        ev__loop_free(loop, udp->backend.rmeta);
+        udp->backend.rmeta = NULL;
+    }
+    if (!(udp->base.data.flags & EV_HANDLE_INPLACE))
+    {
+        ev__loop_free(loop, udp);
     }
-    ev_mutex_leave(&s_atomic_lock);
 
-    return ret;
+    if (close_cb != NULL)
+    {
+        close_cb(udp, close_arg);
+    }
 }
 
-int64_t ev_atomic64_fetch_or(volatile ev_atomic64_t* obj, int64_t arg)
+/**
+ * @return bool
+ */
+static int _ev_udp_is_connected_unix(ev_os_socket_t sock)
 {
-    int64_t ret;
-    ev_mutex_enter(&s_atomic_lock);
+    struct sockaddr_storage addr;
+    socklen_t               addrlen = sizeof(addr);
+
+    if (getpeername(sock, (struct sockaddr *)&addr, &addrlen) != 0)
     {
-        ret = *obj;
-        *obj |= arg;
+        return 0;
     }
-    ev_mutex_leave(&s_atomic_lock);
-
-    return ret;
+    return addrlen > 0;
 }
 
-int32_t ev_atomic32_fetch_xor(volatile ev_atomic32_t* obj, int32_t arg)
+static int _ev_udp_set_flags_unix(ev_udp_t *udp, unsigned flags)
 {
-    int32_t ret;
-    ev_mutex_enter(&s_atomic_lock);
+    int err;
+    if (flags & EV_UDP_IPV6_ONLY)
     {
-        ret = *obj;
-        *obj ^= arg;
+        int yes = 1;
+        if (setsockopt(udp->sock, IPPROTO_IPV6, IPV6_V6ONLY, &yes,
+                       sizeof(yes)) == -1)
+        {
+            err = errno;
+            return ev__translate_sys_error(err);
+        }
     }
-    ev_mutex_leave(&s_atomic_lock);
 
-    return ret;
-}
+    if (flags & EV_UDP_REUSEADDR)
+    {
+        if ((err = ev__reuse_unix(udp->sock)) != 0)
+        {
+            return err;
+        }
+    }
 
-int64_t ev_atomic32_fetch_xor(volatile ev_atomic64_t* obj, int64_t arg)
-{
-    int64_t ret;
-    ev_mutex_enter(&s_atomic_lock);
+    if (flags & EV_UDP_REUSEPORT)
     {
-        ret = *obj;
-        *obj ^= arg;
+#if defined(SO_REUSEPORT)
+        int yes = 1;
+        if (setsockopt(udp->sock, SOL_SOCKET, SO_REUSEPORT, &yes,
+                       sizeof(yes)) == -1)
+        {
+            err = errno;
+            return ev__translate_sys_error(err);
+        }
+#else
+        return EV_ENOSYS;
+#endif
     }
-    ev_mutex_leave(&s_atomic_lock);
 
-    return ret;
+    return 0;
 }
 
-int32_t ev_atomic32_fetch_and(volatile ev_atomic32_t* obj, int32_t arg)
+static int _ev_udp_disconnect_unix(ev_udp_t *udp)
 {
-    int32_t ret;
-    ev_mutex_enter(&s_atomic_lock);
+    struct sockaddr addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sa_family = AF_UNSPEC;
+
+    int r;
+    do
     {
-        ret = *obj;
-        *obj &= arg;
+        r = connect(udp->sock, &addr, sizeof(addr));
+    } while (r == -1 && errno == EINTR);
+
+    if (r == -1 && errno != EAFNOSUPPORT)
+    {
+        r = errno;
+        return ev__translate_sys_error(r);
     }
-    ev_mutex_leave(&s_atomic_lock);
 
-    return ret;
+    udp->base.data.flags &= ~EV_HANDLE_UDP_CONNECTED;
+    return 0;
 }
 
-int64_t ev_atomic64_fetch_and(volatile ev_atomic64_t* obj, int64_t arg)
+/**
+ * @brief Max datagrams flushed by one sendmmsg().
+ */
+#define EV_UDP_SENDMMSG_MAX 64
+
+/**
+ * @brief Control message buffer for one datagram.
+ */
+typedef union ev_udp_cmsg
 {
-    int64_t ret;
-    ev_mutex_enter(&s_atomic_lock);
+    char           buf[CMSG_SPACE(sizeof(uint16_t))]; /**< UDP_SEGMENT */
+    struct cmsghdr align;                              /**< Alignment */
+} ev_udp_cmsg_t;
+
+/**
+ * @brief Bytes of segmented request \p req carried by one message.
+ */
+static size_t _ev_udp_segment_step_unix(ev_udp_t *udp, ev_udp_write_t *req)
+{
+#if defined(UDP_SEGMENT)
+    if (g_ev_loop_unix_ctx.udp_gso &&
+        !(udp->base.data.flags & EV_HANDLE_UDP_NO_GSO))
     {
-        ret = *obj;
-        *obj &= arg;
+        size_t nseg = EV_UDP_GSO_MAX_SIZE / req->seg_size;
+        if (nseg > EV_UDP_GSO_MAX_SEGMENTS)
+        {
+            nseg = EV_UDP_GSO_MAX_SEGMENTS;
+        }
+        return nseg != 0 ? nseg * req->seg_size : req->seg_size;
     }
-    ev_mutex_leave(&s_atomic_lock);
-
-    return ret;
-}
-
 #else
+    (void)udp;
+#endif
+    return req->seg_size;
+}
 
-EV_LOCAL void ev__atomic_exit(void)
+/**
+ * @brief Fill message headers from the head of send queue.
+ *
+ * A segmented request may take several messages, each carrying as many
+ * segments as one UDP_SEGMENT send allows, or a single segment if GSO is not
+ * available. Already sent bytes are tracked by #ev_write_t::size.
+ *
+ * @return  Number of messages.
+ */
+static size_t _ev_udp_fill_mmsghdr_unix(ev_udp_t *udp, ev_udp_write_t **reqs,
+                                        struct mmsghdr *hdrs,
+                                        struct iovec   *iovs,
+                                        ev_udp_cmsg_t  *ctrls)
 {
-}
+    size_t          nmsg = 0;
+    ev_list_node_t *it = ev_list_begin(&udp->send_list);
 
-#endif
+    for (; it != NULL && nmsg < EV_UDP_SENDMMSG_MAX; it = ev_list_next(it))
+    {
+        ev_udp_write_t *req = EV_CONTAINER_OF(it, ev_udp_write_t, base.node);
+        size_t          offset = req->base.size;
+        size_t          step =
+            req->seg_size != 0 ? _ev_udp_segment_step_unix(udp, req) : 0;
 
-// #line 92 "ev.c"
-////////////////////////////////////////////////////////////////////////////////
-// FILE:    ev/errno.c
-// SIZE:    438
-// SHA-256: ac04a2a3cf8600a4daf0051b8d5beb42832225fea7fa9085a9c652c2905a16eb
-////////////////////////////////////////////////////////////////////////////////
-// #line 1 "ev/errno.c"
-const char* ev_strerror(int err)
-{
-#define EV_EXPAND_ERRMAP(err, syserr, str) case err: return str;
+        do
+        {
+            struct msghdr *hdr = &hdrs[nmsg].msg_hdr;
+            memset(hdr, 0, sizeof(*hdr));
+            hdrs[nmsg].msg_len = 0;
+            reqs[nmsg] = req;
 
-    switch (err)
-    {
-    /* Success */
-    case 0:                     return "Operation success";
-    case EV_EOF:                return "End of file";
-    /* posix */
-    EV_ERRNO_POSIX_MAP(EV_EXPAND_ERRMAP);
-    /* Unknown error */
-    default:                    break;
-    }
-    return "Unknown error";
+            if (req->backend.peer_addr.ss_family != AF_UNSPEC)
+            {
+                hdr->msg_name = &req->backend.peer_addr;
+                hdr->msg_namelen = ev__get_addr_len(
+                    (struct sockaddr *)&req->backend.peer_addr);
+            }
 
-#undef EV_EXPAND_ERRMAP
-}
+            if (req->seg_size == 0)
+            {
+                hdr->msg_iov = (struct iovec *)req->base.bufs;
+                hdr->msg_iovlen = req->base.nbuf;
+                nmsg++;
+                break;
+            }
 
-// #line 93 "ev.c"
-////////////////////////////////////////////////////////////////////////////////
-// FILE:    ev/fs.c
-// SIZE:    25615
-// SHA-256: f341c85028b2c0dd95da2cf2f9c5459f6b749c065759db19424283589128f128
-////////////////////////////////////////////////////////////////////////////////
-// #line 1 "ev/fs.c"
-#include <sys/stat.h>
-#include <string.h>
-#include <assert.h>
+            size_t len = req->base.capacity - offset;
+            len = len < step ? len : step;
+            iovs[nmsg].iov_base = (uint8_t *)req->base.bufs[0].data + offset;
+            iovs[nmsg].iov_len = len;
+            hdr->msg_iov = &iovs[nmsg];
+            hdr->msg_iovlen = 1;
+            offset += len;
 
-#if !defined(S_ISDIR) && defined(S_IFMT) && defined(S_IFDIR)
-#   define S_ISDIR(m) (((m) & S_IFMT) == S_IFDIR)
+#if defined(UDP_SEGMENT)
+            if (step != req->seg_size && len > req->seg_size)
+            {
+                hdr->msg_control = ctrls[nmsg].buf;
+                hdr->msg_controllen = sizeof(ctrls[nmsg].buf);
+
+                struct cmsghdr *cmsg = CMSG_FIRSTHDR(hdr);
+                cmsg->cmsg_level = SOL_UDP;
+                cmsg->cmsg_type = UDP_SEGMENT;
+                cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+                *(uint16_t *)CMSG_DATA(cmsg) = (uint16_t)req->seg_size;
+            }
+#else
+            (void)ctrls;
 #endif
+            nmsg++;
+        } while (offset < req->base.capacity && nmsg < EV_UDP_SENDMMSG_MAX);
+    }
 
-typedef struct ev_dirent_record_s
-{
-    ev_list_node_t      node;   /**< List node */
-    ev_dirent_t         data;   /**< Dirent info */
-} ev_dirent_record_t;
-
-typedef struct fs_readdir_helper
-{
-    ev_fs_req_t*        req;    /**< File system request */
-    ssize_t             cnt;    /**< Dirent counter */
-} fs_readdir_helper_t;
-
-typedef struct fs_remove_helper
-{
-    const char*         parent_path;
-    int                 ret;
-} fs_remove_helper_t;
+    return nmsg;
+}
 
-static void _ev_fs_erase_req(ev_file_t* file, ev_fs_req_t* req)
+static void _ev_udp_finish_write_unix(ev_udp_t *udp, ev_udp_write_t *req,
+                                      ssize_t size)
 {
-    ev_list_erase(&file->work_queue, &req->node);
+    ev_list_erase(&udp->send_list, &req->base.node);
+    _ev_udp_w_user_callback_unix(udp, req, size);
 }
 
-static void _ev_fs_cleanup_req_as_open(ev_fs_req_t* token)
+static int _ev_udp_on_io_write_unix(ev_udp_t *udp)
 {
-    if (token->req.as_open.path != NULL)
+    int             ret;
+    size_t          i, nmsg;
+    ev_udp_write_t *reqs[EV_UDP_SENDMMSG_MAX];
+    struct mmsghdr  hdrs[EV_UDP_SENDMMSG_MAX];
+    struct iovec    iovs[EV_UDP_SENDMMSG_MAX];
+    ev_udp_cmsg_t   ctrls[EV_UDP_SENDMMSG_MAX];
+
+    while ((nmsg = _ev_udp_fill_mmsghdr_unix(udp, reqs, hdrs, iovs, ctrls)) !=
+           0)
     {
-        ev_free(token->req.as_open.path);
-        token->req.as_open.path = NULL;
-    }
-}
+        do
+        {
+            ret = sendmmsg(udp->sock, hdrs, nmsg, MSG_DONTWAIT);
+        } while (ret < 0 && errno == EINTR);
 
-static void _ev_fs_cleanup_req_as_seek(ev_fs_req_t* req)
-{
-    (void)req;
-}
+        if (ret < 0)
+        {
+            int err = errno;
+            if (err == EAGAIN || err == EWOULDBLOCK)
+            {
+                return 0;
+            }
 
-static void _ev_fs_cleanup_req_as_read(ev_fs_req_t* req)
-{
-    ev__read_exit(&req->req.as_read.read_req);
-}
+            /*
+             * ENOBUFS does not clear once the socket is writable again, so
+             * waiting for EPOLLOUT would spin. It is reported below like any
+             * other error, the datagram is dropped as the network would.
+             */
 
-static void _ev_fs_cleanup_req_as_write(ev_fs_req_t* req)
-{
-    ev__write_exit(&req->req.as_write.write_req);
+            /* Route without checksum offload rejects GSO, fall back */
+            if (err == EIO && hdrs[0].msg_hdr.msg_control != NULL)
+            {
+                udp->base.data.flags |= EV_HANDLE_UDP_NO_GSO;
+                continue;
+            }
+
+            /* Error belongs to the first datagram, the rest is retried */
+            _ev_udp_finish_write_unix(udp, reqs[0],
+                                      ev__translate_sys_error(err));
+            if (udp->sock == EV_OS_SOCKET_INVALID)
+            {
+                return 0;
+            }
+            continue;
+        }
+
+        for (i = 0; i < (size_t)ret; i++)
+        {
+            ev_udp_write_t *req = reqs[i];
+            req->base.size += hdrs[i].msg_len;
+            if (req->seg_size != 0 && req->base.size < req->base.capacity)
+            {
+                continue;
+            }
+            _ev_udp_finish_write_unix(udp, req, req->base.size);
+
+            /* Remaining requests are cancelled by close */
+            if (udp->sock == EV_OS_SOCKET_INVALID)
+            {
+                return 0;
+            }
+        }
+    }
+
+    return 0;
 }
 
-static void _ev_fs_cleanup_req_as_fstat(ev_fs_req_t* req)
+/**
+ * @return  Enabled #ev_udp_recv_info_flags_t.
+ */
+static unsigned _ev_udp_recv_info_flags_unix(ev_udp_t *udp)
 {
-    (void)req;
+    return udp->backend.rmeta != NULL ? udp->backend.rmeta->flags : 0;
 }
 
-static void _ev_fs_cleanup_req_as_readdir(ev_fs_req_t* req)
+/**
+ * @brief Parse control messages.
+ * @param[in] hdr       Received message.
+ * @param[in] flags     Enabled #ev_udp_recv_info_flags_t.
+ * @param[out] info     Ancillary data. Ignored if \p flags is 0.
+ * @return              GRO segment size, 0 if datagrams are not coalesced.
+ */
+static size_t _ev_udp_parse_cmsg_unix(struct msghdr *hdr, unsigned flags,
+                                      ev_udp_recv_info_t *info)
 {
-    ev_list_node_t* it;
-    while ((it = ev_list_pop_front(&req->rsp.dirents)) != NULL)
-    {
-        ev_dirent_record_t* rec = EV_CONTAINER_OF(it, ev_dirent_record_t, node);
-        ev_free((char*)rec->data.name);
-        ev_free(rec);
-    }
+    size_t          seg_size = 0;
+    struct cmsghdr *cmsg = CMSG_FIRSTHDR(hdr);
 
-    if (req->req.as_readdir.path != NULL)
+    if (flags != 0)
     {
-        ev_free(req->req.as_readdir.path);
-        req->req.as_readdir.path = NULL;
+        info->flags = 0;
     }
-}
 
-static void _ev_fs_cleanup_req_as_readfile(ev_fs_req_t* req)
-{
-    if (req->req.as_readfile.path != NULL)
+    for (; cmsg != NULL; cmsg = CMSG_NXTHDR(hdr, cmsg))
     {
-        ev_free(req->req.as_readfile.path);
-        req->req.as_readfile.path = NULL;
+#if defined(UDP_GRO)
+        if (cmsg->cmsg_level == SOL_UDP && cmsg->cmsg_type == UDP_GRO)
+        {
+            int val;
+            memcpy(&val, CMSG_DATA(cmsg), sizeof(val));
+            seg_size = val;
+            continue;
+        }
+#endif
+        if (flags == 0)
+        {
+            continue;
+        }
+#if defined(IP_PKTINFO)
+        if (cmsg->cmsg_level == IPPROTO_IP && cmsg->cmsg_type == IP_PKTINFO)
+        {
+            struct in_pktinfo   pi;
+            struct sockaddr_in *addr = (struct sockaddr_in *)&info->dst_addr;
+            memcpy(&pi, CMSG_DATA(cmsg), sizeof(pi));
+            memset(addr, 0, sizeof(*addr));
+            addr->sin_family = AF_INET;
+            addr->sin_addr = pi.ipi_addr;
+            info->ifindex = pi.ipi_ifindex;
+            info->flags |= EV_UDP_RECV_PKTINFO;
+            continue;
+        }
+#endif
+#if defined(IPV6_PKTINFO)
+        if (cmsg->cmsg_level == IPPROTO_IPV6 && cmsg->cmsg_type == IPV6_PKTINFO)
+        {
+            struct in6_pktinfo   pi;
+            struct sockaddr_in6 *addr = (struct sockaddr_in6 *)&info->dst_addr;
+            memcpy(&pi, CMSG_DATA(cmsg), sizeof(pi));
+            memset(addr, 0, sizeof(*addr));
+            addr->sin6_family = AF_INET6;
+            addr->sin6_addr = pi.ipi6_addr;
+            info->ifindex = pi.ipi6_ifindex;
+            info->flags |= EV_UDP_RECV_PKTINFO;
+            continue;
+        }
+#endif
+#if defined(SO_TIMESTAMPNS)
+        if (cmsg->cmsg_level == SOL_SOCKET &&
+            cmsg->cmsg_type == SCM_TIMESTAMPNS)
+        {
+            struct timespec ts;
+            memcpy(&ts, CMSG_DATA(cmsg), sizeof(ts));
+            info->timestamp = (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+            info->flags |= EV_UDP_RECV_TIMESTAMP;
+            continue;
+        }
+#endif
+#if defined(SO_RXQ_OVFL)
+        if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SO_RXQ_OVFL)
+        {
+            memcpy(&info->drops, CMSG_DATA(cmsg), sizeof(info->drops));
+            info->flags |= EV_UDP_RECV_DROPS;
+            continue;
+        }
+#endif
     }
 
-    if (req->rsp.filecontent.data != NULL)
+    /* Kernel omits the counter until the first drop */
+    if ((flags & EV_UDP_RECV_DROPS) && !(info->flags & EV_UDP_RECV_DROPS))
     {
-        ev_free(req->rsp.filecontent.data);
-        req->rsp.filecontent.data = NULL;
+        info->drops = 0;
+        info->flags |= EV_UDP_RECV_DROPS;
     }
-    req->rsp.filecontent.size = 0;
-}
 
-static void _ev_fs_cleanup_req_as_mkdir(ev_fs_req_t* req)
-{
-    if (req->req.as_mkdir.path != NULL)
-    {
-        ev_free(req->req.as_mkdir.path);
-        req->req.as_mkdir.path = NULL;
-    }
+    return seg_size;
 }
 
-static void _ev_fs_cleanup_req_as_remove(ev_fs_req_t* req)
+static int _ev_udp_do_recvmsg_unix(ev_udp_t *udp, ev_udp_read_t *req)
 {
-    if (req->req.as_remove.path != NULL)
-    {
-        ev_free(req->req.as_remove.path);
-        req->req.as_remove.path = NULL;
-    }
-}
+    struct msghdr hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    memset(&req->addr, 0, sizeof(req->addr));
 
-static void _ev_fs_init_req(ev_fs_req_t* req, ev_file_t* file, ev_file_cb cb, ev_fs_req_type_t type)
-{
-    req->req_type = type;
-    req->cb = cb;
-    req->file = file;
-    req->result = EV_EINPROGRESS;
+    hdr.msg_name = &req->addr;
+    hdr.msg_namelen = sizeof(req->addr);
+    hdr.msg_iov = (struct iovec *)req->base.data.bufs;
+    hdr.msg_iovlen = req->base.data.nbuf;
 
-    if (file != NULL)
+    unsigned flags = _ev_udp_recv_info_flags_unix(udp);
+    if (flags != 0)
     {
-        ev_list_push_back(&file->work_queue, &req->node);
+        hdr.msg_control = udp->backend.rmeta->ctrl.buf;
+        hdr.msg_controllen = sizeof(udp->backend.rmeta->ctrl);
     }
-}
 
-static int _ev_fs_init_req_as_open(ev_fs_req_t* token, ev_file_t* file,
-    const char* path, int flags, int mode, ev_file_cb cb)
-{
-    _ev_fs_init_req(token, file, cb, EV_FS_REQ_OPEN);
+    ssize_t read_size;
+    do
+    {
+        read_size = recvmsg(udp->sock, &hdr, 0);
+    } while (read_size < 0 && errno == EINTR);
 
-    if ((token->req.as_open.path = ev__strdup(path)) == NULL)
+    if (read_size < 0)
     {
-        return EV_ENOMEM;
+        int err = errno;
+        if (err == EAGAIN || err == EWOULDBLOCK)
+        {
+            return EV_EAGAIN;
+        }
+        return ev__translate_sys_error(err);
     }
 
-    token->req.as_open.flags = flags;
-    token->req.as_open.mode = mode;
+    if (flags != 0)
+    {
+        _ev_udp_parse_cmsg_unix(&hdr, flags, &udp->backend.rmeta->info);
+    }
 
+    req->base.data.size += read_size;
     return 0;
 }
 
-static int _ev_fs_init_req_as_seek(ev_fs_req_t* token, ev_file_t* file,
-    int whence, int64_t offset, ev_file_cb cb)
+static int _ev_udp_on_io_read_unix(ev_udp_t *udp)
 {
-    _ev_fs_init_req(token, file, cb, EV_FS_REQ_SEEK);
-
-    token->req.as_seek.whence = whence;
-    token->req.as_seek.offset = offset;
+    int             ret = 0;
+    ev_list_node_t *it;
+    while ((it = ev_list_begin(&udp->recv_list)) != NULL)
+    {
+        ev_udp_read_t *req = EV_CONTAINER_OF(it, ev_udp_read_t, base.node);
 
-    return 0;
-}
+        if ((ret = _ev_udp_do_recvmsg_unix(udp, req)) != 0)
+        {
+            break;
+        }
 
-static int _ev_fs_init_req_as_read(ev_fs_req_t* req, ev_file_t* file,
-    ev_buf_t bufs[], size_t nbuf, int64_t offset, ev_file_cb cb)
-{
-    _ev_fs_init_req(req, file, cb, EV_FS_REQ_READ);
+        ev_list_erase(&udp->recv_list, it);
+        _ev_udp_r_user_callback_unix(udp, req, (struct sockaddr *)&req->addr,
+                                     req->base.data.size);
+    }
 
-    int ret = ev__read_init(&req->req.as_read.read_req, bufs, nbuf);
-    if (ret != 0)
+    if (ret == EV_EAGAIN)
     {
-        return ret;
+        ret = 0;
     }
-    req->req.as_read.offset = offset;
-
-    return 0;
+    return ret;
 }
 
-static int _ev_fs_init_req_as_write(ev_fs_req_t* token, ev_file_t* file,
-    ev_buf_t bufs[], size_t nbuf, int64_t offset, ev_file_cb cb)
+static int _ev_udp_on_io_read_batch_unix(ev_udp_t *udp)
 {
-    _ev_fs_init_req(token, file, cb, EV_FS_REQ_WRITE);
+    int                  ret;
+    size_t               i;
+    ev_udp_recv_batch_t *batch = udp->backend.rbatch;
 
-    int ret = ev__write_init(&token->req.as_write.write_req, bufs, nbuf);
-    if (ret != 0)
+    for (;;)
     {
-        return ret;
-    }
-    token->req.as_write.offset = offset;
+        for (i = 0; i < batch->capacity; i++)
+        {
+            batch->hdrs[i].msg_hdr.msg_namelen = sizeof(batch->addrs[i]);
+            batch->hdrs[i].msg_hdr.msg_controllen = sizeof(batch->ctrls[i]);
+            batch->hdrs[i].msg_hdr.msg_flags = 0;
+            batch->hdrs[i].msg_len = 0;
+        }
 
-    return 0;
-}
+        do
+        {
+            ret = recvmmsg(udp->sock, batch->hdrs, batch->capacity,
+                           MSG_DONTWAIT, NULL);
+        } while (ret < 0 && errno == EINTR);
 
-static void _ev_fs_init_req_as_fstat(ev_fs_req_t* req, ev_file_t* file,
-    ev_fs_stat_t* stat, ev_file_cb cb)
-{
-    _ev_fs_init_req(req, file, cb, EV_FS_REQ_FSTAT);
-    req->rsp.stat = stat;
-}
+        if (ret < 0)
+        {
+            int err = errno;
+            if (err == EAGAIN || err == EWOULDBLOCK)
+            {
+                return 0;
+            }
+            return ev__translate_sys_error(err);
+        }
 
-static int _ev_fs_init_req_as_readdir(ev_fs_req_t* req, const char* path, ev_file_cb cb)
-{
-    _ev_fs_init_req(req, NULL, cb, EV_FS_REQ_READDIR);
-    req->req.as_readdir.path = ev__strdup(path);
-    if (req->req.as_readdir.path == NULL)
-    {
-        return EV_ENOMEM;
-    }
+        unsigned flags = _ev_udp_recv_info_flags_unix(udp);
+        for (i = 0; i < (size_t)ret; i++)
+        {
+            batch->msgs[i].size = batch->hdrs[i].msg_len;
+            batch->msgs[i].seg_size = _ev_udp_parse_cmsg_unix(
+                &batch->hdrs[i].msg_hdr, flags, &batch->infos[i]);
+            batch->msgs[i].info = flags != 0 ? &batch->infos[i] : NULL;
+        }
 
-    ev_list_init(&req->rsp.dirents);
+        batch->busy = 1;
+        batch->cb(udp, batch->msgs, ret, 0, batch->arg);
+        batch->busy = 0;
 
-    return 0;
+        if (batch->stopped)
+        {
+            ev__loop_free(udp->base.loop, batch);
+            return 0;
+        }
+
+        /* Socket queue is drained, or handle is closed in callback */
+        if ((size_t)ret < batch->capacity || udp->sock == EV_OS_SOCKET_INVALID)
+        {
+            return 0;
+        }
+    }
 }
 
-static int _ev_fs_init_req_as_readfile(ev_fs_req_t* req, const char* path,
-    ev_file_cb cb)
+/**
+ * @brief Max datagrams read by one recvmmsg() in continuous receive.
+ */
+#define EV_UDP_RECVMMSG_MAX 64
+
+static int _ev_udp_on_io_read_ring_unix(ev_udp_t *udp)
 {
-    _ev_fs_init_req(req, NULL, cb, EV_FS_REQ_READFILE);
+    int                 ret;
+    size_t              i, nmsg;
+    ev_list_node_t     *it;
+    ev_udp_recv_ring_t *ring = udp->backend.rring;
+    ev_udp_recv_slot_t *slots[EV_UDP_RECVMMSG_MAX];
+    struct mmsghdr      hdrs[EV_UDP_RECVMMSG_MAX];
+    struct iovec        iovs[EV_UDP_RECVMMSG_MAX];
 
-    req->req.as_readfile.path = ev__strdup(path);
-    if (req->req.as_readfile.path == NULL)
+    while (!ring->stopped && ev_list_size(&ring->free_list) != 0)
     {
-        return EV_ENOMEM;
-    }
+        it = ev_list_begin(&ring->free_list);
+        for (nmsg = 0; it != NULL && nmsg < EV_UDP_RECVMMSG_MAX; nmsg++)
+        {
+            ev_udp_recv_slot_t *slot =
+                EV_CONTAINER_OF(it, ev_udp_recv_slot_t, node);
+            it = ev_list_next(it);
+
+            slots[nmsg] = slot;
+            iovs[nmsg].iov_base = slot->msg.data;
+            iovs[nmsg].iov_len = ring->buf_size;
+            memset(&hdrs[nmsg], 0, sizeof(hdrs[nmsg]));
+            hdrs[nmsg].msg_hdr.msg_name = &slot->addr;
+            hdrs[nmsg].msg_hdr.msg_namelen = sizeof(slot->addr);
+            hdrs[nmsg].msg_hdr.msg_iov = &iovs[nmsg];
+            hdrs[nmsg].msg_hdr.msg_iovlen = 1;
+            hdrs[nmsg].msg_hdr.msg_control = slot->ctrl.buf;
+            hdrs[nmsg].msg_hdr.msg_controllen = sizeof(slot->ctrl);
+        }
 
-    req->rsp.filecontent = ev_buf_make(NULL, 0);
+        do
+        {
+            ret = recvmmsg(udp->sock, hdrs, nmsg, MSG_DONTWAIT, NULL);
+        } while (ret < 0 && errno == EINTR);
 
-    return 0;
-}
+        if (ret < 0)
+        {
+            int err = errno;
+            if (err == EAGAIN || err == EWOULDBLOCK)
+            {
+                return 0;
+            }
+            return ev__translate_sys_error(err);
+        }
 
-static int _ev_fs_init_req_as_mkdir(ev_fs_req_t* req, const char* path, int mode,
-    ev_file_cb cb)
-{
-    _ev_fs_init_req(req, NULL, cb, EV_FS_REQ_MKDIR);
+        /* Lend all received buffers before calling back */
+        for (i = 0; i < (size_t)ret; i++)
+        {
+            ev_list_erase(&ring->free_list, &slots[i]->node);
+            ring->borrowed++;
+        }
 
-    req->req.as_mkdir.path = ev__strdup(path);
-    if (req->req.as_mkdir.path == NULL)
-    {
-        return EV_ENOMEM;
-    }
-    req->req.as_mkdir.mode = mode;
+        ring->busy = 1;
+        for (i = 0; i < (size_t)ret; i++)
+        {
+            ev_udp_recv_slot_t *slot = slots[i];
+            if (ring->stopped || udp->sock == EV_OS_SOCKET_INVALID)
+            {
+                /* Undelivered datagrams are dropped */
+                ev_list_push_back(&ring->free_list, &slot->node);
+                ring->borrowed--;
+                continue;
+            }
 
-    return 0;
-}
+            unsigned flags = _ev_udp_recv_info_flags_unix(udp);
+            slot->msg.size = hdrs[i].msg_len;
+            slot->msg.seg_size =
+                _ev_udp_parse_cmsg_unix(&hdrs[i].msg_hdr, flags, &slot->info);
+            slot->msg.info = flags != 0 ? &slot->info : NULL;
+            ring->cb(udp, &slot->msg, 0, ring->arg);
+        }
+        ring->busy = 0;
 
-static int _ev_fs_init_req_as_remove(ev_fs_req_t* req, const char* path, int recursion, ev_file_cb cb)
-{
-    _ev_fs_init_req(req, NULL, cb, EV_FS_REQ_REMOVE);
+        if (ring->stopped)
+        {
+            _ev_udp_recv_ring_try_free_unix(udp);
+            return 0;
+        }
+        if (udp->sock == EV_OS_SOCKET_INVALID || (size_t)ret < nmsg)
+        {
+            return 0;
+        }
+    }
 
-    req->req.as_remove.path = ev__strdup(path);
-    if (req->req.as_remove.path == NULL)
+    /* All buffers are borrowed, wait for return */
+    if (!ring->stopped)
     {
-        return EV_ENOMEM;
+        ev__nonblock_io_del(udp->base.loop, &udp->backend.io, EPOLLIN);
     }
-    req->req.as_remove.recursion = recursion;
-
     return 0;
 }
 
-/**
- * @brief Check if \p file have pending task.
- * @return  bool
- */
-static int _ev_file_have_pending(ev_file_t* file)
+static void _ev_udp_on_io_unix(ev_nonblock_io_t *io, unsigned evts, void *arg)
 {
-    return ev_list_size(&file->work_queue) != 0;
-}
+    (void)arg;
+    int       ret;
+    ev_udp_t *udp = EV_CONTAINER_OF(io, ev_udp_t, backend.io);
 
-static void _ev_file_do_close_callback(ev_file_t* file)
-{
-    if (file->close_cb != NULL)
+    if (evts & EPOLLOUT)
     {
-        file->close_cb(file);
+        if ((ret = _ev_udp_on_io_write_unix(udp)) != 0)
+        {
+            goto err;
+        }
+
+        /* Closed in callback */
+        if (udp->sock == EV_OS_SOCKET_INVALID)
+        {
+            return;
+        }
+
+        if (ev_list_size(&udp->send_list) == 0)
+        {
+            ev__nonblock_io_del(udp->base.loop, &udp->backend.io, EPOLLOUT);
+        }
     }
-}
 
-static void _ev_file_do_close_callback_if_necessary(ev_file_t* file)
-{
-    if (file == NULL)
+    if ((evts & EPOLLIN) && udp->backend.rbatch != NULL)
     {
-        return;
+        if ((ret = _ev_udp_on_io_read_batch_unix(udp)) != 0)
+        {
+            goto err;
+        }
     }
-    if (file->close_cb != NULL && !_ev_file_have_pending(file))
+    else if ((evts & EPOLLIN) && udp->backend.rring != NULL &&
+             !udp->backend.rring->stopped)
     {
-        _ev_file_do_close_callback(file);
+        if ((ret = _ev_udp_on_io_read_ring_unix(udp)) != 0)
+        {
+            goto err;
+        }
     }
-}
-
-static void _ev_file_on_close(ev_handle_t* handle)
-{
-    ev_file_t* file = EV_CONTAINER_OF(handle, ev_file_t, base);
-    _ev_file_do_close_callback(file);
-}
-
-static void _ev_file_cancel_all_pending_task(ev_file_t* file, size_t* failure_count)
-{
-    *failure_count = 0;
-
-    ev_list_node_t* it = ev_list_begin(&file->work_queue);
-    for (; it != NULL; it = ev_list_next(it))
+    else if (evts & EPOLLIN)
     {
-        ev_fs_req_t* req = EV_CONTAINER_OF(it, ev_fs_req_t, node);
-        if (ev_loop_cancel(&req->work_token) != 0)
+        if ((ret = _ev_udp_on_io_read_unix(udp)) != 0)
         {
-            *failure_count += 1;
+            goto err;
+        }
+
+        if (ev_list_size(&udp->recv_list) == 0 && udp->backend.rbatch == NULL)
+        {
+            ev__nonblock_io_del(udp->base.loop, &udp->backend.io, EPOLLIN);
         }
     }
+
+    return;
+
+err:
+    _ev_udp_abort_unix(udp, ret);
 }
 
-static int _ev_fs_on_readdir_entry(ev_dirent_t* info, void* arg)
+static int _ev_udp_maybe_deferred_socket_unix(ev_udp_t *udp, int domain)
 {
-    fs_readdir_helper_t* helper = arg;
-
-    ev_dirent_record_t* rec = ev_malloc(sizeof(ev_dirent_record_t));
-    if (rec == NULL)
+    if (udp->sock != EV_OS_SOCKET_INVALID)
     {
-        goto err_nomem;
+        return 0;
     }
 
-    rec->data.type = info->type;
-    rec->data.name = ev__strdup(info->name);
-    if (rec->data.name == NULL)
+    if ((udp->sock = socket(domain, SOCK_DGRAM, 0)) < 0)
     {
-        goto err_nomem;
+        int ret = errno;
+        return ev__translate_sys_error(ret);
     }
 
-    ev_list_push_back(&helper->req->rsp.dirents, &rec->node);
-    helper->cnt++;
+    ev__nonblock_io_init(&udp->backend.io, udp->sock, _ev_udp_on_io_unix, NULL);
 
     return 0;
-
-err_nomem:
-    if (rec != NULL)
-    {
-        ev_free(rec);
-    }
-    helper->req->result = EV_ENOMEM;
-    return -1;
 }
 
-static void _ev_fs_smart_deactive(ev_file_t* file)
+static int _ev_udp_do_connect_unix(ev_udp_t *udp, const struct sockaddr *addr)
 {
-    size_t io_sz = ev_list_size(&file->work_queue);
-    if (io_sz == 0)
+    int       ret;
+    socklen_t addrlen = ev__get_addr_len(addr);
+    if (addrlen == (socklen_t)-1)
     {
-        ev__handle_deactive(&file->base);
+        return EV_EINVAL;
     }
-}
-
-static void _ev_fs_on_done(ev_work_t* work, int status)
-{
-    ev_fs_req_t* req = EV_CONTAINER_OF(work, ev_fs_req_t, work_token);
-    ev_file_t* file = req->file;
 
-    if (status == EV_ECANCELED)
+    if ((ret = _ev_udp_maybe_deferred_socket_unix(udp, addr->sa_family)) != 0)
     {
-        assert(req->result == 0);
-        req->result = EV_ECANCELED;
+        return ret;
     }
 
-    if (file != NULL)
+    do
     {
-        _ev_fs_erase_req(file, req);
-        _ev_fs_smart_deactive(file);
+        ret = connect(udp->sock, addr, addrlen);
+    } while (ret == -1 && errno == EINTR);
+
+    if (ret != 0)
+    {
+        ret = errno;
+        return ev__translate_sys_error(ret);
     }
-    req->cb(req);
 
-    /**
-     * As describe in #ev_file_exit(), we have to check close status.
-     */
-    _ev_file_do_close_callback_if_necessary(file);
+    udp->base.data.flags |= EV_HANDLE_UDP_CONNECTED;
+    return 0;
 }
 
-static void _ev_file_on_open(ev_work_t* work)
+static int _ev_udp_maybe_deferred_bind_unix(ev_udp_t *udp, int domain,
+                                            int flags)
 {
-    ev_fs_req_t* req = EV_CONTAINER_OF(work, ev_fs_req_t, work_token);
-    ev_file_t* file = req->file;
+    int ret = _ev_udp_maybe_deferred_socket_unix(udp, domain);
+    if (ret != 0)
+    {
+        return ret;
+    }
 
-    req->result = ev__fs_open(&file->file, req->req.as_open.path,
-        req->req.as_open.flags, req->req.as_open.mode);
-}
+    if (udp->base.data.flags & EV_HANDLE_UDP_BOUND)
+    {
+        return 0;
+    }
 
-static void _ev_file_on_read(ev_work_t* work)
-{
-    ev_fs_req_t* req = EV_CONTAINER_OF(work, ev_fs_req_t, work_token);
-    ev_file_t* file = req->file;
-    ev_read_t* read_req = &req->req.as_read.read_req;
-
-    req->result = ev__fs_readv(file->file, read_req->data.bufs,
-        read_req->data.nbuf);
-}
+    struct sockaddr_storage addr;
+    struct sockaddr_in     *addr4 = (struct sockaddr_in *)&addr;
+    struct sockaddr_in6    *addr6 = (struct sockaddr_in6 *)&addr;
 
-static void _ev_file_on_pread(ev_work_t* work)
-{
-    ev_fs_req_t* req = EV_CONTAINER_OF(work, ev_fs_req_t, work_token);
-    ev_file_t* file = req->file;
-    ev_read_t* read_req = &req->req.as_read.read_req;
+    switch (domain)
+    {
+    case AF_INET: {
+        memset(addr4, 0, sizeof(*addr4));
+        addr4->sin_family = AF_INET;
+        addr4->sin_addr.s_addr = INADDR_ANY;
+        return ev_udp_bind(udp, (struct sockaddr *)addr4, flags);
+    }
 
-    req->result = ev__fs_preadv(file->file, read_req->data.bufs,
-        read_req->data.nbuf, req->req.as_read.offset);
-}
+    case AF_INET6: {
+        memset(addr6, 0, sizeof(*addr6));
+        addr6->sin6_family = AF_INET6;
+        addr6->sin6_addr = in6addr_any;
+        return ev_udp_bind(udp, (struct sockaddr *)addr6, flags);
+    }
 
-static void _ev_file_on_write(ev_work_t* work)
-{
-    ev_fs_req_t* req = EV_CONTAINER_OF(work, ev_fs_req_t, work_token);
-    ev_file_t* file = req->file;
-    ev_write_t* write_req = &req->req.as_write.write_req;
+    default:
+        break;
+    }
 
-    req->result = ev__fs_writev(file->file, write_req->bufs,
-        write_req->nbuf);
+    EV_ABORT();
 }
 
-static void _ev_file_on_pwrite(ev_work_t* work)
+static int _ev_udp_convert_interface_addr4_unix(
+    struct ip_mreq *dst, const struct sockaddr_in *multicast_addr,
+    const char *interface_addr)
 {
-    ev_fs_req_t* req = EV_CONTAINER_OF(work, ev_fs_req_t, work_token);
-    ev_file_t* file = req->file;
-    ev_write_t* write_req = &req->req.as_write.write_req;
+    int ret;
+    memset(dst, 0, sizeof(*dst));
 
-    req->result = ev__fs_pwritev(file->file, write_req->bufs,
-        write_req->nbuf, req->req.as_write.offset);
-}
+    if (interface_addr != NULL)
+    {
+        if ((ret = inet_pton(AF_INET, interface_addr,
+                             &dst->imr_interface.s_addr)) != 1)
+        {
+            int ret = errno;
+            return ev__translate_sys_error(ret);
+        }
+    }
+    else
+    {
+        dst->imr_interface.s_addr = htonl(INADDR_ANY);
+    }
 
-static void _ev_file_on_fstat(ev_work_t* work)
-{
-    ev_fs_req_t* req = EV_CONTAINER_OF(work, ev_fs_req_t, work_token);
-    ev_file_t* file = req->file;
+    dst->imr_multiaddr.s_addr = multicast_addr->sin_addr.s_addr;
 
-    req->result = ev__fs_fstat(file->file, req->rsp.stat);
+    return 0;
 }
 
-static void _ev_fs_readdir_sync(ev_fs_req_t* req)
+static int _ev_udp_setmembership4_unix(ev_udp_t           *udp,
+                                       struct sockaddr_in *multicast_addr,
+                                       const char         *interface_addr,
+                                       ev_udp_membership_t membership)
 {
-    fs_readdir_helper_t helper = { req, 0 };
-    req->result = ev__fs_readdir(req->req.as_readdir.path,
-        _ev_fs_on_readdir_entry, &helper);
+    int ret;
 
-    /* If operation success, replace result with dirent counter */
-    if (req->result == 0)
+    struct ip_mreq mreq;
+    if ((ret = _ev_udp_convert_interface_addr4_unix(&mreq, multicast_addr,
+                                                    interface_addr)) != 0)
     {
-        req->result = helper.cnt;
+        return ret;
     }
-}
 
-static void _ev_fs_on_readdir(ev_work_t* work)
-{
-    ev_fs_req_t* req = EV_CONTAINER_OF(work, ev_fs_req_t, work_token);
-    _ev_fs_readdir_sync(req);
+    int optname = membership == EV_UDP_ENTER_GROUP ? IP_ADD_MEMBERSHIP
+                                                   : IP_DROP_MEMBERSHIP;
+    if (setsockopt(udp->sock, IPPROTO_IP, optname, &mreq, sizeof(mreq)) != 0)
+    {
+        ret = errno;
+        return ev__translate_sys_error(ret);
+    }
+
+    return 0;
 }
 
-static void _ev_fs_readfile_sync(ev_fs_req_t* req)
+static void _ev_udp_convert_interface_addr6_unix(
+    struct ipv6_mreq *dst, struct sockaddr_in6 *multicast_addr,
+    const char *interface_addr)
 {
-    const char* path = req->req.as_readfile.path;
-
-    ev_os_file_t file = EV_OS_FILE_INVALID;
-    req->result = ev__fs_open(&file, path, EV_FS_O_RDONLY, 0);
-    if (req->result != 0)
-    {
-        return;
-    }
+    memset(dst, 0, sizeof(*dst));
 
-    ev_fs_stat_t statbuf = EV_FS_STAT_INVALID;
-    req->result = ev__fs_fstat(file, &statbuf);
-    if (req->result != 0)
+    if (interface_addr != 0)
     {
-        goto close_file;
-    }
+        struct sockaddr_in6 addr6;
+        ev_ipv6_addr(interface_addr, 0, &addr6);
 
-#if UINT64_MAX > SIZE_MAX
-    if (statbuf.st_size > SIZE_MAX)
-    {
-        req->result = EV_E2BIG;
-        goto close_file;
+        dst->ipv6mr_interface = addr6.sin6_scope_id;
     }
-#endif
-    /* Now it is a safe cast. */
-    size_t file_sz = (size_t)statbuf.st_size;
-
-    void* data = ev_malloc(file_sz);
-    if (data == NULL)
+    else
     {
-        req->result = EV_ENOMEM;
-        goto close_file;
+        dst->ipv6mr_interface = 0;
     }
-
-    req->rsp.filecontent = ev_buf_make(data, file_sz);
-    req->result = ev__fs_preadv(file, &req->rsp.filecontent, 1, 0);
-
-close_file:
-    ev__fs_close(file);
-}
-
-static void _ev_fs_on_readfile(ev_work_t* work)
-{
-    ev_fs_req_t* req = EV_CONTAINER_OF(work, ev_fs_req_t, work_token);
-    _ev_fs_readfile_sync(req);
+    dst->ipv6mr_multiaddr = multicast_addr->sin6_addr;
 }
 
-static void _ev_fs_on_mkdir(ev_work_t* work)
+static int _ev_udp_setmembership6_unix(ev_udp_t            *udp,
+                                       struct sockaddr_in6 *multicast_addr,
+                                       const char          *interface_addr,
+                                       ev_udp_membership_t  membership)
 {
-    ev_fs_req_t* req = EV_CONTAINER_OF(work, ev_fs_req_t, work_token);
-    const char* path = req->req.as_mkdir.path;
-    int mode = req->req.as_mkdir.mode;
-
-    req->result = ev__fs_mkdir(path, mode);
-}
+    int              ret;
+    struct ipv6_mreq mreq;
+    _ev_udp_convert_interface_addr6_unix(&mreq, multicast_addr, interface_addr);
 
-static void _ev_fs_on_remove(ev_work_t* work)
-{
-    ev_fs_req_t* req = EV_CONTAINER_OF(work, ev_fs_req_t, work_token);
-    const char* path = req->req.as_remove.path;
+    int optname = membership == EV_UDP_ENTER_GROUP ? IPV6_ADD_MEMBERSHIP
+                                                   : IPV6_DROP_MEMBERSHIP;
+    if (setsockopt(udp->sock, IPPROTO_IPV6, optname, &mreq, sizeof(mreq)) != 0)
+    {
+        ret = errno;
+        return ev__translate_sys_error(ret);
+    }
 
-    req->result = ev__fs_remove(path, req->req.as_remove.recursion);
+    return 0;
 }
 
-static int _ev_file_read_template(ev_file_t* file, ev_fs_req_t* req, ev_buf_t bufs[],
-    size_t nbuf, int64_t offset, ev_file_cb cb, ev_work_cb work_cb)
+static int _ev_udp_convert_source_interface_addr4_unix(
+    struct ip_mreq_source *dst, const char *interface_addr,
+    const struct sockaddr_in *multicast_addr,
+    const struct sockaddr_in *source_addr)
 {
-    ev_loop_t* loop = file->base.loop;
+    int ret;
+    memset(dst, 0, sizeof(*dst));
 
-    int ret = _ev_fs_init_req_as_read(req, file, bufs, nbuf, offset, cb);
-    if (ret != 0)
+    if (interface_addr != NULL)
     {
-        return ret;
+        if ((ret = inet_pton(AF_INET, interface_addr,
+                             &dst->imr_interface.s_addr)) != 1)
+        {
+            ret = errno;
+            return ev__translate_sys_error(ret);
+        }
     }
-
-    ev__handle_active(&file->base);
-
-    ret = ev__loop_submit_threadpool(loop, &req->work_token,
-        EV_THREADPOOL_WORK_IO_FAST, work_cb, _ev_fs_on_done);
-    if (ret != 0)
+    else
     {
-        _ev_fs_cleanup_req_as_read(req);
-        _ev_fs_smart_deactive(file);
-        return ret;
+        dst->imr_interface.s_addr = htonl(INADDR_ANY);
     }
 
+    dst->imr_multiaddr.s_addr = multicast_addr->sin_addr.s_addr;
+    dst->imr_sourceaddr.s_addr = source_addr->sin_addr.s_addr;
+
     return 0;
 }
 
-static int _ev_file_pwrite_template(ev_file_t* file, ev_fs_req_t* req, ev_buf_t bufs[],
-    size_t nbuf, int64_t offset, ev_file_cb cb, ev_work_cb work_cb)
+static int _ev_udp_set_source_membership4_unix(
+    ev_udp_t *udp, const struct sockaddr_in *multicast_addr,
+    const char *interface_addr, const struct sockaddr_in *source_addr,
+    ev_udp_membership_t membership)
 {
-    int ret;
-    ev_loop_t* loop = file->base.loop;
-
-    ret = _ev_fs_init_req_as_write(req, file, bufs, nbuf, offset, cb);
+    int ret = _ev_udp_maybe_deferred_bind_unix(udp, AF_INET, EV_UDP_REUSEADDR);
     if (ret != 0)
     {
         return ret;
     }
 
-    ev__handle_active(&file->base);
-
-    ret = ev__loop_submit_threadpool(loop, &req->work_token,
-        EV_THREADPOOL_WORK_IO_FAST, work_cb, _ev_fs_on_done);
-    if (ret != 0)
+    struct ip_mreq_source mreq;
+    if ((ret = _ev_udp_convert_source_interface_addr4_unix(
+             &mreq, interface_addr, multicast_addr, source_addr)) != 0)
     {
-        _ev_fs_cleanup_req_as_write(req);
-        _ev_fs_smart_deactive(file);
         return ret;
     }
 
+    int optname = membership == EV_UDP_ENTER_GROUP ? IP_ADD_SOURCE_MEMBERSHIP
+                                                   : IP_DROP_SOURCE_MEMBERSHIP;
+    if (setsockopt(udp->sock, IPPROTO_IP, optname, &mreq, sizeof(mreq)) != 0)
+    {
+        ret = errno;
+        return ev__translate_sys_error(ret);
+    }
+
     return 0;
 }
 
-static void _ev_fs_on_seek(ev_work_t* work)
+static int _ev_udp_convert_source_interface_addr6_unix(
+    struct group_source_req *dst, const char *interface_addr,
+    const struct sockaddr_in6 *multicast_addr,
+    const struct sockaddr_in6 *source_addr)
 {
-    ev_fs_req_t* req = EV_CONTAINER_OF(work, ev_fs_req_t, work_token);
-    ev_file_t* file = req->file;
+    int                 ret;
+    struct sockaddr_in6 addr_6;
 
-    req->result = ev__fs_seek(file->file, req->req.as_seek.whence, req->req.as_seek.offset);
-}
+    memset(dst, 0, sizeof(*dst));
 
-static int _ev_fs_remove(const char* path)
-{
-    int errcode;
-    if (remove(path) != 0)
+    if (interface_addr != NULL)
     {
-        errcode = errno;
-        return ev__translate_sys_error(errcode);
+        if ((ret = ev_ipv6_addr(interface_addr, 0, &addr_6)) != 0)
+        {
+            return ret;
+        }
+        dst->gsr_interface = addr_6.sin6_scope_id;
     }
+    else
+    {
+        dst->gsr_interface = 0;
+    }
+
+    memcpy(&dst->gsr_group, multicast_addr, sizeof(*multicast_addr));
+    memcpy(&dst->gsr_source, source_addr, sizeof(*source_addr));
+
     return 0;
 }
 
-static  int _ev_fs_remove_helper(ev_dirent_t* info, void* arg)
+static int _ev_udp_set_source_membership6_unix(
+    ev_udp_t *udp, const struct sockaddr_in6 *multicast_addr,
+    const char *interface_addr, const struct sockaddr_in6 *source_addr,
+    ev_udp_membership_t membership)
 {
-    fs_remove_helper_t* helper = arg;
-    const char* parent_path = helper->parent_path;
-    size_t parent_path_sz = strlen(parent_path);
-    size_t name_sz = strlen(info->name);
-    size_t full_path_sz = parent_path_sz + 1 + name_sz;
-
-    char* full_path = ev_malloc(full_path_sz + 1);
-    snprintf(full_path, full_path_sz + 1, "%s/%s", parent_path, info->name);
-
-    helper->ret = ev__fs_remove(full_path, 1);
-    ev_free(full_path);
+    int ret = _ev_udp_maybe_deferred_bind_unix(udp, AF_INET6, EV_UDP_REUSEADDR);
+    if (ret != 0)
+    {
+        return ret;
+    }
 
-    return helper->ret;
-}
+    struct group_source_req mreq;
+    if ((ret = _ev_udp_convert_source_interface_addr6_unix(
+             &mreq, interface_addr, multicast_addr, source_addr)) != 0)
+    {
+        return ret;
+    }
 
-/**
- * @brief Initialize a file handle
- * @param[in] loop      Event loop
- * @param[out] file     File handle
- * @return              #ev_errno_t
- */
-static int _ev_file_init(ev_loop_t* loop, ev_file_t* file)
-{
-    file->file = EV_OS_FILE_INVALID;
-    file->close_cb = NULL;
-    ev__handle_init(loop, &file->base, EV_ROLE_EV_FILE);
-    ev_list_init(&file->work_queue);
+    int optname = membership == EV_UDP_ENTER_GROUP ? MCAST_JOIN_SOURCE_GROUP
+                                                   : MCAST_LEAVE_SOURCE_GROUP;
+    if (setsockopt(udp->sock, IPPROTO_IPV6, optname, &mreq, sizeof(mreq)) != 0)
+    {
+        ret = errno;
+        return ev__translate_sys_error(ret);
+    }
 
     return 0;
 }
 
-static void _ev_file_close(ev_file_t* file)
+static int _ev_udp_set_ttl_unix(ev_udp_t *udp, int ttl, int option4,
+                                int option6)
 {
-    if (file->file != EV_OS_FILE_INVALID)
+    int level;
+    int option;
+    if (udp->base.data.flags & EV_HANDLE_UDP_IPV6)
     {
-        ev__fs_close(file->file);
-        file->file = EV_OS_FILE_INVALID;
+        level = IPPROTO_IPV6;
+        option = option6;
     }
-}
-
-void ev_file_close(ev_file_t* file, ev_file_close_cb cb)
-{
-    size_t failure_count;
-
-    if (file->base.loop == NULL)
+    else
     {
-        EV_ASSERT(cb == NULL, "operation in synchronous mode.");
-        _ev_file_close(file);
-        return;
+        level = IPPROTO_IP;
+        option = option4;
     }
 
-    /**
-     * Cancel all pending task. Do note that some tasks might be cancel failed
-     * as they are currently executing.
-     */
-    _ev_file_cancel_all_pending_task(file, &failure_count);
+    void     *optval = &ttl;
+    socklen_t optlen = sizeof(ttl);
 
     /**
-     * It should be safe to close handle, event there are some works in
-     * progress.
+     * On Solaris and derivatives such as SmartOS, the length of socket options
+     * is sizeof(int) for IPV6_MULTICAST_LOOP and sizeof(char) for
+     * IP_MULTICAST_LOOP, so hardcode the size of the option in the IPv6 case,
+     * and use the general uv__setsockopt_maybe_char call otherwise.
      */
-    _ev_file_close(file);
-
-    file->close_cb = cb;
+#if defined(__sun) || defined(_AIX) || defined(__OpenBSD__) ||                 \
+    defined(__MVS__) || defined(__QNX__)
+    char char_val = ttl;
+    if (!(udp->base.data.flags & EV_HANDLE_UDP_IPV6))
+    {
+        optval = &char_val;
+        optlen = sizeof(char_val);
+    }
+#endif
 
-    /**
-     * If all pending task was cancel, it is safe to close handle, because they
-     * are in the backlog queue.
-     */
-    if (failure_count == 0)
+    if (setsockopt(udp->sock, level, option, optval, optlen) != 0)
     {
-        ev__handle_exit(&file->base, _ev_file_on_close);
-        return;
+        int ret = errno;
+        return ev__translate_sys_error(ret);
     }
 
-    /**
-     * Now we have some problem, because some task is executing.
-     *
-     * We cannot close handle directly as these tasks will surely callback after
-     * this handle closed.
-     *
-     * So we have to check close status in file operations callback. Once no
-     * pending tasks, we can close this handle.
-     */
+    return 0;
 }
 
-int ev_file_open(ev_loop_t* loop, ev_file_t* file, ev_fs_req_t* token, const char* path,
-    int flags, int mode, ev_file_cb cb)
+EV_LOCAL int ev__udp_recv(ev_udp_t *udp, ev_udp_read_t *req)
 {
-    int ret;
-    if (cb == NULL)
-    {
-        if (loop != NULL || token != NULL)
-        {
-            return EV_EINVAL;
-        }
-        memset(file, 0, sizeof(*file));
-        return ev__fs_open(&file->file, path, flags, mode);
-    }
-
-    if ((ret = _ev_file_init(loop, file)) != 0)
+    (void)req;
+    if (udp->backend.rbatch != NULL || udp->backend.rring != NULL)
     {
-        return ret;
+        return EV_EBUSY;
     }
 
-    if ((ret = _ev_fs_init_req_as_open(token, file, path, flags, mode, cb)) != 0)
+    if (ev_list_size(&udp->recv_list) == 1)
     {
-        return ret;
+        ev__nonblock_io_add(udp->base.loop, &udp->backend.io, EPOLLIN);
     }
 
-    ev__handle_active(&file->base);
-
-    ret = ev__loop_submit_threadpool(loop, &token->work_token,
-        EV_THREADPOOL_WORK_IO_FAST, _ev_file_on_open, _ev_fs_on_done);
-    if (ret != 0)
-    {
-        _ev_fs_cleanup_req_as_open(token);
-        _ev_fs_smart_deactive(file);
-        return ret;
-    }
+    ev__handle_active(&udp->base);
 
     return 0;
 }
 
-int64_t ev_file_seek(ev_file_t* file, ev_fs_req_t* req, int whence, int64_t offset,
-    ev_file_cb cb)
+EV_LOCAL int ev__udp_send(ev_udp_t *udp, ev_udp_write_t *req,
+                          const struct sockaddr *addr, socklen_t addrlen)
 {
     int ret;
-    ev_loop_t* loop = file->base.loop;
-    if (loop == NULL)
+
+    if (addr == NULL)
     {
-        EV_ASSERT(cb == NULL, "operation in synchronous mode.");
-        return ev__fs_seek(file->file, whence, offset);
+        req->backend.peer_addr.ss_family = AF_UNSPEC;
     }
+    else
+    {
+        if ((ret = _ev_udp_maybe_deferred_bind_unix(udp, addr->sa_family, 0)) !=
+            0)
+        {
+            return ret;
+        }
 
-    _ev_fs_init_req_as_seek(req, file, whence, offset, cb);
-    ev__handle_active(&file->base);
+        if (addrlen == (socklen_t)-1)
+        {
+            return EV_EINVAL;
+        }
 
-    ret = ev__loop_submit_threadpool(loop, &req->work_token,
-        EV_THREADPOOL_WORK_IO_FAST, _ev_fs_on_seek, _ev_fs_on_done);
-    if (ret != 0)
+        memcpy(&req->backend.peer_addr, addr, addrlen);
+    }
+
+    if (ev_list_size(&udp->send_list) == 1)
     {
-        _ev_fs_smart_deactive(file);
-        return ret;
+        ev__nonblock_io_add(udp->base.loop, &udp->backend.io, EPOLLOUT);
     }
 
+    ev__handle_active(&udp->base);
+
     return 0;
 }
 
-ssize_t ev_file_read(ev_file_t* file, ev_fs_req_t* req, void* buff,
-    size_t size, ev_file_cb cb)
+static int _ev_udp_init_unix(ev_loop_t *loop, ev_udp_t *udp, int domain)
 {
-    ev_buf_t buf = ev_buf_make(buff, size);
-    return ev_file_readv(file, req, &buf, 1, cb);
-}
+    int err;
 
-ssize_t ev_file_readv(ev_file_t* file, ev_fs_req_t* req, ev_buf_t bufs[],
-    size_t nbuf, ev_file_cb cb)
-{
-    if (file->base.loop == NULL)
+    udp->sock = EV_OS_SOCKET_INVALID;
+    if (domain != AF_UNSPEC)
     {
-        EV_ASSERT(req == NULL && cb == NULL, "operation in synchronous mode.");
-        return ev__fs_readv(file->file, bufs, nbuf);
+        if ((err = _ev_udp_maybe_deferred_socket_unix(udp, domain)) != 0)
+        {
+            return err;
+        }
     }
 
-    return _ev_file_read_template(file, req, bufs, nbuf, 0, cb, _ev_file_on_read);
+    ev__handle_init(loop, &udp->base, EV_ROLE_EV_UDP);
+    ev_list_init(&udp->send_list);
+    ev_list_init(&udp->recv_list);
+    udp->backend.rbatch = NULL;
+    udp->backend.rring = NULL;
+    udp->backend.rmeta = NULL;
+
+    return 0;
 }
 
-ssize_t ev_file_pread(ev_file_t* file, ev_fs_req_t* req, void* buff,
-    size_t size, int64_t offset, ev_file_cb cb)
+size_t ev_udp_size(void)
 {
-    ev_buf_t buf = ev_buf_make(buff, size);
-    return ev_file_preadv(file, req, &buf, 1, offset, cb);
+    return sizeof(ev_udp_t);
 }
 
-ssize_t ev_file_preadv(ev_file_t* file, ev_fs_req_t* req, ev_buf_t bufs[],
-    size_t nbuf, int64_t offset, ev_file_cb cb)
+int ev_udp_init(ev_loop_t *loop, ev_udp_t **udp, int domain)
 {
-    if (file->base.loop == NULL)
+    int err;
+    if (domain != AF_INET && domain != AF_INET6 && domain != AF_UNSPEC)
     {
-        EV_ASSERT(req == NULL && cb == NULL, "operation in synchronous mode.");
-        return ev__fs_preadv(file->file, bufs, nbuf, offset);
+        return EV_EINVAL;
     }
 
-    return _ev_file_read_template(file, req, bufs, nbuf, offset, cb, _ev_file_on_pread);
-}
-
-ssize_t ev_file_write(ev_file_t* file, ev_fs_req_t* req, const void* data,
-    size_t size, ev_file_cb cb)
-{
-    ev_buf_t buf = ev_buf_make((void*)data, size);
-    return ev_file_writev(file, req, &buf, 1, cb);
-}
+    ev_udp_t *new_udp =
+        ev__loop_malloc(loop, EV_ALLOCATOR_TYPE_UDP, sizeof(ev_udp_t));
+    if (new_udp == NULL)
+    {
+        return EV_ENOMEM;
+    }
 
-ssize_t ev_file_writev(ev_file_t* file, ev_fs_req_t* req, ev_buf_t bufs[],
-    size_t nbuf, ev_file_cb cb)
-{
-    if (file->base.loop == NULL)
+    if ((err = _ev_udp_init_unix(loop, new_udp, domain)) != 0)
     {
-        EV_ASSERT(req == NULL && cb == NULL, "operation in synchronous mode.");
-        return ev__fs_writev(file->file, bufs, nbuf);
+        ev__loop_free(loop, new_udp);
+        return err;
     }
 
-    return _ev_file_pwrite_template(file, req, bufs, nbuf, 0, cb, _ev_file_on_write);
+    *udp = new_udp;
+    return 0;
 }
 
-ssize_t ev_file_pwrite(ev_file_t* file, ev_fs_req_t* req, const void* data,
-    size_t size, int64_t offset, ev_file_cb cb)
+int ev_udp_init_inplace(ev_loop_t *loop, ev_udp_t **udp, int domain, void *mem)
 {
-    ev_buf_t buf = ev_buf_make((void*)data, size);
-    return ev_file_pwritev(file, req, &buf, 1, offset, cb);
-}
+    int       err;
+    ev_udp_t *new_udp = mem;
+    if (domain != AF_INET && domain != AF_INET6 && domain != AF_UNSPEC)
+    {
+        return EV_EINVAL;
+    }
 
-ssize_t ev_file_pwritev(ev_file_t* file, ev_fs_req_t* req, ev_buf_t bufs[],
-    size_t nbuf, int64_t offset, ev_file_cb cb)
-{
-    if (file->base.loop == NULL)
+    if ((err = _ev_udp_init_unix(loop, new_udp, domain)) != 0)
     {
-        EV_ASSERT(req == NULL && cb == NULL, "operation in synchronous mode.");
-        return ev__fs_pwritev(file->file, bufs, nbuf, offset);
+        return err;
     }
-    return _ev_file_pwrite_template(file, req, bufs, nbuf, offset, cb, _ev_file_on_pwrite);
+    new_udp->base.data.flags |= EV_HANDLE_INPLACE;
+
+    *udp = new_udp;
+    return 0;
 }
 
-int ev_file_stat(ev_file_t* file, ev_fs_req_t* req, ev_fs_stat_t* stat, ev_file_cb cb)
+int ev_udp_open(ev_udp_t *udp, ev_os_socket_t sock)
 {
-    int ret;
-    ev_loop_t* loop = file->base.loop;
-    if (loop == NULL)
+    int err;
+    if (udp->sock != EV_OS_SOCKET_INVALID)
     {
-        EV_ASSERT(req == NULL && cb == NULL);
-        return ev__fs_fstat(file->file, stat);
+        return EV_EBUSY;
     }
 
-    _ev_fs_init_req_as_fstat(req, file, stat, cb);
-    ev__handle_active(&file->base);
+    if ((err = ev__nonblock(sock, 1)) != 0)
+    {
+        return err;
+    }
 
-    ret = ev__loop_submit_threadpool(loop, &req->work_token, EV_THREADPOOL_WORK_IO_FAST,
-        _ev_file_on_fstat, _ev_fs_on_done);
-    if (ret != 0)
+    if (_ev_udp_is_connected_unix(sock))
     {
-        _ev_fs_cleanup_req_as_fstat(req);
-        _ev_fs_smart_deactive(file);
-        return ret;
+        udp->base.data.flags |= EV_HANDLE_UDP_CONNECTED;
     }
 
     return 0;
 }
 
-ssize_t ev_fs_readdir(ev_loop_t* loop, ev_fs_req_t* req, const char* path,
-    ev_file_cb cb)
+void ev_udp_exit(ev_udp_t *udp, ev_udp_cb close_cb, void *close_arg)
 {
-    int ret;
-    if ((ret = _ev_fs_init_req_as_readdir(req, path, cb)) != 0)
-    {
-        return ret;
-    }
+    _ev_udp_close_unix(udp);
+    udp->close_cb = close_cb;
+    udp->close_arg = close_arg;
+    ev__handle_exit(&udp->base, _ev_udp_on_close_unix);
+}
 
-    if (cb == NULL)
+int ev_udp_bind(ev_udp_t *udp, const struct sockaddr *addr, unsigned flags)
+{
+    int       ret;
+    socklen_t addrlen = ev__get_addr_len(addr);
+    if (addrlen == (socklen_t)-1)
     {
-        EV_ASSERT(loop == NULL, "operation in synchronous mode.");
-
-        _ev_fs_readdir_sync(req);
-        if (req->result < 0)
-        {
-            ev_fs_req_cleanup(req);
-        }
-        return (ssize_t)req->result;
+        return EV_EINVAL;
     }
 
-    ret = ev__loop_submit_threadpool(loop, &req->work_token, EV_THREADPOOL_WORK_IO_FAST,
-        _ev_fs_on_readdir, _ev_fs_on_done);
-    if (ret != 0)
+    if ((ret = _ev_udp_maybe_deferred_socket_unix(udp, addr->sa_family)) != 0)
     {
-        _ev_fs_cleanup_req_as_readdir(req);
         return ret;
     }
 
-    return 0;
-}
-
-int64_t ev_fs_readfile(ev_loop_t* loop, ev_fs_req_t* req, const char* path,
-    ev_file_cb cb)
-{
-    int ret;
-    if ((ret = _ev_fs_init_req_as_readfile(req, path, cb)) != 0)
+    if ((ret = _ev_udp_set_flags_unix(udp, flags)) != 0)
     {
         return ret;
     }
-    if (cb == NULL)
-    {
-        EV_ASSERT(loop == NULL, "operation in synchronous mode.");
 
-        _ev_fs_readfile_sync(req);
-        if (req->result < 0)
+    if (bind(udp->sock, addr, addrlen) < 0)
+    {
+        ret = errno;
+        if (ret == EAFNOSUPPORT)
         {
-            ev_fs_req_cleanup(req);
+            return EV_EINVAL;
         }
-        return req->result;
+        return ev__translate_sys_error(ret);
     }
 
-    ret = ev__loop_submit_threadpool(loop, &req->work_token, EV_THREADPOOL_WORK_IO_FAST,
-        _ev_fs_on_readfile, _ev_fs_on_done);
-    if (ret != 0)
+    if (addr->sa_family == AF_INET6)
     {
-        _ev_fs_cleanup_req_as_readfile(req);
-        return ret;
+        udp->base.data.flags |= EV_HANDLE_UDP_IPV6;
     }
 
+    udp->base.data.flags |= EV_HANDLE_UDP_BOUND;
     return 0;
 }
 
-int ev_fs_mkdir(ev_loop_t* loop, ev_fs_req_t* req, const char* path, int mode,
-    ev_file_cb cb)
+int ev_udp_connect(ev_udp_t *udp, const struct sockaddr *addr)
 {
-    int ret;
-    if (cb == NULL)
+    if (addr == NULL)
     {
-        EV_ASSERT(loop == NULL && req == NULL, "operation in synchronous mode.");
-        return ev__fs_mkdir(path, mode);
+        if (!(udp->base.data.flags & EV_HANDLE_UDP_CONNECTED))
+        {
+            return EV_ENOTCONN;
+        }
+        return _ev_udp_disconnect_unix(udp);
     }
 
-    if ((ret = _ev_fs_init_req_as_mkdir(req, path, mode, cb)) != 0)
+    return _ev_udp_do_connect_unix(udp, addr);
+}
+
+int ev_udp_getsockname(ev_udp_t *udp, struct sockaddr *name, size_t *len)
+{
+    socklen_t wrap_len = *len;
+    if (getsockname(udp->sock, name, &wrap_len) != 0)
     {
-        return ret;
+        int err = errno;
+        return ev__translate_sys_error(err);
     }
 
-    ret = ev__loop_submit_threadpool(loop, &req->work_token, EV_THREADPOOL_WORK_IO_FAST,
-        _ev_fs_on_mkdir, _ev_fs_on_done);
-    if (ret != 0)
+    *len = wrap_len;
+    return 0;
+}
+
+int ev_udp_getpeername(ev_udp_t *udp, struct sockaddr *name, size_t *len)
+{
+    socklen_t wrap_len = *len;
+    if (getpeername(udp->sock, name, &wrap_len) != 0)
     {
-        _ev_fs_cleanup_req_as_mkdir(req);
-        return ret;
+        int err = errno;
+        return ev__translate_sys_error(err);
     }
 
+    *len = wrap_len;
     return 0;
 }
 
-int ev_fs_remove(ev_loop_t* loop, ev_fs_req_t* req, const char* path, int recursion, ev_file_cb cb)
+int ev_udp_recv_batch_start(ev_udp_t *udp, size_t batch, size_t msg_size,
+                            ev_udp_recv_batch_cb cb, void *arg)
 {
-    int ret;
-    if (cb == NULL)
+    size_t i;
+    if (udp->sock == EV_OS_SOCKET_INVALID)
     {
-        EV_ASSERT(loop == NULL && req == NULL, "operation in synchronous mode.");
-        return ev__fs_remove(path, recursion);
+        return EV_EPIPE;
+    }
+    if (batch == 0 || batch > UIO_MAXIOV || msg_size == 0)
+    {
+        return EV_EINVAL;
+    }
+    if (udp->backend.rbatch != NULL || udp->backend.rring != NULL ||
+        ev_list_size(&udp->recv_list) != 0)
+    {
+        return EV_EBUSY;
     }
 
-    if ((ret = _ev_fs_init_req_as_remove(req, path, recursion, cb)) != 0)
+    size_t unit_sz = sizeof(struct sockaddr_storage) + sizeof(struct mmsghdr) +
+                     sizeof(struct iovec) + sizeof(ev_udp_datagram_t) +
+                     sizeof(ev_udp_recv_cmsg_t) + sizeof(ev_udp_recv_info_t);
+    if (msg_size > (SIZE_MAX - sizeof(ev_udp_recv_batch_t)) / batch - unit_sz)
     {
-        return ret;
+        return EV_ENOMEM;
     }
 
-    ret = ev__loop_submit_threadpool(loop, &req->work_token, EV_THREADPOOL_WORK_IO_FAST,
-        _ev_fs_on_remove, _ev_fs_on_done);
-    if (ret != 0)
+    ev_udp_recv_batch_t *ctx =
+        ev__loop_malloc(udp->base.loop, EV_ALLOCATOR_TYPE_UDP,
+                        sizeof(ev_udp_recv_batch_t) +
+                            batch * (unit_sz + msg_size));
+    if (ctx == NULL)
     {
-        _ev_fs_cleanup_req_as_remove(req);
-        return ret;
+        return EV_ENOMEM;
     }
 
-    return 0;
-}
+    ctx->cb = cb;
+    ctx->arg = arg;
+    ctx->capacity = batch;
+    ctx->msg_size = msg_size;
+    ctx->busy = 0;
+    ctx->stopped = 0;
+    ctx->addrs = (struct sockaddr_storage *)(ctx + 1);
+    ctx->hdrs = (struct mmsghdr *)(ctx->addrs + batch);
+    ctx->iovs = (struct iovec *)(ctx->hdrs + batch);
+    ctx->msgs = (ev_udp_datagram_t *)(ctx->iovs + batch);
+    ctx->ctrls = (ev_udp_recv_cmsg_t *)(ctx->msgs + batch);
+    ctx->infos = (ev_udp_recv_info_t *)(ctx->ctrls + batch);
+    ctx->data = (uint8_t *)(ctx->infos + batch);
+
+    memset(ctx->hdrs, 0, sizeof(struct mmsghdr) * batch);
+    for (i = 0; i < batch; i++)
+    {
+        ctx->iovs[i].iov_base = ctx->data + i * msg_size;
+        ctx->iovs[i].iov_len = msg_size;
+        ctx->hdrs[i].msg_hdr.msg_name = &ctx->addrs[i];
+        ctx->hdrs[i].msg_hdr.msg_iov = &ctx->iovs[i];
+        ctx->hdrs[i].msg_hdr.msg_iovlen = 1;
+        ctx->hdrs[i].msg_hdr.msg_control = ctx->ctrls[i].buf;
+        ctx->msgs[i].addr = (struct sockaddr *)&ctx->addrs[i];
+        ctx->msgs[i].data = ctx->iovs[i].iov_base;
+        ctx->msgs[i].size = 0;
+        ctx->msgs[i].seg_size = 0;
+        ctx->msgs[i].info = NULL;
+    }
+
+    udp->backend.rbatch = ctx;
+    ev__nonblock_io_add(udp->base.loop, &udp->backend.io, EPOLLIN);
+    ev__handle_active(&udp->base);
 
-ev_fs_stat_t* ev_fs_get_statbuf(ev_fs_req_t* req)
-{
-    return req->rsp.stat;
+    return 0;
 }
 
-void ev_fs_req_cleanup(ev_fs_req_t* req)
+int ev_udp_recv_batch_stop(ev_udp_t *udp)
 {
-    switch (req->req_type)
+    if (udp->backend.rbatch == NULL)
     {
-    case EV_FS_REQ_OPEN:
-        _ev_fs_cleanup_req_as_open(req);
-        break;
+        return EV_ENOENT;
+    }
 
-    case EV_FS_REQ_SEEK:
-        _ev_fs_cleanup_req_as_seek(req);
-        break;
+    _ev_udp_recv_batch_detach_unix(udp);
+    if (udp->sock != EV_OS_SOCKET_INVALID)
+    {
+        ev__nonblock_io_del(udp->base.loop, &udp->backend.io, EPOLLIN);
+    }
+    _ev_udp_smart_deactive(udp);
 
-    case EV_FS_REQ_READ:
-        _ev_fs_cleanup_req_as_read(req);
-        break;
+    return 0;
+}
 
-    case EV_FS_REQ_WRITE:
-        _ev_fs_cleanup_req_as_write(req);
-        break;
+int ev_udp_recv_start(ev_udp_t *udp, size_t nbuf, size_t buf_size,
+                      ev_udp_recv_ring_cb cb, void *arg)
+{
+    size_t i;
+    if (udp->sock == EV_OS_SOCKET_INVALID)
+    {
+        return EV_EPIPE;
+    }
+    if (nbuf == 0 || buf_size == 0)
+    {
+        return EV_EINVAL;
+    }
+    /* A stopped ring is busy until all buffers are returned */
+    if (udp->backend.rbatch != NULL || udp->backend.rring != NULL ||
+        ev_list_size(&udp->recv_list) != 0)
+    {
+        return EV_EBUSY;
+    }
+    if (buf_size > (SIZE_MAX - sizeof(ev_udp_recv_ring_t)) / nbuf -
+                       sizeof(ev_udp_recv_slot_t))
+    {
+        return EV_ENOMEM;
+    }
 
-    case EV_FS_REQ_FSTAT:
-        _ev_fs_cleanup_req_as_fstat(req);
-        break;
+    ev_udp_recv_ring_t *ring = ev__loop_malloc(
+        udp->base.loop, EV_ALLOCATOR_TYPE_UDP,
+        sizeof(ev_udp_recv_ring_t) +
+            nbuf * (sizeof(ev_udp_recv_slot_t) + buf_size));
+    if (ring == NULL)
+    {
+        return EV_ENOMEM;
+    }
 
-    case EV_FS_REQ_READDIR:
-        _ev_fs_cleanup_req_as_readdir(req);
-        break;
+    ring->cb = cb;
+    ring->arg = arg;
+    ring->buf_size = buf_size;
+    ring->borrowed = 0;
+    ring->busy = 0;
+    ring->stopped = 0;
+    ev_list_init(&ring->free_list);
 
-    case EV_FS_REQ_READFILE:
-        _ev_fs_cleanup_req_as_readfile(req);
-        break;
+    ev_udp_recv_slot_t *slots = (ev_udp_recv_slot_t *)(ring + 1);
+    uint8_t            *data = (uint8_t *)(slots + nbuf);
+    for (i = 0; i < nbuf; i++)
+    {
+        slots[i].msg.addr = (struct sockaddr *)&slots[i].addr;
+        slots[i].msg.data = data + i * buf_size;
+        slots[i].msg.size = 0;
+        slots[i].msg.seg_size = 0;
+        slots[i].msg.info = NULL;
+        ev_list_push_back(&ring->free_list, &slots[i].node);
+    }
 
-    case EV_FS_REQ_MKDIR:
-        _ev_fs_cleanup_req_as_mkdir(req);
-        break;
+    udp->backend.rring = ring;
+    ev__nonblock_io_add(udp->base.loop, &udp->backend.io, EPOLLIN);
+    ev__handle_active(&udp->base);
 
-    default:
-        EV_ABORT("req:%d", req->req_type);
-    }
+    return 0;
 }
 
-ev_file_t* ev_fs_get_file(ev_fs_req_t* req)
+int ev_udp_recv_stop(ev_udp_t *udp)
 {
-    return req->file;
-}
+    ev_udp_recv_ring_t *ring = udp->backend.rring;
+    if (ring == NULL || ring->stopped)
+    {
+        return EV_ENOENT;
+    }
 
-ev_dirent_t* ev_fs_get_first_dirent(ev_fs_req_t* req)
-{
-    ev_list_node_t* it = ev_list_begin(&req->rsp.dirents);
-    if (it == NULL)
+    ring->stopped = 1;
+    if (udp->sock != EV_OS_SOCKET_INVALID)
     {
-        return NULL;
+        ev__nonblock_io_del(udp->base.loop, &udp->backend.io, EPOLLIN);
     }
+    _ev_udp_smart_deactive(udp);
+    _ev_udp_recv_ring_try_free_unix(udp);
 
-    ev_dirent_record_t* rec = EV_CONTAINER_OF(it, ev_dirent_record_t, node);
-    return &rec->data;
+    return 0;
 }
 
-ev_dirent_t* ev_fs_get_next_dirent(ev_dirent_t* curr)
+void ev_udp_recv_release(ev_udp_t *udp, ev_udp_datagram_t *msg)
 {
-    if (curr == NULL)
+    ev_udp_recv_ring_t *ring = udp->backend.rring;
+    ev_udp_recv_slot_t *slot = EV_CONTAINER_OF(msg, ev_udp_recv_slot_t, msg);
+
+    if (ring == NULL)
     {
-        return NULL;
+        /* Handle is closed, buffer is already released */
+        return;
     }
 
-    ev_dirent_record_t* rec = EV_CONTAINER_OF(curr, ev_dirent_record_t, data);
+    ev_list_push_back(&ring->free_list, &slot->node);
+    ring->borrowed--;
 
-    ev_list_node_t* next_node = ev_list_next(&rec->node);
-    if (next_node == NULL)
+    if (ring->stopped)
     {
-        return NULL;
+        _ev_udp_recv_ring_try_free_unix(udp);
+        return;
     }
 
-    ev_dirent_record_t* next_rec = EV_CONTAINER_OF(next_node, ev_dirent_record_t, node);
-    return &next_rec->data;
+    /* Ring was exhausted, resume reading */
+    if (ev_list_size(&ring->free_list) == 1 &&
+        udp->sock != EV_OS_SOCKET_INVALID)
+    {
+        ev__nonblock_io_add(udp->base.loop, &udp->backend.io, EPOLLIN);
+    }
 }
 
-ev_buf_t* ev_fs_get_filecontent(ev_fs_req_t* req)
+/**
+ * @brief Toggle socket option for one #ev_udp_recv_info_flags_t.
+ */
+static int _ev_udp_set_recv_info_opt_unix(ev_udp_t *udp, int family,
+                                          unsigned flag, unsigned flags)
 {
-    return &req->rsp.filecontent;
+    int level = SOL_SOCKET;
+    int optname;
+    int on = (flags & flag) != 0;
+
+    switch (flag)
+    {
+    case EV_UDP_RECV_PKTINFO:
+        if (family == AF_INET6)
+        {
+            level = IPPROTO_IPV6;
+            optname = IPV6_RECVPKTINFO;
+        }
+        else
+        {
+            level = IPPROTO_IP;
+            optname = IP_PKTINFO;
+        }
+        break;
+#if defined(SO_TIMESTAMPNS)
+    case EV_UDP_RECV_TIMESTAMP:
+        optname = SO_TIMESTAMPNS;
+        break;
+#endif
+#if defined(SO_RXQ_OVFL)
+    case EV_UDP_RECV_DROPS:
+        optname = SO_RXQ_OVFL;
+        break;
+#endif
+    default:
+        return on ? EV_ENOSYS : 0;
+    }
+
+    if (setsockopt(udp->sock, level, optname, &on, sizeof(on)) != 0)
+    {
+        int err = errno;
+        return ev__translate_sys_error(err);
+    }
+    return 0;
 }
 
-EV_LOCAL int ev__fs_remove(const char* path, int recursive)
+int ev_udp_set_recv_info(ev_udp_t *udp, unsigned flags)
 {
-    int ret;
+    int                     ret;
+    unsigned                flag, prev;
+    struct sockaddr_storage addr;
+    socklen_t               addr_len = sizeof(addr);
+    unsigned                all =
+        EV_UDP_RECV_PKTINFO | EV_UDP_RECV_TIMESTAMP | EV_UDP_RECV_DROPS;
 
-    struct stat buf;
-    if (stat(path, &buf) != 0)
+    if (flags & ~all)
     {
-        ret = errno;
-        return ev__translate_sys_error(ret);
+        return EV_EINVAL;
     }
-
-    if (!S_ISDIR(buf.st_mode) || !recursive)
+    if (udp->sock == EV_OS_SOCKET_INVALID)
     {
-        goto finish;
+        return EV_EBADF;
     }
 
-    fs_remove_helper_t helper;
-    helper.parent_path = path;
-    helper.ret = 0;
+    /* Handle flags only know the family of addresses passed to bind */
+    if (getsockname(udp->sock, (struct sockaddr *)&addr, &addr_len) != 0)
+    {
+        int err = errno;
+        return ev__translate_sys_error(err);
+    }
 
-    if ((ret = ev__fs_readdir(path, _ev_fs_remove_helper, &helper)) != 0)
+    if (udp->backend.rmeta == NULL)
     {
-        return helper.ret;
+        if (flags == 0)
+        {
+            return 0;
+        }
+        udp->backend.rmeta = ev__loop_malloc(
+            udp->base.loop, EV_ALLOCATOR_TYPE_UDP, sizeof(ev_udp_recv_meta_t));
+        if (udp->backend.rmeta == NULL)
+        {
+            return EV_ENOMEM;
+        }
+        udp->backend.rmeta->flags = 0;
     }
 
-finish:
-    return _ev_fs_remove(path);
-}
+    prev = udp->backend.rmeta->flags;
+    for (flag = EV_UDP_RECV_PKTINFO; flag <= EV_UDP_RECV_DROPS; flag <<= 1)
+    {
+        ret = _ev_udp_set_recv_info_opt_unix(udp, addr.ss_family, flag, flags);
+        if (ret != 0)
+        {
+            goto err_rollback;
+        }
+    }
 
-// #line 94 "ev.c"
-////////////////////////////////////////////////////////////////////////////////
-// FILE:    ev/handle.c
-// SIZE:    3642
-// SHA-256: 37cc134812484bb50e8ae6ae2b4204095f1c3fec79b22675a03976bac920058b
-////////////////////////////////////////////////////////////////////////////////
-// #line 1 "ev/handle.c"
-#include <assert.h>
+    udp->backend.rmeta->flags = flags;
+    return 0;
 
-/**
- * @brief Set handle as inactive.
- * @param[in] handle    handler
- */
-EV_LOCAL void ev__handle_deactive(ev_handle_t* handle)
-{
-    if (!(handle->data.flags & EV_HANDLE_ACTIVE))
+err_rollback:
+    while ((flag >>= 1) >= EV_UDP_RECV_PKTINFO)
     {
-        return;
+        _ev_udp_set_recv_info_opt_unix(udp, addr.ss_family, flag, prev);
     }
-    handle->data.flags &= ~EV_HANDLE_ACTIVE;
-
-    ev_loop_t* loop = handle->loop;
-    ev_list_erase(&loop->handles.active_list, &handle->handle_queue);
-    ev_list_push_back(&loop->handles.idle_list, &handle->handle_queue);
+    return ret;
 }
 
-/**
- * @brief Force set handle as active.
- * @param[in] handle    handler
- */
-EV_LOCAL void ev__handle_active(ev_handle_t* handle)
+const ev_udp_recv_info_t *ev_udp_recv_info(ev_udp_t *udp)
 {
-    if (handle->data.flags & EV_HANDLE_ACTIVE)
+    if (_ev_udp_recv_info_flags_unix(udp) == 0)
     {
-        return;
+        return NULL;
     }
-    handle->data.flags |= EV_HANDLE_ACTIVE;
-
-    ev_loop_t* loop = handle->loop;
-    ev_list_erase(&loop->handles.idle_list, &handle->handle_queue);
-    ev_list_push_back(&loop->handles.active_list, &handle->handle_queue);
+    return &udp->backend.rmeta->info;
 }
 
-static void _ev_to_close_handle(ev_handle_t* handle)
+static int _ev_udp_opt_native_unix(ev_udp_t *udp, ev_udp_opt_t opt,
+                                   int *level, int *name)
 {
-    /**
-     * Deactive but not reset #ev_handle_t::data::active_events, for debug
-     * purpose.
-     * The #ev_handle_t::data::active_events should be zero by now.
-     */
-    ev__handle_deactive(handle);
-
-    handle->data.flags |= EV_HANDLE_CLOSED;
-    ev_list_erase(&handle->loop->handles.idle_list, &handle->handle_queue);
-
-    handle->endgame.close_cb(handle);
+    *level = SOL_SOCKET;
+    switch (opt)
+    {
+    case EV_UDP_OPT_SNDBUF:
+        *name = SO_SNDBUF;
+        return 0;
+    case EV_UDP_OPT_RCVBUF:
+        *name = SO_RCVBUF;
+        return 0;
+#if defined(SO_SNDBUFFORCE)
+    case EV_UDP_OPT_SNDBUFFORCE:
+        *name = SO_SNDBUFFORCE;
+        return 0;
+#endif
+#if defined(SO_RCVBUFFORCE)
+    case EV_UDP_OPT_RCVBUFFORCE:
+        *name = SO_RCVBUFFORCE;
+        return 0;
+#endif
+    case EV_UDP_OPT_TOS:
+        if (udp->base.data.flags & EV_HANDLE_UDP_IPV6)
+        {
+            *level = IPPROTO_IPV6;
+            *name = IPV6_TCLASS;
+        }
+        else
+        {
+            *level = IPPROTO_IP;
+            *name = IP_TOS;
+        }
+        return 0;
+    default:
+        return EV_ENOSYS;
+    }
 }
 
-EV_LOCAL void ev__handle_init(ev_loop_t* loop, ev_handle_t* handle, ev_role_t role)
+int ev_udp_setopt(ev_udp_t *udp, ev_udp_opt_t opt, int val)
 {
-    handle->loop = loop;
-    ev_list_push_back(&loop->handles.idle_list, &handle->handle_queue);
-
-    handle->data.role = role;
-    handle->data.flags = 0;
-
-    handle->backlog.status = EV_ENOENT;
-    handle->backlog.cb = NULL;
-    handle->backlog.node = (ev_list_node_t)EV_LIST_NODE_INIT;
+    int ret, level, name;
+    if ((ret = _ev_udp_opt_native_unix(udp, opt, &level, &name)) != 0)
+    {
+        return ret;
+    }
 
-    handle->endgame.close_cb = NULL;
-    handle->endgame.node = (ev_list_node_t)EV_LIST_NODE_INIT;
+    if (setsockopt(udp->sock, level, name, &val, sizeof(val)) != 0)
+    {
+        ret = errno;
+        return ev__translate_sys_error(ret);
+    }
+    return 0;
 }
 
-EV_LOCAL void ev__handle_exit(ev_handle_t* handle, ev_handle_cb close_cb)
+int ev_udp_getopt(ev_udp_t *udp, ev_udp_opt_t opt, int *val)
 {
-    assert(!ev__handle_is_closing(handle));
-
-    handle->data.flags |= EV_HANDLE_CLOSING;
-    handle->endgame.close_cb = close_cb;
+    int ret, level, name;
+    if ((ret = _ev_udp_opt_native_unix(udp, opt, &level, &name)) != 0)
+    {
+        return ret;
+    }
 
-    if (close_cb != NULL)
+    /* Read back the effective value */
+    if (opt == EV_UDP_OPT_SNDBUFFORCE)
     {
-        ev_list_push_back(&handle->loop->endgame_queue, &handle->endgame.node);
+        name = SO_SNDBUF;
     }
-    else
+    else if (opt == EV_UDP_OPT_RCVBUFFORCE)
     {
-        ev__handle_deactive(handle);
-        handle->data.flags |= EV_HANDLE_CLOSED;
-        ev_list_erase(&handle->loop->handles.idle_list, &handle->handle_queue);
+        name = SO_RCVBUF;
     }
-}
-
-EV_LOCAL int ev__handle_is_active(ev_handle_t* handle)
-{
-    return handle->data.flags & EV_HANDLE_ACTIVE;
-}
 
-EV_LOCAL int ev__handle_is_closing(ev_handle_t* handle)
-{
-    return handle->data.flags & (EV_HANDLE_CLOSING | EV_HANDLE_CLOSED);
+    socklen_t len = sizeof(*val);
+    if (getsockopt(udp->sock, level, name, val, &len) != 0)
+    {
+        ret = errno;
+        return ev__translate_sys_error(ret);
+    }
+    return 0;
 }
 
-EV_LOCAL int ev__backlog_submit(ev_handle_t* handle, ev_handle_cb callback)
+int ev_udp_set_reuseport_cbpf(ev_udp_t *udp, const void *insns, size_t ninsn)
 {
-    if (handle->backlog.status != EV_ENOENT)
+    if (insns == NULL || ninsn == 0 || ninsn > USHRT_MAX)
     {
-        return EV_EEXIST;
+        return EV_EINVAL;
     }
 
-    handle->backlog.status = EV_EEXIST;
-    handle->backlog.cb = callback;
-
-    ev_list_push_back(&handle->loop->backlog_queue, &handle->backlog.node);
+#if defined(SO_ATTACH_REUSEPORT_CBPF)
+    struct sock_fprog prog;
+    prog.len = (unsigned short)ninsn;
+    prog.filter = (struct sock_filter *)insns;
 
+    if (setsockopt(udp->sock, SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &prog,
+                   sizeof(prog)) != 0)
+    {
+        int err = errno;
+        return ev__translate_sys_error(err);
+    }
     return 0;
+#else
+    (void)udp;
+    return EV_ENOSYS;
+#endif
 }
 
-EV_LOCAL size_t ev__process_backlog(ev_loop_t* loop)
+int ev_udp_set_reuseport_cpu(ev_udp_t *udp, unsigned group_size)
 {
-    ev_list_node_t* it;
-    size_t active_count = 0;
-
-    while ((it = ev_list_pop_front(&loop->backlog_queue)) != NULL)
+    if (group_size == 0)
     {
-        ev_handle_t* handle = EV_CONTAINER_OF(it, ev_handle_t, backlog.node);
+        return EV_EINVAL;
+    }
 
-        handle->backlog.status = EV_ENOENT;
+#if defined(SO_ATTACH_REUSEPORT_CBPF)
+    struct sock_filter insns[] = {
+        /* A = current CPU */
+        { BPF_LD | BPF_W | BPF_ABS, 0, 0, (uint32_t)(SKF_AD_OFF + SKF_AD_CPU) },
+        /* A = A % group_size */
+        { BPF_ALU | BPF_MOD | BPF_K, 0, 0, group_size },
+        /* return A */
+        { BPF_RET | BPF_A, 0, 0, 0 },
+    };
+    return ev_udp_set_reuseport_cbpf(udp, insns, ARRAY_SIZE(insns));
+#else
+    (void)udp;
+    return EV_ENOSYS;
+#endif
+}
 
-        handle->backlog.cb(handle);
-        active_count++;
+int ev_udp_set_gro(ev_udp_t *udp, int on)
+{
+#if defined(UDP_GRO)
+    if (setsockopt(udp->sock, SOL_UDP, UDP_GRO, &on, sizeof(on)) != 0)
+    {
+        int err = errno;
+        return err == ENOPROTOOPT ? EV_ENOSYS : ev__translate_sys_error(err);
     }
-
-    return active_count;
+    return 0;
+#else
+    (void)on;
+    return EV_ENOSYS;
+#endif
 }
 
-EV_LOCAL size_t ev__process_endgame(ev_loop_t* loop)
+int ev_udp_set_membership(ev_udp_t *udp, const char *multicast_addr,
+                          const char         *interface_addr,
+                          ev_udp_membership_t membership)
 {
-    ev_list_node_t* it;
-    size_t active_count = 0;
+    int                     ret;
+    struct sockaddr_storage addr;
 
-    while ((it = ev_list_pop_front(&loop->endgame_queue)) != NULL)
+    if (membership != EV_UDP_LEAVE_GROUP && membership != EV_UDP_ENTER_GROUP)
     {
-        ev_handle_t* handle = EV_CONTAINER_OF(it, ev_handle_t, endgame.node);
-        _ev_to_close_handle(handle);
-        active_count++;
+        return EV_EINVAL;
     }
 
-    return active_count;
-}
+    struct sockaddr_in *addr_4 = (struct sockaddr_in *)&addr;
+    memset(addr_4, 0, sizeof(*addr_4));
 
-// #line 95 "ev.c"
-////////////////////////////////////////////////////////////////////////////////
-// FILE:    ev/list.c
-// SIZE:    3572
-// SHA-256: 5ca5df3a7fcd1e63840867dc5f2eccbbe2ec19a00174d27dc715130cdf87f5bd
-////////////////////////////////////////////////////////////////////////////////
-// #line 1 "ev/list.c"
-#include <string.h>
+    if (ev_ipv4_addr(multicast_addr, 0, addr_4) == 0)
+    {
+        if ((ret = _ev_udp_maybe_deferred_bind_unix(udp, AF_INET,
+                                                    EV_UDP_REUSEADDR)) != 0)
+        {
+            return ret;
+        }
 
-static void _list_lite_set_once(ev_list_t* handler, ev_list_node_t* node)
-{
-    handler->head = node;
-    handler->tail = node;
-    node->p_after = NULL;
-    node->p_before = NULL;
-    handler->size = 1;
-}
+        return _ev_udp_setmembership4_unix(udp, addr_4, interface_addr,
+                                           membership);
+    }
 
-void ev_list_init(ev_list_t* handler)
-{
-    memset(handler, 0, sizeof(*handler));
-}
+    struct sockaddr_in6 *addr_6 = (struct sockaddr_in6 *)&addr;
+    memset(addr_6, 0, sizeof(*addr_6));
 
-void ev_list_push_back(ev_list_t* handler, ev_list_node_t* node)
-{
-    if (handler->head == NULL)
+    if (ev_ipv6_addr(multicast_addr, 0, addr_6) == 0)
     {
-        _list_lite_set_once(handler, node);
-        return;
+        if ((ret = _ev_udp_maybe_deferred_bind_unix(udp, AF_INET6,
+                                                    EV_UDP_REUSEADDR)) != 0)
+        {
+            return ret;
+        }
+
+        return _ev_udp_setmembership6_unix(udp, addr_6, interface_addr,
+                                           membership);
     }
 
-    node->p_after = NULL;
-    node->p_before = handler->tail;
-    handler->tail->p_after = node;
-    handler->tail = node;
-    handler->size++;
+    return EV_EINVAL;
 }
 
-void ev_list_insert_before(ev_list_t* handler, ev_list_node_t* pos, ev_list_node_t* node)
+int ev_udp_set_source_membership(ev_udp_t *udp, const char *multicast_addr,
+                                 const char         *interface_addr,
+                                 const char         *source_addr,
+                                 ev_udp_membership_t membership)
 {
-    if (handler->head == pos)
+    int                     ret;
+    struct sockaddr_storage mcast_addr;
+    struct sockaddr_storage src_addr;
+
+    if (membership != EV_UDP_LEAVE_GROUP && membership != EV_UDP_ENTER_GROUP)
     {
-        ev_list_push_front(handler, node);
-        return;
+        return EV_EINVAL;
     }
 
-    node->p_before = pos->p_before;
-    node->p_after = pos;
-    pos->p_before->p_after = node;
-    pos->p_before = node;
-    handler->size++;
-}
-
-void ev_list_insert_after(ev_list_t* handler,  ev_list_node_t* pos, ev_list_node_t* node)
-{
-    if (handler->tail == pos)
+    struct sockaddr_in *mcast_addr_4 = (struct sockaddr_in *)&mcast_addr;
+    if ((ret = ev_ipv4_addr(multicast_addr, 0, mcast_addr_4)) == 0)
     {
-        ev_list_push_back(handler, node);
-        return;
-    }
+        struct sockaddr_in *src_addr_4 = (struct sockaddr_in *)&src_addr;
+        if ((ret = ev_ipv4_addr(source_addr, 0, src_addr_4)) != 0)
+        {
+            return ret;
+        }
 
-    node->p_before = pos;
-    node->p_after = pos->p_after;
-    pos->p_after->p_before = node;
-    pos->p_after = node;
-    handler->size++;
-}
+        return _ev_udp_set_source_membership4_unix(
+            udp, mcast_addr_4, interface_addr, src_addr_4, membership);
+    }
 
-void ev_list_push_front(ev_list_t* handler, ev_list_node_t* node)
-{
-    if (handler->head == NULL)
+    struct sockaddr_in6 *mcast_addr_6 = (struct sockaddr_in6 *)&mcast_addr;
+    if ((ret = ev_ipv6_addr(multicast_addr, 0, mcast_addr_6)) == 0)
     {
-        _list_lite_set_once(handler, node);
-        return;
+        struct sockaddr_in6 *src_addr_6 = (struct sockaddr_in6 *)&src_addr;
+        if ((ret = ev_ipv6_addr(source_addr, 0, src_addr_6)) != 0)
+        {
+            return ret;
+        }
+
+        return _ev_udp_set_source_membership6_unix(
+            udp, mcast_addr_6, interface_addr, src_addr_6, membership);
     }
 
-    node->p_before = NULL;
-    node->p_after = handler->head;
-    handler->head->p_before = node;
-    handler->head = node;
-    handler->size++;
+    return ret;
 }
 
-ev_list_node_t* ev_list_begin(const ev_list_t* handler)
+int ev_udp_set_multicast_loop(ev_udp_t *udp, int on)
 {
-    return handler->head;
+    return _ev_udp_set_ttl_unix(udp, on, IP_MULTICAST_LOOP,
+                                IPV6_MULTICAST_LOOP);
 }
 
-ev_list_node_t* ev_list_end(const ev_list_t* handler)
+int ev_udp_set_multicast_ttl(ev_udp_t *udp, int ttl)
 {
-    return handler->tail;
+    return _ev_udp_set_ttl_unix(udp, ttl, IP_MULTICAST_TTL,
+                                IPV6_MULTICAST_HOPS);
 }
 
-ev_list_node_t* ev_list_next(const ev_list_node_t* node)
+int ev_udp_set_multicast_interface(ev_udp_t *udp, const char *interface_addr)
 {
-    return node->p_after;
-}
+    int                     ret;
+    struct sockaddr_storage addr_st;
+    struct sockaddr_in     *addr_4 = (struct sockaddr_in *)&addr_st;
+    struct sockaddr_in6    *addr_6 = (struct sockaddr_in6 *)&addr_st;
 
-ev_list_node_t* ev_list_prev(const ev_list_node_t* node)
-{
-    return node->p_before;
-}
+    int is_ipv6 = udp->base.data.flags & EV_HANDLE_UDP_IPV6;
+    if ((ret = ev__udp_interface_addr_to_sockaddr(&addr_st, interface_addr,
+                                                  is_ipv6)) != 0)
+    {
+        return ret;
+    }
 
-void ev_list_erase(ev_list_t* handler, ev_list_node_t* node)
-{
-    handler->size--;
+    int       level;
+    int       optname;
+    void     *optval;
+    socklen_t optlen;
 
-    /* Only one node */
-    if (handler->head == node && handler->tail == node)
+    if (addr_st.ss_family == AF_INET)
     {
-        handler->head = NULL;
-        handler->tail = NULL;
-        goto fin;
+        level = IPPROTO_IP;
+        optname = IP_MULTICAST_IF;
+        optval = &addr_4->sin_addr;
+        optlen = sizeof(addr_4->sin_addr);
     }
-
-    if (handler->head == node)
+    else if (addr_st.ss_family == AF_INET6)
     {
-        node->p_after->p_before = NULL;
-        handler->head = node->p_after;
-        goto fin;
+        level = IPPROTO_IPV6;
+        optname = IPV6_MULTICAST_IF;
+        optval = &addr_6->sin6_scope_id;
+        optlen = sizeof(addr_6->sin6_scope_id);
     }
-
-    if (handler->tail == node)
+    else
     {
-        node->p_before->p_after = NULL;
-        handler->tail = node->p_before;
-        goto fin;
+        EV_ABORT();
     }
 
-    node->p_before->p_after = node->p_after;
-    node->p_after->p_before = node->p_before;
-
-fin:
-    node->p_after = NULL;
-    node->p_before = NULL;
-}
-
-ev_list_node_t* ev_list_pop_front(ev_list_t* handler)
-{
-    ev_list_node_t* node = handler->head;
-    if (node == NULL)
+    if (setsockopt(udp->sock, level, optname, optval, optlen) != 0)
     {
-        return NULL;
+        ret = errno;
+        return ev__translate_sys_error(ret);
     }
 
-    ev_list_erase(handler, node);
-    return node;
+    return 0;
 }
 
-ev_list_node_t* ev_list_pop_back(ev_list_t* handler)
+int ev_udp_set_broadcast(ev_udp_t *udp, int on)
 {
-    ev_list_node_t* node = handler->tail;
-    if (node == NULL)
+    int err;
+    if (setsockopt(udp->sock, SOL_SOCKET, SO_BROADCAST, &on, sizeof(on)) != 0)
     {
-        return NULL;
+        err = errno;
+        return ev__translate_sys_error(err);
     }
 
-    ev_list_erase(handler, node);
-    return node;
-}
-
-size_t ev_list_size(const ev_list_t* handler)
-{
-    return handler->size;
+    return 0;
 }
 
-void ev_list_migrate(ev_list_t* dst, ev_list_t* src)
+int ev_udp_set_ttl(ev_udp_t *udp, int ttl)
 {
-    if (src->head == NULL)
+    if (ttl < 1 || ttl > 255)
     {
-        return;
+        return EV_EINVAL;
     }
 
-    if (dst->tail == NULL)
-    {
-        *dst = *src;
-    }
-    else
+#if defined(__MVS__)
+    /* zOS does not support setting ttl for IPv4 */
+    if (!(udp->base.data.flags & EV_HANDLE_UDP_IPV6))
     {
-        dst->tail->p_after = src->head;
-        dst->tail->p_after->p_before = dst->tail;
-        dst->tail = src->tail;
-        dst->size += src->size;
+        return EV_ENOTSUP;
     }
+#endif
 
-    src->head = NULL;
-    src->tail = NULL;
-    src->size = 0;
+    return _ev_udp_set_ttl_unix(udp, ttl, IP_TTL, IPV6_UNICAST_HOPS);
 }
 
-// #line 96 "ev.c"
+// #line 94 "ev.c"
+
+#endif
+
 ////////////////////////////////////////////////////////////////////////////////
-// FILE:    ev/log.c
-// SIZE:    1941
-// SHA-256: 43253f4df061cdd0745b3c136d51bab8120c246e48fb7c8878ecf0e1cc18bbb8
+// FILE:    ev/assert.c
+// SIZE:    384
+// SHA-256: f8987454a05572d8a74466a1c47c51b6de945dbec63aa5d118450aa64e7c81e8
 ////////////////////////////////////////////////////////////////////////////////
-// #line 1 "ev/log.c"
-#include <stdarg.h>
-#include <stdio.h>
+// #line 1 "ev/assert.c"
 
-static const char* _ev_filename(const char* file)
+EV_LOCAL void ev__assertion_failure(const char* exp, const char* file, int line, const char* fmt, ...)
 {
-    const char* pos = file;
-
-    for (; *file; ++file)
+    fprintf(stderr, "%s:%d: Assertion failed: %s", file, line, exp);
+    if (fmt != NULL)
     {
-        if (*file == '\\' || *file == '/')
-        {
-            pos = file + 1;
-        }
+        fprintf(stderr, ": ");
+
+        va_list ap;
+        va_start(ap, fmt);
+        vfprintf(stderr, fmt, ap);
+        va_end(ap);
     }
-    return pos;
+    fprintf(stderr, "\n");
+    abort();
 }
 
-static char _ev_ascii_to_char(unsigned char c)
+// #line 98 "ev.c"
+////////////////////////////////////////////////////////////////////////////////
+// FILE:    ev/allocator.c
+// SIZE:    6039
+// SHA-256: 50327976abeac5ff70064dc48609b6a9aa3252c8f8a6cada12a5f50e47c5fcae
+////////////////////////////////////////////////////////////////////////////////
+// #line 1 "ev/allocator.c"
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(EV_ALLOCATOR_STAT)
+
+/**
+ * @brief Header in front of every chunk when statistics is enabled.
+ */
+typedef union ev_allocator_hdr
 {
-    if (c >= 32 && c <= 126)
+    struct
     {
-        return c;
-    }
-    return '.';
-}
+        size_t              size; /**< User visible size */
+        ev_allocator_type_t type; /**< Memory category */
+    } data;
 
-EV_LOCAL void ev__log(ev_log_level_t level, const char* file, const char* func,
-    int line, const char* fmt, ...)
+    /* Keep user memory suitably aligned for any type. */
+    long double align_ld;
+    void       *align_ptr;
+    uint64_t    align_u64;
+} ev_allocator_hdr_t;
+
+typedef struct ev_allocator_counter
 {
-    va_list ap;
-    va_start(ap, fmt);
+    ev_atomic64_t live_bytes;
+    ev_atomic64_t peak_bytes;
+    ev_atomic64_t alloc_count;
+    ev_atomic64_t realloc_count;
+    ev_atomic64_t free_count;
+} ev_allocator_counter_t;
 
-    const char* prefix;
-    switch (level)
-    {
-    case EV_LOG_INFO:
-        prefix = "I";
-        break;
-    case EV_LOG_ERROR:
-        prefix = "E";
-        break;
-    case EV_LOG_FATAL:
-        prefix = "F";
-        break;
-    default:
-        prefix = "T";
-        break;
-    }
+static ev_allocator_counter_t s_allocator_counter[EV_ALLOCATOR_TYPE_MAX];
 
-    printf("[%s %s:%d %s] ", prefix, _ev_filename(file), line, func);
-    vprintf(fmt, ap);
-    printf("\n");
+#endif
 
-    va_end(ap);
+static void *_ev_realloc(void *ptr, size_t size)
+{
+    return realloc(ptr, size);
 }
 
-EV_LOCAL void ev__dump_hex(const void* data, size_t size, size_t width)
-{
-    const unsigned char* pdat = (unsigned char*)data;
+static ev_realloc_fn s_allocator = _ev_realloc;
 
-    size_t idx_line;
-    for (idx_line = 0; idx_line < size; idx_line += width)
+static void *_ev_allocator_raw(ev_loop_t *loop, void *ptr, size_t size)
+{
+    if (loop != NULL && loop->allocator.fn != NULL)
     {
-        size_t idx_colume;
-        /* printf hex */
-        for (idx_colume = 0; idx_colume < width; idx_colume++)
-        {
-            const char* postfix = (idx_colume < width - 1) ? "" : "|";
+        return loop->allocator.fn(ptr, size, loop->allocator.arg);
+    }
+    return s_allocator(ptr, size);
+}
 
-            if (idx_colume + idx_line < size)
-            {
-                fprintf(stdout, "%02x %s", pdat[idx_colume + idx_line], postfix);
-            }
-            else
-            {
-                fprintf(stdout, "   %s", postfix);
-            }
-        }
-        fprintf(stdout, " ");
-        /* printf char */
-        for (idx_colume = 0; (idx_colume < width) && (idx_colume + idx_line < size); idx_colume++)
+#if defined(EV_ALLOCATOR_STAT)
+
+static void _ev_allocator_stat_update(ev_allocator_type_t type, size_t old_size,
+                                      size_t new_size)
+{
+    ev_allocator_counter_t *counter = &s_allocator_counter[type];
+
+    int64_t live = ev_atomic64_fetch_add(&counter->live_bytes,
+                                         (int64_t)new_size - (int64_t)old_size);
+    live += (int64_t)new_size - (int64_t)old_size;
+
+    int64_t peak = ev_atomic64_load(&counter->peak_bytes);
+    while (live > peak)
+    {
+        if (ev_atomic64_compare_exchange_strong(&counter->peak_bytes, &peak,
+                                                live))
         {
-            fprintf(stdout, "%c", _ev_ascii_to_char(pdat[idx_colume + idx_line]));
+            break;
         }
-        fprintf(stdout, "\n");
     }
 
+    if (old_size == 0)
+    {
+        ev_atomic64_fetch_add(&counter->alloc_count, 1);
+    }
+    else if (new_size == 0)
+    {
+        ev_atomic64_fetch_add(&counter->free_count, 1);
+    }
+    else
+    {
+        ev_atomic64_fetch_add(&counter->realloc_count, 1);
+    }
 }
 
-// #line 97 "ev.c"
-////////////////////////////////////////////////////////////////////////////////
-// FILE:    ev/loop.c
-// SIZE:    8737
-// SHA-256: c470770bd7010034a334f5b55e189f9ee6830230ea17ff5dce698fc60c11789e
-////////////////////////////////////////////////////////////////////////////////
-// #line 1 "ev/loop.c"
-#include <stdio.h>
-#include <stdlib.h>
-#include <assert.h>
-#include <string.h>
-
-#if !defined(_WIN32)
-#   include <net/if.h>
-#   include <sys/un.h>
-#endif
-
-typedef struct ev_strerror_pair
-{
-    int             errn;           /**< Error number */
-    const char*     info;           /**< Error string */
-} ev_strerror_pair_t;
-
-static int _ev_loop_init(ev_loop_t* loop)
+static void *_ev_allocator_realloc(ev_loop_t *loop, ev_allocator_type_t type,
+                                   void *ptr, size_t size)
 {
-    memset(loop, 0, sizeof(*loop));
+    ev_allocator_hdr_t *hdr = NULL;
+    size_t              old_size = 0;
 
-    loop->hwtime = 0;
-    ev_list_init(&loop->handles.idle_list);
-    ev_list_init(&loop->handles.active_list);
-
-    ev_list_init(&loop->backlog_queue);
-    ev_list_init(&loop->endgame_queue);
+    if (ptr != NULL)
+    {
+        hdr = (ev_allocator_hdr_t *)ptr - 1;
+        old_size = hdr->data.size;
+        type = hdr->data.type;
+    }
 
-    ev__init_timer(loop);
+    if (size == 0)
+    {
+        if (hdr != NULL)
+        {
+            _ev_allocator_raw(loop, hdr, 0);
+            _ev_allocator_stat_update(type, old_size, 0);
+        }
+        return NULL;
+    }
 
-    loop->threadpool.pool = NULL;
-    loop->threadpool.node = (ev_list_node_t)EV_LIST_NODE_INIT;
-    ev_mutex_init(&loop->threadpool.mutex, 0);
-    ev_list_init(&loop->threadpool.work_queue);
+    if (size > SIZE_MAX - sizeof(ev_allocator_hdr_t))
+    {
+        return NULL;
+    }
 
-    ev__loop_link_to_default_threadpool(loop);
+    hdr = _ev_allocator_raw(loop, hdr, sizeof(ev_allocator_hdr_t) + size);
+    if (hdr == NULL)
+    {
+        return NULL;
+    }
+    hdr->data.size = size;
+    hdr->data.type = type;
+    _ev_allocator_stat_update(type, old_size, size);
 
-    return 0;
+    return hdr + 1;
 }
 
-static void _ev_loop_exit(ev_loop_t* loop)
-{
-    ev_mutex_exit(loop->threadpool.mutex);
-    ev_loop_unlink_threadpool(loop);
-}
+#else
 
-/**
- * @return bool. non-zero for have active events.
- */
-static int _ev_loop_alive(ev_loop_t* loop)
+static void *_ev_allocator_realloc(ev_loop_t *loop, ev_allocator_type_t type,
+                                   void *ptr, size_t size)
 {
-    return ev_list_size(&loop->handles.active_list)
-        || ev_list_size(&loop->backlog_queue)
-        || ev_list_size(&loop->endgame_queue);
+    (void)type;
+    return _ev_allocator_raw(loop, ptr, size);
 }
 
-static uint32_t _ev_backend_timeout_timer(ev_loop_t* loop)
+#endif
+
+int ev_replace_allocator(ev_realloc_fn  new_allocator,
+                         ev_realloc_fn *old_allocator)
 {
-    ev_map_node_t* it = ev_map_begin(&loop->timer.heap);
-    if (it == NULL)
+    if (new_allocator == NULL)
     {
-        return (uint32_t)-1;
+        return EV_EINVAL;
     }
 
-    ev_timer_t* timer = EV_CONTAINER_OF(it, ev_timer_t, node);
-    if (timer->data.active <= loop->hwtime)
+    if (old_allocator != NULL)
     {
-        return 0;
+        *old_allocator = s_allocator;
     }
-    uint64_t dif = timer->data.active - loop->hwtime;
-    return dif > UINT32_MAX ? UINT32_MAX : (uint32_t)dif;
+    s_allocator = new_allocator;
+
+    return 0;
 }
 
-/**
- * @brief Calculate wait timeout
- * 
- * Calculate timeout as small as posibile.
- * 
- * @param[in] loop  Event loop
- * @return          Timeout in milliseconds
- */
-static uint32_t _ev_backend_timeout(ev_loop_t* loop)
+int ev_allocator_stat(ev_allocator_type_t type, ev_allocator_stat_t *stat)
 {
-    if (loop->mask.b_stop)
+    if ((unsigned)type >= EV_ALLOCATOR_TYPE_MAX)
     {
-        return 0;
+        return EV_EINVAL;
     }
 
-    if (ev_list_size(&loop->backlog_queue) != 0 || ev_list_size(&loop->endgame_queue) != 0)
-    {
-        return 0;
-    }
+#if defined(EV_ALLOCATOR_STAT)
+    ev_allocator_counter_t *counter = &s_allocator_counter[type];
+    stat->live_bytes = (size_t)ev_atomic64_load(&counter->live_bytes);
+    stat->peak_bytes = (size_t)ev_atomic64_load(&counter->peak_bytes);
+    stat->alloc_count = (uint64_t)ev_atomic64_load(&counter->alloc_count);
+    stat->realloc_count = (uint64_t)ev_atomic64_load(&counter->realloc_count);
+    stat->free_count = (uint64_t)ev_atomic64_load(&counter->free_count);
+    return 0;
+#else
+    (void)stat;
+    return EV_ENOSYS;
+#endif
+}
 
-    return _ev_backend_timeout_timer(loop);
+void *ev_calloc(size_t nmemb, size_t size)
+{
+    return ev__loop_calloc(NULL, EV_ALLOCATOR_TYPE_MISC, nmemb, size);
 }
 
-static size_t _ev_calculate_read_capacity(const ev_read_t* req)
+void *ev_malloc(size_t size)
 {
-    size_t total = 0;
+    return _ev_allocator_realloc(NULL, EV_ALLOCATOR_TYPE_MISC, NULL, size);
+}
 
-    size_t i;
-    for (i = 0; i < req->data.nbuf; i++)
-    {
-        total += req->data.bufs[i].size;
-    }
+void *ev_realloc(void *ptr, size_t size)
+{
+    return _ev_allocator_realloc(NULL, EV_ALLOCATOR_TYPE_MISC, ptr, size);
+}
 
-    return total;
+void ev_free(void *ptr)
+{
+    _ev_allocator_realloc(NULL, EV_ALLOCATOR_TYPE_MISC, ptr, 0);
 }
 
-static size_t _ev_calculate_write_size(const ev_write_t* req)
+EV_LOCAL void *ev__malloc(ev_allocator_type_t type, size_t size)
 {
-    size_t total = 0;
+    return _ev_allocator_realloc(NULL, type, NULL, size);
+}
 
-    size_t i;
-    for (i = 0; i < req->nbuf; i++)
-    {
-        total += req->bufs[i].size;
-    }
-    return total;
+EV_LOCAL void *ev__calloc(ev_allocator_type_t type, size_t nmemb, size_t size)
+{
+    return ev__loop_calloc(NULL, type, nmemb, size);
 }
 
-EV_LOCAL void ev__loop_update_time(ev_loop_t* loop)
+EV_LOCAL void *ev__loop_malloc(ev_loop_t *loop, ev_allocator_type_t type,
+                               size_t size)
 {
-    loop->hwtime = ev_hrtime() / 1000000;
+    return _ev_allocator_realloc(loop, type, NULL, size);
 }
 
-EV_LOCAL int ev__ipc_check_frame_hdr(const void* buffer, size_t size)
+EV_LOCAL void *ev__loop_calloc(ev_loop_t *loop, ev_allocator_type_t type,
+                               size_t nmemb, size_t size)
 {
-    const ev_ipc_frame_hdr_t* hdr = buffer;
-    if (size < sizeof(ev_ipc_frame_hdr_t))
+    if (size != 0 && nmemb > SIZE_MAX / size)
     {
-        return 0;
+        return NULL;
     }
 
-    if (hdr->hdr_magic != EV_IPC_FRAME_HDR_MAGIC)
+    const size_t alloc_size = size * nmemb;
+    void        *ptr = _ev_allocator_realloc(loop, type, NULL, alloc_size);
+    if (ptr != NULL)
     {
-        return 0;
+        memset(ptr, 0, alloc_size);
     }
-
-    return 1;
+    return ptr;
 }
 
-EV_LOCAL void ev__ipc_init_frame_hdr(ev_ipc_frame_hdr_t* hdr, uint8_t flags, uint16_t exsz, uint32_t dtsz)
+EV_LOCAL void ev__loop_free(ev_loop_t *loop, void *ptr)
 {
-    hdr->hdr_magic = EV_IPC_FRAME_HDR_MAGIC;
-    hdr->hdr_flags = flags;
-    hdr->hdr_version = 0;
-    hdr->hdr_exsz = exsz;
-
-    hdr->hdr_dtsz = dtsz;
-    hdr->reserved = 0;
+    _ev_allocator_realloc(loop, EV_ALLOCATOR_TYPE_MISC, ptr, 0);
 }
 
-EV_LOCAL ev_loop_t* ev__handle_loop(ev_handle_t* handle)
+EV_LOCAL char *ev__strdup_ext(ev_allocator_type_t type, const char *s)
 {
-    return handle->loop;
+    size_t len = strlen(s) + 1;
+    char  *m = ev__malloc(type, len);
+    if (m == NULL)
+    {
+        return NULL;
+    }
+    return memcpy(m, s, len);
 }
 
-int ev_loop_init(ev_loop_t** loop)
+char *ev__strdup(const char *s)
 {
-    int ret;
-    ev_loop_t* new_loop = ev_malloc(sizeof(ev_loop_t));
-    if (new_loop == NULL)
-    {
-        return EV_ENOMEM;
-    }
+    return ev__strdup_ext(EV_ALLOCATOR_TYPE_MISC, s);
+}
 
-    if ((ret = _ev_loop_init(new_loop)) != 0)
-    {
-        ev_free(new_loop);
-        return ret;
-    }
+// #line 99 "ev.c"
+////////////////////////////////////////////////////////////////////////////////
+// FILE:    ev/atomic.c
+// SIZE:    5881
+// SHA-256: 345bfc0849cfc67cee457944cbc074cb8f8a47dcef54cdd27806ddf1694d0e18
+////////////////////////////////////////////////////////////////////////////////
+// #line 1 "ev/atomic.c"
+#if defined(EV_ATOMIC_WIN32)
 
-    if ((ret = ev__loop_init_backend(new_loop)) != 0)
+EV_LOCAL void ev__atomic_exit(void)
+{
+}
+
+int ev_atomic32_compare_exchange_strong(volatile ev_atomic32_t* obj,
+    int32_t* expected, int32_t desired)
+{
+    int32_t previous = InterlockedCompareExchange(obj, desired, *expected);
+    if (previous == *expected)
     {
-        _ev_loop_exit(new_loop);
-        ev_free(new_loop);
-        return ret;
+        return 1;
     }
 
-    ev__loop_update_time(new_loop);
-    *loop = new_loop;
-
+    *expected = previous;
     return 0;
 }
 
-int ev_loop_exit(ev_loop_t* loop)
+int ev_atomic64_compare_exchange_strong(volatile ev_atomic64_t* obj,
+    int64_t* expected, int64_t desired)
 {
-    if (ev_list_size(&loop->handles.active_list)
-        || ev_list_size(&loop->handles.idle_list))
+    int64_t previous = InterlockedCompareExchange64(obj, desired, *expected);
+    if (previous == *expected)
     {
-        return EV_EBUSY;
+        return 1;
     }
 
-    ev__loop_exit_backend(loop);
-    _ev_loop_exit(loop);
-    ev_free(loop);
-
+    *expected = previous;
     return 0;
 }
 
-void ev_loop_stop(ev_loop_t* loop)
+#elif defined(EV_ATOMIC_LOCK_SIMULATION)
+
+static ev_mutex_t s_atomic_lock;
+
+static void _ev_atomic_lock_init2(void)
 {
-    loop->mask.b_stop = 1;
+    ev_mutex_init(&s_atomic_lock, 0);
 }
 
-static uint32_t _ev_loop_calculate_timeout(ev_loop_t* loop, ev_loop_mode_t mode, size_t active_count)
+static void _ev_atomic_lock_init_once(void)
 {
-    if (mode == EV_LOOP_MODE_ONCE && active_count != 0)
-    {
-        return 0;
-    }
+    static ev_once_t token = EV_ONCE_INIT;
+    ev_once_execute(&token, _ev_atomic_lock_init2);
+}
 
-    return _ev_backend_timeout(loop);
+EV_LOCAL void ev__atomic_exit(void)
+{
+    ev_mutex_exit(&s_atomic_lock);
 }
 
-int ev_loop_run(ev_loop_t* loop, ev_loop_mode_t mode, uint32_t timeout)
+void ev_atomic32_init(volatile ev_atomic32_t* obj, int32_t desired)
 {
-    int ret;
-    size_t active_count = 0;
+    _ev_atomic_lock_init_once();
+    ev_atomic32_store(obj, desired);
+}
 
-    if (mode == EV_LOOP_MODE_NOWAIT)
+void ev_atomic64_init(volatile ev_atomic64_t* obj, int64_t desired)
+{
+    _ev_atomic_lock_init_once();
+    ev_atomic64_store(obj, desired);
+}
+
+void ev_atomic32_store(volatile ev_atomic32_t* obj, int32_t desired)
+{
+    ev_mutex_enter(&s_atomic_lock);
     {
-        timeout = 0;
+        *obj = desired;
     }
+    ev_mutex_leave(&s_atomic_lock);
+}
 
-    ev__loop_update_time(loop);
-    const uint64_t start_time_ms = loop->hwtime;
-
-    while ((ret = _ev_loop_alive(loop)) != 0 && !loop->mask.b_stop)
+void ev_atomic64_store(volatile ev_atomic64_t* obj, int64_t desired)
+{
+    ev_mutex_enter(&s_atomic_lock);
     {
-        ev__loop_update_time(loop);
-
-        active_count += ev__process_timer(loop);
-        active_count += ev__process_backlog(loop);
-        active_count += ev__process_endgame(loop);
-
-        if ((ret = _ev_loop_alive(loop)) == 0)
-        {
-            break;
-        }
-
-        /* IO multiplexing */
-        uint32_t loop_timeout = _ev_loop_calculate_timeout(loop, mode, active_count);
-        loop_timeout = EV_MIN(loop_timeout, timeout);
-        ev__poll(loop, loop_timeout);
-
-        /**
-         * #EV_LOOP_MODE_ONCE implies forward progress: at least one callback must have
-         * been invoked when it returns. #_ev_poll_win() can return without doing
-         * I/O (meaning: no callbacks) when its timeout expires - which means we
-         * have pending timers that satisfy the forward progress constraint.
-         *
-         * #EV_LOOP_MODE_NOWAIT makes no guarantees about progress so it's omitted from
-         * the check.
-         */
-        ev__loop_update_time(loop);
-        const uint32_t diff_time_ms = (uint32_t)(loop->hwtime - start_time_ms);
-
-        active_count += ev__process_timer(loop);
-        active_count += ev__process_backlog(loop);
-        active_count += ev__process_endgame(loop);
-
-        if (timeout != EV_INFINITE_TIMEOUT)
-        {
-            timeout = timeout > diff_time_ms ? timeout - diff_time_ms : 0;
-        }
-        if (timeout == 0 || (mode == EV_LOOP_MODE_ONCE && active_count != 0))
-        {
-            break;
-        }
+        *obj = desired;
     }
+    ev_mutex_leave(&s_atomic_lock);
+}
 
-    /* Prevent #ev_loop_t::mask::b_stop from compile optimization */
-    if (loop->mask.b_stop)
+int32_t ev_atomic32_load(volatile ev_atomic32_t* obj)
+{
+    int32_t ret;
+    ev_mutex_enter(&s_atomic_lock);
     {
-        loop->mask.b_stop = 0;
+        ret = *obj;
     }
+    ev_mutex_leave(&s_atomic_lock);
 
     return ret;
 }
 
-EV_LOCAL int ev__write_init(ev_write_t* req, ev_buf_t* bufs, size_t nbuf)
+int64_t ev_atomic64_load(volatile ev_atomic64_t* obj)
 {
-    req->nbuf = nbuf;
-
-    if (nbuf <= ARRAY_SIZE(req->bufsml))
-    {
-        req->bufs = req->bufsml;
-    }
-    else
+    int64_t ret;
+    ev_mutex_enter(&s_atomic_lock);
     {
-        req->bufs = ev_malloc(sizeof(ev_buf_t) * nbuf);
-        if (req->bufs == NULL)
-        {
-            return EV_ENOMEM;
-        }
+        ret = *obj;
     }
+    ev_mutex_leave(&s_atomic_lock);
 
-    memcpy(req->bufs, bufs, sizeof(ev_buf_t) * nbuf);
-    req->size = 0;
-    req->capacity = _ev_calculate_write_size(req);
-    return 0;
+    return ret;
 }
 
-EV_LOCAL void ev__write_exit(ev_write_t* req)
+int32_t ev_atomic32_exchange(volatile ev_atomic32_t* obj, int32_t desired)
 {
-    if (req->bufs != req->bufsml)
+    int32_t ret;
+    ev_mutex_enter(&s_atomic_lock);
     {
-        ev_free(req->bufs);
+        ret = *obj;
+        *obj = desired;
     }
+    ev_mutex_leave(&s_atomic_lock);
 
-    req->bufs = NULL;
-    req->nbuf = 0;
+    return ret;
 }
 
-EV_LOCAL int ev__read_init(ev_read_t* req, ev_buf_t* bufs, size_t nbuf)
+int64_t ev_atomic64_exchange(volatile ev_atomic64_t* obj, int64_t desired)
 {
-    req->data.nbuf = nbuf;
-
-    if (nbuf <= ARRAY_SIZE(req->data.bufsml))
+    int64_t ret;
+    ev_mutex_enter(&s_atomic_lock);
     {
-        req->data.bufs = req->data.bufsml;
+        ret = *obj;
+        *obj = desired;
     }
-    else
+    ev_mutex_leave(&s_atomic_lock);
+
+    return ret;
+}
+
+int ev_atomic32_compare_exchange_strong(volatile ev_atomic32_t* obj,
+    int32_t* expected, int32_t desired)
+{
+    int ret;
+    ev_mutex_enter(&s_atomic_lock);
     {
-        req->data.bufs = ev_malloc(sizeof(ev_buf_t) * nbuf);
-        if (req->data.bufs == NULL)
+        int32_t previous = *obj;
+        if (previous == *expected)
         {
-            return EV_ENOMEM;
+            *obj = desired;
+            ret = 1;
+        }
+        else
+        {
+            *expected = previous;
+            ret = 0;
         }
     }
-
-    memcpy(req->data.bufs, bufs, sizeof(ev_buf_t) * nbuf);
-    req->data.capacity = _ev_calculate_read_capacity(req);
-    req->data.size = 0;
-    return 0;
+    ev_mutex_leave(&s_atomic_lock);
+    return ret;
 }
 
-EV_LOCAL void ev__read_exit(ev_read_t* req)
+int ev_atomic64_compare_exchange_strong(volatile ev_atomic64_t* obj,
+    int64_t* expected, int64_t desired)
 {
-    if (req->data.bufs != req->data.bufsml)
+    int ret;
+    ev_mutex_enter(&s_atomic_lock);
     {
-        ev_free(req->data.bufs);
+        int64_t previous = *obj;
+        if (previous == *expected)
+        {
+            *obj = desired;
+            ret = 1;
+        }
+        else
+        {
+            *expected = previous;
+            ret = 0;
+        }
     }
-    req->data.bufs = NULL;
-    req->data.nbuf = 0;
+    ev_mutex_leave(&s_atomic_lock);
+    return ret;
 }
 
-EV_LOCAL socklen_t ev__get_addr_len(const struct sockaddr* addr)
+int32_t ev_atomic32_fetch_add(volatile ev_atomic32_t* obj, int32_t arg)
 {
-    if (addr->sa_family == AF_INET)
+    int32_t ret;
+    ev_mutex_enter(&s_atomic_lock);
     {
-        return sizeof(struct sockaddr_in);
+        ret = *obj;
+        *obj += arg;
     }
-    if (addr->sa_family == AF_INET6)
+    ev_mutex_leave(&s_atomic_lock);
+
+    return ret;
+}
+
+int64_t ev_atomic64_fetch_add(volatile ev_atomic64_t* obj, int64_t arg)
+{
+    int64_t ret;
+    ev_mutex_enter(&s_atomic_lock);
     {
-        return sizeof(struct sockaddr_in6);
+        ret = *obj;
+        *obj += arg;
     }
-#if defined(AF_UNIX) && !defined(_WIN32)
-    if (addr->sa_family == AF_UNIX)
+    ev_mutex_leave(&s_atomic_lock);
+
+    return ret;
+}
+
+int32_t ev_atomic32_fetch_sub(volatile ev_atomic32_t* obj, int32_t arg)
+{
+    int32_t ret;
+    ev_mutex_enter(&s_atomic_lock);
     {
-        return sizeof(struct sockaddr_un);
+        ret = *obj;
+        *obj -= arg;
     }
-#endif
+    ev_mutex_leave(&s_atomic_lock);
 
-    return (socklen_t)-1;
+    return ret;
 }
 
-void ev_loop_walk(ev_loop_t* loop, ev_walk_cb cb, void* arg)
+int64_t ev_atomic64_fetch_sub(volatile ev_atomic64_t* obj, int64_t arg)
 {
-    ev_list_t* walk_lists[] = {
-        &loop->handles.active_list,
-        &loop->handles.idle_list,
-    };
+    int64_t ret;
+    ev_mutex_enter(&s_atomic_lock);
+    {
+        ret = *obj;
+        *obj -= arg;
+    }
+    ev_mutex_leave(&s_atomic_lock);
 
-    size_t i;
-    for (i = 0; i < ARRAY_SIZE(walk_lists); i++)
+    return ret;
+}
+
+int32_t ev_atomic32_fetch_or(volatile ev_atomic32_t* obj, int32_t arg)
+{
+    int32_t ret;
+    ev_mutex_enter(&s_atomic_lock);
     {
-        ev_list_node_t* it = ev_list_begin(walk_lists[i]);
-        for (; it != NULL; it = ev_list_next(it))
-        {
-            ev_handle_t* handle = EV_CONTAINER_OF(it, ev_handle_t, handle_queue);
-            if (cb(handle, arg) != 0)
-            {
-                return;
-            }
-        }
+        ret = *obj;
+        *obj |= arg;
     }
+    ev_mutex_leave(&s_atomic_lock);
+
+    return ret;
 }
 
-// #line 98 "ev.c"
-////////////////////////////////////////////////////////////////////////////////
-// FILE:    ev/map.c
-// SIZE:    23122
-// SHA-256: a59516f016393afb28e7da797a13f70950fafde010d6ceb77b9968bc4899afec
-////////////////////////////////////////////////////////////////////////////////
-// #line 1 "ev/map.c"
-#include <stdint.h>
-#include <inttypes.h>
-#include <stddef.h>
+int64_t ev_atomic64_fetch_or(volatile ev_atomic64_t* obj, int64_t arg)
+{
+    int64_t ret;
+    ev_mutex_enter(&s_atomic_lock);
+    {
+        ret = *obj;
+        *obj |= arg;
+    }
+    ev_mutex_leave(&s_atomic_lock);
 
-/*
-* red-black trees properties:  http://en.wikipedia.org/wiki/Rbtree
-*
-*  1) A node is either red or black
-*  2) The root is black
-*  3) All leaves (NULL) are black
-*  4) Both children of every red node are black
-*  5) Every simple path from root to leaves contains the same number
-*     of black nodes.
-*
-*  4 and 5 give the O(log n) guarantee, since 4 implies you cannot have two
-*  consecutive red nodes in a path and every red node is therefore followed by
-*  a black. So if B is the number of black nodes on every simple path (as per
-*  5), then the longest possible path due to 4 is 2B.
-*
-*  We shall indicate color with case, where black nodes are uppercase and red
-*  nodes will be lowercase. Unknown color nodes shall be drawn as red within
-*  parentheses and have some accompanying text comment.
-*/
+    return ret;
+}
 
-#define RB_RED      0
-#define RB_BLACK    1
+int32_t ev_atomic32_fetch_xor(volatile ev_atomic32_t* obj, int32_t arg)
+{
+    int32_t ret;
+    ev_mutex_enter(&s_atomic_lock);
+    {
+        ret = *obj;
+        *obj ^= arg;
+    }
+    ev_mutex_leave(&s_atomic_lock);
 
-#define __rb_color(pc)     ((uintptr_t)(pc) & 1)
-#define __rb_is_black(pc)  __rb_color(pc)
-#define __rb_is_red(pc)    (!__rb_color(pc))
-#define __rb_parent(pc)    ((ev_map_node_t*)(pc & ~3))
-#define rb_color(rb)       __rb_color((rb)->__rb_parent_color)
-#define rb_is_red(rb)      __rb_is_red((rb)->__rb_parent_color)
-#define rb_is_black(rb)    __rb_is_black((rb)->__rb_parent_color)
-#define rb_parent(r)   ((ev_map_node_t*)((uintptr_t)((r)->__rb_parent_color) & ~3))
+    return ret;
+}
 
-/* 'empty' nodes are nodes that are known not to be inserted in an rbtree */
-#define RB_EMPTY_NODE(node)  \
-    ((node)->__rb_parent_color == (struct ev_map_node*)(node))
+int64_t ev_atomic32_fetch_xor(volatile ev_atomic64_t* obj, int64_t arg)
+{
+    int64_t ret;
+    ev_mutex_enter(&s_atomic_lock);
+    {
+        ret = *obj;
+        *obj ^= arg;
+    }
+    ev_mutex_leave(&s_atomic_lock);
 
-static void rb_set_black(ev_map_node_t *rb)
+    return ret;
+}
+
+int32_t ev_atomic32_fetch_and(volatile ev_atomic32_t* obj, int32_t arg)
 {
-    rb->__rb_parent_color =
-        (ev_map_node_t*)((uintptr_t)(rb->__rb_parent_color) | RB_BLACK);
+    int32_t ret;
+    ev_mutex_enter(&s_atomic_lock);
+    {
+        ret = *obj;
+        *obj &= arg;
+    }
+    ev_mutex_leave(&s_atomic_lock);
+
+    return ret;
 }
 
-static ev_map_node_t *rb_red_parent(ev_map_node_t *red)
+int64_t ev_atomic64_fetch_and(volatile ev_atomic64_t* obj, int64_t arg)
 {
-    return (ev_map_node_t*)red->__rb_parent_color;
+    int64_t ret;
+    ev_mutex_enter(&s_atomic_lock);
+    {
+        ret = *obj;
+        *obj &= arg;
+    }
+    ev_mutex_leave(&s_atomic_lock);
+
+    return ret;
 }
 
-static void rb_set_parent_color(ev_map_node_t *rb, ev_map_node_t *p, int color)
+#else
+
+EV_LOCAL void ev__atomic_exit(void)
 {
-    rb->__rb_parent_color = (struct ev_map_node*)((uintptr_t)p | color);
 }
 
-static void __rb_change_child(ev_map_node_t* old_node, ev_map_node_t* new_node,
-    ev_map_node_t* parent, ev_map_t* root)
+#endif
+
+// #line 100 "ev.c"
+////////////////////////////////////////////////////////////////////////////////
+// FILE:    ev/dns.c
+// SIZE:    8878
+// SHA-256: 4f00b1548307df8b77cb2dbf1a384aca83e251a08b3a0820f20d43895ed26479
+////////////////////////////////////////////////////////////////////////////////
+// #line 1 "ev/dns.c"
+#include <string.h>
+
+#define EV_DNS_DEFAULT_TTL      30000
+#define EV_DNS_DEFAULT_NEG_TTL  5000
+
+/**
+ * @brief Max number of cache entries, the oldest one is evicted beyond it.
+ */
+#define EV_DNS_CACHE_MAX_SIZE   1024
+
+static int _ev_dns_cmp_str(const char *s1, const char *s2)
 {
-    if (parent)
+    if (s1 == NULL || s2 == NULL)
     {
-        if (parent->rb_left == old_node)
-        {
-            parent->rb_left = new_node;
-        }
-        else
-        {
-            parent->rb_right = new_node;
-        }
+        return (s1 != NULL) - (s2 != NULL);
     }
-    else
+    return strcmp(s1, s2);
+}
+
+static int _ev_dns_cmp_entry(const ev_map_node_t *key1,
+                             const ev_map_node_t *key2, void *arg)
+{
+    (void)arg;
+    int                     ret;
+    ev_getaddrinfo_entry_t *e1 =
+        EV_CONTAINER_OF(key1, ev_getaddrinfo_entry_t, node);
+    ev_getaddrinfo_entry_t *e2 =
+        EV_CONTAINER_OF(key2, ev_getaddrinfo_entry_t, node);
+
+    if (e1->flags != e2->flags)
     {
-        root->rb_root = new_node;
+        return e1->flags < e2->flags ? -1 : 1;
+    }
+    if (e1->family != e2->family)
+    {
+        return e1->family < e2->family ? -1 : 1;
+    }
+    if (e1->socktype != e2->socktype)
+    {
+        return e1->socktype < e2->socktype ? -1 : 1;
+    }
+    if (e1->protocol != e2->protocol)
+    {
+        return e1->protocol < e2->protocol ? -1 : 1;
     }
+    if ((ret = _ev_dns_cmp_str(e1->host, e2->host)) != 0)
+    {
+        return ret;
+    }
+    return _ev_dns_cmp_str(e1->service, e2->service);
 }
 
-/*
-* Helper function for rotations:
-* - old's parent and color get assigned to new
-* - old gets assigned new as a parent and 'color' as a color.
-*/
-static void __rb_rotate_set_parents(ev_map_node_t* old, ev_map_node_t* new_node,
-    ev_map_t* root, int color)
+static int _ev_dns_translate_error(int ret)
 {
-    ev_map_node_t* parent = rb_parent(old);
-    new_node->__rb_parent_color = old->__rb_parent_color;
-    rb_set_parent_color(old, new_node, color);
-    __rb_change_child(old, new_node, parent, root);
+    switch (ret)
+    {
+    case 0:
+        return 0;
+    case EAI_NONAME:
+#if defined(EAI_NODATA) && EAI_NODATA != EAI_NONAME
+    case EAI_NODATA:
+#endif
+        return EV_ENOENT;
+    case EAI_AGAIN:
+        return EV_EAGAIN;
+    case EAI_MEMORY:
+        return EV_ENOMEM;
+    case EAI_FAMILY:
+    case EAI_SOCKTYPE:
+    case EAI_SERVICE:
+    case EAI_BADFLAGS:
+        return EV_EINVAL;
+#if defined(EAI_SYSTEM)
+    case EAI_SYSTEM:
+        return ev__translate_sys_error(errno);
+#endif
+    default:
+        break;
+    }
+    return EV_EIO;
 }
 
-static void __rb_insert(ev_map_node_t* node, ev_map_t* root)
+static void _ev_dns_unref(ev_getaddrinfo_entry_t *entry)
 {
-    ev_map_node_t* parent = rb_red_parent(node), *gparent, *tmp;
-
-    for (;;) {
-        /*
-        * Loop invariant: node is red
-        *
-        * If there is a black parent, we are done.
-        * Otherwise, take some corrective action as we don't
-        * want a red root or two consecutive red nodes.
-        */
-        if (!parent) {
-            rb_set_parent_color(node, NULL, RB_BLACK);
-            break;
-        }
-        else if (rb_is_black(parent))
-            break;
+    if (--entry->refcnt != 0)
+    {
+        return;
+    }
 
-        gparent = rb_red_parent(parent);
-
-        tmp = gparent->rb_right;
-        if (parent != tmp) {    /* parent == gparent->rb_left */
-            if (tmp && rb_is_red(tmp)) {
-                /*
-                * Case 1 - color flips
-                *
-                *       G            g
-                *      / \          / \
-                *     p   u  -->   P   U
-                *    /            /
-                *   n            n
-                *
-                * However, since g's parent might be red, and
-                * 4) does not allow this, we need to recurse
-                * at g.
-                */
-                rb_set_parent_color(tmp, gparent, RB_BLACK);
-                rb_set_parent_color(parent, gparent, RB_BLACK);
-                node = gparent;
-                parent = rb_parent(node);
-                rb_set_parent_color(node, parent, RB_RED);
-                continue;
-            }
+    if (entry->res != NULL)
+    {
+        freeaddrinfo(entry->res);
+    }
+    ev__loop_free(entry->loop, entry);
+}
 
-            tmp = parent->rb_right;
-            if (node == tmp) {
-                /*
-                * Case 2 - left rotate at parent
-                *
-                *      G             G
-                *     / \           / \
-                *    p   U  -->    n   U
-                *     \           /
-                *      n         p
-                *
-                * This still leaves us in violation of 4), the
-                * continuation into Case 3 will fix that.
-                */
-                parent->rb_right = tmp = node->rb_left;
-                node->rb_left = parent;
-                if (tmp)
-                    rb_set_parent_color(tmp, parent,
-                    RB_BLACK);
-                rb_set_parent_color(parent, node, RB_RED);
-                parent = node;
-                tmp = node->rb_right;
-            }
+static void _ev_dns_uncache(ev_getaddrinfo_entry_t *entry)
+{
+    ev_loop_t *loop = entry->loop;
+    if (!entry->cached)
+    {
+        return;
+    }
 
-            /*
-            * Case 3 - right rotate at gparent
-            *
-            *        G           P
-            *       / \         / \
-            *      p   U  -->  n   g
-            *     /                 \
-            *    n                   U
-            */
-            gparent->rb_left = tmp;  /* == parent->rb_right */
-            parent->rb_right = gparent;
-            if (tmp)
-                rb_set_parent_color(tmp, gparent, RB_BLACK);
-            __rb_rotate_set_parents(gparent, parent, root, RB_RED);
-            break;
-        }
-        else {
-            tmp = gparent->rb_left;
-            if (tmp && rb_is_red(tmp)) {
-                /* Case 1 - color flips */
-                rb_set_parent_color(tmp, gparent, RB_BLACK);
-                rb_set_parent_color(parent, gparent, RB_BLACK);
-                node = gparent;
-                parent = rb_parent(node);
-                rb_set_parent_color(node, parent, RB_RED);
-                continue;
-            }
+    entry->cached = 0;
+    ev_map_erase(&loop->dns.cache, &entry->node);
+    ev_list_erase(&loop->dns.age, &entry->age);
+    loop->dns.cache_sz--;
+    _ev_dns_unref(entry);
+}
 
-            tmp = parent->rb_left;
-            if (node == tmp) {
-                /* Case 2 - right rotate at parent */
-                parent->rb_left = tmp = node->rb_right;
-                node->rb_right = parent;
-                if (tmp)
-                    rb_set_parent_color(tmp, parent,
-                    RB_BLACK);
-                rb_set_parent_color(parent, node, RB_RED);
-                parent = node;
-                tmp = node->rb_left;
-            }
+static int _ev_dns_is_expired(ev_getaddrinfo_entry_t *entry)
+{
+    return !entry->pending && entry->expire <= entry->loop->hwtime;
+}
 
-            /* Case 3 - left rotate at gparent */
-            gparent->rb_right = tmp;  /* == parent->rb_left */
-            parent->rb_left = gparent;
-            if (tmp)
-                rb_set_parent_color(tmp, gparent, RB_BLACK);
-            __rb_rotate_set_parents(gparent, parent, root, RB_RED);
-            break;
-        }
+/**
+ * @brief Evict the oldest entries until there is room for a new one.
+ *
+ * An evicted entry that is still in use is released by its last request.
+ */
+static void _ev_dns_evict(ev_loop_t *loop)
+{
+    ev_list_node_t *it;
+    while (loop->dns.cache_sz >= EV_DNS_CACHE_MAX_SIZE &&
+           (it = ev_list_begin(&loop->dns.age)) != NULL)
+    {
+        _ev_dns_uncache(EV_CONTAINER_OF(it, ev_getaddrinfo_entry_t, age));
     }
 }
 
-static void rb_set_parent(ev_map_node_t* rb, ev_map_node_t*p)
+static void _ev_dns_finish(ev_getaddrinfo_t *req)
 {
-    rb->__rb_parent_color = (struct ev_map_node*)(rb_color(rb) | (uintptr_t)p);
+    ev_getaddrinfo_entry_t *entry = req->entry;
+    req->entry = NULL;
+
+    ev__handle_deactive(&req->base);
+    ev__handle_exit(&req->base, NULL);
+
+    req->cb(req, entry->status == 0 ? entry->res : NULL, entry->status);
+    _ev_dns_unref(entry);
 }
 
-static ev_map_node_t* __rb_erase_augmented(ev_map_node_t* node, ev_map_t* root)
+static void _ev_dns_on_backlog(ev_handle_t *handle)
 {
-    ev_map_node_t *child = node->rb_right, *tmp = node->rb_left;
-    ev_map_node_t *parent, *rebalance;
-    uintptr_t pc;
+    ev_getaddrinfo_t *req = EV_CONTAINER_OF(handle, ev_getaddrinfo_t, base);
+    _ev_dns_finish(req);
+}
 
-    if (!tmp) {
-        /*
-        * Case 1: node to erase has no more than 1 child (easy!)
-        *
-        * Note that if there is one child it must be red due to 5)
-        * and node must be black due to 4). We adjust colors locally
-        * so as to bypass __rb_erase_color() later on.
-        */
-        pc = (uintptr_t)(node->__rb_parent_color);
-        parent = __rb_parent(pc);
-        __rb_change_child(node, child, parent, root);
-        if (child) {
-            child->__rb_parent_color = (struct ev_map_node*)pc;
-            rebalance = NULL;
-        }
-        else
-            rebalance = __rb_is_black(pc) ? parent : NULL;
-        tmp = parent;
+static void _ev_dns_on_work(ev_work_t *work)
+{
+    int                     ret;
+    struct addrinfo         hints;
+    ev_getaddrinfo_entry_t *entry =
+        EV_CONTAINER_OF(work, ev_getaddrinfo_entry_t, token);
+
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_flags = entry->flags;
+    hints.ai_family = entry->family;
+    hints.ai_socktype = entry->socktype;
+    hints.ai_protocol = entry->protocol;
+
+    ret = getaddrinfo(entry->host, entry->service, &hints, &entry->res);
+    entry->status = _ev_dns_translate_error(ret);
+}
+
+static void _ev_dns_on_work_done(ev_work_t *work, int status)
+{
+    ev_list_node_t         *it;
+    ev_getaddrinfo_entry_t *entry =
+        EV_CONTAINER_OF(work, ev_getaddrinfo_entry_t, token);
+    ev_loop_t *loop = entry->loop;
+
+    entry->pending = 0;
+    if (status != 0)
+    {
+        entry->status = status;
     }
-    else if (!child) {
-        /* Still case 1, but this time the child is node->rb_left */
-        pc = (uintptr_t)(node->__rb_parent_color);
-        tmp->__rb_parent_color = (ev_map_node_t*)pc;
-        parent = __rb_parent(pc);
-        __rb_change_child(node, tmp, parent, root);
-        rebalance = NULL;
-        tmp = parent;
+
+    if (entry->status == 0)
+    {
+        entry->expire = loop->hwtime + loop->dns.ttl;
+    }
+    else if (entry->status == EV_ENOENT)
+    {
+        entry->expire = loop->hwtime + loop->dns.neg_ttl;
+    }
+    else
+    {
+        /* Temporary failure is not cached */
+        _ev_dns_uncache(entry);
     }
-    else {
-        ev_map_node_t* successor = child, *child2;
-        tmp = child->rb_left;
-        if (!tmp) {
-            /*
-            * Case 2: node's successor is its right child
-            *
-            *    (n)          (s)
-            *    / \          / \
-            *  (x) (s)  ->  (x) (c)
-            *        \
-            *        (c)
-            */
-            parent = successor;
-            child2 = successor->rb_right;
-        }
-        else {
-            /*
-            * Case 3: node's successor is leftmost under
-            * node's right child subtree
-            *
-            *    (n)          (s)
-            *    / \          / \
-            *  (x) (y)  ->  (x) (y)
-            *      /            /
-            *    (p)          (p)
-            *    /            /
-            *  (s)          (c)
-            *    \
-            *    (c)
-            */
-            do {
-                parent = successor;
-                successor = tmp;
-                tmp = tmp->rb_left;
-            } while (tmp);
-            parent->rb_left = child2 = successor->rb_right;
-            successor->rb_right = child;
-            rb_set_parent(child, successor);
-        }
 
-        successor->rb_left = tmp = node->rb_left;
-        rb_set_parent(tmp, successor);
+    /* Callback may add new request to this entry */
+    entry->refcnt++;
+    while ((it = ev_list_pop_front(&entry->wait_queue)) != NULL)
+    {
+        ev_getaddrinfo_t *req = EV_CONTAINER_OF(it, ev_getaddrinfo_t, node);
+        _ev_dns_finish(req);
+    }
+    _ev_dns_unref(entry);
+}
 
-        pc = (uintptr_t)(node->__rb_parent_color);
-        tmp = __rb_parent(pc);
-        __rb_change_child(node, successor, tmp, root);
-        if (child2) {
-            successor->__rb_parent_color = (struct ev_map_node*)pc;
-            rb_set_parent_color(child2, parent, RB_BLACK);
-            rebalance = NULL;
-        }
-        else {
-            uintptr_t pc2 = (uintptr_t)(successor->__rb_parent_color);
-            successor->__rb_parent_color = (struct ev_map_node*)pc;
-            rebalance = __rb_is_black(pc2) ? parent : NULL;
-        }
-        tmp = successor;
+static ev_getaddrinfo_entry_t *_ev_dns_new_entry(ev_loop_t  *loop,
+                                                 const char *host,
+                                                 const char *service,
+                                                 const struct addrinfo *hints)
+{
+    size_t host_sz = host != NULL ? strlen(host) + 1 : 0;
+    size_t service_sz = service != NULL ? strlen(service) + 1 : 0;
+
+    ev_getaddrinfo_entry_t *entry =
+        ev__loop_malloc(loop, EV_ALLOCATOR_TYPE_MISC,
+                        sizeof(ev_getaddrinfo_entry_t) + host_sz + service_sz);
+    if (entry == NULL)
+    {
+        return NULL;
     }
 
-    return rebalance;
+    char *pos = (char *)(entry + 1);
+    entry->host = host != NULL ? memcpy(pos, host, host_sz) : NULL;
+    entry->service =
+        service != NULL ? memcpy(pos + host_sz, service, service_sz) : NULL;
+    entry->flags = hints->ai_flags;
+    entry->family = hints->ai_family;
+    entry->socktype = hints->ai_socktype;
+    entry->protocol = hints->ai_protocol;
+
+    ev_list_init(&entry->wait_queue);
+    entry->loop = loop;
+    entry->res = NULL;
+    entry->status = 0;
+    entry->pending = 1;
+    entry->cached = 1;
+    entry->refcnt = 1;
+    entry->expire = 0;
+
+    return entry;
 }
 
-/*
-* Inline version for rb_erase() use - we want to be able to inline
-* and eliminate the dummy_rotate callback there
-*/
-static void
-____rb_erase_color(ev_map_node_t* parent, ev_map_t* root)
+EV_LOCAL void ev__init_dns(ev_loop_t *loop)
 {
-    ev_map_node_t* node = NULL, *sibling, *tmp1, *tmp2;
+    ev_map_init(&loop->dns.cache, _ev_dns_cmp_entry, NULL);
+    ev_list_init(&loop->dns.age);
+    loop->dns.cache_sz = 0;
+    loop->dns.ttl = EV_DNS_DEFAULT_TTL;
+    loop->dns.neg_ttl = EV_DNS_DEFAULT_NEG_TTL;
+}
 
-    for (;;) {
-        /*
-        * Loop invariants:
-        * - node is black (or NULL on first iteration)
-        * - node is not the root (parent is not NULL)
-        * - All leaf paths going through parent and node have a
-        *   black node count that is 1 lower than other leaf paths.
-        */
-        sibling = parent->rb_right;
-        if (node != sibling) {  /* node == parent->rb_left */
-            if (rb_is_red(sibling)) {
-                /*
-                * Case 1 - left rotate at parent
-                *
-                *     P               S
-                *    / \             / \
-                *   N   s    -->    p   Sr
-                *      / \         / \
-                *     Sl  Sr      N   Sl
-                */
+EV_LOCAL void ev__exit_dns(ev_loop_t *loop)
+{
+    ev_map_node_t *it;
+    while ((it = ev_map_begin(&loop->dns.cache)) != NULL)
+    {
+        _ev_dns_uncache(EV_CONTAINER_OF(it, ev_getaddrinfo_entry_t, node));
+    }
+}
+
+int ev_getaddrinfo(ev_loop_t *loop, ev_getaddrinfo_t *req, const char *host,
+                   const char *service, const struct addrinfo *hints,
+                   ev_getaddrinfo_cb cb)
+{
+    int                     ret;
+    struct addrinfo         empty_hints;
+    ev_getaddrinfo_entry_t  key;
+    ev_getaddrinfo_entry_t *entry = NULL;
+
+    if (host == NULL && service == NULL)
+    {
+        return EV_EINVAL;
+    }
+    if (hints == NULL)
+    {
+        memset(&empty_hints, 0, sizeof(empty_hints));
+        empty_hints.ai_family = AF_UNSPEC;
+        hints = &empty_hints;
+    }
+
+    key.host = host;
+    key.service = service;
+    key.flags = hints->ai_flags;
+    key.family = hints->ai_family;
+    key.socktype = hints->ai_socktype;
+    key.protocol = hints->ai_protocol;
+
+    ev_map_node_t *it = ev_map_find(&loop->dns.cache, &key.node);
+    if (it != NULL)
+    {
+        entry = EV_CONTAINER_OF(it, ev_getaddrinfo_entry_t, node);
+        if (_ev_dns_is_expired(entry))
+        {
+            _ev_dns_uncache(entry);
+            entry = NULL;
+        }
+    }
+
+    if (entry == NULL)
+    {
+        _ev_dns_evict(loop);
+
+        if ((entry = _ev_dns_new_entry(loop, host, service, hints)) == NULL)
+        {
+            return EV_ENOMEM;
+        }
+
+        ret = ev__loop_submit_threadpool(loop, &entry->token,
+                                         EV_THREADPOOL_WORK_IO_SLOW,
+                                         _ev_dns_on_work, _ev_dns_on_work_done);
+        if (ret != 0)
+        {
+            ev__loop_free(loop, entry);
+            return ret;
+        }
+
+        ev_map_insert(&loop->dns.cache, &entry->node);
+        ev_list_push_back(&loop->dns.age, &entry->age);
+        loop->dns.cache_sz++;
+    }
+
+    ev__handle_init(loop, &req->base, EV_ROLE_EV_REQ_DNS);
+    ev__handle_active(&req->base);
+    req->node = (ev_list_node_t)EV_LIST_NODE_INIT;
+    req->entry = entry;
+    req->cb = cb;
+    entry->refcnt++;
+
+    if (entry->pending)
+    {
+        ev_list_push_back(&entry->wait_queue, &req->node);
+    }
+    else
+    {
+        ev__backlog_submit(&req->base, _ev_dns_on_backlog);
+    }
+
+    return 0;
+}
+
+void ev_getaddrinfo_set_ttl(ev_loop_t *loop, uint64_t ttl, uint64_t neg_ttl)
+{
+    loop->dns.ttl = ttl;
+    loop->dns.neg_ttl = neg_ttl;
+}
+
+// #line 101 "ev.c"
+////////////////////////////////////////////////////////////////////////////////
+// FILE:    ev/errno.c
+// SIZE:    438
+// SHA-256: ac04a2a3cf8600a4daf0051b8d5beb42832225fea7fa9085a9c652c2905a16eb
+////////////////////////////////////////////////////////////////////////////////
+// #line 1 "ev/errno.c"
+const char* ev_strerror(int err)
+{
+#define EV_EXPAND_ERRMAP(err, syserr, str) case err: return str;
+
+    switch (err)
+    {
+    /* Success */
+    case 0:                     return "Operation success";
+    case EV_EOF:                return "End of file";
+    /* posix */
+    EV_ERRNO_POSIX_MAP(EV_EXPAND_ERRMAP);
+    /* Unknown error */
+    default:                    break;
+    }
+    return "Unknown error";
+
+#undef EV_EXPAND_ERRMAP
+}
+
+// #line 102 "ev.c"
+////////////////////////////////////////////////////////////////////////////////
+// FILE:    ev/fs.c
+// SIZE:    25883
+// SHA-256: 0067c4e69187e4bd1804fbd5f07b244285054acc4d58a1a104a1ba63cf283d3d
+////////////////////////////////////////////////////////////////////////////////
+// #line 1 "ev/fs.c"
+#include <sys/stat.h>
+#include <string.h>
+#include <assert.h>
+
+#if !defined(S_ISDIR) && defined(S_IFMT) && defined(S_IFDIR)
+#   define S_ISDIR(m) (((m) & S_IFMT) == S_IFDIR)
+#endif
+
+typedef struct ev_dirent_record_s
+{
+    ev_list_node_t      node;   /**< List node */
+    ev_dirent_t         data;   /**< Dirent info */
+} ev_dirent_record_t;
+
+typedef struct fs_readdir_helper
+{
+    ev_fs_req_t*        req;    /**< File system request */
+    ssize_t             cnt;    /**< Dirent counter */
+} fs_readdir_helper_t;
+
+typedef struct fs_remove_helper
+{
+    const char*         parent_path;
+    int                 ret;
+} fs_remove_helper_t;
+
+static void _ev_fs_erase_req(ev_file_t* file, ev_fs_req_t* req)
+{
+    ev_list_erase(&file->work_queue, &req->node);
+}
+
+static void _ev_fs_cleanup_req_as_open(ev_fs_req_t* token)
+{
+    if (token->req.as_open.path != NULL)
+    {
+        ev_free(token->req.as_open.path);
+        token->req.as_open.path = NULL;
+    }
+}
+
+static void _ev_fs_cleanup_req_as_seek(ev_fs_req_t* req)
+{
+    (void)req;
+}
+
+static void _ev_fs_cleanup_req_as_read(ev_fs_req_t* req)
+{
+    ev__read_exit(&req->req.as_read.read_req);
+}
+
+static void _ev_fs_cleanup_req_as_write(ev_fs_req_t* req)
+{
+    ev__write_exit(&req->req.as_write.write_req);
+}
+
+static void _ev_fs_cleanup_req_as_fstat(ev_fs_req_t* req)
+{
+    (void)req;
+}
+
+static void _ev_fs_cleanup_req_as_readdir(ev_fs_req_t* req)
+{
+    ev_list_node_t* it;
+    while ((it = ev_list_pop_front(&req->rsp.dirents)) != NULL)
+    {
+        ev_dirent_record_t* rec = EV_CONTAINER_OF(it, ev_dirent_record_t, node);
+        ev_free((char*)rec->data.name);
+        ev_free(rec);
+    }
+
+    if (req->req.as_readdir.path != NULL)
+    {
+        ev_free(req->req.as_readdir.path);
+        req->req.as_readdir.path = NULL;
+    }
+}
+
+static void _ev_fs_cleanup_req_as_readfile(ev_fs_req_t* req)
+{
+    if (req->req.as_readfile.path != NULL)
+    {
+        ev_free(req->req.as_readfile.path);
+        req->req.as_readfile.path = NULL;
+    }
+
+    if (req->rsp.filecontent.data != NULL)
+    {
+        ev_free(req->rsp.filecontent.data);
+        req->rsp.filecontent.data = NULL;
+    }
+    req->rsp.filecontent.size = 0;
+}
+
+static void _ev_fs_cleanup_req_as_mkdir(ev_fs_req_t* req)
+{
+    if (req->req.as_mkdir.path != NULL)
+    {
+        ev_free(req->req.as_mkdir.path);
+        req->req.as_mkdir.path = NULL;
+    }
+}
+
+static void _ev_fs_cleanup_req_as_remove(ev_fs_req_t* req)
+{
+    if (req->req.as_remove.path != NULL)
+    {
+        ev_free(req->req.as_remove.path);
+        req->req.as_remove.path = NULL;
+    }
+}
+
+static void _ev_fs_init_req(ev_fs_req_t* req, ev_file_t* file, ev_file_cb cb, ev_fs_req_type_t type)
+{
+    req->req_type = type;
+    req->cb = cb;
+    req->file = file;
+    req->result = EV_EINPROGRESS;
+
+    if (file != NULL)
+    {
+        ev_list_push_back(&file->work_queue, &req->node);
+    }
+}
+
+static int _ev_fs_init_req_as_open(ev_fs_req_t* token, ev_file_t* file,
+    const char* path, int flags, int mode, ev_file_cb cb)
+{
+    _ev_fs_init_req(token, file, cb, EV_FS_REQ_OPEN);
+
+    token->req.as_open.path = ev__strdup_ext(EV_ALLOCATOR_TYPE_FS, path);
+    if (token->req.as_open.path == NULL)
+    {
+        return EV_ENOMEM;
+    }
+
+    token->req.as_open.flags = flags;
+    token->req.as_open.mode = mode;
+
+    return 0;
+}
+
+static int _ev_fs_init_req_as_seek(ev_fs_req_t* token, ev_file_t* file,
+    int whence, int64_t offset, ev_file_cb cb)
+{
+    _ev_fs_init_req(token, file, cb, EV_FS_REQ_SEEK);
+
+    token->req.as_seek.whence = whence;
+    token->req.as_seek.offset = offset;
+
+    return 0;
+}
+
+static int _ev_fs_init_req_as_read(ev_fs_req_t* req, ev_file_t* file,
+    ev_buf_t bufs[], size_t nbuf, int64_t offset, ev_file_cb cb)
+{
+    _ev_fs_init_req(req, file, cb, EV_FS_REQ_READ);
+
+    int ret = ev__read_init(&req->req.as_read.read_req, bufs, nbuf);
+    if (ret != 0)
+    {
+        return ret;
+    }
+    req->req.as_read.offset = offset;
+
+    return 0;
+}
+
+static int _ev_fs_init_req_as_write(ev_fs_req_t* token, ev_file_t* file,
+    ev_buf_t bufs[], size_t nbuf, int64_t offset, ev_file_cb cb)
+{
+    _ev_fs_init_req(token, file, cb, EV_FS_REQ_WRITE);
+
+    int ret = ev__write_init(&token->req.as_write.write_req, bufs, nbuf);
+    if (ret != 0)
+    {
+        return ret;
+    }
+    token->req.as_write.offset = offset;
+
+    return 0;
+}
+
+static void _ev_fs_init_req_as_fstat(ev_fs_req_t* req, ev_file_t* file,
+    ev_fs_stat_t* stat, ev_file_cb cb)
+{
+    _ev_fs_init_req(req, file, cb, EV_FS_REQ_FSTAT);
+    req->rsp.stat = stat;
+}
+
+static int _ev_fs_init_req_as_readdir(ev_fs_req_t* req, const char* path, ev_file_cb cb)
+{
+    _ev_fs_init_req(req, NULL, cb, EV_FS_REQ_READDIR);
+    req->req.as_readdir.path = ev__strdup_ext(EV_ALLOCATOR_TYPE_FS, path);
+    if (req->req.as_readdir.path == NULL)
+    {
+        return EV_ENOMEM;
+    }
+
+    ev_list_init(&req->rsp.dirents);
+
+    return 0;
+}
+
+static int _ev_fs_init_req_as_readfile(ev_fs_req_t* req, const char* path,
+    ev_file_cb cb)
+{
+    _ev_fs_init_req(req, NULL, cb, EV_FS_REQ_READFILE);
+
+    req->req.as_readfile.path = ev__strdup_ext(EV_ALLOCATOR_TYPE_FS, path);
+    if (req->req.as_readfile.path == NULL)
+    {
+        return EV_ENOMEM;
+    }
+
+    req->rsp.filecontent = ev_buf_make(NULL, 0);
+
+    return 0;
+}
+
+static int _ev_fs_init_req_as_mkdir(ev_fs_req_t* req, const char* path, int mode,
+    ev_file_cb cb)
+{
+    _ev_fs_init_req(req, NULL, cb, EV_FS_REQ_MKDIR);
+
+    req->req.as_mkdir.path = ev__strdup_ext(EV_ALLOCATOR_TYPE_FS, path);
+    if (req->req.as_mkdir.path == NULL)
+    {
+        return EV_ENOMEM;
+    }
+    req->req.as_mkdir.mode = mode;
+
+    return 0;
+}
+
+static int _ev_fs_init_req_as_remove(ev_fs_req_t* req, const char* path, int recursion, ev_file_cb cb)
+{
+    _ev_fs_init_req(req, NULL, cb, EV_FS_REQ_REMOVE);
+
+    req->req.as_remove.path = ev__strdup_ext(EV_ALLOCATOR_TYPE_FS, path);
+    if (req->req.as_remove.path == NULL)
+    {
+        return EV_ENOMEM;
+    }
+    req->req.as_remove.recursion = recursion;
+
+    return 0;
+}
+
+/**
+ * @brief Check if \p file have pending task.
+ * @return  bool
+ */
+static int _ev_file_have_pending(ev_file_t* file)
+{
+    return ev_list_size(&file->work_queue) != 0;
+}
+
+static void _ev_file_do_close_callback(ev_file_t* file)
+{
+    if (file->close_cb != NULL)
+    {
+        file->close_cb(file);
+    }
+}
+
+static void _ev_file_do_close_callback_if_necessary(ev_file_t* file)
+{
+    if (file == NULL)
+    {
+        return;
+    }
+    if (file->close_cb != NULL && !_ev_file_have_pending(file))
+    {
+        _ev_file_do_close_callback(file);
+    }
+}
+
+static void _ev_file_on_close(ev_handle_t* handle)
+{
+    ev_file_t* file = EV_CONTAINER_OF(handle, ev_file_t, base);
+    _ev_file_do_close_callback(file);
+}
+
+static void _ev_file_cancel_all_pending_task(ev_file_t* file, size_t* failure_count)
+{
+    *failure_count = 0;
+
+    ev_list_node_t* it = ev_list_begin(&file->work_queue);
+    for (; it != NULL; it = ev_list_next(it))
+    {
+        ev_fs_req_t* req = EV_CONTAINER_OF(it, ev_fs_req_t, node);
+        if (ev_loop_cancel(&req->work_token) != 0)
+        {
+            *failure_count += 1;
+        }
+    }
+}
+
+static int _ev_fs_on_readdir_entry(ev_dirent_t* info, void* arg)
+{
+    fs_readdir_helper_t* helper = arg;
+
+    ev_dirent_record_t* rec =
+        ev__malloc(EV_ALLOCATOR_TYPE_DIRENT, sizeof(ev_dirent_record_t));
+    if (rec == NULL)
+    {
+        goto err_nomem;
+    }
+
+    rec->data.type = info->type;
+    rec->data.name = ev__strdup_ext(EV_ALLOCATOR_TYPE_DIRENT, info->name);
+    if (rec->data.name == NULL)
+    {
+        goto err_nomem;
+    }
+
+    ev_list_push_back(&helper->req->rsp.dirents, &rec->node);
+    helper->cnt++;
+
+    return 0;
+
+err_nomem:
+    if (rec != NULL)
+    {
+        ev_free(rec);
+    }
+    helper->req->result = EV_ENOMEM;
+    return -1;
+}
+
+static void _ev_fs_smart_deactive(ev_file_t* file)
+{
+    size_t io_sz = ev_list_size(&file->work_queue);
+    if (io_sz == 0)
+    {
+        ev__handle_deactive(&file->base);
+    }
+}
+
+static void _ev_fs_on_done(ev_work_t* work, int status)
+{
+    ev_fs_req_t* req = EV_CONTAINER_OF(work, ev_fs_req_t, work_token);
+    ev_file_t* file = req->file;
+
+    if (status == EV_ECANCELED)
+    {
+        assert(req->result == 0);
+        req->result = EV_ECANCELED;
+    }
+
+    if (file != NULL)
+    {
+        _ev_fs_erase_req(file, req);
+        _ev_fs_smart_deactive(file);
+    }
+    req->cb(req);
+
+    /**
+     * As describe in #ev_file_exit(), we have to check close status.
+     */
+    _ev_file_do_close_callback_if_necessary(file);
+}
+
+static void _ev_file_on_open(ev_work_t* work)
+{
+    ev_fs_req_t* req = EV_CONTAINER_OF(work, ev_fs_req_t, work_token);
+    ev_file_t* file = req->file;
+
+    req->result = ev__fs_open(&file->file, req->req.as_open.path,
+        req->req.as_open.flags, req->req.as_open.mode);
+}
+
+static void _ev_file_on_read(ev_work_t* work)
+{
+    ev_fs_req_t* req = EV_CONTAINER_OF(work, ev_fs_req_t, work_token);
+    ev_file_t* file = req->file;
+    ev_read_t* read_req = &req->req.as_read.read_req;
+
+    req->result = ev__fs_readv(file->file, read_req->data.bufs,
+        read_req->data.nbuf);
+}
+
+static void _ev_file_on_pread(ev_work_t* work)
+{
+    ev_fs_req_t* req = EV_CONTAINER_OF(work, ev_fs_req_t, work_token);
+    ev_file_t* file = req->file;
+    ev_read_t* read_req = &req->req.as_read.read_req;
+
+    req->result = ev__fs_preadv(file->file, read_req->data.bufs,
+        read_req->data.nbuf, req->req.as_read.offset);
+}
+
+static void _ev_file_on_write(ev_work_t* work)
+{
+    ev_fs_req_t* req = EV_CONTAINER_OF(work, ev_fs_req_t, work_token);
+    ev_file_t* file = req->file;
+    ev_write_t* write_req = &req->req.as_write.write_req;
+
+    req->result = ev__fs_writev(file->file, write_req->bufs,
+        write_req->nbuf);
+}
+
+static void _ev_file_on_pwrite(ev_work_t* work)
+{
+    ev_fs_req_t* req = EV_CONTAINER_OF(work, ev_fs_req_t, work_token);
+    ev_file_t* file = req->file;
+    ev_write_t* write_req = &req->req.as_write.write_req;
+
+    req->result = ev__fs_pwritev(file->file, write_req->bufs,
+        write_req->nbuf, req->req.as_write.offset);
+}
+
+static void _ev_file_on_fstat(ev_work_t* work)
+{
+    ev_fs_req_t* req = EV_CONTAINER_OF(work, ev_fs_req_t, work_token);
+    ev_file_t* file = req->file;
+
+    req->result = ev__fs_fstat(file->file, req->rsp.stat);
+}
+
+static void _ev_fs_readdir_sync(ev_fs_req_t* req)
+{
+    fs_readdir_helper_t helper = { req, 0 };
+    req->result = ev__fs_readdir(req->req.as_readdir.path,
+        _ev_fs_on_readdir_entry, &helper);
+
+    /* If operation success, replace result with dirent counter */
+    if (req->result == 0)
+    {
+        req->result = helper.cnt;
+    }
+}
+
+static void _ev_fs_on_readdir(ev_work_t* work)
+{
+    ev_fs_req_t* req = EV_CONTAINER_OF(work, ev_fs_req_t, work_token);
+    _ev_fs_readdir_sync(req);
+}
+
+static void _ev_fs_readfile_sync(ev_fs_req_t* req)
+{
+    const char* path = req->req.as_readfile.path;
+
+    ev_os_file_t file = EV_OS_FILE_INVALID;
+    req->result = ev__fs_open(&file, path, EV_FS_O_RDONLY, 0);
+    if (req->result != 0)
+    {
+        return;
+    }
+
+    ev_fs_stat_t statbuf = EV_FS_STAT_INVALID;
+    req->result = ev__fs_fstat(file, &statbuf);
+    if (req->result != 0)
+    {
+        goto close_file;
+    }
+
+#if UINT64_MAX > SIZE_MAX
+    if (statbuf.st_size > SIZE_MAX)
+    {
+        req->result = EV_E2BIG;
+        goto close_file;
+    }
+#endif
+    /* Now it is a safe cast. */
+    size_t file_sz = (size_t)statbuf.st_size;
+
+    void* data = ev__malloc(EV_ALLOCATOR_TYPE_FS, file_sz);
+    if (data == NULL)
+    {
+        req->result = EV_ENOMEM;
+        goto close_file;
+    }
+
+    req->rsp.filecontent = ev_buf_make(data, file_sz);
+    req->result = ev__fs_preadv(file, &req->rsp.filecontent, 1, 0);
+
+close_file:
+    ev__fs_close(file);
+}
+
+static void _ev_fs_on_readfile(ev_work_t* work)
+{
+    ev_fs_req_t* req = EV_CONTAINER_OF(work, ev_fs_req_t, work_token);
+    _ev_fs_readfile_sync(req);
+}
+
+static void _ev_fs_on_mkdir(ev_work_t* work)
+{
+    ev_fs_req_t* req = EV_CONTAINER_OF(work, ev_fs_req_t, work_token);
+    const char* path = req->req.as_mkdir.path;
+    int mode = req->req.as_mkdir.mode;
+
+    req->result = ev__fs_mkdir(path, mode);
+}
+
+static void _ev_fs_on_remove(ev_work_t* work)
+{
+    ev_fs_req_t* req = EV_CONTAINER_OF(work, ev_fs_req_t, work_token);
+    const char* path = req->req.as_remove.path;
+
+    req->result = ev__fs_remove(path, req->req.as_remove.recursion);
+}
+
+static int _ev_file_read_template(ev_file_t* file, ev_fs_req_t* req, ev_buf_t bufs[],
+    size_t nbuf, int64_t offset, ev_file_cb cb, ev_work_cb work_cb)
+{
+    ev_loop_t* loop = file->base.loop;
+
+    int ret = _ev_fs_init_req_as_read(req, file, bufs, nbuf, offset, cb);
+    if (ret != 0)
+    {
+        return ret;
+    }
+
+    ev__handle_active(&file->base);
+
+    ret = ev__loop_submit_threadpool(loop, &req->work_token,
+        EV_THREADPOOL_WORK_IO_FAST, work_cb, _ev_fs_on_done);
+    if (ret != 0)
+    {
+        _ev_fs_cleanup_req_as_read(req);
+        _ev_fs_smart_deactive(file);
+        return ret;
+    }
+
+    return 0;
+}
+
+static int _ev_file_pwrite_template(ev_file_t* file, ev_fs_req_t* req, ev_buf_t bufs[],
+    size_t nbuf, int64_t offset, ev_file_cb cb, ev_work_cb work_cb)
+{
+    int ret;
+    ev_loop_t* loop = file->base.loop;
+
+    ret = _ev_fs_init_req_as_write(req, file, bufs, nbuf, offset, cb);
+    if (ret != 0)
+    {
+        return ret;
+    }
+
+    ev__handle_active(&file->base);
+
+    ret = ev__loop_submit_threadpool(loop, &req->work_token,
+        EV_THREADPOOL_WORK_IO_FAST, work_cb, _ev_fs_on_done);
+    if (ret != 0)
+    {
+        _ev_fs_cleanup_req_as_write(req);
+        _ev_fs_smart_deactive(file);
+        return ret;
+    }
+
+    return 0;
+}
+
+static void _ev_fs_on_seek(ev_work_t* work)
+{
+    ev_fs_req_t* req = EV_CONTAINER_OF(work, ev_fs_req_t, work_token);
+    ev_file_t* file = req->file;
+
+    req->result = ev__fs_seek(file->file, req->req.as_seek.whence, req->req.as_seek.offset);
+}
+
+static int _ev_fs_remove(const char* path)
+{
+    int errcode;
+    if (remove(path) != 0)
+    {
+        errcode = errno;
+        return ev__translate_sys_error(errcode);
+    }
+    return 0;
+}
+
+static  int _ev_fs_remove_helper(ev_dirent_t* info, void* arg)
+{
+    fs_remove_helper_t* helper = arg;
+    const char* parent_path = helper->parent_path;
+    size_t parent_path_sz = strlen(parent_path);
+    size_t name_sz = strlen(info->name);
+    size_t full_path_sz = parent_path_sz + 1 + name_sz;
+
+    char* full_path = ev__malloc(EV_ALLOCATOR_TYPE_FS, full_path_sz + 1);
+    snprintf(full_path, full_path_sz + 1, "%s/%s", parent_path, info->name);
+
+    helper->ret = ev__fs_remove(full_path, 1);
+    ev_free(full_path);
+
+    return helper->ret;
+}
+
+/**
+ * @brief Initialize a file handle
+ * @param[in] loop      Event loop
+ * @param[out] file     File handle
+ * @return              #ev_errno_t
+ */
+static int _ev_file_init(ev_loop_t* loop, ev_file_t* file)
+{
+    file->file = EV_OS_FILE_INVALID;
+    file->close_cb = NULL;
+    ev__handle_init(loop, &file->base, EV_ROLE_EV_FILE);
+    ev_list_init(&file->work_queue);
+
+    return 0;
+}
+
+static void _ev_file_close(ev_file_t* file)
+{
+    if (file->file != EV_OS_FILE_INVALID)
+    {
+        ev__fs_close(file->file);
+        file->file = EV_OS_FILE_INVALID;
+    }
+}
+
+void ev_file_close(ev_file_t* file, ev_file_close_cb cb)
+{
+    size_t failure_count;
+
+    if (file->base.loop == NULL)
+    {
+        EV_ASSERT(cb == NULL, "operation in synchronous mode.");
+        _ev_file_close(file);
+        return;
+    }
+
+    /**
+     * Cancel all pending task. Do note that some tasks might be cancel failed
+     * as they are currently executing.
+     */
+    _ev_file_cancel_all_pending_task(file, &failure_count);
+
+    /**
+     * It should be safe to close handle, event there are some works in
+     * progress.
+     */
+    _ev_file_close(file);
+
+    file->close_cb = cb;
+
+    /**
+     * If all pending task was cancel, it is safe to close handle, because they
+     * are in the backlog queue.
+     */
+    if (failure_count == 0)
+    {
+        ev__handle_exit(&file->base, _ev_file_on_close);
+        return;
+    }
+
+    /**
+     * Now we have some problem, because some task is executing.
+     *
+     * We cannot close handle directly as these tasks will surely callback after
+     * this handle closed.
+     *
+     * So we have to check close status in file operations callback. Once no
+     * pending tasks, we can close this handle.
+     */
+}
+
+int ev_file_open(ev_loop_t* loop, ev_file_t* file, ev_fs_req_t* token, const char* path,
+    int flags, int mode, ev_file_cb cb)
+{
+    int ret;
+    if (cb == NULL)
+    {
+        if (loop != NULL || token != NULL)
+        {
+            return EV_EINVAL;
+        }
+        memset(file, 0, sizeof(*file));
+        return ev__fs_open(&file->file, path, flags, mode);
+    }
+
+    if ((ret = _ev_file_init(loop, file)) != 0)
+    {
+        return ret;
+    }
+
+    if ((ret = _ev_fs_init_req_as_open(token, file, path, flags, mode, cb)) != 0)
+    {
+        return ret;
+    }
+
+    ev__handle_active(&file->base);
+
+    ret = ev__loop_submit_threadpool(loop, &token->work_token,
+        EV_THREADPOOL_WORK_IO_FAST, _ev_file_on_open, _ev_fs_on_done);
+    if (ret != 0)
+    {
+        _ev_fs_cleanup_req_as_open(token);
+        _ev_fs_smart_deactive(file);
+        return ret;
+    }
+
+    return 0;
+}
+
+int64_t ev_file_seek(ev_file_t* file, ev_fs_req_t* req, int whence, int64_t offset,
+    ev_file_cb cb)
+{
+    int ret;
+    ev_loop_t* loop = file->base.loop;
+    if (loop == NULL)
+    {
+        EV_ASSERT(cb == NULL, "operation in synchronous mode.");
+        return ev__fs_seek(file->file, whence, offset);
+    }
+
+    _ev_fs_init_req_as_seek(req, file, whence, offset, cb);
+    ev__handle_active(&file->base);
+
+    ret = ev__loop_submit_threadpool(loop, &req->work_token,
+        EV_THREADPOOL_WORK_IO_FAST, _ev_fs_on_seek, _ev_fs_on_done);
+    if (ret != 0)
+    {
+        _ev_fs_smart_deactive(file);
+        return ret;
+    }
+
+    return 0;
+}
+
+ssize_t ev_file_read(ev_file_t* file, ev_fs_req_t* req, void* buff,
+    size_t size, ev_file_cb cb)
+{
+    ev_buf_t buf = ev_buf_make(buff, size);
+    return ev_file_readv(file, req, &buf, 1, cb);
+}
+
+ssize_t ev_file_readv(ev_file_t* file, ev_fs_req_t* req, ev_buf_t bufs[],
+    size_t nbuf, ev_file_cb cb)
+{
+    if (file->base.loop == NULL)
+    {
+        EV_ASSERT(req == NULL && cb == NULL, "operation in synchronous mode.");
+        return ev__fs_readv(file->file, bufs, nbuf);
+    }
+
+    return _ev_file_read_template(file, req, bufs, nbuf, 0, cb, _ev_file_on_read);
+}
+
+ssize_t ev_file_pread(ev_file_t* file, ev_fs_req_t* req, void* buff,
+    size_t size, int64_t offset, ev_file_cb cb)
+{
+    ev_buf_t buf = ev_buf_make(buff, size);
+    return ev_file_preadv(file, req, &buf, 1, offset, cb);
+}
+
+ssize_t ev_file_preadv(ev_file_t* file, ev_fs_req_t* req, ev_buf_t bufs[],
+    size_t nbuf, int64_t offset, ev_file_cb cb)
+{
+    if (file->base.loop == NULL)
+    {
+        EV_ASSERT(req == NULL && cb == NULL, "operation in synchronous mode.");
+        return ev__fs_preadv(file->file, bufs, nbuf, offset);
+    }
+
+    return _ev_file_read_template(file, req, bufs, nbuf, offset, cb, _ev_file_on_pread);
+}
+
+ssize_t ev_file_write(ev_file_t* file, ev_fs_req_t* req, const void* data,
+    size_t size, ev_file_cb cb)
+{
+    ev_buf_t buf = ev_buf_make((void*)data, size);
+    return ev_file_writev(file, req, &buf, 1, cb);
+}
+
+ssize_t ev_file_writev(ev_file_t* file, ev_fs_req_t* req, ev_buf_t bufs[],
+    size_t nbuf, ev_file_cb cb)
+{
+    if (file->base.loop == NULL)
+    {
+        EV_ASSERT(req == NULL && cb == NULL, "operation in synchronous mode.");
+        return ev__fs_writev(file->file, bufs, nbuf);
+    }
+
+    return _ev_file_pwrite_template(file, req, bufs, nbuf, 0, cb, _ev_file_on_write);
+}
+
+ssize_t ev_file_pwrite(ev_file_t* file, ev_fs_req_t* req, const void* data,
+    size_t size, int64_t offset, ev_file_cb cb)
+{
+    ev_buf_t buf = ev_buf_make((void*)data, size);
+    return ev_file_pwritev(file, req, &buf, 1, offset, cb);
+}
+
+ssize_t ev_file_pwritev(ev_file_t* file, ev_fs_req_t* req, ev_buf_t bufs[],
+    size_t nbuf, int64_t offset, ev_file_cb cb)
+{
+    if (file->base.loop == NULL)
+    {
+        EV_ASSERT(req == NULL && cb == NULL, "operation in synchronous mode.");
+        return ev__fs_pwritev(file->file, bufs, nbuf, offset);
+    }
+    return _ev_file_pwrite_template(file, req, bufs, nbuf, offset, cb, _ev_file_on_pwrite);
+}
+
+int ev_file_stat(ev_file_t* file, ev_fs_req_t* req, ev_fs_stat_t* stat, ev_file_cb cb)
+{
+    int ret;
+    ev_loop_t* loop = file->base.loop;
+    if (loop == NULL)
+    {
+        EV_ASSERT(req == NULL && cb == NULL);
+        return ev__fs_fstat(file->file, stat);
+    }
+
+    _ev_fs_init_req_as_fstat(req, file, stat, cb);
+    ev__handle_active(&file->base);
+
+    ret = ev__loop_submit_threadpool(loop, &req->work_token, EV_THREADPOOL_WORK_IO_FAST,
+        _ev_file_on_fstat, _ev_fs_on_done);
+    if (ret != 0)
+    {
+        _ev_fs_cleanup_req_as_fstat(req);
+        _ev_fs_smart_deactive(file);
+        return ret;
+    }
+
+    return 0;
+}
+
+ssize_t ev_fs_readdir(ev_loop_t* loop, ev_fs_req_t* req, const char* path,
+    ev_file_cb cb)
+{
+    int ret;
+    if ((ret = _ev_fs_init_req_as_readdir(req, path, cb)) != 0)
+    {
+        return ret;
+    }
+
+    if (cb == NULL)
+    {
+        EV_ASSERT(loop == NULL, "operation in synchronous mode.");
+
+        _ev_fs_readdir_sync(req);
+        if (req->result < 0)
+        {
+            ev_fs_req_cleanup(req);
+        }
+        return (ssize_t)req->result;
+    }
+
+    ret = ev__loop_submit_threadpool(loop, &req->work_token, EV_THREADPOOL_WORK_IO_FAST,
+        _ev_fs_on_readdir, _ev_fs_on_done);
+    if (ret != 0)
+    {
+        _ev_fs_cleanup_req_as_readdir(req);
+        return ret;
+    }
+
+    return 0;
+}
+
+int64_t ev_fs_readfile(ev_loop_t* loop, ev_fs_req_t* req, const char* path,
+    ev_file_cb cb)
+{
+    int ret;
+    if ((ret = _ev_fs_init_req_as_readfile(req, path, cb)) != 0)
+    {
+        return ret;
+    }
+    if (cb == NULL)
+    {
+        EV_ASSERT(loop == NULL, "operation in synchronous mode.");
+
+        _ev_fs_readfile_sync(req);
+        if (req->result < 0)
+        {
+            ev_fs_req_cleanup(req);
+        }
+        return req->result;
+    }
+
+    ret = ev__loop_submit_threadpool(loop, &req->work_token, EV_THREADPOOL_WORK_IO_FAST,
+        _ev_fs_on_readfile, _ev_fs_on_done);
+    if (ret != 0)
+    {
+        _ev_fs_cleanup_req_as_readfile(req);
+        return ret;
+    }
+
+    return 0;
+}
+
+int ev_fs_mkdir(ev_loop_t* loop, ev_fs_req_t* req, const char* path, int mode,
+    ev_file_cb cb)
+{
+    int ret;
+    if (cb == NULL)
+    {
+        EV_ASSERT(loop == NULL && req == NULL, "operation in synchronous mode.");
+        return ev__fs_mkdir(path, mode);
+    }
+
+    if ((ret = _ev_fs_init_req_as_mkdir(req, path, mode, cb)) != 0)
+    {
+        return ret;
+    }
+
+    ret = ev__loop_submit_threadpool(loop, &req->work_token, EV_THREADPOOL_WORK_IO_FAST,
+        _ev_fs_on_mkdir, _ev_fs_on_done);
+    if (ret != 0)
+    {
+        _ev_fs_cleanup_req_as_mkdir(req);
+        return ret;
+    }
+
+    return 0;
+}
+
+int ev_fs_remove(ev_loop_t* loop, ev_fs_req_t* req, const char* path, int recursion, ev_file_cb cb)
+{
+    int ret;
+    if (cb == NULL)
+    {
+        EV_ASSERT(loop == NULL && req == NULL, "operation in synchronous mode.");
+        return ev__fs_remove(path, recursion);
+    }
+
+    if ((ret = _ev_fs_init_req_as_remove(req, path, recursion, cb)) != 0)
+    {
+        return ret;
+    }
+
+    ret = ev__loop_submit_threadpool(loop, &req->work_token, EV_THREADPOOL_WORK_IO_FAST,
+        _ev_fs_on_remove, _ev_fs_on_done);
+    if (ret != 0)
+    {
+        _ev_fs_cleanup_req_as_remove(req);
+        return ret;
+    }
+
+    return 0;
+}
+
+ev_fs_stat_t* ev_fs_get_statbuf(ev_fs_req_t* req)
+{
+    return req->rsp.stat;
+}
+
+void ev_fs_req_cleanup(ev_fs_req_t* req)
+{
+    switch (req->req_type)
+    {
+    case EV_FS_REQ_OPEN:
+        _ev_fs_cleanup_req_as_open(req);
+        break;
+
+    case EV_FS_REQ_SEEK:
+        _ev_fs_cleanup_req_as_seek(req);
+        break;
+
+    case EV_FS_REQ_READ:
+        _ev_fs_cleanup_req_as_read(req);
+        break;
+
+    case EV_FS_REQ_WRITE:
+        _ev_fs_cleanup_req_as_write(req);
+        break;
+
+    case EV_FS_REQ_FSTAT:
+        _ev_fs_cleanup_req_as_fstat(req);
+        break;
+
+    case EV_FS_REQ_READDIR:
+        _ev_fs_cleanup_req_as_readdir(req);
+        break;
+
+    case EV_FS_REQ_READFILE:
+        _ev_fs_cleanup_req_as_readfile(req);
+        break;
+
+    case EV_FS_REQ_MKDIR:
+        _ev_fs_cleanup_req_as_mkdir(req);
+        break;
+
+    default:
+        EV_ABORT("req:%d", req->req_type);
+    }
+}
+
+ev_file_t* ev_fs_get_file(ev_fs_req_t* req)
+{
+    return req->file;
+}
+
+ev_dirent_t* ev_fs_get_first_dirent(ev_fs_req_t* req)
+{
+    ev_list_node_t* it = ev_list_begin(&req->rsp.dirents);
+    if (it == NULL)
+    {
+        return NULL;
+    }
+
+    ev_dirent_record_t* rec = EV_CONTAINER_OF(it, ev_dirent_record_t, node);
+    return &rec->data;
+}
+
+ev_dirent_t* ev_fs_get_next_dirent(ev_dirent_t* curr)
+{
+    if (curr == NULL)
+    {
+        return NULL;
+    }
+
+    ev_dirent_record_t* rec = EV_CONTAINER_OF(curr, ev_dirent_record_t, data);
+
+    ev_list_node_t* next_node = ev_list_next(&rec->node);
+    if (next_node == NULL)
+    {
+        return NULL;
+    }
+
+    ev_dirent_record_t* next_rec = EV_CONTAINER_OF(next_node, ev_dirent_record_t, node);
+    return &next_rec->data;
+}
+
+ev_buf_t* ev_fs_get_filecontent(ev_fs_req_t* req)
+{
+    return &req->rsp.filecontent;
+}
+
+EV_LOCAL int ev__fs_remove(const char* path, int recursive)
+{
+    int ret;
+
+    struct stat buf;
+    if (stat(path, &buf) != 0)
+    {
+        ret = errno;
+        return ev__translate_sys_error(ret);
+    }
+
+    if (!S_ISDIR(buf.st_mode) || !recursive)
+    {
+        goto finish;
+    }
+
+    fs_remove_helper_t helper;
+    helper.parent_path = path;
+    helper.ret = 0;
+
+    if ((ret = ev__fs_readdir(path, _ev_fs_remove_helper, &helper)) != 0)
+    {
+        return helper.ret;
+    }
+
+finish:
+    return _ev_fs_remove(path);
+}
+
+// #line 103 "ev.c"
+////////////////////////////////////////////////////////////////////////////////
+// FILE:    ev/handle.c
+// SIZE:    3642
+// SHA-256: 37cc134812484bb50e8ae6ae2b4204095f1c3fec79b22675a03976bac920058b
+////////////////////////////////////////////////////////////////////////////////
+// #line 1 "ev/handle.c"
+#include <assert.h>
+
+/**
+ * @brief Set handle as inactive.
+ * @param[in] handle    handler
+ */
+EV_LOCAL void ev__handle_deactive(ev_handle_t* handle)
+{
+    if (!(handle->data.flags & EV_HANDLE_ACTIVE))
+    {
+        return;
+    }
+    handle->data.flags &= ~EV_HANDLE_ACTIVE;
+
+    ev_loop_t* loop = handle->loop;
+    ev_list_erase(&loop->handles.active_list, &handle->handle_queue);
+    ev_list_push_back(&loop->handles.idle_list, &handle->handle_queue);
+}
+
+/**
+ * @brief Force set handle as active.
+ * @param[in] handle    handler
+ */
+EV_LOCAL void ev__handle_active(ev_handle_t* handle)
+{
+    if (handle->data.flags & EV_HANDLE_ACTIVE)
+    {
+        return;
+    }
+    handle->data.flags |= EV_HANDLE_ACTIVE;
+
+    ev_loop_t* loop = handle->loop;
+    ev_list_erase(&loop->handles.idle_list, &handle->handle_queue);
+    ev_list_push_back(&loop->handles.active_list, &handle->handle_queue);
+}
+
+static void _ev_to_close_handle(ev_handle_t* handle)
+{
+    /**
+     * Deactive but not reset #ev_handle_t::data::active_events, for debug
+     * purpose.
+     * The #ev_handle_t::data::active_events should be zero by now.
+     */
+    ev__handle_deactive(handle);
+
+    handle->data.flags |= EV_HANDLE_CLOSED;
+    ev_list_erase(&handle->loop->handles.idle_list, &handle->handle_queue);
+
+    handle->endgame.close_cb(handle);
+}
+
+EV_LOCAL void ev__handle_init(ev_loop_t* loop, ev_handle_t* handle, ev_role_t role)
+{
+    handle->loop = loop;
+    ev_list_push_back(&loop->handles.idle_list, &handle->handle_queue);
+
+    handle->data.role = role;
+    handle->data.flags = 0;
+
+    handle->backlog.status = EV_ENOENT;
+    handle->backlog.cb = NULL;
+    handle->backlog.node = (ev_list_node_t)EV_LIST_NODE_INIT;
+
+    handle->endgame.close_cb = NULL;
+    handle->endgame.node = (ev_list_node_t)EV_LIST_NODE_INIT;
+}
+
+EV_LOCAL void ev__handle_exit(ev_handle_t* handle, ev_handle_cb close_cb)
+{
+    assert(!ev__handle_is_closing(handle));
+
+    handle->data.flags |= EV_HANDLE_CLOSING;
+    handle->endgame.close_cb = close_cb;
+
+    if (close_cb != NULL)
+    {
+        ev_list_push_back(&handle->loop->endgame_queue, &handle->endgame.node);
+    }
+    else
+    {
+        ev__handle_deactive(handle);
+        handle->data.flags |= EV_HANDLE_CLOSED;
+        ev_list_erase(&handle->loop->handles.idle_list, &handle->handle_queue);
+    }
+}
+
+EV_LOCAL int ev__handle_is_active(ev_handle_t* handle)
+{
+    return handle->data.flags & EV_HANDLE_ACTIVE;
+}
+
+EV_LOCAL int ev__handle_is_closing(ev_handle_t* handle)
+{
+    return handle->data.flags & (EV_HANDLE_CLOSING | EV_HANDLE_CLOSED);
+}
+
+EV_LOCAL int ev__backlog_submit(ev_handle_t* handle, ev_handle_cb callback)
+{
+    if (handle->backlog.status != EV_ENOENT)
+    {
+        return EV_EEXIST;
+    }
+
+    handle->backlog.status = EV_EEXIST;
+    handle->backlog.cb = callback;
+
+    ev_list_push_back(&handle->loop->backlog_queue, &handle->backlog.node);
+
+    return 0;
+}
+
+EV_LOCAL size_t ev__process_backlog(ev_loop_t* loop)
+{
+    ev_list_node_t* it;
+    size_t active_count = 0;
+
+    while ((it = ev_list_pop_front(&loop->backlog_queue)) != NULL)
+    {
+        ev_handle_t* handle = EV_CONTAINER_OF(it, ev_handle_t, backlog.node);
+
+        handle->backlog.status = EV_ENOENT;
+
+        handle->backlog.cb(handle);
+        active_count++;
+    }
+
+    return active_count;
+}
+
+EV_LOCAL size_t ev__process_endgame(ev_loop_t* loop)
+{
+    ev_list_node_t* it;
+    size_t active_count = 0;
+
+    while ((it = ev_list_pop_front(&loop->endgame_queue)) != NULL)
+    {
+        ev_handle_t* handle = EV_CONTAINER_OF(it, ev_handle_t, endgame.node);
+        _ev_to_close_handle(handle);
+        active_count++;
+    }
+
+    return active_count;
+}
+
+// #line 104 "ev.c"
+////////////////////////////////////////////////////////////////////////////////
+// FILE:    ev/list.c
+// SIZE:    3572
+// SHA-256: 5ca5df3a7fcd1e63840867dc5f2eccbbe2ec19a00174d27dc715130cdf87f5bd
+////////////////////////////////////////////////////////////////////////////////
+// #line 1 "ev/list.c"
+#include <string.h>
+
+static void _list_lite_set_once(ev_list_t* handler, ev_list_node_t* node)
+{
+    handler->head = node;
+    handler->tail = node;
+    node->p_after = NULL;
+    node->p_before = NULL;
+    handler->size = 1;
+}
+
+void ev_list_init(ev_list_t* handler)
+{
+    memset(handler, 0, sizeof(*handler));
+}
+
+void ev_list_push_back(ev_list_t* handler, ev_list_node_t* node)
+{
+    if (handler->head == NULL)
+    {
+        _list_lite_set_once(handler, node);
+        return;
+    }
+
+    node->p_after = NULL;
+    node->p_before = handler->tail;
+    handler->tail->p_after = node;
+    handler->tail = node;
+    handler->size++;
+}
+
+void ev_list_insert_before(ev_list_t* handler, ev_list_node_t* pos, ev_list_node_t* node)
+{
+    if (handler->head == pos)
+    {
+        ev_list_push_front(handler, node);
+        return;
+    }
+
+    node->p_before = pos->p_before;
+    node->p_after = pos;
+    pos->p_before->p_after = node;
+    pos->p_before = node;
+    handler->size++;
+}
+
+void ev_list_insert_after(ev_list_t* handler,  ev_list_node_t* pos, ev_list_node_t* node)
+{
+    if (handler->tail == pos)
+    {
+        ev_list_push_back(handler, node);
+        return;
+    }
+
+    node->p_before = pos;
+    node->p_after = pos->p_after;
+    pos->p_after->p_before = node;
+    pos->p_after = node;
+    handler->size++;
+}
+
+void ev_list_push_front(ev_list_t* handler, ev_list_node_t* node)
+{
+    if (handler->head == NULL)
+    {
+        _list_lite_set_once(handler, node);
+        return;
+    }
+
+    node->p_before = NULL;
+    node->p_after = handler->head;
+    handler->head->p_before = node;
+    handler->head = node;
+    handler->size++;
+}
+
+ev_list_node_t* ev_list_begin(const ev_list_t* handler)
+{
+    return handler->head;
+}
+
+ev_list_node_t* ev_list_end(const ev_list_t* handler)
+{
+    return handler->tail;
+}
+
+ev_list_node_t* ev_list_next(const ev_list_node_t* node)
+{
+    return node->p_after;
+}
+
+ev_list_node_t* ev_list_prev(const ev_list_node_t* node)
+{
+    return node->p_before;
+}
+
+void ev_list_erase(ev_list_t* handler, ev_list_node_t* node)
+{
+    handler->size--;
+
+    /* Only one node */
+    if (handler->head == node && handler->tail == node)
+    {
+        handler->head = NULL;
+        handler->tail = NULL;
+        goto fin;
+    }
+
+    if (handler->head == node)
+    {
+        node->p_after->p_before = NULL;
+        handler->head = node->p_after;
+        goto fin;
+    }
+
+    if (handler->tail == node)
+    {
+        node->p_before->p_after = NULL;
+        handler->tail = node->p_before;
+        goto fin;
+    }
+
+    node->p_before->p_after = node->p_after;
+    node->p_after->p_before = node->p_before;
+
+fin:
+    node->p_after = NULL;
+    node->p_before = NULL;
+}
+
+ev_list_node_t* ev_list_pop_front(ev_list_t* handler)
+{
+    ev_list_node_t* node = handler->head;
+    if (node == NULL)
+    {
+        return NULL;
+    }
+
+    ev_list_erase(handler, node);
+    return node;
+}
+
+ev_list_node_t* ev_list_pop_back(ev_list_t* handler)
+{
+    ev_list_node_t* node = handler->tail;
+    if (node == NULL)
+    {
+        return NULL;
+    }
+
+    ev_list_erase(handler, node);
+    return node;
+}
+
+size_t ev_list_size(const ev_list_t* handler)
+{
+    return handler->size;
+}
+
+void ev_list_migrate(ev_list_t* dst, ev_list_t* src)
+{
+    if (src->head == NULL)
+    {
+        return;
+    }
+
+    if (dst->tail == NULL)
+    {
+        *dst = *src;
+    }
+    else
+    {
+        dst->tail->p_after = src->head;
+        dst->tail->p_after->p_before = dst->tail;
+        dst->tail = src->tail;
+        dst->size += src->size;
+    }
+
+    src->head = NULL;
+    src->tail = NULL;
+    src->size = 0;
+}
+
+// #line 105 "ev.c"
+////////////////////////////////////////////////////////////////////////////////
+// FILE:    ev/log.c
+// SIZE:    1941
+// SHA-256: 43253f4df061cdd0745b3c136d51bab8120c246e48fb7c8878ecf0e1cc18bbb8
+////////////////////////////////////////////////////////////////////////////////
+// #line 1 "ev/log.c"
+#include <stdarg.h>
+#include <stdio.h>
+
+static const char* _ev_filename(const char* file)
+{
+    const char* pos = file;
+
+    for (; *file; ++file)
+    {
+        if (*file == '\\' || *file == '/')
+        {
+            pos = file + 1;
+        }
+    }
+    return pos;
+}
+
+static char _ev_ascii_to_char(unsigned char c)
+{
+    if (c >= 32 && c <= 126)
+    {
+        return c;
+    }
+    return '.';
+}
+
+EV_LOCAL void ev__log(ev_log_level_t level, const char* file, const char* func,
+    int line, const char* fmt, ...)
+{
+    va_list ap;
+    va_start(ap, fmt);
+
+    const char* prefix;
+    switch (level)
+    {
+    case EV_LOG_INFO:
+        prefix = "I";
+        break;
+    case EV_LOG_ERROR:
+        prefix = "E";
+        break;
+    case EV_LOG_FATAL:
+        prefix = "F";
+        break;
+    default:
+        prefix = "T";
+        break;
+    }
+
+    printf("[%s %s:%d %s] ", prefix, _ev_filename(file), line, func);
+    vprintf(fmt, ap);
+    printf("\n");
+
+    va_end(ap);
+}
+
+EV_LOCAL void ev__dump_hex(const void* data, size_t size, size_t width)
+{
+    const unsigned char* pdat = (unsigned char*)data;
+
+    size_t idx_line;
+    for (idx_line = 0; idx_line < size; idx_line += width)
+    {
+        size_t idx_colume;
+        /* printf hex */
+        for (idx_colume = 0; idx_colume < width; idx_colume++)
+        {
+            const char* postfix = (idx_colume < width - 1) ? "" : "|";
+
+            if (idx_colume + idx_line < size)
+            {
+                fprintf(stdout, "%02x %s", pdat[idx_colume + idx_line], postfix);
+            }
+            else
+            {
+                fprintf(stdout, "   %s", postfix);
+            }
+        }
+        fprintf(stdout, " ");
+        /* printf char */
+        for (idx_colume = 0; (idx_colume < width) && (idx_colume + idx_line < size); idx_colume++)
+        {
+            fprintf(stdout, "%c", _ev_ascii_to_char(pdat[idx_colume + idx_line]));
+        }
+        fprintf(stdout, "\n");
+    }
+
+}
+
+// #line 106 "ev.c"
+////////////////////////////////////////////////////////////////////////////////
+// FILE:    ev/loop.c
+// SIZE:    9227
+// SHA-256: 8d4e1bab768a972756371eba756ecc651705aa5d4d7586d3de9c3c2eff256b3b
+////////////////////////////////////////////////////////////////////////////////
+// #line 1 "ev/loop.c"
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <string.h>
+
+#if !defined(_WIN32)
+#   include <net/if.h>
+#   include <sys/un.h>
+#endif
+
+typedef struct ev_strerror_pair
+{
+    int             errn;           /**< Error number */
+    const char*     info;           /**< Error string */
+} ev_strerror_pair_t;
+
+static int _ev_loop_init(ev_loop_t* loop)
+{
+    memset(loop, 0, sizeof(*loop));
+
+    loop->hwtime = 0;
+    ev_list_init(&loop->handles.idle_list);
+    ev_list_init(&loop->handles.active_list);
+
+    ev_list_init(&loop->backlog_queue);
+    ev_list_init(&loop->endgame_queue);
+
+    ev__init_timer(loop);
+    ev__init_dns(loop);
+
+    loop->threadpool.pool = NULL;
+    loop->threadpool.node = (ev_list_node_t)EV_LIST_NODE_INIT;
+    ev_mutex_init(&loop->threadpool.mutex, 0);
+    ev_list_init(&loop->threadpool.work_queue);
+
+    ev__loop_link_to_default_threadpool(loop);
+
+    return 0;
+}
+
+static void _ev_loop_exit(ev_loop_t* loop)
+{
+    ev_mutex_exit(loop->threadpool.mutex);
+    ev_loop_unlink_threadpool(loop);
+}
+
+/**
+ * @return bool. non-zero for have active events.
+ */
+static int _ev_loop_alive(ev_loop_t* loop)
+{
+    return ev_list_size(&loop->handles.active_list)
+        || ev_list_size(&loop->backlog_queue)
+        || ev_list_size(&loop->endgame_queue);
+}
+
+static uint32_t _ev_backend_timeout_timer(ev_loop_t* loop)
+{
+    ev_map_node_t* it = ev_map_begin(&loop->timer.heap);
+    if (it == NULL)
+    {
+        return (uint32_t)-1;
+    }
+
+    ev_timer_t* timer = EV_CONTAINER_OF(it, ev_timer_t, node);
+    if (timer->data.active <= loop->hwtime)
+    {
+        return 0;
+    }
+    uint64_t dif = timer->data.active - loop->hwtime;
+    return dif > UINT32_MAX ? UINT32_MAX : (uint32_t)dif;
+}
+
+/**
+ * @brief Calculate wait timeout
+ * 
+ * Calculate timeout as small as posibile.
+ * 
+ * @param[in] loop  Event loop
+ * @return          Timeout in milliseconds
+ */
+static uint32_t _ev_backend_timeout(ev_loop_t* loop)
+{
+    if (loop->mask.b_stop)
+    {
+        return 0;
+    }
+
+    if (ev_list_size(&loop->backlog_queue) != 0 || ev_list_size(&loop->endgame_queue) != 0)
+    {
+        return 0;
+    }
+
+    return _ev_backend_timeout_timer(loop);
+}
+
+static size_t _ev_calculate_read_capacity(const ev_read_t* req)
+{
+    size_t total = 0;
+
+    size_t i;
+    for (i = 0; i < req->data.nbuf; i++)
+    {
+        total += req->data.bufs[i].size;
+    }
+
+    return total;
+}
+
+static size_t _ev_calculate_write_size(const ev_write_t* req)
+{
+    size_t total = 0;
+
+    size_t i;
+    for (i = 0; i < req->nbuf; i++)
+    {
+        total += req->bufs[i].size;
+    }
+    return total;
+}
+
+EV_LOCAL void ev__loop_update_time(ev_loop_t* loop)
+{
+    loop->hwtime = ev_hrtime() / 1000000;
+}
+
+EV_LOCAL int ev__ipc_check_frame_hdr(const void* buffer, size_t size)
+{
+    const ev_ipc_frame_hdr_t* hdr = buffer;
+    if (size < sizeof(ev_ipc_frame_hdr_t))
+    {
+        return 0;
+    }
+
+    if (hdr->hdr_magic != EV_IPC_FRAME_HDR_MAGIC)
+    {
+        return 0;
+    }
+
+    return 1;
+}
+
+EV_LOCAL void ev__ipc_init_frame_hdr(ev_ipc_frame_hdr_t* hdr, uint8_t flags, uint16_t exsz, uint32_t dtsz)
+{
+    hdr->hdr_magic = EV_IPC_FRAME_HDR_MAGIC;
+    hdr->hdr_flags = flags;
+    hdr->hdr_version = 0;
+    hdr->hdr_exsz = exsz;
+
+    hdr->hdr_dtsz = dtsz;
+    hdr->reserved = 0;
+}
+
+EV_LOCAL ev_loop_t* ev__handle_loop(ev_handle_t* handle)
+{
+    return handle->loop;
+}
+
+int ev_loop_init(ev_loop_t** loop)
+{
+    int ret;
+    ev_loop_t* new_loop = ev_malloc(sizeof(ev_loop_t));
+    if (new_loop == NULL)
+    {
+        return EV_ENOMEM;
+    }
+
+    if ((ret = _ev_loop_init(new_loop)) != 0)
+    {
+        ev_free(new_loop);
+        return ret;
+    }
+
+    if ((ret = ev__loop_init_backend(new_loop)) != 0)
+    {
+        _ev_loop_exit(new_loop);
+        ev_free(new_loop);
+        return ret;
+    }
+
+    ev__loop_update_time(new_loop);
+    *loop = new_loop;
+
+    return 0;
+}
+
+int ev_loop_exit(ev_loop_t* loop)
+{
+    if (ev_list_size(&loop->handles.active_list)
+        || ev_list_size(&loop->handles.idle_list))
+    {
+        return EV_EBUSY;
+    }
+
+    ev__exit_dns(loop);
+    ev__loop_exit_backend(loop);
+    _ev_loop_exit(loop);
+    ev_free(loop);
+
+    return 0;
+}
+
+int ev_loop_replace_allocator(ev_loop_t* loop, ev_loop_realloc_fn allocator,
+    void* arg)
+{
+    if (ev_list_size(&loop->handles.active_list)
+        || ev_list_size(&loop->handles.idle_list))
+    {
+        return EV_EBUSY;
+    }
+
+    /* Cache entries must be released by the allocator they come from */
+    ev__exit_dns(loop);
+
+    loop->allocator.fn = allocator;
+    loop->allocator.arg = allocator != NULL ? arg : NULL;
+
+    return 0;
+}
+
+void ev_loop_stop(ev_loop_t* loop)
+{
+    loop->mask.b_stop = 1;
+}
+
+static uint32_t _ev_loop_calculate_timeout(ev_loop_t* loop, ev_loop_mode_t mode, size_t active_count)
+{
+    if (mode == EV_LOOP_MODE_ONCE && active_count != 0)
+    {
+        return 0;
+    }
+
+    return _ev_backend_timeout(loop);
+}
+
+int ev_loop_run(ev_loop_t* loop, ev_loop_mode_t mode, uint32_t timeout)
+{
+    int ret;
+    size_t active_count = 0;
+
+    if (mode == EV_LOOP_MODE_NOWAIT)
+    {
+        timeout = 0;
+    }
+
+    ev__loop_update_time(loop);
+    const uint64_t start_time_ms = loop->hwtime;
+
+    while ((ret = _ev_loop_alive(loop)) != 0 && !loop->mask.b_stop)
+    {
+        ev__loop_update_time(loop);
+
+        active_count += ev__process_timer(loop);
+        active_count += ev__process_backlog(loop);
+        active_count += ev__process_endgame(loop);
+
+        if ((ret = _ev_loop_alive(loop)) == 0)
+        {
+            break;
+        }
+
+        /* IO multiplexing */
+        uint32_t loop_timeout = _ev_loop_calculate_timeout(loop, mode, active_count);
+        loop_timeout = EV_MIN(loop_timeout, timeout);
+        ev__poll(loop, loop_timeout);
+
+        /**
+         * #EV_LOOP_MODE_ONCE implies forward progress: at least one callback must have
+         * been invoked when it returns. #_ev_poll_win() can return without doing
+         * I/O (meaning: no callbacks) when its timeout expires - which means we
+         * have pending timers that satisfy the forward progress constraint.
+         *
+         * #EV_LOOP_MODE_NOWAIT makes no guarantees about progress so it's omitted from
+         * the check.
+         */
+        ev__loop_update_time(loop);
+        const uint32_t diff_time_ms = (uint32_t)(loop->hwtime - start_time_ms);
+
+        active_count += ev__process_timer(loop);
+        active_count += ev__process_backlog(loop);
+        active_count += ev__process_endgame(loop);
+
+        if (timeout != EV_INFINITE_TIMEOUT)
+        {
+            timeout = timeout > diff_time_ms ? timeout - diff_time_ms : 0;
+        }
+        if (timeout == 0 || (mode == EV_LOOP_MODE_ONCE && active_count != 0))
+        {
+            break;
+        }
+    }
+
+    /* Prevent #ev_loop_t::mask::b_stop from compile optimization */
+    if (loop->mask.b_stop)
+    {
+        loop->mask.b_stop = 0;
+    }
+
+    return ret;
+}
+
+EV_LOCAL int ev__write_init(ev_write_t* req, ev_buf_t* bufs, size_t nbuf)
+{
+    req->nbuf = nbuf;
+
+    if (nbuf <= ARRAY_SIZE(req->bufsml))
+    {
+        req->bufs = req->bufsml;
+    }
+    else
+    {
+        req->bufs = ev_malloc(sizeof(ev_buf_t) * nbuf);
+        if (req->bufs == NULL)
+        {
+            return EV_ENOMEM;
+        }
+    }
+
+    memcpy(req->bufs, bufs, sizeof(ev_buf_t) * nbuf);
+    req->size = 0;
+    req->capacity = _ev_calculate_write_size(req);
+    return 0;
+}
+
+EV_LOCAL void ev__write_exit(ev_write_t* req)
+{
+    if (req->bufs != req->bufsml)
+    {
+        ev_free(req->bufs);
+    }
+
+    req->bufs = NULL;
+    req->nbuf = 0;
+}
+
+EV_LOCAL int ev__read_init(ev_read_t* req, ev_buf_t* bufs, size_t nbuf)
+{
+    req->data.nbuf = nbuf;
+
+    if (nbuf <= ARRAY_SIZE(req->data.bufsml))
+    {
+        req->data.bufs = req->data.bufsml;
+    }
+    else
+    {
+        req->data.bufs = ev_malloc(sizeof(ev_buf_t) * nbuf);
+        if (req->data.bufs == NULL)
+        {
+            return EV_ENOMEM;
+        }
+    }
+
+    memcpy(req->data.bufs, bufs, sizeof(ev_buf_t) * nbuf);
+    req->data.capacity = _ev_calculate_read_capacity(req);
+    req->data.size = 0;
+    return 0;
+}
+
+EV_LOCAL void ev__read_exit(ev_read_t* req)
+{
+    if (req->data.bufs != req->data.bufsml)
+    {
+        ev_free(req->data.bufs);
+    }
+    req->data.bufs = NULL;
+    req->data.nbuf = 0;
+}
+
+EV_LOCAL socklen_t ev__get_addr_len(const struct sockaddr* addr)
+{
+    if (addr->sa_family == AF_INET)
+    {
+        return sizeof(struct sockaddr_in);
+    }
+    if (addr->sa_family == AF_INET6)
+    {
+        return sizeof(struct sockaddr_in6);
+    }
+#if defined(AF_UNIX) && !defined(_WIN32)
+    if (addr->sa_family == AF_UNIX)
+    {
+        return sizeof(struct sockaddr_un);
+    }
+#endif
+
+    return (socklen_t)-1;
+}
+
+void ev_loop_walk(ev_loop_t* loop, ev_walk_cb cb, void* arg)
+{
+    ev_list_t* walk_lists[] = {
+        &loop->handles.active_list,
+        &loop->handles.idle_list,
+    };
+
+    size_t i;
+    for (i = 0; i < ARRAY_SIZE(walk_lists); i++)
+    {
+        ev_list_node_t* it = ev_list_begin(walk_lists[i]);
+        for (; it != NULL; it = ev_list_next(it))
+        {
+            ev_handle_t* handle = EV_CONTAINER_OF(it, ev_handle_t, handle_queue);
+            if (cb(handle, arg) != 0)
+            {
+                return;
+            }
+        }
+    }
+}
+
+// #line 107 "ev.c"
+////////////////////////////////////////////////////////////////////////////////
+// FILE:    ev/map.c
+// SIZE:    23122
+// SHA-256: a59516f016393afb28e7da797a13f70950fafde010d6ceb77b9968bc4899afec
+////////////////////////////////////////////////////////////////////////////////
+// #line 1 "ev/map.c"
+#include <stdint.h>
+#include <inttypes.h>
+#include <stddef.h>
+
+/*
+* red-black trees properties:  http://en.wikipedia.org/wiki/Rbtree
+*
+*  1) A node is either red or black
+*  2) The root is black
+*  3) All leaves (NULL) are black
+*  4) Both children of every red node are black
+*  5) Every simple path from root to leaves contains the same number
+*     of black nodes.
+*
+*  4 and 5 give the O(log n) guarantee, since 4 implies you cannot have two
+*  consecutive red nodes in a path and every red node is therefore followed by
+*  a black. So if B is the number of black nodes on every simple path (as per
+*  5), then the longest possible path due to 4 is 2B.
+*
+*  We shall indicate color with case, where black nodes are uppercase and red
+*  nodes will be lowercase. Unknown color nodes shall be drawn as red within
+*  parentheses and have some accompanying text comment.
+*/
+
+#define RB_RED      0
+#define RB_BLACK    1
+
+#define __rb_color(pc)     ((uintptr_t)(pc) & 1)
+#define __rb_is_black(pc)  __rb_color(pc)
+#define __rb_is_red(pc)    (!__rb_color(pc))
+#define __rb_parent(pc)    ((ev_map_node_t*)(pc & ~3))
+#define rb_color(rb)       __rb_color((rb)->__rb_parent_color)
+#define rb_is_red(rb)      __rb_is_red((rb)->__rb_parent_color)
+#define rb_is_black(rb)    __rb_is_black((rb)->__rb_parent_color)
+#define rb_parent(r)   ((ev_map_node_t*)((uintptr_t)((r)->__rb_parent_color) & ~3))
+
+/* 'empty' nodes are nodes that are known not to be inserted in an rbtree */
+#define RB_EMPTY_NODE(node)  \
+    ((node)->__rb_parent_color == (struct ev_map_node*)(node))
+
+static void rb_set_black(ev_map_node_t *rb)
+{
+    rb->__rb_parent_color =
+        (ev_map_node_t*)((uintptr_t)(rb->__rb_parent_color) | RB_BLACK);
+}
+
+static ev_map_node_t *rb_red_parent(ev_map_node_t *red)
+{
+    return (ev_map_node_t*)red->__rb_parent_color;
+}
+
+static void rb_set_parent_color(ev_map_node_t *rb, ev_map_node_t *p, int color)
+{
+    rb->__rb_parent_color = (struct ev_map_node*)((uintptr_t)p | color);
+}
+
+static void __rb_change_child(ev_map_node_t* old_node, ev_map_node_t* new_node,
+    ev_map_node_t* parent, ev_map_t* root)
+{
+    if (parent)
+    {
+        if (parent->rb_left == old_node)
+        {
+            parent->rb_left = new_node;
+        }
+        else
+        {
+            parent->rb_right = new_node;
+        }
+    }
+    else
+    {
+        root->rb_root = new_node;
+    }
+}
+
+/*
+* Helper function for rotations:
+* - old's parent and color get assigned to new
+* - old gets assigned new as a parent and 'color' as a color.
+*/
+static void __rb_rotate_set_parents(ev_map_node_t* old, ev_map_node_t* new_node,
+    ev_map_t* root, int color)
+{
+    ev_map_node_t* parent = rb_parent(old);
+    new_node->__rb_parent_color = old->__rb_parent_color;
+    rb_set_parent_color(old, new_node, color);
+    __rb_change_child(old, new_node, parent, root);
+}
+
+static void __rb_insert(ev_map_node_t* node, ev_map_t* root)
+{
+    ev_map_node_t* parent = rb_red_parent(node), *gparent, *tmp;
+
+    for (;;) {
+        /*
+        * Loop invariant: node is red
+        *
+        * If there is a black parent, we are done.
+        * Otherwise, take some corrective action as we don't
+        * want a red root or two consecutive red nodes.
+        */
+        if (!parent) {
+            rb_set_parent_color(node, NULL, RB_BLACK);
+            break;
+        }
+        else if (rb_is_black(parent))
+            break;
+
+        gparent = rb_red_parent(parent);
+
+        tmp = gparent->rb_right;
+        if (parent != tmp) {    /* parent == gparent->rb_left */
+            if (tmp && rb_is_red(tmp)) {
+                /*
+                * Case 1 - color flips
+                *
+                *       G            g
+                *      / \          / \
+                *     p   u  -->   P   U
+                *    /            /
+                *   n            n
+                *
+                * However, since g's parent might be red, and
+                * 4) does not allow this, we need to recurse
+                * at g.
+                */
+                rb_set_parent_color(tmp, gparent, RB_BLACK);
+                rb_set_parent_color(parent, gparent, RB_BLACK);
+                node = gparent;
+                parent = rb_parent(node);
+                rb_set_parent_color(node, parent, RB_RED);
+                continue;
+            }
+
+            tmp = parent->rb_right;
+            if (node == tmp) {
+                /*
+                * Case 2 - left rotate at parent
+                *
+                *      G             G
+                *     / \           / \
+                *    p   U  -->    n   U
+                *     \           /
+                *      n         p
+                *
+                * This still leaves us in violation of 4), the
+                * continuation into Case 3 will fix that.
+                */
+                parent->rb_right = tmp = node->rb_left;
+                node->rb_left = parent;
+                if (tmp)
+                    rb_set_parent_color(tmp, parent,
+                    RB_BLACK);
+                rb_set_parent_color(parent, node, RB_RED);
+                parent = node;
+                tmp = node->rb_right;
+            }
+
+            /*
+            * Case 3 - right rotate at gparent
+            *
+            *        G           P
+            *       / \         / \
+            *      p   U  -->  n   g
+            *     /                 \
+            *    n                   U
+            */
+            gparent->rb_left = tmp;  /* == parent->rb_right */
+            parent->rb_right = gparent;
+            if (tmp)
+                rb_set_parent_color(tmp, gparent, RB_BLACK);
+            __rb_rotate_set_parents(gparent, parent, root, RB_RED);
+            break;
+        }
+        else {
+            tmp = gparent->rb_left;
+            if (tmp && rb_is_red(tmp)) {
+                /* Case 1 - color flips */
+                rb_set_parent_color(tmp, gparent, RB_BLACK);
+                rb_set_parent_color(parent, gparent, RB_BLACK);
+                node = gparent;
+                parent = rb_parent(node);
+                rb_set_parent_color(node, parent, RB_RED);
+                continue;
+            }
+
+            tmp = parent->rb_left;
+            if (node == tmp) {
+                /* Case 2 - right rotate at parent */
+                parent->rb_left = tmp = node->rb_right;
+                node->rb_right = parent;
+                if (tmp)
+                    rb_set_parent_color(tmp, parent,
+                    RB_BLACK);
+                rb_set_parent_color(parent, node, RB_RED);
+                parent = node;
+                tmp = node->rb_left;
+            }
+
+            /* Case 3 - left rotate at gparent */
+            gparent->rb_right = tmp;  /* == parent->rb_left */
+            parent->rb_left = gparent;
+            if (tmp)
+                rb_set_parent_color(tmp, gparent, RB_BLACK);
+            __rb_rotate_set_parents(gparent, parent, root, RB_RED);
+            break;
+        }
+    }
+}
+
+static void rb_set_parent(ev_map_node_t* rb, ev_map_node_t*p)
+{
+    rb->__rb_parent_color = (struct ev_map_node*)(rb_color(rb) | (uintptr_t)p);
+}
+
+static ev_map_node_t* __rb_erase_augmented(ev_map_node_t* node, ev_map_t* root)
+{
+    ev_map_node_t *child = node->rb_right, *tmp = node->rb_left;
+    ev_map_node_t *parent, *rebalance;
+    uintptr_t pc;
+
+    if (!tmp) {
+        /*
+        * Case 1: node to erase has no more than 1 child (easy!)
+        *
+        * Note that if there is one child it must be red due to 5)
+        * and node must be black due to 4). We adjust colors locally
+        * so as to bypass __rb_erase_color() later on.
+        */
+        pc = (uintptr_t)(node->__rb_parent_color);
+        parent = __rb_parent(pc);
+        __rb_change_child(node, child, parent, root);
+        if (child) {
+            child->__rb_parent_color = (struct ev_map_node*)pc;
+            rebalance = NULL;
+        }
+        else
+            rebalance = __rb_is_black(pc) ? parent : NULL;
+        tmp = parent;
+    }
+    else if (!child) {
+        /* Still case 1, but this time the child is node->rb_left */
+        pc = (uintptr_t)(node->__rb_parent_color);
+        tmp->__rb_parent_color = (ev_map_node_t*)pc;
+        parent = __rb_parent(pc);
+        __rb_change_child(node, tmp, parent, root);
+        rebalance = NULL;
+        tmp = parent;
+    }
+    else {
+        ev_map_node_t* successor = child, *child2;
+        tmp = child->rb_left;
+        if (!tmp) {
+            /*
+            * Case 2: node's successor is its right child
+            *
+            *    (n)          (s)
+            *    / \          / \
+            *  (x) (s)  ->  (x) (c)
+            *        \
+            *        (c)
+            */
+            parent = successor;
+            child2 = successor->rb_right;
+        }
+        else {
+            /*
+            * Case 3: node's successor is leftmost under
+            * node's right child subtree
+            *
+            *    (n)          (s)
+            *    / \          / \
+            *  (x) (y)  ->  (x) (y)
+            *      /            /
+            *    (p)          (p)
+            *    /            /
+            *  (s)          (c)
+            *    \
+            *    (c)
+            */
+            do {
+                parent = successor;
+                successor = tmp;
+                tmp = tmp->rb_left;
+            } while (tmp);
+            parent->rb_left = child2 = successor->rb_right;
+            successor->rb_right = child;
+            rb_set_parent(child, successor);
+        }
+
+        successor->rb_left = tmp = node->rb_left;
+        rb_set_parent(tmp, successor);
+
+        pc = (uintptr_t)(node->__rb_parent_color);
+        tmp = __rb_parent(pc);
+        __rb_change_child(node, successor, tmp, root);
+        if (child2) {
+            successor->__rb_parent_color = (struct ev_map_node*)pc;
+            rb_set_parent_color(child2, parent, RB_BLACK);
+            rebalance = NULL;
+        }
+        else {
+            uintptr_t pc2 = (uintptr_t)(successor->__rb_parent_color);
+            successor->__rb_parent_color = (struct ev_map_node*)pc;
+            rebalance = __rb_is_black(pc2) ? parent : NULL;
+        }
+        tmp = successor;
+    }
+
+    return rebalance;
+}
+
+/*
+* Inline version for rb_erase() use - we want to be able to inline
+* and eliminate the dummy_rotate callback there
+*/
+static void
+____rb_erase_color(ev_map_node_t* parent, ev_map_t* root)
+{
+    ev_map_node_t* node = NULL, *sibling, *tmp1, *tmp2;
+
+    for (;;) {
+        /*
+        * Loop invariants:
+        * - node is black (or NULL on first iteration)
+        * - node is not the root (parent is not NULL)
+        * - All leaf paths going through parent and node have a
+        *   black node count that is 1 lower than other leaf paths.
+        */
+        sibling = parent->rb_right;
+        if (node != sibling) {  /* node == parent->rb_left */
+            if (rb_is_red(sibling)) {
+                /*
+                * Case 1 - left rotate at parent
+                *
+                *     P               S
+                *    / \             / \
+                *   N   s    -->    p   Sr
+                *      / \         / \
+                *     Sl  Sr      N   Sl
+                */
                 parent->rb_right = tmp1 = sibling->rb_left;
                 sibling->rb_left = parent;
                 rb_set_parent_color(tmp1, parent, RB_BLACK);
@@ -18217,1325 +23717,2215 @@ ____rb_erase_color(ev_map_node_t* parent, ev_map_t* root)
                 tmp1 = sibling;
                 sibling = tmp2;
             }
-            /*
-            * Case 4 - left rotate at parent + color flips
-            * (p and sl could be either color here.
-            *  After rotation, p becomes black, s acquires
-            *  p's color, and sl keeps its color)
-            *
-            *      (p)             (s)
-            *      / \             / \
-            *     N   S     -->   P   Sr
-            *        / \         / \
-            *      (sl) sr      N  (sl)
-            */
-            parent->rb_right = tmp2 = sibling->rb_left;
-            sibling->rb_left = parent;
-            rb_set_parent_color(tmp1, sibling, RB_BLACK);
-            if (tmp2)
-                rb_set_parent(tmp2, parent);
-            __rb_rotate_set_parents(parent, sibling, root,
-                RB_BLACK);
+            /*
+            * Case 4 - left rotate at parent + color flips
+            * (p and sl could be either color here.
+            *  After rotation, p becomes black, s acquires
+            *  p's color, and sl keeps its color)
+            *
+            *      (p)             (s)
+            *      / \             / \
+            *     N   S     -->   P   Sr
+            *        / \         / \
+            *      (sl) sr      N  (sl)
+            */
+            parent->rb_right = tmp2 = sibling->rb_left;
+            sibling->rb_left = parent;
+            rb_set_parent_color(tmp1, sibling, RB_BLACK);
+            if (tmp2)
+                rb_set_parent(tmp2, parent);
+            __rb_rotate_set_parents(parent, sibling, root,
+                RB_BLACK);
+            break;
+        }
+        else {
+            sibling = parent->rb_left;
+            if (rb_is_red(sibling)) {
+                /* Case 1 - right rotate at parent */
+                parent->rb_left = tmp1 = sibling->rb_right;
+                sibling->rb_right = parent;
+                rb_set_parent_color(tmp1, parent, RB_BLACK);
+                __rb_rotate_set_parents(parent, sibling, root,
+                    RB_RED);
+                sibling = tmp1;
+            }
+            tmp1 = sibling->rb_left;
+            if (!tmp1 || rb_is_black(tmp1)) {
+                tmp2 = sibling->rb_right;
+                if (!tmp2 || rb_is_black(tmp2)) {
+                    /* Case 2 - sibling color flip */
+                    rb_set_parent_color(sibling, parent,
+                        RB_RED);
+                    if (rb_is_red(parent))
+                        rb_set_black(parent);
+                    else {
+                        node = parent;
+                        parent = rb_parent(node);
+                        if (parent)
+                            continue;
+                    }
+                    break;
+                }
+                /* Case 3 - right rotate at sibling */
+                sibling->rb_right = tmp1 = tmp2->rb_left;
+                tmp2->rb_left = sibling;
+                parent->rb_left = tmp2;
+                if (tmp1)
+                    rb_set_parent_color(tmp1, sibling,
+                    RB_BLACK);
+                tmp1 = sibling;
+                sibling = tmp2;
+            }
+            /* Case 4 - left rotate at parent + color flips */
+            parent->rb_left = tmp2 = sibling->rb_right;
+            sibling->rb_right = parent;
+            rb_set_parent_color(tmp1, sibling, RB_BLACK);
+            if (tmp2)
+                rb_set_parent(tmp2, parent);
+            __rb_rotate_set_parents(parent, sibling, root,
+                RB_BLACK);
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Inserting data into the tree.
+ *
+ * The insert instead must be implemented
+ * in two steps: First, the code must insert the element in order as a red leaf
+ * in the tree, and then the support library function #_ev_map_low_insert_color
+ * must be called.
+ *
+ * @param node      The node you want to insert
+ * @param parent    The position you want to insert
+ * @param rb_link   Will be set to `node`
+ * @see _ev_map_low_insert_color
+ */
+static void _ev_map_low_link_node(ev_map_node_t* node,
+    ev_map_node_t* parent, ev_map_node_t** rb_link)
+{
+    node->__rb_parent_color = parent;
+    node->rb_left = node->rb_right = NULL;
+
+    *rb_link = node;
+    return;
+}
+
+/**
+ * @brief re-balancing ("recoloring") the tree.
+ * @param node      The node just linked
+ * @param root      The map
+ * @see eaf_map_low_link_node
+ */
+static void _ev_map_low_insert_color(ev_map_node_t* node, ev_map_t* root)
+{
+    __rb_insert(node, root);
+}
+
+/**
+ * @brief Delete the node from the map.
+ * @warning The node must already in the map.
+ * @param root      The pointer to the map
+ * @param node      The node
+ */
+static void _ev_map_low_erase(ev_map_t* root, ev_map_node_t* node)
+{
+    ev_map_node_t* rebalance;
+    rebalance = __rb_erase_augmented(node, root);
+    if (rebalance)
+        ____rb_erase_color(rebalance, root);
+}
+
+/**
+ * @brief Returns an iterator to the beginning
+ * @param root      The pointer to the map
+ * @return          An iterator
+ */
+static ev_map_node_t* _ev_map_low_first(const ev_map_t* root)
+{
+    ev_map_node_t* n = root->rb_root;
+
+    if (!n)
+        return NULL;
+    while (n->rb_left)
+        n = n->rb_left;
+    return n;
+}
+
+/**
+ * @brief Returns an iterator to the end
+ * @param root      The pointer to the map
+ * @return          An iterator
+ */
+static ev_map_node_t* _ev_map_low_last(const ev_map_t* root)
+{
+    ev_map_node_t* n = root->rb_root;
+
+    if (!n)
+        return NULL;
+    while (n->rb_right)
+        n = n->rb_right;
+    return n;
+}
+
+/**
+ * @brief Get an iterator next to the given one.
+ * @param node      Current iterator
+ * @return          Next iterator
+ */
+static ev_map_node_t* _ev_map_low_next(const ev_map_node_t* node)
+{
+    ev_map_node_t* parent;
+
+    if (RB_EMPTY_NODE(node))
+        return NULL;
+
+    /*
+    * If we have a right-hand child, go down and then left as far
+    * as we can.
+    */
+    if (node->rb_right) {
+        node = node->rb_right;
+        while (node->rb_left)
+            node = node->rb_left;
+        return (ev_map_node_t *)node;
+    }
+
+    /*
+    * No right-hand children. Everything down and left is smaller than us,
+    * so any 'next' node must be in the general direction of our parent.
+    * Go up the tree; any time the ancestor is a right-hand child of its
+    * parent, keep going up. First time it's a left-hand child of its
+    * parent, said parent is our 'next' node.
+    */
+    while ((parent = rb_parent(node)) != NULL && node == parent->rb_right)
+        node = parent;
+
+    return parent;
+}
+
+/**
+ * @brief Get an iterator before the given one.
+ * @param node      Current iterator
+ * @return          Previous iterator
+ */
+static ev_map_node_t* _ev_map_low_prev(const ev_map_node_t* node)
+{
+    ev_map_node_t* parent;
+
+    if (RB_EMPTY_NODE(node))
+        return NULL;
+
+    /*
+    * If we have a left-hand child, go down and then right as far
+    * as we can.
+    */
+    if (node->rb_left) {
+        node = node->rb_left;
+        while (node->rb_right)
+            node = node->rb_right;
+        return (ev_map_node_t *)node;
+    }
+
+    /*
+    * No left-hand children. Go up till we find an ancestor which
+    * is a right-hand child of its parent.
+    */
+    while ((parent = rb_parent(node)) != NULL && node == parent->rb_left)
+        node = parent;
+
+    return parent;
+}
+
+void ev_map_init(ev_map_t* handler, ev_map_cmp_fn cmp, void* arg)
+{
+    handler->rb_root = NULL;
+    handler->cmp.cmp = cmp;
+    handler->cmp.arg = arg;
+    handler->size = 0;
+}
+
+ev_map_node_t* ev_map_insert(ev_map_t* handler, ev_map_node_t* node)
+{
+    ev_map_node_t **new_node = &(handler->rb_root), *parent = NULL;
+
+    /* Figure out where to put new node */
+    while (*new_node)
+    {
+        int result = handler->cmp.cmp(node, *new_node, handler->cmp.arg);
+
+        parent = *new_node;
+        if (result < 0)
+        {
+            new_node = &((*new_node)->rb_left);
+        }
+        else if (result > 0)
+        {
+            new_node = &((*new_node)->rb_right);
+        }
+        else
+        {
+            return *new_node;
+        }
+    }
+
+    handler->size++;
+    _ev_map_low_link_node(node, parent, new_node);
+    _ev_map_low_insert_color(node, handler);
+
+    return NULL;
+}
+
+void ev_map_erase(ev_map_t* handler, ev_map_node_t* node)
+{
+    handler->size--;
+    _ev_map_low_erase(handler, node);
+}
+
+size_t ev_map_size(const ev_map_t* handler)
+{
+    return handler->size;
+}
+
+ev_map_node_t* ev_map_find(const ev_map_t* handler, const ev_map_node_t* key)
+{
+    ev_map_node_t* node = handler->rb_root;
+
+    while (node)
+    {
+        int result = handler->cmp.cmp(key, node, handler->cmp.arg);
+
+        if (result < 0)
+        {
+            node = node->rb_left;
+        }
+        else if (result > 0)
+        {
+            node = node->rb_right;
+        }
+        else
+        {
+            return node;
+        }
+    }
+
+    return NULL;
+}
+
+ev_map_node_t* ev_map_find_lower(const ev_map_t* handler, const ev_map_node_t* key)
+{
+    ev_map_node_t* lower_node = NULL;
+    ev_map_node_t* node = handler->rb_root;
+    while (node)
+    {
+        int result = handler->cmp.cmp(key, node, handler->cmp.arg);
+        if (result < 0)
+        {
+            node = node->rb_left;
+        }
+        else if (result > 0)
+        {
+            lower_node = node;
+            node = node->rb_right;
+        }
+        else
+        {
+            return node;
+        }
+    }
+
+    return lower_node;
+}
+
+ev_map_node_t* ev_map_find_upper(const ev_map_t* handler, const ev_map_node_t* key)
+{
+    ev_map_node_t* upper_node = NULL;
+    ev_map_node_t* node = handler->rb_root;
+
+    while (node)
+    {
+        int result = handler->cmp.cmp(key, node, handler->cmp.arg);
+
+        if (result < 0)
+        {
+            upper_node = node;
+            node = node->rb_left;
+        }
+        else if (result > 0)
+        {
+            node = node->rb_right;
+        }
+        else
+        {
+            if (upper_node == NULL)
+            {
+                upper_node = node->rb_right;
+            }
             break;
         }
-        else {
-            sibling = parent->rb_left;
-            if (rb_is_red(sibling)) {
-                /* Case 1 - right rotate at parent */
-                parent->rb_left = tmp1 = sibling->rb_right;
-                sibling->rb_right = parent;
-                rb_set_parent_color(tmp1, parent, RB_BLACK);
-                __rb_rotate_set_parents(parent, sibling, root,
-                    RB_RED);
-                sibling = tmp1;
-            }
-            tmp1 = sibling->rb_left;
-            if (!tmp1 || rb_is_black(tmp1)) {
-                tmp2 = sibling->rb_right;
-                if (!tmp2 || rb_is_black(tmp2)) {
-                    /* Case 2 - sibling color flip */
-                    rb_set_parent_color(sibling, parent,
-                        RB_RED);
-                    if (rb_is_red(parent))
-                        rb_set_black(parent);
-                    else {
-                        node = parent;
-                        parent = rb_parent(node);
-                        if (parent)
-                            continue;
-                    }
-                    break;
-                }
-                /* Case 3 - right rotate at sibling */
-                sibling->rb_right = tmp1 = tmp2->rb_left;
-                tmp2->rb_left = sibling;
-                parent->rb_left = tmp2;
-                if (tmp1)
-                    rb_set_parent_color(tmp1, sibling,
-                    RB_BLACK);
-                tmp1 = sibling;
-                sibling = tmp2;
-            }
-            /* Case 4 - left rotate at parent + color flips */
-            parent->rb_left = tmp2 = sibling->rb_right;
-            sibling->rb_right = parent;
-            rb_set_parent_color(tmp1, sibling, RB_BLACK);
-            if (tmp2)
-                rb_set_parent(tmp2, parent);
-            __rb_rotate_set_parents(parent, sibling, root,
-                RB_BLACK);
-            break;
+    }
+
+    return upper_node;
+}
+
+ev_map_node_t* ev_map_begin(const ev_map_t* handler)
+{
+    return _ev_map_low_first(handler);
+}
+
+ev_map_node_t* ev_map_end(const ev_map_t* handler)
+{
+    return _ev_map_low_last(handler);
+}
+
+ev_map_node_t* ev_map_next(const ev_map_node_t* node)
+{
+    return _ev_map_low_next(node);
+}
+
+ev_map_node_t* ev_map_prev(const ev_map_node_t* node)
+{
+    return _ev_map_low_prev(node);
+}
+
+// #line 108 "ev.c"
+////////////////////////////////////////////////////////////////////////////////
+// FILE:    ev/misc.c
+// SIZE:    4675
+// SHA-256: d78fa3b24dd333847e25caf4acd1babea4b3cdbbb42401522c2dee83c076c3be
+////////////////////////////////////////////////////////////////////////////////
+// #line 1 "ev/misc.c"
+#include <assert.h>
+#include <string.h>
+
+#if !defined(_WIN32)
+#   include <net/if.h>
+#   include <sys/un.h>
+#endif
+
+static void _ev_set_scope_id(struct sockaddr_in6* addr, const char* ip)
+{
+    const char* zone_index = strchr(ip, '%');
+    if (zone_index == NULL)
+    {
+        return;
+    }
+
+    char address_part[40];
+    size_t address_part_size = zone_index - ip;
+    if (address_part_size >= sizeof(address_part))
+    {
+        address_part_size = sizeof(address_part) - 1;
+    }
+
+    memcpy(address_part, ip, address_part_size);
+    address_part[address_part_size] = '\0';
+    ip = address_part;
+
+    zone_index++; /* skip '%' */
+    /* NOTE: unknown interface (id=0) is silently ignored */
+#ifdef _WIN32
+    addr->sin6_scope_id = atoi(zone_index);
+#else
+    addr->sin6_scope_id = if_nametoindex(zone_index);
+#endif
+}
+
+static void _ev_random_on_work(ev_work_t* work)
+{
+    ev_random_req_t* req = EV_CONTAINER_OF(work, ev_random_req_t, work);
+    req->ret = ev__random(req->buf, req->len);
+}
+
+static void _ev_random_on_done(ev_work_t* work, int status)
+{
+    ev_random_req_t* req = EV_CONTAINER_OF(work, ev_random_req_t, work);
+    status = status != 0 ? status : req->ret;
+    req->cb(req, status, req->buf, req->len);
+}
+
+int ev_ipv4_addr(const char* ip, int port, struct sockaddr_in* addr)
+{
+    memset(addr, 0, sizeof(*addr));
+
+    addr->sin_family = AF_INET;
+    addr->sin_port = htons((uint16_t)port);
+
+    return inet_pton(AF_INET, ip, &addr->sin_addr) ? 0 : EV_EINVAL;
+}
+
+int ev_ipv6_addr(const char* ip, int port, struct sockaddr_in6* addr)
+{
+    memset(addr, 0, sizeof(*addr));
+
+    addr->sin6_family = AF_INET6;
+    addr->sin6_port = htons((uint16_t)port);
+    _ev_set_scope_id(addr, ip);
+
+    return inet_pton(AF_INET6, ip, &addr->sin6_addr) ? 0 : EV_EINVAL;
+}
+
+int ev_ipv4_name(const struct sockaddr_in* addr, int* port, char* ip, size_t len)
+{
+    if (port != NULL)
+    {
+        *port = ntohs(addr->sin_port);
+    }
+
+    if (ip != NULL)
+    {
+        return inet_ntop(AF_INET, &addr->sin_addr, ip, len) != NULL ?
+            0 : EV_ENOSPC;
+    }
+
+    return 0;
+}
+
+int ev_ipv6_name(const struct sockaddr_in6* addr, int* port, char* ip, size_t len)
+{
+    if (port != NULL)
+    {
+        *port = ntohs(addr->sin6_port);
+    }
+
+    if (ip != NULL)
+    {
+        return inet_ntop(AF_INET6, &addr->sin6_addr, ip, len) != NULL ?
+            0 : EV_ENOSPC;
+    }
+
+    return 0;
+}
+
+int ev_ip_addr(const char* ip, int port, struct sockaddr* addr, size_t size)
+{
+    if (strstr(ip, ":") != NULL)
+    {
+        if (size < sizeof(struct sockaddr_in6))
+        {
+            return EV_EINVAL;
+        }
+        return ev_ipv6_addr(ip, port, (struct sockaddr_in6*)addr);
+    }
+
+    if (size < sizeof(struct sockaddr_in))
+    {
+        return EV_EINVAL;
+    }
+    return ev_ipv4_addr(ip, port, (struct sockaddr_in*)addr);
+}
+
+int ev_ip_name(const struct sockaddr* addr, int* port, char* ip, size_t len)
+{
+    if (addr->sa_family == AF_INET)
+    {
+        return ev_ipv4_name((struct sockaddr_in*)addr, port, ip, len);
+    }
+    return ev_ipv6_name((struct sockaddr_in6*)addr, port, ip, len);
+}
+
+ev_buf_t ev_buf_make(void* buf, size_t len)
+{
+    ev_buf_t tmp;
+
+#if defined(_WIN32)
+    tmp.data = (CHAR*)buf;
+    tmp.size = (ULONG)len;
+#else
+    tmp.data = buf;
+    tmp.size = len;
+#endif
+
+    return tmp;
+}
+
+void ev_buf_make_n(ev_buf_t bufs[], size_t nbuf, ...)
+{
+    va_list ap;
+    va_start(ap, nbuf);
+    ev_buf_make_v(bufs, nbuf, ap);
+    va_end(ap);
+}
+
+void ev_buf_make_v(ev_buf_t bufs[], size_t nbuf, va_list ap)
+{
+    size_t i;
+    for (i = 0; i < nbuf; i++)
+    {
+        void* v_b = va_arg(ap, void*);
+        size_t v_l = va_arg(ap, size_t);
+        bufs[i] = ev_buf_make(v_b, v_l);
+    }
+}
+
+EV_LOCAL int ev__translate_posix_sys_error(int syserr)
+{
+#define EV_EXPAND_ERRMAP(err, syserr, str) case syserr: return err;
+
+    switch (syserr)
+    {
+    /* Success */
+    case 0:                 return 0;
+#if EWOULDBLOCK != EAGAIN
+    case EWOULDBLOCK:       return EV_EAGAIN;
+#endif
+    EV_ERRNO_POSIX_MAP(EV_EXPAND_ERRMAP);
+
+    /* Unknown */
+    default:                break;
+    }
+
+    EV_ABORT("unknown system errno %d.", syserr);
+
+#undef EV_EXPAND_ERRMAP
+}
+
+void ev_library_shutdown(void)
+{
+    ev__backend_shutdown();
+    ev_threadpool_default_cleanup();
+    ev__atomic_exit();
+}
+
+EV_API int ev_random(ev_loop_t* loop, ev_random_req_t* req, void* buf,
+    size_t len, int flags, ev_random_cb cb)
+{
+    if (loop == NULL)
+    {
+        return ev__random(buf, len);
+    }
+
+    req->buf = buf;
+    req->len = len;
+    req->flags = flags;
+    req->cb = cb;
+    req->ret = 0;
+    return ev_loop_queue_work(loop, &req->work, _ev_random_on_work, _ev_random_on_done);
+}
+
+// #line 109 "ev.c"
+////////////////////////////////////////////////////////////////////////////////
+// FILE:    ev/pipe.c
+// SIZE:    2961
+// SHA-256: 64694c6d1a5aa43c96bc6d35cd9869828158839bcdeac3e9c00853f5a9cb343e
+////////////////////////////////////////////////////////////////////////////////
+// #line 1 "ev/pipe.c"
+
+int ev_pipe_write(ev_pipe_t *pipe, ev_buf_t *bufs, size_t nbuf,
+                  ev_pipe_write_cb cb, void *arg)
+{
+    return ev_pipe_write_ex(pipe, bufs, nbuf, EV_ROLE_UNKNOWN, NULL, cb, arg);
+}
+
+EV_LOCAL int ev__pipe_read_init(ev_pipe_read_req_t *req, ev_buf_t *bufs,
+                                size_t nbuf, ev_pipe_read_cb cb)
+{
+    int ret;
+    if ((ret = ev__read_init(&req->base, bufs, nbuf)) != 0)
+    {
+        return ret;
+    }
+    req->ucb = cb;
+
+    req->handle.num = 0;
+    req->handle.pos = 0;
+    return 0;
+}
+
+EV_LOCAL int ev__pipe_write_init(ev_pipe_write_req_t *req, ev_buf_t *bufs,
+                                 size_t nbuf, ev_pipe_write_cb cb, void *arg)
+{
+    return ev__pipe_write_init_ext(req, cb, arg, bufs, nbuf, EV_ROLE_UNKNOWN,
+                                   NULL, 0);
+}
+
+static int _ev_pipe_get_os_socket(ev_role_t handle_role, void *handle_addr,
+                                  ev_os_socket_t *sock)
+{
+    switch (handle_role)
+    {
+    case EV_ROLE_EV_TCP:
+        if (((ev_tcp_t *)handle_addr)->base.data.role != EV_ROLE_EV_TCP)
+        {
+            return EV_EINVAL;
+        }
+        *sock = ((ev_tcp_t *)handle_addr)->sock;
+        return 0;
+
+    case EV_ROLE_EV_SHM_CHANNEL:
+        return ev__shm_channel_doorbell(handle_addr, sock);
+
+        /* not support other type */
+    default:
+        break;
+    }
+
+    return EV_EINVAL;
+}
+
+EV_LOCAL int ev__pipe_write_init_ext(ev_pipe_write_req_t *req,
+                                     ev_pipe_write_cb cb, void *arg,
+                                     ev_buf_t *bufs, size_t nbuf,
+                                     ev_role_t handle_role, void **handle_addrs,
+                                     size_t handle_num)
+{
+    int ret;
+    if (handle_num > EV_PIPE_IPC_HANDLE_MAX)
+    {
+        return EV_E2BIG;
+    }
+    if ((ret = ev__write_init(&req->base, bufs, nbuf)) != 0)
+    {
+        return ret;
+    }
+    req->ucb = cb;
+    req->ucb_arg = arg;
+
+    /* no handle need to send */
+    req->handle.role = EV_ROLE_UNKNOWN;
+    req->handle.num = 0;
+    if (handle_role == EV_ROLE_UNKNOWN || handle_num == 0)
+    {
+        return 0;
+    }
+
+    size_t i;
+    for (i = 0; i < handle_num; i++)
+    {
+        if (handle_addrs[i] == NULL)
+        {
+            return EV_EINVAL;
+        }
+        ret = _ev_pipe_get_os_socket(handle_role, handle_addrs[i],
+                                     &req->handle.os_socket[i]);
+        if (ret != 0)
+        {
+            return ret;
         }
     }
+    req->handle.role = handle_role;
+    req->handle.num = handle_num;
+
+    return 0;
 }
 
-/**
- * @brief Inserting data into the tree.
- *
- * The insert instead must be implemented
- * in two steps: First, the code must insert the element in order as a red leaf
- * in the tree, and then the support library function #_ev_map_low_insert_color
- * must be called.
- *
- * @param node      The node you want to insert
- * @param parent    The position you want to insert
- * @param rb_link   Will be set to `node`
- * @see _ev_map_low_insert_color
- */
-static void _ev_map_low_link_node(ev_map_node_t* node,
-    ev_map_node_t* parent, ev_map_node_t** rb_link)
+int ev_pipe_write_ex(ev_pipe_t *pipe, ev_buf_t *bufs, size_t nbuf,
+                     ev_role_t handle_role, void *handle_addr,
+                     ev_pipe_write_cb cb, void *arg)
 {
-    node->__rb_parent_color = parent;
-    node->rb_left = node->rb_right = NULL;
+    size_t handle_num = handle_role != EV_ROLE_UNKNOWN ? 1 : 0;
+    return ev_pipe_write_handles(pipe, bufs, nbuf, handle_role, &handle_addr,
+                                 handle_num, cb, arg);
+}
 
-    *rb_link = node;
-    return;
+// #line 110 "ev.c"
+////////////////////////////////////////////////////////////////////////////////
+// FILE:    ev/queue.c
+// SIZE:    1816
+// SHA-256: 9468974292682b6b1e084aa8faf5023eb1daa8ab6fedc554f1e451c0c9124fac
+////////////////////////////////////////////////////////////////////////////////
+// #line 1 "ev/queue.c"
+#include <stdlib.h>
+
+#define EV_QUEUE_NEXT(node)         ((node)->p_next)
+#define EV_QUEUE_PREV(node)         ((node)->p_prev)
+#define EV_QUEUE_PREV_NEXT(node)    (EV_QUEUE_NEXT(EV_QUEUE_PREV(node)))
+#define EV_QUEUE_NEXT_PREV(node)    (EV_QUEUE_PREV(EV_QUEUE_NEXT(node)))
+
+void ev_queue_init(ev_queue_node_t* head)
+{
+    EV_QUEUE_NEXT(head) = head;
+    EV_QUEUE_PREV(head) = head;
 }
 
-/**
- * @brief re-balancing ("recoloring") the tree.
- * @param node      The node just linked
- * @param root      The map
- * @see eaf_map_low_link_node
- */
-static void _ev_map_low_insert_color(ev_map_node_t* node, ev_map_t* root)
+void ev_queue_push_back(ev_queue_node_t* head, ev_queue_node_t* node)
 {
-    __rb_insert(node, root);
+    EV_QUEUE_NEXT(node) = head;
+    EV_QUEUE_PREV(node) = EV_QUEUE_PREV(head);
+    EV_QUEUE_PREV_NEXT(node) = node;
+    EV_QUEUE_PREV(head) = node;
 }
 
-/**
- * @brief Delete the node from the map.
- * @warning The node must already in the map.
- * @param root      The pointer to the map
- * @param node      The node
- */
-static void _ev_map_low_erase(ev_map_t* root, ev_map_node_t* node)
+void ev_queue_push_front(ev_queue_node_t* head, ev_queue_node_t* node)
 {
-    ev_map_node_t* rebalance;
-    rebalance = __rb_erase_augmented(node, root);
-    if (rebalance)
-        ____rb_erase_color(rebalance, root);
+    EV_QUEUE_NEXT(node) = EV_QUEUE_NEXT(head);
+    EV_QUEUE_PREV(node) = head;
+    EV_QUEUE_NEXT_PREV(node) = node;
+    EV_QUEUE_NEXT(head) = node;
 }
 
-/**
- * @brief Returns an iterator to the beginning
- * @param root      The pointer to the map
- * @return          An iterator
- */
-static ev_map_node_t* _ev_map_low_first(const ev_map_t* root)
+void ev_queue_erase(ev_queue_node_t* node)
 {
-    ev_map_node_t* n = root->rb_root;
+    EV_QUEUE_PREV_NEXT(node) = EV_QUEUE_NEXT(node);
+    EV_QUEUE_NEXT_PREV(node) = EV_QUEUE_PREV(node);
+}
 
-    if (!n)
+ev_queue_node_t* ev_queue_pop_front(ev_queue_node_t* head)
+{
+    ev_queue_node_t* node = ev_queue_head(head);
+    if (node == NULL)
+    {
         return NULL;
-    while (n->rb_left)
-        n = n->rb_left;
-    return n;
+    }
+
+    ev_queue_erase(node);
+    return node;
 }
 
-/**
- * @brief Returns an iterator to the end
- * @param root      The pointer to the map
- * @return          An iterator
- */
-static ev_map_node_t* _ev_map_low_last(const ev_map_t* root)
+ev_queue_node_t* ev_queue_pop_back(ev_queue_node_t* head)
 {
-    ev_map_node_t* n = root->rb_root;
-
-    if (!n)
+    ev_queue_node_t* node = EV_QUEUE_PREV(head);
+    if (node == head)
+    {
         return NULL;
-    while (n->rb_right)
-        n = n->rb_right;
-    return n;
+    }
+
+    ev_queue_erase(node);
+    return node;
+}
+
+ev_queue_node_t* ev_queue_head(ev_queue_node_t* head)
+{
+    ev_queue_node_t* node = EV_QUEUE_NEXT(head);
+    return node == head ? NULL : node;
+}
+
+ev_queue_node_t* ev_queue_next(ev_queue_node_t* head, ev_queue_node_t* node)
+{
+    ev_queue_node_t* next = EV_QUEUE_NEXT(node);
+    return next == head ? NULL : next;
+}
+
+int ev_queue_empty(const ev_queue_node_t* node)
+{
+    return EV_QUEUE_NEXT(node) == node;
+}
+
+// #line 111 "ev.c"
+////////////////////////////////////////////////////////////////////////////////
+// FILE:    ev/ringbuffer.c
+// SIZE:    17440
+// SHA-256: 8ffd298ee30c5fb60ba540fcbf3262ae6197fd992dc226f964fba3bd44ec5cb9
+////////////////////////////////////////////////////////////////////////////////
+// #line 1 "ev/ringbuffer.c"
+
+#define EV_RB_BEG_POS(rb) \
+    sizeof((rb)->basis)
+
+#define EV_RB_BEG_NODE(rb)  \
+    EV_RB_NODE(rb, EV_RB_BEG_POS(rb))
+
+#define EV_RB_NODE(rb, pos)   \
+    ((ring_buffer_node_t*)((uintptr_t)&((rb)->basis) + (pos)))
+
+#define EV_RB_BASIS_DIFF(rb, ptr)   \
+    ((uintptr_t)(ptr) - (uintptr_t)&((rb)->basis))
+
+static void _ring_buffer_reinit(ring_buffer_t* rb)
+{
+    rb->counter.writing = 0;
+    rb->counter.committed = 0;
+    rb->counter.reading = 0;
+
+    rb->node.off_reserve = 0;
+    rb->node.off_HEAD = 0;
+    rb->node.off_TAIL = 0;
 }
 
 /**
- * @brief Get an iterator next to the given one.
- * @param node      Current iterator
- * @return          Next iterator
+ * @brief Create the first node in empty ring buffer.
+ * @param rb         ring buffer
+ * @param data_len   length of user data
+ * @param node_size  size of node
+ * @return           token
  */
-static ev_map_node_t* _ev_map_low_next(const ev_map_node_t* node)
+static ring_buffer_token_t* _ring_buffer_reserve_empty(ring_buffer_t* rb,
+    size_t data_len, size_t node_size)
 {
-    ev_map_node_t* parent;
-
-    if (RB_EMPTY_NODE(node))
+    /* check capacity */
+    if (node_size > rb->config.capacity)
+    {
         return NULL;
+    }
 
-    /*
-    * If we have a right-hand child, go down and then left as far
-    * as we can.
-    */
-    if (node->rb_right) {
-        node = node->rb_right;
-        while (node->rb_left)
-            node = node->rb_left;
-        return (ev_map_node_t *)node;
+    /* The value of ring_buffer_t::basis MUST be 0 */
+    rb->node.off_HEAD = EV_RB_BEG_POS(rb);
+
+    /* Initialize node */
+    {
+        ring_buffer_node_t* head = EV_RB_NODE(rb, rb->node.off_HEAD);
+        head->state = RINGBUFFER_STAT_WRITING;
+        head->token.size.size = data_len;
+
+        /* Initialize position chain */
+        head->chain_pos.off_next = rb->node.off_HEAD;
+        head->chain_pos.off_prev = rb->node.off_HEAD;
+
+        /* Initialize time chain */
+        head->chain_time.off_newer = 0;
+        head->chain_time.off_older = 0;
     }
 
-    /*
-    * No right-hand children. Everything down and left is smaller than us,
-    * so any 'next' node must be in the general direction of our parent.
-    * Go up the tree; any time the ancestor is a right-hand child of its
-    * parent, keep going up. First time it's a left-hand child of its
-    * parent, said parent is our 'next' node.
-    */
-    while ((parent = rb_parent(node)) != NULL && node == parent->rb_right)
-        node = parent;
+    /* Initialize other resources */
+    rb->node.off_TAIL = rb->node.off_HEAD;
+    rb->node.off_reserve = rb->node.off_HEAD;
+    rb->counter.writing++;
+
+    ring_buffer_node_t* rb_oldest_reserve = EV_RB_NODE(rb, rb->node.off_reserve);
+    return &rb_oldest_reserve->token;
+}
+
+/**
+ * @brief Update time chain for \p new_node
+ * @param rb         RingBuffer
+ * @param new_node   New node
+ */
+static void _ring_buffer_update_time_for_new_node(ring_buffer_t* rb,
+    ring_buffer_node_t* new_node)
+{
+    /* update chain_time */
+    new_node->chain_time.off_newer = 0;
+    new_node->chain_time.off_older = rb->node.off_HEAD;
+    EV_RB_NODE(rb, new_node->chain_time.off_older)->chain_time.off_newer = EV_RB_BASIS_DIFF(rb, new_node);
 
-    return parent;
+    /* update HEAD */
+    rb->node.off_HEAD = EV_RB_BASIS_DIFF(rb, new_node);
 }
 
 /**
- * @brief Get an iterator before the given one.
- * @param node      Current iterator
- * @return          Previous iterator
+ * @brief Perform overwrite
  */
-static ev_map_node_t* _ev_map_low_prev(const ev_map_node_t* node)
+static ring_buffer_token_t* _ring_buffer_perform_overwrite(
+    ring_buffer_t* rb, uint8_t* start_point, ring_buffer_node_t* node_start,
+    ring_buffer_node_t* node_end, size_t counter_lost_nodes,
+    size_t data_len)
 {
-    ev_map_node_t* parent;
-
-    if (RB_EMPTY_NODE(node))
-        return NULL;
+    ring_buffer_node_t* rb_tail = EV_RB_NODE(rb, rb->node.off_TAIL);
+    ring_buffer_node_t* newer_node = EV_RB_NODE(rb, node_end->chain_time.off_newer);
 
     /*
-    * If we have a left-hand child, go down and then right as far
-    * as we can.
-    */
-    if (node->rb_left) {
-        node = node->rb_left;
-        while (node->rb_right)
-            node = node->rb_right;
-        return (ev_map_node_t *)node;
+     * here [node_start, node_end] will be overwrite,
+     * so off_reserve need to move forward.
+     * if TAIL was overwrite, then move TAIL too.
+     */
+    if (rb_tail == EV_RB_NODE(rb, rb->node.off_reserve))
+    {
+        rb->node.off_TAIL = EV_RB_BASIS_DIFF(rb, newer_node);
     }
+    rb->node.off_reserve = EV_RB_BASIS_DIFF(rb, newer_node);
 
-    /*
-    * No left-hand children. Go up till we find an ancestor which
-    * is a right-hand child of its parent.
-    */
-    while ((parent = rb_parent(node)) != NULL && node == parent->rb_left)
-        node = parent;
-
-    return parent;
-}
-
-void ev_map_init(ev_map_t* handler, ev_map_cmp_fn cmp, void* arg)
-{
-    handler->rb_root = NULL;
-    handler->cmp.cmp = cmp;
-    handler->cmp.arg = arg;
-    handler->size = 0;
-}
+    /* generate new node */
+    ring_buffer_node_t* new_node = (ring_buffer_node_t*)start_point;
 
-ev_map_node_t* ev_map_insert(ev_map_t* handler, ev_map_node_t* node)
-{
-    ev_map_node_t **new_node = &(handler->rb_root), *parent = NULL;
+    /* Update position chain */
+    new_node->chain_pos.off_next = node_end->chain_pos.off_next;
+    EV_RB_NODE(rb, new_node->chain_pos.off_next)->chain_pos.off_prev = EV_RB_BASIS_DIFF(rb, new_node);
+    new_node->chain_pos.off_prev = node_start->chain_pos.off_prev;
+    EV_RB_NODE(rb, new_node->chain_pos.off_prev)->chain_pos.off_next = EV_RB_BASIS_DIFF(rb, new_node);
 
-    /* Figure out where to put new node */
-    while (*new_node)
+    /* Update time chain */
+    if (node_start->chain_time.off_older != 0)
     {
-        int result = handler->cmp.cmp(node, *new_node, handler->cmp.arg);
-
-        parent = *new_node;
-        if (result < 0)
-        {
-            new_node = &((*new_node)->rb_left);
-        }
-        else if (result > 0)
-        {
-            new_node = &((*new_node)->rb_right);
-        }
-        else
-        {
-            return *new_node;
-        }
+        EV_RB_NODE(rb, node_start->chain_time.off_older)->chain_time.off_newer =
+            node_end->chain_time.off_newer;
+    }
+    if (node_end->chain_time.off_newer != 0)
+    {
+        EV_RB_NODE(rb, node_end->chain_time.off_newer)->chain_time.off_older =
+            node_start->chain_time.off_older;
     }
+    _ring_buffer_update_time_for_new_node(rb, new_node);
 
-    handler->size++;
-    _ev_map_low_link_node(node, parent, new_node);
-    _ev_map_low_insert_color(node, handler);
+    /* Update counter */
+    rb->counter.committed -= counter_lost_nodes;
+    rb->counter.writing += 1;
 
-    return NULL;
-}
+    /* Update data length */
+    new_node->token.size.size = data_len;
 
-void ev_map_erase(ev_map_t* handler, ev_map_node_t* node)
-{
-    handler->size--;
-    _ev_map_low_erase(handler, node);
-}
+    /* Update node status */
+    new_node->state = RINGBUFFER_STAT_WRITING;
 
-size_t ev_map_size(const ev_map_t* handler)
-{
-    return handler->size;
+    return &new_node->token;
 }
 
-ev_map_node_t* ev_map_find(const ev_map_t* handler, const ev_map_node_t* key)
+/**
+ * @brief Try to overwrite
+ */
+static ring_buffer_token_t* _ring_buffer_reserve_try_overwrite(
+    ring_buffer_t* rb, size_t data_len, size_t node_size)
 {
-    ev_map_node_t* node = handler->rb_root;
-
-    while (node)
+    ring_buffer_node_t* rb_oldest_reserve = EV_RB_NODE(rb, rb->node.off_reserve);
+    /* Overwrite only works for committed nodes */
+    if (rb->node.off_reserve == 0
+        || rb_oldest_reserve->state != RINGBUFFER_STAT_COMMITTED)
     {
-        int result = handler->cmp.cmp(key, node, handler->cmp.arg);
-
-        if (result < 0)
-        {
-            node = node->rb_left;
-        }
-        else if (result > 0)
-        {
-            node = node->rb_right;
-        }
-        else
-        {
-            return node;
-        }
+        return NULL;
     }
 
-    return NULL;
-}
-
-ev_map_node_t* ev_map_find_lower(const ev_map_t* handler, const ev_map_node_t* key)
-{
-    ev_map_node_t* lower_node = NULL;
-    ev_map_node_t* node = handler->rb_root;
-    while (node)
+    /* Short cut: if only exists one node, check whether whole ring buffer can hold this data */
+    if (rb_oldest_reserve->chain_pos.off_next == rb->node.off_reserve)
     {
-        int result = handler->cmp.cmp(key, node, handler->cmp.arg);
-        if (result < 0)
-        {
-            node = node->rb_left;
-        }
-        else if (result > 0)
-        {
-            lower_node = node;
-            node = node->rb_right;
-        }
-        else
+        if (rb->config.capacity < node_size)
         {
-            return node;
+            return NULL;
         }
+
+        /* If we can, re-initialize and add this node */
+        _ring_buffer_reinit(rb);
+        return _ring_buffer_reserve_empty(rb, data_len, node_size);
     }
 
-    return lower_node;
-}
+    /* Step 1. Calculate where overwrite start */
+    const ring_buffer_node_t* backward_node = EV_RB_NODE(rb, rb_oldest_reserve->chain_pos.off_prev);
+    uint8_t* start_point = (backward_node < rb_oldest_reserve) ?
+        ((uint8_t*)backward_node + ring_buffer_node_cost(backward_node->token.size.size)) :
+        (uint8_t*)EV_RB_BEG_NODE(rb);
 
-ev_map_node_t* ev_map_find_upper(const ev_map_t* handler, const ev_map_node_t* key)
-{
-    ev_map_node_t* upper_node = NULL;
-    ev_map_node_t* node = handler->rb_root;
+    /* Step 2. Calculate whether continuous committed nodes could hold needed data */
+    size_t sum_size = 0;
+    size_t counter_lost_nodes = 1;
+    ring_buffer_node_t* node_end = rb_oldest_reserve;
 
-    while (node)
+    while (1)
     {
-        int result = handler->cmp.cmp(key, node, handler->cmp.arg);
+        sum_size = (uint8_t*)node_end + ring_buffer_node_cost(node_end->token.size.size) - (uint8_t*)start_point;
 
-        if (result < 0)
-        {
-            upper_node = node;
-            node = node->rb_left;
-        }
-        else if (result > 0)
-        {
-            node = node->rb_right;
-        }
-        else
+        ring_buffer_node_t* forward_of_node_end = EV_RB_NODE(rb, node_end->chain_pos.off_next);
+        if (!(sum_size < node_size /* overwrite minimum nodes */
+            && forward_of_node_end->state == RINGBUFFER_STAT_COMMITTED /* only overwrite committed node */
+            && node_end->chain_pos.off_next == node_end->chain_time.off_newer /* node must both physical and time continuous */
+            && forward_of_node_end > node_end /* cannot interrupt by array boundary */
+            ))
         {
-            if (upper_node == NULL)
-            {
-                upper_node = node->rb_right;
-            }
             break;
         }
+        node_end = EV_RB_NODE(rb, node_end->chain_pos.off_next);
+        counter_lost_nodes++;
     }
 
-    return upper_node;
-}
+    /* Step 3. check if condition allow to overwrite */
+    if (sum_size < node_size)
+    {
+        return NULL;
+    }
 
-ev_map_node_t* ev_map_begin(const ev_map_t* handler)
-{
-    return _ev_map_low_first(handler);
+    /* Step 4. perform overwrite */
+    return _ring_buffer_perform_overwrite(rb, start_point, rb_oldest_reserve,
+        node_end, counter_lost_nodes, data_len);
 }
 
-ev_map_node_t* ev_map_end(const ev_map_t* handler)
+inline static void _ring_buffer_insert_new_node(ring_buffer_t* rb,
+    ring_buffer_node_t* new_node, size_t data_len)
 {
-    return _ev_map_low_last(handler);
+    ring_buffer_node_t* rb_head = EV_RB_NODE(rb, rb->node.off_HEAD);
+
+    /* initialize token */
+    new_node->state = RINGBUFFER_STAT_WRITING;
+    new_node->token.size.size = data_len;
+
+    /* update chain_pos */
+    new_node->chain_pos.off_next = rb_head->chain_pos.off_next;
+    new_node->chain_pos.off_prev = rb->node.off_HEAD;
+    EV_RB_NODE(rb, new_node->chain_pos.off_next)->chain_pos.off_prev = EV_RB_BASIS_DIFF(rb, new_node);
+    EV_RB_NODE(rb, new_node->chain_pos.off_prev)->chain_pos.off_next = EV_RB_BASIS_DIFF(rb, new_node);
+
+    _ring_buffer_update_time_for_new_node(rb, new_node);
 }
 
-ev_map_node_t* ev_map_next(const ev_map_node_t* node)
+/**
+ * @brief Update off_reserve
+ */
+static void _ring_buffer_reserve_update_oldest_reserve(ring_buffer_t* rb,
+    ring_buffer_node_t* node)
 {
-    return _ev_map_low_next(node);
+    if (rb->node.off_reserve == 0)
+    {
+        rb->node.off_reserve = EV_RB_BASIS_DIFF(rb, node);
+    }
 }
 
-ev_map_node_t* ev_map_prev(const ev_map_node_t* node)
+static ring_buffer_token_t* _ring_buffer_reserve_none_empty(
+    ring_buffer_t* rb, size_t data_len, size_t node_size, int flags)
 {
-    return _ev_map_low_prev(node);
-}
-
-// #line 99 "ev.c"
-////////////////////////////////////////////////////////////////////////////////
-// FILE:    ev/misc.c
-// SIZE:    4675
-// SHA-256: d78fa3b24dd333847e25caf4acd1babea4b3cdbbb42401522c2dee83c076c3be
-////////////////////////////////////////////////////////////////////////////////
-// #line 1 "ev/misc.c"
-#include <assert.h>
-#include <string.h>
+    ring_buffer_node_t* rb_head = EV_RB_NODE(rb, rb->node.off_HEAD);
 
-#if !defined(_WIN32)
-#   include <net/if.h>
-#   include <sys/un.h>
-#endif
+    /**
+     * Get next possible node in right side of HEAD
+     * If there is a node exists, the address of that node is larger or equal to calculated address.
+     */
+    size_t next_possible_pos = rb->node.off_HEAD + ring_buffer_node_cost(rb_head->token.size.size);
+    ring_buffer_node_t* next_possible_node = EV_RB_NODE(rb, next_possible_pos);
 
-static void _ev_set_scope_id(struct sockaddr_in6* addr, const char* ip)
-{
-    const char* zone_index = strchr(ip, '%');
-    if (zone_index == NULL)
+    /* If have a existing node on right side of HEAD, we can use that space */
+    if (rb_head->chain_pos.off_next > rb->node.off_HEAD)
     {
-        return;
+        /* If space is enough, generate token */
+        if (rb_head->chain_pos.off_next - next_possible_pos >= node_size)
+        {
+            rb->counter.writing++;
+            _ring_buffer_insert_new_node(rb, next_possible_node, data_len);
+            _ring_buffer_reserve_update_oldest_reserve(rb, next_possible_node);
+            return &next_possible_node->token;
+        }
+
+        /* Otherwise overwrite */
+        return (flags & RINGBUFFER_FLAG_OVERWRITE) ?
+            _ring_buffer_reserve_try_overwrite(rb, data_len, node_size) :
+            NULL;
     }
 
-    char address_part[40];
-    size_t address_part_size = zone_index - ip;
-    if (address_part_size >= sizeof(address_part))
+    /* If no existing node on right side, try to create token */
+    if ((rb->config.capacity - (next_possible_pos - EV_RB_BEG_POS(rb))) >= node_size)
     {
-        address_part_size = sizeof(address_part) - 1;
+        rb->counter.writing++;
+        _ring_buffer_insert_new_node(rb, next_possible_node, data_len);
+        _ring_buffer_reserve_update_oldest_reserve(rb, next_possible_node);
+        return &next_possible_node->token;
     }
 
-    memcpy(address_part, ip, address_part_size);
-    address_part[address_part_size] = '\0';
-    ip = address_part;
-
-    zone_index++; /* skip '%' */
-    /* NOTE: unknown interface (id=0) is silently ignored */
-#ifdef _WIN32
-    addr->sin6_scope_id = atoi(zone_index);
-#else
-    addr->sin6_scope_id = if_nametoindex(zone_index);
-#endif
-}
+    /* if area on the most left cache is enough, make token */
+    if (rb_head->chain_pos.off_next - EV_RB_BEG_POS(rb) >= node_size)
+    {
+        next_possible_node = EV_RB_BEG_NODE(rb);
+        rb->counter.writing++;
+        _ring_buffer_insert_new_node(rb, next_possible_node, data_len);
+        _ring_buffer_reserve_update_oldest_reserve(rb, next_possible_node);
+        return &next_possible_node->token;
+    }
 
-static void _ev_random_on_work(ev_work_t* work)
-{
-    ev_random_req_t* req = EV_CONTAINER_OF(work, ev_random_req_t, work);
-    req->ret = ev__random(req->buf, req->len);
+    /* in other condition, overwrite if needed */
+    return (flags & RINGBUFFER_FLAG_OVERWRITE) ?
+        _ring_buffer_reserve_try_overwrite(rb, data_len, node_size) : NULL;
 }
 
-static void _ev_random_on_done(ev_work_t* work, int status)
+inline static int _ring_buffer_commit_for_write_confirm(ring_buffer_t* rb,
+    ring_buffer_node_t* node)
 {
-    ev_random_req_t* req = EV_CONTAINER_OF(work, ev_random_req_t, work);
-    status = status != 0 ? status : req->ret;
-    req->cb(req, status, req->buf, req->len);
-}
+    (void)rb;
 
-int ev_ipv4_addr(const char* ip, int port, struct sockaddr_in* addr)
-{
-    memset(addr, 0, sizeof(*addr));
+    /* Update counter */
+    rb->counter.writing--;
+    rb->counter.committed++;
 
-    addr->sin_family = AF_INET;
-    addr->sin_port = htons((uint16_t)port);
+    /* Update node status */
+    node->state = RINGBUFFER_STAT_COMMITTED;
 
-    return inet_pton(AF_INET, ip, &addr->sin_addr) ? 0 : EV_EINVAL;
+    return 0;
 }
 
-int ev_ipv6_addr(const char* ip, int port, struct sockaddr_in6* addr)
+/**
+ * @brief Update position chain and time chain after delete node.
+ * @param node   The node to delete
+ */
+static void _ring_buffer_delete_node_update_chain(ring_buffer_t* rb,
+    ring_buffer_node_t* node)
 {
-    memset(addr, 0, sizeof(*addr));
-
-    addr->sin6_family = AF_INET6;
-    addr->sin6_port = htons((uint16_t)port);
-    _ev_set_scope_id(addr, ip);
+    /* Update position chain */
+    EV_RB_NODE(rb, node->chain_pos.off_prev)->chain_pos.off_next = node->chain_pos.off_next;
+    EV_RB_NODE(rb, node->chain_pos.off_next)->chain_pos.off_prev = node->chain_pos.off_prev;
 
-    return inet_pton(AF_INET6, ip, &addr->sin6_addr) ? 0 : EV_EINVAL;
+    /* Update time chain */
+    if (node->chain_time.off_older != 0)
+    {
+        EV_RB_NODE(rb, node->chain_time.off_older)->chain_time.off_newer = node->chain_time.off_newer;
+    }
+    if (node->chain_time.off_newer != 0)
+    {
+        EV_RB_NODE(rb, node->chain_time.off_newer)->chain_time.off_older = node->chain_time.off_older;
+    }
 }
 
-int ev_ipv4_name(const struct sockaddr_in* addr, int* port, char* ip, size_t len)
+/**
+ * @brief Completely remove a node from ring buffer
+ * @param rb    ring buffer
+ * @param node  node to be delete
+ */
+static void _ring_buffer_delete_node(ring_buffer_t* rb,
+    ring_buffer_node_t* node)
 {
-    if (port != NULL)
+    /**
+     * Short cut: If only one node in ring buffer, re-initialize.
+     * Here use `p_forward` to check if it meets the condition:
+     * 1. `chain_pos.off_next` always point to next node. If it point to self, there is only one node.
+     * 2. Access to `node` means `node` is in CPU cache line. By access `p_forward` can avoid cache miss.
+     */
+    if (node->chain_pos.off_next == EV_RB_BASIS_DIFF(rb, node))
     {
-        *port = ntohs(addr->sin_port);
+        _ring_buffer_reinit(rb);
+        return;
     }
 
-    if (ip != NULL)
+    /* Delete node and update chains */
+    _ring_buffer_delete_node_update_chain(rb, node);
+
+    /* Update off_reserve */
+    if (rb->node.off_reserve == EV_RB_BASIS_DIFF(rb, node))
     {
-        return inet_ntop(AF_INET, &addr->sin_addr, ip, len) != NULL ?
-            0 : EV_ENOSPC;
+        rb->node.off_reserve = node->chain_time.off_newer;
     }
 
-    return 0;
-}
-
-int ev_ipv6_name(const struct sockaddr_in6* addr, int* port, char* ip, size_t len)
-{
-    if (port != NULL)
+    /* Update TAIL if necessary */
+    if (node->chain_time.off_older == 0)
     {
-        *port = ntohs(addr->sin6_port);
+        rb->node.off_TAIL = node->chain_time.off_newer;
+        return;
     }
 
-    if (ip != NULL)
+     /* Update HEAD if necessary */
+    if (node->chain_time.off_newer == 0)
     {
-        return inet_ntop(AF_INET6, &addr->sin6_addr, ip, len) != NULL ?
-            0 : EV_ENOSPC;
+        rb->node.off_HEAD = node->chain_time.off_older;
+        return;
     }
 
+    return;
+}
+
+static int _ring_buffer_commit_for_write_discard(ring_buffer_t* rb,
+    ring_buffer_node_t* node)
+{
+    rb->counter.writing--;
+    _ring_buffer_delete_node(rb, node);
     return 0;
 }
 
-int ev_ip_addr(const char* ip, int port, struct sockaddr* addr, size_t size)
+static int _ring_buffer_commit_for_write(ring_buffer_t* rb,
+    ring_buffer_node_t* node, int flags)
 {
-    if (strstr(ip, ":") != NULL)
+    return (flags & RINGBUFFER_FLAG_DISCARD) ?
+        _ring_buffer_commit_for_write_discard(rb, node) :
+        _ring_buffer_commit_for_write_confirm(rb, node);
+}
+
+static int _ring_buffer_commit_for_consume_confirm(ring_buffer_t* rb,
+    ring_buffer_node_t* node)
+{
+    rb->counter.reading--;
+    _ring_buffer_delete_node(rb, node);
+    return 0;
+}
+
+/**
+ * @brief Discard a consumed token.
+ * the only condition a consumed token can be discard is no one consume newer token
+ */
+static int _ring_buffer_commit_for_consume_discard(ring_buffer_t* rb,
+    ring_buffer_node_t* node, int flags)
+{
+    /* If existing a newer consumer, should fail. */
+    if (node->chain_time.off_newer != 0
+        && EV_RB_NODE(rb, node->chain_time.off_newer)->state == RINGBUFFER_STAT_READING)
     {
-        if (size < sizeof(struct sockaddr_in6))
-        {
-            return EV_EINVAL;
-        }
-        return ev_ipv6_addr(ip, port, (struct sockaddr_in6*)addr);
+        return (flags & RINGBUFFER_FLAG_ABANDON) ?
+            _ring_buffer_commit_for_consume_confirm(rb, node) : -1;
     }
 
-    if (size < sizeof(struct sockaddr_in))
+    /* Update counter and status */
+    rb->counter.reading--;
+    rb->counter.committed++;
+    node->state = RINGBUFFER_STAT_COMMITTED;
+
+    /* if no newer node, then off_reserve should point to this node */
+    if (node->chain_time.off_newer == 0)
     {
-        return EV_EINVAL;
+        rb->node.off_reserve = EV_RB_BASIS_DIFF(rb, node);
+        return 0;
     }
-    return ev_ipv4_addr(ip, port, (struct sockaddr_in*)addr);
-}
 
-int ev_ip_name(const struct sockaddr* addr, int* port, char* ip, size_t len)
-{
-    if (addr->sa_family == AF_INET)
+    /* if node is just older than off_reserve, then off_reserve should move back */
+    if (rb->node.off_reserve != 0
+        && EV_RB_NODE(rb, rb->node.off_reserve)->chain_time.off_older == EV_RB_BASIS_DIFF(rb, node))
     {
-        return ev_ipv4_name((struct sockaddr_in*)addr, port, ip, len);
+        rb->node.off_reserve = EV_RB_BASIS_DIFF(rb, node);
+        return 0;
     }
-    return ev_ipv6_name((struct sockaddr_in6*)addr, port, ip, len);
+
+    return 0;
 }
 
-ev_buf_t ev_buf_make(void* buf, size_t len)
+static int _ring_buffer_commit_for_consume(ring_buffer_t* rb,
+    ring_buffer_node_t* node, int flags)
 {
-    ev_buf_t tmp;
-
-#if defined(_WIN32)
-    tmp.data = (CHAR*)buf;
-    tmp.size = (ULONG)len;
-#else
-    tmp.data = buf;
-    tmp.size = len;
-#endif
-
-    return tmp;
+    return (flags & RINGBUFFER_FLAG_DISCARD) ?
+        _ring_buffer_commit_for_consume_discard(rb, node, flags) :
+        _ring_buffer_commit_for_consume_confirm(rb, node);
 }
 
-void ev_buf_make_n(ev_buf_t bufs[], size_t nbuf, ...)
+EV_LOCAL size_t ring_buffer_heap_cost(void)
 {
-    va_list ap;
-    va_start(ap, nbuf);
-    ev_buf_make_v(bufs, nbuf, ap);
-    va_end(ap);
+    /* need to align with machine size */
+    return EV_ALIGN_SIZE(sizeof(struct ring_buffer), sizeof(void*));
 }
 
-void ev_buf_make_v(ev_buf_t bufs[], size_t nbuf, va_list ap)
+EV_LOCAL size_t ring_buffer_node_cost(size_t size)
 {
-    size_t i;
-    for (i = 0; i < nbuf; i++)
-    {
-        void* v_b = va_arg(ap, void*);
-        size_t v_l = va_arg(ap, size_t);
-        bufs[i] = ev_buf_make(v_b, v_l);
-    }
+    return EV_ALIGN_SIZE(sizeof(ring_buffer_node_t) + size, sizeof(void*));
 }
 
-EV_LOCAL int ev__translate_posix_sys_error(int syserr)
+EV_LOCAL ring_buffer_t* ring_buffer_init(void* buffer, size_t size)
 {
-#define EV_EXPAND_ERRMAP(err, syserr, str) case syserr: return err;
+    /* Calculate start address */
+    ring_buffer_t* handler = buffer;
 
-    switch (syserr)
+    /* Check space size */
+    if (ring_buffer_heap_cost() + ring_buffer_node_cost(0) >= size)
     {
-    /* Success */
-    case 0:                 return 0;
-#if EWOULDBLOCK != EAGAIN
-    case EWOULDBLOCK:       return EV_EAGAIN;
-#endif
-    EV_ERRNO_POSIX_MAP(EV_EXPAND_ERRMAP);
-
-    /* Unknown */
-    default:                break;
+        return NULL;
     }
 
-    EV_ABORT("unknown system errno %d.", syserr);
+    /* setup necessary field */
+    handler->config.capacity = size - ring_buffer_heap_cost();
+    handler->basis = NULL;
 
-#undef EV_EXPAND_ERRMAP
+    /* initialize */
+    _ring_buffer_reinit(handler);
+
+    return handler;
 }
 
-void ev_library_shutdown(void)
+EV_LOCAL ring_buffer_token_t* ring_buffer_reserve(ring_buffer_t* handler, size_t len,
+    int flags)
 {
-    ev__backend_shutdown();
-    ev_threadpool_default_cleanup();
-    ev__atomic_exit();
+    /* node must aligned */
+    const size_t node_size = ring_buffer_node_cost(len);
+
+    /* empty ring buffer */
+    if (handler->node.off_TAIL == 0)
+    {
+        return _ring_buffer_reserve_empty(handler, len, node_size);
+    }
+
+    /* non empty ring buffer */
+    return _ring_buffer_reserve_none_empty(handler, len, node_size, flags);
 }
 
-EV_API int ev_random(ev_loop_t* loop, ev_random_req_t* req, void* buf,
-    size_t len, int flags, ev_random_cb cb)
+EV_LOCAL ring_buffer_token_t* ring_buffer_consume(ring_buffer_t* handler)
 {
-    if (loop == NULL)
+    ring_buffer_node_t* rb_oldest_reserve = EV_RB_NODE(handler, handler->node.off_reserve);
+    if (handler->node.off_reserve == 0
+        || rb_oldest_reserve->state != RINGBUFFER_STAT_COMMITTED)
     {
-        return ev__random(buf, len);
+        return NULL;
     }
 
-    req->buf = buf;
-    req->len = len;
-    req->flags = flags;
-    req->cb = cb;
-    req->ret = 0;
-    return ev_loop_queue_work(loop, &req->work, _ev_random_on_work, _ev_random_on_done);
-}
+    handler->counter.committed--;
+    handler->counter.reading++;
 
-// #line 100 "ev.c"
-////////////////////////////////////////////////////////////////////////////////
-// FILE:    ev/pipe.c
-// SIZE:    1714
-// SHA-256: 4a84bdd0058fc74e4ab519b0fe65b4017bb04b733daa5e99233e9c3c8e012dbd
-////////////////////////////////////////////////////////////////////////////////
-// #line 1 "ev/pipe.c"
+    ring_buffer_node_t* token_node = rb_oldest_reserve;
+    handler->node.off_reserve = rb_oldest_reserve->chain_time.off_newer;
+    token_node->state = RINGBUFFER_STAT_READING;
 
-int ev_pipe_write(ev_pipe_t *pipe, ev_buf_t *bufs, size_t nbuf,
-                  ev_pipe_write_cb cb, void *arg)
+    return &token_node->token;
+}
+
+EV_LOCAL int ring_buffer_commit(ring_buffer_t* handler, ring_buffer_token_t* token, int flags)
 {
-    return ev_pipe_write_ex(pipe, bufs, nbuf, EV_ROLE_UNKNOWN, NULL, cb, arg);
+    ring_buffer_node_t* node = EV_CONTAINER_OF(token, ring_buffer_node_t, token);
+
+    return node->state == RINGBUFFER_STAT_WRITING ?
+        _ring_buffer_commit_for_write(handler, node, flags) :
+        _ring_buffer_commit_for_consume(handler, node, flags);
 }
 
-EV_LOCAL int ev__pipe_read_init(ev_pipe_read_req_t *req, ev_buf_t *bufs,
-                                size_t nbuf, ev_pipe_read_cb cb)
+EV_LOCAL size_t ring_buffer_count(ring_buffer_t* handler, ring_buffer_counter_t* counter)
 {
-    int ret;
-    if ((ret = ev__read_init(&req->base, bufs, nbuf)) != 0)
+    if (counter != NULL)
     {
-        return ret;
+        *counter = handler->counter;
     }
-    req->ucb = cb;
 
-    req->handle.os_socket = EV_OS_SOCKET_INVALID;
-    return 0;
+    return handler->counter.committed + handler->counter.reading + handler->counter.writing;
 }
 
-EV_LOCAL int ev__pipe_write_init(ev_pipe_write_req_t *req, ev_buf_t *bufs,
-                                 size_t nbuf, ev_pipe_write_cb cb, void *arg)
+EV_LOCAL ring_buffer_token_t* ring_buffer_begin(const ring_buffer_t* handler)
 {
-    return ev__pipe_write_init_ext(req, cb, arg, bufs, nbuf, EV_ROLE_UNKNOWN,
-                                   NULL);
+    ring_buffer_node_t* rb_tail = EV_RB_NODE(handler, handler->node.off_TAIL);
+    return &(rb_tail->token);
 }
 
-EV_LOCAL int ev__pipe_write_init_ext(ev_pipe_write_req_t *req,
-                                     ev_pipe_write_cb cb, void *arg,
-                                     ev_buf_t *bufs, size_t nbuf,
-                                     ev_role_t handle_role, void *handle_addr)
+EV_LOCAL ring_buffer_token_t* ring_buffer_next(const ring_buffer_t* handler, const ring_buffer_token_t* token)
 {
-    int ret;
-    if ((ret = ev__write_init(&req->base, bufs, nbuf)) != 0)
-    {
-        return ret;
-    }
-    req->ucb = cb;
-    req->ucb_arg = arg;
-
-    req->handle.role = handle_role;
-    switch (handle_role)
+    ring_buffer_node_t* node = EV_CONTAINER_OF(token, ring_buffer_node_t, token);
+    if (node->chain_time.off_newer == 0)
     {
-        /* no handle need to send */
-    case EV_ROLE_UNKNOWN:
-        break;
-
-    case EV_ROLE_EV_TCP:
-        if (((ev_tcp_t *)handle_addr)->base.data.role != EV_ROLE_EV_TCP)
-        {
-            return EV_EINVAL;
-        }
-        req->handle.u.os_socket = ((ev_tcp_t *)handle_addr)->sock;
-        break;
-
-        /* not support other type */
-    default:
-        return EV_EINVAL;
+        return NULL;
     }
 
-    return 0;
+    node = EV_RB_NODE(handler, node->chain_time.off_newer);
+    return &(node->token);
 }
 
-// #line 101 "ev.c"
+// #line 112 "ev.c"
 ////////////////////////////////////////////////////////////////////////////////
-// FILE:    ev/queue.c
-// SIZE:    1816
-// SHA-256: 9468974292682b6b1e084aa8faf5023eb1daa8ab6fedc554f1e451c0c9124fac
+// FILE:    ev/shmem.c
+// SIZE:    129
+// SHA-256: f2d8bee7408dc4d79ec2b33c0f7fd2d1dc9d5d82f0e8df99fbe61a2b07f370ff
 ////////////////////////////////////////////////////////////////////////////////
-// #line 1 "ev/queue.c"
-#include <stdlib.h>
-
-#define EV_QUEUE_NEXT(node)         ((node)->p_next)
-#define EV_QUEUE_PREV(node)         ((node)->p_prev)
-#define EV_QUEUE_PREV_NEXT(node)    (EV_QUEUE_NEXT(EV_QUEUE_PREV(node)))
-#define EV_QUEUE_NEXT_PREV(node)    (EV_QUEUE_PREV(EV_QUEUE_NEXT(node)))
+// #line 1 "ev/shmem.c"
 
-void ev_queue_init(ev_queue_node_t* head)
+void* ev_shmem_addr(ev_shmem_t* shm)
 {
-    EV_QUEUE_NEXT(head) = head;
-    EV_QUEUE_PREV(head) = head;
+    return shm->addr;
 }
 
-void ev_queue_push_back(ev_queue_node_t* head, ev_queue_node_t* node)
+size_t ev_shmem_size(ev_shmem_t* shm)
 {
-    EV_QUEUE_NEXT(node) = head;
-    EV_QUEUE_PREV(node) = EV_QUEUE_PREV(head);
-    EV_QUEUE_PREV_NEXT(node) = node;
-    EV_QUEUE_PREV(head) = node;
+    return shm->size;
 }
 
-void ev_queue_push_front(ev_queue_node_t* head, ev_queue_node_t* node)
-{
-    EV_QUEUE_NEXT(node) = EV_QUEUE_NEXT(head);
-    EV_QUEUE_PREV(node) = head;
-    EV_QUEUE_NEXT_PREV(node) = node;
-    EV_QUEUE_NEXT(head) = node;
-}
+// #line 113 "ev.c"
+////////////////////////////////////////////////////////////////////////////////
+// FILE:    ev/tcp.c
+// SIZE:    8526
+// SHA-256: fb13cd5d64b4bab9edfdaf077d4462b6901cf99d3c5787d34a9ac5eaa37b4ecf
+////////////////////////////////////////////////////////////////////////////////
+// #line 1 "ev/tcp.c"
+/**
+ * @brief Options that only make sense on listen socket.
+ */
+#define EV_TCP_OPT_LISTEN_MASK                                                  \
+    ((1u << EV_TCP_OPT_DEFER_ACCEPT) | (1u << EV_TCP_OPT_FASTOPEN))
 
-void ev_queue_erase(ev_queue_node_t* node)
-{
-    EV_QUEUE_PREV_NEXT(node) = EV_QUEUE_NEXT(node);
-    EV_QUEUE_NEXT_PREV(node) = EV_QUEUE_PREV(node);
-}
+/**
+ * @brief Options that the kernel copies from listen socket to connection.
+ */
+#define EV_TCP_OPT_INHERIT_MASK                                                 \
+    ((1u << EV_TCP_OPT_NODELAY) | (1u << EV_TCP_OPT_KEEPALIVE) |               \
+     (1u << EV_TCP_OPT_SNDBUF) | (1u << EV_TCP_OPT_RCVBUF) |                   \
+     (1u << EV_TCP_OPT_NOTSENT_LOWAT) | (1u << EV_TCP_OPT_BUSY_POLL))
 
-ev_queue_node_t* ev_queue_pop_front(ev_queue_node_t* head)
+static int _ev_tcp_opt_apply_one(ev_tcp_t *sock, int opt)
 {
-    ev_queue_node_t* node = ev_queue_head(head);
-    if (node == NULL)
+    int ret, level, name;
+    if ((ret = ev__tcp_opt_native((ev_tcp_opt_t)opt, &level, &name)) != 0)
     {
-        return NULL;
+        return ret;
     }
-
-    ev_queue_erase(node);
-    return node;
-}
-
-ev_queue_node_t* ev_queue_pop_back(ev_queue_node_t* head)
-{
-    ev_queue_node_t* node = EV_QUEUE_PREV(head);
-    if (node == head)
+    if ((ret = ev__tcp_setsockopt(sock->sock, level, name,
+                                  sock->opts.val[opt])) != 0)
     {
-        return NULL;
+        return ret;
     }
 
-    ev_queue_erase(node);
-    return node;
+    sock->opts.pending &= ~(1u << opt);
+    return 0;
 }
 
-ev_queue_node_t* ev_queue_head(ev_queue_node_t* head)
+static void _ev_tcp_recycle_trim(ev_tcp_t *lisn, size_t capacity)
 {
-    ev_queue_node_t* node = EV_QUEUE_NEXT(head);
-    return node == head ? NULL : node;
+    ev_list_node_t *it;
+    while (ev_list_size(&lisn->recycle.idle_queue) > capacity)
+    {
+        it = ev_list_pop_front(&lisn->recycle.idle_queue);
+        ev_tcp_t *sock = EV_CONTAINER_OF(it, ev_tcp_t, recycle.node);
+        ev__loop_free(lisn->base.loop, sock);
+    }
 }
 
-ev_queue_node_t* ev_queue_next(ev_queue_node_t* head, ev_queue_node_t* node)
+EV_LOCAL void ev__tcp_opts_init(ev_tcp_t *sock)
 {
-    ev_queue_node_t* next = EV_QUEUE_NEXT(node);
-    return next == head ? NULL : next;
+    memset(&sock->opts, 0, sizeof(sock->opts));
 }
 
-int ev_queue_empty(const ev_queue_node_t* node)
+EV_LOCAL int ev__tcp_opts_apply(ev_tcp_t *sock, int listen)
 {
-    return EV_QUEUE_NEXT(node) == node;
-}
+    int      ret, opt;
+    unsigned todo = sock->opts.pending;
+    if (!listen)
+    {
+        todo &= ~EV_TCP_OPT_LISTEN_MASK;
+    }
 
-// #line 102 "ev.c"
-////////////////////////////////////////////////////////////////////////////////
-// FILE:    ev/ringbuffer.c
-// SIZE:    17440
-// SHA-256: 8ffd298ee30c5fb60ba540fcbf3262ae6197fd992dc226f964fba3bd44ec5cb9
-////////////////////////////////////////////////////////////////////////////////
-// #line 1 "ev/ringbuffer.c"
+    for (opt = 0; opt < EV_TCP_OPT_CNT; opt++)
+    {
+        if ((todo & (1u << opt)) &&
+            (ret = _ev_tcp_opt_apply_one(sock, opt)) != 0)
+        {
+            return ret;
+        }
+    }
 
-#define EV_RB_BEG_POS(rb) \
-    sizeof((rb)->basis)
+    return 0;
+}
 
-#define EV_RB_BEG_NODE(rb)  \
-    EV_RB_NODE(rb, EV_RB_BEG_POS(rb))
+EV_LOCAL void ev__tcp_opts_inherit(ev_tcp_t *conn, ev_tcp_t *lisn,
+                                   int by_kernel)
+{
+    int      opt;
+    unsigned copy =
+        lisn->opts.mask & ~EV_TCP_OPT_LISTEN_MASK & ~conn->opts.mask;
 
-#define EV_RB_NODE(rb, pos)   \
-    ((ring_buffer_node_t*)((uintptr_t)&((rb)->basis) + (pos)))
+    for (opt = 0; opt < EV_TCP_OPT_CNT; opt++)
+    {
+        if (copy & (1u << opt))
+        {
+            conn->opts.val[opt] = lisn->opts.val[opt];
+        }
+    }
+    conn->opts.mask |= copy;
+    conn->opts.pending |= by_kernel ? (copy & ~EV_TCP_OPT_INHERIT_MASK) : copy;
 
-#define EV_RB_BASIS_DIFF(rb, ptr)   \
-    ((uintptr_t)(ptr) - (uintptr_t)&((rb)->basis))
+    (void)ev__tcp_opts_apply(conn, 0);
+}
 
-static void _ring_buffer_reinit(ring_buffer_t* rb)
+EV_LOCAL void ev__tcp_recycle_init(ev_tcp_t *sock)
 {
-    rb->counter.writing = 0;
-    rb->counter.committed = 0;
-    rb->counter.reading = 0;
-
-    rb->node.off_reserve = 0;
-    rb->node.off_HEAD = 0;
-    rb->node.off_TAIL = 0;
+    sock->recycle.owner = NULL;
+    sock->recycle.node = (ev_list_node_t)EV_LIST_NODE_INIT;
+    ev_list_init(&sock->recycle.idle_queue);
+    ev_list_init(&sock->recycle.busy_queue);
+    sock->recycle.capacity = 0;
 }
 
-/**
- * @brief Create the first node in empty ring buffer.
- * @param rb         ring buffer
- * @param data_len   length of user data
- * @param node_size  size of node
- * @return           token
- */
-static ring_buffer_token_t* _ring_buffer_reserve_empty(ring_buffer_t* rb,
-    size_t data_len, size_t node_size)
+EV_LOCAL int ev__tcp_recycle(ev_tcp_t *sock)
 {
-    /* check capacity */
-    if (node_size > rb->config.capacity)
+    ev_tcp_t *lisn = sock->recycle.owner;
+    if (lisn == NULL)
     {
-        return NULL;
+        return 0;
     }
 
-    /* The value of ring_buffer_t::basis MUST be 0 */
-    rb->node.off_HEAD = EV_RB_BEG_POS(rb);
+    sock->recycle.owner = NULL;
+    ev_list_erase(&lisn->recycle.busy_queue, &sock->recycle.node);
 
-    /* Initialize node */
+    if (ev_list_size(&lisn->recycle.idle_queue) >= lisn->recycle.capacity)
     {
-        ring_buffer_node_t* head = EV_RB_NODE(rb, rb->node.off_HEAD);
-        head->state = RINGBUFFER_STAT_WRITING;
-        head->token.size.size = data_len;
+        return 0;
+    }
 
-        /* Initialize position chain */
-        head->chain_pos.off_next = rb->node.off_HEAD;
-        head->chain_pos.off_prev = rb->node.off_HEAD;
+    ev_list_push_back(&lisn->recycle.idle_queue, &sock->recycle.node);
+    return 1;
+}
 
-        /* Initialize time chain */
-        head->chain_time.off_newer = 0;
-        head->chain_time.off_older = 0;
+EV_LOCAL void ev__tcp_recycle_exit(ev_tcp_t *lisn)
+{
+    ev_list_node_t *it;
+    while ((it = ev_list_pop_front(&lisn->recycle.busy_queue)) != NULL)
+    {
+        ev_tcp_t *sock = EV_CONTAINER_OF(it, ev_tcp_t, recycle.node);
+        sock->recycle.owner = NULL;
     }
 
-    /* Initialize other resources */
-    rb->node.off_TAIL = rb->node.off_HEAD;
-    rb->node.off_reserve = rb->node.off_HEAD;
-    rb->counter.writing++;
-
-    ring_buffer_node_t* rb_oldest_reserve = EV_RB_NODE(rb, rb->node.off_reserve);
-    return &rb_oldest_reserve->token;
+    _ev_tcp_recycle_trim(lisn, 0);
+    lisn->recycle.capacity = 0;
 }
 
-/**
- * @brief Update time chain for \p new_node
- * @param rb         RingBuffer
- * @param new_node   New node
- */
-static void _ring_buffer_update_time_for_new_node(ring_buffer_t* rb,
-    ring_buffer_node_t* new_node)
+int ev_tcp_accept_cache(ev_tcp_t *lisn, size_t capacity)
 {
-    /* update chain_time */
-    new_node->chain_time.off_newer = 0;
-    new_node->chain_time.off_older = rb->node.off_HEAD;
-    EV_RB_NODE(rb, new_node->chain_time.off_older)->chain_time.off_newer = EV_RB_BASIS_DIFF(rb, new_node);
+    if (lisn->base.data.flags & EV_HANDLE_CLOSING)
+    {
+        return EV_EBADF;
+    }
 
-    /* update HEAD */
-    rb->node.off_HEAD = EV_RB_BASIS_DIFF(rb, new_node);
+    lisn->recycle.capacity = capacity;
+    _ev_tcp_recycle_trim(lisn, capacity);
+
+    return 0;
 }
 
-/**
- * @brief Perform overwrite
- */
-static ring_buffer_token_t* _ring_buffer_perform_overwrite(
-    ring_buffer_t* rb, uint8_t* start_point, ring_buffer_node_t* node_start,
-    ring_buffer_node_t* node_end, size_t counter_lost_nodes,
-    size_t data_len)
+int ev_tcp_init_accept(ev_tcp_t *lisn, ev_tcp_t **conn)
 {
-    ring_buffer_node_t* rb_tail = EV_RB_NODE(rb, rb->node.off_TAIL);
-    ring_buffer_node_t* newer_node = EV_RB_NODE(rb, node_end->chain_time.off_newer);
+    int             ret;
+    ev_tcp_t       *sock;
+    ev_list_node_t *it;
 
-    /*
-     * here [node_start, node_end] will be overwrite,
-     * so off_reserve need to move forward.
-     * if TAIL was overwrite, then move TAIL too.
-     */
-    if (rb_tail == EV_RB_NODE(rb, rb->node.off_reserve))
+    if (lisn->base.data.flags & EV_HANDLE_CLOSING)
     {
-        rb->node.off_TAIL = EV_RB_BASIS_DIFF(rb, newer_node);
+        return EV_EBADF;
+    }
+    if (!(lisn->base.data.flags & EV_HANDLE_TCP_LISTING))
+    {
+        return EV_EINVAL;
     }
-    rb->node.off_reserve = EV_RB_BASIS_DIFF(rb, newer_node);
 
-    /* generate new node */
-    ring_buffer_node_t* new_node = (ring_buffer_node_t*)start_point;
+    if ((it = ev_list_pop_front(&lisn->recycle.idle_queue)) != NULL)
+    {
+        sock = EV_CONTAINER_OF(it, ev_tcp_t, recycle.node);
+        ev__tcp_init(lisn->base.loop, sock);
+    }
+    else if ((ret = ev_tcp_init(lisn->base.loop, &sock)) != 0)
+    {
+        return ret;
+    }
 
-    /* Update position chain */
-    new_node->chain_pos.off_next = node_end->chain_pos.off_next;
-    EV_RB_NODE(rb, new_node->chain_pos.off_next)->chain_pos.off_prev = EV_RB_BASIS_DIFF(rb, new_node);
-    new_node->chain_pos.off_prev = node_start->chain_pos.off_prev;
-    EV_RB_NODE(rb, new_node->chain_pos.off_prev)->chain_pos.off_next = EV_RB_BASIS_DIFF(rb, new_node);
+    sock->recycle.owner = lisn;
+    ev_list_push_back(&lisn->recycle.busy_queue, &sock->recycle.node);
 
-    /* Update time chain */
-    if (node_start->chain_time.off_older != 0)
+    *conn = sock;
+    return 0;
+}
+
+int ev_tcp_setopt(ev_tcp_t *sock, ev_tcp_opt_t opt, int val)
+{
+    int ret, level, name;
+    if ((int)opt < 0 || (int)opt >= EV_TCP_OPT_CNT)
     {
-        EV_RB_NODE(rb, node_start->chain_time.off_older)->chain_time.off_newer =
-            node_end->chain_time.off_newer;
+        return EV_EINVAL;
     }
-    if (node_end->chain_time.off_newer != 0)
+    if ((ret = ev__tcp_opt_native(opt, &level, &name)) != 0)
     {
-        EV_RB_NODE(rb, node_end->chain_time.off_newer)->chain_time.off_older =
-            node_start->chain_time.off_older;
+        return ret;
     }
-    _ring_buffer_update_time_for_new_node(rb, new_node);
 
-    /* Update counter */
-    rb->counter.committed -= counter_lost_nodes;
-    rb->counter.writing += 1;
+    unsigned bit = 1u << opt;
+    int      old_val = sock->opts.val[opt];
+    unsigned old_mask = sock->opts.mask;
+    unsigned old_pending = sock->opts.pending;
 
-    /* Update data length */
-    new_node->token.size.size = data_len;
+    sock->opts.val[opt] = val;
+    sock->opts.mask |= bit;
+    sock->opts.pending |= bit;
 
-    /* Update node status */
-    new_node->state = RINGBUFFER_STAT_WRITING;
+    if (sock->sock == EV_OS_SOCKET_INVALID)
+    {
+        return 0;
+    }
+    if ((bit & EV_TCP_OPT_LISTEN_MASK) &&
+        !(sock->base.data.flags & EV_HANDLE_TCP_LISTING))
+    {
+        return 0;
+    }
 
-    return &new_node->token;
+    if ((ret = _ev_tcp_opt_apply_one(sock, opt)) != 0)
+    {
+        sock->opts.val[opt] = old_val;
+        sock->opts.mask = old_mask;
+        sock->opts.pending = old_pending;
+    }
+    return ret;
 }
 
-/**
- * @brief Try to overwrite
- */
-static ring_buffer_token_t* _ring_buffer_reserve_try_overwrite(
-    ring_buffer_t* rb, size_t data_len, size_t node_size)
+int ev_tcp_getopt(ev_tcp_t *sock, ev_tcp_opt_t opt, int *val)
 {
-    ring_buffer_node_t* rb_oldest_reserve = EV_RB_NODE(rb, rb->node.off_reserve);
-    /* Overwrite only works for committed nodes */
-    if (rb->node.off_reserve == 0
-        || rb_oldest_reserve->state != RINGBUFFER_STAT_COMMITTED)
+    int ret, level, name;
+    if ((int)opt < 0 || (int)opt >= EV_TCP_OPT_CNT)
     {
-        return NULL;
+        return EV_EINVAL;
+    }
+    if ((ret = ev__tcp_opt_native(opt, &level, &name)) != 0)
+    {
+        return ret;
     }
 
-    /* Short cut: if only exists one node, check whether whole ring buffer can hold this data */
-    if (rb_oldest_reserve->chain_pos.off_next == rb->node.off_reserve)
+    unsigned bit = 1u << opt;
+    if (sock->sock != EV_OS_SOCKET_INVALID && !(sock->opts.pending & bit))
     {
-        if (rb->config.capacity < node_size)
-        {
-            return NULL;
-        }
+        return ev__tcp_getsockopt(sock->sock, level, name, val);
+    }
+    if (sock->opts.mask & bit)
+    {
+        *val = sock->opts.val[opt];
+        return 0;
+    }
+    return EV_EBADF;
+}
 
-        /* If we can, re-initialize and add this node */
-        _ring_buffer_reinit(rb);
-        return _ring_buffer_reserve_empty(rb, data_len, node_size);
+static void _ev_tcp_info_hist_add(uint64_t *hist, uint64_t val)
+{
+    size_t idx = 0;
+    while (val != 0 && idx < EV_TCP_INFO_HIST_SIZE - 1)
+    {
+        val >>= 1;
+        idx++;
     }
+    hist[idx]++;
+}
 
-    /* Step 1. Calculate where overwrite start */
-    const ring_buffer_node_t* backward_node = EV_RB_NODE(rb, rb_oldest_reserve->chain_pos.off_prev);
-    uint8_t* start_point = (backward_node < rb_oldest_reserve) ?
-        ((uint8_t*)backward_node + ring_buffer_node_cost(backward_node->token.size.size)) :
-        (uint8_t*)EV_RB_BEG_NODE(rb);
+static int _ev_tcp_info_on_walk(ev_handle_t *handle, void *arg)
+{
+    ev_tcp_info_t       info;
+    ev_tcp_info_stat_t *stat = arg;
 
-    /* Step 2. Calculate whether continuous committed nodes could hold needed data */
-    size_t sum_size = 0;
-    size_t counter_lost_nodes = 1;
-    ring_buffer_node_t* node_end = rb_oldest_reserve;
+    if (handle->data.role != EV_ROLE_EV_TCP || ev__handle_is_closing(handle) ||
+        (handle->data.flags & EV_HANDLE_TCP_LISTING))
+    {
+        return 0;
+    }
 
-    while (1)
+    ev_tcp_t *sock = EV_CONTAINER_OF(handle, ev_tcp_t, base);
+    if (sock->sock == EV_OS_SOCKET_INVALID || ev_tcp_get_info(sock, &info) != 0)
     {
-        sum_size = (uint8_t*)node_end + ring_buffer_node_cost(node_end->token.size.size) - (uint8_t*)start_point;
+        return 0;
+    }
 
-        ring_buffer_node_t* forward_of_node_end = EV_RB_NODE(rb, node_end->chain_pos.off_next);
-        if (!(sum_size < node_size /* overwrite minimum nodes */
-            && forward_of_node_end->state == RINGBUFFER_STAT_COMMITTED /* only overwrite committed node */
-            && node_end->chain_pos.off_next == node_end->chain_time.off_newer /* node must both physical and time continuous */
-            && forward_of_node_end > node_end /* cannot interrupt by array boundary */
-            ))
-        {
-            break;
-        }
-        node_end = EV_RB_NODE(rb, node_end->chain_pos.off_next);
-        counter_lost_nodes++;
+    stat->sock_cnt++;
+    _ev_tcp_info_hist_add(stat->rtt, info.rtt);
+    _ev_tcp_info_hist_add(stat->snd_cwnd, info.snd_cwnd);
+    _ev_tcp_info_hist_add(stat->total_retrans, info.total_retrans);
+    _ev_tcp_info_hist_add(stat->delivery_rate, info.delivery_rate);
+
+    return 0;
+}
+
+static void _ev_tcp_sampler_on_timer(ev_timer_t *timer, void *arg)
+{
+    ev_tcp_sampler_t *sampler = arg;
+
+    ev_tcp_info_collect(timer->base.loop, &sampler->stat);
+    sampler->cb(sampler, &sampler->stat, sampler->arg);
+}
+
+static void _ev_tcp_sampler_on_close(ev_timer_t *timer, void *arg)
+{
+    ev_tcp_sampler_t *sampler = arg;
+    ev__loop_free(timer->base.loop, sampler);
+}
+
+void ev_tcp_info_collect(ev_loop_t *loop, ev_tcp_info_stat_t *stat)
+{
+    memset(stat, 0, sizeof(*stat));
+    ev_loop_walk(loop, _ev_tcp_info_on_walk, stat);
+}
+
+int ev_tcp_sampler_init(ev_loop_t *loop, ev_tcp_sampler_t **sampler,
+                        uint64_t interval, ev_tcp_sampler_cb cb, void *arg)
+{
+    int               ret;
+    ev_tcp_sampler_t *new_sampler;
+
+    if (interval == 0)
+    {
+        return EV_EINVAL;
     }
 
-    /* Step 3. check if condition allow to overwrite */
-    if (sum_size < node_size)
+    new_sampler = ev__loop_malloc(loop, EV_ALLOCATOR_TYPE_TCP,
+                                  sizeof(ev_tcp_sampler_t));
+    if (new_sampler == NULL)
     {
-        return NULL;
+        return EV_ENOMEM;
     }
 
-    /* Step 4. perform overwrite */
-    return _ring_buffer_perform_overwrite(rb, start_point, rb_oldest_reserve,
-        node_end, counter_lost_nodes, data_len);
+    if ((ret = ev_timer_init(loop, &new_sampler->timer)) != 0)
+    {
+        ev__loop_free(loop, new_sampler);
+        return ret;
+    }
+    new_sampler->cb = cb;
+    new_sampler->arg = arg;
+    memset(&new_sampler->stat, 0, sizeof(new_sampler->stat));
+
+    ev_timer_start(new_sampler->timer, interval, interval,
+                   _ev_tcp_sampler_on_timer, new_sampler);
+
+    *sampler = new_sampler;
+    return 0;
 }
 
-inline static void _ring_buffer_insert_new_node(ring_buffer_t* rb,
-    ring_buffer_node_t* new_node, size_t data_len)
+void ev_tcp_sampler_exit(ev_tcp_sampler_t *sampler)
 {
-    ring_buffer_node_t* rb_head = EV_RB_NODE(rb, rb->node.off_HEAD);
+    /* Memory is released once timer is closed */
+    ev_timer_exit(sampler->timer, _ev_tcp_sampler_on_close, sampler);
+}
 
-    /* initialize token */
-    new_node->state = RINGBUFFER_STAT_WRITING;
-    new_node->token.size.size = data_len;
+// #line 114 "ev.c"
+////////////////////////////////////////////////////////////////////////////////
+// FILE:    ev/tcp_pool.c
+// SIZE:    13912
+// SHA-256: 56cdab36e5735946cde690239703fc03629bee52c416a7c32e6e050c4c3492b4
+////////////////////////////////////////////////////////////////////////////////
+// #line 1 "ev/tcp_pool.c"
+static int _ev_tcp_pool_cmp_host(const ev_map_node_t *key1,
+                                 const ev_map_node_t *key2, void *arg)
+{
+    (void)arg;
+    ev_tcp_pool_host_t *host1 = EV_CONTAINER_OF(key1, ev_tcp_pool_host_t, node);
+    ev_tcp_pool_host_t *host2 = EV_CONTAINER_OF(key2, ev_tcp_pool_host_t, node);
 
-    /* update chain_pos */
-    new_node->chain_pos.off_next = rb_head->chain_pos.off_next;
-    new_node->chain_pos.off_prev = rb->node.off_HEAD;
-    EV_RB_NODE(rb, new_node->chain_pos.off_next)->chain_pos.off_prev = EV_RB_BASIS_DIFF(rb, new_node);
-    EV_RB_NODE(rb, new_node->chain_pos.off_prev)->chain_pos.off_next = EV_RB_BASIS_DIFF(rb, new_node);
+    if (host1->addr_sz != host2->addr_sz)
+    {
+        return host1->addr_sz < host2->addr_sz ? -1 : 1;
+    }
+    return memcmp(&host1->addr, &host2->addr, host1->addr_sz);
+}
+
+static ev_tcp_pool_host_t *_ev_tcp_pool_find_host(ev_tcp_pool_t         *pool,
+                                                  const struct sockaddr *addr,
+                                                  size_t                 size)
+{
+    ev_tcp_pool_host_t key;
+    memcpy(&key.addr, addr, size);
+    key.addr_sz = size;
+
+    ev_map_node_t *it = ev_map_find(&pool->hosts, &key.node);
+    if (it != NULL)
+    {
+        return EV_CONTAINER_OF(it, ev_tcp_pool_host_t, node);
+    }
+
+    ev_tcp_pool_host_t *host = ev__loop_malloc(
+        pool->loop, EV_ALLOCATOR_TYPE_TCP, sizeof(ev_tcp_pool_host_t));
+    if (host == NULL)
+    {
+        return NULL;
+    }
+
+    host->pool = pool;
+    memcpy(&host->addr, addr, size);
+    host->addr_sz = size;
+    ev_list_init(&host->idle_queue);
+    ev_list_init(&host->busy_queue);
+    ev_list_init(&host->wait_queue);
+    ev_map_insert(&pool->hosts, &host->node);
 
-    _ring_buffer_update_time_for_new_node(rb, new_node);
+    return host;
 }
 
 /**
- * @brief Update off_reserve
+ * @brief Free \p host once it has no connection and no waiting acquire.
  */
-static void _ring_buffer_reserve_update_oldest_reserve(ring_buffer_t* rb,
-    ring_buffer_node_t* node)
+static void _ev_tcp_pool_put_host(ev_tcp_pool_host_t *host)
 {
-    if (rb->node.off_reserve == 0)
+    ev_tcp_pool_t *pool = host->pool;
+    if (ev_list_size(&host->idle_queue) != 0 ||
+        ev_list_size(&host->busy_queue) != 0 ||
+        ev_list_size(&host->wait_queue) != 0)
     {
-        rb->node.off_reserve = EV_RB_BASIS_DIFF(rb, node);
+        return;
     }
+
+    ev_map_erase(&pool->hosts, &host->node);
+    ev__loop_free(pool->loop, host);
 }
 
-static ring_buffer_token_t* _ring_buffer_reserve_none_empty(
-    ring_buffer_t* rb, size_t data_len, size_t node_size, int flags)
+static size_t _ev_tcp_pool_host_size(ev_tcp_pool_host_t *host)
 {
-    ring_buffer_node_t* rb_head = EV_RB_NODE(rb, rb->node.off_HEAD);
+    return ev_list_size(&host->idle_queue) + ev_list_size(&host->busy_queue);
+}
 
-    /**
-     * Get next possible node in right side of HEAD
-     * If there is a node exists, the address of that node is larger or equal to calculated address.
-     */
-    size_t next_possible_pos = rb->node.off_HEAD + ring_buffer_node_cost(rb_head->token.size.size);
-    ring_buffer_node_t* next_possible_node = EV_RB_NODE(rb, next_possible_pos);
+static int _ev_tcp_pool_host_full(ev_tcp_pool_host_t *host)
+{
+    size_t max_per_host = host->pool->opts.max_per_host;
+    return max_per_host != 0 && _ev_tcp_pool_host_size(host) >= max_per_host;
+}
 
-    /* If have a existing node on right side of HEAD, we can use that space */
-    if (rb_head->chain_pos.off_next > rb->node.off_HEAD)
-    {
-        /* If space is enough, generate token */
-        if (rb_head->chain_pos.off_next - next_possible_pos >= node_size)
-        {
-            rb->counter.writing++;
-            _ring_buffer_insert_new_node(rb, next_possible_node, data_len);
-            _ring_buffer_reserve_update_oldest_reserve(rb, next_possible_node);
-            return &next_possible_node->token;
-        }
+/**
+ * @brief Finish acquire \p req with \p sock.
+ */
+static void _ev_tcp_pool_finish(ev_tcp_pool_t *pool, ev_tcp_pool_req_t *req,
+                                ev_tcp_t *sock, int stat)
+{
+    ev_tcp_pool_cb cb = req->cb;
+    void          *arg = req->arg;
+    ev__loop_free(pool->loop, req);
+    cb(pool, sock, stat, arg);
+}
 
-        /* Otherwise overwrite */
-        return (flags & RINGBUFFER_FLAG_OVERWRITE) ?
-            _ring_buffer_reserve_try_overwrite(rb, data_len, node_size) :
-            NULL;
+static void _ev_tcp_pool_on_ready(ev_timer_t *timer, void *arg)
+{
+    (void)timer;
+    ev_list_node_t *it;
+    ev_tcp_pool_t  *pool = arg;
+
+    /* Callback may destroy the pool */
+    while (!pool->closing && (it = ev_list_pop_front(&pool->ready_queue)) != NULL)
+    {
+        ev_tcp_t          *sock = EV_CONTAINER_OF(it, ev_tcp_t, pool.rnode);
+        ev_tcp_pool_req_t *req = sock->pool.req;
+        sock->pool.state = EV_TCP_POOL_BUSY;
+        sock->pool.req = NULL;
+        _ev_tcp_pool_finish(pool, req, sock, 0);
     }
+}
 
-    /* If no existing node on right side, try to create token */
-    if ((rb->config.capacity - (next_possible_pos - EV_RB_BEG_POS(rb))) >= node_size)
+/**
+ * @brief Hand \p sock out on next loop iteration.
+ */
+static void _ev_tcp_pool_dispatch(ev_tcp_pool_t *pool, ev_tcp_t *sock,
+                                  ev_tcp_pool_req_t *req)
+{
+    sock->pool.state = EV_TCP_POOL_READY;
+    sock->pool.req = req;
+    ev_list_push_back(&pool->ready_queue, &sock->pool.rnode);
+    ev_timer_start(pool->ready_timer, 0, 0, _ev_tcp_pool_on_ready, pool);
+}
+
+static void _ev_tcp_pool_on_connect(ev_tcp_t *sock, int stat, void *arg)
+{
+    (void)arg;
+    ev_tcp_pool_host_t *host = sock->pool.host;
+    ev_tcp_pool_req_t  *req = sock->pool.req;
+
+    /* Pool is destroyed, acquire is canceled by pool */
+    if (host == NULL)
     {
-        rb->counter.writing++;
-        _ring_buffer_insert_new_node(rb, next_possible_node, data_len);
-        _ring_buffer_reserve_update_oldest_reserve(rb, next_possible_node);
-        return &next_possible_node->token;
+        return;
     }
 
-    /* if area on the most left cache is enough, make token */
-    if (rb_head->chain_pos.off_next - EV_RB_BEG_POS(rb) >= node_size)
+    if (stat != 0)
     {
-        next_possible_node = EV_RB_BEG_NODE(rb);
-        rb->counter.writing++;
-        _ring_buffer_insert_new_node(rb, next_possible_node, data_len);
-        _ring_buffer_reserve_update_oldest_reserve(rb, next_possible_node);
-        return &next_possible_node->token;
+        sock->pool.state = EV_TCP_POOL_BUSY;
+        sock->pool.req = NULL;
+        if (!(sock->base.data.flags & EV_HANDLE_CLOSING))
+        {
+            ev_tcp_exit(sock, NULL, NULL);
+        }
+        _ev_tcp_pool_finish(host->pool, req, NULL, stat);
+        return;
     }
 
-    /* in other condition, overwrite if needed */
-    return (flags & RINGBUFFER_FLAG_OVERWRITE) ?
-        _ring_buffer_reserve_try_overwrite(rb, data_len, node_size) : NULL;
+    /*
+     * The handle is still active inside connect callback, defer it so user
+     * is able to release it back immediately.
+     */
+    _ev_tcp_pool_dispatch(host->pool, sock, req);
 }
 
-inline static int _ring_buffer_commit_for_write_confirm(ring_buffer_t* rb,
-    ring_buffer_node_t* node)
+static int _ev_tcp_pool_connect(ev_tcp_pool_host_t *host,
+                                ev_tcp_pool_req_t  *req)
 {
-    (void)rb;
+    int       ret;
+    ev_tcp_t *sock;
+    if ((ret = ev_tcp_init(host->pool->loop, &sock)) != 0)
+    {
+        return ret;
+    }
 
-    /* Update counter */
-    rb->counter.writing--;
-    rb->counter.committed++;
+    ret = ev_tcp_connect(sock, (struct sockaddr *)&host->addr, host->addr_sz,
+                         _ev_tcp_pool_on_connect, NULL);
+    if (ret != 0)
+    {
+        ev_tcp_exit(sock, NULL, NULL);
+        return ret;
+    }
 
-    /* Update node status */
-    node->state = RINGBUFFER_STAT_COMMITTED;
+    sock->pool.host = host;
+    sock->pool.state = EV_TCP_POOL_CONNECTING;
+    sock->pool.req = req;
+    ev_list_push_back(&host->busy_queue, &sock->pool.node);
 
     return 0;
 }
 
 /**
- * @brief Update position chain and time chain after delete node.
- * @param node   The node to delete
+ * @brief Start connecting for waiting acquires while there are free slots.
+ *
+ * \p host is freed if it ends up empty, and failed acquires are finished
+ * after that, as their callbacks may acquire or close the pool again.
  */
-static void _ring_buffer_delete_node_update_chain(ring_buffer_t* rb,
-    ring_buffer_node_t* node)
+static void _ev_tcp_pool_promote(ev_tcp_pool_host_t *host)
 {
-    /* Update position chain */
-    EV_RB_NODE(rb, node->chain_pos.off_prev)->chain_pos.off_next = node->chain_pos.off_next;
-    EV_RB_NODE(rb, node->chain_pos.off_next)->chain_pos.off_prev = node->chain_pos.off_prev;
+    ev_list_node_t *it;
+    ev_tcp_pool_t  *pool = host->pool;
+    ev_list_t       failed = EV_LIST_INIT;
 
-    /* Update time chain */
-    if (node->chain_time.off_older != 0)
+    while (!_ev_tcp_pool_host_full(host) &&
+           (it = ev_list_pop_front(&host->wait_queue)) != NULL)
     {
-        EV_RB_NODE(rb, node->chain_time.off_older)->chain_time.off_newer = node->chain_time.off_newer;
+        ev_tcp_pool_req_t *req = EV_CONTAINER_OF(it, ev_tcp_pool_req_t, node);
+        if ((req->stat = _ev_tcp_pool_connect(host, req)) != 0)
+        {
+            ev_list_push_back(&failed, &req->node);
+        }
     }
-    if (node->chain_time.off_newer != 0)
+    _ev_tcp_pool_put_host(host);
+
+    while ((it = ev_list_pop_front(&failed)) != NULL)
     {
-        EV_RB_NODE(rb, node->chain_time.off_newer)->chain_time.off_older = node->chain_time.off_older;
+        ev_tcp_pool_req_t *req = EV_CONTAINER_OF(it, ev_tcp_pool_req_t, node);
+        _ev_tcp_pool_finish(pool, req, NULL, req->stat);
     }
 }
 
 /**
- * @brief Completely remove a node from ring buffer
- * @param rb    ring buffer
- * @param node  node to be delete
+ * @brief Close connection that is not idle any more.
+ *
+ * It stays in busy queue until closed, so it still holds a slot.
  */
-static void _ring_buffer_delete_node(ring_buffer_t* rb,
-    ring_buffer_node_t* node)
+static void _ev_tcp_pool_evict(ev_tcp_t *sock)
 {
-    /**
-     * Short cut: If only one node in ring buffer, re-initialize.
-     * Here use `p_forward` to check if it meets the condition:
-     * 1. `chain_pos.off_next` always point to next node. If it point to self, there is only one node.
-     * 2. Access to `node` means `node` is in CPU cache line. By access `p_forward` can avoid cache miss.
-     */
-    if (node->chain_pos.off_next == EV_RB_BASIS_DIFF(rb, node))
+    ev_tcp_pool_host_t *host = sock->pool.host;
+
+    if (sock->pool.state == EV_TCP_POOL_IDLE)
     {
-        _ring_buffer_reinit(rb);
-        return;
+        ev_list_erase(&host->idle_queue, &sock->pool.node);
+        ev_list_push_back(&host->busy_queue, &sock->pool.node);
+        sock->pool.state = EV_TCP_POOL_BUSY;
+        host->pool->idle_cnt--;
     }
+    ev_tcp_exit(sock, NULL, NULL);
+}
 
-    /* Delete node and update chains */
-    _ring_buffer_delete_node_update_chain(rb, node);
+static void _ev_tcp_pool_on_idle(ev_timer_t *timer, void *arg)
+{
+    ev_tcp_pool_t  *pool = arg;
+    uint64_t        now = pool->loop->hwtime;
+    ev_map_node_t  *it = ev_map_begin(&pool->hosts);
+    ev_list_node_t *node, *next;
 
-    /* Update off_reserve */
-    if (rb->node.off_reserve == EV_RB_BASIS_DIFF(rb, node))
+    for (; it != NULL; it = ev_map_next(it))
     {
-        rb->node.off_reserve = node->chain_time.off_newer;
+        ev_tcp_pool_host_t *host = EV_CONTAINER_OF(it, ev_tcp_pool_host_t, node);
+        for (node = ev_list_begin(&host->idle_queue); node != NULL; node = next)
+        {
+            next = ev_list_next(node);
+            ev_tcp_t *sock = EV_CONTAINER_OF(node, ev_tcp_t, pool.node);
+            if (now - sock->pool.since >= pool->opts.idle_timeout ||
+                ev__tcp_probe(sock->sock) != 0)
+            {
+                _ev_tcp_pool_evict(sock);
+            }
+        }
     }
 
-    /* Update TAIL if necessary */
-    if (node->chain_time.off_older == 0)
+    if (pool->idle_cnt == 0)
     {
-        rb->node.off_TAIL = node->chain_time.off_newer;
-        return;
+        ev_timer_stop(timer);
     }
+}
 
-     /* Update HEAD if necessary */
-    if (node->chain_time.off_newer == 0)
+static void _ev_tcp_pool_on_timer_close(ev_timer_t *timer, void *arg)
+{
+    (void)timer;
+    ev_list_node_t *it;
+    ev_tcp_pool_t  *pool = arg;
+
+    if (--pool->timer_cnt != 0)
     {
-        rb->node.off_HEAD = node->chain_time.off_older;
         return;
     }
 
-    return;
-}
-
-static int _ring_buffer_commit_for_write_discard(ring_buffer_t* rb,
-    ring_buffer_node_t* node)
-{
-    rb->counter.writing--;
-    _ring_buffer_delete_node(rb, node);
-    return 0;
-}
+    while ((it = ev_list_pop_front(&pool->cancel_queue)) != NULL)
+    {
+        ev_tcp_pool_req_t *req = EV_CONTAINER_OF(it, ev_tcp_pool_req_t, node);
+        _ev_tcp_pool_finish(pool, req, NULL, EV_ECANCELED);
+    }
 
-static int _ring_buffer_commit_for_write(ring_buffer_t* rb,
-    ring_buffer_node_t* node, int flags)
-{
-    return (flags & RINGBUFFER_FLAG_DISCARD) ?
-        _ring_buffer_commit_for_write_discard(rb, node) :
-        _ring_buffer_commit_for_write_confirm(rb, node);
+    ev__loop_free(pool->loop, pool);
 }
 
-static int _ring_buffer_commit_for_consume_confirm(ring_buffer_t* rb,
-    ring_buffer_node_t* node)
+static void _ev_tcp_pool_exit_host(ev_tcp_pool_t *pool, ev_tcp_pool_host_t *host)
 {
-    rb->counter.reading--;
-    _ring_buffer_delete_node(rb, node);
-    return 0;
-}
+    ev_list_node_t *it;
 
-/**
- * @brief Discard a consumed token.
- * the only condition a consumed token can be discard is no one consume newer token
- */
-static int _ring_buffer_commit_for_consume_discard(ring_buffer_t* rb,
-    ring_buffer_node_t* node, int flags)
-{
-    /* If existing a newer consumer, should fail. */
-    if (node->chain_time.off_newer != 0
-        && EV_RB_NODE(rb, node->chain_time.off_newer)->state == RINGBUFFER_STAT_READING)
+    while ((it = ev_list_pop_front(&host->idle_queue)) != NULL)
     {
-        return (flags & RINGBUFFER_FLAG_ABANDON) ?
-            _ring_buffer_commit_for_consume_confirm(rb, node) : -1;
+        ev_tcp_t *sock = EV_CONTAINER_OF(it, ev_tcp_t, pool.node);
+        sock->pool.host = NULL;
+        ev_tcp_exit(sock, NULL, NULL);
     }
 
-    /* Update counter and status */
-    rb->counter.reading--;
-    rb->counter.committed++;
-    node->state = RINGBUFFER_STAT_COMMITTED;
-
-    /* if no newer node, then off_reserve should point to this node */
-    if (node->chain_time.off_newer == 0)
+    while ((it = ev_list_pop_front(&host->busy_queue)) != NULL)
     {
-        rb->node.off_reserve = EV_RB_BASIS_DIFF(rb, node);
-        return 0;
-    }
+        ev_tcp_t *sock = EV_CONTAINER_OF(it, ev_tcp_t, pool.node);
+        sock->pool.host = NULL;
 
-    /* if node is just older than off_reserve, then off_reserve should move back */
-    if (rb->node.off_reserve != 0
-        && EV_RB_NODE(rb, rb->node.off_reserve)->chain_time.off_older == EV_RB_BASIS_DIFF(rb, node))
-    {
-        rb->node.off_reserve = EV_RB_BASIS_DIFF(rb, node);
-        return 0;
+        /* Connections in use are detached */
+        if (sock->pool.state == EV_TCP_POOL_BUSY)
+        {
+            continue;
+        }
+
+        if (sock->pool.state == EV_TCP_POOL_READY)
+        {
+            ev_list_erase(&pool->ready_queue, &sock->pool.rnode);
+        }
+        ev_list_push_back(&pool->cancel_queue, &sock->pool.req->node);
+        sock->pool.req = NULL;
+        ev_tcp_exit(sock, NULL, NULL);
     }
 
-    return 0;
+    ev_list_migrate(&pool->cancel_queue, &host->wait_queue);
 }
 
-static int _ring_buffer_commit_for_consume(ring_buffer_t* rb,
-    ring_buffer_node_t* node, int flags)
+EV_LOCAL void ev__tcp_pool_link_init(ev_tcp_t *sock)
 {
-    return (flags & RINGBUFFER_FLAG_DISCARD) ?
-        _ring_buffer_commit_for_consume_discard(rb, node, flags) :
-        _ring_buffer_commit_for_consume_confirm(rb, node);
+    sock->pool.host = NULL;
+    sock->pool.state = EV_TCP_POOL_BUSY;
+    sock->pool.node = (ev_list_node_t)EV_LIST_NODE_INIT;
+    sock->pool.rnode = (ev_list_node_t)EV_LIST_NODE_INIT;
+    sock->pool.since = 0;
+    sock->pool.req = NULL;
 }
 
-EV_LOCAL size_t ring_buffer_heap_cost(void)
+EV_LOCAL void ev__tcp_pool_unlink(ev_tcp_t *sock)
 {
-    /* need to align with machine size */
-    return EV_ALIGN_SIZE(sizeof(struct ring_buffer), sizeof(void*));
-}
+    ev_tcp_pool_host_t *host = sock->pool.host;
+    if (host == NULL)
+    {
+        return;
+    }
+    sock->pool.host = NULL;
 
-EV_LOCAL size_t ring_buffer_node_cost(size_t size)
-{
-    return EV_ALIGN_SIZE(sizeof(ring_buffer_node_t) + size, sizeof(void*));
+    if (sock->pool.state == EV_TCP_POOL_IDLE)
+    {
+        ev_list_erase(&host->idle_queue, &sock->pool.node);
+        host->pool->idle_cnt--;
+    }
+    else
+    {
+        ev_list_erase(&host->busy_queue, &sock->pool.node);
+    }
+
+    /* A slot is free now */
+    _ev_tcp_pool_promote(host);
 }
 
-EV_LOCAL ring_buffer_t* ring_buffer_init(void* buffer, size_t size)
+int ev_tcp_pool_init(ev_loop_t *loop, ev_tcp_pool_t **pool,
+                     const ev_tcp_pool_opts_t *opts)
 {
-    /* Calculate start address */
-    ring_buffer_t* handler = buffer;
-
-    /* Check space size */
-    if (ring_buffer_heap_cost() + ring_buffer_node_cost(0) >= size)
+    int            ret;
+    ev_tcp_pool_t *new_pool =
+        ev__loop_malloc(loop, EV_ALLOCATOR_TYPE_TCP, sizeof(ev_tcp_pool_t));
+    if (new_pool == NULL)
     {
-        return NULL;
+        return EV_ENOMEM;
     }
 
-    /* setup necessary field */
-    handler->config.capacity = size - ring_buffer_heap_cost();
-    handler->basis = NULL;
+    new_pool->loop = loop;
+    new_pool->opts = *opts;
+    ev_map_init(&new_pool->hosts, _ev_tcp_pool_cmp_host, NULL);
+    new_pool->idle_cnt = 0;
+    new_pool->closing = 0;
+    new_pool->timer_cnt = 2;
+    ev_list_init(&new_pool->ready_queue);
+    ev_list_init(&new_pool->cancel_queue);
 
-    /* initialize */
-    _ring_buffer_reinit(handler);
+    if ((ret = ev_timer_init(loop, &new_pool->ready_timer)) != 0)
+    {
+        ev__loop_free(loop, new_pool);
+        return ret;
+    }
+    if ((ret = ev_timer_init(loop, &new_pool->idle_timer)) != 0)
+    {
+        new_pool->timer_cnt = 1;
+        ev_timer_exit(new_pool->ready_timer, _ev_tcp_pool_on_timer_close,
+                      new_pool);
+        return ret;
+    }
 
-    return handler;
+    *pool = new_pool;
+    return 0;
 }
 
-EV_LOCAL ring_buffer_token_t* ring_buffer_reserve(ring_buffer_t* handler, size_t len,
-    int flags)
+void ev_tcp_pool_exit(ev_tcp_pool_t *pool)
 {
-    /* node must aligned */
-    const size_t node_size = ring_buffer_node_cost(len);
-
-    /* empty ring buffer */
-    if (handler->node.off_TAIL == 0)
+    ev_map_node_t *it;
+
+    pool->closing = 1;
+    while ((it = ev_map_begin(&pool->hosts)) != NULL)
     {
-        return _ring_buffer_reserve_empty(handler, len, node_size);
+        ev_tcp_pool_host_t *host = EV_CONTAINER_OF(it, ev_tcp_pool_host_t, node);
+        ev_map_erase(&pool->hosts, it);
+        _ev_tcp_pool_exit_host(pool, host);
+        ev__loop_free(pool->loop, host);
     }
+    pool->idle_cnt = 0;
 
-    /* non empty ring buffer */
-    return _ring_buffer_reserve_none_empty(handler, len, node_size, flags);
+    /* Pool is released once both timers are closed */
+    ev_timer_exit(pool->ready_timer, _ev_tcp_pool_on_timer_close, pool);
+    ev_timer_exit(pool->idle_timer, _ev_tcp_pool_on_timer_close, pool);
 }
 
-EV_LOCAL ring_buffer_token_t* ring_buffer_consume(ring_buffer_t* handler)
+int ev_tcp_pool_acquire(ev_tcp_pool_t *pool, const struct sockaddr *addr,
+                        size_t size, ev_tcp_pool_cb cb, void *arg)
 {
-    ring_buffer_node_t* rb_oldest_reserve = EV_RB_NODE(handler, handler->node.off_reserve);
-    if (handler->node.off_reserve == 0
-        || rb_oldest_reserve->state != RINGBUFFER_STAT_COMMITTED)
+    int             ret;
+    ev_list_node_t *it;
+    if (pool->closing)
     {
-        return NULL;
+        return EV_EBADF;
+    }
+    if (size > sizeof(struct sockaddr_storage))
+    {
+        return EV_EINVAL;
     }
 
-    handler->counter.committed--;
-    handler->counter.reading++;
-
-    ring_buffer_node_t* token_node = rb_oldest_reserve;
-    handler->node.off_reserve = rb_oldest_reserve->chain_time.off_newer;
-    token_node->state = RINGBUFFER_STAT_READING;
+    ev_tcp_pool_host_t *host = _ev_tcp_pool_find_host(pool, addr, size);
+    if (host == NULL)
+    {
+        return EV_ENOMEM;
+    }
 
-    return &token_node->token;
-}
+    ev_tcp_pool_req_t *req = ev__loop_malloc(pool->loop, EV_ALLOCATOR_TYPE_TCP,
+                                             sizeof(ev_tcp_pool_req_t));
+    if (req == NULL)
+    {
+        _ev_tcp_pool_put_host(host);
+        return EV_ENOMEM;
+    }
+    req->cb = cb;
+    req->arg = arg;
 
-EV_LOCAL int ring_buffer_commit(ring_buffer_t* handler, ring_buffer_token_t* token, int flags)
-{
-    ring_buffer_node_t* node = EV_CONTAINER_OF(token, ring_buffer_node_t, token);
+    /* Newest connection is the least likely to be closed by peer */
+    while ((it = ev_list_end(&host->idle_queue)) != NULL)
+    {
+        ev_tcp_t *sock = EV_CONTAINER_OF(it, ev_tcp_t, pool.node);
+        if (ev__tcp_probe(sock->sock) != 0)
+        {
+            _ev_tcp_pool_evict(sock);
+            continue;
+        }
 
-    return node->state == RINGBUFFER_STAT_WRITING ?
-        _ring_buffer_commit_for_write(handler, node, flags) :
-        _ring_buffer_commit_for_consume(handler, node, flags);
-}
+        ev_list_erase(&host->idle_queue, it);
+        ev_list_push_back(&host->busy_queue, it);
+        pool->idle_cnt--;
+        _ev_tcp_pool_dispatch(pool, sock, req);
+        return 0;
+    }
 
-EV_LOCAL size_t ring_buffer_count(ring_buffer_t* handler, ring_buffer_counter_t* counter)
-{
-    if (counter != NULL)
+    if (_ev_tcp_pool_host_full(host))
     {
-        *counter = handler->counter;
+        ev_list_push_back(&host->wait_queue, &req->node);
+        return 0;
     }
 
-    return handler->counter.committed + handler->counter.reading + handler->counter.writing;
+    if ((ret = _ev_tcp_pool_connect(host, req)) != 0)
+    {
+        ev__loop_free(pool->loop, req);
+        _ev_tcp_pool_put_host(host);
+    }
+    return ret;
 }
 
-EV_LOCAL ring_buffer_token_t* ring_buffer_begin(const ring_buffer_t* handler)
+void ev_tcp_pool_release(ev_tcp_pool_t *pool, ev_tcp_t *sock, int reuse)
 {
-    ring_buffer_node_t* rb_tail = EV_RB_NODE(handler, handler->node.off_TAIL);
-    return &(rb_tail->token);
-}
+    ev_list_node_t     *it;
+    ev_tcp_pool_host_t *host = sock->pool.host;
 
-EV_LOCAL ring_buffer_token_t* ring_buffer_next(const ring_buffer_t* handler, const ring_buffer_token_t* token)
-{
-    ring_buffer_node_t* node = EV_CONTAINER_OF(token, ring_buffer_node_t, token);
-    if (node->chain_time.off_newer == 0)
+    if (host == NULL || host->pool != pool || !reuse ||
+        ev__handle_is_active(&sock->base) || ev__tcp_probe(sock->sock) != 0)
     {
-        return NULL;
+        ev_tcp_exit(sock, NULL, NULL);
+        return;
     }
 
-    node = EV_RB_NODE(handler, node->chain_time.off_newer);
-    return &(node->token);
-}
+    /* Hand over to waiting acquire directly */
+    if ((it = ev_list_pop_front(&host->wait_queue)) != NULL)
+    {
+        _ev_tcp_pool_dispatch(
+            pool, sock, EV_CONTAINER_OF(it, ev_tcp_pool_req_t, node));
+        return;
+    }
 
-// #line 103 "ev.c"
-////////////////////////////////////////////////////////////////////////////////
-// FILE:    ev/shmem.c
-// SIZE:    129
-// SHA-256: f2d8bee7408dc4d79ec2b33c0f7fd2d1dc9d5d82f0e8df99fbe61a2b07f370ff
-////////////////////////////////////////////////////////////////////////////////
-// #line 1 "ev/shmem.c"
+    if (ev_list_size(&host->idle_queue) >= pool->opts.max_idle)
+    {
+        ev_tcp_exit(sock, NULL, NULL);
+        return;
+    }
 
-void* ev_shmem_addr(ev_shmem_t* shm)
-{
-    return shm->addr;
-}
+    ev_list_erase(&host->busy_queue, &sock->pool.node);
+    ev_list_push_back(&host->idle_queue, &sock->pool.node);
+    sock->pool.state = EV_TCP_POOL_IDLE;
+    sock->pool.since = pool->loop->hwtime;
+    pool->idle_cnt++;
 
-size_t ev_shmem_size(ev_shmem_t* shm)
-{
-    return shm->size;
+    if (pool->opts.idle_timeout != 0 &&
+        !ev__handle_is_active(&pool->idle_timer->base))
+    {
+        /* Connections live at most 1.5 times of idle timeout */
+        uint64_t tick = pool->opts.idle_timeout / 2 + 1;
+        ev_timer_start(pool->idle_timer, tick, tick, _ev_tcp_pool_on_idle,
+                       pool);
+    }
 }
 
-// #line 104 "ev.c"
+// #line 115 "ev.c"
 ////////////////////////////////////////////////////////////////////////////////
 // FILE:    ev/threadpool.c
-// SIZE:    9221
-// SHA-256: 651df358bac08a32719cd41273843e9e30f72e33f9da2dd3aaab81b6124123ad
+// SIZE:    9288
+// SHA-256: 7366b7c8331e21aa2516f7de0e9029c943ac389e0df7ac70cdd0f4d937a63d06
 ////////////////////////////////////////////////////////////////////////////////
 // #line 1 "ev/threadpool.c"
 #include <assert.h>
@@ -19684,7 +26074,8 @@ int ev_threadpool_init(ev_threadpool_t *pool, const ev_thread_opt_t *opt,
     int    ret;
     size_t i;
 
-    if ((pool->threads = ev_calloc(num, sizeof(ev_thread_t *))) == NULL)
+    if ((pool->threads = ev__calloc(EV_ALLOCATOR_TYPE_THREADPOOL, num,
+                                    sizeof(ev_thread_t *))) == NULL)
     {
         return EV_ENOMEM;
     }
@@ -19925,11 +26316,11 @@ EV_LOCAL void ev__threadpool_process(ev_loop_t *loop)
     }
 }
 
-// #line 105 "ev.c"
+// #line 116 "ev.c"
 ////////////////////////////////////////////////////////////////////////////////
 // FILE:    ev/timer.c
-// SIZE:    2849
-// SHA-256: d065b4c1c4afe93379a9909bdde93ac0c9bd1f6b2b825182e80fb13646b5a148
+// SIZE:    7103
+// SHA-256: a5457a6e7f0c42e74d7d9615566fd71a7d4f23c78e786cec9d86b08584f2b763
 ////////////////////////////////////////////////////////////////////////////////
 // #line 1 "ev/timer.c"
 #include <string.h>
@@ -19956,11 +26347,17 @@ static int _ev_cmp_timer(const ev_map_node_t *key1, const ev_map_node_t *key2,
 static void _ev_timer_on_close(ev_handle_t *handle)
 {
     ev_timer_t *timer = EV_CONTAINER_OF(handle, ev_timer_t, base);
+    /* Caller owned memory may be released in close callback */
+    int         inplace = timer->base.data.flags & EV_HANDLE_INPLACE;
+    ev_loop_t  *loop = timer->base.loop;
     if (timer->close_cb != NULL)
     {
         timer->close_cb(timer, timer->close_arg);
     }
-    ev_free(timer);
+    if (!inplace)
+    {
+        ev__loop_free(loop, timer);
+    }
 }
 
 EV_LOCAL void ev__init_timer(ev_loop_t *loop)
@@ -19996,7 +26393,8 @@ EV_LOCAL size_t ev__process_timer(ev_loop_t *loop)
 
 int ev_timer_init(ev_loop_t *loop, ev_timer_t **handle)
 {
-    ev_timer_t *new_timer = ev_calloc(1, sizeof(ev_timer_t));
+    ev_timer_t *new_timer = ev__loop_calloc(loop, EV_ALLOCATOR_TYPE_TIMER, 1,
+                                            sizeof(ev_timer_t));
     if (new_timer == NULL)
     {
         return EV_ENOMEM;
@@ -20009,6 +26407,23 @@ int ev_timer_init(ev_loop_t *loop, ev_timer_t **handle)
     return 0;
 }
 
+size_t ev_timer_size(void)
+{
+    return sizeof(ev_timer_t);
+}
+
+int ev_timer_init_inplace(ev_loop_t *loop, ev_timer_t **handle, void *mem)
+{
+    ev_timer_t *new_timer = mem;
+
+    memset(new_timer, 0, sizeof(*new_timer));
+    ev__handle_init(loop, &new_timer->base, EV_ROLE_EV_TIMER);
+    new_timer->base.data.flags |= EV_HANDLE_INPLACE;
+
+    *handle = new_timer;
+    return 0;
+}
+
 void ev_timer_exit(ev_timer_t *handle, ev_timer_cb cb, void *arg)
 {
     handle->close_cb = cb;
@@ -20052,11 +26467,146 @@ void ev_timer_stop(ev_timer_t *handle)
     ev_map_erase(&handle->base.loop->timer.heap, &handle->node);
 }
 
-// #line 106 "ev.c"
+static void _ev_idle_timer_detach(ev_idle_token_t *token)
+{
+    ev_list_erase(&token->owner->queue, &token->node);
+    token->owner = NULL;
+}
+
+static void _ev_idle_timer_on_timer(ev_timer_t *timer, void *arg)
+{
+    (void)timer;
+    ev_list_node_t  *it;
+    ev_idle_timer_t *handle = arg;
+    uint64_t         now = handle->timer.base.loop->hwtime;
+
+    /* Callback may destroy the manager */
+    while (!handle->closing && (it = ev_list_begin(&handle->queue)) != NULL)
+    {
+        ev_idle_token_t *token = EV_CONTAINER_OF(it, ev_idle_token_t, node);
+        if (token->last + handle->timeout > now)
+        {
+            break;
+        }
+
+        _ev_idle_timer_detach(token);
+        token->cb(token, token->arg);
+    }
+
+    if (handle->closing || (it = ev_list_begin(&handle->queue)) == NULL)
+    {
+        return;
+    }
+
+    /* Wake up when the least recently active token expires */
+    ev_idle_token_t *token = EV_CONTAINER_OF(it, ev_idle_token_t, node);
+    uint64_t         deadline = token->last + handle->timeout;
+    ev_timer_start(&handle->timer, deadline > now ? deadline - now : 0, 0,
+                   _ev_idle_timer_on_timer, handle);
+}
+
+static void _ev_idle_timer_on_close(ev_timer_t *timer, void *arg)
+{
+    (void)timer;
+    ev_idle_timer_t *handle = arg;
+    ev__loop_free(handle->timer.base.loop, handle);
+}
+
+int ev_idle_timer_init(ev_loop_t *loop, ev_idle_timer_t **handle,
+                       uint64_t timeout)
+{
+    ev_timer_t      *timer;
+    if (timeout == 0)
+    {
+        return EV_EINVAL;
+    }
+
+    ev_idle_timer_t *new_handle =
+        ev__loop_malloc(loop, EV_ALLOCATOR_TYPE_TIMER, sizeof(ev_idle_timer_t));
+    if (new_handle == NULL)
+    {
+        return EV_ENOMEM;
+    }
+
+    ev_timer_init_inplace(loop, &timer, &new_handle->timer);
+    ev_list_init(&new_handle->queue);
+    new_handle->timeout = timeout;
+    new_handle->closing = 0;
+
+    *handle = new_handle;
+    return 0;
+}
+
+void ev_idle_timer_exit(ev_idle_timer_t *handle)
+{
+    ev_list_node_t *it;
+
+    handle->closing = 1;
+    while ((it = ev_list_begin(&handle->queue)) != NULL)
+    {
+        _ev_idle_timer_detach(EV_CONTAINER_OF(it, ev_idle_token_t, node));
+    }
+
+    /* Memory is released once timer is closed */
+    ev_timer_exit(&handle->timer, _ev_idle_timer_on_close, handle);
+}
+
+void ev_idle_timer_add(ev_idle_timer_t *handle, ev_idle_token_t *token,
+                       ev_idle_cb cb, void *arg)
+{
+    if (token->owner != NULL)
+    {
+        ev_idle_timer_remove(token);
+    }
+
+    token->owner = handle;
+    token->cb = cb;
+    token->arg = arg;
+    token->last = handle->timer.base.loop->hwtime;
+    ev_list_push_back(&handle->queue, &token->node);
+
+    /* Older tokens expire first, so the timer only starts for the first one */
+    if (!ev__handle_is_active(&handle->timer.base))
+    {
+        ev_timer_start(&handle->timer, handle->timeout, 0,
+                       _ev_idle_timer_on_timer, handle);
+    }
+}
+
+void ev_idle_timer_touch(ev_idle_token_t *token)
+{
+    ev_idle_timer_t *handle = token->owner;
+    if (handle == NULL)
+    {
+        return;
+    }
+
+    /* Timer is left as is, it reschedules itself when fired */
+    token->last = handle->timer.base.loop->hwtime;
+    ev_list_erase(&handle->queue, &token->node);
+    ev_list_push_back(&handle->queue, &token->node);
+}
+
+void ev_idle_timer_remove(ev_idle_token_t *token)
+{
+    ev_idle_timer_t *handle = token->owner;
+    if (handle == NULL)
+    {
+        return;
+    }
+
+    _ev_idle_timer_detach(token);
+    if (ev_list_size(&handle->queue) == 0)
+    {
+        ev_timer_stop(&handle->timer);
+    }
+}
+
+// #line 117 "ev.c"
 ////////////////////////////////////////////////////////////////////////////////
 // FILE:    ev/udp.c
-// SIZE:    3071
-// SHA-256: 97441e353af7ca95b04b4d2cca7dbd02336b5bf0effa0885a0ad2780f4d5a9f6
+// SIZE:    4535
+// SHA-256: 8f2e9a95805233f098952f56c4140be0e4e71b8f1cbce9d6859d271ec4b95607
 ////////////////////////////////////////////////////////////////////////////////
 // #line 1 "ev/udp.c"
 #include <string.h>
@@ -20098,6 +26648,47 @@ EV_LOCAL int ev__udp_interface_addr_to_sockaddr(struct sockaddr_storage *dst,
     return 0;
 }
 
+static int _ev_udp_send(ev_udp_t *udp, ev_buf_t *bufs, size_t nbuf,
+                        size_t seg_size, const struct sockaddr *addr,
+                        ev_udp_write_cb cb, void *arg)
+{
+    int             ret;
+    ev_udp_write_t *req = ev__loop_malloc(
+        udp->base.loop, EV_ALLOCATOR_TYPE_UDP, sizeof(ev_udp_write_t));
+    if (req == NULL)
+    {
+        return EV_ENOMEM;
+    }
+
+    req->usr_cb = cb;
+    req->usr_cb_arg = arg;
+    ev__handle_init(udp->base.loop, &req->handle, EV_ROLE_EV_REQ_UDP_W);
+
+    if ((ret = ev__write_init(&req->base, bufs, nbuf)) != 0)
+    {
+        goto err;
+    }
+    /* Payload fit in one segment is a plain datagram */
+    req->seg_size = seg_size < req->base.capacity ? seg_size : 0;
+    ev_list_push_back(&udp->send_list, &req->base.node);
+
+    socklen_t addrlen = addr != NULL ? ev__get_addr_len(addr) : 0;
+    if ((ret = ev__udp_send(udp, req, addr, addrlen)) != 0)
+    {
+        goto err_cleanup_write;
+    }
+
+    return 0;
+
+err_cleanup_write:
+    ev_list_erase(&udp->send_list, &req->base.node);
+    ev__write_exit(&req->base);
+err:
+    ev__handle_exit(&req->handle, NULL);
+    ev__loop_free(udp->base.loop, req);
+    return ret;
+}
+
 int ev_udp_try_send(ev_udp_t *udp, ev_buf_t *bufs, size_t nbuf,
                     const struct sockaddr *addr, ev_udp_write_cb cb, void *arg)
 {
@@ -20109,6 +26700,29 @@ int ev_udp_try_send(ev_udp_t *udp, ev_buf_t *bufs, size_t nbuf,
     return ev_udp_send(udp, bufs, nbuf, addr, cb, arg);
 }
 
+ssize_t ev_udp_send_batch(ev_udp_t *udp, const ev_udp_datagram_t *msgs,
+                          size_t nmsg, ev_udp_write_cb cb, void *arg)
+{
+    int    ret;
+    size_t i;
+    if (nmsg == 0)
+    {
+        return EV_EINVAL;
+    }
+
+    for (i = 0; i < nmsg; i++)
+    {
+        ev_buf_t buf = ev_buf_make(msgs[i].data, msgs[i].size);
+        if ((ret = _ev_udp_send(udp, &buf, 1, msgs[i].seg_size, msgs[i].addr,
+                                cb, arg)) != 0)
+        {
+            return i != 0 ? (ssize_t)i : ret;
+        }
+    }
+
+    return nmsg;
+}
+
 int ev_udp_recv(ev_udp_t *udp, ev_buf_t *bufs, size_t nbuf, ev_udp_recv_cb cb,
                 void *arg)
 {
@@ -20118,7 +26732,8 @@ int ev_udp_recv(ev_udp_t *udp, ev_buf_t *bufs, size_t nbuf, ev_udp_recv_cb cb,
         return EV_EPIPE;
     }
 
-    ev_udp_read_t *req = ev_malloc(sizeof(ev_udp_read_t));
+    ev_udp_read_t *req = ev__loop_malloc(
+        udp->base.loop, EV_ALLOCATOR_TYPE_UDP, sizeof(ev_udp_read_t));
     if (req == NULL)
     {
         return EV_ENOMEM;
@@ -20145,48 +26760,29 @@ int ev_udp_recv(ev_udp_t *udp, ev_buf_t *bufs, size_t nbuf, ev_udp_recv_cb cb,
 
 err:
     ev__handle_exit(&req->handle, NULL);
-    ev_free(req);
+    ev__loop_free(udp->base.loop, req);
     return ret;
 }
 
 int ev_udp_send(ev_udp_t *udp, ev_buf_t *bufs, size_t nbuf,
                 const struct sockaddr *addr, ev_udp_write_cb cb, void *arg)
 {
-    int             ret;
-    ev_udp_write_t *req = ev_malloc(sizeof(ev_udp_write_t));
-    if (req == NULL)
-    {
-        return EV_ENOMEM;
-    }
-
-    req->usr_cb = cb;
-    req->usr_cb_arg = arg;
-    ev__handle_init(udp->base.loop, &req->handle, EV_ROLE_EV_REQ_UDP_W);
-
-    if ((ret = ev__write_init(&req->base, bufs, nbuf)) != 0)
-    {
-        goto err;
-    }
-    ev_list_push_back(&udp->send_list, &req->base.node);
+    return _ev_udp_send(udp, bufs, nbuf, 0, addr, cb, arg);
+}
 
-    socklen_t addrlen = addr != NULL ? ev__get_addr_len(addr) : 0;
-    if ((ret = ev__udp_send(udp, req, addr, addrlen)) != 0)
+int ev_udp_send_gso(ev_udp_t *udp, void *data, size_t size, size_t seg_size,
+                    const struct sockaddr *addr, ev_udp_write_cb cb, void *arg)
+{
+    if (size == 0 || seg_size == 0 || seg_size > EV_UDP_GSO_MAX_SIZE)
     {
-        goto err_cleanup_write;
+        return EV_EINVAL;
     }
 
-    return 0;
-
-err_cleanup_write:
-    ev_list_erase(&udp->send_list, &req->base.node);
-    ev__write_exit(&req->base);
-err:
-    ev__handle_exit(&req->handle, NULL);
-    ev_free(req);
-    return ret;
+    ev_buf_t buf = ev_buf_make(data, size);
+    return _ev_udp_send(udp, &buf, 1, seg_size, addr, cb, arg);
 }
 
-// #line 107 "ev.c"
+// #line 118 "ev.c"
 ////////////////////////////////////////////////////////////////////////////////
 // FILE:    ev/version.c
 // SIZE:    303
@@ -20210,5 +26806,5 @@ unsigned ev_version_code(void)
     return EV_VERSION_CODE;
 }
 
-// #line 108 "ev.c"
+// #line 119 "ev.c"
 
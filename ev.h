@@ -26,6 +26,36 @@
 /**
  * # Changelog
  * 
+ * ## Unreleased
+ * 
+ * ### Features
+ * 1. Support loop local allocator by `ev_loop_replace_allocator()`.
+ * 2. Support allocator statistics by `ev_allocator_stat()`, enabled by `EV_ALLOCATOR_STAT`.
+ * 3. Support in-place initialization for tcp, udp, timer, async and pipe handles.
+ * 4. Support recycling accepted tcp handles by `ev_tcp_accept_cache()` and `ev_tcp_init_accept()`.
+ * 5. Coalesce queued stream writes into one `writev()` on unix.
+ * 6. Support `ev_tcp_try_write()`, and `ev_tcp_write()` now writes immediately if nothing is queued.
+ * 7. Support sending file content to tcp socket by `ev_tcp_sendfile()`.
+ * 8. Support MSG_ZEROCOPY tcp writes by `ev_tcp_set_zerocopy()`.
+ * 9. Accept connections in batch by `ev_tcp_accept_start()`.
+ * 10. Set tcp socket options by `ev_tcp_setopt()`.
+ * 11. Watch write queue of tcp and pipe by `ev_tcp_set_watermark()` and `ev_pipe_set_watermark()`.
+ * 12. Forward data between tcp sockets and pipes by splice(2) with `ev_tcp_pipe_to()`.
+ * 13. Reuse outbound tcp connections by `ev_tcp_pool_acquire()`.
+ * 14. Resolve names asynchronously with a per-loop TTL cache by `ev_getaddrinfo()`.
+ * 15. Share one timer among idle connections by `ev_idle_timer_init()`.
+ * 16. Read transport statistics by `ev_tcp_get_info()` and sample them periodically by `ev_tcp_sampler_init()`.
+ * 17. Receive udp datagrams in batches by `ev_udp_recv_batch_start()`.
+ * 18. Flush queued udp datagrams by `sendmmsg()` and add `ev_udp_send_batch()`.
+ * 19. Support udp segmentation offload by `ev_udp_send_gso()` and `ev_udp_set_gro()`.
+ * 20. Receive udp datagrams into a ring of borrowed buffers by `ev_udp_recv_start()`.
+ * 21. Report destination address, kernel timestamp and drop counter of udp datagrams by `ev_udp_set_recv_info()`.
+ * 22. Tune udp sockets by `ev_udp_setopt()` and shard one port across loops by `EV_UDP_REUSEPORT`.
+ * 23. Pack queued IPC pipe frames into one `sendmsg()` and parse received frames in batch on Unix.
+ * 24. Add `ev_shm_channel_t` for message passing over shared memory with an eventfd doorbell.
+ * 25. Add `ev_pipe_write_handles()` to send up to `EV_PIPE_IPC_HANDLE_MAX` handles in one IPC frame; `ev_pipe_accept()` now takes received handles one by one, and `ev_pipe_discard()` closes those not accepted.
+ * 
+ * 
  * ## v1.0.0 (2024/11/25)
  * 
  * ### Features
@@ -1176,8 +1206,8 @@ EV_API const char* ev_strerror(int err);
 // #line 73 "ev.h"
 ////////////////////////////////////////////////////////////////////////////////
 // FILE:    ev/allocator.h
-// SIZE:    1933
-// SHA-256: d094345d9727bfdbeb994b3906bf0788c71f24dcf651ff0432c120bf7efd2c73
+// SIZE:    3872
+// SHA-256: c6089e88865bcbecc29d94df246dd8247ba1b4f5fe38cc9bd41036e2e89fa570
 ////////////////////////////////////////////////////////////////////////////////
 // #line 1 "ev/allocator.h"
 #ifndef __EV_ALLOCATOR_H__
@@ -1191,6 +1221,37 @@ extern "C" {
  * @{
  */
 
+/**
+ * @brief Memory usage category.
+ *
+ * Every chunk allocated by libev is attributed to one of these categories, so
+ * that #ev_allocator_stat() can tell where the memory goes.
+ */
+typedef enum ev_allocator_type
+{
+    EV_ALLOCATOR_TYPE_MISC = 0,       /**< Everything not listed below. */
+    EV_ALLOCATOR_TYPE_TCP = 1,        /**< TCP handles and requests. */
+    EV_ALLOCATOR_TYPE_UDP = 2,        /**< UDP handles and requests. */
+    EV_ALLOCATOR_TYPE_PIPE = 3,       /**< Pipe handles and requests. */
+    EV_ALLOCATOR_TYPE_FS = 4,         /**< File paths and file content. */
+    EV_ALLOCATOR_TYPE_TIMER = 5,      /**< Timer handles. */
+    EV_ALLOCATOR_TYPE_THREADPOOL = 6, /**< Thread pool. */
+    EV_ALLOCATOR_TYPE_DIRENT = 7,     /**< Directory entries. */
+    EV_ALLOCATOR_TYPE_MAX,            /**< Number of categories. */
+} ev_allocator_type_t;
+
+/**
+ * @brief Allocator statistics for one #ev_allocator_type_t.
+ */
+typedef struct ev_allocator_stat
+{
+    size_t   live_bytes;    /**< Bytes currently allocated. */
+    size_t   peak_bytes;    /**< Maximum value \p live_bytes ever reached. */
+    uint64_t alloc_count;   /**< Number of allocations. */
+    uint64_t realloc_count; /**< Number of reallocations. */
+    uint64_t free_count;    /**< Number of releases. */
+} ev_allocator_stat_t;
+
 /**
  * @brief Replacement function for realloc.
  * @see https://man7.org/linux/man-pages/man3/realloc.3.html
@@ -1239,6 +1300,23 @@ EV_API void *ev_realloc(void *ptr, size_t size);
  */
 EV_API void ev_free(void *ptr);
 
+/**
+ * @brief Get allocator statistics.
+ *
+ * Statistics are only available when libev is compiled with
+ * `EV_ALLOCATOR_STAT` defined. It covers memory allocated from both the global
+ * allocator and loop local allocators. Call it periodically and compare the
+ * counters to get allocation rates.
+ *
+ * @param[in] type      Memory category.
+ * @param[out] stat     Statistics.
+ * @return #EV_SUCCESS if success.
+ * @return #EV_EINVAL if \p type is not valid.
+ * @return #EV_ENOSYS if statistics is not compiled in.
+ */
+EV_API int ev_allocator_stat(ev_allocator_type_t type,
+                             ev_allocator_stat_t *stat);
+
 /**
  * @brief Same as
  * [strdup(3)](https://man7.org/linux/man-pages/man3/strdup.3.html)
@@ -1809,8 +1887,8 @@ typedef struct ev_file_map_backend
 #else
 ////////////////////////////////////////////////////////////////////////////////
 // FILE:    ev/unix.h
-// SIZE:    11287
-// SHA-256: 1056acdf3ff770b9d6c5f6c1c182af2df13ee2b881f5b38e17e2586c31d28a4a
+// SIZE:    14220
+// SHA-256: 01a38bdbb00ad7fe3320263a09fb3114a58fdc5a9d96f67fab70dc4fea0567d0
 ////////////////////////////////////////////////////////////////////////////////
 // #line 1 "ev/unix.h"
 /**
@@ -1820,6 +1898,7 @@ typedef struct ev_file_map_backend
 #define __EV_BACKEND_UNIX_H__
 
 #include <netinet/in.h>
+#include <netdb.h>
 #include <sys/epoll.h>
 #include <pthread.h>
 #include <semaphore.h>
@@ -1915,6 +1994,10 @@ struct ev_write;
 struct ev_read;
 
 struct ev_nonblock_stream;
+struct ev_nonblock_splice;
+struct ev_udp_recv_batch;
+struct ev_udp_recv_ring;
+struct ev_udp_recv_meta;
 
 /**
  * @brief Typedef of #ev_nonblock_stream.
@@ -1937,6 +2020,28 @@ typedef void(*ev_stream_write_cb)(ev_nonblock_stream_t* stream, struct ev_write*
  */
 typedef void(*ev_stream_read_cb)(ev_nonblock_stream_t* stream, struct ev_read* req, ssize_t size);
 
+/**
+ * @brief Zerocopy completion callback
+ * @param[in] seq_done  Number of zerocopy sends whose pages are released
+ */
+typedef void(*ev_stream_zerocopy_cb)(ev_nonblock_stream_t* stream, uint32_t seq_done);
+
+/**
+ * @brief Inclusive range of completed zerocopy sends.
+ */
+typedef struct ev_stream_zerocopy_range
+{
+    uint32_t                lo;                 /**< First sequence number */
+    uint32_t                hi;                 /**< Last sequence number */
+} ev_stream_zerocopy_range_t;
+
+/**
+ * @brief Write queue watermark callback
+ * @param[in] high      Non-zero if queued bytes reach high watermark, zero if
+ *                      they drop to low watermark.
+ */
+typedef void(*ev_stream_watermark_cb)(ev_nonblock_stream_t* stream, int high);
+
 /**
  * @brief Buffer
  * @internal Must share the same layout with `struct iovec`.
@@ -2041,6 +2146,7 @@ struct ev_nonblock_io
             int                     evtfd[2];           /**< [0] for read, [1] for write. */\
             ev_nonblock_io_t        io;\
         } threadpool;\
+        int                         emfile_fd;          /**< Reserved fd for accept on EMFILE */\
     }
 
 /**
@@ -2053,7 +2159,8 @@ struct ev_nonblock_io
         {\
             { EV_OS_PIPE_INVALID, EV_OS_PIPE_INVALID },\
             EV_NONBLOCK_IO_INVALID,\
-        }\
+        },\
+        -1,\
     }
 
 /**
@@ -2069,7 +2176,8 @@ struct ev_nonblock_io
  */
 #define EV_TCP_WRITE_BACKEND    \
     struct ev_tcp_write_backend {\
-        int                         _useless[0];        /**< Useless field */\
+        uint32_t                    zc_seq;             /**< Zerocopy sends to wait for */\
+        int                         stat;               /**< Failure of a write done inline */\
     }
 
 /**
@@ -2100,6 +2208,7 @@ struct ev_nonblock_stream
         unsigned                io_abort : 1;       /**< No futher IO allowed */
         unsigned                io_reg_r : 1;       /**< IO registered read event */
         unsigned                io_reg_w : 1;       /**< IO registered write event */
+        unsigned                io_reg_e : 1;       /**< IO registered error event */
     }flags;
 
     ev_nonblock_io_t            io;                 /**< IO object */
@@ -2108,6 +2217,7 @@ struct ev_nonblock_stream
     {
         ev_list_t               w_queue;            /**< Write queue */
         ev_list_t               r_queue;            /**< Read queue */
+        size_t                  w_size;             /**< Bytes not sent in write queue */
     }pending;
 
     struct
@@ -2115,6 +2225,30 @@ struct ev_nonblock_stream
         ev_stream_write_cb      w_cb;               /**< Write callback */
         ev_stream_read_cb       r_cb;               /**< Read callback */
     }callbacks;
+
+    struct
+    {
+        ev_stream_zerocopy_cb   cb;                 /**< Completion callback, NULL if zerocopy is off */
+        uint32_t                seq_sent;           /**< Number of zerocopy sends */
+        uint32_t                seq_done;           /**< Number of completed zerocopy sends */
+        ev_stream_zerocopy_range_t* ranges;         /**< Completions after a gap, sorted */
+        size_t                  range_num;          /**< Number of \p ranges */
+        size_t                  range_cap;          /**< Capacity of \p ranges */
+    }zerocopy;
+
+    struct
+    {
+        ev_stream_watermark_cb  cb;                 /**< Watermark callback, NULL if disabled */
+        size_t                  low;                /**< Low watermark */
+        size_t                  high;               /**< High watermark */
+        int                     is_high;            /**< Reached high watermark */
+    }watermark;
+
+    struct
+    {
+        struct ev_nonblock_splice*  as_src;         /**< Splice reading from this stream */
+        struct ev_nonblock_splice*  as_dst;         /**< Splice writing to this stream */
+    }splice;
 };
 
 /**
@@ -2125,8 +2259,11 @@ struct ev_nonblock_stream
         NULL,                           /* .loop */\
         { 0, 0, 0, 0, 0 },              /* .flags */\
         EV_NONBLOCK_IO_INVALID,         /* .io */\
-        { EV_LIST_INIT, EV_LIST_INIT }, /* .pending */\
-        { NULL, NULL }                  /* .callbacks */\
+        { EV_LIST_INIT, EV_LIST_INIT, 0 },  /* .pending */\
+        { NULL, NULL },                 /* .callbacks */\
+        { NULL, 0, 0, NULL, 0, 0 },     /* .zerocopy */\
+        { NULL, 0, 0, 0 },              /* .watermark */\
+        { NULL, NULL }                  /* .splice */\
     }
 
 /**
@@ -2140,6 +2277,9 @@ struct ev_nonblock_stream
 #define EV_UDP_BACKEND  \
     struct ev_udp_backend {\
         ev_nonblock_io_t                    io;                 /**< Backend IO */\
+        struct ev_udp_recv_batch*           rbatch;             /**< Batch receive context */\
+        struct ev_udp_recv_ring*            rring;              /**< Continuous receive context */\
+        struct ev_udp_recv_meta*            rmeta;              /**< Ancillary data context */\
     }
 
 /**
@@ -2155,7 +2295,8 @@ struct ev_nonblock_stream
  */
 #define EV_PIPE_WRITE_BACKEND   \
     struct ev_pipe_write_backend {\
-        int                                 _useless[0];        /**< Useless field */\
+        ev_ipc_frame_hdr_t                  hdr;                /**< Frame header, IPC mode only */\
+        size_t                              sent;               /**< Frame bytes sent, header included */\
     }
 
 /**
@@ -2165,6 +2306,8 @@ struct ev_nonblock_stream
     union ev_pipe_backend {\
         struct {\
             ev_nonblock_stream_t            stream;             /**< Stream */\
+            ev_pipe_watermark_cb            wm_cb;              /**< Watermark callback */\
+            void*                           wm_arg;             /**< Watermark argument */\
         }data_mode;\
         struct {\
             ev_nonblock_io_t                io;                 /**< IO object */\
@@ -2175,25 +2318,20 @@ struct ev_nonblock_stream
             }mask;\
             struct {\
                 struct {\
-                    size_t                  head_read_size;     /**< Head read size */\
                     size_t                  data_remain_size;   /**< Data remain to read */\
                     size_t                  buf_idx;            /**< Buffer index to fill */\
                     size_t                  buf_pos;            /**< Buffer position to fill */\
                     ev_pipe_read_req_t*     reading;            /**< Current handling request */\
                 }curr;\
                 ev_list_t                   rqueue;             /**< #ev_pipe_read_req_t */\
-                uint8_t                     buffer[sizeof(ev_ipc_frame_hdr_t)];\
+                uint8_t*                    buffer;             /**< Receive buffer */\
+                size_t                      pos;                /**< Parse position in buffer */\
+                size_t                      len;                /**< Received bytes in buffer */\
+                int                         fds[EV_PIPE_IPC_HANDLE_MAX]; /**< Received handles waiting for their frame */\
+                size_t                      fd_num;             /**< Number of waiting handles */\
             }rio;\
             struct {\
-                struct {\
-                    size_t                  head_send_capacity; /**< Head send capacity */\
-                    size_t                  head_send_size;     /**< Head send size */\
-                    size_t                  buf_idx;            /**< Buffer index to send */\
-                    size_t                  buf_pos;            /**< Buffer position to send */\
-                    ev_pipe_write_req_t*    writing;            /**< Currernt handling request */\
-                }curr;\
                 ev_list_t                   wqueue;             /**< #ev_pipe_write_req_t */\
-                uint8_t                     buffer[sizeof(ev_ipc_frame_hdr_t)];\
             }wio;\
         }ipc_mode;\
     }
@@ -3250,8 +3388,8 @@ EV_API uint64_t ev_hrtime(void);
 // #line 91 "ev.h"
 ////////////////////////////////////////////////////////////////////////////////
 // FILE:    ev/handle.h
-// SIZE:    3412
-// SHA-256: 0f125dc97a9228af87f8e33bfb974e19d1ae70208f1782d5626a9270b2e28ee8
+// SIZE:    3582
+// SHA-256: 7befe6a7f4a0c302bec2bbbb6ee2b91eb75c5827892394526f818271ea953794
 ////////////////////////////////////////////////////////////////////////////////
 // #line 1 "ev/handle.h"
 #ifndef __EV_HANDLE_H__
@@ -3277,10 +3415,12 @@ typedef enum ev_role
     EV_ROLE_EV_UDP          = 5,                    /**< Type of #ev_udp_t */
     EV_ROLE_EV_WORK         = 6,                    /**< Type of #ev_work_t */
     EV_ROLE_EV_FILE         = 7,                    /**< Type of #ev_file_t */
+    EV_ROLE_EV_SHM_CHANNEL  = 8,                    /**< Type of #ev_shm_channel_t */
     EV_ROLE_EV_REQ_UDP_R    = 100,                  /**< Type of #ev_udp_read_t */
     EV_ROLE_EV_REQ_UDP_W    = 101,                  /**< Type of #ev_udp_write_t */
+    EV_ROLE_EV_REQ_DNS      = 102,                  /**< Type of #ev_getaddrinfo_t */
     EV_ROLE_EV__RANGE_BEG   = EV_ROLE_EV_HANDLE,
-    EV_ROLE_EV__RANGE_END   = EV_ROLE_EV_REQ_UDP_W,
+    EV_ROLE_EV__RANGE_END   = EV_ROLE_EV_REQ_DNS,
 
     EV_ROLE_OS_SOCKET       = 1000,                 /**< OS socket */
     EV_ROLE_OS__RANGE_BEG   = EV_ROLE_OS_SOCKET,
@@ -3365,8 +3505,8 @@ struct ev_handle
 // #line 92 "ev.h"
 ////////////////////////////////////////////////////////////////////////////////
 // FILE:    ev/loop.h
-// SIZE:    5622
-// SHA-256: a4851098894e725931c7e0c628d5ae5e6c714299755d0ab6d029d7d6a5e14ab4
+// SIZE:    7112
+// SHA-256: dadc4762cf84f3313e3acf767ceb7bbc63a4271e14ea7b7a63676aa88b527d97
 ////////////////////////////////////////////////////////////////////////////////
 // #line 1 "ev/loop.h"
 #ifndef __EV_LOOP_H__
@@ -3474,6 +3614,20 @@ typedef struct ev_loop ev_loop_t;
  */
 typedef int (*ev_walk_cb)(ev_handle_t* handle, void* arg);
 
+/**
+ * @brief Loop local replacement function for realloc.
+ *
+ * Same as #ev_realloc_fn, with an extra user defined argument that can be
+ * used to carry allocator state such as an arena or a thread cache.
+ *
+ * @param[in] ptr   Memory to resize, or NULL to allocate.
+ * @param[in] size  New size, or 0 to release \p ptr.
+ * @param[in] arg   User defined argument passed to
+ *   #ev_loop_replace_allocator().
+ * @return          Memory address, or NULL if failure.
+ */
+typedef void* (*ev_loop_realloc_fn)(void* ptr, size_t size, void* arg);
+
 /**
  * @brief Initializes the given structure.
  * @param[out] loop     Event loop handler
@@ -3493,6 +3647,27 @@ EV_API int ev_loop_init(ev_loop_t** loop);
  */
 EV_API int ev_loop_exit(ev_loop_t* loop);
 
+/**
+ * @brief Override the allocator used by handles that belong to \p loop.
+ *
+ * By default all memory is allocated from the global allocator (see
+ * #ev_replace_allocator()). A loop local allocator is only ever called from
+ * the thread running \p loop, so it does not need to be thread-safe.
+ *
+ * Memory owned by TCP, UDP, pipe, timer and async handles (including their
+ * internal requests) is allocated from the loop local allocator.
+ *
+ * @note The allocator can only be changed when there are no handles in \p loop,
+ *   or it will return #EV_EBUSY. The resolver cache of \p loop is flushed.
+ * @param[in] loop      Event loop handler.
+ * @param[in] allocator Replacement function, or NULL to restore the global
+ *   allocator.
+ * @param[in] arg       User defined argument passed to \p allocator.
+ * @return              #ev_errno_t
+ */
+EV_API int ev_loop_replace_allocator(ev_loop_t* loop,
+    ev_loop_realloc_fn allocator, void* arg);
+
 /**
  * @brief Stop the event loop, causing ev_loop_run() to end as soon as possible.
  *
@@ -3571,8 +3746,8 @@ EV_API void ev_loop_walk(ev_loop_t* loop, ev_walk_cb cb, void* arg);
 // #line 93 "ev.h"
 ////////////////////////////////////////////////////////////////////////////////
 // FILE:    ev/async.h
-// SIZE:    1507
-// SHA-256: 72110a9b21df7b574a0366c6e45c90500985718e56071ad4a16fe2f9954f839a
+// SIZE:    2443
+// SHA-256: e51a4b39b54f45f9f490085562abaed37177114cb6fb159b160c6dbb74a5b1b1
 ////////////////////////////////////////////////////////////////////////////////
 // #line 1 "ev/async.h"
 #ifndef __EV_ASYNC_H__
@@ -3612,6 +3787,31 @@ typedef void (*ev_async_cb)(ev_async_t *async, void *arg);
 EV_API int ev_async_init(ev_loop_t *loop, ev_async_t **handle,
                          ev_async_cb activate_cb, void *activate_arg);
 
+/**
+ * @brief Get the size of #ev_async_t.
+ * @return                  Size in bytes.
+ */
+EV_API size_t ev_async_size(void);
+
+/**
+ * @brief Initialize the handle in caller-owned memory.
+ *
+ * Same as #ev_async_init(), but the handle is constructed inside \p mem
+ * instead of allocating from heap. \p mem must be at least #ev_async_size()
+ * bytes, aligned as memory returned by malloc(3), and stay valid until the
+ * close callback is called.
+ *
+ * @param[in] loop          Event loop
+ * @param[out] handle       A pointer to the structure
+ * @param[in] activate_cb   Activate callback
+ * @param[in] activate_arg  Activate argument.
+ * @param[in] mem           Memory to construct the handle in.
+ * @return                  #ev_errno_t
+ */
+EV_API int ev_async_init_inplace(ev_loop_t *loop, ev_async_t **handle,
+                                 ev_async_cb activate_cb, void *activate_arg,
+                                 void *mem);
+
 /**
  * @brief Destroy the structure.
  * @param[in] handle    Async handle.
@@ -3642,8 +3842,8 @@ EV_API void ev_async_wakeup(ev_async_t *handle);
 // #line 94 "ev.h"
 ////////////////////////////////////////////////////////////////////////////////
 // FILE:    ev/timer.h
-// SIZE:    1852
-// SHA-256: 69f3279b440218b37c34face176bf082cf18e48ddf0ff2fb23e568ce7bc478be
+// SIZE:    5458
+// SHA-256: 65fd4788b557702650f45869b8944d223636d368f1c538966e86dce5e4403370
 ////////////////////////////////////////////////////////////////////////////////
 // #line 1 "ev/timer.h"
 #ifndef __EV_TIMER_H__
@@ -3676,6 +3876,28 @@ typedef void (*ev_timer_cb)(ev_timer_t *timer, void* arg);
  */
 EV_API int ev_timer_init(ev_loop_t *loop, ev_timer_t **handle);
 
+/**
+ * @brief Get the size of #ev_timer_t.
+ * @return              Size in bytes.
+ */
+EV_API size_t ev_timer_size(void);
+
+/**
+ * @brief Initialize the handle in caller-owned memory.
+ *
+ * Same as #ev_timer_init(), but the handle is constructed inside \p mem
+ * instead of allocating from heap. \p mem must be at least #ev_timer_size()
+ * bytes, aligned as memory returned by malloc(3), and stay valid until the
+ * close callback is called.
+ *
+ * @param[in] loop      A pointer to the event loop
+ * @param[out] handle   The structure to initialize
+ * @param[in] mem       Memory to construct the handle in.
+ * @return              #ev_errno_t
+ */
+EV_API int ev_timer_init_inplace(ev_loop_t *loop, ev_timer_t **handle,
+                                 void *mem);
+
 /**
  * @brief Destroy the timer
  * @warning The timer structure cannot be freed until close_cb is called.
@@ -3711,6 +3933,99 @@ EV_API int ev_timer_start(ev_timer_t *handle, uint64_t timeout,
  */
 EV_API void ev_timer_stop(ev_timer_t *handle);
 
+/**
+ * @brief Idle timeout manager type.
+ */
+typedef struct ev_idle_timer ev_idle_timer_t;
+
+/**
+ * @brief Typedef of #ev_idle_token.
+ */
+typedef struct ev_idle_token ev_idle_token_t;
+
+/**
+ * @brief Type definition for callback passed to #ev_idle_timer_add().
+ *
+ * \p token is already removed from the manager when called.
+ *
+ * @param[in] token     Expired token
+ * @param[in] arg       User defined argument.
+ */
+typedef void (*ev_idle_cb)(ev_idle_token_t *token, void *arg);
+
+/**
+ * @brief Idle timeout token, typically embedded in a connection.
+ */
+struct ev_idle_token
+{
+    ev_list_node_t   node;  /**< #ev_idle_timer::queue */
+    ev_idle_timer_t *owner; /**< Manager, NULL if not added */
+    uint64_t         last;  /**< Last active time */
+    ev_idle_cb       cb;    /**< Expire callback */
+    void            *arg;   /**< User defined argument. */
+};
+#define EV_IDLE_TOKEN_INIT                                                     \
+    {                                                                          \
+        EV_LIST_NODE_INIT, NULL, 0, NULL, NULL,                                \
+    }
+
+/**
+ * @brief Create an idle timeout manager.
+ *
+ * All tokens share the same \p timeout, so they are kept in a list ordered by
+ * last activity, and a single timer expires stale tokens in bulk. Compared to
+ * a #ev_timer_t per connection, #ev_idle_timer_touch() is a O(1) list move
+ * instead of a timer restart.
+ *
+ * @param[in] loop      A pointer to the event loop
+ * @param[out] handle   Idle timeout manager
+ * @param[in] timeout   Idle timeout in milliseconds, must not be zero.
+ * @return              #ev_errno_t
+ */
+EV_API int ev_idle_timer_init(ev_loop_t *loop, ev_idle_timer_t **handle,
+                              uint64_t timeout);
+
+/**
+ * @brief Destroy the manager.
+ *
+ * Tokens still in the manager are removed without callback. It is safe to
+ * call this function in #ev_idle_cb.
+ *
+ * @param[in] handle    Idle timeout manager
+ */
+EV_API void ev_idle_timer_exit(ev_idle_timer_t *handle);
+
+/**
+ * @brief Add \p token into manager.
+ *
+ * If \p token is already in a manager, it is moved into \p handle.
+ *
+ * @param[in] handle    Idle timeout manager
+ * @param[in] token     Idle token
+ * @param[in] cb        Expire callback
+ * @param[in] arg       User defined argument.
+ */
+EV_API void ev_idle_timer_add(ev_idle_timer_t *handle, ev_idle_token_t *token,
+                              ev_idle_cb cb, void *arg);
+
+/**
+ * @brief Mark \p token as active now.
+ *
+ * Does nothing if \p token is not in a manager.
+ *
+ * @param[in] token     Idle token
+ */
+EV_API void ev_idle_timer_touch(ev_idle_token_t *token);
+
+/**
+ * @brief Remove \p token from its manager.
+ *
+ * Does nothing if \p token is not in a manager.
+ *
+ * @param[in] token     Idle token
+ */
+EV_API void ev_idle_timer_remove(ev_idle_token_t *token);
+
 /**
  * @} EV_TIMER
  */
@@ -3723,8 +4038,8 @@ EV_API void ev_timer_stop(ev_timer_t *handle);
 // #line 95 "ev.h"
 ////////////////////////////////////////////////////////////////////////////////
 // FILE:    ev/tcp.h
-// SIZE:    5797
-// SHA-256: 9ba2320f8106d7d52451cf6a21782ecf54984d92e2b547945d50a27ea6b7278b
+// SIZE:    25541
+// SHA-256: 2154867a642fe565976d814f5fd71e50d23156a2bb0f13654b808595ea3144f3
 ////////////////////////////////////////////////////////////////////////////////
 // #line 1 "ev/tcp.h"
 #ifndef __EV_TCP_H__
@@ -3746,11 +4061,79 @@ extern "C" {
  * This is an example for how to use #ev_tcp_t as tcp server.
  */
 
+/**
+ * @brief TCP socket options.
+ *
+ * All options take an int value.
+ */
+typedef enum ev_tcp_opt
+{
+    /**
+     * @brief TCP_NODELAY. Non-zero to send small segments without delay.
+     */
+    EV_TCP_OPT_NODELAY = 0,
+
+    /**
+     * @brief SO_KEEPALIVE. Non-zero to send keep-alive probes.
+     */
+    EV_TCP_OPT_KEEPALIVE = 1,
+
+    /**
+     * @brief SO_SNDBUF. Send buffer size in bytes.
+     */
+    EV_TCP_OPT_SNDBUF = 2,
+
+    /**
+     * @brief SO_RCVBUF. Receive buffer size in bytes.
+     */
+    EV_TCP_OPT_RCVBUF = 3,
+
+    /**
+     * @brief TCP_QUICKACK. Non-zero to send ACK immediately.
+     * @note The kernel may turn it off again by itself.
+     */
+    EV_TCP_OPT_QUICKACK = 4,
+
+    /**
+     * @brief TCP_NOTSENT_LOWAT. Socket is writable only if unsent data in
+     *   bytes is less than this value.
+     */
+    EV_TCP_OPT_NOTSENT_LOWAT = 5,
+
+    /**
+     * @brief TCP_DEFER_ACCEPT. Seconds to wait for data before a connection
+     *   is accepted. Listen socket only.
+     */
+    EV_TCP_OPT_DEFER_ACCEPT = 6,
+
+    /**
+     * @brief TCP_FASTOPEN. Max length of pending TFO requests. Listen socket
+     *   only.
+     */
+    EV_TCP_OPT_FASTOPEN = 7,
+
+    /**
+     * @brief SO_BUSY_POLL. Microseconds to busy poll the device queue on
+     *   read.
+     */
+    EV_TCP_OPT_BUSY_POLL = 8,
+} ev_tcp_opt_t;
+
 /**
  * @brief TCP socket.
  */
 typedef struct ev_tcp ev_tcp_t;
 
+/**
+ * @brief Outbound connection pool.
+ */
+typedef struct ev_tcp_pool ev_tcp_pool_t;
+
+/**
+ * @brief See #ev_file_t.
+ */
+struct ev_file_s;
+
 /**
  * @brief Close callback for #ev_tcp_t
  * @param[in] sock      A closed socket
@@ -3783,6 +4166,59 @@ typedef void (*ev_tcp_connect_cb)(ev_tcp_t *sock, int stat, void *arg);
  */
 typedef void (*ev_tcp_write_cb)(ev_tcp_t *sock, ssize_t size, void *arg);
 
+/**
+ * @brief Write queue watermark callback
+ * @param[in] sock      Socket.
+ * @param[in] high      Non-zero if queued bytes reach high watermark, zero if
+ *                      they drop to low watermark.
+ * @param[in] arg       User defined argument.
+ */
+typedef void (*ev_tcp_watermark_cb)(ev_tcp_t *sock, int high, void *arg);
+
+/**
+ * @brief Pipe finish callback
+ * @param[in] src       Source handle.
+ * @param[in] dst       Destination handle.
+ * @param[in] size      Number of bytes moved to \p dst.
+ * @param[in] stat      0 if \p src reaches end of file and every byte is moved
+ *                      to \p dst, otherwise #ev_errno_t.
+ * @param[in] arg       User defined argument.
+ */
+typedef void (*ev_tcp_pipe_cb)(void *src, void *dst, uint64_t size, int stat,
+                               void *arg);
+
+/**
+ * @brief Acquire callback
+ * @param[in] pool      Connection pool
+ * @param[in] sock      Connected socket, NULL if failed.
+ * @param[in] stat      #ev_errno_t
+ * @param[in] arg       User defined argument.
+ */
+typedef void (*ev_tcp_pool_cb)(ev_tcp_pool_t *pool, ev_tcp_t *sock, int stat,
+                               void *arg);
+
+/**
+ * @brief Options of #ev_tcp_pipe_to().
+ */
+typedef struct ev_tcp_pipe_opts
+{
+    size_t         capacity; /**< Max bytes buffered in kernel, 0 for default. */
+    ev_tcp_pipe_cb cb;       /**< Finish callback, can be NULL. */
+    void          *arg;      /**< User defined argument. */
+} ev_tcp_pipe_opts_t;
+
+/**
+ * @brief Options of #ev_tcp_pool_init().
+ */
+typedef struct ev_tcp_pool_opts
+{
+    size_t   max_idle;     /**< Max idle connections kept per address. */
+    size_t   max_per_host; /**< Max connections per address, including those
+                                in use, 0 for unlimited. */
+    uint64_t idle_timeout; /**< Close connections idle for this many
+                                milliseconds, 0 to keep them forever. */
+} ev_tcp_pool_opts_t;
+
 /**
  * @brief Read callback
  * @param[in] sock      Socket.
@@ -3791,6 +4227,60 @@ typedef void (*ev_tcp_write_cb)(ev_tcp_t *sock, ssize_t size, void *arg);
  */
 typedef void (*ev_tcp_read_cb)(ev_tcp_t *sock, ssize_t size, void *arg);
 
+/**
+ * @brief Transport statistics of a connection.
+ *
+ * Fields not provided by the system are zero.
+ */
+typedef struct ev_tcp_info
+{
+    uint32_t rtt;            /**< Smoothed RTT in microseconds. */
+    uint32_t rtt_var;        /**< RTT variance in microseconds. */
+    uint32_t min_rtt;        /**< Minimum RTT in microseconds. */
+    uint32_t snd_mss;        /**< Sender MSS in bytes. */
+    uint32_t snd_cwnd;       /**< Congestion window in segments. */
+    uint32_t unacked;        /**< Segments in flight. */
+    uint32_t lost;           /**< Segments considered lost. */
+    uint32_t total_retrans;  /**< Segments retransmitted in total. */
+    uint64_t delivery_rate;  /**< Delivery rate in bytes per second. */
+    uint64_t bytes_acked;    /**< Bytes acknowledged by peer. */
+    uint64_t bytes_received; /**< Bytes received from peer. */
+} ev_tcp_info_t;
+
+/**
+ * @brief Number of buckets in #ev_tcp_info_stat_t histograms.
+ */
+#define EV_TCP_INFO_HIST_SIZE 32
+
+/**
+ * @brief Histograms of #ev_tcp_info_t across connections.
+ *
+ * Bucket 0 counts zero values, bucket N counts values in [2^(N-1), 2^N), and
+ * the last bucket also counts everything larger.
+ */
+typedef struct ev_tcp_info_stat
+{
+    uint64_t sock_cnt;                             /**< Sampled connections. */
+    uint64_t rtt[EV_TCP_INFO_HIST_SIZE];           /**< #ev_tcp_info_t::rtt */
+    uint64_t snd_cwnd[EV_TCP_INFO_HIST_SIZE];      /**< #ev_tcp_info_t::snd_cwnd */
+    uint64_t total_retrans[EV_TCP_INFO_HIST_SIZE]; /**< #ev_tcp_info_t::total_retrans */
+    uint64_t delivery_rate[EV_TCP_INFO_HIST_SIZE]; /**< #ev_tcp_info_t::delivery_rate */
+} ev_tcp_info_stat_t;
+
+/**
+ * @brief Typedef of #ev_tcp_sampler.
+ */
+typedef struct ev_tcp_sampler ev_tcp_sampler_t;
+
+/**
+ * @brief Sampler callback
+ * @param[in] sampler   Sampler.
+ * @param[in] stat      Statistics of this round.
+ * @param[in] arg       User defined argument.
+ */
+typedef void (*ev_tcp_sampler_cb)(ev_tcp_sampler_t         *sampler,
+                                  const ev_tcp_info_stat_t *stat, void *arg);
+
 /**
  * @brief Initialize a tcp socket
  * @param[in] loop      Event loop
@@ -3798,6 +4288,27 @@ typedef void (*ev_tcp_read_cb)(ev_tcp_t *sock, ssize_t size, void *arg);
  */
 EV_API int ev_tcp_init(ev_loop_t *loop, ev_tcp_t **tcp);
 
+/**
+ * @brief Get the size of #ev_tcp_t.
+ * @return              Size in bytes.
+ */
+EV_API size_t ev_tcp_size(void);
+
+/**
+ * @brief Initialize a tcp socket in caller-owned memory.
+ *
+ * Same as #ev_tcp_init(), but the handle is constructed inside \p mem instead
+ * of allocating from heap. \p mem must be at least #ev_tcp_size() bytes,
+ * aligned as memory returned by malloc(3), and stay valid until the close
+ * callback is called.
+ *
+ * @param[in] loop      Event loop
+ * @param[out] tcp      TCP handle
+ * @param[in] mem       Memory to construct the handle in.
+ * @return              #ev_errno_t
+ */
+EV_API int ev_tcp_init_inplace(ev_loop_t *loop, ev_tcp_t **tcp, void *mem);
+
 /**
  * @brief Destroy socket
  * @param[in] sock      Socket
@@ -3837,6 +4348,76 @@ EV_API int ev_tcp_listen(ev_tcp_t *sock, int backlog);
 EV_API int ev_tcp_accept(ev_tcp_t *acpt, ev_tcp_t *conn, ev_tcp_accept_cb cb,
                          void *arg);
 
+/**
+ * @brief Accept connections automatically.
+ *
+ * Each time \p lisn becomes readable, connections are accepted until there is
+ * none left or \p budget connections are accepted, so a burst of connections
+ * costs one wakeup instead of one per connection.
+ *
+ * For each connection a handle is created by #ev_tcp_init_accept() and passed
+ * to \p cb with \p stat set to 0. The handle belongs to the user and must be
+ * closed by #ev_tcp_exit(). If accept fails (e.g. #EV_EMFILE), \p cb is called
+ * with \p conn set to NULL and the error in \p stat, and accepting continues
+ * on next event.
+ *
+ * Requests queued by #ev_tcp_accept() are served first.
+ *
+ * If the process runs out of fds, \p cb is called with #EV_EMFILE or
+ * #EV_ENFILE, and connections waiting in backlog are closed. Otherwise the
+ * listen socket would keep waking up with the same error.
+ *
+ * On Windows there is no readiness to drain, \p budget is the number of
+ * accept requests kept pending instead.
+ *
+ * @param[in] lisn      Listen socket
+ * @param[in] budget    Max connections accepted in one round, 0 for default.
+ * @param[in] cb        Connection callback
+ * @param[in] arg       User defined argument pass to \p cb.
+ * @return              #ev_errno_t
+ */
+EV_API int ev_tcp_accept_start(ev_tcp_t *lisn, size_t budget,
+                               ev_tcp_accept_cb cb, void *arg);
+
+/**
+ * @brief Stop accepting connections automatically.
+ * @param[in] lisn      Listen socket
+ * @return              #ev_errno_t
+ */
+EV_API int ev_tcp_accept_stop(ev_tcp_t *lisn);
+
+/**
+ * @brief Enable recycling of connection handles for listen socket.
+ *
+ * Handles obtained by #ev_tcp_init_accept() are kept by \p lisn once they are
+ * closed instead of being freed, so the next #ev_tcp_init_accept() can reuse
+ * them without going through the allocator. At most \p capacity closed
+ * handles are kept, the rest are freed as usual. Set \p capacity to 0 to
+ * disable the cache and release all kept handles.
+ *
+ * All kept handles are released when \p lisn is closed.
+ *
+ * @param[in] lisn      Listen socket
+ * @param[in] capacity  Max number of closed handles to keep.
+ * @return              #ev_errno_t
+ */
+EV_API int ev_tcp_accept_cache(ev_tcp_t *lisn, size_t capacity);
+
+/**
+ * @brief Initialize a tcp socket for accepting a connection from \p lisn.
+ *
+ * The handle is reused from the cache of \p lisn if possible, otherwise it is
+ * allocated as #ev_tcp_init() does. The returned handle is ready to be passed
+ * to #ev_tcp_accept(), and is used and closed like any other handle. Do not
+ * touch it after the close callback returns, as it may be handed out again.
+ *
+ * @see #ev_tcp_accept_cache()
+ * @param[in] lisn      Listen socket
+ * @param[out] conn     TCP handle
+ * @return              #ev_errno_t. #EV_EINVAL if \p lisn is not listening.
+ */
+EV_API int ev_tcp_init_accept(ev_tcp_t *lisn, ev_tcp_t **conn);
+
 /**
  * @brief Connect to address
  * @param[in] sock          Socket handle
@@ -3862,25 +4443,158 @@ EV_API int ev_tcp_connect(ev_tcp_t *sock, struct sockaddr *addr, size_t size,
  *   + If \p pipe is exiting but there are pending write request. The callback
  *     will be called with status #EV_ECANCELED.
  *
+ * The callback is never called inside #ev_tcp_write(), even if the data is
+ * sent, or fails to be sent, right away.
+ *
  * @param[in] sock      Socket handle
  * @param[in] bufs      Buffer list
  * @param[in] nbuf      Buffer number
  * @param[in] cb        Send result callback
  * @param[in] arg       User defined argument.
- * @return              #ev_errno_t
+ * @return              #ev_errno_t. Failure to send is not returned here but
+ *                      passed to \p cb.
  */
 EV_API int ev_tcp_write(ev_tcp_t *sock, ev_buf_t *bufs, size_t nbuf,
                         ev_tcp_write_cb cb, void *arg);
 
 /**
- * @brief Read data
+ * @brief Same as #ev_tcp_write(), but won't queue a write request if it can't
+ *   be completed immediately.
  *
- * Once #ev_tcp_read() return #EV_SUCCESS, it take the ownership of \p req, so
- * you should not modify the content of it until bounded callback is called.
+ * Data is written only if there is no pending write request, so the order of
+ * data is kept.
  *
- * It is a guarantee that every bounded callback of \p req will be called, with
- * following scene:
- *   + If read success or failure. The callback will be called with read status.
+ * @param[in] sock      Socket handle
+ * @param[in] bufs      Buffer list
+ * @param[in] nbuf      Buffer number
+ * @return              Number of bytes written, which may be less than the
+ *                      total size of \p bufs, or #ev_errno_t on failure.
+ *                      #EV_EAGAIN if nothing could be written right now.
+ *                      #EV_ENOSYS if not supported on this platform.
+ */
+EV_API ssize_t ev_tcp_try_write(ev_tcp_t *sock, ev_buf_t *bufs, size_t nbuf);
+
+/**
+ * @brief Send a range of file to socket.
+ *
+ * The data is copied inside the kernel by sendfile(2) if available, so no user
+ * space buffer is involved. The request is queued together with requests from
+ * #ev_tcp_write() and keeps the order of data.
+ *
+ * \p cb is called with \p len on success. If the file is shorter than
+ * requested, \p cb is called with #EV_EOF after the available data is sent,
+ * and requests queued after it are not affected.
+ *
+ * \p file must stay open until \p cb is called.
+ *
+ * @param[in] sock      Socket handle
+ * @param[in] file      File to send
+ * @param[in] offset    Offset of first byte in \p file
+ * @param[in] len       Number of bytes to send
+ * @param[in] cb        Send result callback
+ * @param[in] arg       User defined argument.
+ * @return              #ev_errno_t. #EV_ENOTCONN if \p sock has no socket.
+ *                      #EV_ENOSYS if not supported on this platform.
+ */
+EV_API int ev_tcp_sendfile(ev_tcp_t *sock, struct ev_file_s *file,
+                           int64_t offset, size_t len, ev_tcp_write_cb cb,
+                           void *arg);
+
+/**
+ * @brief Watch the number of bytes waiting in write queue.
+ *
+ * \p cb is called with \p high set to non-zero once queued bytes reach \p high,
+ * so the producer can pause, and then with zero once they drop to \p low, so it
+ * can resume. The callback may be called from inside #ev_tcp_write().
+ *
+ * @param[in] sock      Socket handle
+ * @param[in] low       Low watermark in bytes.
+ * @param[in] high      High watermark in bytes, must not be less than \p low.
+ * @param[in] cb        Watermark callback, or NULL to disable.
+ * @param[in] arg       User defined argument.
+ * @return              #ev_errno_t. #EV_ENOSYS if not supported on this
+ *                      platform.
+ */
+EV_API int ev_tcp_set_watermark(ev_tcp_t *sock, size_t low, size_t high,
+                                ev_tcp_watermark_cb cb, void *arg);
+
+/**
+ * @brief Get the number of bytes waiting in write queue.
+ * @param[in] sock      Socket handle
+ * @return              Queued bytes, or #ev_errno_t. #EV_ENOSYS if not
+ *                      supported on this platform.
+ */
+EV_API ssize_t ev_tcp_write_queue_size(ev_tcp_t *sock);
+
+/**
+ * @brief Send data of #ev_tcp_write() by MSG_ZEROCOPY.
+ *
+ * The kernel sends directly from the user buffers instead of copying them,
+ * which saves CPU for large writes. As the buffers are still in use after the
+ * data is queued to the socket, the write callback is delayed until the kernel
+ * notifies that they are released, so do not reuse the buffers until then.
+ *
+ * Small writes are usually slower by zerocopy, only enable it if most of the
+ * writes are large (at least tens of KiB).
+ *
+ * Callbacks of #ev_tcp_sendfile() are not delayed, so they may be called
+ * before callbacks of earlier #ev_tcp_write().
+ *
+ * @param[in] sock      Connected socket
+ * @param[in] enable    Non-zero to enable, zero to disable.
+ * @return              #ev_errno_t. #EV_EBUSY if disable with pending write
+ *                      requests. #EV_ENOSYS if not supported on this platform.
+ */
+EV_API int ev_tcp_set_zerocopy(ev_tcp_t *sock, int enable);
+
+/**
+ * @brief Forward all data received by \p src to \p dst.
+ *
+ * Data is moved by splice(2) through a kernel pipe, so it is never copied into
+ * user space. At most ev_tcp_pipe_opts_t::capacity bytes are buffered, \p src
+ * is not read while \p dst is unable to take more, so a slow peer throttles a
+ * fast one.
+ *
+ * Until the finish callback is called, \p src does not accept #ev_tcp_read()
+ * and \p dst does not accept #ev_tcp_write(), both fail with #EV_EBUSY. The
+ * callback is called once \p src reaches end of file, either socket fails, or
+ * either socket is closed. \p dst is not shutdown by this function.
+ *
+ * @param[in] src       Connected socket to read from.
+ * @param[in] dst       Connected socket to write to, may be the same as \p src.
+ * @param[in] opts      Options, can be NULL.
+ * @return              #ev_errno_t. #EV_EBUSY if \p src has pending read
+ *                      requests or \p dst has pending write requests.
+ *                      #EV_ENOSYS if not supported on this platform.
+ */
+EV_API int ev_tcp_pipe_to(ev_tcp_t *src, ev_tcp_t *dst,
+                          const ev_tcp_pipe_opts_t *opts);
+
+/**
+ * @brief Same as #ev_tcp_pipe_to(), but either side may be a #ev_pipe_t.
+ *
+ * Only #EV_ROLE_EV_TCP and #EV_ROLE_EV_PIPE are supported, and the pipe must
+ * be in data mode (not IPC).
+ *
+ * @param[in] src_role  Type of \p src.
+ * @param[in] src       Handle to read from.
+ * @param[in] dst_role  Type of \p dst.
+ * @param[in] dst       Handle to write to.
+ * @param[in] opts      Options, can be NULL.
+ * @return              #ev_errno_t
+ */
+EV_API int ev_tcp_pipe_to_ex(ev_role_t src_role, void *src, ev_role_t dst_role,
+                             void *dst, const ev_tcp_pipe_opts_t *opts);
+
+/**
+ * @brief Read data
+ *
+ * Once #ev_tcp_read() return #EV_SUCCESS, it take the ownership of \p req, so
+ * you should not modify the content of it until bounded callback is called.
+ *
+ * It is a guarantee that every bounded callback of \p req will be called, with
+ * following scene:
+ *   + If read success or failure. The callback will be called with read status.
  *   + If \p pipe is exiting but there are pending read request. The callback
  *     will be called with status #EV_ECANCELED.
  *
@@ -3894,6 +4608,146 @@ EV_API int ev_tcp_write(ev_tcp_t *sock, ev_buf_t *bufs, size_t nbuf,
 EV_API int ev_tcp_read(ev_tcp_t *sock, ev_buf_t *bufs, size_t nbuf,
                        ev_tcp_read_cb cb, void *arg);
 
+/**
+ * @brief Set socket option.
+ *
+ * If \p sock does not have an underlying socket yet, the option is saved and
+ * applied as soon as the socket is created by #ev_tcp_bind() or
+ * #ev_tcp_connect(). Listen socket only options (#EV_TCP_OPT_DEFER_ACCEPT,
+ * #EV_TCP_OPT_FASTOPEN) are applied by #ev_tcp_listen() before it starts
+ * listening.
+ *
+ * Options of a listen socket are inherited by its accepted connections, except
+ * for listen socket only options.
+ *
+ * @param[in] sock      Socket handle
+ * @param[in] opt       Option
+ * @param[in] val       Option value
+ * @return              #ev_errno_t. #EV_ENOSYS if \p opt is not supported on
+ *                      this platform.
+ */
+EV_API int ev_tcp_setopt(ev_tcp_t *sock, ev_tcp_opt_t opt, int val);
+
+/**
+ * @brief Get socket option.
+ *
+ * The value is read from the socket if it is applied, so it might be different
+ * from what is set (e.g. Linux doubles #EV_TCP_OPT_SNDBUF). Otherwise the saved
+ * value is returned.
+ *
+ * @param[in] sock      Socket handle
+ * @param[in] opt       Option
+ * @param[out] val      Option value
+ * @return              #ev_errno_t. #EV_EBADF if there is no socket and the
+ *                      option is not set.
+ */
+EV_API int ev_tcp_getopt(ev_tcp_t *sock, ev_tcp_opt_t opt, int *val);
+
+/**
+ * @brief Create outbound connection pool.
+ *
+ * The pool keeps connections released by user, keyed by peer address, and
+ * hands them out again instead of connecting every time. Idle connections are
+ * reused newest first, and are closed when they expire, when the peer closes
+ * them or when they receive unexpected data.
+ *
+ * @param[in] loop      Event loop
+ * @param[out] pool     Connection pool
+ * @param[in] opts      Options
+ * @return              #ev_errno_t
+ */
+EV_API int ev_tcp_pool_init(ev_loop_t *loop, ev_tcp_pool_t **pool,
+                            const ev_tcp_pool_opts_t *opts);
+
+/**
+ * @brief Destroy connection pool.
+ *
+ * Idle connections are closed. Pending acquires are finished with
+ * #EV_ECANCELED. Connections in use are detached from the pool and must be
+ * closed by #ev_tcp_exit().
+ *
+ * @param[in] pool      Connection pool
+ */
+EV_API void ev_tcp_pool_exit(ev_tcp_pool_t *pool);
+
+/**
+ * @brief Get a connection to \p addr.
+ *
+ * An idle connection is reused if there is any, otherwise a new one is made.
+ * If ev_tcp_pool_opts_t::max_per_host connections to \p addr exist, the
+ * request waits until one of them is released or closed.
+ *
+ * \p cb is never called inside this function.
+ *
+ * @param[in] pool      Connection pool
+ * @param[in] addr      Peer address
+ * @param[in] size      Address size
+ * @param[in] cb        Acquire callback
+ * @param[in] arg       User defined argument.
+ * @return              #ev_errno_t
+ */
+EV_API int ev_tcp_pool_acquire(ev_tcp_pool_t *pool, const struct sockaddr *addr,
+                               size_t size, ev_tcp_pool_cb cb, void *arg);
+
+/**
+ * @brief Give connection back to pool.
+ *
+ * The connection is closed instead of kept if \p reuse is zero, it has pending
+ * read or write requests, it is not healthy, or the pool is full.
+ *
+ * @param[in] pool      Connection pool
+ * @param[in] sock      Connection from #ev_tcp_pool_acquire().
+ * @param[in] reuse     Non-zero if the connection can be reused.
+ */
+EV_API void ev_tcp_pool_release(ev_tcp_pool_t *pool, ev_tcp_t *sock,
+                                int reuse);
+
+/**
+ * @brief Get transport statistics of a connection.
+ *
+ * On Linux it costs one getsockopt(TCP_INFO) call.
+ *
+ * @param[in] sock      Connected socket
+ * @param[out] info     Transport statistics
+ * @return              #ev_errno_t. #EV_ENOTCONN if \p sock is not connected.
+ */
+EV_API int ev_tcp_get_info(ev_tcp_t *sock, ev_tcp_info_t *info);
+
+/**
+ * @brief Aggregate #ev_tcp_get_info() of all connections in \p loop.
+ *
+ * Listening and unconnected sockets are skipped.
+ *
+ * @param[in] loop      Event loop
+ * @param[out] stat     Histograms, reset before filling.
+ */
+EV_API void ev_tcp_info_collect(ev_loop_t *loop, ev_tcp_info_stat_t *stat);
+
+/**
+ * @brief Run #ev_tcp_info_collect() periodically.
+ *
+ * The sampler keeps \p loop alive until #ev_tcp_sampler_exit() is called.
+ *
+ * @param[in] loop      Event loop
+ * @param[out] sampler  Sampler
+ * @param[in] interval  Sample interval in milliseconds, must not be 0.
+ * @param[in] cb        Sampler callback
+ * @param[in] arg       User defined argument.
+ * @return              #ev_errno_t. #EV_EINVAL if \p interval is 0.
+ */
+EV_API int ev_tcp_sampler_init(ev_loop_t *loop, ev_tcp_sampler_t **sampler,
+                               uint64_t interval, ev_tcp_sampler_cb cb,
+                               void *arg);
+
+/**
+ * @brief Stop and destroy the sampler.
+ *
+ * It is safe to call this function in #ev_tcp_sampler_cb.
+ *
+ * @param[in] sampler   Sampler
+ */
+EV_API void ev_tcp_sampler_exit(ev_tcp_sampler_t *sampler);
+
 /**
  * @brief Get the current address to which the socket is bound.
  * @param[in] sock  Socket handle
@@ -3926,8 +4780,8 @@ EV_API int ev_tcp_getpeername(ev_tcp_t *sock, struct sockaddr *name,
 // #line 96 "ev.h"
 ////////////////////////////////////////////////////////////////////////////////
 // FILE:    ev/udp.h
-// SIZE:    8161
-// SHA-256: a4395c06ff06bce34a4b8f0f2cb03e51dc4a669fa5b2d489960d03ed4fed6527
+// SIZE:    20417
+// SHA-256: 14061e3df7c6cea15bfb40d131e1926366289e8fb96c054938c5a5479da09be5
 ////////////////////////////////////////////////////////////////////////////////
 // #line 1 "ev/udp.h"
 #ifndef __EV_UDP_H__
@@ -3964,8 +4818,86 @@ typedef enum ev_udp_flags
      * @brief Reuse address. Only the last one can receive message.
      */
     EV_UDP_REUSEADDR = 2,
+
+    /**
+     * @brief SO_REUSEPORT. Datagrams are distributed among all sockets bound
+     *   to the same address, so each event loop can own one of them.
+     */
+    EV_UDP_REUSEPORT = 4,
 } ev_udp_flags_t;
 
+/**
+ * @brief UDP socket options.
+ * @see ev_udp_setopt()
+ */
+typedef enum ev_udp_opt
+{
+    /**
+     * @brief SO_SNDBUF. Send buffer size in bytes.
+     */
+    EV_UDP_OPT_SNDBUF = 0,
+
+    /**
+     * @brief SO_RCVBUF. Receive buffer size in bytes.
+     */
+    EV_UDP_OPT_RCVBUF = 1,
+
+    /**
+     * @brief SO_SNDBUFFORCE. Same as #EV_UDP_OPT_SNDBUF but ignores the
+     *   system limit. Requires CAP_NET_ADMIN.
+     */
+    EV_UDP_OPT_SNDBUFFORCE = 2,
+
+    /**
+     * @brief SO_RCVBUFFORCE. Same as #EV_UDP_OPT_RCVBUF but ignores the
+     *   system limit. Requires CAP_NET_ADMIN.
+     */
+    EV_UDP_OPT_RCVBUFFORCE = 3,
+
+    /**
+     * @brief IP_TOS / IPV6_TCLASS. Traffic class byte, DSCP is the upper six
+     *   bits (e.g. `46 << 2` for Expedited Forwarding).
+     */
+    EV_UDP_OPT_TOS = 4,
+} ev_udp_opt_t;
+
+/**
+ * @brief Ancillary data of received datagrams.
+ */
+typedef enum ev_udp_recv_info_flags
+{
+    /**
+     * @brief Destination address and interface. IP_PKTINFO / IPV6_RECVPKTINFO.
+     */
+    EV_UDP_RECV_PKTINFO = 0x01,
+
+    /**
+     * @brief Kernel receive timestamp. SO_TIMESTAMPNS.
+     */
+    EV_UDP_RECV_TIMESTAMP = 0x02,
+
+    /**
+     * @brief Counter of datagrams dropped by socket. SO_RXQ_OVFL.
+     */
+    EV_UDP_RECV_DROPS = 0x04,
+} ev_udp_recv_info_flags_t;
+
+/**
+ * @brief Ancillary data of a received datagram.
+ * @see ev_udp_set_recv_info()
+ */
+typedef struct ev_udp_recv_info
+{
+    unsigned flags; /**< Valid fields. #ev_udp_recv_info_flags_t */
+
+    struct sockaddr_storage dst_addr;  /**< Destination address, port is 0. */
+    unsigned                ifindex;   /**< Receiving interface index. */
+    uint64_t                timestamp; /**< Receive time in nanoseconds since
+                                            Unix epoch. */
+    uint32_t                drops;     /**< Datagrams dropped since socket was
+                                            created. */
+} ev_udp_recv_info_t;
+
 /**
  * @brief UDP socket type.
  */
@@ -3996,6 +4928,48 @@ typedef void (*ev_udp_write_cb)(ev_udp_t *udp, ssize_t size, void *arg);
 typedef void (*ev_udp_recv_cb)(ev_udp_t *udp, const struct sockaddr *addr,
                                ssize_t size, void *arg);
 
+/**
+ * @brief Datagram for #ev_udp_recv_batch_start(), #ev_udp_recv_start() and
+ *   #ev_udp_send_batch().
+ */
+typedef struct ev_udp_datagram
+{
+    const struct sockaddr    *addr;     /**< Peer address. */
+    void                     *data;     /**< Payload. */
+    size_t                    size;     /**< Payload size. */
+    size_t                    seg_size; /**< Segment size if \p data carries
+                                             several datagrams, 0 otherwise. */
+    const ev_udp_recv_info_t *info;     /**< Ancillary data on receive if
+                                             enabled by #ev_udp_set_recv_info(),
+                                             NULL otherwise. */
+} ev_udp_datagram_t;
+
+/**
+ * @brief Batch read callback
+ * @param[in] udp       UDP socket.
+ * @param[in] msgs      Received datagrams. Memory is owned by \p udp and only
+ *                      valid inside the callback.
+ * @param[in] nmsg      Number of datagrams.
+ * @param[in] stat      #ev_errno_t. If non-zero, \p nmsg is zero and batch
+ *                      receive is stopped.
+ * @param[in] arg       User defined argument.
+ */
+typedef void (*ev_udp_recv_batch_cb)(ev_udp_t *udp, ev_udp_datagram_t *msgs,
+                                     size_t nmsg, int stat, void *arg);
+
+/**
+ * @brief Continuous read callback
+ * @param[in] udp       UDP socket.
+ * @param[in] msg       Received datagram. The buffer is borrowed from \p udp
+ *                      and must be returned by #ev_udp_recv_release().
+ * @param[in] stat      #ev_errno_t. If non-zero, \p msg is NULL and continuous
+ *                      receive is stopped. Borrowed buffers stay valid until
+ *                      returned or until \p udp is closed.
+ * @param[in] arg       User defined argument.
+ */
+typedef void (*ev_udp_recv_ring_cb)(ev_udp_t *udp, ev_udp_datagram_t *msg,
+                                    int stat, void *arg);
+
 /**
  * @brief Initialize a UDP handle.
  * @param[in] loop      Event loop
@@ -4005,6 +4979,29 @@ typedef void (*ev_udp_recv_cb)(ev_udp_t *udp, const struct sockaddr *addr,
  */
 EV_API int ev_udp_init(ev_loop_t *loop, ev_udp_t **udp, int domain);
 
+/**
+ * @brief Get the size of #ev_udp_t.
+ * @return              Size in bytes.
+ */
+EV_API size_t ev_udp_size(void);
+
+/**
+ * @brief Initialize a UDP handle in caller-owned memory.
+ *
+ * Same as #ev_udp_init(), but the handle is constructed inside \p mem instead
+ * of allocating from heap. \p mem must be at least #ev_udp_size() bytes,
+ * aligned as memory returned by malloc(3), and stay valid until the close
+ * callback is called.
+ *
+ * @param[in] loop      Event loop
+ * @param[out] udp      A UDP handle to initialize
+ * @param[in] domain    AF_INET / AF_INET6 / AF_UNSPEC
+ * @param[in] mem       Memory to construct the handle in.
+ * @return              #ev_errno_t
+ */
+EV_API int ev_udp_init_inplace(ev_loop_t *loop, ev_udp_t **udp, int domain,
+                               void *mem);
+
 /**
  * @brief Close UDP handle
  * @param[in] udp       A UDP handle
@@ -4171,6 +5168,46 @@ EV_API int ev_udp_try_send(ev_udp_t *udp, ev_buf_t *bufs, size_t nbuf,
                            const struct sockaddr *addr, ev_udp_write_cb cb,
                            void *arg);
 
+/**
+ * @brief Send \p data as a train of \p seg_size datagrams.
+ *
+ * The kernel splits the payload by UDP_SEGMENT (GSO) so that one system call
+ * emits up to 64 datagrams. The last datagram may be shorter. If segmentation
+ * offload is not available, datagrams are sent one by one. Either way \p cb is
+ * called once when the whole payload is sent.
+ *
+ * @param[in] udp       A UDP handle
+ * @param[in] data      Payload. Must stay valid until \p cb is called.
+ * @param[in] size      Payload size.
+ * @param[in] seg_size  Size of each datagram.
+ * @param[in] addr      Peer address
+ * @param[in] cb        Send result callback
+ * @param[in] arg       User defined argument.
+ * @return              #ev_errno_t
+ */
+EV_API int ev_udp_send_gso(ev_udp_t *udp, void *data, size_t size,
+                           size_t seg_size, const struct sockaddr *addr,
+                           ev_udp_write_cb cb, void *arg);
+
+/**
+ * @brief Queue a list of datagrams.
+ *
+ * Each datagram is an independent send request and \p cb is called once for
+ * every datagram with its own result. Queued datagrams are flushed together by
+ * sendmmsg(2) where available. A datagram with non-zero
+ * #ev_udp_datagram_t::seg_size is sent as #ev_udp_send_gso() does.
+ *
+ * @param[in] udp   A UDP handle
+ * @param[in] msgs  Datagrams. Payload must stay valid until \p cb is called.
+ * @param[in] nmsg  Number of datagrams.
+ * @param[in] cb    Send result callback
+ * @param[in] arg   User defined argument.
+ * @return          Number of datagrams queued. If nothing is queued, return
+ *                  #ev_errno_t.
+ */
+EV_API ssize_t ev_udp_send_batch(ev_udp_t *udp, const ev_udp_datagram_t *msgs,
+                                 size_t nmsg, ev_udp_write_cb cb, void *arg);
+
 /**
  * @brief Queue a read request.
  * @param[in] udp   A UDP handle
@@ -4183,6 +5220,160 @@ EV_API int ev_udp_try_send(ev_udp_t *udp, ev_buf_t *bufs, size_t nbuf,
 EV_API int ev_udp_recv(ev_udp_t *udp, ev_buf_t *bufs, size_t nbuf,
                        ev_udp_recv_cb cb, void *arg);
 
+/**
+ * @brief Keep receiving datagrams in batches.
+ *
+ * Up to \p batch datagrams are read by one recvmmsg(2) call into buffers owned
+ * by \p udp, and delivered together in one callback. Datagrams larger than
+ * \p msg_size are truncated. While batch receive is running, #ev_udp_recv()
+ * and #ev_udp_recv_start() return #EV_EBUSY.
+ *
+ * @param[in] udp       A UDP handle
+ * @param[in] batch     Max datagrams per callback.
+ * @param[in] msg_size  Buffer size for each datagram.
+ * @param[in] cb        Batch read callback
+ * @param[in] arg       User defined argument.
+ * @return              #ev_errno_t
+ */
+EV_API int ev_udp_recv_batch_start(ev_udp_t *udp, size_t batch,
+                                   size_t msg_size, ev_udp_recv_batch_cb cb,
+                                   void *arg);
+
+/**
+ * @brief Stop batch receive.
+ *
+ * It is safe to call this function in #ev_udp_recv_batch_cb.
+ *
+ * @param[in] udp       A UDP handle
+ * @return              #ev_errno_t
+ */
+EV_API int ev_udp_recv_batch_stop(ev_udp_t *udp);
+
+/**
+ * @brief Keep receiving datagrams into a ring of preallocated buffers.
+ *
+ * \p nbuf buffers of \p buf_size bytes are allocated once. Each datagram is
+ * delivered in a buffer the user borrows until #ev_udp_recv_release() is
+ * called, so no allocation happens per datagram. When every buffer is
+ * borrowed, reading pauses until one is returned. While continuous receive is
+ * running, #ev_udp_recv() and #ev_udp_recv_batch_start() return #EV_EBUSY.
+ *
+ * @param[in] udp       A UDP handle
+ * @param[in] nbuf      Number of buffers.
+ * @param[in] buf_size  Size of each buffer. Larger datagrams are truncated.
+ * @param[in] cb        Continuous read callback
+ * @param[in] arg       User defined argument.
+ * @return              #ev_errno_t
+ */
+EV_API int ev_udp_recv_start(ev_udp_t *udp, size_t nbuf, size_t buf_size,
+                             ev_udp_recv_ring_cb cb, void *arg);
+
+/**
+ * @brief Stop continuous receive.
+ *
+ * It is safe to call this function in #ev_udp_recv_ring_cb. Borrowed buffers
+ * stay valid until returned or until \p udp is closed.
+ *
+ * @param[in] udp       A UDP handle
+ * @return              #ev_errno_t
+ */
+EV_API int ev_udp_recv_stop(ev_udp_t *udp);
+
+/**
+ * @brief Return a buffer borrowed by #ev_udp_recv_ring_cb.
+ * @param[in] udp       A UDP handle
+ * @param[in] msg       The datagram passed to #ev_udp_recv_ring_cb.
+ */
+EV_API void ev_udp_recv_release(ev_udp_t *udp, ev_udp_datagram_t *msg);
+
+/**
+ * @brief Enable ancillary data of received datagrams.
+ *
+ * Enabled fields are reported by #ev_udp_datagram_t::info on batch and
+ * continuous receive, and by #ev_udp_recv_info() in #ev_udp_recv_cb.
+ *
+ * If any of \p flags cannot be applied, previous flags stay in effect.
+ *
+ * @param[in] udp   A UDP handle
+ * @param[in] flags #ev_udp_recv_info_flags_t. 0 to disable.
+ * @return          #ev_errno_t
+ */
+EV_API int ev_udp_set_recv_info(ev_udp_t *udp, unsigned flags);
+
+/**
+ * @brief Get ancillary data of the datagram passed to #ev_udp_recv_cb.
+ * @param[in] udp   A UDP handle
+ * @return          Only valid in #ev_udp_recv_cb. NULL if not enabled.
+ */
+EV_API const ev_udp_recv_info_t *ev_udp_recv_info(ev_udp_t *udp);
+
+/**
+ * @brief Set socket option.
+ * @param[in] udp       A UDP handle
+ * @param[in] opt       Option
+ * @param[in] val       Option value
+ * @return              #ev_errno_t. #EV_ENOSYS if \p opt is not supported on
+ *                      this platform.
+ */
+EV_API int ev_udp_setopt(ev_udp_t *udp, ev_udp_opt_t opt, int val);
+
+/**
+ * @brief Get socket option.
+ *
+ * The value is read from the socket, so it might be different from what is set
+ * (e.g. Linux doubles #EV_UDP_OPT_RCVBUF).
+ *
+ * @param[in] udp       A UDP handle
+ * @param[in] opt       Option
+ * @param[out] val      Option value
+ * @return              #ev_errno_t
+ */
+EV_API int ev_udp_getopt(ev_udp_t *udp, ev_udp_opt_t opt, int *val);
+
+/**
+ * @brief Attach a classic BPF program that picks the receiving socket of a
+ *   #EV_UDP_REUSEPORT group.
+ *
+ * The program returns the index of the socket in the group, in the order they
+ * were bound. Out of range results fall back to the default hash. Attaching to
+ * any socket in the group affects the whole group.
+ *
+ * @param[in] udp       A UDP handle bound with #EV_UDP_REUSEPORT.
+ * @param[in] insns     Array of `struct sock_filter`.
+ * @param[in] ninsn     Number of instructions.
+ * @return              #ev_errno_t
+ */
+EV_API int ev_udp_set_reuseport_cbpf(ev_udp_t *udp, const void *insns,
+                                     size_t ninsn);
+
+/**
+ * @brief Steer datagrams of a #EV_UDP_REUSEPORT group by receiving CPU.
+ *
+ * A datagram handled by CPU `n` is delivered to socket `n % group_size`. Pin
+ * each event loop thread to the matching CPU to keep a flow on one core.
+ *
+ * @param[in] udp           A UDP handle bound with #EV_UDP_REUSEPORT.
+ * @param[in] group_size    Number of sockets in the group.
+ * @return                  #ev_errno_t
+ */
+EV_API int ev_udp_set_reuseport_cpu(ev_udp_t *udp, unsigned group_size);
+
+/**
+ * @brief Let kernel coalesce received datagrams by UDP_GRO.
+ *
+ * Coalesced datagrams are delivered by #ev_udp_recv_batch_start() and
+ * #ev_udp_recv_start() as one #ev_udp_datagram_t with
+ * #ev_udp_datagram_t::seg_size set, so the buffer should be large enough,
+ * e.g. 65535 bytes. Do not enable it when
+ * receiving by #ev_udp_recv(), which cannot report segment boundaries.
+ *
+ * @param[in] udp   A UDP handle
+ * @param[in] on    Bool
+ * @return          #ev_errno_t. #EV_ENOSYS if not supported, datagrams are
+ *                  then delivered one by one.
+ */
+EV_API int ev_udp_set_gro(ev_udp_t *udp, int on);
+
 /**
  * @} EV_UDP
  */
@@ -4194,9 +5385,102 @@ EV_API int ev_udp_recv(ev_udp_t *udp, ev_buf_t *bufs, size_t nbuf,
 
 // #line 97 "ev.h"
 ////////////////////////////////////////////////////////////////////////////////
+// FILE:    ev/dns.h
+// SIZE:    2456
+// SHA-256: bae63833c823174044127db95cdb2ccbc0e62e93756b7052815a436f6de01f7e
+////////////////////////////////////////////////////////////////////////////////
+// #line 1 "ev/dns.h"
+#ifndef __EV_DNS_H__
+#define __EV_DNS_H__
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @defgroup EV_DNS DNS
+ * @{
+ */
+
+struct ev_getaddrinfo_entry;
+
+/**
+ * @brief Typedef of #ev_getaddrinfo_s.
+ */
+typedef struct ev_getaddrinfo_s ev_getaddrinfo_t;
+
+/**
+ * @brief Resolve callback.
+ *
+ * \p res is owned by the resolver cache and is only valid inside the callback,
+ * copy what you need.
+ *
+ * @param[in] req       Resolve request
+ * @param[in] res       Address list, or NULL if failure.
+ * @param[in] status    #ev_errno_t
+ */
+typedef void (*ev_getaddrinfo_cb)(ev_getaddrinfo_t *req,
+                                  const struct addrinfo *res, int status);
+
+/**
+ * @brief Resolve request.
+ */
+struct ev_getaddrinfo_s
+{
+    ev_handle_t                  base;  /**< Base object */
+    ev_list_node_t               node;  /**< Wait queue node */
+    struct ev_getaddrinfo_entry *entry; /**< Cache entry */
+    ev_getaddrinfo_cb            cb;    /**< Resolve callback */
+};
+
+/**
+ * @brief Resolve \p host and \p service asynchronously.
+ *
+ * The lookup runs in the thread pool. Results are cached in \p loop, and
+ * concurrent lookups with the same arguments share one #getaddrinfo() call.
+ * Names that do not exist are cached as well, with a shorter TTL.
+ *
+ * \p cb is never called inside this function.
+ *
+ * @param[in] loop      Event loop
+ * @param[out] req      Resolve request, must be valid until \p cb is called.
+ * @param[in] host      Host name, can be NULL if \p service is not NULL.
+ * @param[in] service   Service name or port, can be NULL.
+ * @param[in] hints     Same as #getaddrinfo(), can be NULL.
+ * @param[in] cb        Resolve callback
+ * @return              #ev_errno_t
+ */
+EV_API int ev_getaddrinfo(ev_loop_t *loop, ev_getaddrinfo_t *req,
+                          const char *host, const char *service,
+                          const struct addrinfo *hints, ev_getaddrinfo_cb cb);
+
+/**
+ * @brief Set cache TTL of \p loop.
+ *
+ * Only affects lookups finished afterwards. Zero disables the cache, but
+ * concurrent lookups are still shared.
+ *
+ * @param[in] loop      Event loop
+ * @param[in] ttl       TTL of resolved names in milliseconds. Default 30000.
+ * @param[in] neg_ttl   TTL of names that do not exist in milliseconds.
+ *   Default 5000.
+ */
+EV_API void ev_getaddrinfo_set_ttl(ev_loop_t *loop, uint64_t ttl,
+                                   uint64_t neg_ttl);
+
+/**
+ * @} EV_DNS
+ */
+
+#ifdef __cplusplus
+}
+#endif
+#endif
+
+// #line 98 "ev.h"
+////////////////////////////////////////////////////////////////////////////////
 // FILE:    ev/pipe.h
-// SIZE:    9184
-// SHA-256: d7f29f52292c03dae4de9e27eeb231e9e85eeca8db652a00dca3e7c30d971379
+// SIZE:    14249
+// SHA-256: fae63c3429877d5f9a25dc9d5e7fff23f6f8bac560ece41b8de62e7cbb4167e7
 ////////////////////////////////////////////////////////////////////////////////
 // #line 1 "ev/pipe.h"
 #ifndef __EV_PIPE_H__
@@ -4251,6 +5535,15 @@ typedef void (*ev_pipe_write_cb)(ev_pipe_t *pipe, ssize_t result, void *arg);
  */
 typedef void (*ev_pipe_read_cb)(ev_pipe_read_req_t *req, ssize_t result);
 
+/**
+ * @brief Write queue watermark callback
+ * @param[in] pipe      Pipe handle
+ * @param[in] high      Non-zero if queued bytes reach high watermark, zero if
+ *                      they drop to low watermark.
+ * @param[in] arg       User defined argument.
+ */
+typedef void (*ev_pipe_watermark_cb)(ev_pipe_t *pipe, int high, void *arg);
+
 /**
  * @brief IPC frame header.
  *
@@ -4283,6 +5576,7 @@ typedef void (*ev_pipe_read_cb)(ev_pipe_read_req_t *req, ssize_t result);
  * | bit  | 0                   | 1                 |
  * | ---- | ------------------- | ----------------- |
  * | [00] | without information | have information  |
+ * | [01] | without handle      | have handles      |
  */
 typedef struct ev_ipc_frame_hdr
 {
@@ -4294,6 +5588,19 @@ typedef struct ev_ipc_frame_hdr
     uint32_t reserved;    /**< Zeros */
 } ev_ipc_frame_hdr_t;
 
+/**
+ * @def EV_PIPE_IPC_HANDLE_MAX
+ * @brief Maximum number of handles carried by one IPC frame.
+ */
+#if defined(_WIN32)
+#   define EV_PIPE_IPC_HANDLE_MAX   1
+#elif defined(__PASE__)
+/* on IBMi PASE the control message length can not exceed 256. */
+#   define EV_PIPE_IPC_HANDLE_MAX   60
+#else
+#   define EV_PIPE_IPC_HANDLE_MAX   64
+#endif
+
 /**
  * @brief Read request token for pipe.
  */
@@ -4303,7 +5610,9 @@ struct ev_pipe_read_req
     ev_pipe_read_cb ucb;  /**< User callback */
     struct
     {
-        ev_os_socket_t os_socket; /**< Socket handler */
+        ev_os_socket_t os_socket[EV_PIPE_IPC_HANDLE_MAX]; /**< Received handles */
+        size_t         num; /**< Number of received handles */
+        size_t         pos; /**< Index of next handle to accept */
     } handle;
     EV_PIPE_READ_BACKEND backend; /**< Backend */
 };
@@ -4319,8 +5628,12 @@ struct ev_pipe_read_req
  *   transfer in pipe will be package as a special designed data frame, so you
  *   don't need to manually split data.
  *
- * @warning Due to special features of `IPC` mode, it is significantly slower
- *   than normal mode, so don't use `IPC` mode to transmit large data.
+ * On Unix, queued frames are packed into one system call and received frames
+ *   are parsed from one large buffer, so small messages cost about the same
+ *   as in normal mode. A frame carrying a handle is always sent alone.
+ *
+ * @warning On Windows, `IPC` mode is significantly slower than normal mode,
+ *   so don't use `IPC` mode to transmit large data.
  *
  * @param[in] loop      Event loop
  * @param[out] pipe     Pipe handle
@@ -4329,6 +5642,29 @@ struct ev_pipe_read_req
  */
 EV_API int ev_pipe_init(ev_loop_t *loop, ev_pipe_t **pipe, int ipc);
 
+/**
+ * @brief Get the size of #ev_pipe_t.
+ * @return              Size in bytes.
+ */
+EV_API size_t ev_pipe_size(void);
+
+/**
+ * @brief Initialize a pipe handle in caller-owned memory.
+ *
+ * Same as #ev_pipe_init(), but the handle is constructed inside \p mem
+ * instead of allocating from heap. \p mem must be at least #ev_pipe_size()
+ * bytes, aligned as memory returned by malloc(3), and stay valid until the
+ * close callback is called.
+ *
+ * @param[in] loop      Event loop
+ * @param[out] pipe     Pipe handle
+ * @param[in] ipc       Initialize as IPC mode.
+ * @param[in] mem       Memory to construct the handle in.
+ * @return              #ev_errno_t
+ */
+EV_API int ev_pipe_init_inplace(ev_loop_t *loop, ev_pipe_t **pipe, int ipc,
+                                void *mem);
+
 /**
  * @brief Destroy pipe.
  *
@@ -4353,6 +5689,31 @@ EV_API void ev_pipe_exit(ev_pipe_t *pipe, ev_pipe_cb close_cb, void *close_arg);
  */
 EV_API int ev_pipe_open(ev_pipe_t *pipe, ev_os_pipe_t handle);
 
+/**
+ * @brief Watch the number of bytes waiting in write queue.
+ *
+ * Same as #ev_tcp_set_watermark(). Only available for opened pipe in data
+ * mode.
+ *
+ * @param[in] pipe      Pipe handle
+ * @param[in] low       Low watermark in bytes.
+ * @param[in] high      High watermark in bytes, must not be less than \p low.
+ * @param[in] cb        Watermark callback, or NULL to disable.
+ * @param[in] arg       User defined argument.
+ * @return              #ev_errno_t. #EV_ENOSYS if not supported on this
+ *                      platform or \p pipe is in IPC mode.
+ */
+EV_API int ev_pipe_set_watermark(ev_pipe_t *pipe, size_t low, size_t high,
+                                 ev_pipe_watermark_cb cb, void *arg);
+
+/**
+ * @brief Get the number of bytes waiting in write queue.
+ * @param[in] pipe      Pipe handle
+ * @return              Queued bytes, or #ev_errno_t. #EV_ENOSYS if not
+ *                      supported on this platform or \p pipe is in IPC mode.
+ */
+EV_API ssize_t ev_pipe_write_queue_size(ev_pipe_t *pipe);
+
 /**
  * @brief Write data
  *
@@ -4383,6 +5744,10 @@ EV_API int ev_pipe_write(ev_pipe_t *pipe, ev_buf_t *bufs, size_t nbuf,
  * + It is able to handle large amount of \p nbuf event it is larger than
  *   #EV_IOV_MAX.
  *
+ * Supported \p handle_role are #EV_ROLE_EV_TCP and #EV_ROLE_EV_SHM_CHANNEL.
+ * For a shared memory channel the doorbell is sent, see #ev_shm_channel_init().
+ * Use #ev_pipe_write_handles() to send more than one handle.
+ *
  * @param[in] pipe          Pipe handle
  * @param[in] req           Write request
  * @param[in] bufs          Buffer list
@@ -4397,6 +5762,29 @@ EV_API int ev_pipe_write_ex(ev_pipe_t *pipe, ev_buf_t *bufs, size_t nbuf,
                             ev_role_t handle_role, void *handle_addr,
                             ev_pipe_write_cb cb, void *arg);
 
+/**
+ * @brief Like #ev_pipe_write_ex(), but send a list of handles in one frame.
+ *
+ * All handles must be type of \p handle_role. The peer receives them in the
+ * same order by calling #ev_pipe_accept() repeatedly.
+ *
+ * @param[in] pipe          Pipe handle
+ * @param[in] bufs          Buffer list
+ * @param[in] nbuf          Buffer number
+ * @param[in] handle_role   The type of handles to send
+ * @param[in] handle_addrs  The address list of handles to send
+ * @param[in] handle_num    Number of handles, no more than
+ *                          #EV_PIPE_IPC_HANDLE_MAX.
+ * @param[in] cb            Write result callback
+ * @param[in] arg           User defined argument.
+ * @return  #EV_E2BIG: \p handle_num is larger than #EV_PIPE_IPC_HANDLE_MAX.
+ * @return  #ev_errno_t
+ */
+EV_API int ev_pipe_write_handles(ev_pipe_t *pipe, ev_buf_t *bufs, size_t nbuf,
+                                 ev_role_t handle_role, void **handle_addrs,
+                                 size_t handle_num, ev_pipe_write_cb cb,
+                                 void *arg);
+
 /**
  * @brief Read data
  *
@@ -4421,6 +5809,18 @@ EV_API int ev_pipe_read(ev_pipe_t *pipe, ev_pipe_read_req_t *req,
 
 /**
  * @brief Accept handle from peer.
+ *
+ * Each call takes the next handle received by \p req, in the order they were
+ * sent. #ev_pipe_read_req_t::handle::num is the number of received handles.
+ *
+ * Received handles are owned by \p req until accepted. A handle that fails
+ * to accept stays in \p req, unless \p handle_addr has already taken it.
+ * Handles that are never accepted must be released by #ev_pipe_discard(), or
+ * they leak.
+ *
+ * For #EV_ROLE_EV_SHM_CHANNEL, \p handle_addr is a channel opened by
+ * #ev_shm_channel_open(), and the received doorbell is attached to it.
+ *
  * @param[in] pipe          Pipe handle.
  * @param[in] req           Read request.
  * @param[in] handle_role   Handle type.
@@ -4428,12 +5828,23 @@ EV_API int ev_pipe_read(ev_pipe_t *pipe, ev_pipe_read_req_t *req,
  * @return  #EV_SUCCESS: Operation success.
  * @return  #EV_EINVAL: \p pipe is not initialized with IPC, or \p handle_role
  * is not support, or \p handle_addr is NULL.
- * @return  #EV_ENOENT: \p req does not receive a handle.
+ * @return  #EV_ENOENT: \p req does not receive a handle, or all handles are
+ * accepted.
  * @return  #EV_ENOMEM: \p handle_size is too small.
  */
 EV_API int ev_pipe_accept(ev_pipe_t *pipe, ev_pipe_read_req_t *req,
                           ev_role_t handle_role, void *handle_addr);
 
+/**
+ * @brief Close handles received by \p req that are not accepted.
+ *
+ * Call it once done with #ev_pipe_accept(), before \p req is reused or
+ * released. It does nothing if all handles are accepted.
+ *
+ * @param[in] req   Read request.
+ */
+EV_API void ev_pipe_discard(ev_pipe_read_req_t *req);
+
 /**
  * @brief Make a pair of pipe.
  *
@@ -4466,7 +5877,134 @@ EV_API void ev_pipe_close(ev_os_pipe_t fd);
 #endif
 #endif
 
-// #line 98 "ev.h"
+// #line 99 "ev.h"
+////////////////////////////////////////////////////////////////////////////////
+// FILE:    ev/shm_channel.h
+// SIZE:    3792
+// SHA-256: aa3449ab5430325ab07c703c66fd224e5a3c39b1009daf003f8192f6036b5e41
+////////////////////////////////////////////////////////////////////////////////
+// #line 1 "ev/shm_channel.h"
+#ifndef __EV_SHM_CHANNEL_H__
+#define __EV_SHM_CHANNEL_H__
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @defgroup EV_SHM_CHANNEL Shared memory channel
+ *
+ * A single producer, single consumer message ring inside shared memory.
+ *
+ * The receiving process creates the channel by #ev_shm_channel_init(), and
+ * share its doorbell by #ev_pipe_write_ex() with #EV_ROLE_EV_SHM_CHANNEL over
+ * an IPC pipe. The sending process opens the same shared memory by
+ * #ev_shm_channel_open(), and attach the doorbell by #ev_pipe_accept().
+ *
+ * Messages are copied into the ring without any system call. The doorbell is
+ * only rung when the receiver is waiting, so a busy channel costs no system
+ * call in either process.
+ *
+ * @note Only supported on Unix.
+ * @{
+ */
+
+/**
+ * @brief Shared memory channel type.
+ */
+typedef struct ev_shm_channel ev_shm_channel_t;
+
+/**
+ * @brief Receive callback.
+ *
+ * \p data points into shared memory, and is only valid inside the callback.
+ *
+ * If the ring is corrupted, the callback is called once with \p size set to
+ * #EV_EPROTO and no more message is received. The channel still needs
+ * #ev_shm_channel_exit().
+ *
+ * @param[in] chan  Channel
+ * @param[in] data  Message, or NULL on failure.
+ * @param[in] size  Message size, or #EV_EPROTO if the channel is broken.
+ * @param[in] arg   User defined argument.
+ */
+typedef void (*ev_shm_channel_recv_cb)(ev_shm_channel_t *chan,
+                                       const void *data, ssize_t size,
+                                       void *arg);
+
+/**
+ * @brief Close callback.
+ * @param[in] chan  Channel
+ * @param[in] arg   User defined argument.
+ */
+typedef void (*ev_shm_channel_cb)(ev_shm_channel_t *chan, void *arg);
+
+/**
+ * @brief Create a channel for receiving.
+ *
+ * The channel keeps \p loop alive until #ev_shm_channel_exit() is called.
+ *
+ * @param[in] loop  Event loop
+ * @param[out] chan Channel
+ * @param[in] key   Shared memory key, see #ev_shmem_init().
+ * @param[in] size  Ring size in bytes, rounded up to power of 2.
+ * @param[in] cb    Receive callback
+ * @param[in] arg   User defined argument.
+ * @return          #ev_errno_t
+ */
+EV_API int ev_shm_channel_init(ev_loop_t *loop, ev_shm_channel_t **chan,
+                               const char *key, size_t size,
+                               ev_shm_channel_recv_cb cb, void *arg);
+
+/**
+ * @brief Open a channel created by peer for sending.
+ *
+ * The doorbell must be attached by #ev_pipe_accept() before the first
+ * #ev_shm_channel_send().
+ *
+ * @param[in] loop  Event loop
+ * @param[out] chan Channel
+ * @param[in] key   Shared memory key
+ * @return          #EV_EINVAL if shared memory is not a channel, or
+ *                  #ev_errno_t.
+ */
+EV_API int ev_shm_channel_open(ev_loop_t *loop, ev_shm_channel_t **chan,
+                               const char *key);
+
+/**
+ * @brief Close channel.
+ * @param[in] chan      Channel
+ * @param[in] close_cb  Close callback, can be NULL.
+ * @param[in] close_arg Close argument.
+ */
+EV_API void ev_shm_channel_exit(ev_shm_channel_t *chan,
+                                ev_shm_channel_cb close_cb, void *close_arg);
+
+/**
+ * @brief Copy a message into channel.
+ *
+ * Only one sender is allowed for each channel.
+ *
+ * @param[in] chan  Channel opened by #ev_shm_channel_open().
+ * @param[in] data  Message
+ * @param[in] size  Message size, empty message is allowed.
+ * @return  #EV_SUCCESS: Message is queued.
+ * @return  #EV_EAGAIN: Ring is full, try again after receiver catches up.
+ * @return  #EV_E2BIG: \p size is larger than half of the ring.
+ * @return  #EV_ENOTCONN: Doorbell is not attached.
+ */
+EV_API int ev_shm_channel_send(ev_shm_channel_t *chan, const void *data,
+                               size_t size);
+
+/**
+ * @} EV_SHM_CHANNEL
+ */
+
+#ifdef __cplusplus
+}
+#endif
+#endif
+
+// #line 100 "ev.h"
 ////////////////////////////////////////////////////////////////////////////////
 // FILE:    ev/fs.h
 // SIZE:    21150
@@ -5092,7 +6630,7 @@ EV_API ev_buf_t* ev_fs_get_filecontent(ev_fs_req_t* req);
 #endif
 #endif
 
-// #line 99 "ev.h"
+// #line 101 "ev.h"
 ////////////////////////////////////////////////////////////////////////////////
 // FILE:    ev/process.h
 // SIZE:    6793
@@ -5342,7 +6880,7 @@ EV_API ssize_t ev_exepath(char* buffer, size_t size);
 #endif
 #endif
 
-// #line 100 "ev.h"
+// #line 102 "ev.h"
 ////////////////////////////////////////////////////////////////////////////////
 // FILE:    ev/misc.h
 // SIZE:    5389
@@ -5551,7 +7089,7 @@ EV_API int ev_random(ev_loop_t* loop, ev_random_req_t* req, void* buf,
 #endif
 #endif
 
-// #line 101 "ev.h"
+// #line 103 "ev.h"
 
 #endif
 
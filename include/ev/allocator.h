@@ -9,6 +9,37 @@ extern "C" {
  * @{
  */
 
+/**
+ * @brief Memory usage category.
+ *
+ * Every chunk allocated by libev is attributed to one of these categories, so
+ * that #ev_allocator_stat() can tell where the memory goes.
+ */
+typedef enum ev_allocator_type
+{
+    EV_ALLOCATOR_TYPE_MISC = 0,       /**< Everything not listed below. */
+    EV_ALLOCATOR_TYPE_TCP = 1,        /**< TCP handles and requests. */
+    EV_ALLOCATOR_TYPE_UDP = 2,        /**< UDP handles and requests. */
+    EV_ALLOCATOR_TYPE_PIPE = 3,       /**< Pipe handles and requests. */
+    EV_ALLOCATOR_TYPE_FS = 4,         /**< File paths and file content. */
+    EV_ALLOCATOR_TYPE_TIMER = 5,      /**< Timer handles. */
+    EV_ALLOCATOR_TYPE_THREADPOOL = 6, /**< Thread pool. */
+    EV_ALLOCATOR_TYPE_DIRENT = 7,     /**< Directory entries. */
+    EV_ALLOCATOR_TYPE_MAX,            /**< Number of categories. */
+} ev_allocator_type_t;
+
+/**
+ * @brief Allocator statistics for one #ev_allocator_type_t.
+ */
+typedef struct ev_allocator_stat
+{
+    size_t   live_bytes;    /**< Bytes currently allocated. */
+    size_t   peak_bytes;    /**< Maximum value \p live_bytes ever reached. */
+    uint64_t alloc_count;   /**< Number of allocations. */
+    uint64_t realloc_count; /**< Number of reallocations. */
+    uint64_t free_count;    /**< Number of releases. */
+} ev_allocator_stat_t;
+
 /**
  * @brief Replacement function for realloc.
  * @see https://man7.org/linux/man-pages/man3/realloc.3.html
@@ -57,6 +88,23 @@ EV_API void *ev_realloc(void *ptr, size_t size);
  */
 EV_API void ev_free(void *ptr);
 
+/**
+ * @brief Get allocator statistics.
+ *
+ * Statistics are only available when libev is compiled with
+ * `EV_ALLOCATOR_STAT` defined. It covers memory allocated from both the global
+ * allocator and loop local allocators. Call it periodically and compare the
+ * counters to get allocation rates.
+ *
+ * @param[in] type      Memory category.
+ * @param[out] stat     Statistics.
+ * @return #EV_SUCCESS if success.
+ * @return #EV_EINVAL if \p type is not valid.
+ * @return #EV_ENOSYS if statistics is not compiled in.
+ */
+EV_API int ev_allocator_stat(ev_allocator_type_t type,
+                             ev_allocator_stat_t *stat);
+
 /**
  * @brief Same as
  * [strdup(3)](https://man7.org/linux/man-pages/man3/strdup.3.html)
@@ -0,0 +1,85 @@
+#ifndef __EV_DNS_H__
+#define __EV_DNS_H__
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @defgroup EV_DNS DNS
+ * @{
+ */
+
+struct ev_getaddrinfo_entry;
+
+/**
+ * @brief Typedef of #ev_getaddrinfo_s.
+ */
+typedef struct ev_getaddrinfo_s ev_getaddrinfo_t;
+
+/**
+ * @brief Resolve callback.
+ *
+ * \p res is owned by the resolver cache and is only valid inside the callback,
+ * copy what you need.
+ *
+ * @param[in] req       Resolve request
+ * @param[in] res       Address list, or NULL if failure.
+ * @param[in] status    #ev_errno_t
+ */
+typedef void (*ev_getaddrinfo_cb)(ev_getaddrinfo_t *req,
+                                  const struct addrinfo *res, int status);
+
+/**
+ * @brief Resolve request.
+ */
+struct ev_getaddrinfo_s
+{
+    ev_handle_t                  base;  /**< Base object */
+    ev_list_node_t               node;  /**< Wait queue node */
+    struct ev_getaddrinfo_entry *entry; /**< Cache entry */
+    ev_getaddrinfo_cb            cb;    /**< Resolve callback */
+};
+
+/**
+ * @brief Resolve \p host and \p service asynchronously.
+ *
+ * The lookup runs in the thread pool. Results are cached in \p loop, and
+ * concurrent lookups with the same arguments share one #getaddrinfo() call.
+ * Names that do not exist are cached as well, with a shorter TTL.
+ *
+ * \p cb is never called inside this function.
+ *
+ * @param[in] loop      Event loop
+ * @param[out] req      Resolve request, must be valid until \p cb is called.
+ * @param[in] host      Host name, can be NULL if \p service is not NULL.
+ * @param[in] service   Service name or port, can be NULL.
+ * @param[in] hints     Same as #getaddrinfo(), can be NULL.
+ * @param[in] cb        Resolve callback
+ * @return              #ev_errno_t
+ */
+EV_API int ev_getaddrinfo(ev_loop_t *loop, ev_getaddrinfo_t *req,
+                          const char *host, const char *service,
+                          const struct addrinfo *hints, ev_getaddrinfo_cb cb);
+
+/**
+ * @brief Set cache TTL of \p loop.
+ *
+ * Only affects lookups finished afterwards. Zero disables the cache, but
+ * concurrent lookups are still shared.
+ *
+ * @param[in] loop      Event loop
+ * @param[in] ttl       TTL of resolved names in milliseconds. Default 30000.
+ * @param[in] neg_ttl   TTL of names that do not exist in milliseconds.
+ *   Default 5000.
+ */
+EV_API void ev_getaddrinfo_set_ttl(ev_loop_t *loop, uint64_t ttl,
+                                   uint64_t neg_ttl);
+
+/**
+ * @} EV_DNS
+ */
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,119 @@
+#ifndef __EV_SHM_CHANNEL_H__
+#define __EV_SHM_CHANNEL_H__
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @defgroup EV_SHM_CHANNEL Shared memory channel
+ *
+ * A single producer, single consumer message ring inside shared memory.
+ *
+ * The receiving process creates the channel by #ev_shm_channel_init(), and
+ * share its doorbell by #ev_pipe_write_ex() with #EV_ROLE_EV_SHM_CHANNEL over
+ * an IPC pipe. The sending process opens the same shared memory by
+ * #ev_shm_channel_open(), and attach the doorbell by #ev_pipe_accept().
+ *
+ * Messages are copied into the ring without any system call. The doorbell is
+ * only rung when the receiver is waiting, so a busy channel costs no system
+ * call in either process.
+ *
+ * @note Only supported on Unix.
+ * @{
+ */
+
+/**
+ * @brief Shared memory channel type.
+ */
+typedef struct ev_shm_channel ev_shm_channel_t;
+
+/**
+ * @brief Receive callback.
+ *
+ * \p data points into shared memory, and is only valid inside the callback.
+ *
+ * If the ring is corrupted, the callback is called once with \p size set to
+ * #EV_EPROTO and no more message is received. The channel still needs
+ * #ev_shm_channel_exit().
+ *
+ * @param[in] chan  Channel
+ * @param[in] data  Message, or NULL on failure.
+ * @param[in] size  Message size, or #EV_EPROTO if the channel is broken.
+ * @param[in] arg   User defined argument.
+ */
+typedef void (*ev_shm_channel_recv_cb)(ev_shm_channel_t *chan,
+                                       const void *data, ssize_t size,
+                                       void *arg);
+
+/**
+ * @brief Close callback.
+ * @param[in] chan  Channel
+ * @param[in] arg   User defined argument.
+ */
+typedef void (*ev_shm_channel_cb)(ev_shm_channel_t *chan, void *arg);
+
+/**
+ * @brief Create a channel for receiving.
+ *
+ * The channel keeps \p loop alive until #ev_shm_channel_exit() is called.
+ *
+ * @param[in] loop  Event loop
+ * @param[out] chan Channel
+ * @param[in] key   Shared memory key, see #ev_shmem_init().
+ * @param[in] size  Ring size in bytes, rounded up to power of 2.
+ * @param[in] cb    Receive callback
+ * @param[in] arg   User defined argument.
+ * @return          #ev_errno_t
+ */
+EV_API int ev_shm_channel_init(ev_loop_t *loop, ev_shm_channel_t **chan,
+                               const char *key, size_t size,
+                               ev_shm_channel_recv_cb cb, void *arg);
+
+/**
+ * @brief Open a channel created by peer for sending.
+ *
+ * The doorbell must be attached by #ev_pipe_accept() before the first
+ * #ev_shm_channel_send().
+ *
+ * @param[in] loop  Event loop
+ * @param[out] chan Channel
+ * @param[in] key   Shared memory key
+ * @return          #EV_EINVAL if shared memory is not a channel, or
+ *                  #ev_errno_t.
+ */
+EV_API int ev_shm_channel_open(ev_loop_t *loop, ev_shm_channel_t **chan,
+                               const char *key);
+
+/**
+ * @brief Close channel.
+ * @param[in] chan      Channel
+ * @param[in] close_cb  Close callback, can be NULL.
+ * @param[in] close_arg Close argument.
+ */
+EV_API void ev_shm_channel_exit(ev_shm_channel_t *chan,
+                                ev_shm_channel_cb close_cb, void *close_arg);
+
+/**
+ * @brief Copy a message into channel.
+ *
+ * Only one sender is allowed for each channel.
+ *
+ * @param[in] chan  Channel opened by #ev_shm_channel_open().
+ * @param[in] data  Message
+ * @param[in] size  Message size, empty message is allowed.
+ * @return  #EV_SUCCESS: Message is queued.
+ * @return  #EV_EAGAIN: Ring is full, try again after receiver catches up.
+ * @return  #EV_E2BIG: \p size is larger than half of the ring.
+ * @return  #EV_ENOTCONN: Doorbell is not attached.
+ */
+EV_API int ev_shm_channel_send(ev_shm_channel_t *chan, const void *data,
+                               size_t size);
+
+/**
+ * @} EV_SHM_CHANNEL
+ */
+
+#ifdef __cplusplus
+}
+#endif
+#endif
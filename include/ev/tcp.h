@@ -1,195 +1,734 @@
-#ifndef __EV_TCP_H__
-#define __EV_TCP_H__
-#ifdef __cplusplus
-extern "C" {
-#endif
-
-/**
- * @defgroup EV_TCP TCP
- *
- * TCP layer.
- *
- * @{
- */
-
-/**
- * @example tcp_echo_server.c
- * This is an example for how to use #ev_tcp_t as tcp server.
- */
-
-/**
- * @brief TCP socket.
- */
-typedef struct ev_tcp ev_tcp_t;
-
-/**
- * @brief Close callback for #ev_tcp_t
- * @param[in] sock      A closed socket
- * @param[in] arg       User defined argument.
- */
-typedef void (*ev_tcp_close_cb)(ev_tcp_t *sock, void *arg);
-
-/**
- * @brief Accept callback
- * @param[in] lisn      Listen socket
- * @param[in] conn      Accepted socket
- * @param[in] stat      #ev_errno_t
- * @param[in] arg       User defined argument.
- */
-typedef void (*ev_tcp_accept_cb)(ev_tcp_t *lisn, ev_tcp_t *conn, int stat,
-                                 void *arg);
-
-/**
- * @brief Connect callback
- * @param[in] sock      Connect socket
- * @param[in] stat      #ev_errno_t
- */
-typedef void (*ev_tcp_connect_cb)(ev_tcp_t *sock, int stat, void *arg);
-
-/**
- * @brief Write callback
- * @param[in] sock      Socket.
- * @param[in] size      Write result
- * @param[in] arg       User defined argument.
- */
-typedef void (*ev_tcp_write_cb)(ev_tcp_t *sock, ssize_t size, void *arg);
-
-/**
- * @brief Read callback
- * @param[in] sock      Socket.
- * @param[in] size      Read result.
- * @param[in] arg       User defined argument.
- */
-typedef void (*ev_tcp_read_cb)(ev_tcp_t *sock, ssize_t size, void *arg);
-
-/**
- * @brief Initialize a tcp socket
- * @param[in] loop      Event loop
- * @param[out] tcp      TCP handle
- */
-EV_API int ev_tcp_init(ev_loop_t *loop, ev_tcp_t **tcp);
-
-/**
- * @brief Destroy socket
- * @param[in] sock      Socket
- * @param[in] cb        Destroy callback
- * @param[in] arg       User defined argument.
- */
-EV_API void ev_tcp_exit(ev_tcp_t *sock, ev_tcp_close_cb cb, void *arg);
-
-/**
- * @brief Bind the handle to an address and port.
- * addr should point to an initialized struct sockaddr_in or struct
- * sockaddr_in6.
- * @param[in] tcp       Socket handler
- * @param[in] addr      Bind address
- * @param[in] addrlen   Address length
- * @return              #ev_errno_t
- */
-EV_API int ev_tcp_bind(ev_tcp_t *tcp, const struct sockaddr *addr,
-                       size_t addrlen);
-
-/**
- * @brief Start listening for incoming connections.
- * @param[in] sock      Listen socket
- * @param[in] backlog   The number of connections the kernel might queue
- * @return              #ev_errno_t
- */
-EV_API int ev_tcp_listen(ev_tcp_t *sock, int backlog);
-
-/**
- * @brief Accept a connection from listen socket
- * @param[in] acpt          Listen socket
- * @param[in] conn          The socket to store new connection
- * @param[in] cb            Accept callback
- * @param[in] arg           User defined argument pass to \p cb.
- * @return                  #ev_errno_t
- */
-EV_API int ev_tcp_accept(ev_tcp_t *acpt, ev_tcp_t *conn, ev_tcp_accept_cb cb,
-                         void *arg);
-
-/**
- * @brief Connect to address
- * @param[in] sock          Socket handle
- * @param[in] addr          Address
- * @param[in] size          Address size
- * @param[in] cb            Connect callback
- * @param[in] arg           Connect argument.
- * @return                  #ev_errno_t
- */
-EV_API int ev_tcp_connect(ev_tcp_t *sock, struct sockaddr *addr, size_t size,
-                          ev_tcp_connect_cb cb, void *arg);
-
-/**
- * @brief Write data
- *
- * Once #ev_tcp_write() return #EV_SUCCESS, it take the ownership of \p req, so
- * you should not modify the content of it until bounded callback is called.
- *
- * It is a guarantee that every bounded callback of \p req will be called, with
- * following scene:
- *   + If write success or failure. The callback will be called with write
- * status.
- *   + If \p pipe is exiting but there are pending write request. The callback
- *     will be called with status #EV_ECANCELED.
- *
- * @param[in] sock      Socket handle
- * @param[in] bufs      Buffer list
- * @param[in] nbuf      Buffer number
- * @param[in] cb        Send result callback
- * @param[in] arg       User defined argument.
- * @return              #ev_errno_t
- */
-EV_API int ev_tcp_write(ev_tcp_t *sock, ev_buf_t *bufs, size_t nbuf,
-                        ev_tcp_write_cb cb, void *arg);
-
-/**
- * @brief Read data
- *
- * Once #ev_tcp_read() return #EV_SUCCESS, it take the ownership of \p req, so
- * you should not modify the content of it until bounded callback is called.
- *
- * It is a guarantee that every bounded callback of \p req will be called, with
- * following scene:
- *   + If read success or failure. The callback will be called with read status.
- *   + If \p pipe is exiting but there are pending read request. The callback
- *     will be called with status #EV_ECANCELED.
- *
- * @param[in] sock  Socket handle
- * @param[in] bufs  Buffer list
- * @param[in] nbuf  Buffer number
- * @param[in] cb    Read result callback
- * @param[in] arg   User defined argument.
- * @return          #ev_errno_t
- */
-EV_API int ev_tcp_read(ev_tcp_t *sock, ev_buf_t *bufs, size_t nbuf,
-                       ev_tcp_read_cb cb, void *arg);
-
-/**
- * @brief Get the current address to which the socket is bound.
- * @param[in] sock  Socket handle
- * @param[out] name A buffer to store address
- * @param[in,out] len   buffer size
- * @return          #ev_errno_t
- */
-EV_API int ev_tcp_getsockname(ev_tcp_t *sock, struct sockaddr *name,
-                              size_t *len);
-
-/**
- * @brief Get the address of the peer connected to the socket.
- * @param[in] sock  Socket handle
- * @param[out] name A buffer to store address
- * @param[in,out] len   buffer size
- * @return          #ev_errno_t
- */
-EV_API int ev_tcp_getpeername(ev_tcp_t *sock, struct sockaddr *name,
-                              size_t *len);
-
-/**
- * @} EV_TCP
- */
-
-#ifdef __cplusplus
-}
-#endif
-#endif
+#ifndef __EV_TCP_H__
+#define __EV_TCP_H__
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @defgroup EV_TCP TCP
+ *
+ * TCP layer.
+ *
+ * @{
+ */
+
+/**
+ * @example tcp_echo_server.c
+ * This is an example for how to use #ev_tcp_t as tcp server.
+ */
+
+/**
+ * @brief TCP socket options.
+ *
+ * All options take an int value.
+ */
+typedef enum ev_tcp_opt
+{
+    /**
+     * @brief TCP_NODELAY. Non-zero to send small segments without delay.
+     */
+    EV_TCP_OPT_NODELAY = 0,
+
+    /**
+     * @brief SO_KEEPALIVE. Non-zero to send keep-alive probes.
+     */
+    EV_TCP_OPT_KEEPALIVE = 1,
+
+    /**
+     * @brief SO_SNDBUF. Send buffer size in bytes.
+     */
+    EV_TCP_OPT_SNDBUF = 2,
+
+    /**
+     * @brief SO_RCVBUF. Receive buffer size in bytes.
+     */
+    EV_TCP_OPT_RCVBUF = 3,
+
+    /**
+     * @brief TCP_QUICKACK. Non-zero to send ACK immediately.
+     * @note The kernel may turn it off again by itself.
+     */
+    EV_TCP_OPT_QUICKACK = 4,
+
+    /**
+     * @brief TCP_NOTSENT_LOWAT. Socket is writable only if unsent data in
+     *   bytes is less than this value.
+     */
+    EV_TCP_OPT_NOTSENT_LOWAT = 5,
+
+    /**
+     * @brief TCP_DEFER_ACCEPT. Seconds to wait for data before a connection
+     *   is accepted. Listen socket only.
+     */
+    EV_TCP_OPT_DEFER_ACCEPT = 6,
+
+    /**
+     * @brief TCP_FASTOPEN. Max length of pending TFO requests. Listen socket
+     *   only.
+     */
+    EV_TCP_OPT_FASTOPEN = 7,
+
+    /**
+     * @brief SO_BUSY_POLL. Microseconds to busy poll the device queue on
+     *   read.
+     */
+    EV_TCP_OPT_BUSY_POLL = 8,
+} ev_tcp_opt_t;
+
+/**
+ * @brief TCP socket.
+ */
+typedef struct ev_tcp ev_tcp_t;
+
+/**
+ * @brief Outbound connection pool.
+ */
+typedef struct ev_tcp_pool ev_tcp_pool_t;
+
+/**
+ * @brief See #ev_file_t.
+ */
+struct ev_file_s;
+
+/**
+ * @brief Close callback for #ev_tcp_t
+ * @param[in] sock      A closed socket
+ * @param[in] arg       User defined argument.
+ */
+typedef void (*ev_tcp_close_cb)(ev_tcp_t *sock, void *arg);
+
+/**
+ * @brief Accept callback
+ * @param[in] lisn      Listen socket
+ * @param[in] conn      Accepted socket
+ * @param[in] stat      #ev_errno_t
+ * @param[in] arg       User defined argument.
+ */
+typedef void (*ev_tcp_accept_cb)(ev_tcp_t *lisn, ev_tcp_t *conn, int stat,
+                                 void *arg);
+
+/**
+ * @brief Connect callback
+ * @param[in] sock      Connect socket
+ * @param[in] stat      #ev_errno_t
+ */
+typedef void (*ev_tcp_connect_cb)(ev_tcp_t *sock, int stat, void *arg);
+
+/**
+ * @brief Write callback
+ * @param[in] sock      Socket.
+ * @param[in] size      Write result
+ * @param[in] arg       User defined argument.
+ */
+typedef void (*ev_tcp_write_cb)(ev_tcp_t *sock, ssize_t size, void *arg);
+
+/**
+ * @brief Write queue watermark callback
+ * @param[in] sock      Socket.
+ * @param[in] high      Non-zero if queued bytes reach high watermark, zero if
+ *                      they drop to low watermark.
+ * @param[in] arg       User defined argument.
+ */
+typedef void (*ev_tcp_watermark_cb)(ev_tcp_t *sock, int high, void *arg);
+
+/**
+ * @brief Pipe finish callback
+ * @param[in] src       Source handle.
+ * @param[in] dst       Destination handle.
+ * @param[in] size      Number of bytes moved to \p dst.
+ * @param[in] stat      0 if \p src reaches end of file and every byte is moved
+ *                      to \p dst, otherwise #ev_errno_t.
+ * @param[in] arg       User defined argument.
+ */
+typedef void (*ev_tcp_pipe_cb)(void *src, void *dst, uint64_t size, int stat,
+                               void *arg);
+
+/**
+ * @brief Acquire callback
+ * @param[in] pool      Connection pool
+ * @param[in] sock      Connected socket, NULL if failed.
+ * @param[in] stat      #ev_errno_t
+ * @param[in] arg       User defined argument.
+ */
+typedef void (*ev_tcp_pool_cb)(ev_tcp_pool_t *pool, ev_tcp_t *sock, int stat,
+                               void *arg);
+
+/**
+ * @brief Options of #ev_tcp_pipe_to().
+ */
+typedef struct ev_tcp_pipe_opts
+{
+    size_t         capacity; /**< Max bytes buffered in kernel, 0 for default. */
+    ev_tcp_pipe_cb cb;       /**< Finish callback, can be NULL. */
+    void          *arg;      /**< User defined argument. */
+} ev_tcp_pipe_opts_t;
+
+/**
+ * @brief Options of #ev_tcp_pool_init().
+ */
+typedef struct ev_tcp_pool_opts
+{
+    size_t   max_idle;     /**< Max idle connections kept per address. */
+    size_t   max_per_host; /**< Max connections per address, including those
+                                in use, 0 for unlimited. */
+    uint64_t idle_timeout; /**< Close connections idle for this many
+                                milliseconds, 0 to keep them forever. */
+} ev_tcp_pool_opts_t;
+
+/**
+ * @brief Read callback
+ * @param[in] sock      Socket.
+ * @param[in] size      Read result.
+ * @param[in] arg       User defined argument.
+ */
+typedef void (*ev_tcp_read_cb)(ev_tcp_t *sock, ssize_t size, void *arg);
+
+/**
+ * @brief Transport statistics of a connection.
+ *
+ * Fields not provided by the system are zero.
+ */
+typedef struct ev_tcp_info
+{
+    uint32_t rtt;            /**< Smoothed RTT in microseconds. */
+    uint32_t rtt_var;        /**< RTT variance in microseconds. */
+    uint32_t min_rtt;        /**< Minimum RTT in microseconds. */
+    uint32_t snd_mss;        /**< Sender MSS in bytes. */
+    uint32_t snd_cwnd;       /**< Congestion window in segments. */
+    uint32_t unacked;        /**< Segments in flight. */
+    uint32_t lost;           /**< Segments considered lost. */
+    uint32_t total_retrans;  /**< Segments retransmitted in total. */
+    uint64_t delivery_rate;  /**< Delivery rate in bytes per second. */
+    uint64_t bytes_acked;    /**< Bytes acknowledged by peer. */
+    uint64_t bytes_received; /**< Bytes received from peer. */
+} ev_tcp_info_t;
+
+/**
+ * @brief Number of buckets in #ev_tcp_info_stat_t histograms.
+ */
+#define EV_TCP_INFO_HIST_SIZE 32
+
+/**
+ * @brief Histograms of #ev_tcp_info_t across connections.
+ *
+ * Bucket 0 counts zero values, bucket N counts values in [2^(N-1), 2^N), and
+ * the last bucket also counts everything larger.
+ */
+typedef struct ev_tcp_info_stat
+{
+    uint64_t sock_cnt;                             /**< Sampled connections. */
+    uint64_t rtt[EV_TCP_INFO_HIST_SIZE];           /**< #ev_tcp_info_t::rtt */
+    uint64_t snd_cwnd[EV_TCP_INFO_HIST_SIZE];      /**< #ev_tcp_info_t::snd_cwnd */
+    uint64_t total_retrans[EV_TCP_INFO_HIST_SIZE]; /**< #ev_tcp_info_t::total_retrans */
+    uint64_t delivery_rate[EV_TCP_INFO_HIST_SIZE]; /**< #ev_tcp_info_t::delivery_rate */
+} ev_tcp_info_stat_t;
+
+/**
+ * @brief Typedef of #ev_tcp_sampler.
+ */
+typedef struct ev_tcp_sampler ev_tcp_sampler_t;
+
+/**
+ * @brief Sampler callback
+ * @param[in] sampler   Sampler.
+ * @param[in] stat      Statistics of this round.
+ * @param[in] arg       User defined argument.
+ */
+typedef void (*ev_tcp_sampler_cb)(ev_tcp_sampler_t         *sampler,
+                                  const ev_tcp_info_stat_t *stat, void *arg);
+
+/**
+ * @brief Initialize a tcp socket
+ * @param[in] loop      Event loop
+ * @param[out] tcp      TCP handle
+ */
+EV_API int ev_tcp_init(ev_loop_t *loop, ev_tcp_t **tcp);
+
+/**
+ * @brief Get the size of #ev_tcp_t.
+ * @return              Size in bytes.
+ */
+EV_API size_t ev_tcp_size(void);
+
+/**
+ * @brief Initialize a tcp socket in caller-owned memory.
+ *
+ * Same as #ev_tcp_init(), but the handle is constructed inside \p mem instead
+ * of allocating from heap. \p mem must be at least #ev_tcp_size() bytes,
+ * aligned as memory returned by malloc(3), and stay valid until the close
+ * callback is called.
+ *
+ * @param[in] loop      Event loop
+ * @param[out] tcp      TCP handle
+ * @param[in] mem       Memory to construct the handle in.
+ * @return              #ev_errno_t
+ */
+EV_API int ev_tcp_init_inplace(ev_loop_t *loop, ev_tcp_t **tcp, void *mem);
+
+/**
+ * @brief Destroy socket
+ * @param[in] sock      Socket
+ * @param[in] cb        Destroy callback
+ * @param[in] arg       User defined argument.
+ */
+EV_API void ev_tcp_exit(ev_tcp_t *sock, ev_tcp_close_cb cb, void *arg);
+
+/**
+ * @brief Bind the handle to an address and port.
+ * addr should point to an initialized struct sockaddr_in or struct
+ * sockaddr_in6.
+ * @param[in] tcp       Socket handler
+ * @param[in] addr      Bind address
+ * @param[in] addrlen   Address length
+ * @return              #ev_errno_t
+ */
+EV_API int ev_tcp_bind(ev_tcp_t *tcp, const struct sockaddr *addr,
+                       size_t addrlen);
+
+/**
+ * @brief Start listening for incoming connections.
+ * @param[in] sock      Listen socket
+ * @param[in] backlog   The number of connections the kernel might queue
+ * @return              #ev_errno_t
+ */
+EV_API int ev_tcp_listen(ev_tcp_t *sock, int backlog);
+
+/**
+ * @brief Accept a connection from listen socket
+ * @param[in] acpt          Listen socket
+ * @param[in] conn          The socket to store new connection
+ * @param[in] cb            Accept callback
+ * @param[in] arg           User defined argument pass to \p cb.
+ * @return                  #ev_errno_t
+ */
+EV_API int ev_tcp_accept(ev_tcp_t *acpt, ev_tcp_t *conn, ev_tcp_accept_cb cb,
+                         void *arg);
+
+/**
+ * @brief Accept connections automatically.
+ *
+ * Each time \p lisn becomes readable, connections are accepted until there is
+ * none left or \p budget connections are accepted, so a burst of connections
+ * costs one wakeup instead of one per connection.
+ *
+ * For each connection a handle is created by #ev_tcp_init_accept() and passed
+ * to \p cb with \p stat set to 0. The handle belongs to the user and must be
+ * closed by #ev_tcp_exit(). If accept fails (e.g. #EV_EMFILE), \p cb is called
+ * with \p conn set to NULL and the error in \p stat, and accepting continues
+ * on next event.
+ *
+ * Requests queued by #ev_tcp_accept() are served first.
+ *
+ * If the process runs out of fds, \p cb is called with #EV_EMFILE or
+ * #EV_ENFILE, and connections waiting in backlog are closed. Otherwise the
+ * listen socket would keep waking up with the same error.
+ *
+ * On Windows there is no readiness to drain, \p budget is the number of
+ * accept requests kept pending instead.
+ *
+ * @param[in] lisn      Listen socket
+ * @param[in] budget    Max connections accepted in one round, 0 for default.
+ * @param[in] cb        Connection callback
+ * @param[in] arg       User defined argument pass to \p cb.
+ * @return              #ev_errno_t
+ */
+EV_API int ev_tcp_accept_start(ev_tcp_t *lisn, size_t budget,
+                               ev_tcp_accept_cb cb, void *arg);
+
+/**
+ * @brief Stop accepting connections automatically.
+ * @param[in] lisn      Listen socket
+ * @return              #ev_errno_t
+ */
+EV_API int ev_tcp_accept_stop(ev_tcp_t *lisn);
+
+/**
+ * @brief Enable recycling of connection handles for listen socket.
+ *
+ * Handles obtained by #ev_tcp_init_accept() are kept by \p lisn once they are
+ * closed instead of being freed, so the next #ev_tcp_init_accept() can reuse
+ * them without going through the allocator. At most \p capacity closed
+ * handles are kept, the rest are freed as usual. Set \p capacity to 0 to
+ * disable the cache and release all kept handles.
+ *
+ * All kept handles are released when \p lisn is closed.
+ *
+ * @param[in] lisn      Listen socket
+ * @param[in] capacity  Max number of closed handles to keep.
+ * @return              #ev_errno_t
+ */
+EV_API int ev_tcp_accept_cache(ev_tcp_t *lisn, size_t capacity);
+
+/**
+ * @brief Initialize a tcp socket for accepting a connection from \p lisn.
+ *
+ * The handle is reused from the cache of \p lisn if possible, otherwise it is
+ * allocated as #ev_tcp_init() does. The returned handle is ready to be passed
+ * to #ev_tcp_accept(), and is used and closed like any other handle. Do not
+ * touch it after the close callback returns, as it may be handed out again.
+ *
+ * @see #ev_tcp_accept_cache()
+ * @param[in] lisn      Listen socket
+ * @param[out] conn     TCP handle
+ * @return              #ev_errno_t. #EV_EINVAL if \p lisn is not listening.
+ */
+EV_API int ev_tcp_init_accept(ev_tcp_t *lisn, ev_tcp_t **conn);
+
+/**
+ * @brief Connect to address
+ * @param[in] sock          Socket handle
+ * @param[in] addr          Address
+ * @param[in] size          Address size
+ * @param[in] cb            Connect callback
+ * @param[in] arg           Connect argument.
+ * @return                  #ev_errno_t
+ */
+EV_API int ev_tcp_connect(ev_tcp_t *sock, struct sockaddr *addr, size_t size,
+                          ev_tcp_connect_cb cb, void *arg);
+
+/**
+ * @brief Write data
+ *
+ * Once #ev_tcp_write() return #EV_SUCCESS, it take the ownership of \p req, so
+ * you should not modify the content of it until bounded callback is called.
+ *
+ * It is a guarantee that every bounded callback of \p req will be called, with
+ * following scene:
+ *   + If write success or failure. The callback will be called with write
+ * status.
+ *   + If \p pipe is exiting but there are pending write request. The callback
+ *     will be called with status #EV_ECANCELED.
+ *
+ * The callback is never called inside #ev_tcp_write(), even if the data is
+ * sent, or fails to be sent, right away.
+ *
+ * @param[in] sock      Socket handle
+ * @param[in] bufs      Buffer list
+ * @param[in] nbuf      Buffer number
+ * @param[in] cb        Send result callback
+ * @param[in] arg       User defined argument.
+ * @return              #ev_errno_t. Failure to send is not returned here but
+ *                      passed to \p cb.
+ */
+EV_API int ev_tcp_write(ev_tcp_t *sock, ev_buf_t *bufs, size_t nbuf,
+                        ev_tcp_write_cb cb, void *arg);
+
+/**
+ * @brief Same as #ev_tcp_write(), but won't queue a write request if it can't
+ *   be completed immediately.
+ *
+ * Data is written only if there is no pending write request, so the order of
+ * data is kept.
+ *
+ * @param[in] sock      Socket handle
+ * @param[in] bufs      Buffer list
+ * @param[in] nbuf      Buffer number
+ * @return              Number of bytes written, which may be less than the
+ *                      total size of \p bufs, or #ev_errno_t on failure.
+ *                      #EV_EAGAIN if nothing could be written right now.
+ *                      #EV_ENOSYS if not supported on this platform.
+ */
+EV_API ssize_t ev_tcp_try_write(ev_tcp_t *sock, ev_buf_t *bufs, size_t nbuf);
+
+/**
+ * @brief Send a range of file to socket.
+ *
+ * The data is copied inside the kernel by sendfile(2) if available, so no user
+ * space buffer is involved. The request is queued together with requests from
+ * #ev_tcp_write() and keeps the order of data.
+ *
+ * \p cb is called with \p len on success. If the file is shorter than
+ * requested, \p cb is called with #EV_EOF after the available data is sent,
+ * and requests queued after it are not affected.
+ *
+ * \p file must stay open until \p cb is called.
+ *
+ * @param[in] sock      Socket handle
+ * @param[in] file      File to send
+ * @param[in] offset    Offset of first byte in \p file
+ * @param[in] len       Number of bytes to send
+ * @param[in] cb        Send result callback
+ * @param[in] arg       User defined argument.
+ * @return              #ev_errno_t. #EV_ENOTCONN if \p sock has no socket.
+ *                      #EV_ENOSYS if not supported on this platform.
+ */
+EV_API int ev_tcp_sendfile(ev_tcp_t *sock, struct ev_file_s *file,
+                           int64_t offset, size_t len, ev_tcp_write_cb cb,
+                           void *arg);
+
+/**
+ * @brief Watch the number of bytes waiting in write queue.
+ *
+ * \p cb is called with \p high set to non-zero once queued bytes reach \p high,
+ * so the producer can pause, and then with zero once they drop to \p low, so it
+ * can resume. The callback may be called from inside #ev_tcp_write().
+ *
+ * @param[in] sock      Socket handle
+ * @param[in] low       Low watermark in bytes.
+ * @param[in] high      High watermark in bytes, must not be less than \p low.
+ * @param[in] cb        Watermark callback, or NULL to disable.
+ * @param[in] arg       User defined argument.
+ * @return              #ev_errno_t. #EV_ENOSYS if not supported on this
+ *                      platform.
+ */
+EV_API int ev_tcp_set_watermark(ev_tcp_t *sock, size_t low, size_t high,
+                                ev_tcp_watermark_cb cb, void *arg);
+
+/**
+ * @brief Get the number of bytes waiting in write queue.
+ * @param[in] sock      Socket handle
+ * @return              Queued bytes, or #ev_errno_t. #EV_ENOSYS if not
+ *                      supported on this platform.
+ */
+EV_API ssize_t ev_tcp_write_queue_size(ev_tcp_t *sock);
+
+/**
+ * @brief Send data of #ev_tcp_write() by MSG_ZEROCOPY.
+ *
+ * The kernel sends directly from the user buffers instead of copying them,
+ * which saves CPU for large writes. As the buffers are still in use after the
+ * data is queued to the socket, the write callback is delayed until the kernel
+ * notifies that they are released, so do not reuse the buffers until then.
+ *
+ * Small writes are usually slower by zerocopy, only enable it if most of the
+ * writes are large (at least tens of KiB).
+ *
+ * Callbacks of #ev_tcp_sendfile() are not delayed, so they may be called
+ * before callbacks of earlier #ev_tcp_write().
+ *
+ * @param[in] sock      Connected socket
+ * @param[in] enable    Non-zero to enable, zero to disable.
+ * @return              #ev_errno_t. #EV_EBUSY if disable with pending write
+ *                      requests. #EV_ENOSYS if not supported on this platform.
+ */
+EV_API int ev_tcp_set_zerocopy(ev_tcp_t *sock, int enable);
+
+/**
+ * @brief Forward all data received by \p src to \p dst.
+ *
+ * Data is moved by splice(2) through a kernel pipe, so it is never copied into
+ * user space. At most ev_tcp_pipe_opts_t::capacity bytes are buffered, \p src
+ * is not read while \p dst is unable to take more, so a slow peer throttles a
+ * fast one.
+ *
+ * Until the finish callback is called, \p src does not accept #ev_tcp_read()
+ * and \p dst does not accept #ev_tcp_write(), both fail with #EV_EBUSY. The
+ * callback is called once \p src reaches end of file, either socket fails, or
+ * either socket is closed. \p dst is not shutdown by this function.
+ *
+ * @param[in] src       Connected socket to read from.
+ * @param[in] dst       Connected socket to write to, may be the same as \p src.
+ * @param[in] opts      Options, can be NULL.
+ * @return              #ev_errno_t. #EV_EBUSY if \p src has pending read
+ *                      requests or \p dst has pending write requests.
+ *                      #EV_ENOSYS if not supported on this platform.
+ */
+EV_API int ev_tcp_pipe_to(ev_tcp_t *src, ev_tcp_t *dst,
+                          const ev_tcp_pipe_opts_t *opts);
+
+/**
+ * @brief Same as #ev_tcp_pipe_to(), but either side may be a #ev_pipe_t.
+ *
+ * Only #EV_ROLE_EV_TCP and #EV_ROLE_EV_PIPE are supported, and the pipe must
+ * be in data mode (not IPC).
+ *
+ * @param[in] src_role  Type of \p src.
+ * @param[in] src       Handle to read from.
+ * @param[in] dst_role  Type of \p dst.
+ * @param[in] dst       Handle to write to.
+ * @param[in] opts      Options, can be NULL.
+ * @return              #ev_errno_t
+ */
+EV_API int ev_tcp_pipe_to_ex(ev_role_t src_role, void *src, ev_role_t dst_role,
+                             void *dst, const ev_tcp_pipe_opts_t *opts);
+
+/**
+ * @brief Read data
+ *
+ * Once #ev_tcp_read() return #EV_SUCCESS, it take the ownership of \p req, so
+ * you should not modify the content of it until bounded callback is called.
+ *
+ * It is a guarantee that every bounded callback of \p req will be called, with
+ * following scene:
+ *   + If read success or failure. The callback will be called with read status.
+ *   + If \p pipe is exiting but there are pending read request. The callback
+ *     will be called with status #EV_ECANCELED.
+ *
+ * @param[in] sock  Socket handle
+ * @param[in] bufs  Buffer list
+ * @param[in] nbuf  Buffer number
+ * @param[in] cb    Read result callback
+ * @param[in] arg   User defined argument.
+ * @return          #ev_errno_t
+ */
+EV_API int ev_tcp_read(ev_tcp_t *sock, ev_buf_t *bufs, size_t nbuf,
+                       ev_tcp_read_cb cb, void *arg);
+
+/**
+ * @brief Set socket option.
+ *
+ * If \p sock does not have an underlying socket yet, the option is saved and
+ * applied as soon as the socket is created by #ev_tcp_bind() or
+ * #ev_tcp_connect(). Listen socket only options (#EV_TCP_OPT_DEFER_ACCEPT,
+ * #EV_TCP_OPT_FASTOPEN) are applied by #ev_tcp_listen() before it starts
+ * listening.
+ *
+ * Options of a listen socket are inherited by its accepted connections, except
+ * for listen socket only options.
+ *
+ * @param[in] sock      Socket handle
+ * @param[in] opt       Option
+ * @param[in] val       Option value
+ * @return              #ev_errno_t. #EV_ENOSYS if \p opt is not supported on
+ *                      this platform.
+ */
+EV_API int ev_tcp_setopt(ev_tcp_t *sock, ev_tcp_opt_t opt, int val);
+
+/**
+ * @brief Get socket option.
+ *
+ * The value is read from the socket if it is applied, so it might be different
+ * from what is set (e.g. Linux doubles #EV_TCP_OPT_SNDBUF). Otherwise the saved
+ * value is returned.
+ *
+ * @param[in] sock      Socket handle
+ * @param[in] opt       Option
+ * @param[out] val      Option value
+ * @return              #ev_errno_t. #EV_EBADF if there is no socket and the
+ *                      option is not set.
+ */
+EV_API int ev_tcp_getopt(ev_tcp_t *sock, ev_tcp_opt_t opt, int *val);
+
+/**
+ * @brief Create outbound connection pool.
+ *
+ * The pool keeps connections released by user, keyed by peer address, and
+ * hands them out again instead of connecting every time. Idle connections are
+ * reused newest first, and are closed when they expire, when the peer closes
+ * them or when they receive unexpected data.
+ *
+ * @param[in] loop      Event loop
+ * @param[out] pool     Connection pool
+ * @param[in] opts      Options
+ * @return              #ev_errno_t
+ */
+EV_API int ev_tcp_pool_init(ev_loop_t *loop, ev_tcp_pool_t **pool,
+                            const ev_tcp_pool_opts_t *opts);
+
+/**
+ * @brief Destroy connection pool.
+ *
+ * Idle connections are closed. Pending acquires are finished with
+ * #EV_ECANCELED. Connections in use are detached from the pool and must be
+ * closed by #ev_tcp_exit().
+ *
+ * @param[in] pool      Connection pool
+ */
+EV_API void ev_tcp_pool_exit(ev_tcp_pool_t *pool);
+
+/**
+ * @brief Get a connection to \p addr.
+ *
+ * An idle connection is reused if there is any, otherwise a new one is made.
+ * If ev_tcp_pool_opts_t::max_per_host connections to \p addr exist, the
+ * request waits until one of them is released or closed.
+ *
+ * \p cb is never called inside this function.
+ *
+ * @param[in] pool      Connection pool
+ * @param[in] addr      Peer address
+ * @param[in] size      Address size
+ * @param[in] cb        Acquire callback
+ * @param[in] arg       User defined argument.
+ * @return              #ev_errno_t
+ */
+EV_API int ev_tcp_pool_acquire(ev_tcp_pool_t *pool, const struct sockaddr *addr,
+                               size_t size, ev_tcp_pool_cb cb, void *arg);
+
+/**
+ * @brief Give connection back to pool.
+ *
+ * The connection is closed instead of kept if \p reuse is zero, it has pending
+ * read or write requests, it is not healthy, or the pool is full.
+ *
+ * @param[in] pool      Connection pool
+ * @param[in] sock      Connection from #ev_tcp_pool_acquire().
+ * @param[in] reuse     Non-zero if the connection can be reused.
+ */
+EV_API void ev_tcp_pool_release(ev_tcp_pool_t *pool, ev_tcp_t *sock,
+                                int reuse);
+
+/**
+ * @brief Get transport statistics of a connection.
+ *
+ * On Linux it costs one getsockopt(TCP_INFO) call.
+ *
+ * @param[in] sock      Connected socket
+ * @param[out] info     Transport statistics
+ * @return              #ev_errno_t. #EV_ENOTCONN if \p sock is not connected.
+ */
+EV_API int ev_tcp_get_info(ev_tcp_t *sock, ev_tcp_info_t *info);
+
+/**
+ * @brief Aggregate #ev_tcp_get_info() of all connections in \p loop.
+ *
+ * Listening and unconnected sockets are skipped.
+ *
+ * @param[in] loop      Event loop
+ * @param[out] stat     Histograms, reset before filling.
+ */
+EV_API void ev_tcp_info_collect(ev_loop_t *loop, ev_tcp_info_stat_t *stat);
+
+/**
+ * @brief Run #ev_tcp_info_collect() periodically.
+ *
+ * The sampler keeps \p loop alive until #ev_tcp_sampler_exit() is called.
+ *
+ * @param[in] loop      Event loop
+ * @param[out] sampler  Sampler
+ * @param[in] interval  Sample interval in milliseconds, must not be 0.
+ * @param[in] cb        Sampler callback
+ * @param[in] arg       User defined argument.
+ * @return              #ev_errno_t. #EV_EINVAL if \p interval is 0.
+ */
+EV_API int ev_tcp_sampler_init(ev_loop_t *loop, ev_tcp_sampler_t **sampler,
+                               uint64_t interval, ev_tcp_sampler_cb cb,
+                               void *arg);
+
+/**
+ * @brief Stop and destroy the sampler.
+ *
+ * It is safe to call this function in #ev_tcp_sampler_cb.
+ *
+ * @param[in] sampler   Sampler
+ */
+EV_API void ev_tcp_sampler_exit(ev_tcp_sampler_t *sampler);
+
+/**
+ * @brief Get the current address to which the socket is bound.
+ * @param[in] sock  Socket handle
+ * @param[out] name A buffer to store address
+ * @param[in,out] len   buffer size
+ * @return          #ev_errno_t
+ */
+EV_API int ev_tcp_getsockname(ev_tcp_t *sock, struct sockaddr *name,
+                              size_t *len);
+
+/**
+ * @brief Get the address of the peer connected to the socket.
+ * @param[in] sock  Socket handle
+ * @param[out] name A buffer to store address
+ * @param[in,out] len   buffer size
+ * @return          #ev_errno_t
+ */
+EV_API int ev_tcp_getpeername(ev_tcp_t *sock, struct sockaddr *name,
+                              size_t *len);
+
+/**
+ * @} EV_TCP
+ */
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -1,73 +1,188 @@
-#ifndef __EV_TIMER_H__
-#define __EV_TIMER_H__
-#ifdef __cplusplus
-extern "C" {
-#endif
-
-/**
- * @defgroup EV_TIMER Timer
- * @{
- */
-
-/**
- * @brief Timer handle type.
- */
-typedef struct ev_timer ev_timer_t;
-
-/**
- * @brief Type definition for callback passed to #ev_timer_start().
- * @param[in] timer     A pointer to #ev_timer_t structure
- */
-typedef void (*ev_timer_cb)(ev_timer_t *timer, void* arg);
-
-/**
- * @brief Initialize the handle.
- * @param[in] loop      A pointer to the event loop
- * @param[out] handle   The structure to initialize
- * @return              #ev_errno_t
- */
-EV_API int ev_timer_init(ev_loop_t *loop, ev_timer_t **handle);
-
-/**
- * @brief Destroy the timer
- * @warning The timer structure cannot be freed until close_cb is called.
- * @param[in] handle    Timer handle
- * @param[in] cb        Close callback.
- * @param[in] arg       User defined argument.
- */
-EV_API void ev_timer_exit(ev_timer_t *handle, ev_timer_cb cb, void* arg);
-
-/**
- * @brief Start the timer. timeout and repeat are in milliseconds.
- *
- * If timeout is zero, the callback fires on the next event loop iteration. If
- * repeat is non-zero, the callback fires first after timeout milliseconds and
- * then repeatedly after repeat milliseconds.
- *
- * @param[in] handle    Timer handle
- * @param[in] timeout   The first callback timeout
- * @param[in] repeat    Repeat timeout
- * @param[in] cb        Active callback
- * @param[in] arg       User defined argument.
- * @return              #ev_errno_t
- */
-EV_API int ev_timer_start(ev_timer_t *handle, uint64_t timeout,
-                          uint64_t repeat, ev_timer_cb cb, void* arg);
-
-/**
- * @brief Stop the timer.
- *
- * the callback will not be called anymore.
- *
- * @param[in] handle    Timer handle
- */
-EV_API void ev_timer_stop(ev_timer_t *handle);
-
-/**
- * @} EV_TIMER
- */
-
-#ifdef __cplusplus
-}
-#endif
-#endif
+#ifndef __EV_TIMER_H__
+#define __EV_TIMER_H__
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @defgroup EV_TIMER Timer
+ * @{
+ */
+
+/**
+ * @brief Timer handle type.
+ */
+typedef struct ev_timer ev_timer_t;
+
+/**
+ * @brief Type definition for callback passed to #ev_timer_start().
+ * @param[in] timer     A pointer to #ev_timer_t structure
+ */
+typedef void (*ev_timer_cb)(ev_timer_t *timer, void* arg);
+
+/**
+ * @brief Initialize the handle.
+ * @param[in] loop      A pointer to the event loop
+ * @param[out] handle   The structure to initialize
+ * @return              #ev_errno_t
+ */
+EV_API int ev_timer_init(ev_loop_t *loop, ev_timer_t **handle);
+
+/**
+ * @brief Get the size of #ev_timer_t.
+ * @return              Size in bytes.
+ */
+EV_API size_t ev_timer_size(void);
+
+/**
+ * @brief Initialize the handle in caller-owned memory.
+ *
+ * Same as #ev_timer_init(), but the handle is constructed inside \p mem
+ * instead of allocating from heap. \p mem must be at least #ev_timer_size()
+ * bytes, aligned as memory returned by malloc(3), and stay valid until the
+ * close callback is called.
+ *
+ * @param[in] loop      A pointer to the event loop
+ * @param[out] handle   The structure to initialize
+ * @param[in] mem       Memory to construct the handle in.
+ * @return              #ev_errno_t
+ */
+EV_API int ev_timer_init_inplace(ev_loop_t *loop, ev_timer_t **handle,
+                                 void *mem);
+
+/**
+ * @brief Destroy the timer
+ * @warning The timer structure cannot be freed until close_cb is called.
+ * @param[in] handle    Timer handle
+ * @param[in] cb        Close callback.
+ * @param[in] arg       User defined argument.
+ */
+EV_API void ev_timer_exit(ev_timer_t *handle, ev_timer_cb cb, void* arg);
+
+/**
+ * @brief Start the timer. timeout and repeat are in milliseconds.
+ *
+ * If timeout is zero, the callback fires on the next event loop iteration. If
+ * repeat is non-zero, the callback fires first after timeout milliseconds and
+ * then repeatedly after repeat milliseconds.
+ *
+ * @param[in] handle    Timer handle
+ * @param[in] timeout   The first callback timeout
+ * @param[in] repeat    Repeat timeout
+ * @param[in] cb        Active callback
+ * @param[in] arg       User defined argument.
+ * @return              #ev_errno_t
+ */
+EV_API int ev_timer_start(ev_timer_t *handle, uint64_t timeout,
+                          uint64_t repeat, ev_timer_cb cb, void* arg);
+
+/**
+ * @brief Stop the timer.
+ *
+ * the callback will not be called anymore.
+ *
+ * @param[in] handle    Timer handle
+ */
+EV_API void ev_timer_stop(ev_timer_t *handle);
+
+/**
+ * @brief Idle timeout manager type.
+ */
+typedef struct ev_idle_timer ev_idle_timer_t;
+
+/**
+ * @brief Typedef of #ev_idle_token.
+ */
+typedef struct ev_idle_token ev_idle_token_t;
+
+/**
+ * @brief Type definition for callback passed to #ev_idle_timer_add().
+ *
+ * \p token is already removed from the manager when called.
+ *
+ * @param[in] token     Expired token
+ * @param[in] arg       User defined argument.
+ */
+typedef void (*ev_idle_cb)(ev_idle_token_t *token, void *arg);
+
+/**
+ * @brief Idle timeout token, typically embedded in a connection.
+ */
+struct ev_idle_token
+{
+    ev_list_node_t   node;  /**< #ev_idle_timer::queue */
+    ev_idle_timer_t *owner; /**< Manager, NULL if not added */
+    uint64_t         last;  /**< Last active time */
+    ev_idle_cb       cb;    /**< Expire callback */
+    void            *arg;   /**< User defined argument. */
+};
+#define EV_IDLE_TOKEN_INIT                                                     \
+    {                                                                          \
+        EV_LIST_NODE_INIT, NULL, 0, NULL, NULL,                                \
+    }
+
+/**
+ * @brief Create an idle timeout manager.
+ *
+ * All tokens share the same \p timeout, so they are kept in a list ordered by
+ * last activity, and a single timer expires stale tokens in bulk. Compared to
+ * a #ev_timer_t per connection, #ev_idle_timer_touch() is a O(1) list move
+ * instead of a timer restart.
+ *
+ * @param[in] loop      A pointer to the event loop
+ * @param[out] handle   Idle timeout manager
+ * @param[in] timeout   Idle timeout in milliseconds, must not be zero.
+ * @return              #ev_errno_t
+ */
+EV_API int ev_idle_timer_init(ev_loop_t *loop, ev_idle_timer_t **handle,
+                              uint64_t timeout);
+
+/**
+ * @brief Destroy the manager.
+ *
+ * Tokens still in the manager are removed without callback. It is safe to
+ * call this function in #ev_idle_cb.
+ *
+ * @param[in] handle    Idle timeout manager
+ */
+EV_API void ev_idle_timer_exit(ev_idle_timer_t *handle);
+
+/**
+ * @brief Add \p token into manager.
+ *
+ * If \p token is already in a manager, it is moved into \p handle.
+ *
+ * @param[in] handle    Idle timeout manager
+ * @param[in] token     Idle token
+ * @param[in] cb        Expire callback
+ * @param[in] arg       User defined argument.
+ */
+EV_API void ev_idle_timer_add(ev_idle_timer_t *handle, ev_idle_token_t *token,
+                              ev_idle_cb cb, void *arg);
+
+/**
+ * @brief Mark \p token as active now.
+ *
+ * Does nothing if \p token is not in a manager.
+ *
+ * @param[in] token     Idle token
+ */
+EV_API void ev_idle_timer_touch(ev_idle_token_t *token);
+
+/**
+ * @brief Remove \p token from its manager.
+ *
+ * Does nothing if \p token is not in a manager.
+ *
+ * @param[in] token     Idle token
+ */
+EV_API void ev_idle_timer_remove(ev_idle_token_t *token);
+
+/**
+ * @} EV_TIMER
+ */
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -1,261 +1,598 @@
-#ifndef __EV_UDP_H__
-#define __EV_UDP_H__
-#ifdef __cplusplus
-extern "C" {
-#endif
-
-/**
- * @defgroup EV_UDP UDP
- * @{
- */
-
-/**
- * @brief Multicast operation.
- */
-typedef enum ev_udp_membership
-{
-    EV_UDP_LEAVE_GROUP = 0, /**< Leave multicast group */
-    EV_UDP_ENTER_GROUP = 1, /**< Join multicast group */
-} ev_udp_membership_t;
-
-/**
- * @brief UDP socket flags.
- */
-typedef enum ev_udp_flags
-{
-    /**
-     * @brief Do not bound to IPv4 address.
-     */
-    EV_UDP_IPV6_ONLY = 1,
-
-    /**
-     * @brief Reuse address. Only the last one can receive message.
-     */
-    EV_UDP_REUSEADDR = 2,
-} ev_udp_flags_t;
-
-/**
- * @brief UDP socket type.
- */
-typedef struct ev_udp ev_udp_t;
-
-/**
- * @brief Callback for #ev_udp_t
- * @param[in] udp   UDP handle
- * @param[in] arg   User defined argument.
- */
-typedef void (*ev_udp_cb)(ev_udp_t *udp, void *arg);
-
-/**
- * @brief Write callback
- * @param[in] udp       UDP socket.
- * @param[in] size      Write result.
- * @param[in] arg       User defined argument.
- */
-typedef void (*ev_udp_write_cb)(ev_udp_t *udp, ssize_t size, void *arg);
-
-/**
- * @brief Read callback
- * @param[in] udp       UDP socket.
- * @param[in] addr      Peer address.
- * @param[in] size      Read result.
- * @param[in] arg       User defined argument.
- */
-typedef void (*ev_udp_recv_cb)(ev_udp_t *udp, const struct sockaddr *addr,
-                               ssize_t size, void *arg);
-
-/**
- * @brief Initialize a UDP handle.
- * @param[in] loop      Event loop
- * @param[out] udp      A UDP handle to initialize
- * @param[in] domain    AF_INET / AF_INET6 / AF_UNSPEC
- * @return              #ev_errno_t
- */
-EV_API int ev_udp_init(ev_loop_t *loop, ev_udp_t **udp, int domain);
-
-/**
- * @brief Close UDP handle
- * @param[in] udp       A UDP handle
- * @param[in] close_cb  Close callback
- * @param[in] close_arg User defined argument.
- */
-EV_API void ev_udp_exit(ev_udp_t *udp, ev_udp_cb close_cb, void *close_arg);
-
-/**
- * @brief Open a existing UDP socket
- * @note \p udp must be a initialized handle
- * @param[in] udp       A initialized UDP handle
- * @param[in] sock      A system UDP socket
- * @return              #ev_errno_t
- */
-EV_API int ev_udp_open(ev_udp_t *udp, ev_os_socket_t sock);
-
-/**
- * @brief Bind the UDP handle to an IP address and port.
- * @param[in] udp       A UDP handle
- * @param[in] addr      struct sockaddr_in or struct sockaddr_in6 with the
- *   address and port to bind to.
- * @param[in] flags     #ev_udp_flags_t
- * @return              #ev_errno_t
- */
-EV_API int ev_udp_bind(ev_udp_t *udp, const struct sockaddr *addr,
-                       unsigned flags);
-
-/**
- * @brief Associate the UDP handle to a remote address and port, so every
- * message sent by this handle is automatically sent to that destination.
- * @param[in] udp       A UDP handle
- * @param[in] addr      Remote address
- * @return              #ev_errno_t
- */
-EV_API int ev_udp_connect(ev_udp_t *udp, const struct sockaddr *addr);
-
-/**
- * @brief Get the local IP and port of the UDP handle.
- * @param[in] udp       A UDP handle
- * @param[out] name     Pointer to the structure to be filled with the address
- * data. In order to support IPv4 and IPv6 struct sockaddr_storage should be
- * used.
- * @param[in,out] len   On input it indicates the data of the name field.
- *   On output it indicates how much of it was filled.
- * @return              #ev_errno_t
- */
-EV_API int ev_udp_getsockname(ev_udp_t *udp, struct sockaddr *name,
-                              size_t *len);
-
-/**
- * @brief Get the remote IP and port of the UDP handle on connected UDP handles.
- * @param[in] udp       A UDP handle
- * @param[out] name     Pointer to the structure to be filled with the address
- * data. In order to support IPv4 and IPv6 struct sockaddr_storage should be
- * used.
- * @param[in,out] len   On input it indicates the data of the name field.
- *   On output it indicates how much of it was filled.
- * @return              #ev_errno_t
- */
-EV_API int ev_udp_getpeername(ev_udp_t *udp, struct sockaddr *name,
-                              size_t *len);
-
-/**
- * @brief Set membership for a multicast address.
- * @param[in] udp               A UDP handle
- * @param[in] multicast_addr    Multicast address to set membership for.
- * @param[in] interface_addr    Interface address.
- * @param[in] membership        #ev_udp_membership_t
- * @return                      #ev_errno_t
- */
-EV_API int ev_udp_set_membership(ev_udp_t *udp, const char *multicast_addr,
-                                 const char         *interface_addr,
-                                 ev_udp_membership_t membership);
-
-/**
- * @brief Set membership for a source-specific multicast group.
- * @param[in] udp               A UDP handle
- * @param[in] multicast_addr    Multicast address to set membership for.
- * @param[in] interface_addr    Interface address.
- * @param[in] source_addr       Source address.
- * @param[in] membership        #ev_udp_membership_t
- * @return                      #ev_errno_t
- */
-EV_API int ev_udp_set_source_membership(ev_udp_t           *udp,
-                                        const char         *multicast_addr,
-                                        const char         *interface_addr,
-                                        const char         *source_addr,
-                                        ev_udp_membership_t membership);
-
-/**
- * @brief Set IP multicast loop flag. Makes multicast packets loop back to local
- * sockets.
- * @param[in] udp   A UDP handle
- * @param[in] on    bool
- * @return          #ev_errno_t
- */
-EV_API int ev_udp_set_multicast_loop(ev_udp_t *udp, int on);
-
-/**
- * @brief Set the multicast ttl.
- * @param[in] udp   A UDP handle
- * @param[in] ttl   1 through 255
- * @return          #ev_errno_t
- */
-EV_API int ev_udp_set_multicast_ttl(ev_udp_t *udp, int ttl);
-
-/**
- * @brief Set the multicast interface to send or receive data on.
- * @param[in] udp               A UDP handle
- * @param[in] interface_addr    interface address.
- * @return                      #ev_errno_t
- */
-EV_API int ev_udp_set_multicast_interface(ev_udp_t   *udp,
-                                          const char *interface_addr);
-
-/**
- * @brief Set broadcast on or off.
- * @param[in] udp   A UDP handle
- * @param[in] on    1 for on, 0 for off
- * @return          #ev_errno_t
- */
-EV_API int ev_udp_set_broadcast(ev_udp_t *udp, int on);
-
-/**
- * @brief Set the time to live.
- * @param[in] udp   A UDP handle
- * @param[in] ttl   1 through 255.
- * @return          #ev_errno_t
- */
-EV_API int ev_udp_set_ttl(ev_udp_t *udp, int ttl);
-
-/**
- * @brief Send data over the UDP socket.
- *
- * If the socket has not previously been bound with #ev_udp_bind() it will be
- * bound to 0.0.0.0 (the "all interfaces" IPv4 address) and a random port
- * number.
- *
- * @param[in] udp   A UDP handle
- * @param[in] bufs  Buffer list
- * @param[in] nbuf  Buffer number
- * @param[in] addr  Peer address
- * @param[in] cb    Send result callback
- * @param[in] arg   User defined argument.
- * @return          #ev_errno_t
- */
-EV_API int ev_udp_send(ev_udp_t *udp, ev_buf_t *bufs, size_t nbuf,
-                       const struct sockaddr *addr, ev_udp_write_cb cb,
-                       void *arg);
-
-/**
- * @brief Same as #ev_udp_send(), but won't queue a send request if it can't be
- *   completed immediately.
- * @param[in] udp   A UDP handle
- * @param[in] bufs  Buffer list
- * @param[in] nbuf  Buffer number
- * @param[in] addr  Peer address
- * @param[in] cb    Send result callback
- * @param[in] arg   User defined argument.
- * @return          #ev_errno_t
- */
-EV_API int ev_udp_try_send(ev_udp_t *udp, ev_buf_t *bufs, size_t nbuf,
-                           const struct sockaddr *addr, ev_udp_write_cb cb,
-                           void *arg);
-
-/**
- * @brief Queue a read request.
- * @param[in] udp   A UDP handle
- * @param[in] bufs  Receive buffer
- * @param[in] nbuf  Buffer number
- * @param[in] cb    Receive callback
- * @param[in] arg   User defined argument.
- * @return          #ev_errno_t
- */
-EV_API int ev_udp_recv(ev_udp_t *udp, ev_buf_t *bufs, size_t nbuf,
-                       ev_udp_recv_cb cb, void *arg);
-
-/**
- * @} EV_UDP
- */
-
-#ifdef __cplusplus
-}
-#endif
-#endif
+#ifndef __EV_UDP_H__
+#define __EV_UDP_H__
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @defgroup EV_UDP UDP
+ * @{
+ */
+
+/**
+ * @brief Multicast operation.
+ */
+typedef enum ev_udp_membership
+{
+    EV_UDP_LEAVE_GROUP = 0, /**< Leave multicast group */
+    EV_UDP_ENTER_GROUP = 1, /**< Join multicast group */
+} ev_udp_membership_t;
+
+/**
+ * @brief UDP socket flags.
+ */
+typedef enum ev_udp_flags
+{
+    /**
+     * @brief Do not bound to IPv4 address.
+     */
+    EV_UDP_IPV6_ONLY = 1,
+
+    /**
+     * @brief Reuse address. Only the last one can receive message.
+     */
+    EV_UDP_REUSEADDR = 2,
+
+    /**
+     * @brief SO_REUSEPORT. Datagrams are distributed among all sockets bound
+     *   to the same address, so each event loop can own one of them.
+     */
+    EV_UDP_REUSEPORT = 4,
+} ev_udp_flags_t;
+
+/**
+ * @brief UDP socket options.
+ * @see ev_udp_setopt()
+ */
+typedef enum ev_udp_opt
+{
+    /**
+     * @brief SO_SNDBUF. Send buffer size in bytes.
+     */
+    EV_UDP_OPT_SNDBUF = 0,
+
+    /**
+     * @brief SO_RCVBUF. Receive buffer size in bytes.
+     */
+    EV_UDP_OPT_RCVBUF = 1,
+
+    /**
+     * @brief SO_SNDBUFFORCE. Same as #EV_UDP_OPT_SNDBUF but ignores the
+     *   system limit. Requires CAP_NET_ADMIN.
+     */
+    EV_UDP_OPT_SNDBUFFORCE = 2,
+
+    /**
+     * @brief SO_RCVBUFFORCE. Same as #EV_UDP_OPT_RCVBUF but ignores the
+     *   system limit. Requires CAP_NET_ADMIN.
+     */
+    EV_UDP_OPT_RCVBUFFORCE = 3,
+
+    /**
+     * @brief IP_TOS / IPV6_TCLASS. Traffic class byte, DSCP is the upper six
+     *   bits (e.g. `46 << 2` for Expedited Forwarding).
+     */
+    EV_UDP_OPT_TOS = 4,
+} ev_udp_opt_t;
+
+/**
+ * @brief Ancillary data of received datagrams.
+ */
+typedef enum ev_udp_recv_info_flags
+{
+    /**
+     * @brief Destination address and interface. IP_PKTINFO / IPV6_RECVPKTINFO.
+     */
+    EV_UDP_RECV_PKTINFO = 0x01,
+
+    /**
+     * @brief Kernel receive timestamp. SO_TIMESTAMPNS.
+     */
+    EV_UDP_RECV_TIMESTAMP = 0x02,
+
+    /**
+     * @brief Counter of datagrams dropped by socket. SO_RXQ_OVFL.
+     */
+    EV_UDP_RECV_DROPS = 0x04,
+} ev_udp_recv_info_flags_t;
+
+/**
+ * @brief Ancillary data of a received datagram.
+ * @see ev_udp_set_recv_info()
+ */
+typedef struct ev_udp_recv_info
+{
+    unsigned flags; /**< Valid fields. #ev_udp_recv_info_flags_t */
+
+    struct sockaddr_storage dst_addr;  /**< Destination address, port is 0. */
+    unsigned                ifindex;   /**< Receiving interface index. */
+    uint64_t                timestamp; /**< Receive time in nanoseconds since
+                                            Unix epoch. */
+    uint32_t                drops;     /**< Datagrams dropped since socket was
+                                            created. */
+} ev_udp_recv_info_t;
+
+/**
+ * @brief UDP socket type.
+ */
+typedef struct ev_udp ev_udp_t;
+
+/**
+ * @brief Callback for #ev_udp_t
+ * @param[in] udp   UDP handle
+ * @param[in] arg   User defined argument.
+ */
+typedef void (*ev_udp_cb)(ev_udp_t *udp, void *arg);
+
+/**
+ * @brief Write callback
+ * @param[in] udp       UDP socket.
+ * @param[in] size      Write result.
+ * @param[in] arg       User defined argument.
+ */
+typedef void (*ev_udp_write_cb)(ev_udp_t *udp, ssize_t size, void *arg);
+
+/**
+ * @brief Read callback
+ * @param[in] udp       UDP socket.
+ * @param[in] addr      Peer address.
+ * @param[in] size      Read result.
+ * @param[in] arg       User defined argument.
+ */
+typedef void (*ev_udp_recv_cb)(ev_udp_t *udp, const struct sockaddr *addr,
+                               ssize_t size, void *arg);
+
+/**
+ * @brief Datagram for #ev_udp_recv_batch_start(), #ev_udp_recv_start() and
+ *   #ev_udp_send_batch().
+ */
+typedef struct ev_udp_datagram
+{
+    const struct sockaddr    *addr;     /**< Peer address. */
+    void                     *data;     /**< Payload. */
+    size_t                    size;     /**< Payload size. */
+    size_t                    seg_size; /**< Segment size if \p data carries
+                                             several datagrams, 0 otherwise. */
+    const ev_udp_recv_info_t *info;     /**< Ancillary data on receive if
+                                             enabled by #ev_udp_set_recv_info(),
+                                             NULL otherwise. */
+} ev_udp_datagram_t;
+
+/**
+ * @brief Batch read callback
+ * @param[in] udp       UDP socket.
+ * @param[in] msgs      Received datagrams. Memory is owned by \p udp and only
+ *                      valid inside the callback.
+ * @param[in] nmsg      Number of datagrams.
+ * @param[in] stat      #ev_errno_t. If non-zero, \p nmsg is zero and batch
+ *                      receive is stopped.
+ * @param[in] arg       User defined argument.
+ */
+typedef void (*ev_udp_recv_batch_cb)(ev_udp_t *udp, ev_udp_datagram_t *msgs,
+                                     size_t nmsg, int stat, void *arg);
+
+/**
+ * @brief Continuous read callback
+ * @param[in] udp       UDP socket.
+ * @param[in] msg       Received datagram. The buffer is borrowed from \p udp
+ *                      and must be returned by #ev_udp_recv_release().
+ * @param[in] stat      #ev_errno_t. If non-zero, \p msg is NULL and continuous
+ *                      receive is stopped. Borrowed buffers stay valid until
+ *                      returned or until \p udp is closed.
+ * @param[in] arg       User defined argument.
+ */
+typedef void (*ev_udp_recv_ring_cb)(ev_udp_t *udp, ev_udp_datagram_t *msg,
+                                    int stat, void *arg);
+
+/**
+ * @brief Initialize a UDP handle.
+ * @param[in] loop      Event loop
+ * @param[out] udp      A UDP handle to initialize
+ * @param[in] domain    AF_INET / AF_INET6 / AF_UNSPEC
+ * @return              #ev_errno_t
+ */
+EV_API int ev_udp_init(ev_loop_t *loop, ev_udp_t **udp, int domain);
+
+/**
+ * @brief Get the size of #ev_udp_t.
+ * @return              Size in bytes.
+ */
+EV_API size_t ev_udp_size(void);
+
+/**
+ * @brief Initialize a UDP handle in caller-owned memory.
+ *
+ * Same as #ev_udp_init(), but the handle is constructed inside \p mem instead
+ * of allocating from heap. \p mem must be at least #ev_udp_size() bytes,
+ * aligned as memory returned by malloc(3), and stay valid until the close
+ * callback is called.
+ *
+ * @param[in] loop      Event loop
+ * @param[out] udp      A UDP handle to initialize
+ * @param[in] domain    AF_INET / AF_INET6 / AF_UNSPEC
+ * @param[in] mem       Memory to construct the handle in.
+ * @return              #ev_errno_t
+ */
+EV_API int ev_udp_init_inplace(ev_loop_t *loop, ev_udp_t **udp, int domain,
+                               void *mem);
+
+/**
+ * @brief Close UDP handle
+ * @param[in] udp       A UDP handle
+ * @param[in] close_cb  Close callback
+ * @param[in] close_arg User defined argument.
+ */
+EV_API void ev_udp_exit(ev_udp_t *udp, ev_udp_cb close_cb, void *close_arg);
+
+/**
+ * @brief Open a existing UDP socket
+ * @note \p udp must be a initialized handle
+ * @param[in] udp       A initialized UDP handle
+ * @param[in] sock      A system UDP socket
+ * @return              #ev_errno_t
+ */
+EV_API int ev_udp_open(ev_udp_t *udp, ev_os_socket_t sock);
+
+/**
+ * @brief Bind the UDP handle to an IP address and port.
+ * @param[in] udp       A UDP handle
+ * @param[in] addr      struct sockaddr_in or struct sockaddr_in6 with the
+ *   address and port to bind to.
+ * @param[in] flags     #ev_udp_flags_t
+ * @return              #ev_errno_t
+ */
+EV_API int ev_udp_bind(ev_udp_t *udp, const struct sockaddr *addr,
+                       unsigned flags);
+
+/**
+ * @brief Associate the UDP handle to a remote address and port, so every
+ * message sent by this handle is automatically sent to that destination.
+ * @param[in] udp       A UDP handle
+ * @param[in] addr      Remote address
+ * @return              #ev_errno_t
+ */
+EV_API int ev_udp_connect(ev_udp_t *udp, const struct sockaddr *addr);
+
+/**
+ * @brief Get the local IP and port of the UDP handle.
+ * @param[in] udp       A UDP handle
+ * @param[out] name     Pointer to the structure to be filled with the address
+ * data. In order to support IPv4 and IPv6 struct sockaddr_storage should be
+ * used.
+ * @param[in,out] len   On input it indicates the data of the name field.
+ *   On output it indicates how much of it was filled.
+ * @return              #ev_errno_t
+ */
+EV_API int ev_udp_getsockname(ev_udp_t *udp, struct sockaddr *name,
+                              size_t *len);
+
+/**
+ * @brief Get the remote IP and port of the UDP handle on connected UDP handles.
+ * @param[in] udp       A UDP handle
+ * @param[out] name     Pointer to the structure to be filled with the address
+ * data. In order to support IPv4 and IPv6 struct sockaddr_storage should be
+ * used.
+ * @param[in,out] len   On input it indicates the data of the name field.
+ *   On output it indicates how much of it was filled.
+ * @return              #ev_errno_t
+ */
+EV_API int ev_udp_getpeername(ev_udp_t *udp, struct sockaddr *name,
+                              size_t *len);
+
+/**
+ * @brief Set membership for a multicast address.
+ * @param[in] udp               A UDP handle
+ * @param[in] multicast_addr    Multicast address to set membership for.
+ * @param[in] interface_addr    Interface address.
+ * @param[in] membership        #ev_udp_membership_t
+ * @return                      #ev_errno_t
+ */
+EV_API int ev_udp_set_membership(ev_udp_t *udp, const char *multicast_addr,
+                                 const char         *interface_addr,
+                                 ev_udp_membership_t membership);
+
+/**
+ * @brief Set membership for a source-specific multicast group.
+ * @param[in] udp               A UDP handle
+ * @param[in] multicast_addr    Multicast address to set membership for.
+ * @param[in] interface_addr    Interface address.
+ * @param[in] source_addr       Source address.
+ * @param[in] membership        #ev_udp_membership_t
+ * @return                      #ev_errno_t
+ */
+EV_API int ev_udp_set_source_membership(ev_udp_t           *udp,
+                                        const char         *multicast_addr,
+                                        const char         *interface_addr,
+                                        const char         *source_addr,
+                                        ev_udp_membership_t membership);
+
+/**
+ * @brief Set IP multicast loop flag. Makes multicast packets loop back to local
+ * sockets.
+ * @param[in] udp   A UDP handle
+ * @param[in] on    bool
+ * @return          #ev_errno_t
+ */
+EV_API int ev_udp_set_multicast_loop(ev_udp_t *udp, int on);
+
+/**
+ * @brief Set the multicast ttl.
+ * @param[in] udp   A UDP handle
+ * @param[in] ttl   1 through 255
+ * @return          #ev_errno_t
+ */
+EV_API int ev_udp_set_multicast_ttl(ev_udp_t *udp, int ttl);
+
+/**
+ * @brief Set the multicast interface to send or receive data on.
+ * @param[in] udp               A UDP handle
+ * @param[in] interface_addr    interface address.
+ * @return                      #ev_errno_t
+ */
+EV_API int ev_udp_set_multicast_interface(ev_udp_t   *udp,
+                                          const char *interface_addr);
+
+/**
+ * @brief Set broadcast on or off.
+ * @param[in] udp   A UDP handle
+ * @param[in] on    1 for on, 0 for off
+ * @return          #ev_errno_t
+ */
+EV_API int ev_udp_set_broadcast(ev_udp_t *udp, int on);
+
+/**
+ * @brief Set the time to live.
+ * @param[in] udp   A UDP handle
+ * @param[in] ttl   1 through 255.
+ * @return          #ev_errno_t
+ */
+EV_API int ev_udp_set_ttl(ev_udp_t *udp, int ttl);
+
+/**
+ * @brief Send data over the UDP socket.
+ *
+ * If the socket has not previously been bound with #ev_udp_bind() it will be
+ * bound to 0.0.0.0 (the "all interfaces" IPv4 address) and a random port
+ * number.
+ *
+ * @param[in] udp   A UDP handle
+ * @param[in] bufs  Buffer list
+ * @param[in] nbuf  Buffer number
+ * @param[in] addr  Peer address
+ * @param[in] cb    Send result callback
+ * @param[in] arg   User defined argument.
+ * @return          #ev_errno_t
+ */
+EV_API int ev_udp_send(ev_udp_t *udp, ev_buf_t *bufs, size_t nbuf,
+                       const struct sockaddr *addr, ev_udp_write_cb cb,
+                       void *arg);
+
+/**
+ * @brief Same as #ev_udp_send(), but won't queue a send request if it can't be
+ *   completed immediately.
+ * @param[in] udp   A UDP handle
+ * @param[in] bufs  Buffer list
+ * @param[in] nbuf  Buffer number
+ * @param[in] addr  Peer address
+ * @param[in] cb    Send result callback
+ * @param[in] arg   User defined argument.
+ * @return          #ev_errno_t
+ */
+EV_API int ev_udp_try_send(ev_udp_t *udp, ev_buf_t *bufs, size_t nbuf,
+                           const struct sockaddr *addr, ev_udp_write_cb cb,
+                           void *arg);
+
+/**
+ * @brief Send \p data as a train of \p seg_size datagrams.
+ *
+ * The kernel splits the payload by UDP_SEGMENT (GSO) so that one system call
+ * emits up to 64 datagrams. The last datagram may be shorter. If segmentation
+ * offload is not available, datagrams are sent one by one. Either way \p cb is
+ * called once when the whole payload is sent.
+ *
+ * @param[in] udp       A UDP handle
+ * @param[in] data      Payload. Must stay valid until \p cb is called.
+ * @param[in] size      Payload size.
+ * @param[in] seg_size  Size of each datagram.
+ * @param[in] addr      Peer address
+ * @param[in] cb        Send result callback
+ * @param[in] arg       User defined argument.
+ * @return              #ev_errno_t
+ */
+EV_API int ev_udp_send_gso(ev_udp_t *udp, void *data, size_t size,
+                           size_t seg_size, const struct sockaddr *addr,
+                           ev_udp_write_cb cb, void *arg);
+
+/**
+ * @brief Queue a list of datagrams.
+ *
+ * Each datagram is an independent send request and \p cb is called once for
+ * every datagram with its own result. Queued datagrams are flushed together by
+ * sendmmsg(2) where available. A datagram with non-zero
+ * #ev_udp_datagram_t::seg_size is sent as #ev_udp_send_gso() does.
+ *
+ * @param[in] udp   A UDP handle
+ * @param[in] msgs  Datagrams. Payload must stay valid until \p cb is called.
+ * @param[in] nmsg  Number of datagrams.
+ * @param[in] cb    Send result callback
+ * @param[in] arg   User defined argument.
+ * @return          Number of datagrams queued. If nothing is queued, return
+ *                  #ev_errno_t.
+ */
+EV_API ssize_t ev_udp_send_batch(ev_udp_t *udp, const ev_udp_datagram_t *msgs,
+                                 size_t nmsg, ev_udp_write_cb cb, void *arg);
+
+/**
+ * @brief Queue a read request.
+ * @param[in] udp   A UDP handle
+ * @param[in] bufs  Receive buffer
+ * @param[in] nbuf  Buffer number
+ * @param[in] cb    Receive callback
+ * @param[in] arg   User defined argument.
+ * @return          #ev_errno_t
+ */
+EV_API int ev_udp_recv(ev_udp_t *udp, ev_buf_t *bufs, size_t nbuf,
+                       ev_udp_recv_cb cb, void *arg);
+
+/**
+ * @brief Keep receiving datagrams in batches.
+ *
+ * Up to \p batch datagrams are read by one recvmmsg(2) call into buffers owned
+ * by \p udp, and delivered together in one callback. Datagrams larger than
+ * \p msg_size are truncated. While batch receive is running, #ev_udp_recv()
+ * and #ev_udp_recv_start() return #EV_EBUSY.
+ *
+ * @param[in] udp       A UDP handle
+ * @param[in] batch     Max datagrams per callback.
+ * @param[in] msg_size  Buffer size for each datagram.
+ * @param[in] cb        Batch read callback
+ * @param[in] arg       User defined argument.
+ * @return              #ev_errno_t
+ */
+EV_API int ev_udp_recv_batch_start(ev_udp_t *udp, size_t batch,
+                                   size_t msg_size, ev_udp_recv_batch_cb cb,
+                                   void *arg);
+
+/**
+ * @brief Stop batch receive.
+ *
+ * It is safe to call this function in #ev_udp_recv_batch_cb.
+ *
+ * @param[in] udp       A UDP handle
+ * @return              #ev_errno_t
+ */
+EV_API int ev_udp_recv_batch_stop(ev_udp_t *udp);
+
+/**
+ * @brief Keep receiving datagrams into a ring of preallocated buffers.
+ *
+ * \p nbuf buffers of \p buf_size bytes are allocated once. Each datagram is
+ * delivered in a buffer the user borrows until #ev_udp_recv_release() is
+ * called, so no allocation happens per datagram. When every buffer is
+ * borrowed, reading pauses until one is returned. While continuous receive is
+ * running, #ev_udp_recv() and #ev_udp_recv_batch_start() return #EV_EBUSY.
+ *
+ * @param[in] udp       A UDP handle
+ * @param[in] nbuf      Number of buffers.
+ * @param[in] buf_size  Size of each buffer. Larger datagrams are truncated.
+ * @param[in] cb        Continuous read callback
+ * @param[in] arg       User defined argument.
+ * @return              #ev_errno_t
+ */
+EV_API int ev_udp_recv_start(ev_udp_t *udp, size_t nbuf, size_t buf_size,
+                             ev_udp_recv_ring_cb cb, void *arg);
+
+/**
+ * @brief Stop continuous receive.
+ *
+ * It is safe to call this function in #ev_udp_recv_ring_cb. Borrowed buffers
+ * stay valid until returned or until \p udp is closed.
+ *
+ * @param[in] udp       A UDP handle
+ * @return              #ev_errno_t
+ */
+EV_API int ev_udp_recv_stop(ev_udp_t *udp);
+
+/**
+ * @brief Return a buffer borrowed by #ev_udp_recv_ring_cb.
+ * @param[in] udp       A UDP handle
+ * @param[in] msg       The datagram passed to #ev_udp_recv_ring_cb.
+ */
+EV_API void ev_udp_recv_release(ev_udp_t *udp, ev_udp_datagram_t *msg);
+
+/**
+ * @brief Enable ancillary data of received datagrams.
+ *
+ * Enabled fields are reported by #ev_udp_datagram_t::info on batch and
+ * continuous receive, and by #ev_udp_recv_info() in #ev_udp_recv_cb.
+ *
+ * If any of \p flags cannot be applied, previous flags stay in effect.
+ *
+ * @param[in] udp   A UDP handle
+ * @param[in] flags #ev_udp_recv_info_flags_t. 0 to disable.
+ * @return          #ev_errno_t
+ */
+EV_API int ev_udp_set_recv_info(ev_udp_t *udp, unsigned flags);
+
+/**
+ * @brief Get ancillary data of the datagram passed to #ev_udp_recv_cb.
+ * @param[in] udp   A UDP handle
+ * @return          Only valid in #ev_udp_recv_cb. NULL if not enabled.
+ */
+EV_API const ev_udp_recv_info_t *ev_udp_recv_info(ev_udp_t *udp);
+
+/**
+ * @brief Set socket option.
+ * @param[in] udp       A UDP handle
+ * @param[in] opt       Option
+ * @param[in] val       Option value
+ * @return              #ev_errno_t. #EV_ENOSYS if \p opt is not supported on
+ *                      this platform.
+ */
+EV_API int ev_udp_setopt(ev_udp_t *udp, ev_udp_opt_t opt, int val);
+
+/**
+ * @brief Get socket option.
+ *
+ * The value is read from the socket, so it might be different from what is set
+ * (e.g. Linux doubles #EV_UDP_OPT_RCVBUF).
+ *
+ * @param[in] udp       A UDP handle
+ * @param[in] opt       Option
+ * @param[out] val      Option value
+ * @return              #ev_errno_t
+ */
+EV_API int ev_udp_getopt(ev_udp_t *udp, ev_udp_opt_t opt, int *val);
+
+/**
+ * @brief Attach a classic BPF program that picks the receiving socket of a
+ *   #EV_UDP_REUSEPORT group.
+ *
+ * The program returns the index of the socket in the group, in the order they
+ * were bound. Out of range results fall back to the default hash. Attaching to
+ * any socket in the group affects the whole group.
+ *
+ * @param[in] udp       A UDP handle bound with #EV_UDP_REUSEPORT.
+ * @param[in] insns     Array of `struct sock_filter`.
+ * @param[in] ninsn     Number of instructions.
+ * @return              #ev_errno_t
+ */
+EV_API int ev_udp_set_reuseport_cbpf(ev_udp_t *udp, const void *insns,
+                                     size_t ninsn);
+
+/**
+ * @brief Steer datagrams of a #EV_UDP_REUSEPORT group by receiving CPU.
+ *
+ * A datagram handled by CPU `n` is delivered to socket `n % group_size`. Pin
+ * each event loop thread to the matching CPU to keep a flow on one core.
+ *
+ * @param[in] udp           A UDP handle bound with #EV_UDP_REUSEPORT.
+ * @param[in] group_size    Number of sockets in the group.
+ * @return                  #ev_errno_t
+ */
+EV_API int ev_udp_set_reuseport_cpu(ev_udp_t *udp, unsigned group_size);
+
+/**
+ * @brief Let kernel coalesce received datagrams by UDP_GRO.
+ *
+ * Coalesced datagrams are delivered by #ev_udp_recv_batch_start() and
+ * #ev_udp_recv_start() as one #ev_udp_datagram_t with
+ * #ev_udp_datagram_t::seg_size set, so the buffer should be large enough,
+ * e.g. 65535 bytes. Do not enable it when
+ * receiving by #ev_udp_recv(), which cannot report segment boundaries.
+ *
+ * @param[in] udp   A UDP handle
+ * @param[in] on    Bool
+ * @return          #ev_errno_t. #EV_ENOSYS if not supported, datagrams are
+ *                  then delivered one by one.
+ */
+EV_API int ev_udp_set_gro(ev_udp_t *udp, int on);
+
+/**
+ * @} EV_UDP
+ */
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -4,15 +4,19 @@
 #include "ev.h" /* @AMALGAMATE: SKIP */
 
 #include "ev/defs.h"
+#include "ev/allocator_internal.h"
 #include "ev/assert_internal.h"
 #include "ev/async_internal.h"
 #include "ev/atomic_internal.h"
+#include "ev/dns_internal.h"
 #include "ev/handle_internal.h"
 #include "ev/loop_internal.h"
 #include "ev/fs_internal.h"
 #include "ev/misc_internal.h"
 #include "ev/pipe_internal.h"
 #include "ev/ringbuffer.h"
+#include "ev/shm_channel_internal.h"
+#include "ev/tcp_internal.h"
 #include "ev/threadpool.h"
 #include "ev/timer_internal.h"
 #include "ev/log.h"
@@ -44,6 +48,7 @@
 #   include "ev/win/process_win.c"
 #   include "ev/win/sem_win.c"
 #   include "ev/win/shdlib_win.c"
+#   include "ev/win/shm_channel_win.c"
 #   include "ev/win/shmem_win.c"
 #   include "ev/win/tcp_win.c"
 #   include "ev/win/thread_win.c"
@@ -57,9 +62,11 @@
 
 #   include "ev/unix/async_unix.h"
 #   include "ev/unix/io_unix.h"
+#   include "ev/unix/pipe_unix.h"
 #   include "ev/unix/process_unix.h"
 #   include "ev/unix/tcp_unix.h"
 #   include "ev/unix/loop_unix.h"
+#   include "ev/unix/shm_channel_unix.h"
 #   include "ev/unix/shmem_unix.h"
 #   include "ev/unix/stream_unix.h"
 #   include "ev/unix/work.h"
@@ -76,6 +83,7 @@
 #   include "ev/unix/process_unix.c"
 #   include "ev/unix/sem_unix.c"
 #   include "ev/unix/shdlib_unix.c"
+#   include "ev/unix/shm_channel_unix.c"
 #   include "ev/unix/shmem_unix.c"
 #   include "ev/unix/stream_unix.c"
 #   include "ev/unix/tcp_unix.c"
@@ -89,6 +97,7 @@
 #include "ev/assert.c"
 #include "ev/allocator.c"
 #include "ev/atomic.c"
+#include "ev/dns.c"
 #include "ev/errno.c"
 #include "ev/fs.c"
 #include "ev/handle.c"
@@ -101,6 +110,8 @@
 #include "ev/queue.c"
 #include "ev/ringbuffer.c"
 #include "ev/shmem.c"
+#include "ev/tcp.c"
+#include "ev/tcp_pool.c"
 #include "ev/threadpool.c"
 #include "ev/timer.c"
 #include "ev/udp.c"
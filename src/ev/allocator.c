@@ -1,6 +1,38 @@
 #include <stdlib.h>
 #include <string.h>
 
+#if defined(EV_ALLOCATOR_STAT)
+
+/**
+ * @brief Header in front of every chunk when statistics is enabled.
+ */
+typedef union ev_allocator_hdr
+{
+    struct
+    {
+        size_t              size; /**< User visible size */
+        ev_allocator_type_t type; /**< Memory category */
+    } data;
+
+    /* Keep user memory suitably aligned for any type. */
+    long double align_ld;
+    void       *align_ptr;
+    uint64_t    align_u64;
+} ev_allocator_hdr_t;
+
+typedef struct ev_allocator_counter
+{
+    ev_atomic64_t live_bytes;
+    ev_atomic64_t peak_bytes;
+    ev_atomic64_t alloc_count;
+    ev_atomic64_t realloc_count;
+    ev_atomic64_t free_count;
+} ev_allocator_counter_t;
+
+static ev_allocator_counter_t s_allocator_counter[EV_ALLOCATOR_TYPE_MAX];
+
+#endif
+
 static void *_ev_realloc(void *ptr, size_t size)
 {
     return realloc(ptr, size);
@@ -8,6 +40,101 @@ static void *_ev_realloc(void *ptr, size_t size)
 
 static ev_realloc_fn s_allocator = _ev_realloc;
 
+static void *_ev_allocator_raw(ev_loop_t *loop, void *ptr, size_t size)
+{
+    if (loop != NULL && loop->allocator.fn != NULL)
+    {
+        return loop->allocator.fn(ptr, size, loop->allocator.arg);
+    }
+    return s_allocator(ptr, size);
+}
+
+#if defined(EV_ALLOCATOR_STAT)
+
+static void _ev_allocator_stat_update(ev_allocator_type_t type, size_t old_size,
+                                      size_t new_size)
+{
+    ev_allocator_counter_t *counter = &s_allocator_counter[type];
+
+    int64_t live = ev_atomic64_fetch_add(&counter->live_bytes,
+                                         (int64_t)new_size - (int64_t)old_size);
+    live += (int64_t)new_size - (int64_t)old_size;
+
+    int64_t peak = ev_atomic64_load(&counter->peak_bytes);
+    while (live > peak)
+    {
+        if (ev_atomic64_compare_exchange_strong(&counter->peak_bytes, &peak,
+                                                live))
+        {
+            break;
+        }
+    }
+
+    if (old_size == 0)
+    {
+        ev_atomic64_fetch_add(&counter->alloc_count, 1);
+    }
+    else if (new_size == 0)
+    {
+        ev_atomic64_fetch_add(&counter->free_count, 1);
+    }
+    else
+    {
+        ev_atomic64_fetch_add(&counter->realloc_count, 1);
+    }
+}
+
+static void *_ev_allocator_realloc(ev_loop_t *loop, ev_allocator_type_t type,
+                                   void *ptr, size_t size)
+{
+    ev_allocator_hdr_t *hdr = NULL;
+    size_t              old_size = 0;
+
+    if (ptr != NULL)
+    {
+        hdr = (ev_allocator_hdr_t *)ptr - 1;
+        old_size = hdr->data.size;
+        type = hdr->data.type;
+    }
+
+    if (size == 0)
+    {
+        if (hdr != NULL)
+        {
+            _ev_allocator_raw(loop, hdr, 0);
+            _ev_allocator_stat_update(type, old_size, 0);
+        }
+        return NULL;
+    }
+
+    if (size > SIZE_MAX - sizeof(ev_allocator_hdr_t))
+    {
+        return NULL;
+    }
+
+    hdr = _ev_allocator_raw(loop, hdr, sizeof(ev_allocator_hdr_t) + size);
+    if (hdr == NULL)
+    {
+        return NULL;
+    }
+    hdr->data.size = size;
+    hdr->data.type = type;
+    _ev_allocator_stat_update(type, old_size, size);
+
+    return hdr + 1;
+}
+
+#else
+
+static void *_ev_allocator_realloc(ev_loop_t *loop, ev_allocator_type_t type,
+                                   void *ptr, size_t size)
+{
+    (void)type;
+    return _ev_allocator_raw(loop, ptr, size);
+}
+
+#endif
+
 int ev_replace_allocator(ev_realloc_fn  new_allocator,
                          ev_realloc_fn *old_allocator)
 {
@@ -25,39 +152,97 @@ int ev_replace_allocator(ev_realloc_fn  new_allocator,
     return 0;
 }
 
-void *ev_calloc(size_t nmemb, size_t size)
+int ev_allocator_stat(ev_allocator_type_t type, ev_allocator_stat_t *stat)
 {
-    const size_t alloc_size = size * nmemb;
-    void        *ptr = s_allocator(NULL, size * nmemb);
-    if (ptr != NULL)
+    if ((unsigned)type >= EV_ALLOCATOR_TYPE_MAX)
     {
-        memset(ptr, 0, alloc_size);
+        return EV_EINVAL;
     }
-    return ptr;
+
+#if defined(EV_ALLOCATOR_STAT)
+    ev_allocator_counter_t *counter = &s_allocator_counter[type];
+    stat->live_bytes = (size_t)ev_atomic64_load(&counter->live_bytes);
+    stat->peak_bytes = (size_t)ev_atomic64_load(&counter->peak_bytes);
+    stat->alloc_count = (uint64_t)ev_atomic64_load(&counter->alloc_count);
+    stat->realloc_count = (uint64_t)ev_atomic64_load(&counter->realloc_count);
+    stat->free_count = (uint64_t)ev_atomic64_load(&counter->free_count);
+    return 0;
+#else
+    (void)stat;
+    return EV_ENOSYS;
+#endif
+}
+
+void *ev_calloc(size_t nmemb, size_t size)
+{
+    return ev__loop_calloc(NULL, EV_ALLOCATOR_TYPE_MISC, nmemb, size);
 }
 
 void *ev_malloc(size_t size)
 {
-    return s_allocator(NULL, size);
+    return _ev_allocator_realloc(NULL, EV_ALLOCATOR_TYPE_MISC, NULL, size);
 }
 
 void *ev_realloc(void *ptr, size_t size)
 {
-    return s_allocator(ptr, size);
+    return _ev_allocator_realloc(NULL, EV_ALLOCATOR_TYPE_MISC, ptr, size);
 }
 
 void ev_free(void *ptr)
 {
-    s_allocator(ptr, 0);
+    _ev_allocator_realloc(NULL, EV_ALLOCATOR_TYPE_MISC, ptr, 0);
 }
 
-char *ev__strdup(const char *s)
+EV_LOCAL void *ev__malloc(ev_allocator_type_t type, size_t size)
+{
+    return _ev_allocator_realloc(NULL, type, NULL, size);
+}
+
+EV_LOCAL void *ev__calloc(ev_allocator_type_t type, size_t nmemb, size_t size)
+{
+    return ev__loop_calloc(NULL, type, nmemb, size);
+}
+
+EV_LOCAL void *ev__loop_malloc(ev_loop_t *loop, ev_allocator_type_t type,
+                               size_t size)
+{
+    return _ev_allocator_realloc(loop, type, NULL, size);
+}
+
+EV_LOCAL void *ev__loop_calloc(ev_loop_t *loop, ev_allocator_type_t type,
+                               size_t nmemb, size_t size)
+{
+    if (size != 0 && nmemb > SIZE_MAX / size)
+    {
+        return NULL;
+    }
+
+    const size_t alloc_size = size * nmemb;
+    void        *ptr = _ev_allocator_realloc(loop, type, NULL, alloc_size);
+    if (ptr != NULL)
+    {
+        memset(ptr, 0, alloc_size);
+    }
+    return ptr;
+}
+
+EV_LOCAL void ev__loop_free(ev_loop_t *loop, void *ptr)
+{
+    _ev_allocator_realloc(loop, EV_ALLOCATOR_TYPE_MISC, ptr, 0);
+}
+
+EV_LOCAL char *ev__strdup_ext(ev_allocator_type_t type, const char *s)
 {
     size_t len = strlen(s) + 1;
-    char  *m = ev_malloc(len);
+    char  *m = ev__malloc(type, len);
     if (m == NULL)
     {
         return NULL;
     }
     return memcpy(m, s, len);
 }
+
+char *ev__strdup(const char *s)
+{
+    return ev__strdup_ext(EV_ALLOCATOR_TYPE_MISC, s);
+}
@@ -0,0 +1,69 @@
+#ifndef __EV_ALLOCATOR_INTERNAL_H__
+#define __EV_ALLOCATOR_INTERNAL_H__
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Allocate memory from global allocator.
+ * @param[in] type  Memory category.
+ * @param[in] size  Memory size.
+ * @return          Memory address, or NULL if failure. Use #ev_free() to
+ *   release it.
+ */
+EV_LOCAL void *ev__malloc(ev_allocator_type_t type, size_t size);
+
+/**
+ * @brief Allocate zero-initialized memory from global allocator.
+ * @param[in] type  Memory category.
+ * @param[in] nmemb Number of elements.
+ * @param[in] size  Element size.
+ * @return          Memory address, or NULL if failure. Use #ev_free() to
+ *   release it.
+ */
+EV_LOCAL void *ev__calloc(ev_allocator_type_t type, size_t nmemb, size_t size);
+
+/**
+ * @brief Duplicate string by global allocator.
+ * @param[in] type  Memory category.
+ * @param[in] str   String to duplicate.
+ * @return          Duplicated string, or NULL if failure. Use #ev_free() to
+ *   release it.
+ */
+EV_LOCAL char *ev__strdup_ext(ev_allocator_type_t type, const char *str);
+
+/**
+ * @brief Allocate memory from loop local allocator.
+ * @param[in] loop  Event loop. If NULL or the loop does not have a local
+ *   allocator, the global allocator is used.
+ * @param[in] type  Memory category.
+ * @param[in] size  Memory size.
+ * @return          Memory address, or NULL if failure.
+ */
+EV_LOCAL void *ev__loop_malloc(ev_loop_t *loop, ev_allocator_type_t type,
+                               size_t size);
+
+/**
+ * @brief Allocate zero-initialized memory from loop local allocator.
+ * @see ev__loop_malloc()
+ * @param[in] loop  Event loop.
+ * @param[in] type  Memory category.
+ * @param[in] nmemb Number of elements.
+ * @param[in] size  Element size.
+ * @return          Memory address, or NULL if failure.
+ */
+EV_LOCAL void *ev__loop_calloc(ev_loop_t *loop, ev_allocator_type_t type,
+                               size_t nmemb, size_t size);
+
+/**
+ * @brief Release memory allocated by #ev__loop_malloc() or
+ *   #ev__loop_calloc().
+ * @param[in] loop  Event loop. Must be the same one used for allocate.
+ * @param[in] ptr   Memory address.
+ */
+EV_LOCAL void ev__loop_free(ev_loop_t *loop, void *ptr);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,343 @@
+#include <string.h>
+
+#define EV_DNS_DEFAULT_TTL      30000
+#define EV_DNS_DEFAULT_NEG_TTL  5000
+
+/**
+ * @brief Max number of cache entries, the oldest one is evicted beyond it.
+ */
+#define EV_DNS_CACHE_MAX_SIZE   1024
+
+static int _ev_dns_cmp_str(const char *s1, const char *s2)
+{
+    if (s1 == NULL || s2 == NULL)
+    {
+        return (s1 != NULL) - (s2 != NULL);
+    }
+    return strcmp(s1, s2);
+}
+
+static int _ev_dns_cmp_entry(const ev_map_node_t *key1,
+                             const ev_map_node_t *key2, void *arg)
+{
+    (void)arg;
+    int                     ret;
+    ev_getaddrinfo_entry_t *e1 =
+        EV_CONTAINER_OF(key1, ev_getaddrinfo_entry_t, node);
+    ev_getaddrinfo_entry_t *e2 =
+        EV_CONTAINER_OF(key2, ev_getaddrinfo_entry_t, node);
+
+    if (e1->flags != e2->flags)
+    {
+        return e1->flags < e2->flags ? -1 : 1;
+    }
+    if (e1->family != e2->family)
+    {
+        return e1->family < e2->family ? -1 : 1;
+    }
+    if (e1->socktype != e2->socktype)
+    {
+        return e1->socktype < e2->socktype ? -1 : 1;
+    }
+    if (e1->protocol != e2->protocol)
+    {
+        return e1->protocol < e2->protocol ? -1 : 1;
+    }
+    if ((ret = _ev_dns_cmp_str(e1->host, e2->host)) != 0)
+    {
+        return ret;
+    }
+    return _ev_dns_cmp_str(e1->service, e2->service);
+}
+
+static int _ev_dns_translate_error(int ret)
+{
+    switch (ret)
+    {
+    case 0:
+        return 0;
+    case EAI_NONAME:
+#if defined(EAI_NODATA) && EAI_NODATA != EAI_NONAME
+    case EAI_NODATA:
+#endif
+        return EV_ENOENT;
+    case EAI_AGAIN:
+        return EV_EAGAIN;
+    case EAI_MEMORY:
+        return EV_ENOMEM;
+    case EAI_FAMILY:
+    case EAI_SOCKTYPE:
+    case EAI_SERVICE:
+    case EAI_BADFLAGS:
+        return EV_EINVAL;
+#if defined(EAI_SYSTEM)
+    case EAI_SYSTEM:
+        return ev__translate_sys_error(errno);
+#endif
+    default:
+        break;
+    }
+    return EV_EIO;
+}
+
+static void _ev_dns_unref(ev_getaddrinfo_entry_t *entry)
+{
+    if (--entry->refcnt != 0)
+    {
+        return;
+    }
+
+    if (entry->res != NULL)
+    {
+        freeaddrinfo(entry->res);
+    }
+    ev__loop_free(entry->loop, entry);
+}
+
+static void _ev_dns_uncache(ev_getaddrinfo_entry_t *entry)
+{
+    ev_loop_t *loop = entry->loop;
+    if (!entry->cached)
+    {
+        return;
+    }
+
+    entry->cached = 0;
+    ev_map_erase(&loop->dns.cache, &entry->node);
+    ev_list_erase(&loop->dns.age, &entry->age);
+    loop->dns.cache_sz--;
+    _ev_dns_unref(entry);
+}
+
+static int _ev_dns_is_expired(ev_getaddrinfo_entry_t *entry)
+{
+    return !entry->pending && entry->expire <= entry->loop->hwtime;
+}
+
+/**
+ * @brief Evict the oldest entries until there is room for a new one.
+ *
+ * An evicted entry that is still in use is released by its last request.
+ */
+static void _ev_dns_evict(ev_loop_t *loop)
+{
+    ev_list_node_t *it;
+    while (loop->dns.cache_sz >= EV_DNS_CACHE_MAX_SIZE &&
+           (it = ev_list_begin(&loop->dns.age)) != NULL)
+    {
+        _ev_dns_uncache(EV_CONTAINER_OF(it, ev_getaddrinfo_entry_t, age));
+    }
+}
+
+static void _ev_dns_finish(ev_getaddrinfo_t *req)
+{
+    ev_getaddrinfo_entry_t *entry = req->entry;
+    req->entry = NULL;
+
+    ev__handle_deactive(&req->base);
+    ev__handle_exit(&req->base, NULL);
+
+    req->cb(req, entry->status == 0 ? entry->res : NULL, entry->status);
+    _ev_dns_unref(entry);
+}
+
+static void _ev_dns_on_backlog(ev_handle_t *handle)
+{
+    ev_getaddrinfo_t *req = EV_CONTAINER_OF(handle, ev_getaddrinfo_t, base);
+    _ev_dns_finish(req);
+}
+
+static void _ev_dns_on_work(ev_work_t *work)
+{
+    int                     ret;
+    struct addrinfo         hints;
+    ev_getaddrinfo_entry_t *entry =
+        EV_CONTAINER_OF(work, ev_getaddrinfo_entry_t, token);
+
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_flags = entry->flags;
+    hints.ai_family = entry->family;
+    hints.ai_socktype = entry->socktype;
+    hints.ai_protocol = entry->protocol;
+
+    ret = getaddrinfo(entry->host, entry->service, &hints, &entry->res);
+    entry->status = _ev_dns_translate_error(ret);
+}
+
+static void _ev_dns_on_work_done(ev_work_t *work, int status)
+{
+    ev_list_node_t         *it;
+    ev_getaddrinfo_entry_t *entry =
+        EV_CONTAINER_OF(work, ev_getaddrinfo_entry_t, token);
+    ev_loop_t *loop = entry->loop;
+
+    entry->pending = 0;
+    if (status != 0)
+    {
+        entry->status = status;
+    }
+
+    if (entry->status == 0)
+    {
+        entry->expire = loop->hwtime + loop->dns.ttl;
+    }
+    else if (entry->status == EV_ENOENT)
+    {
+        entry->expire = loop->hwtime + loop->dns.neg_ttl;
+    }
+    else
+    {
+        /* Temporary failure is not cached */
+        _ev_dns_uncache(entry);
+    }
+
+    /* Callback may add new request to this entry */
+    entry->refcnt++;
+    while ((it = ev_list_pop_front(&entry->wait_queue)) != NULL)
+    {
+        ev_getaddrinfo_t *req = EV_CONTAINER_OF(it, ev_getaddrinfo_t, node);
+        _ev_dns_finish(req);
+    }
+    _ev_dns_unref(entry);
+}
+
+static ev_getaddrinfo_entry_t *_ev_dns_new_entry(ev_loop_t  *loop,
+                                                 const char *host,
+                                                 const char *service,
+                                                 const struct addrinfo *hints)
+{
+    size_t host_sz = host != NULL ? strlen(host) + 1 : 0;
+    size_t service_sz = service != NULL ? strlen(service) + 1 : 0;
+
+    ev_getaddrinfo_entry_t *entry =
+        ev__loop_malloc(loop, EV_ALLOCATOR_TYPE_MISC,
+                        sizeof(ev_getaddrinfo_entry_t) + host_sz + service_sz);
+    if (entry == NULL)
+    {
+        return NULL;
+    }
+
+    char *pos = (char *)(entry + 1);
+    entry->host = host != NULL ? memcpy(pos, host, host_sz) : NULL;
+    entry->service =
+        service != NULL ? memcpy(pos + host_sz, service, service_sz) : NULL;
+    entry->flags = hints->ai_flags;
+    entry->family = hints->ai_family;
+    entry->socktype = hints->ai_socktype;
+    entry->protocol = hints->ai_protocol;
+
+    ev_list_init(&entry->wait_queue);
+    entry->loop = loop;
+    entry->res = NULL;
+    entry->status = 0;
+    entry->pending = 1;
+    entry->cached = 1;
+    entry->refcnt = 1;
+    entry->expire = 0;
+
+    return entry;
+}
+
+EV_LOCAL void ev__init_dns(ev_loop_t *loop)
+{
+    ev_map_init(&loop->dns.cache, _ev_dns_cmp_entry, NULL);
+    ev_list_init(&loop->dns.age);
+    loop->dns.cache_sz = 0;
+    loop->dns.ttl = EV_DNS_DEFAULT_TTL;
+    loop->dns.neg_ttl = EV_DNS_DEFAULT_NEG_TTL;
+}
+
+EV_LOCAL void ev__exit_dns(ev_loop_t *loop)
+{
+    ev_map_node_t *it;
+    while ((it = ev_map_begin(&loop->dns.cache)) != NULL)
+    {
+        _ev_dns_uncache(EV_CONTAINER_OF(it, ev_getaddrinfo_entry_t, node));
+    }
+}
+
+int ev_getaddrinfo(ev_loop_t *loop, ev_getaddrinfo_t *req, const char *host,
+                   const char *service, const struct addrinfo *hints,
+                   ev_getaddrinfo_cb cb)
+{
+    int                     ret;
+    struct addrinfo         empty_hints;
+    ev_getaddrinfo_entry_t  key;
+    ev_getaddrinfo_entry_t *entry = NULL;
+
+    if (host == NULL && service == NULL)
+    {
+        return EV_EINVAL;
+    }
+    if (hints == NULL)
+    {
+        memset(&empty_hints, 0, sizeof(empty_hints));
+        empty_hints.ai_family = AF_UNSPEC;
+        hints = &empty_hints;
+    }
+
+    key.host = host;
+    key.service = service;
+    key.flags = hints->ai_flags;
+    key.family = hints->ai_family;
+    key.socktype = hints->ai_socktype;
+    key.protocol = hints->ai_protocol;
+
+    ev_map_node_t *it = ev_map_find(&loop->dns.cache, &key.node);
+    if (it != NULL)
+    {
+        entry = EV_CONTAINER_OF(it, ev_getaddrinfo_entry_t, node);
+        if (_ev_dns_is_expired(entry))
+        {
+            _ev_dns_uncache(entry);
+            entry = NULL;
+        }
+    }
+
+    if (entry == NULL)
+    {
+        _ev_dns_evict(loop);
+
+        if ((entry = _ev_dns_new_entry(loop, host, service, hints)) == NULL)
+        {
+            return EV_ENOMEM;
+        }
+
+        ret = ev__loop_submit_threadpool(loop, &entry->token,
+                                         EV_THREADPOOL_WORK_IO_SLOW,
+                                         _ev_dns_on_work, _ev_dns_on_work_done);
+        if (ret != 0)
+        {
+            ev__loop_free(loop, entry);
+            return ret;
+        }
+
+        ev_map_insert(&loop->dns.cache, &entry->node);
+        ev_list_push_back(&loop->dns.age, &entry->age);
+        loop->dns.cache_sz++;
+    }
+
+    ev__handle_init(loop, &req->base, EV_ROLE_EV_REQ_DNS);
+    ev__handle_active(&req->base);
+    req->node = (ev_list_node_t)EV_LIST_NODE_INIT;
+    req->entry = entry;
+    req->cb = cb;
+    entry->refcnt++;
+
+    if (entry->pending)
+    {
+        ev_list_push_back(&entry->wait_queue, &req->node);
+    }
+    else
+    {
+        ev__backlog_submit(&req->base, _ev_dns_on_backlog);
+    }
+
+    return 0;
+}
+
+void ev_getaddrinfo_set_ttl(ev_loop_t *loop, uint64_t ttl, uint64_t neg_ttl)
+{
+    loop->dns.ttl = ttl;
+    loop->dns.neg_ttl = neg_ttl;
+}
@@ -0,0 +1,54 @@
+#ifndef __EV_DNS_INTERNAL_H__
+#define __EV_DNS_INTERNAL_H__
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Resolver cache entry.
+ *
+ * An entry is shared by every request with the same arguments. While the
+ * lookup is in progress, new requests wait in \p wait_queue.
+ */
+typedef struct ev_getaddrinfo_entry
+{
+    ev_map_node_t  node;       /**< #ev_loop_t::dns::cache */
+    ev_list_node_t age;        /**< #ev_loop_t::dns::age */
+    ev_work_t      token;      /**< Thread pool token */
+    ev_list_t      wait_queue; /**< #ev_getaddrinfo_t::node. Waiting requests */
+    ev_loop_t     *loop;       /**< Event loop */
+
+    const char *host;     /**< Host name, stored after this structure */
+    const char *service;  /**< Service name, stored after this structure */
+    int         flags;    /**< #addrinfo::ai_flags */
+    int         family;   /**< #addrinfo::ai_family */
+    int         socktype; /**< #addrinfo::ai_socktype */
+    int         protocol; /**< #addrinfo::ai_protocol */
+
+    struct addrinfo *res;     /**< Lookup result */
+    int              status;  /**< #ev_errno_t, system error in thread pool */
+    int              pending; /**< Lookup is in progress */
+    int              cached;  /**< Entry is in cache */
+    size_t           refcnt;  /**< Reference count */
+    uint64_t         expire;  /**< Expire time */
+} ev_getaddrinfo_entry_t;
+
+/**
+ * @brief Initialize resolver context.
+ * @param[out] loop Event loop
+ */
+EV_LOCAL void ev__init_dns(ev_loop_t *loop);
+
+/**
+ * @brief Release resolver cache.
+ *
+ * Entries still referenced by requests are released when the requests finish.
+ *
+ * @param[in] loop  Event loop
+ */
+EV_LOCAL void ev__exit_dns(ev_loop_t *loop);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
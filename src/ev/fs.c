@@ -127,7 +127,8 @@ static int _ev_fs_init_req_as_open(ev_fs_req_t* token, ev_file_t* file,
 {
     _ev_fs_init_req(token, file, cb, EV_FS_REQ_OPEN);
 
-    if ((token->req.as_open.path = ev__strdup(path)) == NULL)
+    token->req.as_open.path = ev__strdup_ext(EV_ALLOCATOR_TYPE_FS, path);
+    if (token->req.as_open.path == NULL)
     {
         return EV_ENOMEM;
     }
@@ -189,7 +190,7 @@ static void _ev_fs_init_req_as_fstat(ev_fs_req_t* req, ev_file_t* file,
 static int _ev_fs_init_req_as_readdir(ev_fs_req_t* req, const char* path, ev_file_cb cb)
 {
     _ev_fs_init_req(req, NULL, cb, EV_FS_REQ_READDIR);
-    req->req.as_readdir.path = ev__strdup(path);
+    req->req.as_readdir.path = ev__strdup_ext(EV_ALLOCATOR_TYPE_FS, path);
     if (req->req.as_readdir.path == NULL)
     {
         return EV_ENOMEM;
@@ -205,7 +206,7 @@ static int _ev_fs_init_req_as_readfile(ev_fs_req_t* req, const char* path,
 {
     _ev_fs_init_req(req, NULL, cb, EV_FS_REQ_READFILE);
 
-    req->req.as_readfile.path = ev__strdup(path);
+    req->req.as_readfile.path = ev__strdup_ext(EV_ALLOCATOR_TYPE_FS, path);
     if (req->req.as_readfile.path == NULL)
     {
         return EV_ENOMEM;
@@ -221,7 +222,7 @@ static int _ev_fs_init_req_as_mkdir(ev_fs_req_t* req, const char* path, int mode
 {
     _ev_fs_init_req(req, NULL, cb, EV_FS_REQ_MKDIR);
 
-    req->req.as_mkdir.path = ev__strdup(path);
+    req->req.as_mkdir.path = ev__strdup_ext(EV_ALLOCATOR_TYPE_FS, path);
     if (req->req.as_mkdir.path == NULL)
     {
         return EV_ENOMEM;
@@ -235,7 +236,7 @@ static int _ev_fs_init_req_as_remove(ev_fs_req_t* req, const char* path, int rec
 {
     _ev_fs_init_req(req, NULL, cb, EV_FS_REQ_REMOVE);
 
-    req->req.as_remove.path = ev__strdup(path);
+    req->req.as_remove.path = ev__strdup_ext(EV_ALLOCATOR_TYPE_FS, path);
     if (req->req.as_remove.path == NULL)
     {
         return EV_ENOMEM;
@@ -299,14 +300,15 @@ static int _ev_fs_on_readdir_entry(ev_dirent_t* info, void* arg)
 {
     fs_readdir_helper_t* helper = arg;
 
-    ev_dirent_record_t* rec = ev_malloc(sizeof(ev_dirent_record_t));
+    ev_dirent_record_t* rec =
+        ev__malloc(EV_ALLOCATOR_TYPE_DIRENT, sizeof(ev_dirent_record_t));
     if (rec == NULL)
     {
         goto err_nomem;
     }
 
     rec->data.type = info->type;
-    rec->data.name = ev__strdup(info->name);
+    rec->data.name = ev__strdup_ext(EV_ALLOCATOR_TYPE_DIRENT, info->name);
     if (rec->data.name == NULL)
     {
         goto err_nomem;
@@ -463,7 +465,7 @@ static void _ev_fs_readfile_sync(ev_fs_req_t* req)
     /* Now it is a safe cast. */
     size_t file_sz = (size_t)statbuf.st_size;
 
-    void* data = ev_malloc(file_sz);
+    void* data = ev__malloc(EV_ALLOCATOR_TYPE_FS, file_sz);
     if (data == NULL)
     {
         req->result = EV_ENOMEM;
@@ -578,7 +580,7 @@ static  int _ev_fs_remove_helper(ev_dirent_t* info, void* arg)
     size_t name_sz = strlen(info->name);
     size_t full_path_sz = parent_path_sz + 1 + name_sz;
 
-    char* full_path = ev_malloc(full_path_sz + 1);
+    char* full_path = ev__malloc(EV_ALLOCATOR_TYPE_FS, full_path_sz + 1);
     snprintf(full_path, full_path_sz + 1, "%s/%s", parent_path, info->name);
 
     helper->ret = ev__fs_remove(full_path, 1);
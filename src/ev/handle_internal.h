@@ -10,6 +10,7 @@ typedef enum ev_handle_flag
     EV_HANDLE_CLOSING           = 0x01 << 0x00,     /**< 1. Handle is going to close */
     EV_HANDLE_CLOSED            = 0x01 << 0x01,     /**< 2. Handle is closed */
     EV_HANDLE_ACTIVE            = 0x01 << 0x02,     /**< 4. Handle is busy */
+    EV_HANDLE_INPLACE           = 0x01 << 0x03,     /**< 8. Handle memory is owned by user */
 
     /* #EV_ROLE_EV_TCP */
     EV_HANDLE_TCP_LISTING       = 0x01 << 0x08,     /**< 256. This is a listen socket and is listening */
@@ -23,10 +24,15 @@ typedef enum ev_handle_flag
     EV_HANDLE_UDP_CONNECTED     = 0x01 << 0x09,     /**< 512. This socket is connected */
     EV_HANDLE_UDP_BOUND         = 0x01 << 0x0A,     /**< 1024. Socket is bond to address */
     EV_HANDLE_UDP_BYPASS_IOCP   = 0x01 << 0x0B,     /**< 2048. FILE_SKIP_SET_EVENT_ON_HANDLE | FILE_SKIP_COMPLETION_PORT_ON_SUCCESS */
+    EV_HANDLE_UDP_NO_GSO        = 0x01 << 0x0C,     /**< 4096. UDP_SEGMENT rejected by route, send segments one by one */
 
     /* #EV_ROLE_EV_PIPE */
     EV_HANDLE_PIPE_IPC          = 0x01 << 0x08,     /**< 256. This pipe is support IPC */
     EV_HANDLE_PIPE_STREAMING    = 0x01 << 0x09,     /**< 512. This pipe is initialized by #ev_stream_t */
+
+    /* #EV_ROLE_EV_SHM_CHANNEL */
+    EV_HANDLE_SHM_CHANNEL_SENDER = 0x01 << 0x08,    /**< 256. Opened by #ev_shm_channel_open() */
+    EV_HANDLE_SHM_CHANNEL_BROKEN = 0x01 << 0x09,    /**< 512. Ring is corrupted, stop receiving */
 } ev_handle_flag_t;
 
 /**
@@ -1,63 +1,107 @@
-
-int ev_pipe_write(ev_pipe_t *pipe, ev_buf_t *bufs, size_t nbuf,
-                  ev_pipe_write_cb cb, void *arg)
-{
-    return ev_pipe_write_ex(pipe, bufs, nbuf, EV_ROLE_UNKNOWN, NULL, cb, arg);
-}
-
-EV_LOCAL int ev__pipe_read_init(ev_pipe_read_req_t *req, ev_buf_t *bufs,
-                                size_t nbuf, ev_pipe_read_cb cb)
-{
-    int ret;
-    if ((ret = ev__read_init(&req->base, bufs, nbuf)) != 0)
-    {
-        return ret;
-    }
-    req->ucb = cb;
-
-    req->handle.os_socket = EV_OS_SOCKET_INVALID;
-    return 0;
-}
-
-EV_LOCAL int ev__pipe_write_init(ev_pipe_write_req_t *req, ev_buf_t *bufs,
-                                 size_t nbuf, ev_pipe_write_cb cb, void *arg)
-{
-    return ev__pipe_write_init_ext(req, cb, arg, bufs, nbuf, EV_ROLE_UNKNOWN,
-                                   NULL);
-}
-
-EV_LOCAL int ev__pipe_write_init_ext(ev_pipe_write_req_t *req,
-                                     ev_pipe_write_cb cb, void *arg,
-                                     ev_buf_t *bufs, size_t nbuf,
-                                     ev_role_t handle_role, void *handle_addr)
-{
-    int ret;
-    if ((ret = ev__write_init(&req->base, bufs, nbuf)) != 0)
-    {
-        return ret;
-    }
-    req->ucb = cb;
-    req->ucb_arg = arg;
-
-    req->handle.role = handle_role;
-    switch (handle_role)
-    {
-        /* no handle need to send */
-    case EV_ROLE_UNKNOWN:
-        break;
-
-    case EV_ROLE_EV_TCP:
-        if (((ev_tcp_t *)handle_addr)->base.data.role != EV_ROLE_EV_TCP)
-        {
-            return EV_EINVAL;
-        }
-        req->handle.u.os_socket = ((ev_tcp_t *)handle_addr)->sock;
-        break;
-
-        /* not support other type */
-    default:
-        return EV_EINVAL;
-    }
-
-    return 0;
-}
+
+int ev_pipe_write(ev_pipe_t *pipe, ev_buf_t *bufs, size_t nbuf,
+                  ev_pipe_write_cb cb, void *arg)
+{
+    return ev_pipe_write_ex(pipe, bufs, nbuf, EV_ROLE_UNKNOWN, NULL, cb, arg);
+}
+
+EV_LOCAL int ev__pipe_read_init(ev_pipe_read_req_t *req, ev_buf_t *bufs,
+                                size_t nbuf, ev_pipe_read_cb cb)
+{
+    int ret;
+    if ((ret = ev__read_init(&req->base, bufs, nbuf)) != 0)
+    {
+        return ret;
+    }
+    req->ucb = cb;
+
+    req->handle.num = 0;
+    req->handle.pos = 0;
+    return 0;
+}
+
+EV_LOCAL int ev__pipe_write_init(ev_pipe_write_req_t *req, ev_buf_t *bufs,
+                                 size_t nbuf, ev_pipe_write_cb cb, void *arg)
+{
+    return ev__pipe_write_init_ext(req, cb, arg, bufs, nbuf, EV_ROLE_UNKNOWN,
+                                   NULL, 0);
+}
+
+static int _ev_pipe_get_os_socket(ev_role_t handle_role, void *handle_addr,
+                                  ev_os_socket_t *sock)
+{
+    switch (handle_role)
+    {
+    case EV_ROLE_EV_TCP:
+        if (((ev_tcp_t *)handle_addr)->base.data.role != EV_ROLE_EV_TCP)
+        {
+            return EV_EINVAL;
+        }
+        *sock = ((ev_tcp_t *)handle_addr)->sock;
+        return 0;
+
+    case EV_ROLE_EV_SHM_CHANNEL:
+        return ev__shm_channel_doorbell(handle_addr, sock);
+
+        /* not support other type */
+    default:
+        break;
+    }
+
+    return EV_EINVAL;
+}
+
+EV_LOCAL int ev__pipe_write_init_ext(ev_pipe_write_req_t *req,
+                                     ev_pipe_write_cb cb, void *arg,
+                                     ev_buf_t *bufs, size_t nbuf,
+                                     ev_role_t handle_role, void **handle_addrs,
+                                     size_t handle_num)
+{
+    int ret;
+    if (handle_num > EV_PIPE_IPC_HANDLE_MAX)
+    {
+        return EV_E2BIG;
+    }
+    if ((ret = ev__write_init(&req->base, bufs, nbuf)) != 0)
+    {
+        return ret;
+    }
+    req->ucb = cb;
+    req->ucb_arg = arg;
+
+    /* no handle need to send */
+    req->handle.role = EV_ROLE_UNKNOWN;
+    req->handle.num = 0;
+    if (handle_role == EV_ROLE_UNKNOWN || handle_num == 0)
+    {
+        return 0;
+    }
+
+    size_t i;
+    for (i = 0; i < handle_num; i++)
+    {
+        if (handle_addrs[i] == NULL)
+        {
+            return EV_EINVAL;
+        }
+        ret = _ev_pipe_get_os_socket(handle_role, handle_addrs[i],
+                                     &req->handle.os_socket[i]);
+        if (ret != 0)
+        {
+            return ret;
+        }
+    }
+    req->handle.role = handle_role;
+    req->handle.num = handle_num;
+
+    return 0;
+}
+
+int ev_pipe_write_ex(ev_pipe_t *pipe, ev_buf_t *bufs, size_t nbuf,
+                     ev_role_t handle_role, void *handle_addr,
+                     ev_pipe_write_cb cb, void *arg)
+{
+    size_t handle_num = handle_role != EV_ROLE_UNKNOWN ? 1 : 0;
+    return ev_pipe_write_handles(pipe, bufs, nbuf, handle_role, &handle_addr,
+                                 handle_num, cb, arg);
+}
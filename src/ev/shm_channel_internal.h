@@ -0,0 +1,19 @@
+#ifndef __EV_SHM_CHANNEL_INTERNAL_H__
+#define __EV_SHM_CHANNEL_INTERNAL_H__
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Get doorbell of receiving channel to share with peer.
+ * @param[in] chan  Channel created by #ev_shm_channel_init().
+ * @param[out] fd   Doorbell
+ * @return          #ev_errno_t
+ */
+EV_LOCAL int ev__shm_channel_doorbell(ev_shm_channel_t *chan,
+                                      ev_os_socket_t   *fd);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -1,10 +1,10 @@
-
-void* ev_shmem_addr(ev_shmem_t* shm)
-{
-    return shm->addr;
-}
-
-size_t ev_shmem_size(ev_shmem_t* shm)
-{
-    return shm->size;
-}
+
+void* ev_shmem_addr(ev_shmem_t* shm)
+{
+    return shm->addr;
+}
+
+size_t ev_shmem_size(ev_shmem_t* shm)
+{
+    return shm->size;
+}
@@ -1,10 +1,10 @@
-#ifndef __EV_SHARED_MEMORY_COMMON_H__
-#define __EV_SHARED_MEMORY_COMMON_H__
-#ifdef __cplusplus
-extern "C" {
-#endif
-
-#ifdef __cplusplus
-}
-#endif
-#endif
+#ifndef __EV_SHARED_MEMORY_COMMON_H__
+#define __EV_SHARED_MEMORY_COMMON_H__
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+#endif
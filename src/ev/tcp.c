@@ -0,0 +1,336 @@
+/**
+ * @brief Options that only make sense on listen socket.
+ */
+#define EV_TCP_OPT_LISTEN_MASK                                                  \
+    ((1u << EV_TCP_OPT_DEFER_ACCEPT) | (1u << EV_TCP_OPT_FASTOPEN))
+
+/**
+ * @brief Options that the kernel copies from listen socket to connection.
+ */
+#define EV_TCP_OPT_INHERIT_MASK                                                 \
+    ((1u << EV_TCP_OPT_NODELAY) | (1u << EV_TCP_OPT_KEEPALIVE) |               \
+     (1u << EV_TCP_OPT_SNDBUF) | (1u << EV_TCP_OPT_RCVBUF) |                   \
+     (1u << EV_TCP_OPT_NOTSENT_LOWAT) | (1u << EV_TCP_OPT_BUSY_POLL))
+
+static int _ev_tcp_opt_apply_one(ev_tcp_t *sock, int opt)
+{
+    int ret, level, name;
+    if ((ret = ev__tcp_opt_native((ev_tcp_opt_t)opt, &level, &name)) != 0)
+    {
+        return ret;
+    }
+    if ((ret = ev__tcp_setsockopt(sock->sock, level, name,
+                                  sock->opts.val[opt])) != 0)
+    {
+        return ret;
+    }
+
+    sock->opts.pending &= ~(1u << opt);
+    return 0;
+}
+
+static void _ev_tcp_recycle_trim(ev_tcp_t *lisn, size_t capacity)
+{
+    ev_list_node_t *it;
+    while (ev_list_size(&lisn->recycle.idle_queue) > capacity)
+    {
+        it = ev_list_pop_front(&lisn->recycle.idle_queue);
+        ev_tcp_t *sock = EV_CONTAINER_OF(it, ev_tcp_t, recycle.node);
+        ev__loop_free(lisn->base.loop, sock);
+    }
+}
+
+EV_LOCAL void ev__tcp_opts_init(ev_tcp_t *sock)
+{
+    memset(&sock->opts, 0, sizeof(sock->opts));
+}
+
+EV_LOCAL int ev__tcp_opts_apply(ev_tcp_t *sock, int listen)
+{
+    int      ret, opt;
+    unsigned todo = sock->opts.pending;
+    if (!listen)
+    {
+        todo &= ~EV_TCP_OPT_LISTEN_MASK;
+    }
+
+    for (opt = 0; opt < EV_TCP_OPT_CNT; opt++)
+    {
+        if ((todo & (1u << opt)) &&
+            (ret = _ev_tcp_opt_apply_one(sock, opt)) != 0)
+        {
+            return ret;
+        }
+    }
+
+    return 0;
+}
+
+EV_LOCAL void ev__tcp_opts_inherit(ev_tcp_t *conn, ev_tcp_t *lisn,
+                                   int by_kernel)
+{
+    int      opt;
+    unsigned copy =
+        lisn->opts.mask & ~EV_TCP_OPT_LISTEN_MASK & ~conn->opts.mask;
+
+    for (opt = 0; opt < EV_TCP_OPT_CNT; opt++)
+    {
+        if (copy & (1u << opt))
+        {
+            conn->opts.val[opt] = lisn->opts.val[opt];
+        }
+    }
+    conn->opts.mask |= copy;
+    conn->opts.pending |= by_kernel ? (copy & ~EV_TCP_OPT_INHERIT_MASK) : copy;
+
+    (void)ev__tcp_opts_apply(conn, 0);
+}
+
+EV_LOCAL void ev__tcp_recycle_init(ev_tcp_t *sock)
+{
+    sock->recycle.owner = NULL;
+    sock->recycle.node = (ev_list_node_t)EV_LIST_NODE_INIT;
+    ev_list_init(&sock->recycle.idle_queue);
+    ev_list_init(&sock->recycle.busy_queue);
+    sock->recycle.capacity = 0;
+}
+
+EV_LOCAL int ev__tcp_recycle(ev_tcp_t *sock)
+{
+    ev_tcp_t *lisn = sock->recycle.owner;
+    if (lisn == NULL)
+    {
+        return 0;
+    }
+
+    sock->recycle.owner = NULL;
+    ev_list_erase(&lisn->recycle.busy_queue, &sock->recycle.node);
+
+    if (ev_list_size(&lisn->recycle.idle_queue) >= lisn->recycle.capacity)
+    {
+        return 0;
+    }
+
+    ev_list_push_back(&lisn->recycle.idle_queue, &sock->recycle.node);
+    return 1;
+}
+
+EV_LOCAL void ev__tcp_recycle_exit(ev_tcp_t *lisn)
+{
+    ev_list_node_t *it;
+    while ((it = ev_list_pop_front(&lisn->recycle.busy_queue)) != NULL)
+    {
+        ev_tcp_t *sock = EV_CONTAINER_OF(it, ev_tcp_t, recycle.node);
+        sock->recycle.owner = NULL;
+    }
+
+    _ev_tcp_recycle_trim(lisn, 0);
+    lisn->recycle.capacity = 0;
+}
+
+int ev_tcp_accept_cache(ev_tcp_t *lisn, size_t capacity)
+{
+    if (lisn->base.data.flags & EV_HANDLE_CLOSING)
+    {
+        return EV_EBADF;
+    }
+
+    lisn->recycle.capacity = capacity;
+    _ev_tcp_recycle_trim(lisn, capacity);
+
+    return 0;
+}
+
+int ev_tcp_init_accept(ev_tcp_t *lisn, ev_tcp_t **conn)
+{
+    int             ret;
+    ev_tcp_t       *sock;
+    ev_list_node_t *it;
+
+    if (lisn->base.data.flags & EV_HANDLE_CLOSING)
+    {
+        return EV_EBADF;
+    }
+    if (!(lisn->base.data.flags & EV_HANDLE_TCP_LISTING))
+    {
+        return EV_EINVAL;
+    }
+
+    if ((it = ev_list_pop_front(&lisn->recycle.idle_queue)) != NULL)
+    {
+        sock = EV_CONTAINER_OF(it, ev_tcp_t, recycle.node);
+        ev__tcp_init(lisn->base.loop, sock);
+    }
+    else if ((ret = ev_tcp_init(lisn->base.loop, &sock)) != 0)
+    {
+        return ret;
+    }
+
+    sock->recycle.owner = lisn;
+    ev_list_push_back(&lisn->recycle.busy_queue, &sock->recycle.node);
+
+    *conn = sock;
+    return 0;
+}
+
+int ev_tcp_setopt(ev_tcp_t *sock, ev_tcp_opt_t opt, int val)
+{
+    int ret, level, name;
+    if ((int)opt < 0 || (int)opt >= EV_TCP_OPT_CNT)
+    {
+        return EV_EINVAL;
+    }
+    if ((ret = ev__tcp_opt_native(opt, &level, &name)) != 0)
+    {
+        return ret;
+    }
+
+    unsigned bit = 1u << opt;
+    int      old_val = sock->opts.val[opt];
+    unsigned old_mask = sock->opts.mask;
+    unsigned old_pending = sock->opts.pending;
+
+    sock->opts.val[opt] = val;
+    sock->opts.mask |= bit;
+    sock->opts.pending |= bit;
+
+    if (sock->sock == EV_OS_SOCKET_INVALID)
+    {
+        return 0;
+    }
+    if ((bit & EV_TCP_OPT_LISTEN_MASK) &&
+        !(sock->base.data.flags & EV_HANDLE_TCP_LISTING))
+    {
+        return 0;
+    }
+
+    if ((ret = _ev_tcp_opt_apply_one(sock, opt)) != 0)
+    {
+        sock->opts.val[opt] = old_val;
+        sock->opts.mask = old_mask;
+        sock->opts.pending = old_pending;
+    }
+    return ret;
+}
+
+int ev_tcp_getopt(ev_tcp_t *sock, ev_tcp_opt_t opt, int *val)
+{
+    int ret, level, name;
+    if ((int)opt < 0 || (int)opt >= EV_TCP_OPT_CNT)
+    {
+        return EV_EINVAL;
+    }
+    if ((ret = ev__tcp_opt_native(opt, &level, &name)) != 0)
+    {
+        return ret;
+    }
+
+    unsigned bit = 1u << opt;
+    if (sock->sock != EV_OS_SOCKET_INVALID && !(sock->opts.pending & bit))
+    {
+        return ev__tcp_getsockopt(sock->sock, level, name, val);
+    }
+    if (sock->opts.mask & bit)
+    {
+        *val = sock->opts.val[opt];
+        return 0;
+    }
+    return EV_EBADF;
+}
+
+static void _ev_tcp_info_hist_add(uint64_t *hist, uint64_t val)
+{
+    size_t idx = 0;
+    while (val != 0 && idx < EV_TCP_INFO_HIST_SIZE - 1)
+    {
+        val >>= 1;
+        idx++;
+    }
+    hist[idx]++;
+}
+
+static int _ev_tcp_info_on_walk(ev_handle_t *handle, void *arg)
+{
+    ev_tcp_info_t       info;
+    ev_tcp_info_stat_t *stat = arg;
+
+    if (handle->data.role != EV_ROLE_EV_TCP || ev__handle_is_closing(handle) ||
+        (handle->data.flags & EV_HANDLE_TCP_LISTING))
+    {
+        return 0;
+    }
+
+    ev_tcp_t *sock = EV_CONTAINER_OF(handle, ev_tcp_t, base);
+    if (sock->sock == EV_OS_SOCKET_INVALID || ev_tcp_get_info(sock, &info) != 0)
+    {
+        return 0;
+    }
+
+    stat->sock_cnt++;
+    _ev_tcp_info_hist_add(stat->rtt, info.rtt);
+    _ev_tcp_info_hist_add(stat->snd_cwnd, info.snd_cwnd);
+    _ev_tcp_info_hist_add(stat->total_retrans, info.total_retrans);
+    _ev_tcp_info_hist_add(stat->delivery_rate, info.delivery_rate);
+
+    return 0;
+}
+
+static void _ev_tcp_sampler_on_timer(ev_timer_t *timer, void *arg)
+{
+    ev_tcp_sampler_t *sampler = arg;
+
+    ev_tcp_info_collect(timer->base.loop, &sampler->stat);
+    sampler->cb(sampler, &sampler->stat, sampler->arg);
+}
+
+static void _ev_tcp_sampler_on_close(ev_timer_t *timer, void *arg)
+{
+    ev_tcp_sampler_t *sampler = arg;
+    ev__loop_free(timer->base.loop, sampler);
+}
+
+void ev_tcp_info_collect(ev_loop_t *loop, ev_tcp_info_stat_t *stat)
+{
+    memset(stat, 0, sizeof(*stat));
+    ev_loop_walk(loop, _ev_tcp_info_on_walk, stat);
+}
+
+int ev_tcp_sampler_init(ev_loop_t *loop, ev_tcp_sampler_t **sampler,
+                        uint64_t interval, ev_tcp_sampler_cb cb, void *arg)
+{
+    int               ret;
+    ev_tcp_sampler_t *new_sampler;
+
+    if (interval == 0)
+    {
+        return EV_EINVAL;
+    }
+
+    new_sampler = ev__loop_malloc(loop, EV_ALLOCATOR_TYPE_TCP,
+                                  sizeof(ev_tcp_sampler_t));
+    if (new_sampler == NULL)
+    {
+        return EV_ENOMEM;
+    }
+
+    if ((ret = ev_timer_init(loop, &new_sampler->timer)) != 0)
+    {
+        ev__loop_free(loop, new_sampler);
+        return ret;
+    }
+    new_sampler->cb = cb;
+    new_sampler->arg = arg;
+    memset(&new_sampler->stat, 0, sizeof(new_sampler->stat));
+
+    ev_timer_start(new_sampler->timer, interval, interval,
+                   _ev_tcp_sampler_on_timer, new_sampler);
+
+    *sampler = new_sampler;
+    return 0;
+}
+
+void ev_tcp_sampler_exit(ev_tcp_sampler_t *sampler)
+{
+    /* Memory is released once timer is closed */
+    ev_timer_exit(sampler->timer, _ev_tcp_sampler_on_close, sampler);
+}
@@ -0,0 +1,233 @@
+#ifndef __EV_TCP_INTERNAL_H__
+#define __EV_TCP_INTERNAL_H__
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Default number of connections accepted in one round by
+ *   #ev_tcp_accept_start().
+ */
+#define EV_TCP_ACCEPT_BUDGET    64
+
+/**
+ * @brief Number of #ev_tcp_opt_t.
+ */
+#define EV_TCP_OPT_CNT          9
+
+/**
+ * @brief Socket options of #ev_tcp_t.
+ */
+typedef struct ev_tcp_opts
+{
+    unsigned mask;                 /**< Bit set of options set by user */
+    unsigned pending;              /**< Bit set of options not applied yet */
+    int      val[EV_TCP_OPT_CNT];  /**< Option values */
+} ev_tcp_opts_t;
+
+/**
+ * @brief Handle recycling state for #ev_tcp_t.
+ *
+ * A connection handle uses #ev_tcp_recycle_t::owner and
+ * #ev_tcp_recycle_t::node, a listen socket uses the rest.
+ */
+typedef struct ev_tcp_recycle
+{
+    ev_tcp_t      *owner; /**< Listen socket this handle is returned to */
+    ev_list_node_t node;  /**< Node for #ev_tcp_recycle_t::idle_queue or
+                             #ev_tcp_recycle_t::busy_queue */
+
+    ev_list_t idle_queue; /**< (#ev_tcp_recycle_t::node) Closed handles */
+    ev_list_t busy_queue; /**< (#ev_tcp_recycle_t::node) Handles in use */
+    size_t    capacity;   /**< Max size of idle_queue */
+} ev_tcp_recycle_t;
+
+/**
+ * @brief Acquire request of #ev_tcp_pool_acquire().
+ */
+typedef struct ev_tcp_pool_req
+{
+    ev_list_node_t node; /**< Node for #ev_tcp_pool_host_t::wait_queue or
+                            #ev_tcp_pool::cancel_queue */
+    ev_tcp_pool_cb cb;   /**< Acquire callback */
+    void          *arg;  /**< User defined argument */
+    int            stat; /**< Failure to report */
+} ev_tcp_pool_req_t;
+
+/**
+ * @brief State of pooled connection.
+ */
+typedef enum ev_tcp_pool_state
+{
+    EV_TCP_POOL_BUSY = 0,   /**< Handed out to user */
+    EV_TCP_POOL_CONNECTING, /**< Connecting for an acquire */
+    EV_TCP_POOL_READY,      /**< Waiting to be handed out */
+    EV_TCP_POOL_IDLE,       /**< Kept in pool */
+} ev_tcp_pool_state_t;
+
+/**
+ * @brief Connection pool state for #ev_tcp_t.
+ */
+typedef struct ev_tcp_pool_link
+{
+    struct ev_tcp_pool_host *host;  /**< Owner, NULL if not from a pool */
+    ev_tcp_pool_state_t      state; /**< Connection state */
+    ev_list_node_t           node;  /**< Node for
+                                       #ev_tcp_pool_host_t::idle_queue or
+                                       #ev_tcp_pool_host_t::busy_queue */
+    ev_list_node_t           rnode; /**< Node for #ev_tcp_pool::ready_queue */
+    uint64_t                 since; /**< Time in milliseconds it becomes idle */
+    ev_tcp_pool_req_t       *req;   /**< Acquire to finish, if connecting or
+                                       ready */
+} ev_tcp_pool_link_t;
+
+/**
+ * @brief Connections to one peer address.
+ */
+typedef struct ev_tcp_pool_host
+{
+    ev_map_node_t           node;    /**< Node for #ev_tcp_pool::hosts */
+    struct ev_tcp_pool     *pool;    /**< Pool */
+    struct sockaddr_storage addr;    /**< Peer address */
+    size_t                  addr_sz; /**< Peer address size */
+
+    ev_list_t idle_queue; /**< (#ev_tcp_pool_link_t::node) Idle connections,
+                             newest at back */
+    ev_list_t busy_queue; /**< (#ev_tcp_pool_link_t::node) Connections not
+                             idle */
+    ev_list_t wait_queue; /**< (#ev_tcp_pool_req_t::node) Acquires waiting
+                             for a free slot */
+} ev_tcp_pool_host_t;
+
+struct ev_tcp_pool
+{
+    ev_loop_t         *loop;     /**< Event loop */
+    ev_tcp_pool_opts_t opts;     /**< Options */
+    ev_map_t           hosts;    /**< (#ev_tcp_pool_host_t::node) Hosts */
+    size_t             idle_cnt; /**< Idle connections of all hosts */
+    int                closing;  /**< #ev_tcp_pool_exit() is called */
+    int                timer_cnt; /**< Timers not closed yet */
+
+    ev_list_t ready_queue;  /**< (#ev_tcp_pool_link_t::rnode) Connections to
+                               hand out */
+    ev_list_t cancel_queue; /**< (#ev_tcp_pool_req_t::node) Acquires to
+                               cancel once the pool is closed */
+
+    ev_timer_t *ready_timer; /**< Hands out ready connections */
+    ev_timer_t *idle_timer;  /**< Closes expired idle connections */
+};
+
+struct ev_tcp_sampler
+{
+    ev_timer_t        *timer; /**< Sample timer */
+    ev_tcp_sampler_cb  cb;    /**< Sampler callback */
+    void              *arg;   /**< User defined argument. */
+    ev_tcp_info_stat_t stat;  /**< Statistics of last round */
+};
+
+/**
+ * @brief Reset \p sock and link it to \p loop.
+ * @note Platform related.
+ * @param[in] loop  Event loop
+ * @param[in] sock  TCP handle
+ */
+EV_LOCAL void ev__tcp_init(ev_loop_t *loop, ev_tcp_t *sock);
+
+/**
+ * @brief Get native level and name of socket option.
+ * @note Platform related.
+ * @param[in] opt       Option
+ * @param[out] level    Option level
+ * @param[out] name     Option name
+ * @return              #ev_errno_t. #EV_ENOSYS if not supported.
+ */
+EV_LOCAL int ev__tcp_opt_native(ev_tcp_opt_t opt, int *level, int *name);
+
+/**
+ * @brief Set int socket option.
+ * @note Platform related.
+ * @return  #ev_errno_t
+ */
+EV_LOCAL int ev__tcp_setsockopt(ev_os_socket_t sock, int level, int name,
+                                int val);
+
+/**
+ * @brief Get int socket option.
+ * @note Platform related.
+ * @return  #ev_errno_t
+ */
+EV_LOCAL int ev__tcp_getsockopt(ev_os_socket_t sock, int level, int name,
+                                int *val);
+
+/**
+ * @brief Check whether an idle connection is still usable.
+ * @note Platform related.
+ * @param[in] sock  Connected socket
+ * @return          #EV_SUCCESS if nothing is received, #EV_EOF if peer closed
+ *                  the connection, #EV_EPROTO if data is received, or
+ *                  #ev_errno_t.
+ */
+EV_LOCAL int ev__tcp_probe(ev_os_socket_t sock);
+
+/**
+ * @brief Initialize socket options.
+ * @param[in] sock  TCP handle
+ */
+EV_LOCAL void ev__tcp_opts_init(ev_tcp_t *sock);
+
+/**
+ * @brief Apply pending socket options.
+ * @param[in] sock      TCP handle with valid socket.
+ * @param[in] listen    Non-zero to apply listen socket only options.
+ * @return              #ev_errno_t
+ */
+EV_LOCAL int ev__tcp_opts_apply(ev_tcp_t *sock, int listen);
+
+/**
+ * @brief Give socket options of listen socket to accepted connection.
+ *
+ * Errors are ignored as the options are known good on \p lisn.
+ *
+ * @param[in] conn      Accepted connection.
+ * @param[in] lisn      Listen socket.
+ * @param[in] by_kernel Non-zero if the kernel already copied options that it
+ *                      can inherit.
+ */
+EV_LOCAL void ev__tcp_opts_inherit(ev_tcp_t *conn, ev_tcp_t *lisn,
+                                   int by_kernel);
+
+/**
+ * @brief Initialize recycling state.
+ * @param[in] sock  TCP handle
+ */
+EV_LOCAL void ev__tcp_recycle_init(ev_tcp_t *sock);
+
+/**
+ * @brief Give closed handle back to its listen socket.
+ * @param[in] sock  TCP handle that has finished closing.
+ * @return          Non-zero if \p sock is taken and must not be freed.
+ */
+EV_LOCAL int ev__tcp_recycle(ev_tcp_t *sock);
+
+/**
+ * @brief Initialize connection pool state.
+ * @param[in] sock  TCP handle
+ */
+EV_LOCAL void ev__tcp_pool_link_init(ev_tcp_t *sock);
+
+/**
+ * @brief Remove closed handle from its connection pool.
+ * @param[in] sock  TCP handle that has finished closing.
+ */
+EV_LOCAL void ev__tcp_pool_unlink(ev_tcp_t *sock);
+
+/**
+ * @brief Release all kept handles and detach handles in use.
+ * @param[in] lisn  Listen socket that has finished closing.
+ */
+EV_LOCAL void ev__tcp_recycle_exit(ev_tcp_t *lisn);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,494 @@
+static int _ev_tcp_pool_cmp_host(const ev_map_node_t *key1,
+                                 const ev_map_node_t *key2, void *arg)
+{
+    (void)arg;
+    ev_tcp_pool_host_t *host1 = EV_CONTAINER_OF(key1, ev_tcp_pool_host_t, node);
+    ev_tcp_pool_host_t *host2 = EV_CONTAINER_OF(key2, ev_tcp_pool_host_t, node);
+
+    if (host1->addr_sz != host2->addr_sz)
+    {
+        return host1->addr_sz < host2->addr_sz ? -1 : 1;
+    }
+    return memcmp(&host1->addr, &host2->addr, host1->addr_sz);
+}
+
+static ev_tcp_pool_host_t *_ev_tcp_pool_find_host(ev_tcp_pool_t         *pool,
+                                                  const struct sockaddr *addr,
+                                                  size_t                 size)
+{
+    ev_tcp_pool_host_t key;
+    memcpy(&key.addr, addr, size);
+    key.addr_sz = size;
+
+    ev_map_node_t *it = ev_map_find(&pool->hosts, &key.node);
+    if (it != NULL)
+    {
+        return EV_CONTAINER_OF(it, ev_tcp_pool_host_t, node);
+    }
+
+    ev_tcp_pool_host_t *host = ev__loop_malloc(
+        pool->loop, EV_ALLOCATOR_TYPE_TCP, sizeof(ev_tcp_pool_host_t));
+    if (host == NULL)
+    {
+        return NULL;
+    }
+
+    host->pool = pool;
+    memcpy(&host->addr, addr, size);
+    host->addr_sz = size;
+    ev_list_init(&host->idle_queue);
+    ev_list_init(&host->busy_queue);
+    ev_list_init(&host->wait_queue);
+    ev_map_insert(&pool->hosts, &host->node);
+
+    return host;
+}
+
+/**
+ * @brief Free \p host once it has no connection and no waiting acquire.
+ */
+static void _ev_tcp_pool_put_host(ev_tcp_pool_host_t *host)
+{
+    ev_tcp_pool_t *pool = host->pool;
+    if (ev_list_size(&host->idle_queue) != 0 ||
+        ev_list_size(&host->busy_queue) != 0 ||
+        ev_list_size(&host->wait_queue) != 0)
+    {
+        return;
+    }
+
+    ev_map_erase(&pool->hosts, &host->node);
+    ev__loop_free(pool->loop, host);
+}
+
+static size_t _ev_tcp_pool_host_size(ev_tcp_pool_host_t *host)
+{
+    return ev_list_size(&host->idle_queue) + ev_list_size(&host->busy_queue);
+}
+
+static int _ev_tcp_pool_host_full(ev_tcp_pool_host_t *host)
+{
+    size_t max_per_host = host->pool->opts.max_per_host;
+    return max_per_host != 0 && _ev_tcp_pool_host_size(host) >= max_per_host;
+}
+
+/**
+ * @brief Finish acquire \p req with \p sock.
+ */
+static void _ev_tcp_pool_finish(ev_tcp_pool_t *pool, ev_tcp_pool_req_t *req,
+                                ev_tcp_t *sock, int stat)
+{
+    ev_tcp_pool_cb cb = req->cb;
+    void          *arg = req->arg;
+    ev__loop_free(pool->loop, req);
+    cb(pool, sock, stat, arg);
+}
+
+static void _ev_tcp_pool_on_ready(ev_timer_t *timer, void *arg)
+{
+    (void)timer;
+    ev_list_node_t *it;
+    ev_tcp_pool_t  *pool = arg;
+
+    /* Callback may destroy the pool */
+    while (!pool->closing && (it = ev_list_pop_front(&pool->ready_queue)) != NULL)
+    {
+        ev_tcp_t          *sock = EV_CONTAINER_OF(it, ev_tcp_t, pool.rnode);
+        ev_tcp_pool_req_t *req = sock->pool.req;
+        sock->pool.state = EV_TCP_POOL_BUSY;
+        sock->pool.req = NULL;
+        _ev_tcp_pool_finish(pool, req, sock, 0);
+    }
+}
+
+/**
+ * @brief Hand \p sock out on next loop iteration.
+ */
+static void _ev_tcp_pool_dispatch(ev_tcp_pool_t *pool, ev_tcp_t *sock,
+                                  ev_tcp_pool_req_t *req)
+{
+    sock->pool.state = EV_TCP_POOL_READY;
+    sock->pool.req = req;
+    ev_list_push_back(&pool->ready_queue, &sock->pool.rnode);
+    ev_timer_start(pool->ready_timer, 0, 0, _ev_tcp_pool_on_ready, pool);
+}
+
+static void _ev_tcp_pool_on_connect(ev_tcp_t *sock, int stat, void *arg)
+{
+    (void)arg;
+    ev_tcp_pool_host_t *host = sock->pool.host;
+    ev_tcp_pool_req_t  *req = sock->pool.req;
+
+    /* Pool is destroyed, acquire is canceled by pool */
+    if (host == NULL)
+    {
+        return;
+    }
+
+    if (stat != 0)
+    {
+        sock->pool.state = EV_TCP_POOL_BUSY;
+        sock->pool.req = NULL;
+        if (!(sock->base.data.flags & EV_HANDLE_CLOSING))
+        {
+            ev_tcp_exit(sock, NULL, NULL);
+        }
+        _ev_tcp_pool_finish(host->pool, req, NULL, stat);
+        return;
+    }
+
+    /*
+     * The handle is still active inside connect callback, defer it so user
+     * is able to release it back immediately.
+     */
+    _ev_tcp_pool_dispatch(host->pool, sock, req);
+}
+
+static int _ev_tcp_pool_connect(ev_tcp_pool_host_t *host,
+                                ev_tcp_pool_req_t  *req)
+{
+    int       ret;
+    ev_tcp_t *sock;
+    if ((ret = ev_tcp_init(host->pool->loop, &sock)) != 0)
+    {
+        return ret;
+    }
+
+    ret = ev_tcp_connect(sock, (struct sockaddr *)&host->addr, host->addr_sz,
+                         _ev_tcp_pool_on_connect, NULL);
+    if (ret != 0)
+    {
+        ev_tcp_exit(sock, NULL, NULL);
+        return ret;
+    }
+
+    sock->pool.host = host;
+    sock->pool.state = EV_TCP_POOL_CONNECTING;
+    sock->pool.req = req;
+    ev_list_push_back(&host->busy_queue, &sock->pool.node);
+
+    return 0;
+}
+
+/**
+ * @brief Start connecting for waiting acquires while there are free slots.
+ *
+ * \p host is freed if it ends up empty, and failed acquires are finished
+ * after that, as their callbacks may acquire or close the pool again.
+ */
+static void _ev_tcp_pool_promote(ev_tcp_pool_host_t *host)
+{
+    ev_list_node_t *it;
+    ev_tcp_pool_t  *pool = host->pool;
+    ev_list_t       failed = EV_LIST_INIT;
+
+    while (!_ev_tcp_pool_host_full(host) &&
+           (it = ev_list_pop_front(&host->wait_queue)) != NULL)
+    {
+        ev_tcp_pool_req_t *req = EV_CONTAINER_OF(it, ev_tcp_pool_req_t, node);
+        if ((req->stat = _ev_tcp_pool_connect(host, req)) != 0)
+        {
+            ev_list_push_back(&failed, &req->node);
+        }
+    }
+    _ev_tcp_pool_put_host(host);
+
+    while ((it = ev_list_pop_front(&failed)) != NULL)
+    {
+        ev_tcp_pool_req_t *req = EV_CONTAINER_OF(it, ev_tcp_pool_req_t, node);
+        _ev_tcp_pool_finish(pool, req, NULL, req->stat);
+    }
+}
+
+/**
+ * @brief Close connection that is not idle any more.
+ *
+ * It stays in busy queue until closed, so it still holds a slot.
+ */
+static void _ev_tcp_pool_evict(ev_tcp_t *sock)
+{
+    ev_tcp_pool_host_t *host = sock->pool.host;
+
+    if (sock->pool.state == EV_TCP_POOL_IDLE)
+    {
+        ev_list_erase(&host->idle_queue, &sock->pool.node);
+        ev_list_push_back(&host->busy_queue, &sock->pool.node);
+        sock->pool.state = EV_TCP_POOL_BUSY;
+        host->pool->idle_cnt--;
+    }
+    ev_tcp_exit(sock, NULL, NULL);
+}
+
+static void _ev_tcp_pool_on_idle(ev_timer_t *timer, void *arg)
+{
+    ev_tcp_pool_t  *pool = arg;
+    uint64_t        now = pool->loop->hwtime;
+    ev_map_node_t  *it = ev_map_begin(&pool->hosts);
+    ev_list_node_t *node, *next;
+
+    for (; it != NULL; it = ev_map_next(it))
+    {
+        ev_tcp_pool_host_t *host = EV_CONTAINER_OF(it, ev_tcp_pool_host_t, node);
+        for (node = ev_list_begin(&host->idle_queue); node != NULL; node = next)
+        {
+            next = ev_list_next(node);
+            ev_tcp_t *sock = EV_CONTAINER_OF(node, ev_tcp_t, pool.node);
+            if (now - sock->pool.since >= pool->opts.idle_timeout ||
+                ev__tcp_probe(sock->sock) != 0)
+            {
+                _ev_tcp_pool_evict(sock);
+            }
+        }
+    }
+
+    if (pool->idle_cnt == 0)
+    {
+        ev_timer_stop(timer);
+    }
+}
+
+static void _ev_tcp_pool_on_timer_close(ev_timer_t *timer, void *arg)
+{
+    (void)timer;
+    ev_list_node_t *it;
+    ev_tcp_pool_t  *pool = arg;
+
+    if (--pool->timer_cnt != 0)
+    {
+        return;
+    }
+
+    while ((it = ev_list_pop_front(&pool->cancel_queue)) != NULL)
+    {
+        ev_tcp_pool_req_t *req = EV_CONTAINER_OF(it, ev_tcp_pool_req_t, node);
+        _ev_tcp_pool_finish(pool, req, NULL, EV_ECANCELED);
+    }
+
+    ev__loop_free(pool->loop, pool);
+}
+
+static void _ev_tcp_pool_exit_host(ev_tcp_pool_t *pool, ev_tcp_pool_host_t *host)
+{
+    ev_list_node_t *it;
+
+    while ((it = ev_list_pop_front(&host->idle_queue)) != NULL)
+    {
+        ev_tcp_t *sock = EV_CONTAINER_OF(it, ev_tcp_t, pool.node);
+        sock->pool.host = NULL;
+        ev_tcp_exit(sock, NULL, NULL);
+    }
+
+    while ((it = ev_list_pop_front(&host->busy_queue)) != NULL)
+    {
+        ev_tcp_t *sock = EV_CONTAINER_OF(it, ev_tcp_t, pool.node);
+        sock->pool.host = NULL;
+
+        /* Connections in use are detached */
+        if (sock->pool.state == EV_TCP_POOL_BUSY)
+        {
+            continue;
+        }
+
+        if (sock->pool.state == EV_TCP_POOL_READY)
+        {
+            ev_list_erase(&pool->ready_queue, &sock->pool.rnode);
+        }
+        ev_list_push_back(&pool->cancel_queue, &sock->pool.req->node);
+        sock->pool.req = NULL;
+        ev_tcp_exit(sock, NULL, NULL);
+    }
+
+    ev_list_migrate(&pool->cancel_queue, &host->wait_queue);
+}
+
+EV_LOCAL void ev__tcp_pool_link_init(ev_tcp_t *sock)
+{
+    sock->pool.host = NULL;
+    sock->pool.state = EV_TCP_POOL_BUSY;
+    sock->pool.node = (ev_list_node_t)EV_LIST_NODE_INIT;
+    sock->pool.rnode = (ev_list_node_t)EV_LIST_NODE_INIT;
+    sock->pool.since = 0;
+    sock->pool.req = NULL;
+}
+
+EV_LOCAL void ev__tcp_pool_unlink(ev_tcp_t *sock)
+{
+    ev_tcp_pool_host_t *host = sock->pool.host;
+    if (host == NULL)
+    {
+        return;
+    }
+    sock->pool.host = NULL;
+
+    if (sock->pool.state == EV_TCP_POOL_IDLE)
+    {
+        ev_list_erase(&host->idle_queue, &sock->pool.node);
+        host->pool->idle_cnt--;
+    }
+    else
+    {
+        ev_list_erase(&host->busy_queue, &sock->pool.node);
+    }
+
+    /* A slot is free now */
+    _ev_tcp_pool_promote(host);
+}
+
+int ev_tcp_pool_init(ev_loop_t *loop, ev_tcp_pool_t **pool,
+                     const ev_tcp_pool_opts_t *opts)
+{
+    int            ret;
+    ev_tcp_pool_t *new_pool =
+        ev__loop_malloc(loop, EV_ALLOCATOR_TYPE_TCP, sizeof(ev_tcp_pool_t));
+    if (new_pool == NULL)
+    {
+        return EV_ENOMEM;
+    }
+
+    new_pool->loop = loop;
+    new_pool->opts = *opts;
+    ev_map_init(&new_pool->hosts, _ev_tcp_pool_cmp_host, NULL);
+    new_pool->idle_cnt = 0;
+    new_pool->closing = 0;
+    new_pool->timer_cnt = 2;
+    ev_list_init(&new_pool->ready_queue);
+    ev_list_init(&new_pool->cancel_queue);
+
+    if ((ret = ev_timer_init(loop, &new_pool->ready_timer)) != 0)
+    {
+        ev__loop_free(loop, new_pool);
+        return ret;
+    }
+    if ((ret = ev_timer_init(loop, &new_pool->idle_timer)) != 0)
+    {
+        new_pool->timer_cnt = 1;
+        ev_timer_exit(new_pool->ready_timer, _ev_tcp_pool_on_timer_close,
+                      new_pool);
+        return ret;
+    }
+
+    *pool = new_pool;
+    return 0;
+}
+
+void ev_tcp_pool_exit(ev_tcp_pool_t *pool)
+{
+    ev_map_node_t *it;
+
+    pool->closing = 1;
+    while ((it = ev_map_begin(&pool->hosts)) != NULL)
+    {
+        ev_tcp_pool_host_t *host = EV_CONTAINER_OF(it, ev_tcp_pool_host_t, node);
+        ev_map_erase(&pool->hosts, it);
+        _ev_tcp_pool_exit_host(pool, host);
+        ev__loop_free(pool->loop, host);
+    }
+    pool->idle_cnt = 0;
+
+    /* Pool is released once both timers are closed */
+    ev_timer_exit(pool->ready_timer, _ev_tcp_pool_on_timer_close, pool);
+    ev_timer_exit(pool->idle_timer, _ev_tcp_pool_on_timer_close, pool);
+}
+
+int ev_tcp_pool_acquire(ev_tcp_pool_t *pool, const struct sockaddr *addr,
+                        size_t size, ev_tcp_pool_cb cb, void *arg)
+{
+    int             ret;
+    ev_list_node_t *it;
+    if (pool->closing)
+    {
+        return EV_EBADF;
+    }
+    if (size > sizeof(struct sockaddr_storage))
+    {
+        return EV_EINVAL;
+    }
+
+    ev_tcp_pool_host_t *host = _ev_tcp_pool_find_host(pool, addr, size);
+    if (host == NULL)
+    {
+        return EV_ENOMEM;
+    }
+
+    ev_tcp_pool_req_t *req = ev__loop_malloc(pool->loop, EV_ALLOCATOR_TYPE_TCP,
+                                             sizeof(ev_tcp_pool_req_t));
+    if (req == NULL)
+    {
+        _ev_tcp_pool_put_host(host);
+        return EV_ENOMEM;
+    }
+    req->cb = cb;
+    req->arg = arg;
+
+    /* Newest connection is the least likely to be closed by peer */
+    while ((it = ev_list_end(&host->idle_queue)) != NULL)
+    {
+        ev_tcp_t *sock = EV_CONTAINER_OF(it, ev_tcp_t, pool.node);
+        if (ev__tcp_probe(sock->sock) != 0)
+        {
+            _ev_tcp_pool_evict(sock);
+            continue;
+        }
+
+        ev_list_erase(&host->idle_queue, it);
+        ev_list_push_back(&host->busy_queue, it);
+        pool->idle_cnt--;
+        _ev_tcp_pool_dispatch(pool, sock, req);
+        return 0;
+    }
+
+    if (_ev_tcp_pool_host_full(host))
+    {
+        ev_list_push_back(&host->wait_queue, &req->node);
+        return 0;
+    }
+
+    if ((ret = _ev_tcp_pool_connect(host, req)) != 0)
+    {
+        ev__loop_free(pool->loop, req);
+        _ev_tcp_pool_put_host(host);
+    }
+    return ret;
+}
+
+void ev_tcp_pool_release(ev_tcp_pool_t *pool, ev_tcp_t *sock, int reuse)
+{
+    ev_list_node_t     *it;
+    ev_tcp_pool_host_t *host = sock->pool.host;
+
+    if (host == NULL || host->pool != pool || !reuse ||
+        ev__handle_is_active(&sock->base) || ev__tcp_probe(sock->sock) != 0)
+    {
+        ev_tcp_exit(sock, NULL, NULL);
+        return;
+    }
+
+    /* Hand over to waiting acquire directly */
+    if ((it = ev_list_pop_front(&host->wait_queue)) != NULL)
+    {
+        _ev_tcp_pool_dispatch(
+            pool, sock, EV_CONTAINER_OF(it, ev_tcp_pool_req_t, node));
+        return;
+    }
+
+    if (ev_list_size(&host->idle_queue) >= pool->opts.max_idle)
+    {
+        ev_tcp_exit(sock, NULL, NULL);
+        return;
+    }
+
+    ev_list_erase(&host->busy_queue, &sock->pool.node);
+    ev_list_push_back(&host->idle_queue, &sock->pool.node);
+    sock->pool.state = EV_TCP_POOL_IDLE;
+    sock->pool.since = pool->loop->hwtime;
+    pool->idle_cnt++;
+
+    if (pool->opts.idle_timeout != 0 &&
+        !ev__handle_is_active(&pool->idle_timer->base))
+    {
+        /* Connections live at most 1.5 times of idle timeout */
+        uint64_t tick = pool->opts.idle_timeout / 2 + 1;
+        ev_timer_start(pool->idle_timer, tick, tick, _ev_tcp_pool_on_idle,
+                       pool);
+    }
+}
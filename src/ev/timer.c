@@ -1,119 +1,278 @@
-#include <string.h>
-
-static int _ev_cmp_timer(const ev_map_node_t *key1, const ev_map_node_t *key2,
-                         void *arg)
-{
-    (void)arg;
-    ev_timer_t *t1 = EV_CONTAINER_OF(key1, ev_timer_t, node);
-    ev_timer_t *t2 = EV_CONTAINER_OF(key2, ev_timer_t, node);
-
-    if (t1->data.active == t2->data.active)
-    {
-        if (t1 == t2)
-        {
-            return 0;
-        }
-        return t1 < t2 ? -1 : 1;
-    }
-
-    return t1->data.active < t2->data.active ? -1 : 1;
-}
-
-static void _ev_timer_on_close(ev_handle_t *handle)
-{
-    ev_timer_t *timer = EV_CONTAINER_OF(handle, ev_timer_t, base);
-    if (timer->close_cb != NULL)
-    {
-        timer->close_cb(timer, timer->close_arg);
-    }
-    ev_free(timer);
-}
-
-EV_LOCAL void ev__init_timer(ev_loop_t *loop)
-{
-    ev_map_init(&loop->timer.heap, _ev_cmp_timer, NULL);
-}
-
-EV_LOCAL size_t ev__process_timer(ev_loop_t *loop)
-{
-    ev_map_node_t *it;
-    size_t         counter = 0;
-
-    while ((it = ev_map_begin(&loop->timer.heap)) != NULL)
-    {
-        ev_timer_t *timer = EV_CONTAINER_OF(it, ev_timer_t, node);
-        if (timer->data.active > loop->hwtime)
-        {
-            break;
-        }
-
-        ev_timer_stop(timer);
-        if (timer->attr.repeat != 0)
-        {
-            ev_timer_start(timer, timer->attr.repeat, timer->attr.repeat,
-                           timer->attr.cb, timer->attr.arg);
-        }
-        timer->attr.cb(timer, timer->attr.arg);
-        counter++;
-    }
-
-    return counter;
-}
-
-int ev_timer_init(ev_loop_t *loop, ev_timer_t **handle)
-{
-    ev_timer_t *new_timer = ev_calloc(1, sizeof(ev_timer_t));
-    if (new_timer == NULL)
-    {
-        return EV_ENOMEM;
-    }
-
-    memset(new_timer, 0, sizeof(*new_timer));
-    ev__handle_init(loop, &new_timer->base, EV_ROLE_EV_TIMER);
-
-    *handle = new_timer;
-    return 0;
-}
-
-void ev_timer_exit(ev_timer_t *handle, ev_timer_cb cb, void *arg)
-{
-    handle->close_cb = cb;
-    handle->close_arg = arg;
-    ev_timer_stop(handle);
-    ev__handle_exit(&handle->base, _ev_timer_on_close);
-}
-
-int ev_timer_start(ev_timer_t *handle, uint64_t timeout, uint64_t repeat,
-                   ev_timer_cb cb, void *arg)
-{
-    ev_loop_t *loop = handle->base.loop;
-    if (ev__handle_is_active(&handle->base))
-    {
-        ev_timer_stop(handle);
-    }
-
-    handle->attr.cb = cb;
-    handle->attr.arg = arg;
-    handle->attr.timeout = timeout;
-    handle->attr.repeat = repeat;
-    handle->data.active = loop->hwtime + timeout;
-
-    if (ev_map_insert(&loop->timer.heap, &handle->node) != 0)
-    {
-        EV_ABORT("duplicate timer");
-    }
-    ev__handle_active(&handle->base);
-
-    return 0;
-}
-
-void ev_timer_stop(ev_timer_t *handle)
-{
-    if (!ev__handle_is_active(&handle->base))
-    {
-        return;
-    }
-
-    ev__handle_deactive(&handle->base);
-    ev_map_erase(&handle->base.loop->timer.heap, &handle->node);
-}
+#include <string.h>
+
+static int _ev_cmp_timer(const ev_map_node_t *key1, const ev_map_node_t *key2,
+                         void *arg)
+{
+    (void)arg;
+    ev_timer_t *t1 = EV_CONTAINER_OF(key1, ev_timer_t, node);
+    ev_timer_t *t2 = EV_CONTAINER_OF(key2, ev_timer_t, node);
+
+    if (t1->data.active == t2->data.active)
+    {
+        if (t1 == t2)
+        {
+            return 0;
+        }
+        return t1 < t2 ? -1 : 1;
+    }
+
+    return t1->data.active < t2->data.active ? -1 : 1;
+}
+
+static void _ev_timer_on_close(ev_handle_t *handle)
+{
+    ev_timer_t *timer = EV_CONTAINER_OF(handle, ev_timer_t, base);
+    /* Caller owned memory may be released in close callback */
+    int         inplace = timer->base.data.flags & EV_HANDLE_INPLACE;
+    ev_loop_t  *loop = timer->base.loop;
+    if (timer->close_cb != NULL)
+    {
+        timer->close_cb(timer, timer->close_arg);
+    }
+    if (!inplace)
+    {
+        ev__loop_free(loop, timer);
+    }
+}
+
+EV_LOCAL void ev__init_timer(ev_loop_t *loop)
+{
+    ev_map_init(&loop->timer.heap, _ev_cmp_timer, NULL);
+}
+
+EV_LOCAL size_t ev__process_timer(ev_loop_t *loop)
+{
+    ev_map_node_t *it;
+    size_t         counter = 0;
+
+    while ((it = ev_map_begin(&loop->timer.heap)) != NULL)
+    {
+        ev_timer_t *timer = EV_CONTAINER_OF(it, ev_timer_t, node);
+        if (timer->data.active > loop->hwtime)
+        {
+            break;
+        }
+
+        ev_timer_stop(timer);
+        if (timer->attr.repeat != 0)
+        {
+            ev_timer_start(timer, timer->attr.repeat, timer->attr.repeat,
+                           timer->attr.cb, timer->attr.arg);
+        }
+        timer->attr.cb(timer, timer->attr.arg);
+        counter++;
+    }
+
+    return counter;
+}
+
+int ev_timer_init(ev_loop_t *loop, ev_timer_t **handle)
+{
+    ev_timer_t *new_timer = ev__loop_calloc(loop, EV_ALLOCATOR_TYPE_TIMER, 1,
+                                            sizeof(ev_timer_t));
+    if (new_timer == NULL)
+    {
+        return EV_ENOMEM;
+    }
+
+    memset(new_timer, 0, sizeof(*new_timer));
+    ev__handle_init(loop, &new_timer->base, EV_ROLE_EV_TIMER);
+
+    *handle = new_timer;
+    return 0;
+}
+
+size_t ev_timer_size(void)
+{
+    return sizeof(ev_timer_t);
+}
+
+int ev_timer_init_inplace(ev_loop_t *loop, ev_timer_t **handle, void *mem)
+{
+    ev_timer_t *new_timer = mem;
+
+    memset(new_timer, 0, sizeof(*new_timer));
+    ev__handle_init(loop, &new_timer->base, EV_ROLE_EV_TIMER);
+    new_timer->base.data.flags |= EV_HANDLE_INPLACE;
+
+    *handle = new_timer;
+    return 0;
+}
+
+void ev_timer_exit(ev_timer_t *handle, ev_timer_cb cb, void *arg)
+{
+    handle->close_cb = cb;
+    handle->close_arg = arg;
+    ev_timer_stop(handle);
+    ev__handle_exit(&handle->base, _ev_timer_on_close);
+}
+
+int ev_timer_start(ev_timer_t *handle, uint64_t timeout, uint64_t repeat,
+                   ev_timer_cb cb, void *arg)
+{
+    ev_loop_t *loop = handle->base.loop;
+    if (ev__handle_is_active(&handle->base))
+    {
+        ev_timer_stop(handle);
+    }
+
+    handle->attr.cb = cb;
+    handle->attr.arg = arg;
+    handle->attr.timeout = timeout;
+    handle->attr.repeat = repeat;
+    handle->data.active = loop->hwtime + timeout;
+
+    if (ev_map_insert(&loop->timer.heap, &handle->node) != 0)
+    {
+        EV_ABORT("duplicate timer");
+    }
+    ev__handle_active(&handle->base);
+
+    return 0;
+}
+
+void ev_timer_stop(ev_timer_t *handle)
+{
+    if (!ev__handle_is_active(&handle->base))
+    {
+        return;
+    }
+
+    ev__handle_deactive(&handle->base);
+    ev_map_erase(&handle->base.loop->timer.heap, &handle->node);
+}
+
+static void _ev_idle_timer_detach(ev_idle_token_t *token)
+{
+    ev_list_erase(&token->owner->queue, &token->node);
+    token->owner = NULL;
+}
+
+static void _ev_idle_timer_on_timer(ev_timer_t *timer, void *arg)
+{
+    (void)timer;
+    ev_list_node_t  *it;
+    ev_idle_timer_t *handle = arg;
+    uint64_t         now = handle->timer.base.loop->hwtime;
+
+    /* Callback may destroy the manager */
+    while (!handle->closing && (it = ev_list_begin(&handle->queue)) != NULL)
+    {
+        ev_idle_token_t *token = EV_CONTAINER_OF(it, ev_idle_token_t, node);
+        if (token->last + handle->timeout > now)
+        {
+            break;
+        }
+
+        _ev_idle_timer_detach(token);
+        token->cb(token, token->arg);
+    }
+
+    if (handle->closing || (it = ev_list_begin(&handle->queue)) == NULL)
+    {
+        return;
+    }
+
+    /* Wake up when the least recently active token expires */
+    ev_idle_token_t *token = EV_CONTAINER_OF(it, ev_idle_token_t, node);
+    uint64_t         deadline = token->last + handle->timeout;
+    ev_timer_start(&handle->timer, deadline > now ? deadline - now : 0, 0,
+                   _ev_idle_timer_on_timer, handle);
+}
+
+static void _ev_idle_timer_on_close(ev_timer_t *timer, void *arg)
+{
+    (void)timer;
+    ev_idle_timer_t *handle = arg;
+    ev__loop_free(handle->timer.base.loop, handle);
+}
+
+int ev_idle_timer_init(ev_loop_t *loop, ev_idle_timer_t **handle,
+                       uint64_t timeout)
+{
+    ev_timer_t      *timer;
+    if (timeout == 0)
+    {
+        return EV_EINVAL;
+    }
+
+    ev_idle_timer_t *new_handle =
+        ev__loop_malloc(loop, EV_ALLOCATOR_TYPE_TIMER, sizeof(ev_idle_timer_t));
+    if (new_handle == NULL)
+    {
+        return EV_ENOMEM;
+    }
+
+    ev_timer_init_inplace(loop, &timer, &new_handle->timer);
+    ev_list_init(&new_handle->queue);
+    new_handle->timeout = timeout;
+    new_handle->closing = 0;
+
+    *handle = new_handle;
+    return 0;
+}
+
+void ev_idle_timer_exit(ev_idle_timer_t *handle)
+{
+    ev_list_node_t *it;
+
+    handle->closing = 1;
+    while ((it = ev_list_begin(&handle->queue)) != NULL)
+    {
+        _ev_idle_timer_detach(EV_CONTAINER_OF(it, ev_idle_token_t, node));
+    }
+
+    /* Memory is released once timer is closed */
+    ev_timer_exit(&handle->timer, _ev_idle_timer_on_close, handle);
+}
+
+void ev_idle_timer_add(ev_idle_timer_t *handle, ev_idle_token_t *token,
+                       ev_idle_cb cb, void *arg)
+{
+    if (token->owner != NULL)
+    {
+        ev_idle_timer_remove(token);
+    }
+
+    token->owner = handle;
+    token->cb = cb;
+    token->arg = arg;
+    token->last = handle->timer.base.loop->hwtime;
+    ev_list_push_back(&handle->queue, &token->node);
+
+    /* Older tokens expire first, so the timer only starts for the first one */
+    if (!ev__handle_is_active(&handle->timer.base))
+    {
+        ev_timer_start(&handle->timer, handle->timeout, 0,
+                       _ev_idle_timer_on_timer, handle);
+    }
+}
+
+void ev_idle_timer_touch(ev_idle_token_t *token)
+{
+    ev_idle_timer_t *handle = token->owner;
+    if (handle == NULL)
+    {
+        return;
+    }
+
+    /* Timer is left as is, it reschedules itself when fired */
+    token->last = handle->timer.base.loop->hwtime;
+    ev_list_erase(&handle->queue, &token->node);
+    ev_list_push_back(&handle->queue, &token->node);
+}
+
+void ev_idle_timer_remove(ev_idle_token_t *token)
+{
+    ev_idle_timer_t *handle = token->owner;
+    if (handle == NULL)
+    {
+        return;
+    }
+
+    _ev_idle_timer_detach(token);
+    if (ev_list_size(&handle->queue) == 0)
+    {
+        ev_timer_stop(&handle->timer);
+    }
+}
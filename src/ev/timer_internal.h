@@ -26,6 +26,14 @@ struct ev_timer
     } attr;
 };
 
+struct ev_idle_timer
+{
+    ev_timer_t timer;   /**< Expire timer */
+    ev_list_t  queue;   /**< #ev_idle_token_t::node. Ordered by last activity */
+    uint64_t   timeout; /**< Idle timeout */
+    int        closing; /**< Manager is closing */
+};
+
 /**
  * @brief Initialize timer context.
  * @param[out] loop Event loop
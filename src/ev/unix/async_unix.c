@@ -17,9 +17,13 @@ static void _ev_async_on_close(ev_handle_t *handle)
 {
     ev_async_t *async = EV_CONTAINER_OF(handle, ev_async_t, base);
 
+    ev_loop_t  *loop = async->base.loop;
     ev_async_cb close_cb = async->close_cb;
     void       *close_arg = async->close_arg;
-    ev_free(async);
+    if (!(async->base.data.flags & EV_HANDLE_INPLACE))
+    {
+        ev__loop_free(loop, async);
+    }
 
     if (close_cb != NULL)
     {
@@ -59,7 +63,10 @@ static void _ev_async_exit(ev_async_t *handle, ev_async_cb close_cb,
     else
     {
         ev__handle_exit(&handle->base, NULL);
-        ev_free(handle);
+        if (!(handle->base.data.flags & EV_HANDLE_INPLACE))
+        {
+            ev__loop_free(handle->base.loop, handle);
+        }
     }
 }
 
@@ -136,40 +143,78 @@ EV_LOCAL void ev__async_pend(int rfd)
     }
 }
 
+static int _ev_async_init_unix(ev_loop_t *loop, ev_async_t *handle,
+                               ev_async_cb activate_cb, void *activate_arg)
+{
+    int errcode;
+
+    handle->activate_cb = activate_cb;
+    handle->activate_arg = activate_arg;
+    handle->close_cb = NULL;
+    ev__handle_init(loop, &handle->base, EV_ROLE_EV_ASYNC);
+
+    errcode = ev__asyc_eventfd(handle->backend.pipfd);
+    if (errcode != 0)
+    {
+        goto err_close_handle;
+    }
+
+    ev__nonblock_io_init(&handle->backend.io, handle->backend.pipfd[0],
+                         _async_on_wakeup_unix, NULL);
+    ev__nonblock_io_add(loop, &handle->backend.io, EV_IO_IN);
+    ev__handle_active(&handle->base);
+
+    return 0;
+
+err_close_handle:
+    _async_close_pipe(handle);
+    ev__handle_exit(&handle->base, NULL);
+    return errcode;
+}
+
+size_t ev_async_size(void)
+{
+    return sizeof(ev_async_t);
+}
+
 int ev_async_init(ev_loop_t *loop, ev_async_t **handle, ev_async_cb activate_cb,
                   void *activate_arg)
 {
     int         errcode;
-    ev_async_t *new_handle = ev_malloc(sizeof(ev_async_t));
+    ev_async_t *new_handle =
+        ev__loop_malloc(loop, EV_ALLOCATOR_TYPE_MISC, sizeof(ev_async_t));
     if (new_handle == NULL)
     {
         return EV_ENOMEM;
     }
 
-    new_handle->activate_cb = activate_cb;
-    new_handle->activate_arg = activate_arg;
-    new_handle->close_cb = NULL;
-    ev__handle_init(loop, &new_handle->base, EV_ROLE_EV_ASYNC);
-
-    errcode = ev__asyc_eventfd(new_handle->backend.pipfd);
+    errcode = _ev_async_init_unix(loop, new_handle, activate_cb, activate_arg);
     if (errcode != 0)
     {
-        goto err_close_handle;
+        ev__loop_free(loop, new_handle);
+        return errcode;
     }
 
-    ev__nonblock_io_init(&new_handle->backend.io, new_handle->backend.pipfd[0],
-                         _async_on_wakeup_unix, NULL);
-    ev__nonblock_io_add(loop, &new_handle->backend.io, EV_IO_IN);
-    ev__handle_active(&new_handle->base);
-
     *handle = new_handle;
     return 0;
+}
 
-err_close_handle:
-    _async_close_pipe(new_handle);
-    ev__handle_exit(&new_handle->base, NULL);
-    ev_free(new_handle);
-    return errcode;
+int ev_async_init_inplace(ev_loop_t *loop, ev_async_t **handle,
+                          ev_async_cb activate_cb, void *activate_arg,
+                          void *mem)
+{
+    int         errcode;
+    ev_async_t *new_handle = mem;
+
+    errcode = _ev_async_init_unix(loop, new_handle, activate_cb, activate_arg);
+    if (errcode != 0)
+    {
+        return errcode;
+    }
+    new_handle->base.data.flags |= EV_HANDLE_INPLACE;
+
+    *handle = new_handle;
+    return 0;
 }
 
 void ev_async_exit(ev_async_t *handle, ev_async_cb close_cb, void *close_arg)
@@ -1,107 +1,152 @@
-#ifndef __EV_IO_UNIX_H__
-#define __EV_IO_UNIX_H__
-
-#include <sys/epoll.h>
-#define EV_IO_IN            EPOLLIN     /**< The associated file is available for read(2) operations. */
-#define EV_IO_OUT           EPOLLOUT    /**< The associated file is available for write(2) operations. */
-
-#ifdef __cplusplus
-extern "C" {
-#endif
-
-EV_LOCAL void ev__init_io(ev_loop_t* loop);
-
-EV_LOCAL void ev__exit_io(ev_loop_t* loop);
-
-/**
- * @brief Initialize io structure
- * @param[out] io   A pointer to the structure
- * @param[in] fd    File descriptor
- * @param[in] cb    IO active callback
- * @param[in] arg   User data
- */
-EV_LOCAL void ev__nonblock_io_init(ev_nonblock_io_t* io, int fd, ev_nonblock_io_cb cb, void* arg);
-
-/**
- * @brief Add events to IO structure
- * @param[in] loop  Event loop
- * @param[in] io    IO structure
- * @param[in] evts  #EV_IO_IN or #EV_IO_OUT
- */
-EV_LOCAL void ev__nonblock_io_add(ev_loop_t* loop, ev_nonblock_io_t* io, unsigned evts);
-
-/**
- * @brief Delete events from IO structure
- * @param[in] loop  Event loop
- * @param[in] io    IO structure
- * @param[in] evts  #EV_IO_IN or #EV_IO_OUT
- */
-EV_LOCAL void ev__nonblock_io_del(ev_loop_t* loop, ev_nonblock_io_t* io, unsigned evts);
-
-/**
- * @brief Add or remove FD_CLOEXEC
- * @param[in] fd    File descriptor
- * @param[in] set   bool
- * @return          #ev_errno_t
- */
-EV_LOCAL int ev__cloexec(int fd, int set);
-
-/**
- * @brief Add or remove O_NONBLOCK
- * @param[in] fd    File descriptor
- * @param[in] set   bool
- * @return          #ev_errno_t
- */
-EV_LOCAL int ev__nonblock(int fd, int set);
-
-/**
- * @brief Set reuse
- * @return          #ev_errno_t
- */
-EV_LOCAL int ev__reuse_unix(int fd);
-
-/**
- * @brief Return the file access mode and the file status flags
- */
-EV_LOCAL int ev__fcntl_getfl_unix(int fd);
-
-/**
- * @brief Return the file descriptor flags.
- */
-EV_LOCAL int ev__fcntl_getfd_unix(int fd);
-
-/**
- * @brief readv wrap
- * @return 0: try again; >0: read size; <0 errno
- */
-EV_LOCAL ssize_t ev__readv_unix(int fd, ev_buf_t* iov, int iovcnt);
-
-/**
- * @brief readv wrap
- * @return 0: try again; >0: write size; <0 errno
- */
-EV_LOCAL ssize_t ev__writev_unix(int fd, ev_buf_t* iov, int iovcnt);
-
-/**
- * @brief write
- * @return 0: try again; >0: write size; <0 errno
- */
-EV_LOCAL ssize_t ev__write_unix(int fd, void* buffer, size_t size);
-
-/**
- * @brief Write \p req to \p fd
- * @param[in] fd    File to write
- * @param[in] req   Write request
- * @param[in] do_write  Write function
- * @param[in] arg       User defined data
- * @return              + #EV_SUCCESS: \p req send finish
- *                      + #EV_EAGAIN: \p req not send finish, need to try again
- *                      + other value: error
- */
-EV_LOCAL int ev__send_unix(int fd, ev_write_t* req,
-    ssize_t(*do_write)(int fd, struct iovec* iov, int iovcnt, void* arg), void* arg);
-
-#ifdef __cplusplus
-}
-#endif
-#endif
+#ifndef __EV_IO_UNIX_H__
+#define __EV_IO_UNIX_H__
+
+#include <sys/epoll.h>
+#define EV_IO_IN            EPOLLIN     /**< The associated file is available for read(2) operations. */
+#define EV_IO_OUT           EPOLLOUT    /**< The associated file is available for write(2) operations. */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+EV_LOCAL void ev__init_io(ev_loop_t* loop);
+
+EV_LOCAL void ev__exit_io(ev_loop_t* loop);
+
+/**
+ * @brief Initialize io structure
+ * @param[out] io   A pointer to the structure
+ * @param[in] fd    File descriptor
+ * @param[in] cb    IO active callback
+ * @param[in] arg   User data
+ */
+EV_LOCAL void ev__nonblock_io_init(ev_nonblock_io_t* io, int fd, ev_nonblock_io_cb cb, void* arg);
+
+/**
+ * @brief Add events to IO structure
+ * @param[in] loop  Event loop
+ * @param[in] io    IO structure
+ * @param[in] evts  #EV_IO_IN or #EV_IO_OUT
+ */
+EV_LOCAL void ev__nonblock_io_add(ev_loop_t* loop, ev_nonblock_io_t* io, unsigned evts);
+
+/**
+ * @brief Delete events from IO structure
+ * @param[in] loop  Event loop
+ * @param[in] io    IO structure
+ * @param[in] evts  #EV_IO_IN or #EV_IO_OUT
+ */
+EV_LOCAL void ev__nonblock_io_del(ev_loop_t* loop, ev_nonblock_io_t* io, unsigned evts);
+
+/**
+ * @brief Add or remove FD_CLOEXEC
+ * @param[in] fd    File descriptor
+ * @param[in] set   bool
+ * @return          #ev_errno_t
+ */
+EV_LOCAL int ev__cloexec(int fd, int set);
+
+/**
+ * @brief Add or remove O_NONBLOCK
+ * @param[in] fd    File descriptor
+ * @param[in] set   bool
+ * @return          #ev_errno_t
+ */
+EV_LOCAL int ev__nonblock(int fd, int set);
+
+/**
+ * @brief Set reuse
+ * @return          #ev_errno_t
+ */
+EV_LOCAL int ev__reuse_unix(int fd);
+
+/**
+ * @brief Return the file access mode and the file status flags
+ */
+EV_LOCAL int ev__fcntl_getfl_unix(int fd);
+
+/**
+ * @brief Return the file descriptor flags.
+ */
+EV_LOCAL int ev__fcntl_getfd_unix(int fd);
+
+/**
+ * @brief readv wrap
+ * @return 0: try again; >0: read size; <0 errno
+ */
+EV_LOCAL ssize_t ev__readv_unix(int fd, ev_buf_t* iov, int iovcnt);
+
+/**
+ * @brief readv wrap
+ * @return 0: try again; >0: write size; <0 errno
+ */
+EV_LOCAL ssize_t ev__writev_unix(int fd, ev_buf_t* iov, int iovcnt);
+
+/**
+ * @brief write
+ * @return 0: try again; >0: write size; <0 errno
+ */
+EV_LOCAL ssize_t ev__write_unix(int fd, void* buffer, size_t size);
+
+/**
+ * @brief Send \p count bytes of \p in_fd starting at \p offset to \p out_fd.
+ * @return #EV_EAGAIN: try again; 0: end of file; >0: send size; <0 errno
+ */
+EV_LOCAL ssize_t ev__sendfile_unix(int out_fd, int in_fd, int64_t offset, size_t count);
+
+/**
+ * @brief Move \p count bytes from \p fd_in to \p fd_out by splice(2).
+ *
+ * One of \p fd_in and \p fd_out must be a pipe.
+ *
+ * @return #EV_EAGAIN: try again; 0: end of file; >0: move size; <0 errno
+ */
+EV_LOCAL ssize_t ev__splice_unix(int fd_in, int fd_out, size_t count);
+
+/**
+ * @brief Same as #ev__writev_unix(), but send with MSG_ZEROCOPY.
+ *
+ * Fallback to #ev__writev_unix() if MSG_ZEROCOPY is not available.
+ *
+ * @return 0: try again; >0: write size; <0 errno
+ */
+EV_LOCAL ssize_t ev__sendmsg_zerocopy_unix(int fd, ev_buf_t* iov, int iovcnt);
+
+/**
+ * @brief Read next zerocopy completion from error queue of \p fd.
+ *
+ * Completions are not guaranteed to arrive in order, nor to be contiguous.
+ *
+ * @param[in] fd    Socket
+ * @param[out] lo   Sequence number of the first completed zerocopy send.
+ * @param[out] hi   Sequence number of the last completed zerocopy send.
+ * @return          1: got a completion; 0: none; <0 errno
+ */
+EV_LOCAL int ev__zerocopy_notify_unix(int fd, uint32_t* lo, uint32_t* hi);
+
+/**
+ * @brief Account \p write_size bytes as sent for \p req.
+ * @param[in] req           Write request
+ * @param[in] write_size    Bytes sent, must not exceed the pending size.
+ * @return                  + #EV_SUCCESS: \p req send finish
+ *                          + #EV_EAGAIN: \p req not send finish
+ */
+EV_LOCAL int ev__finalize_send_req_unix(ev_write_t* req, size_t write_size);
+
+/**
+ * @brief Write \p req to \p fd
+ * @param[in] fd    File to write
+ * @param[in] req   Write request
+ * @param[in] do_write  Write function
+ * @param[in] arg       User defined data
+ * @return              + #EV_SUCCESS: \p req send finish
+ *                      + #EV_EAGAIN: \p req not send finish, need to try again
+ *                      + other value: error
+ */
+EV_LOCAL int ev__send_unix(int fd, ev_write_t* req,
+    ssize_t(*do_write)(int fd, struct iovec* iov, int iovcnt, void* arg), void* arg);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -1,995 +1,1312 @@
-#define _GNU_SOURCE
-#include <assert.h>
-#include <fcntl.h>
-#include <unistd.h>
-#include <string.h>
-
-typedef char ev_ipc_msghdr[CMSG_SPACE(sizeof(int))];
-
-static void _ev_pipe_close_unix(ev_pipe_t *pipe)
-{
-    if (pipe->pipfd != EV_OS_PIPE_INVALID)
-    {
-        close(pipe->pipfd);
-        pipe->pipfd = EV_OS_PIPE_INVALID;
-    }
-}
-
-static void _ev_pipe_on_close_unix(ev_handle_t *handle)
-{
-    ev_pipe_t *pipe_handle = EV_CONTAINER_OF(handle, ev_pipe_t, base);
-    ev_pipe_cb close_cb = pipe_handle->close_cb;
-    void      *close_arg = pipe_handle->close_arg;
-    ev_free(pipe_handle);
-
-    if (close_cb != NULL)
-    {
-        close_cb(pipe_handle, close_arg);
-    }
-}
-
-static void _ev_pipe_smart_deactive(ev_pipe_t *pipe)
-{
-    size_t io_sz = 0;
-
-    if (!ev__handle_is_active(&pipe->base))
-    {
-        return;
-    }
-
-    if (pipe->base.data.flags & EV_HANDLE_PIPE_IPC)
-    {
-        io_sz += ev_list_size(&pipe->backend.ipc_mode.rio.rqueue);
-        io_sz += pipe->backend.ipc_mode.rio.curr.reading != NULL ? 1 : 0;
-        io_sz += ev_list_size(&pipe->backend.ipc_mode.wio.wqueue);
-        io_sz += pipe->backend.ipc_mode.wio.curr.writing != NULL ? 1 : 0;
-    }
-    else
-    {
-        io_sz = ev__nonblock_stream_size(&pipe->backend.data_mode.stream,
-                                         EV_IO_IN | EV_IO_OUT);
-    }
-
-    if (io_sz == 0)
-    {
-        ev__handle_deactive(&pipe->base);
-    }
-}
-
-static void _ev_pipe_w_user_callback_unix(ev_pipe_t           *pipe,
-                                          ev_pipe_write_req_t *req,
-                                          ssize_t              size)
-{
-    _ev_pipe_smart_deactive(pipe);
-    ev__write_exit(&req->base);
-    req->ucb(pipe, size, req->ucb_arg);
-    ev_free(req);
-}
-
-static void _ev_pipe_r_user_callback_unix(ev_pipe_t          *pipe,
-                                          ev_pipe_read_req_t *req, ssize_t size)
-{
-    _ev_pipe_smart_deactive(pipe);
-    ev__read_exit(&req->base);
-    req->ucb(req, size);
-}
-
-static void _ev_pipe_on_data_mode_write_unix(ev_nonblock_stream_t *stream,
-                                             ev_write_t *req, ssize_t size)
-{
-    ev_pipe_t *pipe_handle =
-        EV_CONTAINER_OF(stream, ev_pipe_t, backend.data_mode.stream);
-    ev_pipe_write_req_t *w_req =
-        EV_CONTAINER_OF(req, ev_pipe_write_req_t, base);
-    _ev_pipe_w_user_callback_unix(pipe_handle, w_req, size);
-}
-
-static void _ev_pipe_on_data_mode_read_unix(ev_nonblock_stream_t *stream,
-                                            ev_read_t *req, ssize_t size)
-{
-    ev_pipe_t *pipe_handle =
-        EV_CONTAINER_OF(stream, ev_pipe_t, backend.data_mode.stream);
-
-    ev_pipe_read_req_t *r_req = EV_CONTAINER_OF(req, ev_pipe_read_req_t, base);
-    _ev_pipe_r_user_callback_unix(pipe_handle, r_req, size);
-}
-
-static int _ev_pipe_on_ipc_mode_io_read_remain(ev_pipe_t *pipe)
-{
-    assert(pipe->backend.ipc_mode.rio.curr.reading != NULL);
-
-    ev_buf_t bufs[EV_IOV_MAX];
-    size_t   target_size = pipe->backend.ipc_mode.rio.curr.data_remain_size;
-    ev_pipe_read_req_t *req = pipe->backend.ipc_mode.rio.curr.reading;
-
-    size_t buf_idx = pipe->backend.ipc_mode.rio.curr.buf_idx;
-    size_t buf_pos = pipe->backend.ipc_mode.rio.curr.buf_pos;
-
-    size_t idx;
-    for (idx = 0; idx < ARRAY_SIZE(bufs) && target_size > 0 &&
-                  buf_idx < req->base.data.nbuf;
-         idx++, buf_idx++)
-    {
-        bufs[idx].data = (uint8_t *)req->base.data.bufs[buf_idx].data + buf_pos;
-        bufs[idx].size = req->base.data.bufs[buf_idx].size - buf_pos;
-
-        bufs[idx].size = EV_MIN(bufs[idx].size, target_size);
-        target_size -= bufs[idx].size;
-
-        buf_pos = 0;
-    }
-
-    ssize_t read_size = ev__readv_unix(pipe->pipfd, bufs, idx);
-    if (read_size < 0)
-    {
-        return read_size;
-    }
-
-    pipe->backend.ipc_mode.rio.curr.data_remain_size -= read_size;
-    req->base.data.size += read_size;
-
-    /* no data remain */
-    if (pipe->backend.ipc_mode.rio.curr.data_remain_size == 0)
-    {
-        goto callback;
-    }
-
-    /* move cursor */
-    while (read_size > 0 &&
-           pipe->backend.ipc_mode.rio.curr.buf_idx < req->base.data.nbuf)
-    {
-        size_t left_size =
-            req->base.data.bufs[pipe->backend.ipc_mode.rio.curr.buf_idx].size -
-            pipe->backend.ipc_mode.rio.curr.buf_pos;
-
-        if (left_size > (size_t)read_size)
-        {
-            pipe->backend.ipc_mode.rio.curr.buf_pos += read_size;
-            break;
-        }
-
-        read_size -= left_size;
-        pipe->backend.ipc_mode.rio.curr.buf_idx++;
-        pipe->backend.ipc_mode.rio.curr.buf_pos = 0;
-        continue;
-    }
-
-    /* Buffer is full */
-    if (pipe->backend.ipc_mode.rio.curr.buf_idx >= req->base.data.nbuf)
-    {
-        goto callback;
-    }
-
-    return 0;
-
-callback:
-    pipe->backend.ipc_mode.rio.curr.reading = NULL;
-    _ev_pipe_r_user_callback_unix(pipe, req, req->base.data.size);
-    return 0;
-}
-
-static ssize_t _ev_pipe_recvmsg_unix(ev_pipe_t *pipe, struct msghdr *msg)
-{
-    struct cmsghdr *cmsg;
-    ssize_t         rc;
-    int            *pfd;
-    int            *end;
-    int             fd = pipe->pipfd;
-#if defined(__linux__)
-    if (!pipe->backend.ipc_mode.mask.no_cmsg_cloexec)
-    {
-        rc = recvmsg(fd, msg, MSG_CMSG_CLOEXEC);
-        if (rc != -1)
-        {
-            return rc;
-        }
-        if ((rc = errno) != EINVAL)
-        {
-            return ev__translate_sys_error(errno);
-        }
-        rc = recvmsg(fd, msg, 0);
-        if (rc == -1)
-        {
-            return ev__translate_sys_error(errno);
-        }
-        pipe->backend.ipc_mode.mask.no_cmsg_cloexec = 1;
-    }
-    else
-    {
-        rc = recvmsg(fd, msg, 0);
-    }
-#else
-    rc = recvmsg(fd, msg, 0);
-#endif
-    if (rc == -1)
-    {
-        return ev__translate_sys_error(errno);
-    }
-    if (msg->msg_controllen == 0)
-    {
-        return rc;
-    }
-    for (cmsg = CMSG_FIRSTHDR(msg); cmsg != NULL; cmsg = CMSG_NXTHDR(msg, cmsg))
-    {
-        if (cmsg->cmsg_type == SCM_RIGHTS)
-        {
-            for (pfd = (int *)CMSG_DATA(cmsg),
-                end = (int *)((char *)cmsg + cmsg->cmsg_len);
-                 pfd < end; pfd += 1)
-            {
-                ev__cloexec(*pfd, 1);
-            }
-        }
-    }
-    return rc;
-}
-
-static void _ev_stream_do_read_parser_msghdr(ev_pipe_read_req_t *req,
-                                             struct msghdr      *msg)
-{
-    struct cmsghdr *cmsg = CMSG_FIRSTHDR(msg);
-    if (cmsg == NULL)
-    {
-        return;
-    }
-
-    void *pv = CMSG_DATA(cmsg);
-    int  *pi = pv;
-    req->handle.os_socket = *pi;
-
-    assert(CMSG_NXTHDR(msg, cmsg) == NULL);
-}
-
-static int _ev_pipe_on_ipc_mode_io_read_first(ev_pipe_t *pipe)
-{
-    void *buffer = (uint8_t *)pipe->backend.ipc_mode.rio.buffer +
-                   pipe->backend.ipc_mode.rio.curr.head_read_size;
-    size_t buffer_size = sizeof(pipe->backend.ipc_mode.rio.buffer) -
-                         pipe->backend.ipc_mode.rio.curr.head_read_size;
-
-    if (pipe->backend.ipc_mode.rio.curr.head_read_size == 0)
-    {
-        struct msghdr msg;
-        ev_ipc_msghdr cmsg_space;
-        struct iovec  iov = { buffer, buffer_size };
-
-        /* ipc uses recvmsg */
-        msg.msg_flags = 0;
-        msg.msg_iov = &iov;
-        msg.msg_iovlen = 1;
-        msg.msg_name = NULL;
-        msg.msg_namelen = 0;
-        /* Set up to receive a descriptor even if one isn't in the message */
-        msg.msg_controllen = sizeof(cmsg_space);
-        msg.msg_control = cmsg_space;
-
-        ssize_t read_size = _ev_pipe_recvmsg_unix(pipe, &msg);
-        if (read_size <= 0)
-        { /* Error or EOF */
-            return read_size;
-        }
-        assert(read_size <= (ssize_t)sizeof(pipe->backend.ipc_mode.rio.buffer));
-
-        _ev_stream_do_read_parser_msghdr(
-            pipe->backend.ipc_mode.rio.curr.reading, &msg);
-        pipe->backend.ipc_mode.rio.curr.head_read_size += read_size;
-    }
-    else
-    {
-        ssize_t read_size = read(pipe->pipfd, buffer, buffer_size);
-        if (read_size == 0)
-        {
-            return EV_EOF;
-        }
-        if (read_size < 0)
-        {
-            int err = errno;
-            if (err == EAGAIN)
-            { /* try again */
-                return 0;
-            }
-            return ev__translate_sys_error(err);
-        }
-        pipe->backend.ipc_mode.rio.curr.head_read_size += read_size;
-    }
-
-    /* If frame header not read complete, try again */
-    if (pipe->backend.ipc_mode.rio.curr.head_read_size <
-        sizeof(ev_ipc_frame_hdr_t))
-    {
-        return 0;
-    }
-
-    /* A invalid frame header means something wrong in the transmission link */
-    if (!ev__ipc_check_frame_hdr(pipe->backend.ipc_mode.rio.buffer,
-                                 sizeof(ev_ipc_frame_hdr_t)))
-    {
-        return EV_EPIPE;
-    }
-
-    ev_ipc_frame_hdr_t *hdr =
-        (ev_ipc_frame_hdr_t *)pipe->backend.ipc_mode.rio.buffer;
-    pipe->backend.ipc_mode.rio.curr.data_remain_size = hdr->hdr_dtsz;
-
-    /* No data remain to read means peer send a empty package */
-    if (pipe->backend.ipc_mode.rio.curr.data_remain_size == 0)
-    {
-        ev_pipe_read_req_t *req = pipe->backend.ipc_mode.rio.curr.reading;
-        pipe->backend.ipc_mode.rio.curr.reading = NULL;
-        _ev_pipe_r_user_callback_unix(pipe, req, req->base.data.size);
-    }
-
-    /* Process to read body */
-    return _ev_pipe_on_ipc_mode_io_read_remain(pipe);
-}
-
-static int _ev_pipe_on_ipc_mode_io_read_unix(ev_pipe_t *pipe)
-{
-    if (pipe->backend.ipc_mode.rio.curr.data_remain_size != 0)
-    {
-        return _ev_pipe_on_ipc_mode_io_read_remain(pipe);
-    }
-
-    assert(pipe->backend.ipc_mode.rio.curr.reading == NULL);
-
-    ev_list_node_t *it = ev_list_pop_front(&pipe->backend.ipc_mode.rio.rqueue);
-    assert(it != NULL);
-
-    pipe->backend.ipc_mode.rio.curr.reading =
-        EV_CONTAINER_OF(it, ev_pipe_read_req_t, base.node);
-    pipe->backend.ipc_mode.rio.curr.head_read_size = 0;
-    pipe->backend.ipc_mode.rio.curr.buf_idx = 0;
-    pipe->backend.ipc_mode.rio.curr.buf_pos = 0;
-
-    return _ev_pipe_on_ipc_mode_io_read_first(pipe);
-}
-
-static ssize_t _ev_pipe_sendmsg_unix(int fd, int fd_to_send, struct iovec *iov,
-                                     int iovcnt)
-{
-    struct msghdr   msg;
-    struct cmsghdr *cmsg;
-
-    ev_ipc_msghdr msg_ctrl_hdr;
-    memset(&msg_ctrl_hdr, 0, sizeof(msg_ctrl_hdr));
-
-    msg.msg_name = NULL;
-    msg.msg_namelen = 0;
-    msg.msg_iov = iov;
-    msg.msg_iovlen = iovcnt;
-    msg.msg_flags = 0;
-
-    msg.msg_control = msg_ctrl_hdr;
-    msg.msg_controllen = sizeof(msg_ctrl_hdr);
-
-    cmsg = CMSG_FIRSTHDR(&msg);
-    cmsg->cmsg_level = SOL_SOCKET;
-    cmsg->cmsg_type = SCM_RIGHTS;
-    cmsg->cmsg_len = CMSG_LEN(sizeof(fd_to_send));
-
-    /* silence aliasing warning */
-    {
-        void *pv = CMSG_DATA(cmsg);
-        int  *pi = pv;
-        *pi = fd_to_send;
-    }
-
-    ssize_t n;
-    do
-    {
-        n = sendmsg(fd, &msg, 0);
-    } while (n == -1 && errno == EINTR);
-
-    if (n >= 0)
-    {
-        return n;
-    }
-
-    int err = errno;
-    if (err == EAGAIN || err == EWOULDBLOCK)
-    {
-        return 0;
-    }
-    return ev__translate_sys_error(err);
-}
-
-static int _ev_pipe_on_ipc_mode_io_write_remain_body_unix(ev_pipe_t *pipe)
-{
-    ev_buf_t             bufs[EV_IOV_MAX];
-    ev_pipe_write_req_t *req = pipe->backend.ipc_mode.wio.curr.writing;
-    assert(req != NULL);
-
-    size_t buf_idx = pipe->backend.ipc_mode.wio.curr.buf_idx;
-    size_t buf_pos = pipe->backend.ipc_mode.wio.curr.buf_pos;
-
-    size_t idx;
-    for (idx = 0; idx < ARRAY_SIZE(bufs) && buf_idx < req->base.nbuf;
-         idx++, buf_idx++)
-    {
-        bufs[idx].data = (uint8_t *)req->base.bufs[buf_idx].data + buf_pos;
-        bufs[idx].size = req->base.bufs[buf_idx].size - buf_pos;
-        buf_pos = 0;
-    }
-
-    ssize_t write_size = ev__writev_unix(pipe->pipfd, bufs, idx);
-    if (write_size < 0)
-    {
-        return write_size;
-    }
-
-    req->base.size += write_size;
-    while (write_size > 0)
-    {
-        size_t left_size =
-            req->base.bufs[pipe->backend.ipc_mode.wio.curr.buf_idx].size -
-            pipe->backend.ipc_mode.wio.curr.buf_pos;
-        if (left_size > (size_t)write_size)
-        {
-            pipe->backend.ipc_mode.wio.curr.buf_pos += write_size;
-            write_size = 0;
-            break;
-        }
-
-        write_size -= left_size;
-        pipe->backend.ipc_mode.wio.curr.buf_idx++;
-        pipe->backend.ipc_mode.wio.curr.buf_pos = 0;
-    }
-
-    /* send finish */
-    if (pipe->backend.ipc_mode.wio.curr.buf_idx >= req->base.nbuf)
-    {
-        pipe->backend.ipc_mode.wio.curr.writing = NULL;
-        _ev_pipe_w_user_callback_unix(pipe, req, req->base.size);
-    }
-
-    return 0;
-}
-
-static int _ev_pipe_on_ipc_mode_io_write_remain_head_unix(ev_pipe_t *pipe)
-{
-    EV_LOG_TRACE("pipe(%p) send remain header", pipe);
-
-    const size_t buffer_pos = pipe->backend.ipc_mode.wio.curr.head_send_size;
-    void        *buffer = pipe->backend.ipc_mode.wio.buffer + buffer_pos;
-    size_t       buffer_size =
-        pipe->backend.ipc_mode.wio.curr.head_send_capacity - buffer_pos;
-
-    ssize_t send_size = ev__write_unix(pipe->pipfd, buffer, buffer_size);
-    if (send_size < 0)
-    {
-        return send_size;
-    }
-    pipe->backend.ipc_mode.wio.curr.head_send_size += send_size;
-
-    /* try again */
-    if ((size_t)send_size < buffer_size)
-    {
-        return 0;
-    }
-
-    /* Write body */
-    return _ev_pipe_on_ipc_mode_io_write_remain_body_unix(pipe);
-}
-
-static int _ev_pipe_on_ipc_mode_io_write_remain_unix(ev_pipe_t *pipe)
-{
-    if (pipe->backend.ipc_mode.wio.curr.head_send_size <
-        pipe->backend.ipc_mode.wio.curr.head_send_capacity)
-    {
-        return _ev_pipe_on_ipc_mode_io_write_remain_head_unix(pipe);
-    }
-
-    return _ev_pipe_on_ipc_mode_io_write_remain_body_unix(pipe);
-}
-
-static int _ev_pipe_ipc_mode_write_new_frame_unix(ev_pipe_t *pipe)
-{
-    ev_pipe_write_req_t *req = pipe->backend.ipc_mode.wio.curr.writing;
-
-    ev_ipc_frame_hdr_t frame_hdr;
-    ev__ipc_init_frame_hdr(&frame_hdr, 0, 0, req->base.capacity);
-    memcpy(pipe->backend.ipc_mode.wio.buffer, &frame_hdr, sizeof(frame_hdr));
-    pipe->backend.ipc_mode.wio.curr.head_send_capacity = sizeof(frame_hdr);
-
-    ssize_t send_size;
-    if (req->handle.role == EV_ROLE_EV_TCP)
-    {
-        struct iovec iov = {
-            pipe->backend.ipc_mode.wio.buffer,
-            pipe->backend.ipc_mode.wio.curr.head_send_capacity
-        };
-
-        send_size = _ev_pipe_sendmsg_unix(pipe->pipfd, req->handle.u.os_socket,
-                                          &iov, 1);
-        if (send_size >= 0)
-        {
-            req->handle.role = EV_ROLE_UNKNOWN;
-            req->handle.u.os_socket = EV_OS_SOCKET_INVALID;
-        }
-    }
-    else
-    {
-        send_size =
-            ev__write_unix(pipe->pipfd, pipe->backend.ipc_mode.wio.buffer,
-                           pipe->backend.ipc_mode.wio.curr.head_send_capacity);
-    }
-
-    if (send_size == 0)
-    { /* If data not send, try again */
-        EV_LOG_TRACE("pipe(%p) data not send, try again", pipe);
-        ev_list_push_front(&pipe->backend.ipc_mode.wio.wqueue, &req->base.node);
-        pipe->backend.ipc_mode.wio.curr.writing = NULL;
-        return 0;
-    }
-    else if (send_size < 0)
-    { /* send_size is error code */
-        EV_LOG_ERROR("pipe(%p) data send failed, err:%d", pipe, send_size);
-        return send_size;
-    }
-
-    pipe->backend.ipc_mode.wio.curr.head_send_size = send_size;
-
-    /* try again to send frame header */
-    if ((size_t)send_size < pipe->backend.ipc_mode.wio.curr.head_send_capacity)
-    {
-        EV_LOG_TRACE("pipe(%p) frame header remain %zu bytes", pipe,
-                     pipe->backend.ipc_mode.wio.curr.head_send_capacity -
-                         send_size);
-        return 0;
-    }
-
-    return _ev_pipe_on_ipc_mode_io_write_remain_unix(pipe);
-}
-
-static void _ev_pipe_ipc_mode_reset_wio_curr_cnt(ev_pipe_t *pipe)
-{
-    pipe->backend.ipc_mode.wio.curr.head_send_size = 0;
-    pipe->backend.ipc_mode.wio.curr.head_send_capacity = 0;
-    pipe->backend.ipc_mode.wio.curr.buf_idx = 0;
-    pipe->backend.ipc_mode.wio.curr.buf_pos = 0;
-}
-
-static void _ev_pipe_ipc_mode_reset_rio_curr_cnt(ev_pipe_t *pipe)
-{
-    pipe->backend.ipc_mode.rio.curr.head_read_size = 0;
-    pipe->backend.ipc_mode.rio.curr.data_remain_size = 0;
-    pipe->backend.ipc_mode.rio.curr.buf_idx = 0;
-    pipe->backend.ipc_mode.rio.curr.buf_pos = 0;
-}
-
-static int _ev_pipe_on_ipc_mode_io_write_unix(ev_pipe_t *pipe)
-{
-    if (pipe->backend.ipc_mode.wio.curr.writing != NULL)
-    {
-        return _ev_pipe_on_ipc_mode_io_write_remain_unix(pipe);
-    }
-
-    ev_list_node_t *it = ev_list_pop_front(&pipe->backend.ipc_mode.wio.wqueue);
-    assert(it != NULL);
-    pipe->backend.ipc_mode.wio.curr.writing =
-        EV_CONTAINER_OF(it, ev_pipe_write_req_t, base.node);
-    _ev_pipe_ipc_mode_reset_wio_curr_cnt(pipe);
-
-    return _ev_pipe_ipc_mode_write_new_frame_unix(pipe);
-}
-
-static void _ev_pipe_ipc_mode_cancel_all_rio_unix(ev_pipe_t *pipe, int stat)
-{
-    ev_list_node_t *it;
-    while ((it = ev_list_pop_front(&pipe->backend.ipc_mode.rio.rqueue)) != NULL)
-    {
-        ev_pipe_read_req_t *req =
-            EV_CONTAINER_OF(it, ev_pipe_read_req_t, base.node);
-        _ev_pipe_r_user_callback_unix(pipe, req, stat);
-    }
-}
-
-static void _ev_pipe_ipc_mode_cancel_all_wio_unix(ev_pipe_t *pipe, int stat)
-{
-    ev_list_node_t *it;
-    while ((it = ev_list_pop_front(&pipe->backend.ipc_mode.wio.wqueue)) != NULL)
-    {
-        ev_pipe_write_req_t *req =
-            EV_CONTAINER_OF(it, ev_pipe_write_req_t, base.node);
-        _ev_pipe_w_user_callback_unix(pipe, req, stat);
-    }
-}
-
-static void _ev_pipe_abort_unix(ev_pipe_t *pipe, int stat)
-{
-    if (pipe->base.data.flags & EV_HANDLE_PIPE_IPC)
-    {
-        ev__nonblock_io_del(pipe->base.loop, &pipe->backend.ipc_mode.io,
-                            EV_IO_IN | EV_IO_OUT);
-        _ev_pipe_close_unix(pipe);
-
-        _ev_pipe_ipc_mode_cancel_all_rio_unix(pipe, stat);
-        _ev_pipe_ipc_mode_cancel_all_wio_unix(pipe, stat);
-    }
-    else
-    {
-        if (pipe->base.data.flags & EV_HANDLE_PIPE_STREAMING)
-        {
-            ev__nonblock_stream_exit(&pipe->backend.data_mode.stream);
-            pipe->base.data.flags &= ~EV_HANDLE_PIPE_STREAMING;
-        }
-        _ev_pipe_close_unix(pipe);
-    }
-}
-
-static void _ev_pipe_on_ipc_mode_io_unix(ev_nonblock_io_t *io, unsigned evts,
-                                         void *arg)
-{
-    (void)arg;
-
-    int        ret = 0;
-    ev_pipe_t *pipe = EV_CONTAINER_OF(io, ev_pipe_t, backend.ipc_mode.io);
-
-    if (evts & (EPOLLIN | EPOLLHUP))
-    {
-        if ((ret = _ev_pipe_on_ipc_mode_io_read_unix(pipe)) != 0)
-        {
-            goto err;
-        }
-        if (ev_list_size(&pipe->backend.ipc_mode.rio.rqueue) == 0 &&
-            pipe->backend.ipc_mode.rio.curr.reading == NULL)
-        {
-            pipe->backend.ipc_mode.mask.rio_pending = 0;
-            ev__nonblock_io_del(pipe->base.loop, &pipe->backend.ipc_mode.io,
-                                EPOLLIN);
-        }
-    }
-    if (evts & (EPOLLOUT | EPOLLERR))
-    {
-        if ((ret = _ev_pipe_on_ipc_mode_io_write_unix(pipe)) != 0)
-        {
-            goto err;
-        }
-        if (ev_list_size(&pipe->backend.ipc_mode.wio.wqueue) == 0 &&
-            pipe->backend.ipc_mode.wio.curr.writing == NULL)
-        {
-            pipe->backend.ipc_mode.mask.wio_pending = 0;
-            ev__nonblock_io_del(pipe->base.loop, &pipe->backend.ipc_mode.io,
-                                EPOLLOUT);
-        }
-    }
-
-    return;
-
-err:
-    _ev_pipe_abort_unix(pipe, ret);
-}
-
-static void _ev_pipe_init_as_ipc_mode_unix(ev_pipe_t *pipe)
-{
-    ev__nonblock_io_init(&pipe->backend.ipc_mode.io, pipe->pipfd,
-                         _ev_pipe_on_ipc_mode_io_unix, NULL);
-    memset(&pipe->backend.ipc_mode.mask, 0,
-           sizeof(pipe->backend.ipc_mode.mask));
-
-    _ev_pipe_ipc_mode_reset_rio_curr_cnt(pipe);
-    pipe->backend.ipc_mode.rio.curr.reading = NULL;
-    ev_list_init(&pipe->backend.ipc_mode.rio.rqueue);
-
-    _ev_pipe_ipc_mode_reset_wio_curr_cnt(pipe);
-    pipe->backend.ipc_mode.wio.curr.writing = NULL;
-    ev_list_init(&pipe->backend.ipc_mode.wio.wqueue);
-}
-
-static void _ev_pipe_ipc_mode_want_write_unix(ev_pipe_t *pipe)
-{
-    if (pipe->backend.ipc_mode.mask.wio_pending)
-    {
-        return;
-    }
-
-    ev__nonblock_io_add(pipe->base.loop, &pipe->backend.ipc_mode.io, EV_IO_OUT);
-    pipe->backend.ipc_mode.mask.wio_pending = 1;
-}
-
-static void _ev_pipe_ipc_mode_want_read_unix(ev_pipe_t *pipe)
-{
-    if (pipe->backend.ipc_mode.mask.rio_pending)
-    {
-        return;
-    }
-
-    ev__nonblock_io_add(pipe->base.loop, &pipe->backend.ipc_mode.io, EV_IO_IN);
-    pipe->backend.ipc_mode.mask.rio_pending = 1;
-}
-
-static int _ev_pipe_write_ipc_mode_unix(ev_pipe_t           *pipe,
-                                        ev_pipe_write_req_t *req)
-{
-    if (req->base.capacity > UINT32_MAX)
-    {
-        return EV_E2BIG;
-    }
-
-    ev_list_push_back(&pipe->backend.ipc_mode.wio.wqueue, &req->base.node);
-    _ev_pipe_ipc_mode_want_write_unix(pipe);
-
-    return 0;
-}
-
-static int _ev_pipe_read_ipc_mode_unix(ev_pipe_t *pipe, ev_pipe_read_req_t *req)
-{
-    ev_list_push_back(&pipe->backend.ipc_mode.rio.rqueue, &req->base.node);
-    _ev_pipe_ipc_mode_want_read_unix(pipe);
-    return 0;
-}
-
-static int _ev_pipe_make_pipe(ev_os_pipe_t fds[2], int rflags, int wflags)
-{
-    int errcode;
-    fds[0] = EV_OS_PIPE_INVALID;
-    fds[1] = EV_OS_PIPE_INVALID;
-
-    if (pipe(fds) < 0)
-    {
-        errcode = errno;
-        errcode = ev__translate_sys_error(errcode);
-        goto err;
-    }
-
-    if ((errcode = ev__cloexec(fds[0], 1)) != 0)
-    {
-        goto err;
-    }
-    if ((errcode = ev__cloexec(fds[1], 1)) != 0)
-    {
-        goto err;
-    }
-
-    if (rflags & EV_PIPE_NONBLOCK)
-    {
-        if ((errcode = ev__nonblock(fds[0], 1)) != 0)
-        {
-            goto err;
-        }
-    }
-
-    if (wflags & EV_PIPE_NONBLOCK)
-    {
-        if ((errcode = ev__nonblock(fds[1], 1)) != 0)
-        {
-            goto err;
-        }
-    }
-
-    return 0;
-
-err:
-    if (fds[0] != EV_OS_PIPE_INVALID)
-    {
-        close(fds[0]);
-        fds[0] = EV_OS_PIPE_INVALID;
-    }
-    if (fds[1] != EV_OS_PIPE_INVALID)
-    {
-        close(fds[1]);
-        fds[1] = EV_OS_PIPE_INVALID;
-    }
-    return errcode;
-}
-
-static int _ev_pipe_make_socketpair(ev_os_pipe_t fds[2], int rflags, int wflags)
-{
-    int errcode;
-    if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds) != 0)
-    {
-        errcode = errno;
-        return ev__translate_sys_error(errcode);
-    }
-
-    if (rflags & EV_PIPE_NONBLOCK)
-    {
-        if ((errcode = ev__nonblock(fds[0], 1)) != 0)
-        {
-            goto err;
-        }
-    }
-
-    if (wflags & EV_PIPE_NONBLOCK)
-    {
-        if ((errcode = ev__nonblock(fds[1], 1)) != 0)
-        {
-            goto err;
-        }
-    }
-
-    return 0;
-
-err:
-    close(fds[0]);
-    close(fds[1]);
-    return errcode;
-}
-
-int ev_pipe_make(ev_os_pipe_t fds[2], int rflags, int wflags)
-{
-    if ((rflags & EV_PIPE_IPC) != (wflags & EV_PIPE_IPC))
-    {
-        return EV_EINVAL;
-    }
-
-    int is_ipc = rflags & EV_PIPE_IPC;
-
-    if (is_ipc)
-    {
-        return _ev_pipe_make_socketpair(fds, rflags, wflags);
-    }
-
-    return _ev_pipe_make_pipe(fds, rflags, wflags);
-}
-
-int ev_pipe_init(ev_loop_t *loop, ev_pipe_t **pipe, int ipc)
-{
-    ev_pipe_t *new_pipe = ev_malloc(sizeof(ev_pipe_t));
-    if (new_pipe == NULL)
-    {
-        return EV_ENOMEM;
-    }
-
-    ev__handle_init(loop, &new_pipe->base, EV_ROLE_EV_PIPE);
-    new_pipe->close_cb = NULL;
-    new_pipe->pipfd = EV_OS_PIPE_INVALID;
-    new_pipe->base.data.flags |= ipc ? EV_HANDLE_PIPE_IPC : 0;
-
-    *pipe = new_pipe;
-    return 0;
-}
-
-void ev_pipe_exit(ev_pipe_t *pipe, ev_pipe_cb close_cb, void *close_arg)
-{
-    pipe->close_cb = close_cb;
-    pipe->close_arg = close_arg;
-    _ev_pipe_abort_unix(pipe, EV_ECANCELED);
-    ev__handle_exit(&pipe->base, _ev_pipe_on_close_unix);
-}
-
-int ev_pipe_open(ev_pipe_t *pipe, ev_os_pipe_t handle)
-{
-    if (pipe->pipfd != EV_OS_PIPE_INVALID)
-    {
-        return EV_EEXIST;
-    }
-
-    int mode = ev__fcntl_getfl_unix(handle);
-    if (mode == -1)
-    {
-        return ev__translate_sys_error(errno);
-    }
-
-    int ret;
-    if ((ret = ev__nonblock(handle, 1)) != 0)
-    {
-        return ret;
-    }
-
-    pipe->pipfd = handle;
-    pipe->base.data.flags |= EV_HANDLE_PIPE_STREAMING;
-
-    if (pipe->base.data.flags & EV_HANDLE_PIPE_IPC)
-    {
-        _ev_pipe_init_as_ipc_mode_unix(pipe);
-    }
-    else
-    {
-        ev__nonblock_stream_init(
-            pipe->base.loop, &pipe->backend.data_mode.stream, handle,
-            _ev_pipe_on_data_mode_write_unix, _ev_pipe_on_data_mode_read_unix);
-    }
-
-    return 0;
-}
-
-int ev_pipe_write_ex(ev_pipe_t *pipe, ev_buf_t *bufs, size_t nbuf,
-                     ev_role_t handle_role, void *handle_addr,
-                     ev_pipe_write_cb cb, void *arg)
-{
-    if (pipe->pipfd == EV_OS_PIPE_INVALID)
-    {
-        return EV_EBADF;
-    }
-
-    ev_pipe_write_req_t *req = ev_malloc(sizeof(ev_pipe_write_req_t));
-    if (req == NULL)
-    {
-        return EV_ENOMEM;
-    }
-
-    int ret = ev__pipe_write_init_ext(req, cb, arg, bufs, nbuf, handle_role,
-                                      handle_addr);
-    if (ret != 0)
-    {
-        ev_free(req);
-        return ret;
-    }
-
-    ev__handle_active(&pipe->base);
-
-    if (pipe->base.data.flags & EV_HANDLE_PIPE_IPC)
-    {
-        ret = _ev_pipe_write_ipc_mode_unix(pipe, req);
-    }
-    else
-    {
-        ret = ev__nonblock_stream_write(&pipe->backend.data_mode.stream,
-                                        &req->base);
-    }
-
-    if (ret != 0)
-    {
-        _ev_pipe_abort_unix(pipe, ret);
-
-        /* The final state must be non-active. */
-        ev__handle_deactive(&pipe->base);
-
-        ev_free(req);
-    }
-
-    return ret;
-}
-
-int ev_pipe_read(ev_pipe_t *pipe, ev_pipe_read_req_t *req, ev_buf_t *bufs,
-                 size_t nbuf, ev_pipe_read_cb cb)
-{
-    if (pipe->pipfd == EV_OS_PIPE_INVALID)
-    {
-        return EV_EBADF;
-    }
-
-    int ret = ev__pipe_read_init(req, bufs, nbuf, cb);
-    if (ret != 0)
-    {
-        return ret;
-    }
-
-    ev__handle_active(&pipe->base);
-
-    if (pipe->base.data.flags & EV_HANDLE_PIPE_IPC)
-    {
-        ret = _ev_pipe_read_ipc_mode_unix(pipe, req);
-    }
-    else
-    {
-        ret = ev__nonblock_stream_read(&pipe->backend.data_mode.stream,
-                                       &req->base);
-    }
-
-    if (ret != 0)
-    {
-        _ev_pipe_abort_unix(pipe, ret);
-
-        /* The final state must be non-active. */
-        ev__handle_deactive(&pipe->base);
-    }
-
-    return ret;
-}
-
-int ev_pipe_accept(ev_pipe_t *pipe, ev_pipe_read_req_t *req,
-                   ev_role_t handle_role, void *handle_addr)
-{
-    if (!(pipe->base.data.flags & EV_HANDLE_PIPE_IPC) ||
-        handle_role != EV_ROLE_EV_TCP || handle_addr == NULL)
-    {
-        return EV_EINVAL;
-    }
-    if (req->handle.os_socket == EV_OS_SOCKET_INVALID)
-    {
-        return EV_ENOENT;
-    }
-
-    ev_tcp_t *tcp = handle_addr;
-    return ev__tcp_open(tcp, req->handle.os_socket);
-}
-
-void ev_pipe_close(ev_os_pipe_t fd)
-{
-    if (fd != EV_OS_PIPE_INVALID)
-    {
-        close(fd);
-    }
-}
+#define _GNU_SOURCE
+#include <assert.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <string.h>
+
+/**
+ * @brief Receive buffer size for IPC mode.
+ *
+ * Small frames are parsed from this buffer in batch, larger frame data is read
+ * into user buffer directly.
+ */
+#define EV_PIPE_IPC_RBUF_SIZE (64 * 1024)
+
+/**
+ * @brief Maximum buffers packed into one sendmsg() in IPC mode. Each frame
+ *   takes one more buffer for its header.
+ */
+#define EV_PIPE_IPC_WIOV_MAX  64
+
+typedef char ev_ipc_msghdr[CMSG_SPACE(sizeof(int) * EV_PIPE_IPC_HANDLE_MAX)];
+
+static void _ev_pipe_close_fds_unix(const int *fds, size_t num)
+{
+    size_t i;
+    for (i = 0; i < num; i++)
+    {
+        close(fds[i]);
+    }
+}
+
+static void _ev_pipe_close_unix(ev_pipe_t *pipe)
+{
+    if (pipe->pipfd != EV_OS_PIPE_INVALID)
+    {
+        close(pipe->pipfd);
+        pipe->pipfd = EV_OS_PIPE_INVALID;
+    }
+}
+
+static void _ev_pipe_on_close_unix(ev_handle_t *handle)
+{
+    ev_pipe_t *pipe_handle = EV_CONTAINER_OF(handle, ev_pipe_t, base);
+    ev_loop_t *loop = pipe_handle->base.loop;
+    ev_pipe_cb close_cb = pipe_handle->close_cb;
+    void      *close_arg = pipe_handle->close_arg;
+    if (!(pipe_handle->base.data.flags & EV_HANDLE_INPLACE))
+    {
+        ev__loop_free(loop, pipe_handle);
+    }
+
+    if (close_cb != NULL)
+    {
+        close_cb(pipe_handle, close_arg);
+    }
+}
+
+static void _ev_pipe_smart_deactive(ev_pipe_t *pipe)
+{
+    size_t io_sz = 0;
+
+    if (!ev__handle_is_active(&pipe->base))
+    {
+        return;
+    }
+
+    if (pipe->base.data.flags & EV_HANDLE_PIPE_IPC)
+    {
+        io_sz += ev_list_size(&pipe->backend.ipc_mode.rio.rqueue);
+        io_sz += pipe->backend.ipc_mode.rio.curr.reading != NULL ? 1 : 0;
+        io_sz += ev_list_size(&pipe->backend.ipc_mode.wio.wqueue);
+    }
+    else
+    {
+        io_sz = ev__nonblock_stream_size(&pipe->backend.data_mode.stream,
+                                         EV_IO_IN | EV_IO_OUT);
+    }
+
+    if (io_sz == 0)
+    {
+        ev__handle_deactive(&pipe->base);
+    }
+}
+
+static void _ev_pipe_w_user_callback_unix(ev_pipe_t           *pipe,
+                                          ev_pipe_write_req_t *req,
+                                          ssize_t              size)
+{
+    _ev_pipe_smart_deactive(pipe);
+    ev__write_exit(&req->base);
+    req->ucb(pipe, size, req->ucb_arg);
+    ev__loop_free(pipe->base.loop, req);
+}
+
+static void _ev_pipe_r_user_callback_unix(ev_pipe_t          *pipe,
+                                          ev_pipe_read_req_t *req, ssize_t size)
+{
+    _ev_pipe_smart_deactive(pipe);
+    ev__read_exit(&req->base);
+    req->ucb(req, size);
+}
+
+static void _ev_pipe_on_data_mode_write_unix(ev_nonblock_stream_t *stream,
+                                             ev_write_t *req, ssize_t size)
+{
+    ev_pipe_t *pipe_handle =
+        EV_CONTAINER_OF(stream, ev_pipe_t, backend.data_mode.stream);
+    ev_pipe_write_req_t *w_req =
+        EV_CONTAINER_OF(req, ev_pipe_write_req_t, base);
+    _ev_pipe_w_user_callback_unix(pipe_handle, w_req, size);
+}
+
+static void _ev_pipe_on_data_mode_read_unix(ev_nonblock_stream_t *stream,
+                                            ev_read_t *req, ssize_t size)
+{
+    ev_pipe_t *pipe_handle =
+        EV_CONTAINER_OF(stream, ev_pipe_t, backend.data_mode.stream);
+
+    ev_pipe_read_req_t *r_req = EV_CONTAINER_OF(req, ev_pipe_read_req_t, base);
+    _ev_pipe_r_user_callback_unix(pipe_handle, r_req, size);
+}
+
+/**
+ * @brief Move read cursor of current request forward by \p size bytes.
+ */
+static void _ev_pipe_ipc_mode_advance_rio_unix(ev_pipe_t *pipe, size_t size)
+{
+    ev_pipe_read_req_t *req = pipe->backend.ipc_mode.rio.curr.reading;
+
+    pipe->backend.ipc_mode.rio.curr.data_remain_size -= size;
+    req->base.data.size += size;
+
+    while (size > 0 &&
+           pipe->backend.ipc_mode.rio.curr.buf_idx < req->base.data.nbuf)
+    {
+        size_t left_size =
+            req->base.data.bufs[pipe->backend.ipc_mode.rio.curr.buf_idx].size -
+            pipe->backend.ipc_mode.rio.curr.buf_pos;
+
+        if (left_size > size)
+        {
+            pipe->backend.ipc_mode.rio.curr.buf_pos += size;
+            break;
+        }
+
+        size -= left_size;
+        pipe->backend.ipc_mode.rio.curr.buf_idx++;
+        pipe->backend.ipc_mode.rio.curr.buf_pos = 0;
+    }
+}
+
+/**
+ * @brief Get unfilled part of current request, limited to remain frame data.
+ * @return  Number of buffers.
+ */
+static size_t _ev_pipe_ipc_mode_rio_bufs_unix(ev_pipe_t *pipe, ev_buf_t *bufs,
+                                              size_t nbuf)
+{
+    ev_pipe_read_req_t *req = pipe->backend.ipc_mode.rio.curr.reading;
+    size_t target_size = pipe->backend.ipc_mode.rio.curr.data_remain_size;
+
+    size_t buf_idx = pipe->backend.ipc_mode.rio.curr.buf_idx;
+    size_t buf_pos = pipe->backend.ipc_mode.rio.curr.buf_pos;
+
+    size_t idx;
+    for (idx = 0;
+         idx < nbuf && target_size > 0 && buf_idx < req->base.data.nbuf;
+         idx++, buf_idx++)
+    {
+        bufs[idx].data = (uint8_t *)req->base.data.bufs[buf_idx].data + buf_pos;
+        bufs[idx].size = req->base.data.bufs[buf_idx].size - buf_pos;
+
+        bufs[idx].size = EV_MIN(bufs[idx].size, target_size);
+        target_size -= bufs[idx].size;
+
+        buf_pos = 0;
+    }
+
+    return idx;
+}
+
+/**
+ * @brief Copy buffered frame data into current request.
+ */
+static void _ev_pipe_ipc_mode_copy_data_unix(ev_pipe_t *pipe)
+{
+    ev_buf_t bufs[EV_IOV_MAX];
+    size_t   nbuf = _ev_pipe_ipc_mode_rio_bufs_unix(pipe, bufs, ARRAY_SIZE(bufs));
+
+    const uint8_t *data =
+        pipe->backend.ipc_mode.rio.buffer + pipe->backend.ipc_mode.rio.pos;
+    size_t data_size =
+        pipe->backend.ipc_mode.rio.len - pipe->backend.ipc_mode.rio.pos;
+
+    size_t i;
+    size_t copy_size = 0;
+    for (i = 0; i < nbuf && copy_size < data_size; i++)
+    {
+        size_t n = EV_MIN(bufs[i].size, data_size - copy_size);
+        memcpy(bufs[i].data, data + copy_size, n);
+        copy_size += n;
+    }
+
+    pipe->backend.ipc_mode.rio.pos += copy_size;
+    _ev_pipe_ipc_mode_advance_rio_unix(pipe, copy_size);
+}
+
+/**
+ * @brief Read frame data into current request directly.
+ * @return  Read size, 0 if try again, or #ev_errno_t.
+ */
+static ssize_t _ev_pipe_ipc_mode_read_data_unix(ev_pipe_t *pipe)
+{
+    ev_buf_t bufs[EV_IOV_MAX];
+    size_t   nbuf = _ev_pipe_ipc_mode_rio_bufs_unix(pipe, bufs, ARRAY_SIZE(bufs));
+
+    ssize_t read_size = ev__readv_unix(pipe->pipfd, bufs, nbuf);
+    if (read_size > 0)
+    {
+        _ev_pipe_ipc_mode_advance_rio_unix(pipe, read_size);
+    }
+    return read_size;
+}
+
+static ssize_t _ev_pipe_recvmsg_unix(ev_pipe_t *pipe, struct msghdr *msg)
+{
+    struct cmsghdr *cmsg;
+    ssize_t         rc;
+    int            *pfd;
+    int            *end;
+    int             fd = pipe->pipfd;
+#if defined(__linux__)
+    if (!pipe->backend.ipc_mode.mask.no_cmsg_cloexec)
+    {
+        rc = recvmsg(fd, msg, MSG_CMSG_CLOEXEC);
+        if (rc != -1)
+        {
+            return rc;
+        }
+        if ((rc = errno) != EINVAL)
+        {
+            return ev__translate_sys_error(errno);
+        }
+        rc = recvmsg(fd, msg, 0);
+        if (rc == -1)
+        {
+            return ev__translate_sys_error(errno);
+        }
+        pipe->backend.ipc_mode.mask.no_cmsg_cloexec = 1;
+    }
+    else
+    {
+        rc = recvmsg(fd, msg, 0);
+    }
+#else
+    rc = recvmsg(fd, msg, 0);
+#endif
+    if (rc == -1)
+    {
+        return ev__translate_sys_error(errno);
+    }
+    if (msg->msg_controllen == 0)
+    {
+        return rc;
+    }
+    for (cmsg = CMSG_FIRSTHDR(msg); cmsg != NULL; cmsg = CMSG_NXTHDR(msg, cmsg))
+    {
+        if (cmsg->cmsg_type == SCM_RIGHTS)
+        {
+            for (pfd = (int *)CMSG_DATA(cmsg),
+                end = (int *)((char *)cmsg + cmsg->cmsg_len);
+                 pfd < end; pfd += 1)
+            {
+                ev__cloexec(*pfd, 1);
+            }
+        }
+    }
+    return rc;
+}
+
+/**
+ * @brief Keep received handles until their frame header is parsed.
+ *
+ * The kernel never merges data after a message carrying descriptors into one
+ * read, and such frame is always sent alone, so at most one list of handles
+ * can wait.
+ */
+static int _ev_pipe_ipc_mode_parser_msghdr_unix(ev_pipe_t     *pipe,
+                                                struct msghdr *msg)
+{
+    struct cmsghdr *cmsg = CMSG_FIRSTHDR(msg);
+    if (cmsg == NULL)
+    {
+        return 0;
+    }
+
+    void  *pv = CMSG_DATA(cmsg);
+    int   *pi = pv;
+    size_t num = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+    assert(CMSG_NXTHDR(msg, cmsg) == NULL);
+
+    /* Peer never sends more than #EV_PIPE_IPC_HANDLE_MAX handles */
+    if ((msg->msg_flags & MSG_CTRUNC) ||
+        pipe->backend.ipc_mode.rio.fd_num != 0)
+    {
+        _ev_pipe_close_fds_unix(pi, num);
+        return EV_EPIPE;
+    }
+    memcpy(pipe->backend.ipc_mode.rio.fds, pi, num * sizeof(int));
+    pipe->backend.ipc_mode.rio.fd_num = num;
+
+    return 0;
+}
+
+/**
+ * @brief Receive as much as possible into receive buffer.
+ * @return  Read size, 0 if try again, or #ev_errno_t.
+ */
+static ssize_t _ev_pipe_ipc_mode_recv_unix(ev_pipe_t *pipe)
+{
+    uint8_t *buffer = pipe->backend.ipc_mode.rio.buffer;
+    size_t   data_size =
+        pipe->backend.ipc_mode.rio.len - pipe->backend.ipc_mode.rio.pos;
+
+    /* Only a partial frame header may be left */
+    if (pipe->backend.ipc_mode.rio.pos != 0)
+    {
+        memmove(buffer, buffer + pipe->backend.ipc_mode.rio.pos, data_size);
+        pipe->backend.ipc_mode.rio.pos = 0;
+        pipe->backend.ipc_mode.rio.len = data_size;
+    }
+
+    /*
+     * Finish a partial frame header before reading more, so handle from next
+     * message cannot arrive before the waiting one is taken.
+     */
+    size_t buffer_size = EV_PIPE_IPC_RBUF_SIZE - data_size;
+    if (data_size != 0 && pipe->backend.ipc_mode.rio.curr.data_remain_size == 0)
+    {
+        buffer_size = sizeof(ev_ipc_frame_hdr_t) - data_size;
+    }
+
+    struct msghdr msg;
+    ev_ipc_msghdr cmsg_space;
+    struct iovec  iov = { buffer + data_size, buffer_size };
+
+    /* ipc uses recvmsg */
+    msg.msg_flags = 0;
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_name = NULL;
+    msg.msg_namelen = 0;
+    /* Set up to receive a descriptor even if one isn't in the message */
+    msg.msg_controllen = sizeof(cmsg_space);
+    msg.msg_control = cmsg_space;
+
+    ssize_t read_size = _ev_pipe_recvmsg_unix(pipe, &msg);
+    if (read_size == EV_EAGAIN)
+    {
+        return 0;
+    }
+    if (read_size == 0)
+    {
+        return EV_EOF;
+    }
+    if (read_size < 0)
+    {
+        return read_size;
+    }
+
+    pipe->backend.ipc_mode.rio.len += read_size;
+
+    int ret = _ev_pipe_ipc_mode_parser_msghdr_unix(pipe, &msg);
+    return ret != 0 ? ret : read_size;
+}
+
+/**
+ * @brief Parse buffered frame header for current request.
+ */
+static int _ev_pipe_ipc_mode_parse_frame_hdr_unix(ev_pipe_t *pipe)
+{
+    const uint8_t *buffer =
+        pipe->backend.ipc_mode.rio.buffer + pipe->backend.ipc_mode.rio.pos;
+
+    /* A invalid frame header means something wrong in the transmission link */
+    if (!ev__ipc_check_frame_hdr(buffer, sizeof(ev_ipc_frame_hdr_t)))
+    {
+        return EV_EPIPE;
+    }
+
+    ev_ipc_frame_hdr_t hdr;
+    memcpy(&hdr, buffer, sizeof(hdr));
+    pipe->backend.ipc_mode.rio.pos += sizeof(hdr);
+    pipe->backend.ipc_mode.rio.curr.data_remain_size = hdr.hdr_dtsz;
+
+    if (hdr.hdr_flags & EV_IPC_FRAME_FLAG_HANDLE)
+    {
+        ev_pipe_read_req_t *req = pipe->backend.ipc_mode.rio.curr.reading;
+        memcpy(req->handle.os_socket, pipe->backend.ipc_mode.rio.fds,
+               pipe->backend.ipc_mode.rio.fd_num * sizeof(int));
+        req->handle.num = pipe->backend.ipc_mode.rio.fd_num;
+        req->handle.pos = 0;
+        pipe->backend.ipc_mode.rio.fd_num = 0;
+    }
+
+    return 0;
+}
+
+static int _ev_pipe_on_ipc_mode_io_read_unix(ev_pipe_t *pipe)
+{
+    ssize_t ret;
+
+    for (;;)
+    {
+        if (pipe->backend.ipc_mode.rio.curr.reading == NULL)
+        {
+            ev_list_node_t *it =
+                ev_list_pop_front(&pipe->backend.ipc_mode.rio.rqueue);
+            if (it == NULL)
+            {
+                return 0;
+            }
+
+            pipe->backend.ipc_mode.rio.curr.reading =
+                EV_CONTAINER_OF(it, ev_pipe_read_req_t, base.node);
+            pipe->backend.ipc_mode.rio.curr.buf_idx = 0;
+            pipe->backend.ipc_mode.rio.curr.buf_pos = 0;
+        }
+
+        size_t data_size =
+            pipe->backend.ipc_mode.rio.len - pipe->backend.ipc_mode.rio.pos;
+        if (pipe->backend.ipc_mode.rio.curr.data_remain_size == 0)
+        {
+            /* If frame header not read complete, try again */
+            if (data_size < sizeof(ev_ipc_frame_hdr_t))
+            {
+                if ((ret = _ev_pipe_ipc_mode_recv_unix(pipe)) <= 0)
+                {
+                    return ret;
+                }
+                continue;
+            }
+
+            if ((ret = _ev_pipe_ipc_mode_parse_frame_hdr_unix(pipe)) != 0)
+            {
+                return ret;
+            }
+            data_size -= sizeof(ev_ipc_frame_hdr_t);
+        }
+
+        /* Empty package is finished without reading */
+        if (pipe->backend.ipc_mode.rio.curr.data_remain_size != 0)
+        {
+            if (data_size != 0)
+            {
+                _ev_pipe_ipc_mode_copy_data_unix(pipe);
+            }
+            else if (pipe->backend.ipc_mode.rio.curr.data_remain_size >=
+                     EV_PIPE_IPC_RBUF_SIZE)
+            {
+                /* Large data bypass receive buffer */
+                if ((ret = _ev_pipe_ipc_mode_read_data_unix(pipe)) <= 0)
+                {
+                    return ret;
+                }
+            }
+            else
+            {
+                if ((ret = _ev_pipe_ipc_mode_recv_unix(pipe)) <= 0)
+                {
+                    return ret;
+                }
+                continue;
+            }
+        }
+
+        ev_pipe_read_req_t *req = pipe->backend.ipc_mode.rio.curr.reading;
+        if (pipe->backend.ipc_mode.rio.curr.data_remain_size != 0 &&
+            pipe->backend.ipc_mode.rio.curr.buf_idx < req->base.data.nbuf)
+        {
+            continue;
+        }
+
+        /* Frame finished or buffer is full */
+        pipe->backend.ipc_mode.rio.curr.reading = NULL;
+        _ev_pipe_r_user_callback_unix(pipe, req, req->base.data.size);
+
+        /* Pipe closed in callback */
+        if (pipe->pipfd == EV_OS_PIPE_INVALID)
+        {
+            return 0;
+        }
+    }
+}
+
+static ssize_t _ev_pipe_sendmsg_unix(int fd, const int *fds_to_send,
+                                     size_t nfd, struct iovec *iov, int iovcnt)
+{
+    struct msghdr   msg;
+    struct cmsghdr *cmsg;
+
+    ev_ipc_msghdr msg_ctrl_hdr;
+    memset(&msg_ctrl_hdr, 0, sizeof(msg_ctrl_hdr));
+
+    msg.msg_name = NULL;
+    msg.msg_namelen = 0;
+    msg.msg_iov = iov;
+    msg.msg_iovlen = iovcnt;
+    msg.msg_flags = 0;
+    msg.msg_control = NULL;
+    msg.msg_controllen = 0;
+
+    if (nfd != 0)
+    {
+        msg.msg_control = msg_ctrl_hdr;
+        msg.msg_controllen = CMSG_SPACE(sizeof(int) * nfd);
+
+        cmsg = CMSG_FIRSTHDR(&msg);
+        cmsg->cmsg_level = SOL_SOCKET;
+        cmsg->cmsg_type = SCM_RIGHTS;
+        cmsg->cmsg_len = CMSG_LEN(sizeof(int) * nfd);
+        memcpy(CMSG_DATA(cmsg), fds_to_send, sizeof(int) * nfd);
+    }
+
+    ssize_t n;
+    do
+    {
+        n = sendmsg(fd, &msg, 0);
+    } while (n == -1 && errno == EINTR);
+
+    if (n >= 0)
+    {
+        return n;
+    }
+
+    int err = errno;
+    if (err == EAGAIN || err == EWOULDBLOCK)
+    {
+        return 0;
+    }
+    return ev__translate_sys_error(err);
+}
+
+/**
+ * @brief Append unsent part of \p req to \p iov.
+ * @param[in] req       Write request
+ * @param[out] iov      Buffer list
+ * @param[in] niov      Buffer list capacity
+ * @param[in,out] size  Total size of appended buffers is added
+ * @return              Number of appended buffers
+ */
+static size_t _ev_pipe_ipc_mode_fill_iov_unix(ev_pipe_write_req_t *req,
+                                              ev_buf_t *iov, size_t niov,
+                                              size_t *size)
+{
+    size_t idx = 0;
+    size_t skip = req->backend.sent;
+
+    if (skip < sizeof(req->backend.hdr))
+    {
+        iov[idx].data = (uint8_t *)&req->backend.hdr + skip;
+        iov[idx].size = sizeof(req->backend.hdr) - skip;
+        *size += iov[idx].size;
+        idx++;
+        skip = 0;
+    }
+    else
+    {
+        skip -= sizeof(req->backend.hdr);
+    }
+
+    size_t i;
+    for (i = 0; i < req->base.nbuf && idx < niov; i++)
+    {
+        ev_buf_t *buf = &req->base.bufs[i];
+        if (skip >= buf->size)
+        {
+            skip -= buf->size;
+            continue;
+        }
+
+        iov[idx].data = (uint8_t *)buf->data + skip;
+        iov[idx].size = buf->size - skip;
+        *size += iov[idx].size;
+        idx++;
+        skip = 0;
+    }
+
+    return idx;
+}
+
+static size_t _ev_pipe_ipc_mode_frame_left_unix(ev_pipe_write_req_t *req)
+{
+    return sizeof(req->backend.hdr) + req->base.capacity - req->backend.sent;
+}
+
+/**
+ * @brief Move fully sent requests from write queue to \p done.
+ */
+static void _ev_pipe_ipc_mode_commit_wio_unix(ev_pipe_t *pipe, size_t size,
+                                              ev_list_t *done)
+{
+    ev_list_node_t *it;
+    while ((it = ev_list_begin(&pipe->backend.ipc_mode.wio.wqueue)) != NULL)
+    {
+        ev_pipe_write_req_t *req =
+            EV_CONTAINER_OF(it, ev_pipe_write_req_t, base.node);
+        size_t left_size = _ev_pipe_ipc_mode_frame_left_unix(req);
+        if (size < left_size)
+        {
+            req->backend.sent += size;
+            break;
+        }
+
+        size -= left_size;
+        req->backend.sent += left_size;
+        req->base.size = req->base.capacity;
+        ev_list_erase(&pipe->backend.ipc_mode.wio.wqueue, it);
+        ev_list_push_back(done, it);
+    }
+}
+
+static int _ev_pipe_on_ipc_mode_io_write_unix(ev_pipe_t *pipe)
+{
+    int             ret = 0;
+    ev_list_t       done = EV_LIST_INIT;
+    ev_list_node_t *it;
+    ev_buf_t        iov[EV_PIPE_IPC_WIOV_MAX];
+
+    while ((it = ev_list_begin(&pipe->backend.ipc_mode.wio.wqueue)) != NULL)
+    {
+        ev_pipe_write_req_t *first =
+            EV_CONTAINER_OF(it, ev_pipe_write_req_t, base.node);
+        size_t nfd = first->handle.num;
+
+        /* Pack as many frames as possible into one message */
+        size_t niov = 0;
+        size_t size = 0;
+        for (; it != NULL && niov < ARRAY_SIZE(iov); it = ev_list_next(it))
+        {
+            ev_pipe_write_req_t *req =
+                EV_CONTAINER_OF(it, ev_pipe_write_req_t, base.node);
+            if (req != first && req->handle.num != 0)
+            {
+                break;
+            }
+
+            size_t left_size = _ev_pipe_ipc_mode_frame_left_unix(req);
+            size_t fill_size = 0;
+            niov += _ev_pipe_ipc_mode_fill_iov_unix(
+                req, iov + niov, ARRAY_SIZE(iov) - niov, &fill_size);
+            size += fill_size;
+
+            if (fill_size < left_size || nfd != 0)
+            {
+                break;
+            }
+        }
+
+        ssize_t send_size =
+            _ev_pipe_sendmsg_unix(pipe->pipfd, first->handle.os_socket, nfd,
+                                  (struct iovec *)iov, (int)niov);
+        if (send_size < 0)
+        { /* send_size is error code */
+            EV_LOG_ERROR("pipe(%p) data send failed, err:%d", pipe,
+                         (int)send_size);
+            ret = (int)send_size;
+            break;
+        }
+        if (send_size > 0 && nfd != 0)
+        {
+            first->handle.role = EV_ROLE_UNKNOWN;
+            first->handle.num = 0;
+        }
+
+        _ev_pipe_ipc_mode_commit_wio_unix(pipe, send_size, &done);
+
+        /* If data not send, try again */
+        if ((size_t)send_size < size)
+        {
+            break;
+        }
+    }
+
+    while ((it = ev_list_pop_front(&done)) != NULL)
+    {
+        ev_pipe_write_req_t *req =
+            EV_CONTAINER_OF(it, ev_pipe_write_req_t, base.node);
+        _ev_pipe_w_user_callback_unix(pipe, req, req->base.size);
+    }
+
+    return ret;
+}
+
+static void _ev_pipe_ipc_mode_reset_rio_curr_cnt(ev_pipe_t *pipe)
+{
+    pipe->backend.ipc_mode.rio.curr.data_remain_size = 0;
+    pipe->backend.ipc_mode.rio.curr.buf_idx = 0;
+    pipe->backend.ipc_mode.rio.curr.buf_pos = 0;
+}
+
+static void _ev_pipe_ipc_mode_cancel_all_rio_unix(ev_pipe_t *pipe, int stat)
+{
+    ev_list_node_t *it;
+    while ((it = ev_list_pop_front(&pipe->backend.ipc_mode.rio.rqueue)) != NULL)
+    {
+        ev_pipe_read_req_t *req =
+            EV_CONTAINER_OF(it, ev_pipe_read_req_t, base.node);
+        _ev_pipe_r_user_callback_unix(pipe, req, stat);
+    }
+}
+
+static void _ev_pipe_ipc_mode_cancel_all_wio_unix(ev_pipe_t *pipe, int stat)
+{
+    ev_list_node_t *it;
+    while ((it = ev_list_pop_front(&pipe->backend.ipc_mode.wio.wqueue)) != NULL)
+    {
+        ev_pipe_write_req_t *req =
+            EV_CONTAINER_OF(it, ev_pipe_write_req_t, base.node);
+        _ev_pipe_w_user_callback_unix(pipe, req, stat);
+    }
+}
+
+static void _ev_pipe_ipc_mode_exit_rio_unix(ev_pipe_t *pipe)
+{
+    ev__loop_free(pipe->base.loop, pipe->backend.ipc_mode.rio.buffer);
+    pipe->backend.ipc_mode.rio.buffer = NULL;
+
+    _ev_pipe_close_fds_unix(pipe->backend.ipc_mode.rio.fds,
+                            pipe->backend.ipc_mode.rio.fd_num);
+    pipe->backend.ipc_mode.rio.fd_num = 0;
+}
+
+static void _ev_pipe_abort_unix(ev_pipe_t *pipe, int stat)
+{
+    if (pipe->base.data.flags & EV_HANDLE_PIPE_IPC)
+    {
+        if (pipe->base.data.flags & EV_HANDLE_PIPE_STREAMING)
+        {
+            ev__nonblock_io_del(pipe->base.loop, &pipe->backend.ipc_mode.io,
+                                EV_IO_IN | EV_IO_OUT);
+            _ev_pipe_close_unix(pipe);
+            _ev_pipe_ipc_mode_exit_rio_unix(pipe);
+            pipe->base.data.flags &= ~EV_HANDLE_PIPE_STREAMING;
+
+            _ev_pipe_ipc_mode_cancel_all_rio_unix(pipe, stat);
+            _ev_pipe_ipc_mode_cancel_all_wio_unix(pipe, stat);
+        }
+    }
+    else
+    {
+        if (pipe->base.data.flags & EV_HANDLE_PIPE_STREAMING)
+        {
+            ev__nonblock_stream_exit(&pipe->backend.data_mode.stream);
+            pipe->base.data.flags &= ~EV_HANDLE_PIPE_STREAMING;
+        }
+        _ev_pipe_close_unix(pipe);
+    }
+}
+
+static void _ev_pipe_ipc_mode_on_read_done_unix(ev_pipe_t *pipe)
+{
+    if (ev_list_size(&pipe->backend.ipc_mode.rio.rqueue) == 0 &&
+        pipe->backend.ipc_mode.rio.curr.reading == NULL)
+    {
+        pipe->backend.ipc_mode.mask.rio_pending = 0;
+        ev__nonblock_io_del(pipe->base.loop, &pipe->backend.ipc_mode.io,
+                            EPOLLIN);
+    }
+}
+
+static void _ev_pipe_on_ipc_mode_io_unix(ev_nonblock_io_t *io, unsigned evts,
+                                         void *arg)
+{
+    (void)arg;
+
+    int        ret = 0;
+    ev_pipe_t *pipe = EV_CONTAINER_OF(io, ev_pipe_t, backend.ipc_mode.io);
+
+    if (evts & (EPOLLIN | EPOLLHUP))
+    {
+        if ((ret = _ev_pipe_on_ipc_mode_io_read_unix(pipe)) != 0)
+        {
+            goto err;
+        }
+        _ev_pipe_ipc_mode_on_read_done_unix(pipe);
+    }
+    if (evts & (EPOLLOUT | EPOLLERR))
+    {
+        if ((ret = _ev_pipe_on_ipc_mode_io_write_unix(pipe)) != 0)
+        {
+            goto err;
+        }
+        if (ev_list_size(&pipe->backend.ipc_mode.wio.wqueue) == 0)
+        {
+            pipe->backend.ipc_mode.mask.wio_pending = 0;
+            ev__nonblock_io_del(pipe->base.loop, &pipe->backend.ipc_mode.io,
+                                EPOLLOUT);
+        }
+    }
+
+    return;
+
+err:
+    _ev_pipe_abort_unix(pipe, ret);
+}
+
+/**
+ * @brief Deliver frames left in receive buffer, which will not wake up poll.
+ */
+static void _ev_pipe_on_ipc_mode_read_backlog_unix(ev_handle_t *handle)
+{
+    int        ret;
+    ev_pipe_t *pipe = EV_CONTAINER_OF(handle, ev_pipe_t, base);
+    if (pipe->pipfd == EV_OS_PIPE_INVALID)
+    {
+        return;
+    }
+
+    if ((ret = _ev_pipe_on_ipc_mode_io_read_unix(pipe)) != 0)
+    {
+        _ev_pipe_abort_unix(pipe, ret);
+        return;
+    }
+    _ev_pipe_ipc_mode_on_read_done_unix(pipe);
+}
+
+static int _ev_pipe_init_as_ipc_mode_unix(ev_pipe_t *pipe)
+{
+    pipe->backend.ipc_mode.rio.buffer = ev__loop_malloc(
+        pipe->base.loop, EV_ALLOCATOR_TYPE_PIPE, EV_PIPE_IPC_RBUF_SIZE);
+    if (pipe->backend.ipc_mode.rio.buffer == NULL)
+    {
+        return EV_ENOMEM;
+    }
+    pipe->backend.ipc_mode.rio.pos = 0;
+    pipe->backend.ipc_mode.rio.len = 0;
+    pipe->backend.ipc_mode.rio.fd_num = 0;
+
+    ev__nonblock_io_init(&pipe->backend.ipc_mode.io, pipe->pipfd,
+                         _ev_pipe_on_ipc_mode_io_unix, NULL);
+    memset(&pipe->backend.ipc_mode.mask, 0,
+           sizeof(pipe->backend.ipc_mode.mask));
+
+    _ev_pipe_ipc_mode_reset_rio_curr_cnt(pipe);
+    pipe->backend.ipc_mode.rio.curr.reading = NULL;
+    ev_list_init(&pipe->backend.ipc_mode.rio.rqueue);
+
+    ev_list_init(&pipe->backend.ipc_mode.wio.wqueue);
+
+    return 0;
+}
+
+static void _ev_pipe_ipc_mode_want_write_unix(ev_pipe_t *pipe)
+{
+    if (pipe->backend.ipc_mode.mask.wio_pending)
+    {
+        return;
+    }
+
+    ev__nonblock_io_add(pipe->base.loop, &pipe->backend.ipc_mode.io, EV_IO_OUT);
+    pipe->backend.ipc_mode.mask.wio_pending = 1;
+}
+
+static void _ev_pipe_ipc_mode_want_read_unix(ev_pipe_t *pipe)
+{
+    if (pipe->backend.ipc_mode.rio.len != pipe->backend.ipc_mode.rio.pos)
+    {
+        ev__backlog_submit(&pipe->base, _ev_pipe_on_ipc_mode_read_backlog_unix);
+    }
+
+    if (pipe->backend.ipc_mode.mask.rio_pending)
+    {
+        return;
+    }
+
+    ev__nonblock_io_add(pipe->base.loop, &pipe->backend.ipc_mode.io, EV_IO_IN);
+    pipe->backend.ipc_mode.mask.rio_pending = 1;
+}
+
+static int _ev_pipe_write_ipc_mode_unix(ev_pipe_t           *pipe,
+                                        ev_pipe_write_req_t *req)
+{
+    if (req->base.capacity > UINT32_MAX)
+    {
+        return EV_E2BIG;
+    }
+
+    uint8_t flags =
+        req->handle.num != 0 ? EV_IPC_FRAME_FLAG_HANDLE : 0;
+    ev__ipc_init_frame_hdr(&req->backend.hdr, flags, 0,
+                           (uint32_t)req->base.capacity);
+    req->backend.sent = 0;
+
+    ev_list_push_back(&pipe->backend.ipc_mode.wio.wqueue, &req->base.node);
+    _ev_pipe_ipc_mode_want_write_unix(pipe);
+
+    return 0;
+}
+
+static int _ev_pipe_read_ipc_mode_unix(ev_pipe_t *pipe, ev_pipe_read_req_t *req)
+{
+    ev_list_push_back(&pipe->backend.ipc_mode.rio.rqueue, &req->base.node);
+    _ev_pipe_ipc_mode_want_read_unix(pipe);
+    return 0;
+}
+
+static int _ev_pipe_make_pipe(ev_os_pipe_t fds[2], int rflags, int wflags)
+{
+    int errcode;
+    fds[0] = EV_OS_PIPE_INVALID;
+    fds[1] = EV_OS_PIPE_INVALID;
+
+    if (pipe(fds) < 0)
+    {
+        errcode = errno;
+        errcode = ev__translate_sys_error(errcode);
+        goto err;
+    }
+
+    if ((errcode = ev__cloexec(fds[0], 1)) != 0)
+    {
+        goto err;
+    }
+    if ((errcode = ev__cloexec(fds[1], 1)) != 0)
+    {
+        goto err;
+    }
+
+    if (rflags & EV_PIPE_NONBLOCK)
+    {
+        if ((errcode = ev__nonblock(fds[0], 1)) != 0)
+        {
+            goto err;
+        }
+    }
+
+    if (wflags & EV_PIPE_NONBLOCK)
+    {
+        if ((errcode = ev__nonblock(fds[1], 1)) != 0)
+        {
+            goto err;
+        }
+    }
+
+    return 0;
+
+err:
+    if (fds[0] != EV_OS_PIPE_INVALID)
+    {
+        close(fds[0]);
+        fds[0] = EV_OS_PIPE_INVALID;
+    }
+    if (fds[1] != EV_OS_PIPE_INVALID)
+    {
+        close(fds[1]);
+        fds[1] = EV_OS_PIPE_INVALID;
+    }
+    return errcode;
+}
+
+static int _ev_pipe_make_socketpair(ev_os_pipe_t fds[2], int rflags, int wflags)
+{
+    int errcode;
+    if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds) != 0)
+    {
+        errcode = errno;
+        return ev__translate_sys_error(errcode);
+    }
+
+    if (rflags & EV_PIPE_NONBLOCK)
+    {
+        if ((errcode = ev__nonblock(fds[0], 1)) != 0)
+        {
+            goto err;
+        }
+    }
+
+    if (wflags & EV_PIPE_NONBLOCK)
+    {
+        if ((errcode = ev__nonblock(fds[1], 1)) != 0)
+        {
+            goto err;
+        }
+    }
+
+    return 0;
+
+err:
+    close(fds[0]);
+    close(fds[1]);
+    return errcode;
+}
+
+int ev_pipe_make(ev_os_pipe_t fds[2], int rflags, int wflags)
+{
+    if ((rflags & EV_PIPE_IPC) != (wflags & EV_PIPE_IPC))
+    {
+        return EV_EINVAL;
+    }
+
+    int is_ipc = rflags & EV_PIPE_IPC;
+
+    if (is_ipc)
+    {
+        return _ev_pipe_make_socketpair(fds, rflags, wflags);
+    }
+
+    return _ev_pipe_make_pipe(fds, rflags, wflags);
+}
+
+static void _ev_pipe_init_unix(ev_loop_t *loop, ev_pipe_t *pipe, int ipc)
+{
+    ev__handle_init(loop, &pipe->base, EV_ROLE_EV_PIPE);
+    pipe->close_cb = NULL;
+    pipe->pipfd = EV_OS_PIPE_INVALID;
+    pipe->base.data.flags |= ipc ? EV_HANDLE_PIPE_IPC : 0;
+}
+
+size_t ev_pipe_size(void)
+{
+    return sizeof(ev_pipe_t);
+}
+
+int ev_pipe_init(ev_loop_t *loop, ev_pipe_t **pipe, int ipc)
+{
+    ev_pipe_t *new_pipe =
+        ev__loop_malloc(loop, EV_ALLOCATOR_TYPE_PIPE, sizeof(ev_pipe_t));
+    if (new_pipe == NULL)
+    {
+        return EV_ENOMEM;
+    }
+
+    _ev_pipe_init_unix(loop, new_pipe, ipc);
+
+    *pipe = new_pipe;
+    return 0;
+}
+
+int ev_pipe_init_inplace(ev_loop_t *loop, ev_pipe_t **pipe, int ipc, void *mem)
+{
+    ev_pipe_t *new_pipe = mem;
+
+    _ev_pipe_init_unix(loop, new_pipe, ipc);
+    new_pipe->base.data.flags |= EV_HANDLE_INPLACE;
+
+    *pipe = new_pipe;
+    return 0;
+}
+
+void ev_pipe_exit(ev_pipe_t *pipe, ev_pipe_cb close_cb, void *close_arg)
+{
+    pipe->close_cb = close_cb;
+    pipe->close_arg = close_arg;
+    _ev_pipe_abort_unix(pipe, EV_ECANCELED);
+    ev__handle_exit(&pipe->base, _ev_pipe_on_close_unix);
+}
+
+int ev_pipe_open(ev_pipe_t *pipe, ev_os_pipe_t handle)
+{
+    if (pipe->pipfd != EV_OS_PIPE_INVALID)
+    {
+        return EV_EEXIST;
+    }
+
+    int mode = ev__fcntl_getfl_unix(handle);
+    if (mode == -1)
+    {
+        return ev__translate_sys_error(errno);
+    }
+
+    int ret;
+    if ((ret = ev__nonblock(handle, 1)) != 0)
+    {
+        return ret;
+    }
+
+    pipe->pipfd = handle;
+
+    if (pipe->base.data.flags & EV_HANDLE_PIPE_IPC)
+    {
+        if ((ret = _ev_pipe_init_as_ipc_mode_unix(pipe)) != 0)
+        {
+            pipe->pipfd = EV_OS_PIPE_INVALID;
+            return ret;
+        }
+    }
+    else
+    {
+        ev__nonblock_stream_init(
+            pipe->base.loop, &pipe->backend.data_mode.stream, handle,
+            _ev_pipe_on_data_mode_write_unix, _ev_pipe_on_data_mode_read_unix);
+        pipe->backend.data_mode.wm_cb = NULL;
+        pipe->backend.data_mode.wm_arg = NULL;
+    }
+    pipe->base.data.flags |= EV_HANDLE_PIPE_STREAMING;
+
+    return 0;
+}
+
+static void _ev_pipe_on_data_mode_watermark_unix(ev_nonblock_stream_t *stream,
+                                                 int                   high)
+{
+    ev_pipe_t *pipe =
+        EV_CONTAINER_OF(stream, ev_pipe_t, backend.data_mode.stream);
+    pipe->backend.data_mode.wm_cb(pipe, high, pipe->backend.data_mode.wm_arg);
+}
+
+int ev_pipe_set_watermark(ev_pipe_t *pipe, size_t low, size_t high,
+                          ev_pipe_watermark_cb cb, void *arg)
+{
+    if (pipe->pipfd == EV_OS_PIPE_INVALID)
+    {
+        return EV_EBADF;
+    }
+    if (pipe->base.data.flags & EV_HANDLE_PIPE_IPC)
+    {
+        return EV_ENOSYS;
+    }
+    if (low > high)
+    {
+        return EV_EINVAL;
+    }
+
+    pipe->backend.data_mode.wm_cb = cb;
+    pipe->backend.data_mode.wm_arg = arg;
+    ev__nonblock_stream_watermark(
+        &pipe->backend.data_mode.stream, low, high,
+        cb != NULL ? _ev_pipe_on_data_mode_watermark_unix : NULL);
+    return 0;
+}
+
+EV_LOCAL int ev__pipe_data_stream_unix(ev_pipe_t *pipe,
+                                       ev_nonblock_stream_t **stream)
+{
+    if (pipe->pipfd == EV_OS_PIPE_INVALID)
+    {
+        return EV_EBADF;
+    }
+    if (pipe->base.data.flags & EV_HANDLE_PIPE_IPC)
+    {
+        return EV_ENOSYS;
+    }
+
+    *stream = &pipe->backend.data_mode.stream;
+    return 0;
+}
+
+EV_LOCAL void ev__pipe_smart_deactive_unix(ev_pipe_t *pipe)
+{
+    _ev_pipe_smart_deactive(pipe);
+}
+
+ssize_t ev_pipe_write_queue_size(ev_pipe_t *pipe)
+{
+    if (pipe->pipfd == EV_OS_PIPE_INVALID)
+    {
+        return EV_EBADF;
+    }
+    if (pipe->base.data.flags & EV_HANDLE_PIPE_IPC)
+    {
+        return EV_ENOSYS;
+    }
+    return (ssize_t)pipe->backend.data_mode.stream.pending.w_size;
+}
+
+int ev_pipe_write_handles(ev_pipe_t *pipe, ev_buf_t *bufs, size_t nbuf,
+                          ev_role_t handle_role, void **handle_addrs,
+                          size_t handle_num, ev_pipe_write_cb cb, void *arg)
+{
+    if (pipe->pipfd == EV_OS_PIPE_INVALID)
+    {
+        return EV_EBADF;
+    }
+
+    ev_pipe_write_req_t *req = ev__loop_malloc(
+        pipe->base.loop, EV_ALLOCATOR_TYPE_PIPE, sizeof(ev_pipe_write_req_t));
+    if (req == NULL)
+    {
+        return EV_ENOMEM;
+    }
+
+    int ret = ev__pipe_write_init_ext(req, cb, arg, bufs, nbuf, handle_role,
+                                      handle_addrs, handle_num);
+    if (ret != 0)
+    {
+        ev__loop_free(pipe->base.loop, req);
+        return ret;
+    }
+
+    ev__handle_active(&pipe->base);
+
+    if (pipe->base.data.flags & EV_HANDLE_PIPE_IPC)
+    {
+        ret = _ev_pipe_write_ipc_mode_unix(pipe, req);
+    }
+    else
+    {
+        ret = ev__nonblock_stream_write(&pipe->backend.data_mode.stream,
+                                        &req->base);
+    }
+
+    if (ret != 0)
+    {
+        _ev_pipe_abort_unix(pipe, ret);
+
+        /* The final state must be non-active. */
+        ev__handle_deactive(&pipe->base);
+
+        ev__loop_free(pipe->base.loop, req);
+    }
+
+    return ret;
+}
+
+int ev_pipe_read(ev_pipe_t *pipe, ev_pipe_read_req_t *req, ev_buf_t *bufs,
+                 size_t nbuf, ev_pipe_read_cb cb)
+{
+    if (pipe->pipfd == EV_OS_PIPE_INVALID)
+    {
+        return EV_EBADF;
+    }
+
+    int ret = ev__pipe_read_init(req, bufs, nbuf, cb);
+    if (ret != 0)
+    {
+        return ret;
+    }
+
+    ev__handle_active(&pipe->base);
+
+    if (pipe->base.data.flags & EV_HANDLE_PIPE_IPC)
+    {
+        ret = _ev_pipe_read_ipc_mode_unix(pipe, req);
+    }
+    else
+    {
+        ret = ev__nonblock_stream_read(&pipe->backend.data_mode.stream,
+                                       &req->base);
+    }
+
+    if (ret != 0)
+    {
+        _ev_pipe_abort_unix(pipe, ret);
+
+        /* The final state must be non-active. */
+        ev__handle_deactive(&pipe->base);
+    }
+
+    return ret;
+}
+
+int ev_pipe_accept(ev_pipe_t *pipe, ev_pipe_read_req_t *req,
+                   ev_role_t handle_role, void *handle_addr)
+{
+    if (!(pipe->base.data.flags & EV_HANDLE_PIPE_IPC) || handle_addr == NULL)
+    {
+        return EV_EINVAL;
+    }
+    if (req->handle.pos >= req->handle.num)
+    {
+        return EV_ENOENT;
+    }
+
+    int ret;
+    int taken;
+    int fd = req->handle.os_socket[req->handle.pos];
+    switch (handle_role)
+    {
+    case EV_ROLE_EV_TCP:
+        ret = ev__tcp_open(handle_addr, fd);
+        /* Socket stays with handle if only its options failed */
+        taken = ret == 0 || ((ev_tcp_t *)handle_addr)->sock == fd;
+        break;
+
+    case EV_ROLE_EV_SHM_CHANNEL:
+        ret = ev__shm_channel_attach_unix(handle_addr, fd);
+        taken = ret == 0;
+        break;
+
+    default:
+        ret = EV_EINVAL;
+        taken = 0;
+        break;
+    }
+
+    /* Ownership is moved to accepted handle */
+    if (taken)
+    {
+        req->handle.os_socket[req->handle.pos] = EV_OS_SOCKET_INVALID;
+        req->handle.pos++;
+    }
+
+    return ret;
+}
+
+void ev_pipe_discard(ev_pipe_read_req_t *req)
+{
+    for (; req->handle.pos < req->handle.num; req->handle.pos++)
+    {
+        close(req->handle.os_socket[req->handle.pos]);
+        req->handle.os_socket[req->handle.pos] = EV_OS_SOCKET_INVALID;
+    }
+}
+
+void ev_pipe_close(ev_os_pipe_t fd)
+{
+    if (fd != EV_OS_PIPE_INVALID)
+    {
+        close(fd);
+    }
+}
@@ -0,0 +1,25 @@
+#ifndef __EV_PIPE_UNIX_H__
+#define __EV_PIPE_UNIX_H__
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Get stream of data mode pipe.
+ * @param[in] pipe      Pipe handle
+ * @param[out] stream   Stream of \p pipe
+ * @return              #ev_errno_t. #EV_ENOSYS if \p pipe is in IPC mode.
+ */
+EV_LOCAL int ev__pipe_data_stream_unix(ev_pipe_t *pipe,
+                                       ev_nonblock_stream_t **stream);
+
+/**
+ * @brief Deactive \p pipe if there is no pending IO.
+ * @param[in] pipe      Pipe handle
+ */
+EV_LOCAL void ev__pipe_smart_deactive_unix(ev_pipe_t *pipe);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
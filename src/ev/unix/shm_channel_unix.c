@@ -0,0 +1,382 @@
+#include <string.h>
+
+#define EV_SHM_CHANNEL_MAGIC    0x45565343
+
+/**
+ * @brief Length prefix marking the rest of ring is unused, the next message
+ *   starts at the beginning of ring.
+ */
+#define EV_SHM_CHANNEL_WRAP     UINT32_MAX
+
+#define EV_SHM_CHANNEL_MIN_SIZE 64
+#define EV_SHM_CHANNEL_MAX_SIZE ((size_t)1 << 30)
+
+/**
+ * @brief Messages handled in one wakeup before yielding to other handles.
+ */
+#define EV_SHM_CHANNEL_RECV_BATCH 1024
+
+static size_t _ev_shm_channel_record_size(size_t size)
+{
+    return EV_ALIGN_SIZE(sizeof(uint32_t) + size, sizeof(uint64_t));
+}
+
+static int _ev_shm_channel_is_closing(ev_shm_channel_t *chan)
+{
+    return ev__handle_is_closing(&chan->base);
+}
+
+static void _ev_shm_channel_on_close_unix(ev_handle_t *handle)
+{
+    ev_shm_channel_t *chan = EV_CONTAINER_OF(handle, ev_shm_channel_t, base);
+    ev_shm_channel_cb close_cb = chan->close_cb;
+    void             *close_arg = chan->close_arg;
+
+    ev_shmem_exit(chan->shm);
+    ev__loop_free(chan->base.loop, chan);
+
+    if (close_cb != NULL)
+    {
+        close_cb(chan, close_arg);
+    }
+}
+
+static void _ev_shm_channel_drain_unix(ev_shm_channel_t *chan);
+
+static void _ev_shm_channel_on_backlog_unix(ev_handle_t *handle)
+{
+    ev_shm_channel_t *chan = EV_CONTAINER_OF(handle, ev_shm_channel_t, base);
+    if (!_ev_shm_channel_is_closing(chan))
+    {
+        _ev_shm_channel_drain_unix(chan);
+    }
+}
+
+/**
+ * @brief Stop receiving from a channel whose ring is corrupted.
+ */
+static void _ev_shm_channel_break_unix(ev_shm_channel_t *chan)
+{
+    chan->base.data.flags |= EV_HANDLE_SHM_CHANNEL_BROKEN;
+    ev__nonblock_io_del(chan->base.loop, &chan->io, EV_IO_IN);
+    ev__handle_deactive(&chan->base);
+
+    chan->recv_cb(chan, NULL, EV_EPROTO, chan->recv_arg);
+}
+
+static void _ev_shm_channel_drain_unix(ev_shm_channel_t *chan)
+{
+    ev_shm_channel_hdr_t *hdr = chan->hdr;
+    const size_t          capacity = chan->capacity;
+    const uint64_t        mask = capacity - 1;
+    uint64_t              tail = (uint64_t)ev_atomic64_load(&hdr->tail.v);
+    uint64_t              head;
+
+    if (chan->base.data.flags & EV_HANDLE_SHM_CHANNEL_BROKEN)
+    {
+        return;
+    }
+
+    size_t cnt = 0;
+    for (;;)
+    {
+        if ((head = (uint64_t)ev_atomic64_load(&hdr->head.v)) == tail)
+        {
+            /* Ask sender to ring doorbell, then check again for a racing one */
+            ev_atomic32_store(&hdr->waiting, 1);
+            if ((uint64_t)ev_atomic64_load(&hdr->head.v) == tail)
+            {
+                return;
+            }
+            ev_atomic32_store(&hdr->waiting, 0);
+            continue;
+        }
+
+        if (cnt++ >= EV_SHM_CHANNEL_RECV_BATCH)
+        {
+            ev__backlog_submit(&chan->base, _ev_shm_channel_on_backlog_unix);
+            return;
+        }
+
+        size_t   pos = (size_t)(tail & mask);
+        uint32_t size;
+        memcpy(&size, chan->ring + pos, sizeof(size));
+        if (size == EV_SHM_CHANNEL_WRAP)
+        {
+            if (head - tail < capacity - pos)
+            {
+                _ev_shm_channel_break_unix(chan);
+                return;
+            }
+            tail += capacity - pos;
+            ev_atomic64_store(&hdr->tail.v, tail);
+            continue;
+        }
+
+        /* Ring is writable by peer, never trust the length prefix */
+        size_t record_size = _ev_shm_channel_record_size(size);
+        if (record_size > capacity / 2 || pos + record_size > capacity ||
+            head - tail < record_size)
+        {
+            _ev_shm_channel_break_unix(chan);
+            return;
+        }
+
+        /* Space is released after callback, so data stay valid inside it */
+        chan->recv_cb(chan, chan->ring + pos + sizeof(size), (ssize_t)size,
+                      chan->recv_arg);
+        tail += record_size;
+        ev_atomic64_store(&hdr->tail.v, tail);
+
+        if (_ev_shm_channel_is_closing(chan))
+        {
+            return;
+        }
+    }
+}
+
+static void _ev_shm_channel_on_doorbell_unix(ev_nonblock_io_t *io,
+                                             unsigned evts, void *arg)
+{
+    (void)evts;
+    (void)arg;
+    ev_shm_channel_t *chan = EV_CONTAINER_OF(io, ev_shm_channel_t, io);
+
+    ev__async_pend(chan->evtfd[0]);
+    _ev_shm_channel_drain_unix(chan);
+}
+
+static ev_shm_channel_t *_ev_shm_channel_new(ev_loop_t *loop)
+{
+    ev_shm_channel_t *chan =
+        ev__loop_malloc(loop, EV_ALLOCATOR_TYPE_MISC, sizeof(ev_shm_channel_t));
+    if (chan == NULL)
+    {
+        return NULL;
+    }
+
+    memset(chan, 0, sizeof(*chan));
+    chan->evtfd[0] = -1;
+    chan->evtfd[1] = -1;
+
+    return chan;
+}
+
+static void _ev_shm_channel_layout(ev_shm_channel_t *chan)
+{
+    chan->hdr = ev_shmem_addr(chan->shm);
+    chan->ring = (uint8_t *)chan->hdr + sizeof(ev_shm_channel_hdr_t);
+}
+
+int ev_shm_channel_init(ev_loop_t *loop, ev_shm_channel_t **chan,
+                        const char *key, size_t size,
+                        ev_shm_channel_recv_cb cb, void *arg)
+{
+    int    ret;
+    size_t capacity = EV_SHM_CHANNEL_MIN_SIZE;
+
+    if (size > EV_SHM_CHANNEL_MAX_SIZE || cb == NULL)
+    {
+        return EV_EINVAL;
+    }
+    while (capacity < size)
+    {
+        capacity <<= 1;
+    }
+
+    ev_shm_channel_t *new_chan = _ev_shm_channel_new(loop);
+    if (new_chan == NULL)
+    {
+        return EV_ENOMEM;
+    }
+
+    ret = ev_shmem_init(&new_chan->shm, key,
+                        sizeof(ev_shm_channel_hdr_t) + capacity);
+    if (ret != 0)
+    {
+        goto err_free;
+    }
+
+    if ((ret = ev__asyc_eventfd(new_chan->evtfd)) != 0)
+    {
+        goto err_shmem;
+    }
+
+    _ev_shm_channel_layout(new_chan);
+    new_chan->capacity = capacity;
+    new_chan->hdr->capacity = (uint32_t)capacity;
+    ev_atomic64_init(&new_chan->hdr->head.v, 0);
+    ev_atomic64_init(&new_chan->hdr->tail.v, 0);
+    ev_atomic32_init(&new_chan->hdr->waiting, 1);
+    new_chan->hdr->magic = EV_SHM_CHANNEL_MAGIC;
+
+    new_chan->recv_cb = cb;
+    new_chan->recv_arg = arg;
+
+    ev__handle_init(loop, &new_chan->base, EV_ROLE_EV_SHM_CHANNEL);
+    ev__nonblock_io_init(&new_chan->io, new_chan->evtfd[0],
+                         _ev_shm_channel_on_doorbell_unix, NULL);
+    ev__nonblock_io_add(loop, &new_chan->io, EV_IO_IN);
+    ev__handle_active(&new_chan->base);
+
+    *chan = new_chan;
+    return 0;
+
+err_shmem:
+    ev_shmem_exit(new_chan->shm);
+err_free:
+    ev__loop_free(loop, new_chan);
+    return ret;
+}
+
+int ev_shm_channel_open(ev_loop_t *loop, ev_shm_channel_t **chan,
+                        const char *key)
+{
+    int               ret;
+    ev_shm_channel_t *new_chan = _ev_shm_channel_new(loop);
+    if (new_chan == NULL)
+    {
+        return EV_ENOMEM;
+    }
+
+    if ((ret = ev_shmem_open(&new_chan->shm, key)) != 0)
+    {
+        goto err_free;
+    }
+
+    _ev_shm_channel_layout(new_chan);
+    size_t   shm_size = ev_shmem_size(new_chan->shm);
+    uint32_t capacity = new_chan->hdr->capacity;
+    if (shm_size < sizeof(ev_shm_channel_hdr_t) ||
+        new_chan->hdr->magic != EV_SHM_CHANNEL_MAGIC || capacity == 0 ||
+        (capacity & (capacity - 1)) != 0 ||
+        shm_size - sizeof(ev_shm_channel_hdr_t) < capacity)
+    {
+        ret = EV_EINVAL;
+        goto err_shmem;
+    }
+    new_chan->capacity = capacity;
+
+    ev__handle_init(loop, &new_chan->base, EV_ROLE_EV_SHM_CHANNEL);
+    new_chan->base.data.flags |= EV_HANDLE_SHM_CHANNEL_SENDER;
+
+    *chan = new_chan;
+    return 0;
+
+err_shmem:
+    ev_shmem_exit(new_chan->shm);
+err_free:
+    ev__loop_free(loop, new_chan);
+    return ret;
+}
+
+void ev_shm_channel_exit(ev_shm_channel_t *chan, ev_shm_channel_cb close_cb,
+                         void *close_arg)
+{
+    chan->close_cb = close_cb;
+    chan->close_arg = close_arg;
+
+    if (!(chan->base.data.flags & EV_HANDLE_SHM_CHANNEL_SENDER))
+    {
+        ev__nonblock_io_del(chan->base.loop, &chan->io, EV_IO_IN);
+        ev__handle_deactive(&chan->base);
+    }
+
+    size_t i;
+    for (i = 0; i < ARRAY_SIZE(chan->evtfd); i++)
+    {
+        if (chan->evtfd[i] != -1)
+        {
+            ev__async_eventfd_close(chan->evtfd[i]);
+            chan->evtfd[i] = -1;
+        }
+    }
+
+    /* Shared memory is unmapped in close callback */
+    ev__handle_exit(&chan->base, _ev_shm_channel_on_close_unix);
+}
+
+int ev_shm_channel_send(ev_shm_channel_t *chan, const void *data, size_t size)
+{
+    ev_shm_channel_hdr_t *hdr = chan->hdr;
+
+    if (!(chan->base.data.flags & EV_HANDLE_SHM_CHANNEL_SENDER))
+    {
+        return EV_EINVAL;
+    }
+    if (chan->evtfd[1] == -1)
+    {
+        return EV_ENOTCONN;
+    }
+
+    /* Limited to half of ring so wrapping always fits */
+    size_t record_size = _ev_shm_channel_record_size(size);
+    if (record_size > chan->capacity / 2)
+    {
+        return EV_E2BIG;
+    }
+
+    uint64_t head = (uint64_t)ev_atomic64_load(&hdr->head.v);
+    uint64_t tail = (uint64_t)ev_atomic64_load(&hdr->tail.v);
+    size_t   pos = (size_t)(head & (chan->capacity - 1));
+    size_t   contig_size = chan->capacity - pos;
+    size_t   need_size = record_size;
+    if (contig_size < record_size)
+    {
+        need_size += contig_size;
+    }
+
+    if (chan->capacity - (head - tail) < need_size)
+    {
+        return EV_EAGAIN;
+    }
+
+    if (contig_size < record_size)
+    {
+        uint32_t wrap = EV_SHM_CHANNEL_WRAP;
+        memcpy(chan->ring + pos, &wrap, sizeof(wrap));
+        head += contig_size;
+        pos = 0;
+    }
+
+    uint32_t size32 = (uint32_t)size;
+    memcpy(chan->ring + pos, &size32, sizeof(size32));
+    memcpy(chan->ring + pos + sizeof(size32), data, size);
+    ev_atomic64_store(&hdr->head.v, head + record_size);
+
+    /* Only ring doorbell once for each wait */
+    if (ev_atomic32_exchange(&hdr->waiting, 0) != 0)
+    {
+        ev__async_post(chan->evtfd[1]);
+    }
+
+    return 0;
+}
+
+EV_LOCAL int ev__shm_channel_doorbell(ev_shm_channel_t *chan,
+                                      ev_os_socket_t   *fd)
+{
+    if (chan->base.data.role != EV_ROLE_EV_SHM_CHANNEL ||
+        (chan->base.data.flags & EV_HANDLE_SHM_CHANNEL_SENDER))
+    {
+        return EV_EINVAL;
+    }
+
+    *fd = chan->evtfd[1];
+    return 0;
+}
+
+EV_LOCAL int ev__shm_channel_attach_unix(ev_shm_channel_t *chan, int fd)
+{
+    if (!(chan->base.data.flags & EV_HANDLE_SHM_CHANNEL_SENDER))
+    {
+        return EV_EINVAL;
+    }
+    if (chan->evtfd[1] != -1)
+    {
+        return EV_EEXIST;
+    }
+
+    chan->evtfd[1] = fd;
+    return 0;
+}
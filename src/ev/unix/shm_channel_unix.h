@@ -0,0 +1,62 @@
+#ifndef __EV_SHM_CHANNEL_UNIX_H__
+#define __EV_SHM_CHANNEL_UNIX_H__
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Ring header at the beginning of shared memory.
+ *
+ * \p head and \p tail are free running byte positions. They are placed in
+ * different cache lines so sender and receiver do not contend.
+ */
+typedef struct ev_shm_channel_hdr
+{
+    uint32_t magic;    /**< #EV_SHM_CHANNEL_MAGIC, set after initialized */
+    uint32_t capacity; /**< Ring size, power of 2 */
+
+    union {
+        ev_atomic64_t v;
+        uint8_t       _align[64];
+    } head; /**< Write position, only changed by sender */
+
+    union {
+        ev_atomic64_t v;
+        uint8_t       _align[64];
+    } tail; /**< Read position, only changed by receiver */
+
+    ev_atomic32_t waiting; /**< Receiver is waiting for doorbell */
+} ev_shm_channel_hdr_t;
+
+struct ev_shm_channel
+{
+    ev_handle_t            base;      /**< Base object */
+    ev_shmem_t            *shm;       /**< Shared memory */
+    ev_shm_channel_hdr_t  *hdr;       /**< Ring header */
+    uint8_t               *ring;      /**< Ring data */
+    size_t                 capacity;  /**< Ring size, not read from header */
+    ev_shm_channel_recv_cb recv_cb;   /**< Receive callback */
+    void                  *recv_arg;  /**< Receive argument */
+    ev_shm_channel_cb      close_cb;  /**< Close callback */
+    void                  *close_arg; /**< Close argument */
+
+    /**
+     * @brief Doorbell.
+     * Receiver polls evtfd[0] and shares evtfd[1], sender only has evtfd[1].
+     */
+    int              evtfd[2];
+    ev_nonblock_io_t io; /**< Doorbell watcher of receiver */
+};
+
+/**
+ * @brief Attach doorbell received from peer.
+ * @param[in] chan  Channel opened by #ev_shm_channel_open().
+ * @param[in] fd    Doorbell
+ * @return          #ev_errno_t
+ */
+EV_LOCAL int ev__shm_channel_attach_unix(ev_shm_channel_t *chan, int fd);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -1,240 +1,926 @@
-
-static ssize_t _ev_stream_do_write_writev_unix(int fd, struct iovec* iov, int iovcnt, void* arg)
-{
-    (void)arg;
-    return ev__writev_unix(fd, (ev_buf_t*)iov, iovcnt);
-}
-
-static int _ev_stream_do_write_once(ev_nonblock_stream_t* stream, ev_write_t* req)
-{
-    return ev__send_unix(stream->io.data.fd, req, _ev_stream_do_write_writev_unix, NULL);
-}
-
-static int _ev_stream_do_read_once(ev_nonblock_stream_t* stream, ev_read_t* req, size_t* size)
-{
-    int iovcnt = req->data.nbuf;
-    if (iovcnt > g_ev_loop_unix_ctx.iovmax)
-    {
-        iovcnt = g_ev_loop_unix_ctx.iovmax;
-    }
-
-    ssize_t read_size;
-    read_size = ev__readv_unix(stream->io.data.fd, req->data.bufs, iovcnt);
-    if (read_size >= 0)
-    {
-        *size = read_size;
-        return 0;
-    }
-    return read_size;
-}
-
-static void _ev_stream_do_write(ev_nonblock_stream_t* stream)
-{
-    ssize_t ret;
-    ev_list_node_t* it;
-    ev_write_t* req;
-
-    while ((it = ev_list_pop_front(&stream->pending.w_queue)) != NULL)
-    {
-        req = EV_CONTAINER_OF(it, ev_write_t, node);
-        if ((ret = _ev_stream_do_write_once(stream, req)) == 0)
-        {
-            stream->callbacks.w_cb(stream, req, req->size);
-            continue;
-        }
-
-        /* Unsuccess operation should restore list */
-        ev_list_push_front(&stream->pending.w_queue, it);
-
-        if (ret == EV_EAGAIN)
-        {
-            break;
-        }
-        goto err;
-    }
-
-    return;
-
-err:
-    while ((it = ev_list_pop_front(&stream->pending.w_queue)) != NULL)
-    {
-        req = EV_CONTAINER_OF(it, ev_write_t, node);
-        ret = ret < 0 ? ret : (ssize_t)req->size;
-        stream->callbacks.w_cb(stream, req, ret);
-    }
-}
-
-static void _ev_stream_do_read(ev_nonblock_stream_t* stream)
-{
-    int ret;
-    ev_list_node_t* it = ev_list_pop_front(&stream->pending.r_queue);
-    ev_read_t* req = EV_CONTAINER_OF(it, ev_read_t, node);
-
-    size_t r_size = 0;
-    ret = _ev_stream_do_read_once(stream, req, &r_size);
-    req->data.size += r_size;
-
-    if (ret == 0)
-    {
-        stream->callbacks.r_cb(stream, req, req->data.size);
-        return;
-    }
-
-    ev_list_push_front(&stream->pending.r_queue, it);
-
-    if (ret == EV_EAGAIN)
-    {
-        return;
-    }
-
-    /* If error, cleanup all pending read requests */
-    while ((it = ev_list_pop_front(&stream->pending.r_queue)) != NULL)
-    {
-        req = EV_CONTAINER_OF(it, ev_read_t, node);
-        stream->callbacks.r_cb(stream, req, ret);
-    }
-}
-
-static void _ev_stream_cleanup_r(ev_nonblock_stream_t* stream, int errcode)
-{
-    ev_list_node_t* it;
-    while ((it = ev_list_pop_front(&stream->pending.r_queue)) != NULL)
-    {
-        ev_read_t* req = EV_CONTAINER_OF(it, ev_read_t, node);
-        stream->callbacks.r_cb(stream, req, errcode);
-    }
-}
-
-static void _ev_stream_cleanup_w(ev_nonblock_stream_t* stream, int errcode)
-{
-    ev_list_node_t* it;
-    while ((it = ev_list_pop_front(&stream->pending.w_queue)) != NULL)
-    {
-        ev_write_t* req = EV_CONTAINER_OF(it, ev_write_t, node);
-        stream->callbacks.w_cb(stream, req, errcode);
-    }
-}
-
-static void _ev_nonblock_stream_on_io(ev_nonblock_io_t* io, unsigned evts, void* arg)
-{
-    (void)arg;
-    ev_nonblock_stream_t* stream = EV_CONTAINER_OF(io, ev_nonblock_stream_t, io);
-
-    if (evts & EPOLLOUT)
-    {
-        _ev_stream_do_write(stream);
-        if (ev_list_size(&stream->pending.w_queue) == 0)
-        {
-            ev__nonblock_io_del(stream->loop, &stream->io, EV_IO_OUT);
-            stream->flags.io_reg_w = 0;
-        }
-    }
-
-    else if (evts & (EPOLLIN | EPOLLHUP))
-    {
-        _ev_stream_do_read(stream);
-        if (ev_list_size(&stream->pending.r_queue) == 0)
-        {
-            ev__nonblock_io_del(stream->loop, &stream->io, EV_IO_IN);
-            stream->flags.io_reg_r = 0;
-        }
-    }
-}
-
-EV_LOCAL void ev__nonblock_stream_init(ev_loop_t* loop,
-    ev_nonblock_stream_t* stream, int fd, ev_stream_write_cb wcb,
-    ev_stream_read_cb rcb)
-{
-    stream->loop = loop;
-
-    stream->flags.io_abort = 0;
-    stream->flags.io_reg_r = 0;
-    stream->flags.io_reg_w = 0;
-
-    ev__nonblock_io_init(&stream->io, fd, _ev_nonblock_stream_on_io, NULL);
-
-    ev_list_init(&stream->pending.w_queue);
-    ev_list_init(&stream->pending.r_queue);
-
-    stream->callbacks.w_cb = wcb;
-    stream->callbacks.r_cb = rcb;
-}
-
-EV_LOCAL void ev__nonblock_stream_exit(ev_nonblock_stream_t* stream)
-{
-    ev__nonblock_stream_abort(stream);
-    ev__nonblock_stream_cleanup(stream, EV_IO_IN | EV_IO_OUT);
-    stream->loop = NULL;
-    stream->callbacks.w_cb = NULL;
-    stream->callbacks.r_cb = NULL;
-}
-
-EV_LOCAL int ev__nonblock_stream_write(ev_nonblock_stream_t* stream, ev_write_t* req)
-{
-    if (stream->flags.io_abort)
-    {
-        return EV_EBADF;
-    }
-
-    if (!stream->flags.io_reg_w)
-    {
-        ev__nonblock_io_add(stream->loop, &stream->io, EV_IO_OUT);
-        stream->flags.io_reg_w = 1;
-    }
-
-    ev_list_push_back(&stream->pending.w_queue, &req->node);
-    return 0;
-}
-
-EV_LOCAL int ev__nonblock_stream_read(ev_nonblock_stream_t* stream, ev_read_t* req)
-{
-    if (stream->flags.io_abort)
-    {
-        return EV_EBADF;
-    }
-
-    if (!stream->flags.io_reg_r)
-    {
-        ev__nonblock_io_add(stream->loop, &stream->io, EV_IO_IN);
-        stream->flags.io_reg_r = 1;
-    }
-
-    ev_list_push_back(&stream->pending.r_queue, &req->node);
-    return 0;
-}
-
-EV_LOCAL size_t ev__nonblock_stream_size(ev_nonblock_stream_t* stream, unsigned evts)
-{
-    size_t ret = 0;
-    if (evts & EV_IO_IN)
-    {
-        ret += ev_list_size(&stream->pending.r_queue);
-    }
-    if (evts & EV_IO_OUT)
-    {
-        ret += ev_list_size(&stream->pending.w_queue);
-    }
-    return ret;
-}
-
-EV_LOCAL void ev__nonblock_stream_abort(ev_nonblock_stream_t* stream)
-{
-    if (!stream->flags.io_abort)
-    {
-        ev__nonblock_io_del(stream->loop, &stream->io, EV_IO_IN | EV_IO_OUT);
-        stream->flags.io_abort = 1;
-    }
-}
-
-EV_LOCAL void ev__nonblock_stream_cleanup(ev_nonblock_stream_t* stream, unsigned evts)
-{
-    if (evts & EV_IO_OUT)
-    {
-        _ev_stream_cleanup_w(stream, EV_ECANCELED);
-    }
-
-    if (evts & EV_IO_IN)
-    {
-        _ev_stream_cleanup_r(stream, EV_ECANCELED);
-    }
-}
+
+#include <fcntl.h>
+#include <limits.h>
+#include <unistd.h>
+
+/**
+ * @brief Max number of iovec gathered for one write.
+ */
+#define EV_STREAM_WRITEV_MAX    1024
+
+/**
+ * @brief Default kernel buffer of splice, same as default pipe size on Linux.
+ */
+#define EV_STREAM_SPLICE_CAPACITY   (64 * 1024)
+
+/**
+ * @brief Gather buffers of queued write requests into \p iov.
+ * @return  Number of buffers gathered.
+ */
+static int _ev_stream_gather_write(ev_nonblock_stream_t* stream, ev_buf_t* iov, int iovmax)
+{
+    int iovcnt = 0;
+    ev_list_node_t* it = ev_list_begin(&stream->pending.w_queue);
+
+    for (; it != NULL && iovcnt < iovmax; it = ev_list_next(it))
+    {
+        ev_write_t* req = EV_CONTAINER_OF(it, ev_write_t, node);
+        if (ev__nonblock_stream_is_file(req))
+        {
+            break;
+        }
+
+        size_t nbuf = req->nbuf;
+        if (nbuf > (size_t)(iovmax - iovcnt))
+        {
+            nbuf = iovmax - iovcnt;
+        }
+
+        memcpy(&iov[iovcnt], req->bufs, sizeof(ev_buf_t) * nbuf);
+        iovcnt += (int)nbuf;
+    }
+
+    return iovcnt;
+}
+
+/**
+ * @brief Watch error queue only while zerocopy sends are outstanding.
+ */
+static void _ev_stream_zerocopy_watch(ev_nonblock_stream_t* stream)
+{
+    int busy = stream->zerocopy.seq_sent != stream->zerocopy.seq_done;
+
+    if (busy && !stream->flags.io_reg_e && !stream->flags.io_abort)
+    {
+        ev__nonblock_io_add(stream->loop, &stream->io, EPOLLERR);
+        stream->flags.io_reg_e = 1;
+    }
+    else if (!busy && stream->flags.io_reg_e)
+    {
+        ev__nonblock_io_del(stream->loop, &stream->io, EPOLLERR);
+        stream->flags.io_reg_e = 0;
+    }
+}
+
+static ssize_t _ev_stream_writev(ev_nonblock_stream_t* stream, ev_buf_t* iov, int iovcnt)
+{
+    if (stream->zerocopy.cb == NULL)
+    {
+        return ev__writev_unix(stream->io.data.fd, iov, iovcnt);
+    }
+
+    ssize_t ret = ev__sendmsg_zerocopy_unix(stream->io.data.fd, iov, iovcnt);
+    if (ret > 0)
+    {
+        stream->zerocopy.seq_sent++;
+        _ev_stream_zerocopy_watch(stream);
+    }
+    return ret;
+}
+
+/**
+ * @brief Compare sequence numbers that may wrap around.
+ * @return  Negative if \p a is before \p b.
+ */
+static int32_t _ev_stream_zerocopy_cmp(uint32_t a, uint32_t b)
+{
+    return (int32_t)(a - b);
+}
+
+/**
+ * @brief Make sure there is room for one more pending range.
+ */
+static int _ev_stream_zerocopy_reserve(ev_nonblock_stream_t* stream)
+{
+    if (stream->zerocopy.range_num < stream->zerocopy.range_cap)
+    {
+        return 0;
+    }
+
+    size_t cap = stream->zerocopy.range_cap != 0 ?
+        stream->zerocopy.range_cap * 2 : 8;
+    ev_stream_zerocopy_range_t* ranges = ev__loop_malloc(stream->loop,
+        EV_ALLOCATOR_TYPE_TCP, sizeof(ev_stream_zerocopy_range_t) * cap);
+    if (ranges == NULL)
+    {
+        return EV_ENOMEM;
+    }
+
+    if (stream->zerocopy.ranges != NULL)
+    {
+        memcpy(ranges, stream->zerocopy.ranges,
+            sizeof(ev_stream_zerocopy_range_t) * stream->zerocopy.range_num);
+        ev__loop_free(stream->loop, stream->zerocopy.ranges);
+    }
+    stream->zerocopy.ranges = ranges;
+    stream->zerocopy.range_cap = cap;
+    return 0;
+}
+
+/**
+ * @brief Record completion of sends [\p lo, \p hi].
+ *
+ * seq_done only moves forward, and only over sends that are all completed.
+ * Ranges after a gap are kept until the gap is closed.
+ */
+static void _ev_stream_zerocopy_complete(ev_nonblock_stream_t* stream,
+    uint32_t lo, uint32_t hi)
+{
+    size_t i, j;
+    ev_stream_zerocopy_range_t* ranges = stream->zerocopy.ranges;
+    uint32_t done = stream->zerocopy.seq_done;
+
+    /* Already counted */
+    if (_ev_stream_zerocopy_cmp(hi, done) < 0)
+    {
+        return;
+    }
+
+    /* Insert sorted by start, room is reserved by caller */
+    for (i = stream->zerocopy.range_num; i > 0; i--)
+    {
+        if (_ev_stream_zerocopy_cmp(ranges[i - 1].lo, lo) <= 0)
+        {
+            break;
+        }
+        ranges[i] = ranges[i - 1];
+    }
+    ranges[i].lo = lo;
+    ranges[i].hi = hi;
+    stream->zerocopy.range_num++;
+
+    /* Merge overlapping and adjacent ranges */
+    for (i = 0, j = 1; j < stream->zerocopy.range_num; j++)
+    {
+        if (_ev_stream_zerocopy_cmp(ranges[j].lo, ranges[i].hi + 1) <= 0)
+        {
+            if (_ev_stream_zerocopy_cmp(ranges[j].hi, ranges[i].hi) > 0)
+            {
+                ranges[i].hi = ranges[j].hi;
+            }
+            continue;
+        }
+        ranges[++i] = ranges[j];
+    }
+    stream->zerocopy.range_num = i + 1;
+
+    /* Advance over the leading range if there is no gap before it */
+    if (_ev_stream_zerocopy_cmp(ranges[0].lo, done) <= 0)
+    {
+        stream->zerocopy.seq_done = ranges[0].hi + 1;
+        stream->zerocopy.range_num--;
+        memmove(ranges, ranges + 1,
+            sizeof(ev_stream_zerocopy_range_t) * stream->zerocopy.range_num);
+    }
+}
+
+static void _ev_stream_do_zerocopy(ev_nonblock_stream_t* stream)
+{
+    uint32_t lo, hi;
+    uint32_t seq_done = stream->zerocopy.seq_done;
+
+    /* Notification is only read if it can be recorded */
+    while (_ev_stream_zerocopy_reserve(stream) == 0 &&
+        ev__zerocopy_notify_unix(stream->io.data.fd, &lo, &hi) > 0)
+    {
+        _ev_stream_zerocopy_complete(stream, lo, hi);
+    }
+
+    if (stream->zerocopy.seq_done == seq_done)
+    {
+        return;
+    }
+
+    _ev_stream_zerocopy_watch(stream);
+    stream->zerocopy.cb(stream, stream->zerocopy.seq_done);
+}
+
+static void _ev_stream_check_watermark(ev_nonblock_stream_t* stream)
+{
+    if (stream->watermark.cb == NULL || stream->flags.io_abort)
+    {
+        return;
+    }
+
+    if (!stream->watermark.is_high && stream->pending.w_size >= stream->watermark.high)
+    {
+        stream->watermark.is_high = 1;
+        stream->watermark.cb(stream, 1);
+    }
+    else if (stream->watermark.is_high && stream->pending.w_size <= stream->watermark.low)
+    {
+        stream->watermark.is_high = 0;
+        stream->watermark.cb(stream, 0);
+    }
+}
+
+/**
+ * @brief Send file request at the head of queue.
+ *
+ * If the file is shorter than requested, \p req is finished with less data
+ * than its capacity, and the rest of queue is not affected.
+ *
+ * @return  #EV_SUCCESS if \p req is finished, #EV_EAGAIN if socket buffer is
+ *          full, or #ev_errno_t.
+ */
+static int _ev_stream_do_sendfile(ev_nonblock_stream_t* stream, ev_nonblock_stream_file_t* req, ev_list_t* done)
+{
+    while (req->base.size < req->base.capacity)
+    {
+        ssize_t ret = ev__sendfile_unix(stream->io.data.fd, req->fd, req->offset,
+            req->base.capacity - req->base.size);
+        if (ret < 0)
+        {
+            return (int)ret;
+        }
+        if (ret == 0)
+        {
+            stream->pending.w_size -= req->base.capacity - req->base.size;
+            break;
+        }
+
+        req->offset += ret;
+        req->base.size += ret;
+        stream->pending.w_size -= ret;
+    }
+
+    ev_list_erase(&stream->pending.w_queue, &req->base.node);
+    ev_list_push_back(done, &req->base.node);
+    return 0;
+}
+
+/**
+ * @brief Distribute \p write_size bytes over queued write requests.
+ *
+ * Finished requests are moved into \p done in order.
+ *
+ * @return  #EV_SUCCESS if all bytes are consumed by finished requests,
+ *          #EV_EAGAIN if the head request is left partially sent.
+ */
+static int _ev_stream_finalize_write(ev_nonblock_stream_t* stream, size_t write_size, ev_list_t* done)
+{
+    ev_list_node_t* it;
+    while ((it = ev_list_begin(&stream->pending.w_queue)) != NULL)
+    {
+        ev_write_t* req = EV_CONTAINER_OF(it, ev_write_t, node);
+        size_t left = req->capacity - req->size;
+
+        /* Gathered data never cover a file request */
+        if (ev__nonblock_stream_is_file(req) && left != 0)
+        {
+            break;
+        }
+
+        if (write_size < left)
+        {
+            /* Zero bytes written means the socket buffer is full */
+            if (write_size == 0)
+            {
+                return EV_EAGAIN;
+            }
+            return ev__finalize_send_req_unix(req, write_size);
+        }
+
+        ev__finalize_send_req_unix(req, left);
+        write_size -= left;
+
+        ev_list_erase(&stream->pending.w_queue, it);
+        ev_list_push_back(done, it);
+    }
+
+    return 0;
+}
+
+static int _ev_stream_do_read_once(ev_nonblock_stream_t* stream, ev_read_t* req, size_t* size)
+{
+    int iovcnt = req->data.nbuf;
+    if (iovcnt > g_ev_loop_unix_ctx.iovmax)
+    {
+        iovcnt = g_ev_loop_unix_ctx.iovmax;
+    }
+
+    ssize_t read_size;
+    read_size = ev__readv_unix(stream->io.data.fd, req->data.bufs, iovcnt);
+    if (read_size >= 0)
+    {
+        *size = read_size;
+        return 0;
+    }
+    return read_size;
+}
+
+static void _ev_stream_do_write(ev_nonblock_stream_t* stream)
+{
+    ssize_t ret;
+    ev_list_node_t* it;
+    ev_write_t* req;
+    ev_buf_t iov[EV_STREAM_WRITEV_MAX];
+    ev_list_t done = EV_LIST_INIT;
+
+    int iovmax = g_ev_loop_unix_ctx.iovmax;
+    if (iovmax > EV_STREAM_WRITEV_MAX)
+    {
+        iovmax = EV_STREAM_WRITEV_MAX;
+    }
+
+    /*
+     * Send buffers of as many queued requests as possible in one syscall, and
+     * keep going until the queue is drained or the socket buffer is full.
+     */
+    do
+    {
+        if ((it = ev_list_begin(&stream->pending.w_queue)) == NULL)
+        {
+            ret = 0;
+            break;
+        }
+
+        req = EV_CONTAINER_OF(it, ev_write_t, node);
+        if (ev__nonblock_stream_is_file(req))
+        {
+            ev_nonblock_stream_file_t* file_req =
+                EV_CONTAINER_OF(req, ev_nonblock_stream_file_t, base);
+            ret = _ev_stream_do_sendfile(stream, file_req, &done);
+            continue;
+        }
+
+        int iovcnt = _ev_stream_gather_write(stream, iov, iovmax);
+        if (iovcnt == 0)
+        {
+            /* Empty requests at head */
+            ret = _ev_stream_finalize_write(stream, 0, &done);
+            continue;
+        }
+
+        if ((ret = _ev_stream_writev(stream, iov, iovcnt)) < 0)
+        {
+            if (ret == EV_ENOBUFS)
+            {
+                ret = EV_EAGAIN;
+            }
+            break;
+        }
+
+        stream->pending.w_size -= ret;
+        ret = _ev_stream_finalize_write(stream, (size_t)ret, &done);
+    } while (ret == 0 && ev_list_size(&stream->pending.w_queue) != 0);
+
+    while ((it = ev_list_pop_front(&done)) != NULL)
+    {
+        req = EV_CONTAINER_OF(it, ev_write_t, node);
+
+        /* Only a file request is finished short, when the file ends early */
+        stream->callbacks.w_cb(stream, req,
+            req->size == req->capacity ? (ssize_t)req->size : EV_EOF);
+    }
+
+    if (ret >= 0 || ret == EV_EAGAIN)
+    {
+        _ev_stream_check_watermark(stream);
+        return;
+    }
+
+    stream->pending.w_size = 0;
+    while ((it = ev_list_pop_front(&stream->pending.w_queue)) != NULL)
+    {
+        req = EV_CONTAINER_OF(it, ev_write_t, node);
+        stream->callbacks.w_cb(stream, req, ret);
+    }
+    _ev_stream_check_watermark(stream);
+}
+
+static void _ev_stream_do_read(ev_nonblock_stream_t* stream)
+{
+    int ret;
+    ev_list_node_t* it = ev_list_pop_front(&stream->pending.r_queue);
+    ev_read_t* req = EV_CONTAINER_OF(it, ev_read_t, node);
+
+    size_t r_size = 0;
+    ret = _ev_stream_do_read_once(stream, req, &r_size);
+    req->data.size += r_size;
+
+    if (ret == 0)
+    {
+        stream->callbacks.r_cb(stream, req, req->data.size);
+        return;
+    }
+
+    ev_list_push_front(&stream->pending.r_queue, it);
+
+    if (ret == EV_EAGAIN)
+    {
+        return;
+    }
+
+    /* If error, cleanup all pending read requests */
+    while ((it = ev_list_pop_front(&stream->pending.r_queue)) != NULL)
+    {
+        req = EV_CONTAINER_OF(it, ev_read_t, node);
+        stream->callbacks.r_cb(stream, req, ret);
+    }
+}
+
+static void _ev_stream_cleanup_r(ev_nonblock_stream_t* stream, int errcode)
+{
+    ev_list_node_t* it;
+    while ((it = ev_list_pop_front(&stream->pending.r_queue)) != NULL)
+    {
+        ev_read_t* req = EV_CONTAINER_OF(it, ev_read_t, node);
+        stream->callbacks.r_cb(stream, req, errcode);
+    }
+}
+
+static void _ev_stream_cleanup_w(ev_nonblock_stream_t* stream, int errcode)
+{
+    ev_list_node_t* it;
+    stream->pending.w_size = 0;
+    while ((it = ev_list_pop_front(&stream->pending.w_queue)) != NULL)
+    {
+        ev_write_t* req = EV_CONTAINER_OF(it, ev_write_t, node);
+        stream->callbacks.w_cb(stream, req, errcode);
+    }
+}
+
+static void _ev_stream_want(ev_nonblock_stream_t* stream, unsigned evt, int want)
+{
+    unsigned reg = evt == EV_IO_IN ? stream->flags.io_reg_r : stream->flags.io_reg_w;
+    if (stream->flags.io_abort || !want == !reg)
+    {
+        return;
+    }
+
+    if (want)
+    {
+        ev__nonblock_io_add(stream->loop, &stream->io, evt);
+    }
+    else
+    {
+        ev__nonblock_io_del(stream->loop, &stream->io, evt);
+    }
+
+    if (evt == EV_IO_IN)
+    {
+        stream->flags.io_reg_r = want ? 1 : 0;
+    }
+    else
+    {
+        stream->flags.io_reg_w = want ? 1 : 0;
+    }
+}
+
+/**
+ * @brief Register IO events that queued requests and splices are waiting for.
+ */
+static void _ev_stream_update_io(ev_nonblock_stream_t* stream)
+{
+    ev_nonblock_splice_t* in = stream->splice.as_src;
+    ev_nonblock_splice_t* out = stream->splice.as_dst;
+
+    int want_in = ev_list_size(&stream->pending.r_queue) != 0 ||
+        (in != NULL && !in->flags.canceled && !in->flags.src_eof &&
+        !in->flags.pipe_full && in->buffered < in->capacity);
+    int want_out = ev_list_size(&stream->pending.w_queue) != 0 ||
+        (out != NULL && !out->flags.canceled && out->buffered != 0);
+
+    _ev_stream_want(stream, EV_IO_IN, want_in);
+    _ev_stream_want(stream, EV_IO_OUT, want_out);
+}
+
+static void _ev_stream_splice_finish(ev_nonblock_splice_t* req, int stat)
+{
+    req->src->splice.as_src = NULL;
+    req->dst->splice.as_dst = NULL;
+    _ev_stream_update_io(req->src);
+    _ev_stream_update_io(req->dst);
+
+    close(req->pipefd[0]);
+    close(req->pipefd[1]);
+    req->pipefd[0] = -1;
+    req->pipefd[1] = -1;
+
+    req->cb(req, stat);
+}
+
+/**
+ * @brief Move data from source into pipe.
+ * @return  #EV_SUCCESS, or #ev_errno_t if source failed.
+ */
+static int _ev_stream_splice_fill(ev_nonblock_splice_t* req)
+{
+    ssize_t ret;
+    while (!req->flags.src_eof && req->buffered < req->capacity)
+    {
+        ret = ev__splice_unix(req->src->io.data.fd, req->pipefd[1],
+            req->capacity - req->buffered);
+        if (ret == 0)
+        {
+            req->flags.src_eof = 1;
+            break;
+        }
+        if (ret < 0)
+        {
+            if (ret != EV_EAGAIN)
+            {
+                return (int)ret;
+            }
+            /*
+             * Either source is drained or pipe runs out of slots before
+             * reaching capacity. Stop watching source until pipe is drained
+             * in the latter case, or a readable source wakes us for nothing.
+             */
+            req->flags.pipe_full = req->buffered != 0;
+            break;
+        }
+        req->buffered += ret;
+    }
+    return 0;
+}
+
+/**
+ * @brief Move data from pipe into destination.
+ * @return  #EV_SUCCESS, or #ev_errno_t if destination failed.
+ */
+static int _ev_stream_splice_drain(ev_nonblock_splice_t* req)
+{
+    ssize_t ret;
+    while (req->buffered != 0)
+    {
+        ret = ev__splice_unix(req->pipefd[0], req->dst->io.data.fd, req->buffered);
+        if (ret == EV_EAGAIN || ret == 0)
+        {
+            break;
+        }
+        if (ret < 0)
+        {
+            return (int)ret;
+        }
+        req->buffered -= ret;
+        req->size += ret;
+        req->flags.pipe_full = 0;
+    }
+    return 0;
+}
+
+static void _ev_stream_splice_run(ev_nonblock_splice_t* req)
+{
+    int ret;
+    if (req->flags.canceled)
+    {
+        return;
+    }
+
+    if ((ret = _ev_stream_splice_fill(req)) != 0 ||
+        (ret = _ev_stream_splice_drain(req)) != 0)
+    {
+        _ev_stream_splice_finish(req, ret);
+        return;
+    }
+
+    if (req->flags.src_eof && req->buffered == 0)
+    {
+        _ev_stream_splice_finish(req, 0);
+        return;
+    }
+
+    _ev_stream_update_io(req->src);
+    _ev_stream_update_io(req->dst);
+}
+
+static void _ev_stream_splice_cancel(ev_nonblock_splice_t* req)
+{
+    if (req == NULL || req->flags.canceled)
+    {
+        return;
+    }
+    req->flags.canceled = 1;
+    _ev_stream_update_io(req->src);
+    _ev_stream_update_io(req->dst);
+}
+
+static void _ev_nonblock_stream_on_io(ev_nonblock_io_t* io, unsigned evts, void* arg)
+{
+    (void)arg;
+    ev_nonblock_stream_t* stream = EV_CONTAINER_OF(io, ev_nonblock_stream_t, io);
+
+    if ((evts & EPOLLERR) && stream->zerocopy.cb != NULL)
+    {
+        _ev_stream_do_zerocopy(stream);
+        if (stream->flags.io_abort)
+        {
+            return;
+        }
+    }
+
+    if ((evts & (EPOLLIN | EPOLLHUP | EPOLLERR)) && stream->splice.as_src != NULL)
+    {
+        _ev_stream_splice_run(stream->splice.as_src);
+        if (stream->flags.io_abort)
+        {
+            return;
+        }
+    }
+
+    if ((evts & (EPOLLOUT | EPOLLERR)) && stream->splice.as_dst != NULL)
+    {
+        _ev_stream_splice_run(stream->splice.as_dst);
+        if (stream->flags.io_abort)
+        {
+            return;
+        }
+    }
+
+    if ((evts & EPOLLOUT) && ev_list_size(&stream->pending.w_queue) != 0)
+    {
+        _ev_stream_do_write(stream);
+    }
+
+    else if ((evts & (EPOLLIN | EPOLLHUP)) && ev_list_size(&stream->pending.r_queue) != 0)
+    {
+        _ev_stream_do_read(stream);
+    }
+
+    _ev_stream_update_io(stream);
+}
+
+EV_LOCAL void ev__nonblock_stream_file_init(ev_nonblock_stream_file_t* req,
+    int fd, int64_t offset, size_t len)
+{
+    req->base.bufs = NULL;
+    req->base.nbuf = 0;
+    req->base.size = 0;
+    req->base.capacity = len;
+    req->fd = fd;
+    req->offset = offset;
+}
+
+EV_LOCAL int ev__nonblock_stream_is_file(const ev_write_t* req)
+{
+    return req->bufs == NULL;
+}
+
+EV_LOCAL void ev__nonblock_stream_init(ev_loop_t* loop,
+    ev_nonblock_stream_t* stream, int fd, ev_stream_write_cb wcb,
+    ev_stream_read_cb rcb)
+{
+    stream->loop = loop;
+
+    stream->flags.io_abort = 0;
+    stream->flags.io_reg_r = 0;
+    stream->flags.io_reg_w = 0;
+    stream->flags.io_reg_e = 0;
+
+    ev__nonblock_io_init(&stream->io, fd, _ev_nonblock_stream_on_io, NULL);
+
+    ev_list_init(&stream->pending.w_queue);
+    ev_list_init(&stream->pending.r_queue);
+    stream->pending.w_size = 0;
+
+    stream->callbacks.w_cb = wcb;
+    stream->callbacks.r_cb = rcb;
+
+    stream->zerocopy.cb = NULL;
+    stream->zerocopy.seq_sent = 0;
+    stream->zerocopy.seq_done = 0;
+    stream->zerocopy.ranges = NULL;
+    stream->zerocopy.range_num = 0;
+    stream->zerocopy.range_cap = 0;
+
+    stream->watermark.cb = NULL;
+    stream->watermark.low = 0;
+    stream->watermark.high = 0;
+    stream->watermark.is_high = 0;
+
+    stream->splice.as_src = NULL;
+    stream->splice.as_dst = NULL;
+}
+
+EV_LOCAL void ev__nonblock_stream_watermark(ev_nonblock_stream_t* stream,
+    size_t low, size_t high, ev_stream_watermark_cb cb)
+{
+    stream->watermark.cb = cb;
+    stream->watermark.low = low;
+    stream->watermark.high = high;
+    stream->watermark.is_high = 0;
+    _ev_stream_check_watermark(stream);
+}
+
+EV_LOCAL int ev__nonblock_stream_splice(ev_nonblock_splice_t* req,
+    ev_nonblock_stream_t* src, ev_nonblock_stream_t* dst, size_t capacity,
+    ev_stream_splice_cb cb)
+{
+#if defined(__linux__)
+    if (src->flags.io_abort || dst->flags.io_abort)
+    {
+        return EV_EBADF;
+    }
+    if (src->splice.as_src != NULL || ev_list_size(&src->pending.r_queue) != 0 ||
+        dst->splice.as_dst != NULL || ev_list_size(&dst->pending.w_queue) != 0)
+    {
+        return EV_EBUSY;
+    }
+
+    if (pipe2(req->pipefd, O_NONBLOCK | O_CLOEXEC) != 0)
+    {
+        return ev__translate_sys_error(errno);
+    }
+
+    if (capacity == 0)
+    {
+        capacity = EV_STREAM_SPLICE_CAPACITY;
+    }
+
+    /* Kernel may refuse to grow pipe beyond /proc/sys/fs/pipe-max-size */
+    int pipe_sz = fcntl(req->pipefd[1], F_GETPIPE_SZ);
+    if (pipe_sz > 0 && (size_t)pipe_sz < capacity)
+    {
+        int new_sz = fcntl(req->pipefd[1], F_SETPIPE_SZ,
+            capacity > INT_MAX ? INT_MAX : (int)capacity);
+        if (new_sz > 0)
+        {
+            pipe_sz = new_sz;
+        }
+    }
+    if (pipe_sz > 0 && (size_t)pipe_sz < capacity)
+    {
+        capacity = pipe_sz;
+    }
+
+    req->src = src;
+    req->dst = dst;
+    req->capacity = capacity;
+    req->buffered = 0;
+    req->size = 0;
+    req->flags.src_eof = 0;
+    req->flags.pipe_full = 0;
+    req->flags.canceled = 0;
+    req->cb = cb;
+
+    src->splice.as_src = req;
+    dst->splice.as_dst = req;
+    _ev_stream_update_io(src);
+
+    return 0;
+#else
+    (void)req; (void)src; (void)dst; (void)capacity; (void)cb;
+    return EV_ENOSYS;
+#endif
+}
+
+EV_LOCAL void ev__nonblock_stream_zerocopy(ev_nonblock_stream_t* stream, ev_stream_zerocopy_cb cb)
+{
+    stream->zerocopy.cb = cb;
+}
+
+EV_LOCAL void ev__nonblock_stream_exit(ev_nonblock_stream_t* stream)
+{
+    ev__nonblock_stream_abort(stream);
+    ev__nonblock_stream_cleanup(stream, EV_IO_IN | EV_IO_OUT);
+    if (stream->zerocopy.ranges != NULL)
+    {
+        ev__loop_free(stream->loop, stream->zerocopy.ranges);
+        stream->zerocopy.ranges = NULL;
+        stream->zerocopy.range_num = 0;
+        stream->zerocopy.range_cap = 0;
+    }
+    stream->loop = NULL;
+    stream->callbacks.w_cb = NULL;
+    stream->callbacks.r_cb = NULL;
+}
+
+EV_LOCAL int ev__nonblock_stream_write(ev_nonblock_stream_t* stream, ev_write_t* req)
+{
+    if (stream->flags.io_abort)
+    {
+        return EV_EBADF;
+    }
+    if (stream->splice.as_dst != NULL)
+    {
+        return EV_EBUSY;
+    }
+
+    if (!stream->flags.io_reg_w)
+    {
+        ev__nonblock_io_add(stream->loop, &stream->io, EV_IO_OUT);
+        stream->flags.io_reg_w = 1;
+    }
+
+    ev_list_push_back(&stream->pending.w_queue, &req->node);
+    stream->pending.w_size += req->capacity - req->size;
+    _ev_stream_check_watermark(stream);
+
+    return 0;
+}
+
+EV_LOCAL ssize_t ev__nonblock_stream_try_write(ev_nonblock_stream_t* stream, ev_buf_t* bufs, size_t nbuf)
+{
+    if (stream->flags.io_abort)
+    {
+        return EV_EBADF;
+    }
+    if (stream->splice.as_dst != NULL)
+    {
+        return EV_EBUSY;
+    }
+
+    /* Data must not overtake queued requests */
+    if (ev_list_size(&stream->pending.w_queue) != 0)
+    {
+        return EV_EAGAIN;
+    }
+
+    int iovcnt = nbuf > (size_t)g_ev_loop_unix_ctx.iovmax ?
+        g_ev_loop_unix_ctx.iovmax : (int)nbuf;
+
+    ssize_t ret = ev__writev_unix(stream->io.data.fd, bufs, iovcnt);
+    if (ret == EV_ENOBUFS)
+    {
+        return EV_EAGAIN;
+    }
+    if (ret != 0)
+    {
+        return ret;
+    }
+
+    /* Nothing is written, either socket buffer is full or \p bufs is empty */
+    size_t i;
+    for (i = 0; i < nbuf; i++)
+    {
+        if (bufs[i].size != 0)
+        {
+            return EV_EAGAIN;
+        }
+    }
+    return 0;
+}
+
+EV_LOCAL int ev__nonblock_stream_read(ev_nonblock_stream_t* stream, ev_read_t* req)
+{
+    if (stream->flags.io_abort)
+    {
+        return EV_EBADF;
+    }
+    if (stream->splice.as_src != NULL)
+    {
+        return EV_EBUSY;
+    }
+
+    if (!stream->flags.io_reg_r)
+    {
+        ev__nonblock_io_add(stream->loop, &stream->io, EV_IO_IN);
+        stream->flags.io_reg_r = 1;
+    }
+
+    ev_list_push_back(&stream->pending.r_queue, &req->node);
+    return 0;
+}
+
+EV_LOCAL size_t ev__nonblock_stream_size(ev_nonblock_stream_t* stream, unsigned evts)
+{
+    size_t ret = 0;
+    if (evts & EV_IO_IN)
+    {
+        ret += ev_list_size(&stream->pending.r_queue);
+        ret += stream->splice.as_src != NULL ? 1 : 0;
+    }
+    if (evts & EV_IO_OUT)
+    {
+        ret += ev_list_size(&stream->pending.w_queue);
+        ret += stream->splice.as_dst != NULL ? 1 : 0;
+    }
+    return ret;
+}
+
+EV_LOCAL void ev__nonblock_stream_abort(ev_nonblock_stream_t* stream)
+{
+    if (!stream->flags.io_abort)
+    {
+        ev__nonblock_io_del(stream->loop, &stream->io, EV_IO_IN | EV_IO_OUT | EPOLLERR);
+        stream->flags.io_abort = 1;
+        stream->flags.io_reg_e = 0;
+
+        /* Streams on the other side must stop splicing too */
+        _ev_stream_splice_cancel(stream->splice.as_src);
+        _ev_stream_splice_cancel(stream->splice.as_dst);
+    }
+}
+
+EV_LOCAL void ev__nonblock_stream_cleanup(ev_nonblock_stream_t* stream, unsigned evts)
+{
+    if (evts & EV_IO_OUT)
+    {
+        _ev_stream_cleanup_w(stream, EV_ECANCELED);
+        if (stream->splice.as_dst != NULL)
+        {
+            _ev_stream_splice_finish(stream->splice.as_dst, EV_ECANCELED);
+        }
+    }
+
+    if (evts & EV_IO_IN)
+    {
+        _ev_stream_cleanup_r(stream, EV_ECANCELED);
+        if (stream->splice.as_src != NULL)
+        {
+            _ev_stream_splice_finish(stream->splice.as_src, EV_ECANCELED);
+        }
+    }
+}
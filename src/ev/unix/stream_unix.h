@@ -1,65 +1,187 @@
-#ifndef __EV_STREAM_UNIX_H__
-#define __EV_STREAM_UNIX_H__
-#ifdef __cplusplus
-extern "C" {
-#endif
-
-/**
- * @brief Initialize stream.
- * @param[in] loop      Event loop
- * @param[out] stream   Stream handler
- * @param[in] fd        File descriptor
- * @param[in] wcb       Write callback
- * @param[in] rcb       Read callback
- */
-EV_LOCAL void ev__nonblock_stream_init(ev_loop_t* loop, ev_nonblock_stream_t* stream,
-    int fd, ev_stream_write_cb wcb, ev_stream_read_cb rcb);
-
-/**
- * @brief Cleanup and exit stream
- * @param[in] stream    Stream handler
- */
-EV_LOCAL void ev__nonblock_stream_exit(ev_nonblock_stream_t* stream);
-
-/**
- * @brief Do stream write
- * @param[in] stream    Stream handle
- * @param[in] req       Write request
- * @return              #ev_errno_t
- */
-EV_LOCAL int ev__nonblock_stream_write(ev_nonblock_stream_t* stream, ev_write_t* req);
-
-/**
- * @brief Do stream read
- * @param[in] stream    Stream handle
- * @param[in] req       Read request
- * @return              #ev_errno_t
- */
-EV_LOCAL int ev__nonblock_stream_read(ev_nonblock_stream_t* stream, ev_read_t* req);
-
-/**
- * @brief Get pending action count.
- * @param[in] stream    Stream handle
- * @param[in] evts      #EV_IO_IN or #EV_IO_OUT
- * @return              Action count
- */
-EV_LOCAL size_t ev__nonblock_stream_size(ev_nonblock_stream_t* stream, unsigned evts);
-
-/**
- * @brief Abort pending requests
- * @param[in] stream    Stream handle
- * @param[in] evts      #EV_IO_IN or #EV_IO_OUT
- */
-EV_LOCAL void ev__nonblock_stream_abort(ev_nonblock_stream_t* stream);
-
-/**
- * @brief Cleanup pending requests
- * @param[in] stream    Stream handle
- * @param[in] evts      #EV_IO_IN or #EV_IO_OUT
- */
-EV_LOCAL void ev__nonblock_stream_cleanup(ev_nonblock_stream_t* stream, unsigned evts);
-
-#ifdef __cplusplus
-}
-#endif
-#endif
+#ifndef __EV_STREAM_UNIX_H__
+#define __EV_STREAM_UNIX_H__
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Write request that sends a range of a file by sendfile(2).
+ *
+ * #ev_write_t::bufs is always NULL, which tells the stream to take the data
+ * from #ev_nonblock_stream_file_t::fd instead of memory.
+ */
+typedef struct ev_nonblock_stream_file
+{
+    ev_write_t                  base;       /**< Base request */
+    int                         fd;         /**< File to send */
+    int64_t                     offset;     /**< Offset of next byte to send */
+} ev_nonblock_stream_file_t;
+
+typedef struct ev_nonblock_splice ev_nonblock_splice_t;
+
+/**
+ * @brief Splice finish callback.
+ * @param[in] req       Splice request
+ * @param[in] stat      0 if source reaches end of file and all data is moved,
+ *                      otherwise #ev_errno_t.
+ */
+typedef void (*ev_stream_splice_cb)(ev_nonblock_splice_t* req, int stat);
+
+/**
+ * @brief Move data from one stream to another through a kernel pipe.
+ *
+ * Data never enters user space. At most #ev_nonblock_splice_t::capacity bytes
+ * are buffered in the pipe, the source is not read until the destination
+ * takes some of them, so a slow destination throttles a fast source.
+ */
+struct ev_nonblock_splice
+{
+    ev_nonblock_stream_t*       src;        /**< Source stream */
+    ev_nonblock_stream_t*       dst;        /**< Destination stream */
+    int                         pipefd[2];  /**< Kernel buffer */
+    size_t                      capacity;   /**< Max bytes buffered in pipe */
+    size_t                      buffered;   /**< Bytes buffered in pipe */
+    uint64_t                    size;       /**< Bytes moved to destination */
+
+    struct
+    {
+        unsigned                src_eof : 1;    /**< Source reaches end of file */
+        unsigned                pipe_full : 1;  /**< Pipe is out of space */
+        unsigned                canceled : 1;   /**< One of the streams is aborted */
+    }flags;
+
+    ev_stream_splice_cb         cb;         /**< Finish callback */
+};
+
+/**
+ * @brief Initialize file write request.
+ * @param[out] req      Write request
+ * @param[in] fd        File to send
+ * @param[in] offset    Offset of first byte to send
+ * @param[in] len       Number of bytes to send
+ */
+EV_LOCAL void ev__nonblock_stream_file_init(ev_nonblock_stream_file_t* req,
+    int fd, int64_t offset, size_t len);
+
+/**
+ * @brief Check whether \p req is a #ev_nonblock_stream_file_t.
+ * @param[in] req       Write request
+ * @return              bool
+ */
+EV_LOCAL int ev__nonblock_stream_is_file(const ev_write_t* req);
+
+/**
+ * @brief Initialize stream.
+ * @param[in] loop      Event loop
+ * @param[out] stream   Stream handler
+ * @param[in] fd        File descriptor
+ * @param[in] wcb       Write callback
+ * @param[in] rcb       Read callback
+ */
+EV_LOCAL void ev__nonblock_stream_init(ev_loop_t* loop, ev_nonblock_stream_t* stream,
+    int fd, ev_stream_write_cb wcb, ev_stream_read_cb rcb);
+
+/**
+ * @brief Cleanup and exit stream
+ * @param[in] stream    Stream handler
+ */
+EV_LOCAL void ev__nonblock_stream_exit(ev_nonblock_stream_t* stream);
+
+/**
+ * @brief Do stream write
+ * @param[in] stream    Stream handle
+ * @param[in] req       Write request
+ * @return              #ev_errno_t
+ */
+EV_LOCAL int ev__nonblock_stream_write(ev_nonblock_stream_t* stream, ev_write_t* req);
+
+/**
+ * @brief Write as much of \p bufs as possible without blocking.
+ * @param[in] stream    Stream handle
+ * @param[in] bufs      Buffer list
+ * @param[in] nbuf      Buffer number
+ * @return              Bytes written, #EV_EAGAIN if nothing is written or
+ *                      there are pending write requests, or #ev_errno_t.
+ */
+EV_LOCAL ssize_t ev__nonblock_stream_try_write(ev_nonblock_stream_t* stream, ev_buf_t* bufs, size_t nbuf);
+
+/**
+ * @brief Send data with MSG_ZEROCOPY.
+ *
+ * Write requests still complete once their data is queued to the socket. The
+ * owner must keep user buffers until \p cb reports that the kernel released
+ * them. Zerocopy sends are counted from 0, the first send that finished a
+ * request is at most #ev_nonblock_stream_t::zerocopy::seq_sent - 1 at the time
+ * the write callback is called.
+ *
+ * @param[in] stream    Stream handle
+ * @param[in] cb        Completion callback, or NULL to turn zerocopy off.
+ */
+EV_LOCAL void ev__nonblock_stream_zerocopy(ev_nonblock_stream_t* stream, ev_stream_zerocopy_cb cb);
+
+/**
+ * @brief Watch size of write queue.
+ *
+ * \p cb is called with non-zero when bytes not sent reach \p high, and then
+ * with zero once they drop to \p low.
+ *
+ * @param[in] stream    Stream handle
+ * @param[in] low       Low watermark
+ * @param[in] high      High watermark
+ * @param[in] cb        Watermark callback, or NULL to disable.
+ */
+EV_LOCAL void ev__nonblock_stream_watermark(ev_nonblock_stream_t* stream,
+    size_t low, size_t high, ev_stream_watermark_cb cb);
+
+/**
+ * @brief Move all data of \p src to \p dst by splice(2).
+ *
+ * While splicing, \p src does not accept read requests and \p dst does not
+ * accept write requests. \p cb is called once when \p src reaches end of
+ * file, either stream fails, or either stream exits.
+ *
+ * @param[out] req      Splice request, must be valid until \p cb is called.
+ * @param[in] src       Source stream
+ * @param[in] dst       Destination stream
+ * @param[in] capacity  Max bytes buffered in kernel, 0 to use default.
+ * @param[in] cb        Finish callback
+ * @return              #ev_errno_t
+ */
+EV_LOCAL int ev__nonblock_stream_splice(ev_nonblock_splice_t* req,
+    ev_nonblock_stream_t* src, ev_nonblock_stream_t* dst, size_t capacity,
+    ev_stream_splice_cb cb);
+
+/**
+ * @brief Do stream read
+ * @param[in] stream    Stream handle
+ * @param[in] req       Read request
+ * @return              #ev_errno_t
+ */
+EV_LOCAL int ev__nonblock_stream_read(ev_nonblock_stream_t* stream, ev_read_t* req);
+
+/**
+ * @brief Get pending action count.
+ * @param[in] stream    Stream handle
+ * @param[in] evts      #EV_IO_IN or #EV_IO_OUT
+ * @return              Action count
+ */
+EV_LOCAL size_t ev__nonblock_stream_size(ev_nonblock_stream_t* stream, unsigned evts);
+
+/**
+ * @brief Abort pending requests
+ * @param[in] stream    Stream handle
+ * @param[in] evts      #EV_IO_IN or #EV_IO_OUT
+ */
+EV_LOCAL void ev__nonblock_stream_abort(ev_nonblock_stream_t* stream);
+
+/**
+ * @brief Cleanup pending requests
+ * @param[in] stream    Stream handle
+ * @param[in] evts      #EV_IO_IN or #EV_IO_OUT
+ */
+EV_LOCAL void ev__nonblock_stream_cleanup(ev_nonblock_stream_t* stream, unsigned evts);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -1,589 +1,1438 @@
-#include <sys/uio.h>
-#include <assert.h>
-#include <unistd.h>
-
-static void _ev_tcp_close_fd(ev_tcp_t *sock)
-{
-    if (sock->sock != EV_OS_SOCKET_INVALID)
-    {
-        close(sock->sock);
-        sock->sock = EV_OS_SOCKET_INVALID;
-    }
-}
-
-static void _ev_tcp_cleanup_listen_queue(ev_tcp_t *s_sock, int stat)
-{
-    ev_list_node_t *it;
-    while ((it = ev_list_pop_front(&s_sock->backend.u.listen.accept_queue)) !=
-           NULL)
-    {
-        ev_tcp_t *c_sock =
-            EV_CONTAINER_OF(it, ev_tcp_t, backend.u.accept.accept_node);
-        c_sock->backend.u.accept.cb(s_sock, c_sock, stat,
-                                    c_sock->backend.u.accept.arg);
-    }
-}
-
-static void _ev_tcp_connect_callback_once(ev_tcp_t *sock, int stat)
-{
-    ev_tcp_connect_cb bak_cb = sock->backend.u.client.cb;
-    void             *cb_arg = sock->backend.u.client.arg;
-    sock->backend.u.client.cb = NULL;
-    sock->backend.u.client.arg = NULL;
-    bak_cb(sock, stat, cb_arg);
-}
-
-static void _ev_tcp_on_close(ev_handle_t *handle)
-{
-    ev_tcp_t *sock = EV_CONTAINER_OF(handle, ev_tcp_t, base);
-
-    if (sock->base.data.flags & EV_HANDLE_TCP_STREAMING)
-    {
-        ev__nonblock_stream_exit(&sock->backend.u.stream);
-        sock->base.data.flags &= ~EV_HANDLE_TCP_STREAMING;
-    }
-
-    if (sock->base.data.flags & EV_HANDLE_TCP_LISTING)
-    {
-        _ev_tcp_cleanup_listen_queue(sock, EV_ECANCELED);
-        sock->base.data.flags &= ~EV_HANDLE_TCP_LISTING;
-    }
-
-    if (sock->base.data.flags & EV_HANDLE_TCP_CONNECTING)
-    {
-        _ev_tcp_connect_callback_once(sock, EV_ECANCELED);
-        sock->base.data.flags &= ~EV_HANDLE_TCP_CONNECTING;
-    }
-
-    if (sock->close_cb != NULL)
-    {
-        sock->close_cb(sock, sock->close_arg);
-    }
-    ev_free(sock);
-}
-
-static void _ev_tcp_smart_deactive(ev_tcp_t *sock)
-{
-    if (sock->base.data.flags & EV_HANDLE_TCP_LISTING)
-    {
-        size_t size = ev_list_size(&sock->backend.u.listen.accept_queue);
-        if (size != 0)
-        {
-            return;
-        }
-    }
-    else if (sock->base.data.flags & EV_HANDLE_TCP_ACCEPTING)
-    {
-        if (sock->backend.u.accept.cb != NULL)
-        {
-            return;
-        }
-    }
-    else if (sock->base.data.flags & EV_HANDLE_TCP_CONNECTING)
-    {
-        if (sock->backend.u.client.cb != NULL)
-        {
-            return;
-        }
-    }
-    else if (sock->base.data.flags & EV_HANDLE_TCP_STREAMING)
-    {
-        size_t io_sz = ev__nonblock_stream_size(&sock->backend.u.stream,
-                                                EV_IO_IN | EV_IO_OUT);
-        if (io_sz != 0)
-        {
-            return;
-        }
-    }
-
-    ev__handle_deactive(&sock->base);
-}
-
-static void _ev_tcp_on_connect(ev_tcp_t *sock)
-{
-    int       ret;
-    socklen_t result_len = sizeof(ret);
-
-    ev__nonblock_io_del(sock->base.loop, &sock->backend.u.client.io, EV_IO_OUT);
-
-    /* Get connect result */
-    if (getsockopt(sock->sock, SOL_SOCKET, SO_ERROR, &ret, &result_len) < 0)
-    {
-        sock->backend.u.client.stat = ev__translate_sys_error(errno);
-        goto fin;
-    }
-
-    /* Result is in `result` */
-    sock->backend.u.client.stat = ev__translate_sys_error(ret);
-
-fin:
-    sock->base.data.flags &= ~EV_HANDLE_TCP_CONNECTING;
-    _ev_tcp_connect_callback_once(sock, sock->backend.u.client.stat);
-    _ev_tcp_smart_deactive(sock);
-}
-
-static void _ev_tcp_w_user_callback_unix(ev_tcp_t           *sock,
-                                         ev_tcp_write_req_t *req, ssize_t size)
-{
-    _ev_tcp_smart_deactive(sock);
-    ev__write_exit(&req->base);
-    req->write_cb(sock, size, req->write_arg);
-    ev_free(req);
-}
-
-static void _ev_tcp_r_user_callback_unix(ev_tcp_t *sock, ev_tcp_read_req_t *req,
-                                         ssize_t size)
-{
-    _ev_tcp_smart_deactive(sock);
-    ev__read_exit(&req->base);
-    req->read_cb(sock, size, req->read_arg);
-    ev_free(req);
-}
-
-static void _on_tcp_write_done(ev_nonblock_stream_t *stream, ev_write_t *req,
-                               ssize_t size)
-{
-    ev_tcp_t *sock = EV_CONTAINER_OF(stream, ev_tcp_t, backend.u.stream);
-    ev_tcp_write_req_t *w_req = EV_CONTAINER_OF(req, ev_tcp_write_req_t, base);
-    _ev_tcp_w_user_callback_unix(sock, w_req, size);
-}
-
-static void _on_tcp_read_done(ev_nonblock_stream_t *stream, ev_read_t *req,
-                              ssize_t size)
-{
-    ev_tcp_t *sock = EV_CONTAINER_OF(stream, ev_tcp_t, backend.u.stream);
-
-    ev_tcp_read_req_t *r_req = EV_CONTAINER_OF(req, ev_tcp_read_req_t, base);
-    _ev_tcp_r_user_callback_unix(sock, r_req, size);
-}
-
-static void _ev_tcp_accept_user_callback_unix(ev_tcp_t *acpt, ev_tcp_t *conn,
-                                              int ret)
-{
-    conn->base.data.flags &= ~EV_HANDLE_TCP_ACCEPTING;
-    _ev_tcp_smart_deactive(conn);
-    _ev_tcp_smart_deactive(acpt);
-
-    ev_tcp_accept_cb bak_cb = conn->backend.u.accept.cb;
-    void            *cb_arg = conn->backend.u.accept.arg;
-    conn->backend.u.accept.cb = NULL;
-    conn->backend.u.accept.arg = NULL;
-    bak_cb(acpt, conn, ret, cb_arg);
-}
-
-static void _ev_tcp_on_accept(ev_tcp_t *acpt)
-{
-    ev_list_node_t *it =
-        ev_list_pop_front(&acpt->backend.u.listen.accept_queue);
-    if (it == NULL)
-    {
-        EV_ABORT("empty accept queue");
-    }
-
-    ev_tcp_t *conn =
-        EV_CONTAINER_OF(it, ev_tcp_t, backend.u.accept.accept_node);
-    _ev_tcp_close_fd(conn);
-
-    do
-    {
-        conn->sock = accept(acpt->sock, NULL, NULL);
-    } while (conn->sock == -1 && errno == EINTR);
-
-    int ret = conn->sock >= 0 ? 0 : ev__translate_sys_error(errno);
-    if (ret == 0)
-    { /* Set non-block mode */
-        if ((ret = ev__nonblock(conn->sock, 1)) != 0)
-        {
-            _ev_tcp_close_fd(conn);
-        }
-    }
-
-    _ev_tcp_accept_user_callback_unix(acpt, conn, ret);
-
-    /* might be close in callback */
-    if (ev__handle_is_closing(&acpt->base))
-    {
-        return;
-    }
-    if (ev_list_size(&acpt->backend.u.listen.accept_queue) == 0)
-    {
-        ev__nonblock_io_del(acpt->base.loop, &acpt->backend.u.listen.io,
-                            EV_IO_IN);
-    }
-}
-
-static void _ev_tcp_on_server_event(ev_nonblock_io_t *io, unsigned evts,
-                                    void *arg)
-{
-    (void)evts;
-    (void)arg;
-    ev_tcp_t *sock = EV_CONTAINER_OF(io, ev_tcp_t, backend.u.listen.io);
-
-    _ev_tcp_on_accept(sock);
-}
-
-static void _ev_tcp_on_client_event(ev_nonblock_io_t *io, unsigned evts,
-                                    void *arg)
-{
-    (void)evts;
-    (void)arg;
-    ev_tcp_t *sock = EV_CONTAINER_OF(io, ev_tcp_t, backend.u.client.io);
-
-    _ev_tcp_on_connect(sock);
-}
-
-/**
- * @return #ev_errno_t
- */
-static int _ev_tcp_setup_fd(ev_tcp_t *sock, int domain, int is_server,
-                            int *new_fd)
-{
-    int ret = 0;
-    int tmp_new_fd = 0;
-    if (sock->sock != EV_OS_SOCKET_INVALID)
-    {
-        goto fin;
-    }
-
-    if ((sock->sock = socket(domain, SOCK_STREAM, 0)) == EV_OS_SOCKET_INVALID)
-    {
-        ret = ev__translate_sys_error(errno);
-        goto fin;
-    }
-
-    if ((ret = ev__nonblock(sock->sock, 1)) != 0)
-    {
-        goto err_nonblock;
-    }
-
-    tmp_new_fd = 1;
-    if (is_server)
-    {
-        ev__nonblock_io_init(&sock->backend.u.listen.io, sock->sock,
-                             _ev_tcp_on_server_event, NULL);
-    }
-    else
-    {
-        ev__nonblock_io_init(&sock->backend.u.client.io, sock->sock,
-                             _ev_tcp_on_client_event, NULL);
-    }
-
-    goto fin;
-
-err_nonblock:
-    _ev_tcp_close_fd(sock);
-fin:
-    if (new_fd != NULL)
-    {
-        *new_fd = tmp_new_fd;
-    }
-    return ret;
-}
-
-static int _ev_tcp_is_listening(ev_tcp_t *sock)
-{
-    return sock->base.data.flags & EV_HANDLE_TCP_LISTING;
-}
-
-static void _ev_tcp_to_connect(ev_handle_t *handle)
-{
-    ev_tcp_t *sock = EV_CONTAINER_OF(handle, ev_tcp_t, base);
-
-    sock->base.data.flags &= ~EV_HANDLE_TCP_CONNECTING;
-    _ev_tcp_connect_callback_once(sock, 0);
-}
-
-static void _ev_tcp_setup_stream_once(ev_tcp_t *sock)
-{
-    if (sock->base.data.flags & EV_HANDLE_TCP_STREAMING)
-    {
-        return;
-    }
-    ev__nonblock_stream_init(sock->base.loop, &sock->backend.u.stream,
-                             sock->sock, _on_tcp_write_done, _on_tcp_read_done);
-    sock->base.data.flags |= EV_HANDLE_TCP_STREAMING;
-}
-
-int ev_tcp_init(ev_loop_t *loop, ev_tcp_t **sock)
-{
-    ev_tcp_t *new_sock = ev_malloc(sizeof(ev_tcp_t));
-    if (new_sock == NULL)
-    {
-        return EV_ENOMEM;
-    }
-
-    ev__handle_init(loop, &new_sock->base, EV_ROLE_EV_TCP);
-    new_sock->close_cb = NULL;
-    new_sock->close_arg = NULL;
-    new_sock->sock = EV_OS_SOCKET_INVALID;
-
-    *sock = new_sock;
-    return 0;
-}
-
-void ev_tcp_exit(ev_tcp_t *sock, ev_tcp_close_cb cb, void *arg)
-{
-    /* Stop all pending IO actions */
-    if (sock->base.data.flags & EV_HANDLE_TCP_STREAMING)
-    {
-        ev__nonblock_stream_abort(&sock->backend.u.stream);
-    }
-    if (sock->base.data.flags & EV_HANDLE_TCP_LISTING)
-    {
-        ev__nonblock_io_del(sock->base.loop, &sock->backend.u.listen.io,
-                            EV_IO_IN);
-    }
-    if (sock->base.data.flags & EV_HANDLE_TCP_CONNECTING)
-    {
-        ev__nonblock_io_del(sock->base.loop, &sock->backend.u.client.io,
-                            EV_IO_OUT);
-    }
-
-    /* Close fd */
-    _ev_tcp_close_fd(sock);
-
-    sock->close_cb = cb;
-    sock->close_arg = arg;
-    ev__handle_exit(&sock->base, _ev_tcp_on_close);
-}
-
-int ev_tcp_bind(ev_tcp_t *tcp, const struct sockaddr *addr, size_t addrlen)
-{
-    int ret;
-    int flag_new_fd;
-    if ((ret = _ev_tcp_setup_fd(tcp, addr->sa_family, 1, &flag_new_fd)) != 0)
-    {
-        return ret;
-    }
-
-    if ((ret = bind(tcp->sock, addr, addrlen)) != 0)
-    {
-        ret = ev__translate_sys_error(errno);
-        goto err_bind;
-    }
-    tcp->base.data.flags |= EV_HABDLE_TCP_BOUND;
-
-    return 0;
-
-err_bind:
-    if (flag_new_fd)
-    {
-        _ev_tcp_close_fd(tcp);
-    }
-    return ret;
-}
-
-int ev_tcp_listen(ev_tcp_t *tcp, int backlog)
-{
-    if (_ev_tcp_is_listening(tcp))
-    {
-        return EV_EADDRINUSE;
-    }
-
-    int ret;
-    if ((ret = listen(tcp->sock, backlog)) != 0)
-    {
-        return ev__translate_sys_error(errno);
-    }
-
-    ev_list_init(&tcp->backend.u.listen.accept_queue);
-    tcp->base.data.flags |= EV_HANDLE_TCP_LISTING;
-
-    return 0;
-}
-
-int ev_tcp_accept(ev_tcp_t *lisn, ev_tcp_t *conn, ev_tcp_accept_cb cb,
-                  void *arg)
-{
-    if (lisn == NULL || conn == NULL || cb == NULL)
-    {
-        return EV_EINVAL;
-    }
-    if (conn->base.data.flags & EV_HANDLE_TCP_ACCEPTING)
-    {
-        return EV_EINPROGRESS;
-    }
-
-    conn->base.data.flags |= EV_HANDLE_TCP_ACCEPTING;
-    conn->backend.u.accept.cb = cb;
-    conn->backend.u.accept.arg = arg;
-    ev_list_push_back(&lisn->backend.u.listen.accept_queue,
-                      &conn->backend.u.accept.accept_node);
-    ev__nonblock_io_add(lisn->base.loop, &lisn->backend.u.listen.io, EV_IO_IN);
-
-    ev__handle_active(&lisn->base);
-    ev__handle_active(&conn->base);
-
-    return 0;
-}
-
-int ev_tcp_write(ev_tcp_t *sock, ev_buf_t *bufs, size_t nbuf,
-                 ev_tcp_write_cb cb, void *arg)
-{
-    if (sock->base.data.flags &
-        (EV_HANDLE_TCP_LISTING | EV_HANDLE_TCP_ACCEPTING |
-         EV_HANDLE_TCP_CONNECTING))
-    {
-        return EV_EINVAL;
-    }
-
-    ev_tcp_write_req_t *req = ev_malloc(sizeof(ev_tcp_write_req_t));
-    if (req == NULL)
-    {
-        return EV_ENOMEM;
-    }
-
-    req->write_cb = cb;
-    req->write_arg = arg;
-    int ret = ev__write_init(&req->base, bufs, nbuf);
-    if (ret != 0)
-    {
-        ev_free(req);
-        return ret;
-    }
-
-    _ev_tcp_setup_stream_once(sock);
-
-    ev__handle_active(&sock->base);
-    ret = ev__nonblock_stream_write(&sock->backend.u.stream, &req->base);
-
-    if (ret != 0)
-    {
-        _ev_tcp_smart_deactive(sock);
-        ev_free(req);
-        return ret;
-    }
-    return 0;
-}
-
-int ev_tcp_read(ev_tcp_t *sock, ev_buf_t *bufs, size_t nbuf, ev_tcp_read_cb cb,
-                void *arg)
-{
-    if (sock->base.data.flags &
-        (EV_HANDLE_TCP_LISTING | EV_HANDLE_TCP_ACCEPTING |
-         EV_HANDLE_TCP_CONNECTING))
-    {
-        return EV_EINVAL;
-    }
-
-    ev_tcp_read_req_t *req = ev_malloc(sizeof(ev_tcp_read_req_t));
-    if (req == NULL)
-    {
-        return EV_ENOMEM;
-    }
-
-    req->read_cb = cb;
-    req->read_arg = arg;
-    int ret = ev__read_init(&req->base, bufs, nbuf);
-    if (ret != 0)
-    {
-        ev_free(req);
-        return ret;
-    }
-
-    _ev_tcp_setup_stream_once(sock);
-
-    ev__handle_active(&sock->base);
-    ret = ev__nonblock_stream_read(&sock->backend.u.stream, &req->base);
-
-    if (ret != 0)
-    {
-        _ev_tcp_smart_deactive(sock);
-        ev_free(req);
-        return ret;
-    }
-    return 0;
-}
-
-int ev_tcp_getsockname(ev_tcp_t *sock, struct sockaddr *name, size_t *len)
-{
-    socklen_t socklen = *len;
-    if (getsockname(sock->sock, name, &socklen) != 0)
-    {
-        return ev__translate_sys_error(errno);
-    }
-
-    *len = (size_t)socklen;
-    return 0;
-}
-
-int ev_tcp_getpeername(ev_tcp_t *sock, struct sockaddr *name, size_t *len)
-{
-    int       ret;
-    socklen_t socklen = *len;
-
-    if ((ret = getpeername(sock->sock, name, &socklen)) != 0)
-    {
-        return ev__translate_sys_error(errno);
-    }
-
-    *len = socklen;
-    return 0;
-}
-
-int ev_tcp_connect(ev_tcp_t *sock, struct sockaddr *addr, size_t size,
-                   ev_tcp_connect_cb cb, void *arg)
-{
-    int        ret;
-    ev_loop_t *loop = sock->base.loop;
-
-    if (sock->base.data.flags & EV_HANDLE_TCP_CONNECTING)
-    {
-        return EV_EINPROGRESS;
-    }
-    if (sock->base.data.flags &
-        (EV_HANDLE_TCP_LISTING | EV_HANDLE_TCP_ACCEPTING |
-         EV_HANDLE_TCP_STREAMING))
-    {
-        return EV_EINVAL;
-    }
-
-    if ((ret = _ev_tcp_setup_fd(sock, addr->sa_family, 0, NULL)) != 0)
-    {
-        return ret;
-    }
-
-    sock->backend.u.client.cb = cb;
-    sock->backend.u.client.arg = arg;
-    sock->base.data.flags |= EV_HANDLE_TCP_CONNECTING;
-
-    if ((ret = connect(sock->sock, addr, size)) == 0)
-    { /* Connect success immediately */
-        sock->backend.u.client.stat = 0;
-        ev__backlog_submit(&sock->base, _ev_tcp_to_connect);
-        return 0;
-    }
-
-    if (errno != EINPROGRESS)
-    {
-        sock->base.data.flags &= ~EV_HANDLE_TCP_CONNECTING;
-        ret = ev__translate_sys_error(errno);
-        goto err;
-    }
-
-    ev__handle_active(&sock->base);
-    ev__nonblock_io_add(loop, &sock->backend.u.client.io, EV_IO_OUT);
-
-    return 0;
-
-err:
-    _ev_tcp_close_fd(sock);
-    ev__handle_deactive(&sock->base);
-    return ret;
-}
-
-EV_LOCAL int ev__tcp_open(ev_tcp_t *tcp, int fd)
-{
-    int busy_flags = EV_HANDLE_TCP_LISTING | EV_HANDLE_TCP_ACCEPTING |
-                     EV_HANDLE_TCP_STREAMING | EV_HANDLE_TCP_CONNECTING |
-                     EV_HABDLE_TCP_BOUND;
-    if (tcp->base.data.flags & busy_flags)
-    {
-        return EV_EBUSY;
-    }
-
-    tcp->sock = fd;
-    _ev_tcp_setup_stream_once(tcp);
-
-    return 0;
-}
+#define _GNU_SOURCE
+#include <netinet/tcp.h>
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <assert.h>
+#include <unistd.h>
+
+/**
+ * @brief File send request token for TCP socket.
+ */
+typedef struct ev_tcp_sendfile_req
+{
+    ev_nonblock_stream_file_t base;      /**< Base object */
+    ev_tcp_write_cb           write_cb;  /**< User callback */
+    void                     *write_arg; /**< User defined argument. */
+} ev_tcp_sendfile_req_t;
+
+/**
+ * @brief Request token of #ev_tcp_pipe_to_ex().
+ */
+typedef struct ev_tcp_pipe_req
+{
+    ev_nonblock_splice_t base;     /**< Base object */
+    ev_loop_t           *loop;     /**< Event loop */
+    ev_role_t            src_role; /**< Type of source handle */
+    void                *src;      /**< Source handle */
+    ev_role_t            dst_role; /**< Type of destination handle */
+    void                *dst;      /**< Destination handle */
+    ev_tcp_pipe_cb       cb;       /**< User callback */
+    void                *arg;      /**< User defined argument. */
+} ev_tcp_pipe_req_t;
+
+static void _ev_tcp_close_fd(ev_tcp_t *sock)
+{
+    if (sock->sock != EV_OS_SOCKET_INVALID)
+    {
+        close(sock->sock);
+        sock->sock = EV_OS_SOCKET_INVALID;
+    }
+}
+
+static void _ev_tcp_cleanup_listen_queue(ev_tcp_t *s_sock, int stat)
+{
+    ev_list_node_t *it;
+    while ((it = ev_list_pop_front(&s_sock->backend.u.listen.accept_queue)) !=
+           NULL)
+    {
+        ev_tcp_t *c_sock =
+            EV_CONTAINER_OF(it, ev_tcp_t, backend.u.accept.accept_node);
+        c_sock->backend.u.accept.cb(s_sock, c_sock, stat,
+                                    c_sock->backend.u.accept.arg);
+    }
+}
+
+static void _ev_tcp_connect_callback_once(ev_tcp_t *sock, int stat)
+{
+    ev_tcp_connect_cb bak_cb = sock->backend.u.client.cb;
+    void             *cb_arg = sock->backend.u.client.arg;
+    sock->backend.u.client.cb = NULL;
+    sock->backend.u.client.arg = NULL;
+    bak_cb(sock, stat, cb_arg);
+}
+
+static void _ev_tcp_smart_deactive(ev_tcp_t *sock)
+{
+    if (sock->base.data.flags & EV_HANDLE_TCP_LISTING)
+    {
+        size_t size = ev_list_size(&sock->backend.u.listen.accept_queue);
+        if (size != 0 || sock->backend.u.listen.on_conn != NULL)
+        {
+            return;
+        }
+    }
+    else if (sock->base.data.flags & EV_HANDLE_TCP_ACCEPTING)
+    {
+        if (sock->backend.u.accept.cb != NULL)
+        {
+            return;
+        }
+    }
+    else if (sock->base.data.flags & EV_HANDLE_TCP_CONNECTING)
+    {
+        if (sock->backend.u.client.cb != NULL)
+        {
+            return;
+        }
+    }
+    else if (sock->base.data.flags & EV_HANDLE_TCP_STREAMING)
+    {
+        size_t io_sz = ev__nonblock_stream_size(&sock->backend.u.stream,
+                                                EV_IO_IN | EV_IO_OUT);
+        if (io_sz != 0 || ev_list_size(&sock->backend.w_done) != 0 ||
+            ev_list_size(&sock->backend.zc_queue) != 0)
+        {
+            return;
+        }
+    }
+
+    ev__handle_deactive(&sock->base);
+}
+
+static void _ev_tcp_on_connect(ev_tcp_t *sock)
+{
+    int       ret;
+    socklen_t result_len = sizeof(ret);
+
+    ev__nonblock_io_del(sock->base.loop, &sock->backend.u.client.io, EV_IO_OUT);
+
+    /* Get connect result */
+    if (getsockopt(sock->sock, SOL_SOCKET, SO_ERROR, &ret, &result_len) < 0)
+    {
+        sock->backend.u.client.stat = ev__translate_sys_error(errno);
+        goto fin;
+    }
+
+    /* Result is in `result` */
+    sock->backend.u.client.stat = ev__translate_sys_error(ret);
+
+fin:
+    sock->base.data.flags &= ~EV_HANDLE_TCP_CONNECTING;
+    _ev_tcp_connect_callback_once(sock, sock->backend.u.client.stat);
+    _ev_tcp_smart_deactive(sock);
+}
+
+static void _ev_tcp_w_user_callback_unix(ev_tcp_t           *sock,
+                                         ev_tcp_write_req_t *req, ssize_t size)
+{
+    _ev_tcp_smart_deactive(sock);
+    ev__write_exit(&req->base);
+    req->write_cb(sock, size, req->write_arg);
+    ev__loop_free(sock->base.loop, req);
+}
+
+static void _ev_tcp_r_user_callback_unix(ev_tcp_t *sock, ev_tcp_read_req_t *req,
+                                         ssize_t size)
+{
+    _ev_tcp_smart_deactive(sock);
+    ev__read_exit(&req->base);
+    req->read_cb(sock, size, req->read_arg);
+    ev__loop_free(sock->base.loop, req);
+}
+
+static void _on_tcp_write_done(ev_nonblock_stream_t *stream, ev_write_t *req,
+                               ssize_t size)
+{
+    ev_tcp_t *sock = EV_CONTAINER_OF(stream, ev_tcp_t, backend.u.stream);
+
+    if (ev__nonblock_stream_is_file(req))
+    {
+        ev_tcp_sendfile_req_t *f_req =
+            EV_CONTAINER_OF(req, ev_tcp_sendfile_req_t, base.base);
+        _ev_tcp_smart_deactive(sock);
+        f_req->write_cb(sock, size, f_req->write_arg);
+        ev__loop_free(sock->base.loop, f_req);
+        return;
+    }
+
+    ev_tcp_write_req_t *w_req = EV_CONTAINER_OF(req, ev_tcp_write_req_t, base);
+
+    /*
+     * The send that finished this request is the last one, so the buffer can
+     * be given back once every send issued so far is completed.
+     */
+    if (size >= 0 && stream->zerocopy.cb != NULL &&
+        stream->zerocopy.seq_sent != stream->zerocopy.seq_done)
+    {
+        w_req->backend.zc_seq = stream->zerocopy.seq_sent;
+        ev_list_push_back(&sock->backend.zc_queue, &w_req->base.node);
+        return;
+    }
+
+    _ev_tcp_w_user_callback_unix(sock, w_req, size);
+}
+
+static void _on_tcp_zerocopy_done(ev_nonblock_stream_t *stream,
+                                  uint32_t              seq_done)
+{
+    ev_tcp_t *sock = EV_CONTAINER_OF(stream, ev_tcp_t, backend.u.stream);
+
+    ev_list_node_t *it;
+    while ((it = ev_list_begin(&sock->backend.zc_queue)) != NULL)
+    {
+        ev_tcp_write_req_t *req =
+            EV_CONTAINER_OF(it, ev_tcp_write_req_t, base.node);
+        if ((int32_t)(req->backend.zc_seq - seq_done) > 0)
+        {
+            break;
+        }
+        ev_list_erase(&sock->backend.zc_queue, it);
+        _ev_tcp_w_user_callback_unix(sock, req, req->base.size);
+    }
+}
+
+static void _ev_tcp_cleanup_zerocopy(ev_tcp_t *sock)
+{
+    ev_list_node_t *it;
+    while ((it = ev_list_pop_front(&sock->backend.zc_queue)) != NULL)
+    {
+        ev_tcp_write_req_t *req =
+            EV_CONTAINER_OF(it, ev_tcp_write_req_t, base.node);
+        _ev_tcp_w_user_callback_unix(sock, req, EV_ECANCELED);
+    }
+}
+
+static void _ev_tcp_flush_write_done(ev_tcp_t *sock)
+{
+    ev_list_node_t *it;
+    while ((it = ev_list_pop_front(&sock->backend.w_done)) != NULL)
+    {
+        ev_tcp_write_req_t *req =
+            EV_CONTAINER_OF(it, ev_tcp_write_req_t, base.node);
+        _ev_tcp_w_user_callback_unix(sock, req,
+                                     req->backend.stat != 0 ?
+                                         req->backend.stat :
+                                         (ssize_t)req->base.size);
+    }
+}
+
+static void _ev_tcp_on_write_backlog(ev_handle_t *handle)
+{
+    ev_tcp_t *sock = EV_CONTAINER_OF(handle, ev_tcp_t, base);
+    _ev_tcp_flush_write_done(sock);
+}
+
+static void _ev_tcp_on_close(ev_handle_t *handle)
+{
+    ev_tcp_t *sock = EV_CONTAINER_OF(handle, ev_tcp_t, base);
+
+    if (sock->base.data.flags & EV_HANDLE_TCP_STREAMING)
+    {
+        _ev_tcp_flush_write_done(sock);
+        _ev_tcp_cleanup_zerocopy(sock);
+        ev__nonblock_stream_exit(&sock->backend.u.stream);
+        sock->base.data.flags &= ~EV_HANDLE_TCP_STREAMING;
+    }
+
+    if (sock->base.data.flags & EV_HANDLE_TCP_LISTING)
+    {
+        _ev_tcp_cleanup_listen_queue(sock, EV_ECANCELED);
+        sock->base.data.flags &= ~EV_HANDLE_TCP_LISTING;
+    }
+
+    if (sock->base.data.flags & EV_HANDLE_TCP_CONNECTING)
+    {
+        _ev_tcp_connect_callback_once(sock, EV_ECANCELED);
+        sock->base.data.flags &= ~EV_HANDLE_TCP_CONNECTING;
+    }
+
+    ev__tcp_pool_unlink(sock);
+    ev__tcp_recycle_exit(sock);
+
+    /* Caller owned memory may be released in close callback */
+    ev_loop_t *loop = sock->base.loop;
+    int        inplace = sock->base.data.flags & EV_HANDLE_INPLACE;
+    int        recycled = ev__tcp_recycle(sock);
+    if (sock->close_cb != NULL)
+    {
+        sock->close_cb(sock, sock->close_arg);
+    }
+
+    if (!recycled && !inplace)
+    {
+        ev__loop_free(loop, sock);
+    }
+}
+
+/**
+ * @brief Try to finish \p req without waiting for the socket to be writable.
+ *
+ * A failed send finishes \p req as well, the error is passed to its callback
+ * just like a queued request.
+ *
+ * @return  #EV_SUCCESS if \p req is finished, #EV_EAGAIN if the remaining
+ *          data need to be queued, or #ev_errno_t if the stream does not
+ *          accept writes.
+ */
+static int _ev_tcp_write_optimistic(ev_tcp_t *sock, ev_tcp_write_req_t *req)
+{
+    ssize_t write_size = ev__nonblock_stream_try_write(
+        &sock->backend.u.stream, req->base.bufs, req->base.nbuf);
+
+    /* Same as ev__nonblock_stream_write(), stream state is checked first */
+    if (write_size == EV_EAGAIN || write_size == EV_EBADF ||
+        write_size == EV_EBUSY)
+    {
+        return (int)write_size;
+    }
+
+    if (write_size < 0)
+    {
+        req->backend.stat = (int)write_size;
+    }
+    else if (ev__finalize_send_req_unix(&req->base, (size_t)write_size) != 0)
+    {
+        return EV_EAGAIN;
+    }
+
+    /* Callback must not be called inside ev_tcp_write() */
+    ev_list_push_back(&sock->backend.w_done, &req->base.node);
+    ev__backlog_submit(&sock->base, _ev_tcp_on_write_backlog);
+
+    return 0;
+}
+
+static void _on_tcp_read_done(ev_nonblock_stream_t *stream, ev_read_t *req,
+                              ssize_t size)
+{
+    ev_tcp_t *sock = EV_CONTAINER_OF(stream, ev_tcp_t, backend.u.stream);
+
+    ev_tcp_read_req_t *r_req = EV_CONTAINER_OF(req, ev_tcp_read_req_t, base);
+    _ev_tcp_r_user_callback_unix(sock, r_req, size);
+}
+
+static void _ev_tcp_accept_user_callback_unix(ev_tcp_t *acpt, ev_tcp_t *conn,
+                                              int ret)
+{
+    conn->base.data.flags &= ~EV_HANDLE_TCP_ACCEPTING;
+    _ev_tcp_smart_deactive(conn);
+    _ev_tcp_smart_deactive(acpt);
+
+    ev_tcp_accept_cb bak_cb = conn->backend.u.accept.cb;
+    void            *cb_arg = conn->backend.u.accept.arg;
+    conn->backend.u.accept.cb = NULL;
+    conn->backend.u.accept.arg = NULL;
+    bak_cb(acpt, conn, ret, cb_arg);
+}
+
+/**
+ * @brief Accept a nonblocking, close-on-exec connection.
+ * @return  Socket, or #ev_errno_t.
+ */
+static int _ev_tcp_accept_fd(int lisn_fd)
+{
+    int fd;
+#if defined(SOCK_NONBLOCK) && defined(SOCK_CLOEXEC)
+    do
+    {
+        fd = accept4(lisn_fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    } while (fd == -1 && errno == EINTR);
+
+    return fd >= 0 ? fd : ev__translate_sys_error(errno);
+#else
+    int ret;
+    do
+    {
+        fd = accept(lisn_fd, NULL, NULL);
+    } while (fd == -1 && errno == EINTR);
+
+    if (fd < 0)
+    {
+        return ev__translate_sys_error(errno);
+    }
+    if ((ret = ev__nonblock(fd, 1)) != 0 || (ret = ev__cloexec(fd, 1)) != 0)
+    {
+        close(fd);
+        return ret;
+    }
+    return fd;
+#endif
+}
+
+static void _ev_tcp_on_accept_queue(ev_tcp_t *acpt)
+{
+    ev_list_node_t *it =
+        ev_list_pop_front(&acpt->backend.u.listen.accept_queue);
+
+    ev_tcp_t *conn =
+        EV_CONTAINER_OF(it, ev_tcp_t, backend.u.accept.accept_node);
+    _ev_tcp_close_fd(conn);
+
+    int ret = _ev_tcp_accept_fd(acpt->sock);
+    if (ret >= 0)
+    {
+        conn->sock = ret;
+        ret = 0;
+        ev__tcp_opts_inherit(conn, acpt, 1);
+    }
+
+    _ev_tcp_accept_user_callback_unix(acpt, conn, ret);
+}
+
+/**
+ * @brief Keep a spare fd so connections can still be taken off the backlog
+ *   when the process runs out of fds.
+ */
+static void _ev_tcp_reserve_emfile_fd(ev_loop_t *loop)
+{
+    if (loop->backend.emfile_fd == -1)
+    {
+        loop->backend.emfile_fd = open("/", O_RDONLY | O_CLOEXEC);
+    }
+}
+
+/**
+ * @brief Drop pending connections of \p lisn after accept failed with
+ *   EMFILE or ENFILE.
+ *
+ * The listen socket is level triggered, the backlog would wake us up again
+ * and again with the same error. Release the spare fd, then accept and close
+ * connections until the backlog is empty.
+ */
+static void _ev_tcp_drop_backlog(ev_tcp_t *lisn)
+{
+    ev_loop_t *loop = lisn->base.loop;
+    if (loop->backend.emfile_fd == -1)
+    {
+        return;
+    }
+
+    close(loop->backend.emfile_fd);
+    loop->backend.emfile_fd = -1;
+
+    int fd;
+    while ((fd = _ev_tcp_accept_fd(lisn->sock)) >= 0 ||
+           fd == EV_ECONNABORTED)
+    {
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+    }
+
+    _ev_tcp_reserve_emfile_fd(loop);
+}
+
+/**
+ * @brief Accept connections until there is none left or budget is used up.
+ */
+static void _ev_tcp_on_accept_drain(ev_tcp_t *lisn)
+{
+    size_t i;
+    for (i = 0; i < lisn->backend.u.listen.budget; i++)
+    {
+        ev_tcp_t *conn = NULL;
+        int       ret = _ev_tcp_accept_fd(lisn->sock);
+        if (ret == EV_EAGAIN)
+        {
+            return;
+        }
+        if (ret == EV_ECONNABORTED)
+        { /* Peer is gone before we accept it, nothing to report. */
+            continue;
+        }
+
+        if (ret >= 0)
+        {
+            int fd = ret;
+            if ((ret = ev_tcp_init_accept(lisn, &conn)) == 0)
+            {
+                conn->sock = fd;
+                ev__tcp_opts_inherit(conn, lisn, 1);
+            }
+            else
+            {
+                close(fd);
+            }
+        }
+
+        lisn->backend.u.listen.on_conn(lisn, conn, ret,
+                                       lisn->backend.u.listen.on_conn_arg);
+        if (ev__handle_is_closing(&lisn->base))
+        {
+            return;
+        }
+        if (ret == EV_EMFILE || ret == EV_ENFILE)
+        {
+            _ev_tcp_drop_backlog(lisn);
+        }
+
+        /* Other errors are reported again next round. */
+        if (ret != 0 || lisn->backend.u.listen.on_conn == NULL)
+        {
+            return;
+        }
+    }
+}
+
+static void _ev_tcp_on_accept(ev_tcp_t *acpt)
+{
+    if (ev_list_size(&acpt->backend.u.listen.accept_queue) != 0)
+    {
+        _ev_tcp_on_accept_queue(acpt);
+    }
+    else if (acpt->backend.u.listen.on_conn != NULL)
+    {
+        _ev_tcp_on_accept_drain(acpt);
+    }
+
+    /* might be close in callback */
+    if (ev__handle_is_closing(&acpt->base))
+    {
+        return;
+    }
+    if (ev_list_size(&acpt->backend.u.listen.accept_queue) == 0 &&
+        acpt->backend.u.listen.on_conn == NULL)
+    {
+        ev__nonblock_io_del(acpt->base.loop, &acpt->backend.u.listen.io,
+                            EV_IO_IN);
+    }
+}
+
+static void _ev_tcp_on_server_event(ev_nonblock_io_t *io, unsigned evts,
+                                    void *arg)
+{
+    (void)evts;
+    (void)arg;
+    ev_tcp_t *sock = EV_CONTAINER_OF(io, ev_tcp_t, backend.u.listen.io);
+
+    _ev_tcp_on_accept(sock);
+}
+
+static void _ev_tcp_on_client_event(ev_nonblock_io_t *io, unsigned evts,
+                                    void *arg)
+{
+    (void)evts;
+    (void)arg;
+    ev_tcp_t *sock = EV_CONTAINER_OF(io, ev_tcp_t, backend.u.client.io);
+
+    _ev_tcp_on_connect(sock);
+}
+
+/**
+ * @return #ev_errno_t
+ */
+static int _ev_tcp_setup_fd(ev_tcp_t *sock, int domain, int is_server,
+                            int *new_fd)
+{
+    int ret = 0;
+    int tmp_new_fd = 0;
+    if (sock->sock != EV_OS_SOCKET_INVALID)
+    {
+        goto fin;
+    }
+
+    if ((sock->sock = socket(domain, SOCK_STREAM, 0)) == EV_OS_SOCKET_INVALID)
+    {
+        ret = ev__translate_sys_error(errno);
+        goto fin;
+    }
+
+    if ((ret = ev__nonblock(sock->sock, 1)) != 0)
+    {
+        goto err_nonblock;
+    }
+    if ((ret = ev__tcp_opts_apply(sock, 0)) != 0)
+    {
+        goto err_nonblock;
+    }
+
+    tmp_new_fd = 1;
+    if (is_server)
+    {
+        ev__nonblock_io_init(&sock->backend.u.listen.io, sock->sock,
+                             _ev_tcp_on_server_event, NULL);
+    }
+    else
+    {
+        ev__nonblock_io_init(&sock->backend.u.client.io, sock->sock,
+                             _ev_tcp_on_client_event, NULL);
+    }
+
+    goto fin;
+
+err_nonblock:
+    _ev_tcp_close_fd(sock);
+fin:
+    if (new_fd != NULL)
+    {
+        *new_fd = tmp_new_fd;
+    }
+    return ret;
+}
+
+static int _ev_tcp_is_listening(ev_tcp_t *sock)
+{
+    return sock->base.data.flags & EV_HANDLE_TCP_LISTING;
+}
+
+static void _ev_tcp_to_connect(ev_handle_t *handle)
+{
+    ev_tcp_t *sock = EV_CONTAINER_OF(handle, ev_tcp_t, base);
+
+    sock->base.data.flags &= ~EV_HANDLE_TCP_CONNECTING;
+    _ev_tcp_connect_callback_once(sock, 0);
+}
+
+static void _on_tcp_watermark(ev_nonblock_stream_t *stream, int high)
+{
+    ev_tcp_t *sock = EV_CONTAINER_OF(stream, ev_tcp_t, backend.u.stream);
+    sock->backend.watermark.cb(sock, high, sock->backend.watermark.arg);
+}
+
+static void _ev_tcp_setup_watermark(ev_tcp_t *sock)
+{
+    ev__nonblock_stream_watermark(
+        &sock->backend.u.stream, sock->backend.watermark.low,
+        sock->backend.watermark.high,
+        sock->backend.watermark.cb != NULL ? _on_tcp_watermark : NULL);
+}
+
+static void _ev_tcp_setup_stream_once(ev_tcp_t *sock)
+{
+    if (sock->base.data.flags & EV_HANDLE_TCP_STREAMING)
+    {
+        return;
+    }
+    ev__nonblock_stream_init(sock->base.loop, &sock->backend.u.stream,
+                             sock->sock, _on_tcp_write_done, _on_tcp_read_done);
+    sock->base.data.flags |= EV_HANDLE_TCP_STREAMING;
+    _ev_tcp_setup_watermark(sock);
+}
+
+EV_LOCAL void ev__tcp_init(ev_loop_t *loop, ev_tcp_t *sock)
+{
+    ev__handle_init(loop, &sock->base, EV_ROLE_EV_TCP);
+    sock->close_cb = NULL;
+    sock->close_arg = NULL;
+    sock->sock = EV_OS_SOCKET_INVALID;
+    ev_list_init(&sock->backend.w_done);
+    ev_list_init(&sock->backend.zc_queue);
+    memset(&sock->backend.watermark, 0, sizeof(sock->backend.watermark));
+    ev__tcp_opts_init(sock);
+    ev__tcp_recycle_init(sock);
+    ev__tcp_pool_link_init(sock);
+}
+
+size_t ev_tcp_size(void)
+{
+    return sizeof(ev_tcp_t);
+}
+
+int ev_tcp_init(ev_loop_t *loop, ev_tcp_t **sock)
+{
+    ev_tcp_t *new_sock =
+        ev__loop_malloc(loop, EV_ALLOCATOR_TYPE_TCP, sizeof(ev_tcp_t));
+    if (new_sock == NULL)
+    {
+        return EV_ENOMEM;
+    }
+
+    ev__tcp_init(loop, new_sock);
+
+    *sock = new_sock;
+    return 0;
+}
+
+int ev_tcp_init_inplace(ev_loop_t *loop, ev_tcp_t **sock, void *mem)
+{
+    ev_tcp_t *new_sock = mem;
+
+    ev__tcp_init(loop, new_sock);
+    new_sock->base.data.flags |= EV_HANDLE_INPLACE;
+
+    *sock = new_sock;
+    return 0;
+}
+
+void ev_tcp_exit(ev_tcp_t *sock, ev_tcp_close_cb cb, void *arg)
+{
+    /* Stop all pending IO actions */
+    if (sock->base.data.flags & EV_HANDLE_TCP_STREAMING)
+    {
+        ev__nonblock_stream_abort(&sock->backend.u.stream);
+    }
+    if (sock->base.data.flags & EV_HANDLE_TCP_LISTING)
+    {
+        ev__nonblock_io_del(sock->base.loop, &sock->backend.u.listen.io,
+                            EV_IO_IN);
+    }
+    if (sock->base.data.flags & EV_HANDLE_TCP_CONNECTING)
+    {
+        ev__nonblock_io_del(sock->base.loop, &sock->backend.u.client.io,
+                            EV_IO_OUT);
+    }
+
+    /* Close fd */
+    _ev_tcp_close_fd(sock);
+
+    sock->close_cb = cb;
+    sock->close_arg = arg;
+    ev__handle_exit(&sock->base, _ev_tcp_on_close);
+}
+
+int ev_tcp_bind(ev_tcp_t *tcp, const struct sockaddr *addr, size_t addrlen)
+{
+    int ret;
+    int flag_new_fd;
+    if ((ret = _ev_tcp_setup_fd(tcp, addr->sa_family, 1, &flag_new_fd)) != 0)
+    {
+        return ret;
+    }
+
+    if ((ret = bind(tcp->sock, addr, addrlen)) != 0)
+    {
+        ret = ev__translate_sys_error(errno);
+        goto err_bind;
+    }
+    tcp->base.data.flags |= EV_HABDLE_TCP_BOUND;
+
+    return 0;
+
+err_bind:
+    if (flag_new_fd)
+    {
+        _ev_tcp_close_fd(tcp);
+    }
+    return ret;
+}
+
+int ev_tcp_listen(ev_tcp_t *tcp, int backlog)
+{
+    if (_ev_tcp_is_listening(tcp))
+    {
+        return EV_EADDRINUSE;
+    }
+
+    int ret;
+    if ((ret = ev__tcp_opts_apply(tcp, 1)) != 0)
+    {
+        return ret;
+    }
+    if ((ret = listen(tcp->sock, backlog)) != 0)
+    {
+        return ev__translate_sys_error(errno);
+    }
+
+    ev_list_init(&tcp->backend.u.listen.accept_queue);
+    tcp->backend.u.listen.on_conn = NULL;
+    tcp->backend.u.listen.on_conn_arg = NULL;
+    tcp->backend.u.listen.budget = 0;
+    tcp->base.data.flags |= EV_HANDLE_TCP_LISTING;
+    _ev_tcp_reserve_emfile_fd(tcp->base.loop);
+
+    return 0;
+}
+
+int ev_tcp_accept(ev_tcp_t *lisn, ev_tcp_t *conn, ev_tcp_accept_cb cb,
+                  void *arg)
+{
+    if (lisn == NULL || conn == NULL || cb == NULL)
+    {
+        return EV_EINVAL;
+    }
+    if (conn->base.data.flags & EV_HANDLE_TCP_ACCEPTING)
+    {
+        return EV_EINPROGRESS;
+    }
+
+    conn->base.data.flags |= EV_HANDLE_TCP_ACCEPTING;
+    conn->backend.u.accept.cb = cb;
+    conn->backend.u.accept.arg = arg;
+    ev_list_push_back(&lisn->backend.u.listen.accept_queue,
+                      &conn->backend.u.accept.accept_node);
+    ev__nonblock_io_add(lisn->base.loop, &lisn->backend.u.listen.io, EV_IO_IN);
+
+    ev__handle_active(&lisn->base);
+    ev__handle_active(&conn->base);
+
+    return 0;
+}
+
+int ev_tcp_accept_start(ev_tcp_t *lisn, size_t budget, ev_tcp_accept_cb cb,
+                        void *arg)
+{
+    if (cb == NULL || !_ev_tcp_is_listening(lisn))
+    {
+        return EV_EINVAL;
+    }
+    if (lisn->backend.u.listen.on_conn != NULL)
+    {
+        return EV_EALREADY;
+    }
+
+    lisn->backend.u.listen.on_conn = cb;
+    lisn->backend.u.listen.on_conn_arg = arg;
+    lisn->backend.u.listen.budget = budget != 0 ? budget : EV_TCP_ACCEPT_BUDGET;
+    ev__nonblock_io_add(lisn->base.loop, &lisn->backend.u.listen.io, EV_IO_IN);
+    ev__handle_active(&lisn->base);
+
+    return 0;
+}
+
+int ev_tcp_accept_stop(ev_tcp_t *lisn)
+{
+    if (!_ev_tcp_is_listening(lisn))
+    {
+        return EV_EINVAL;
+    }
+
+    lisn->backend.u.listen.on_conn = NULL;
+    lisn->backend.u.listen.on_conn_arg = NULL;
+    if (ev_list_size(&lisn->backend.u.listen.accept_queue) == 0)
+    {
+        ev__nonblock_io_del(lisn->base.loop, &lisn->backend.u.listen.io,
+                            EV_IO_IN);
+    }
+    _ev_tcp_smart_deactive(lisn);
+
+    return 0;
+}
+
+int ev_tcp_write(ev_tcp_t *sock, ev_buf_t *bufs, size_t nbuf,
+                 ev_tcp_write_cb cb, void *arg)
+{
+    if (sock->base.data.flags &
+        (EV_HANDLE_TCP_LISTING | EV_HANDLE_TCP_ACCEPTING |
+         EV_HANDLE_TCP_CONNECTING))
+    {
+        return EV_EINVAL;
+    }
+
+    ev_tcp_write_req_t *req = ev__loop_malloc(
+        sock->base.loop, EV_ALLOCATOR_TYPE_TCP, sizeof(ev_tcp_write_req_t));
+    if (req == NULL)
+    {
+        return EV_ENOMEM;
+    }
+
+    req->write_cb = cb;
+    req->write_arg = arg;
+    req->backend.stat = 0;
+    int ret = ev__write_init(&req->base, bufs, nbuf);
+    if (ret != 0)
+    {
+        ev__loop_free(sock->base.loop, req);
+        return ret;
+    }
+
+    _ev_tcp_setup_stream_once(sock);
+
+    ev__handle_active(&sock->base);
+    /* Zerocopy sends need the write queue to track completions */
+    if (sock->backend.u.stream.zerocopy.cb != NULL ||
+        (ret = _ev_tcp_write_optimistic(sock, req)) == EV_EAGAIN)
+    {
+        ret = ev__nonblock_stream_write(&sock->backend.u.stream, &req->base);
+    }
+
+    if (ret != 0)
+    {
+        _ev_tcp_smart_deactive(sock);
+        ev__loop_free(sock->base.loop, req);
+        return ret;
+    }
+    return 0;
+}
+
+int ev_tcp_sendfile(ev_tcp_t *sock, ev_file_t *file, int64_t offset,
+                    size_t len, ev_tcp_write_cb cb, void *arg)
+{
+    int ret;
+    if (sock->base.data.flags &
+        (EV_HANDLE_TCP_LISTING | EV_HANDLE_TCP_ACCEPTING |
+         EV_HANDLE_TCP_CONNECTING))
+    {
+        return EV_EINVAL;
+    }
+    if (offset < 0)
+    {
+        return EV_EINVAL;
+    }
+    if (sock->sock == EV_OS_SOCKET_INVALID)
+    {
+        return EV_ENOTCONN;
+    }
+
+    ev_tcp_sendfile_req_t *req = ev__loop_malloc(
+        sock->base.loop, EV_ALLOCATOR_TYPE_TCP, sizeof(ev_tcp_sendfile_req_t));
+    if (req == NULL)
+    {
+        return EV_ENOMEM;
+    }
+    req->write_cb = cb;
+    req->write_arg = arg;
+    ev__nonblock_stream_file_init(&req->base, file->file, offset, len);
+
+    _ev_tcp_setup_stream_once(sock);
+
+    ev__handle_active(&sock->base);
+    ret = ev__nonblock_stream_write(&sock->backend.u.stream, &req->base.base);
+    if (ret != 0)
+    {
+        _ev_tcp_smart_deactive(sock);
+        ev__loop_free(sock->base.loop, req);
+        return ret;
+    }
+    return 0;
+}
+
+ssize_t ev_tcp_try_write(ev_tcp_t *sock, ev_buf_t *bufs, size_t nbuf)
+{
+    if (sock->base.data.flags &
+        (EV_HANDLE_TCP_LISTING | EV_HANDLE_TCP_ACCEPTING |
+         EV_HANDLE_TCP_CONNECTING))
+    {
+        return EV_EINVAL;
+    }
+    if (sock->sock == EV_OS_SOCKET_INVALID)
+    {
+        return EV_EBADF;
+    }
+
+    _ev_tcp_setup_stream_once(sock);
+    return ev__nonblock_stream_try_write(&sock->backend.u.stream, bufs, nbuf);
+}
+
+static int _ev_tcp_pipe_endpoint(ev_role_t role, void *addr,
+                                 ev_handle_t         **handle,
+                                 ev_nonblock_stream_t **stream)
+{
+    if (role == EV_ROLE_EV_TCP)
+    {
+        ev_tcp_t *sock = addr;
+        if (sock->base.data.flags &
+            (EV_HANDLE_TCP_LISTING | EV_HANDLE_TCP_ACCEPTING |
+             EV_HANDLE_TCP_CONNECTING))
+        {
+            return EV_EINVAL;
+        }
+        if (sock->sock == EV_OS_SOCKET_INVALID)
+        {
+            return EV_EBADF;
+        }
+
+        _ev_tcp_setup_stream_once(sock);
+        *handle = &sock->base;
+        *stream = &sock->backend.u.stream;
+        return 0;
+    }
+
+    if (role == EV_ROLE_EV_PIPE)
+    {
+        ev_pipe_t *pipe = addr;
+        *handle = &pipe->base;
+        return ev__pipe_data_stream_unix(pipe, stream);
+    }
+
+    return EV_EINVAL;
+}
+
+static void _ev_tcp_pipe_smart_deactive(ev_role_t role, void *addr)
+{
+    if (role == EV_ROLE_EV_TCP)
+    {
+        _ev_tcp_smart_deactive(addr);
+    }
+    else
+    {
+        ev__pipe_smart_deactive_unix(addr);
+    }
+}
+
+static void _ev_tcp_on_pipe_done(ev_nonblock_splice_t *splice, int stat)
+{
+    ev_tcp_pipe_req_t *req = EV_CONTAINER_OF(splice, ev_tcp_pipe_req_t, base);
+    ev_tcp_pipe_cb     cb = req->cb;
+    void              *arg = req->arg;
+    void              *src = req->src;
+    void              *dst = req->dst;
+    uint64_t           size = req->base.size;
+
+    _ev_tcp_pipe_smart_deactive(req->src_role, src);
+    _ev_tcp_pipe_smart_deactive(req->dst_role, dst);
+    ev__loop_free(req->loop, req);
+
+    if (cb != NULL)
+    {
+        cb(src, dst, size, stat, arg);
+    }
+}
+
+int ev_tcp_pipe_to_ex(ev_role_t src_role, void *src, ev_role_t dst_role,
+                      void *dst, const ev_tcp_pipe_opts_t *opts)
+{
+    int                   ret;
+    ev_handle_t          *src_handle, *dst_handle;
+    ev_nonblock_stream_t *src_stream, *dst_stream;
+
+    if ((ret = _ev_tcp_pipe_endpoint(src_role, src, &src_handle,
+                                     &src_stream)) != 0 ||
+        (ret = _ev_tcp_pipe_endpoint(dst_role, dst, &dst_handle,
+                                     &dst_stream)) != 0)
+    {
+        return ret;
+    }
+    if (src_handle->loop != dst_handle->loop)
+    {
+        return EV_EINVAL;
+    }
+
+    ev_loop_t         *loop = src_handle->loop;
+    ev_tcp_pipe_req_t *req =
+        ev__loop_malloc(loop, EV_ALLOCATOR_TYPE_TCP, sizeof(ev_tcp_pipe_req_t));
+    if (req == NULL)
+    {
+        return EV_ENOMEM;
+    }
+
+    req->loop = loop;
+    req->src_role = src_role;
+    req->src = src;
+    req->dst_role = dst_role;
+    req->dst = dst;
+    req->cb = opts != NULL ? opts->cb : NULL;
+    req->arg = opts != NULL ? opts->arg : NULL;
+
+    ret = ev__nonblock_stream_splice(&req->base, src_stream, dst_stream,
+                                     opts != NULL ? opts->capacity : 0,
+                                     _ev_tcp_on_pipe_done);
+    if (ret != 0)
+    {
+        ev__loop_free(loop, req);
+        return ret;
+    }
+
+    ev__handle_active(src_handle);
+    ev__handle_active(dst_handle);
+    return 0;
+}
+
+int ev_tcp_pipe_to(ev_tcp_t *src, ev_tcp_t *dst,
+                   const ev_tcp_pipe_opts_t *opts)
+{
+    return ev_tcp_pipe_to_ex(EV_ROLE_EV_TCP, src, EV_ROLE_EV_TCP, dst, opts);
+}
+
+int ev_tcp_set_watermark(ev_tcp_t *sock, size_t low, size_t high,
+                         ev_tcp_watermark_cb cb, void *arg)
+{
+    if (low > high)
+    {
+        return EV_EINVAL;
+    }
+
+    sock->backend.watermark.cb = cb;
+    sock->backend.watermark.arg = arg;
+    sock->backend.watermark.low = low;
+    sock->backend.watermark.high = high;
+
+    /* Otherwise applied once the stream is set up */
+    if (sock->base.data.flags & EV_HANDLE_TCP_STREAMING)
+    {
+        _ev_tcp_setup_watermark(sock);
+    }
+    return 0;
+}
+
+ssize_t ev_tcp_write_queue_size(ev_tcp_t *sock)
+{
+    if (!(sock->base.data.flags & EV_HANDLE_TCP_STREAMING))
+    {
+        return 0;
+    }
+    return (ssize_t)sock->backend.u.stream.pending.w_size;
+}
+
+int ev_tcp_set_zerocopy(ev_tcp_t *sock, int enable)
+{
+#if defined(SO_ZEROCOPY) && defined(MSG_ZEROCOPY)
+    if (sock->base.data.flags &
+        (EV_HANDLE_TCP_LISTING | EV_HANDLE_TCP_ACCEPTING |
+         EV_HANDLE_TCP_CONNECTING))
+    {
+        return EV_EINVAL;
+    }
+    if (sock->sock == EV_OS_SOCKET_INVALID)
+    {
+        return EV_EBADF;
+    }
+
+    _ev_tcp_setup_stream_once(sock);
+    ev_nonblock_stream_t *stream = &sock->backend.u.stream;
+
+    if (!enable)
+    {
+        if (stream->zerocopy.seq_sent != stream->zerocopy.seq_done ||
+            ev__nonblock_stream_size(stream, EV_IO_OUT) != 0)
+        {
+            return EV_EBUSY;
+        }
+        ev__nonblock_stream_zerocopy(stream, NULL);
+        return 0;
+    }
+
+    int opt = 1;
+    if (setsockopt(sock->sock, SOL_SOCKET, SO_ZEROCOPY, &opt, sizeof(opt)) != 0)
+    {
+        return ev__translate_sys_error(errno);
+    }
+    ev__nonblock_stream_zerocopy(stream, _on_tcp_zerocopy_done);
+    return 0;
+#else
+    (void)sock;
+    (void)enable;
+    return EV_ENOSYS;
+#endif
+}
+
+int ev_tcp_read(ev_tcp_t *sock, ev_buf_t *bufs, size_t nbuf, ev_tcp_read_cb cb,
+                void *arg)
+{
+    if (sock->base.data.flags &
+        (EV_HANDLE_TCP_LISTING | EV_HANDLE_TCP_ACCEPTING |
+         EV_HANDLE_TCP_CONNECTING))
+    {
+        return EV_EINVAL;
+    }
+
+    ev_tcp_read_req_t *req = ev__loop_malloc(
+        sock->base.loop, EV_ALLOCATOR_TYPE_TCP, sizeof(ev_tcp_read_req_t));
+    if (req == NULL)
+    {
+        return EV_ENOMEM;
+    }
+
+    req->read_cb = cb;
+    req->read_arg = arg;
+    int ret = ev__read_init(&req->base, bufs, nbuf);
+    if (ret != 0)
+    {
+        ev__loop_free(sock->base.loop, req);
+        return ret;
+    }
+
+    _ev_tcp_setup_stream_once(sock);
+
+    ev__handle_active(&sock->base);
+    ret = ev__nonblock_stream_read(&sock->backend.u.stream, &req->base);
+
+    if (ret != 0)
+    {
+        _ev_tcp_smart_deactive(sock);
+        ev__loop_free(sock->base.loop, req);
+        return ret;
+    }
+    return 0;
+}
+
+#if defined(__linux__)
+
+/**
+ * @brief Layout of `struct tcp_info` since Linux 4.9.
+ *
+ * glibc stops at tcpi_total_retrans, while kernel only appends new fields, so
+ * the part we need is defined here. Fields beyond what the running kernel
+ * returns stay zero.
+ */
+typedef struct ev_tcp_info_linux
+{
+    uint8_t  tcpi_state;
+    uint8_t  tcpi_ca_state;
+    uint8_t  tcpi_retransmits;
+    uint8_t  tcpi_probes;
+    uint8_t  tcpi_backoff;
+    uint8_t  tcpi_options;
+    uint8_t  tcpi_wscale;
+    uint8_t  tcpi_flags;
+    uint32_t tcpi_rto;
+    uint32_t tcpi_ato;
+    uint32_t tcpi_snd_mss;
+    uint32_t tcpi_rcv_mss;
+    uint32_t tcpi_unacked;
+    uint32_t tcpi_sacked;
+    uint32_t tcpi_lost;
+    uint32_t tcpi_retrans;
+    uint32_t tcpi_fackets;
+    uint32_t tcpi_last_data_sent;
+    uint32_t tcpi_last_ack_sent;
+    uint32_t tcpi_last_data_recv;
+    uint32_t tcpi_last_ack_recv;
+    uint32_t tcpi_pmtu;
+    uint32_t tcpi_rcv_ssthresh;
+    uint32_t tcpi_rtt;
+    uint32_t tcpi_rttvar;
+    uint32_t tcpi_snd_ssthresh;
+    uint32_t tcpi_snd_cwnd;
+    uint32_t tcpi_advmss;
+    uint32_t tcpi_reordering;
+    uint32_t tcpi_rcv_rtt;
+    uint32_t tcpi_rcv_space;
+    uint32_t tcpi_total_retrans;
+    uint64_t tcpi_pacing_rate;
+    uint64_t tcpi_max_pacing_rate;
+    uint64_t tcpi_bytes_acked;
+    uint64_t tcpi_bytes_received;
+    uint32_t tcpi_segs_out;
+    uint32_t tcpi_segs_in;
+    uint32_t tcpi_notsent_bytes;
+    uint32_t tcpi_min_rtt;
+    uint32_t tcpi_data_segs_in;
+    uint32_t tcpi_data_segs_out;
+    uint64_t tcpi_delivery_rate;
+} ev_tcp_info_linux_t;
+
+int ev_tcp_get_info(ev_tcp_t *sock, ev_tcp_info_t *info)
+{
+    ev_tcp_info_linux_t raw;
+    socklen_t           len = sizeof(raw);
+
+    if (sock->sock == EV_OS_SOCKET_INVALID)
+    {
+        return EV_ENOTCONN;
+    }
+
+    memset(&raw, 0, sizeof(raw));
+    if (getsockopt(sock->sock, IPPROTO_TCP, TCP_INFO, &raw, &len) != 0)
+    {
+        return ev__translate_sys_error(errno);
+    }
+
+    switch (raw.tcpi_state)
+    {
+    case TCP_LISTEN:
+    case TCP_CLOSE:
+    case TCP_SYN_SENT:
+        return EV_ENOTCONN;
+    default:
+        break;
+    }
+
+    info->rtt = raw.tcpi_rtt;
+    info->rtt_var = raw.tcpi_rttvar;
+    info->min_rtt = raw.tcpi_min_rtt;
+    info->snd_mss = raw.tcpi_snd_mss;
+    info->snd_cwnd = raw.tcpi_snd_cwnd;
+    info->unacked = raw.tcpi_unacked;
+    info->lost = raw.tcpi_lost;
+    info->total_retrans = raw.tcpi_total_retrans;
+    info->delivery_rate = raw.tcpi_delivery_rate;
+    info->bytes_acked = raw.tcpi_bytes_acked;
+    info->bytes_received = raw.tcpi_bytes_received;
+
+    return 0;
+}
+
+#else
+
+int ev_tcp_get_info(ev_tcp_t *sock, ev_tcp_info_t *info)
+{
+    (void)sock;
+    (void)info;
+    return EV_ENOSYS;
+}
+
+#endif
+
+int ev_tcp_getsockname(ev_tcp_t *sock, struct sockaddr *name, size_t *len)
+{
+    socklen_t socklen = *len;
+    if (getsockname(sock->sock, name, &socklen) != 0)
+    {
+        return ev__translate_sys_error(errno);
+    }
+
+    *len = (size_t)socklen;
+    return 0;
+}
+
+int ev_tcp_getpeername(ev_tcp_t *sock, struct sockaddr *name, size_t *len)
+{
+    int       ret;
+    socklen_t socklen = *len;
+
+    if ((ret = getpeername(sock->sock, name, &socklen)) != 0)
+    {
+        return ev__translate_sys_error(errno);
+    }
+
+    *len = socklen;
+    return 0;
+}
+
+int ev_tcp_connect(ev_tcp_t *sock, struct sockaddr *addr, size_t size,
+                   ev_tcp_connect_cb cb, void *arg)
+{
+    int        ret;
+    ev_loop_t *loop = sock->base.loop;
+
+    if (sock->base.data.flags & EV_HANDLE_TCP_CONNECTING)
+    {
+        return EV_EINPROGRESS;
+    }
+    if (sock->base.data.flags &
+        (EV_HANDLE_TCP_LISTING | EV_HANDLE_TCP_ACCEPTING |
+         EV_HANDLE_TCP_STREAMING))
+    {
+        return EV_EINVAL;
+    }
+
+    if ((ret = _ev_tcp_setup_fd(sock, addr->sa_family, 0, NULL)) != 0)
+    {
+        return ret;
+    }
+
+    sock->backend.u.client.cb = cb;
+    sock->backend.u.client.arg = arg;
+    sock->base.data.flags |= EV_HANDLE_TCP_CONNECTING;
+
+    if ((ret = connect(sock->sock, addr, size)) == 0)
+    { /* Connect success immediately */
+        sock->backend.u.client.stat = 0;
+        ev__backlog_submit(&sock->base, _ev_tcp_to_connect);
+        return 0;
+    }
+
+    if (errno != EINPROGRESS)
+    {
+        sock->base.data.flags &= ~EV_HANDLE_TCP_CONNECTING;
+        ret = ev__translate_sys_error(errno);
+        goto err;
+    }
+
+    ev__handle_active(&sock->base);
+    ev__nonblock_io_add(loop, &sock->backend.u.client.io, EV_IO_OUT);
+
+    return 0;
+
+err:
+    _ev_tcp_close_fd(sock);
+    ev__handle_deactive(&sock->base);
+    return ret;
+}
+
+EV_LOCAL int ev__tcp_open(ev_tcp_t *tcp, int fd)
+{
+    int busy_flags = EV_HANDLE_TCP_LISTING | EV_HANDLE_TCP_ACCEPTING |
+                     EV_HANDLE_TCP_STREAMING | EV_HANDLE_TCP_CONNECTING |
+                     EV_HABDLE_TCP_BOUND;
+    if (tcp->base.data.flags & busy_flags)
+    {
+        return EV_EBUSY;
+    }
+
+    tcp->sock = fd;
+    _ev_tcp_setup_stream_once(tcp);
+
+    return ev__tcp_opts_apply(tcp, 0);
+}
+
+EV_LOCAL int ev__tcp_opt_native(ev_tcp_opt_t opt, int *level, int *name)
+{
+    switch (opt)
+    {
+    case EV_TCP_OPT_NODELAY:
+        *level = IPPROTO_TCP;
+        *name = TCP_NODELAY;
+        return 0;
+    case EV_TCP_OPT_KEEPALIVE:
+        *level = SOL_SOCKET;
+        *name = SO_KEEPALIVE;
+        return 0;
+    case EV_TCP_OPT_SNDBUF:
+        *level = SOL_SOCKET;
+        *name = SO_SNDBUF;
+        return 0;
+    case EV_TCP_OPT_RCVBUF:
+        *level = SOL_SOCKET;
+        *name = SO_RCVBUF;
+        return 0;
+#if defined(TCP_QUICKACK)
+    case EV_TCP_OPT_QUICKACK:
+        *level = IPPROTO_TCP;
+        *name = TCP_QUICKACK;
+        return 0;
+#endif
+#if defined(TCP_NOTSENT_LOWAT)
+    case EV_TCP_OPT_NOTSENT_LOWAT:
+        *level = IPPROTO_TCP;
+        *name = TCP_NOTSENT_LOWAT;
+        return 0;
+#endif
+#if defined(TCP_DEFER_ACCEPT)
+    case EV_TCP_OPT_DEFER_ACCEPT:
+        *level = IPPROTO_TCP;
+        *name = TCP_DEFER_ACCEPT;
+        return 0;
+#endif
+#if defined(TCP_FASTOPEN)
+    case EV_TCP_OPT_FASTOPEN:
+        *level = IPPROTO_TCP;
+        *name = TCP_FASTOPEN;
+        return 0;
+#endif
+#if defined(SO_BUSY_POLL)
+    case EV_TCP_OPT_BUSY_POLL:
+        *level = SOL_SOCKET;
+        *name = SO_BUSY_POLL;
+        return 0;
+#endif
+    default:
+        return EV_ENOSYS;
+    }
+}
+
+EV_LOCAL int ev__tcp_setsockopt(ev_os_socket_t sock, int level, int name,
+                                int val)
+{
+    if (setsockopt(sock, level, name, &val, sizeof(val)) != 0)
+    {
+        return ev__translate_sys_error(errno);
+    }
+    return 0;
+}
+
+EV_LOCAL int ev__tcp_getsockopt(ev_os_socket_t sock, int level, int name,
+                                int *val)
+{
+    socklen_t len = sizeof(*val);
+    if (getsockopt(sock, level, name, val, &len) != 0)
+    {
+        return ev__translate_sys_error(errno);
+    }
+    return 0;
+}
+
+EV_LOCAL int ev__tcp_probe(ev_os_socket_t sock)
+{
+    char    c;
+    ssize_t ret;
+    do
+    {
+        ret = recv(sock, &c, 1, MSG_PEEK | MSG_DONTWAIT);
+    } while (ret == -1 && errno == EINTR);
+
+    if (ret == 0)
+    {
+        return EV_EOF;
+    }
+    if (ret > 0)
+    {
+        return EV_EPROTO;
+    }
+    if (errno == EAGAIN || errno == EWOULDBLOCK)
+    {
+        return 0;
+    }
+    return ev__translate_sys_error(errno);
+}
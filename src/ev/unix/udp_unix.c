@@ -1,1015 +1,2113 @@
-#include <unistd.h>
-#include <string.h>
-
-static void _ev_udp_close_unix(ev_udp_t *udp)
-{
-    if (udp->sock != EV_OS_SOCKET_INVALID)
-    {
-        ev__nonblock_io_del(udp->base.loop, &udp->backend.io,
-                            EPOLLIN | EPOLLOUT);
-        close(udp->sock);
-        udp->sock = EV_OS_SOCKET_INVALID;
-    }
-}
-
-static void _ev_udp_smart_deactive(ev_udp_t *udp)
-{
-    size_t io_sz = 0;
-
-    io_sz += ev_list_size(&udp->send_list);
-    io_sz += ev_list_size(&udp->recv_list);
-
-    if (io_sz == 0)
-    {
-        ev__handle_deactive(&udp->base);
-    }
-}
-
-static void _ev_udp_w_user_callback_unix(ev_udp_t *udp, ev_udp_write_t *req,
-                                         ssize_t size)
-{
-    _ev_udp_smart_deactive(udp);
-    ev__write_exit(&req->base);
-    ev__handle_exit(&req->handle, NULL);
-
-    req->usr_cb(udp, size, req->usr_cb_arg);
-    ev_free(req);
-}
-
-static void _ev_udp_r_user_callback_unix(ev_udp_t *udp, ev_udp_read_t *req,
-                                         const struct sockaddr *addr,
-                                         ssize_t                size)
-{
-    _ev_udp_smart_deactive(udp);
-    ev__read_exit(&req->base);
-    ev__handle_exit(&req->handle, NULL);
-
-    req->usr_cb(udp, addr, size, req->usr_cb_arg);
-    ev_free(req);
-}
-
-static void _ev_udp_cancel_all_w_unix(ev_udp_t *udp, int err)
-{
-    ev_list_node_t *it;
-    while ((it = ev_list_pop_front(&udp->send_list)) != NULL)
-    {
-        ev_udp_write_t *req = EV_CONTAINER_OF(it, ev_udp_write_t, base.node);
-        _ev_udp_w_user_callback_unix(udp, req, err);
-    }
-}
-
-static void _ev_udp_cancel_all_r_unix(ev_udp_t *udp, int err)
-{
-    ev_list_node_t *it;
-    while ((it = ev_list_pop_front(&udp->recv_list)) != NULL)
-    {
-        ev_udp_read_t *req = EV_CONTAINER_OF(it, ev_udp_read_t, base.node);
-        _ev_udp_r_user_callback_unix(udp, req, NULL, err);
-    }
-}
-
-static void _ev_udp_abort_unix(ev_udp_t *udp, int err)
-{
-    _ev_udp_close_unix(udp);
-    _ev_udp_cancel_all_w_unix(udp, err);
-    _ev_udp_cancel_all_r_unix(udp, err);
-}
-
-static void _ev_udp_on_close_unix(ev_handle_t *handle)
-{
-    ev_udp_t *udp = EV_CONTAINER_OF(handle, ev_udp_t, base);
-    ev_udp_cb close_cb = udp->close_cb;
-    void     *close_arg = udp->close_arg;
-
-    _ev_udp_abort_unix(udp, EV_ECANCELED);
-    ev_free(udp);
-
-    if (close_cb != NULL)
-    {
-        close_cb(udp, close_arg);
-    }
-}
-
-/**
- * @return bool
- */
-static int _ev_udp_is_connected_unix(ev_os_socket_t sock)
-{
-    struct sockaddr_storage addr;
-    socklen_t               addrlen = sizeof(addr);
-
-    if (getpeername(sock, (struct sockaddr *)&addr, &addrlen) != 0)
-    {
-        return 0;
-    }
-    return addrlen > 0;
-}
-
-static int _ev_udp_set_flags_unix(ev_udp_t *udp, unsigned flags)
-{
-    int err;
-    if (flags & EV_UDP_IPV6_ONLY)
-    {
-        int yes = 1;
-        if (setsockopt(udp->sock, IPPROTO_IPV6, IPV6_V6ONLY, &yes,
-                       sizeof(yes)) == -1)
-        {
-            err = errno;
-            return ev__translate_sys_error(err);
-        }
-    }
-
-    if (flags & EV_UDP_REUSEADDR)
-    {
-        if ((err = ev__reuse_unix(udp->sock)) != 0)
-        {
-            return err;
-        }
-    }
-
-    return 0;
-}
-
-static int _ev_udp_disconnect_unix(ev_udp_t *udp)
-{
-    struct sockaddr addr;
-    memset(&addr, 0, sizeof(addr));
-    addr.sa_family = AF_UNSPEC;
-
-    int r;
-    do
-    {
-        r = connect(udp->sock, &addr, sizeof(addr));
-    } while (r == -1 && errno == EINTR);
-
-    if (r == -1 && errno != EAFNOSUPPORT)
-    {
-        r = errno;
-        return ev__translate_sys_error(r);
-    }
-
-    udp->base.data.flags &= ~EV_HANDLE_UDP_CONNECTED;
-    return 0;
-}
-
-static ssize_t _ev_udp_sendmsg_unix(int fd, struct iovec *iov, int iovcnt,
-                                    void *arg)
-{
-    struct msghdr *p_hdr = arg;
-    p_hdr->msg_iov = iov;
-    p_hdr->msg_iovlen = iovcnt;
-
-    ssize_t write_size;
-    do
-    {
-        write_size = sendmsg(fd, p_hdr, 0);
-    } while (write_size < 0 && errno == EINTR);
-
-    if (write_size < 0)
-    {
-        int err = errno;
-        return ev__translate_sys_error(err);
-    }
-
-    return write_size;
-}
-
-static int _ev_udp_do_sendmsg_unix(ev_udp_t *udp, ev_udp_write_t *req)
-{
-    struct msghdr hdr;
-    memset(&hdr, 0, sizeof(hdr));
-
-    if (req->backend.peer_addr.ss_family == AF_UNSPEC)
-    {
-        hdr.msg_name = NULL;
-        hdr.msg_namelen = 0;
-    }
-    else
-    {
-        hdr.msg_name = &req->backend.peer_addr;
-        hdr.msg_namelen =
-            ev__get_addr_len((struct sockaddr *)&req->backend.peer_addr);
-    }
-
-    return ev__send_unix(udp->sock, &req->base, _ev_udp_sendmsg_unix, &hdr);
-}
-
-static int _ev_udp_on_io_write_unix(ev_udp_t *udp)
-{
-    int             ret = 0;
-    ev_list_node_t *it;
-    while ((it = ev_list_begin(&udp->send_list)) != NULL)
-    {
-        ev_udp_write_t *req = EV_CONTAINER_OF(it, ev_udp_write_t, base.node);
-
-        if ((ret = _ev_udp_do_sendmsg_unix(udp, req)) != 0)
-        {
-            break;
-        }
-
-        ev_list_erase(&udp->send_list, it);
-        _ev_udp_w_user_callback_unix(udp, req, req->base.size);
-    }
-
-    if (ret == EV_EAGAIN)
-    {
-        ret = 0;
-    }
-    return ret;
-}
-
-static int _ev_udp_do_recvmsg_unix(ev_udp_t *udp, ev_udp_read_t *req)
-{
-    struct msghdr hdr;
-    memset(&hdr, 0, sizeof(hdr));
-    memset(&req->addr, 0, sizeof(req->addr));
-
-    hdr.msg_name = &req->addr;
-    hdr.msg_namelen = sizeof(req->addr);
-    hdr.msg_iov = (struct iovec *)req->base.data.bufs;
-    hdr.msg_iovlen = req->base.data.nbuf;
-
-    ssize_t read_size;
-    do
-    {
-        read_size = recvmsg(udp->sock, &hdr, 0);
-    } while (read_size < 0 && errno == EINTR);
-
-    if (read_size < 0)
-    {
-        int err = errno;
-        if (err == EAGAIN || err == EWOULDBLOCK)
-        {
-            return EV_EAGAIN;
-        }
-        return ev__translate_sys_error(err);
-    }
-
-    req->base.data.size += read_size;
-    return 0;
-}
-
-static int _ev_udp_on_io_read_unix(ev_udp_t *udp)
-{
-    int             ret = 0;
-    ev_list_node_t *it;
-    while ((it = ev_list_begin(&udp->recv_list)) != NULL)
-    {
-        ev_udp_read_t *req = EV_CONTAINER_OF(it, ev_udp_read_t, base.node);
-
-        if ((ret = _ev_udp_do_recvmsg_unix(udp, req)) != 0)
-        {
-            break;
-        }
-
-        ev_list_erase(&udp->recv_list, it);
-        _ev_udp_r_user_callback_unix(udp, req, (struct sockaddr *)&req->addr,
-                                     req->base.data.size);
-    }
-
-    if (ret == EV_EAGAIN)
-    {
-        ret = 0;
-    }
-    return ret;
-}
-
-static void _ev_udp_on_io_unix(ev_nonblock_io_t *io, unsigned evts, void *arg)
-{
-    (void)arg;
-    int       ret;
-    ev_udp_t *udp = EV_CONTAINER_OF(io, ev_udp_t, backend.io);
-
-    if (evts & EPOLLOUT)
-    {
-        if ((ret = _ev_udp_on_io_write_unix(udp)) != 0)
-        {
-            goto err;
-        }
-
-        if (ev_list_size(&udp->send_list) == 0)
-        {
-            ev__nonblock_io_del(udp->base.loop, &udp->backend.io, EPOLLOUT);
-        }
-    }
-
-    if (evts & EPOLLIN)
-    {
-        if ((ret = _ev_udp_on_io_read_unix(udp)) != 0)
-        {
-            goto err;
-        }
-
-        if (ev_list_size(&udp->recv_list) == 0)
-        {
-            ev__nonblock_io_del(udp->base.loop, &udp->backend.io, EPOLLIN);
-        }
-    }
-
-    return;
-
-err:
-    _ev_udp_abort_unix(udp, ret);
-}
-
-static int _ev_udp_maybe_deferred_socket_unix(ev_udp_t *udp, int domain)
-{
-    if (udp->sock != EV_OS_SOCKET_INVALID)
-    {
-        return 0;
-    }
-
-    if ((udp->sock = socket(domain, SOCK_DGRAM, 0)) < 0)
-    {
-        int ret = errno;
-        return ev__translate_sys_error(ret);
-    }
-
-    ev__nonblock_io_init(&udp->backend.io, udp->sock, _ev_udp_on_io_unix, NULL);
-
-    return 0;
-}
-
-static int _ev_udp_do_connect_unix(ev_udp_t *udp, const struct sockaddr *addr)
-{
-    int       ret;
-    socklen_t addrlen = ev__get_addr_len(addr);
-    if (addrlen == (socklen_t)-1)
-    {
-        return EV_EINVAL;
-    }
-
-    if ((ret = _ev_udp_maybe_deferred_socket_unix(udp, addr->sa_family)) != 0)
-    {
-        return ret;
-    }
-
-    do
-    {
-        ret = connect(udp->sock, addr, addrlen);
-    } while (ret == -1 && errno == EINTR);
-
-    if (ret != 0)
-    {
-        ret = errno;
-        return ev__translate_sys_error(ret);
-    }
-
-    udp->base.data.flags |= EV_HANDLE_UDP_CONNECTED;
-    return 0;
-}
-
-static int _ev_udp_maybe_deferred_bind_unix(ev_udp_t *udp, int domain,
-                                            int flags)
-{
-    int ret = _ev_udp_maybe_deferred_socket_unix(udp, domain);
-    if (ret != 0)
-    {
-        return ret;
-    }
-
-    if (udp->base.data.flags & EV_HANDLE_UDP_BOUND)
-    {
-        return 0;
-    }
-
-    struct sockaddr_storage addr;
-    struct sockaddr_in     *addr4 = (struct sockaddr_in *)&addr;
-    struct sockaddr_in6    *addr6 = (struct sockaddr_in6 *)&addr;
-
-    switch (domain)
-    {
-    case AF_INET: {
-        memset(addr4, 0, sizeof(*addr4));
-        addr4->sin_family = AF_INET;
-        addr4->sin_addr.s_addr = INADDR_ANY;
-        return ev_udp_bind(udp, (struct sockaddr *)addr4, flags);
-    }
-
-    case AF_INET6: {
-        memset(addr6, 0, sizeof(*addr6));
-        addr6->sin6_family = AF_INET6;
-        addr6->sin6_addr = in6addr_any;
-        return ev_udp_bind(udp, (struct sockaddr *)addr6, flags);
-    }
-
-    default:
-        break;
-    }
-
-    EV_ABORT();
-}
-
-static int _ev_udp_convert_interface_addr4_unix(
-    struct ip_mreq *dst, const struct sockaddr_in *multicast_addr,
-    const char *interface_addr)
-{
-    int ret;
-    memset(dst, 0, sizeof(*dst));
-
-    if (interface_addr != NULL)
-    {
-        if ((ret = inet_pton(AF_INET, interface_addr,
-                             &dst->imr_interface.s_addr)) != 1)
-        {
-            int ret = errno;
-            return ev__translate_sys_error(ret);
-        }
-    }
-    else
-    {
-        dst->imr_interface.s_addr = htonl(INADDR_ANY);
-    }
-
-    dst->imr_multiaddr.s_addr = multicast_addr->sin_addr.s_addr;
-
-    return 0;
-}
-
-static int _ev_udp_setmembership4_unix(ev_udp_t           *udp,
-                                       struct sockaddr_in *multicast_addr,
-                                       const char         *interface_addr,
-                                       ev_udp_membership_t membership)
-{
-    int ret;
-
-    struct ip_mreq mreq;
-    if ((ret = _ev_udp_convert_interface_addr4_unix(&mreq, multicast_addr,
-                                                    interface_addr)) != 0)
-    {
-        return ret;
-    }
-
-    int optname = membership == EV_UDP_ENTER_GROUP ? IP_ADD_MEMBERSHIP
-                                                   : IP_DROP_MEMBERSHIP;
-    if (setsockopt(udp->sock, IPPROTO_IP, optname, &mreq, sizeof(mreq)) != 0)
-    {
-        ret = errno;
-        return ev__translate_sys_error(ret);
-    }
-
-    return 0;
-}
-
-static void _ev_udp_convert_interface_addr6_unix(
-    struct ipv6_mreq *dst, struct sockaddr_in6 *multicast_addr,
-    const char *interface_addr)
-{
-    memset(dst, 0, sizeof(*dst));
-
-    if (interface_addr != 0)
-    {
-        struct sockaddr_in6 addr6;
-        ev_ipv6_addr(interface_addr, 0, &addr6);
-
-        dst->ipv6mr_interface = addr6.sin6_scope_id;
-    }
-    else
-    {
-        dst->ipv6mr_interface = 0;
-    }
-    dst->ipv6mr_multiaddr = multicast_addr->sin6_addr;
-}
-
-static int _ev_udp_setmembership6_unix(ev_udp_t            *udp,
-                                       struct sockaddr_in6 *multicast_addr,
-                                       const char          *interface_addr,
-                                       ev_udp_membership_t  membership)
-{
-    int              ret;
-    struct ipv6_mreq mreq;
-    _ev_udp_convert_interface_addr6_unix(&mreq, multicast_addr, interface_addr);
-
-    int optname = membership == EV_UDP_ENTER_GROUP ? IPV6_ADD_MEMBERSHIP
-                                                   : IPV6_DROP_MEMBERSHIP;
-    if (setsockopt(udp->sock, IPPROTO_IPV6, optname, &mreq, sizeof(mreq)) != 0)
-    {
-        ret = errno;
-        return ev__translate_sys_error(ret);
-    }
-
-    return 0;
-}
-
-static int _ev_udp_convert_source_interface_addr4_unix(
-    struct ip_mreq_source *dst, const char *interface_addr,
-    const struct sockaddr_in *multicast_addr,
-    const struct sockaddr_in *source_addr)
-{
-    int ret;
-    memset(dst, 0, sizeof(*dst));
-
-    if (interface_addr != NULL)
-    {
-        if ((ret = inet_pton(AF_INET, interface_addr,
-                             &dst->imr_interface.s_addr)) != 1)
-        {
-            ret = errno;
-            return ev__translate_sys_error(ret);
-        }
-    }
-    else
-    {
-        dst->imr_interface.s_addr = htonl(INADDR_ANY);
-    }
-
-    dst->imr_multiaddr.s_addr = multicast_addr->sin_addr.s_addr;
-    dst->imr_sourceaddr.s_addr = source_addr->sin_addr.s_addr;
-
-    return 0;
-}
-
-static int _ev_udp_set_source_membership4_unix(
-    ev_udp_t *udp, const struct sockaddr_in *multicast_addr,
-    const char *interface_addr, const struct sockaddr_in *source_addr,
-    ev_udp_membership_t membership)
-{
-    int ret = _ev_udp_maybe_deferred_bind_unix(udp, AF_INET, EV_UDP_REUSEADDR);
-    if (ret != 0)
-    {
-        return ret;
-    }
-
-    struct ip_mreq_source mreq;
-    if ((ret = _ev_udp_convert_source_interface_addr4_unix(
-             &mreq, interface_addr, multicast_addr, source_addr)) != 0)
-    {
-        return ret;
-    }
-
-    int optname = membership == EV_UDP_ENTER_GROUP ? IP_ADD_SOURCE_MEMBERSHIP
-                                                   : IP_DROP_SOURCE_MEMBERSHIP;
-    if (setsockopt(udp->sock, IPPROTO_IP, optname, &mreq, sizeof(mreq)) != 0)
-    {
-        ret = errno;
-        return ev__translate_sys_error(ret);
-    }
-
-    return 0;
-}
-
-static int _ev_udp_convert_source_interface_addr6_unix(
-    struct group_source_req *dst, const char *interface_addr,
-    const struct sockaddr_in6 *multicast_addr,
-    const struct sockaddr_in6 *source_addr)
-{
-    int                 ret;
-    struct sockaddr_in6 addr_6;
-
-    memset(dst, 0, sizeof(*dst));
-
-    if (interface_addr != NULL)
-    {
-        if ((ret = ev_ipv6_addr(interface_addr, 0, &addr_6)) != 0)
-        {
-            return ret;
-        }
-        dst->gsr_interface = addr_6.sin6_scope_id;
-    }
-    else
-    {
-        dst->gsr_interface = 0;
-    }
-
-    memcpy(&dst->gsr_group, multicast_addr, sizeof(*multicast_addr));
-    memcpy(&dst->gsr_source, source_addr, sizeof(*source_addr));
-
-    return 0;
-}
-
-static int _ev_udp_set_source_membership6_unix(
-    ev_udp_t *udp, const struct sockaddr_in6 *multicast_addr,
-    const char *interface_addr, const struct sockaddr_in6 *source_addr,
-    ev_udp_membership_t membership)
-{
-    int ret = _ev_udp_maybe_deferred_bind_unix(udp, AF_INET6, EV_UDP_REUSEADDR);
-    if (ret != 0)
-    {
-        return ret;
-    }
-
-    struct group_source_req mreq;
-    if ((ret = _ev_udp_convert_source_interface_addr6_unix(
-             &mreq, interface_addr, multicast_addr, source_addr)) != 0)
-    {
-        return ret;
-    }
-
-    int optname = membership == EV_UDP_ENTER_GROUP ? MCAST_JOIN_SOURCE_GROUP
-                                                   : MCAST_LEAVE_SOURCE_GROUP;
-    if (setsockopt(udp->sock, IPPROTO_IPV6, optname, &mreq, sizeof(mreq)) != 0)
-    {
-        ret = errno;
-        return ev__translate_sys_error(ret);
-    }
-
-    return 0;
-}
-
-static int _ev_udp_set_ttl_unix(ev_udp_t *udp, int ttl, int option4,
-                                int option6)
-{
-    int level;
-    int option;
-    if (udp->base.data.flags & EV_HANDLE_UDP_IPV6)
-    {
-        level = IPPROTO_IPV6;
-        option = option6;
-    }
-    else
-    {
-        level = IPPROTO_IP;
-        option = option4;
-    }
-
-    void     *optval = &ttl;
-    socklen_t optlen = sizeof(ttl);
-
-    /**
-     * On Solaris and derivatives such as SmartOS, the length of socket options
-     * is sizeof(int) for IPV6_MULTICAST_LOOP and sizeof(char) for
-     * IP_MULTICAST_LOOP, so hardcode the size of the option in the IPv6 case,
-     * and use the general uv__setsockopt_maybe_char call otherwise.
-     */
-#if defined(__sun) || defined(_AIX) || defined(__OpenBSD__) ||                 \
-    defined(__MVS__) || defined(__QNX__)
-    char char_val = ttl;
-    if (!(udp->base.data.flags & EV_HANDLE_UDP_IPV6))
-    {
-        optval = &char_val;
-        optlen = sizeof(char_val);
-    }
-#endif
-
-    if (setsockopt(udp->sock, level, option, optval, optlen) != 0)
-    {
-        int ret = errno;
-        return ev__translate_sys_error(ret);
-    }
-
-    return 0;
-}
-
-EV_LOCAL int ev__udp_recv(ev_udp_t *udp, ev_udp_read_t *req)
-{
-    (void)req;
-    if (ev_list_size(&udp->recv_list) == 1)
-    {
-        ev__nonblock_io_add(udp->base.loop, &udp->backend.io, EPOLLIN);
-    }
-
-    ev__handle_active(&udp->base);
-
-    return 0;
-}
-
-EV_LOCAL int ev__udp_send(ev_udp_t *udp, ev_udp_write_t *req,
-                          const struct sockaddr *addr, socklen_t addrlen)
-{
-    int ret;
-
-    if (addr == NULL)
-    {
-        req->backend.peer_addr.ss_family = AF_UNSPEC;
-    }
-    else
-    {
-        if ((ret = _ev_udp_maybe_deferred_bind_unix(udp, addr->sa_family, 0)) !=
-            0)
-        {
-            return ret;
-        }
-
-        if (addrlen == (socklen_t)-1)
-        {
-            return EV_EINVAL;
-        }
-
-        memcpy(&req->backend.peer_addr, addr, addrlen);
-    }
-
-    if (ev_list_size(&udp->send_list) == 1)
-    {
-        ev__nonblock_io_add(udp->base.loop, &udp->backend.io, EPOLLOUT);
-    }
-
-    ev__handle_active(&udp->base);
-
-    return 0;
-}
-
-int ev_udp_init(ev_loop_t *loop, ev_udp_t **udp, int domain)
-{
-    int err;
-    if (domain != AF_INET && domain != AF_INET6 && domain != AF_UNSPEC)
-    {
-        return EV_EINVAL;
-    }
-
-    ev_udp_t *new_udp = ev_malloc(sizeof(ev_udp_t));
-    if (new_udp == NULL)
-    {
-        return EV_ENOMEM;
-    }
-
-    new_udp->sock = EV_OS_SOCKET_INVALID;
-    if (domain != AF_UNSPEC)
-    {
-        if ((err = _ev_udp_maybe_deferred_socket_unix(new_udp, domain)) != 0)
-        {
-            ev_free(new_udp);
-            return err;
-        }
-    }
-
-    ev__handle_init(loop, &new_udp->base, EV_ROLE_EV_UDP);
-    ev_list_init(&new_udp->send_list);
-    ev_list_init(&new_udp->recv_list);
-
-    *udp = new_udp;
-    return 0;
-}
-
-int ev_udp_open(ev_udp_t *udp, ev_os_socket_t sock)
-{
-    int err;
-    if (udp->sock != EV_OS_SOCKET_INVALID)
-    {
-        return EV_EBUSY;
-    }
-
-    if ((err = ev__nonblock(sock, 1)) != 0)
-    {
-        return err;
-    }
-
-    if (_ev_udp_is_connected_unix(sock))
-    {
-        udp->base.data.flags |= EV_HANDLE_UDP_CONNECTED;
-    }
-
-    return 0;
-}
-
-void ev_udp_exit(ev_udp_t *udp, ev_udp_cb close_cb, void *close_arg)
-{
-    _ev_udp_close_unix(udp);
-    udp->close_cb = close_cb;
-    udp->close_arg = close_arg;
-    ev__handle_exit(&udp->base, _ev_udp_on_close_unix);
-}
-
-int ev_udp_bind(ev_udp_t *udp, const struct sockaddr *addr, unsigned flags)
-{
-    int       ret;
-    socklen_t addrlen = ev__get_addr_len(addr);
-    if (addrlen == (socklen_t)-1)
-    {
-        return EV_EINVAL;
-    }
-
-    if ((ret = _ev_udp_maybe_deferred_socket_unix(udp, addr->sa_family)) != 0)
-    {
-        return ret;
-    }
-
-    if ((ret = _ev_udp_set_flags_unix(udp, flags)) != 0)
-    {
-        return ret;
-    }
-
-    if (bind(udp->sock, addr, addrlen) < 0)
-    {
-        ret = errno;
-        if (ret == EAFNOSUPPORT)
-        {
-            return EV_EINVAL;
-        }
-        return ev__translate_sys_error(ret);
-    }
-
-    if (addr->sa_family == AF_INET6)
-    {
-        udp->base.data.flags |= EV_HANDLE_UDP_IPV6;
-    }
-
-    udp->base.data.flags |= EV_HANDLE_UDP_BOUND;
-    return 0;
-}
-
-int ev_udp_connect(ev_udp_t *udp, const struct sockaddr *addr)
-{
-    if (addr == NULL)
-    {
-        if (!(udp->base.data.flags & EV_HANDLE_UDP_CONNECTED))
-        {
-            return EV_ENOTCONN;
-        }
-        return _ev_udp_disconnect_unix(udp);
-    }
-
-    return _ev_udp_do_connect_unix(udp, addr);
-}
-
-int ev_udp_getsockname(ev_udp_t *udp, struct sockaddr *name, size_t *len)
-{
-    socklen_t wrap_len = *len;
-    if (getsockname(udp->sock, name, &wrap_len) != 0)
-    {
-        int err = errno;
-        return ev__translate_sys_error(err);
-    }
-
-    *len = wrap_len;
-    return 0;
-}
-
-int ev_udp_getpeername(ev_udp_t *udp, struct sockaddr *name, size_t *len)
-{
-    socklen_t wrap_len = *len;
-    if (getpeername(udp->sock, name, &wrap_len) != 0)
-    {
-        int err = errno;
-        return ev__translate_sys_error(err);
-    }
-
-    *len = wrap_len;
-    return 0;
-}
-
-int ev_udp_set_membership(ev_udp_t *udp, const char *multicast_addr,
-                          const char         *interface_addr,
-                          ev_udp_membership_t membership)
-{
-    int                     ret;
-    struct sockaddr_storage addr;
-
-    if (membership != EV_UDP_LEAVE_GROUP && membership != EV_UDP_ENTER_GROUP)
-    {
-        return EV_EINVAL;
-    }
-
-    struct sockaddr_in *addr_4 = (struct sockaddr_in *)&addr;
-    memset(addr_4, 0, sizeof(*addr_4));
-
-    if (ev_ipv4_addr(multicast_addr, 0, addr_4) == 0)
-    {
-        if ((ret = _ev_udp_maybe_deferred_bind_unix(udp, AF_INET,
-                                                    EV_UDP_REUSEADDR)) != 0)
-        {
-            return ret;
-        }
-
-        return _ev_udp_setmembership4_unix(udp, addr_4, interface_addr,
-                                           membership);
-    }
-
-    struct sockaddr_in6 *addr_6 = (struct sockaddr_in6 *)&addr;
-    memset(addr_6, 0, sizeof(*addr_6));
-
-    if (ev_ipv6_addr(multicast_addr, 0, addr_6) == 0)
-    {
-        if ((ret = _ev_udp_maybe_deferred_bind_unix(udp, AF_INET6,
-                                                    EV_UDP_REUSEADDR)) != 0)
-        {
-            return ret;
-        }
-
-        return _ev_udp_setmembership6_unix(udp, addr_6, interface_addr,
-                                           membership);
-    }
-
-    return EV_EINVAL;
-}
-
-int ev_udp_set_source_membership(ev_udp_t *udp, const char *multicast_addr,
-                                 const char         *interface_addr,
-                                 const char         *source_addr,
-                                 ev_udp_membership_t membership)
-{
-    int                     ret;
-    struct sockaddr_storage mcast_addr;
-    struct sockaddr_storage src_addr;
-
-    if (membership != EV_UDP_LEAVE_GROUP && membership != EV_UDP_ENTER_GROUP)
-    {
-        return EV_EINVAL;
-    }
-
-    struct sockaddr_in *mcast_addr_4 = (struct sockaddr_in *)&mcast_addr;
-    if ((ret = ev_ipv4_addr(multicast_addr, 0, mcast_addr_4)) == 0)
-    {
-        struct sockaddr_in *src_addr_4 = (struct sockaddr_in *)&src_addr;
-        if ((ret = ev_ipv4_addr(source_addr, 0, src_addr_4)) != 0)
-        {
-            return ret;
-        }
-
-        return _ev_udp_set_source_membership4_unix(
-            udp, mcast_addr_4, interface_addr, src_addr_4, membership);
-    }
-
-    struct sockaddr_in6 *mcast_addr_6 = (struct sockaddr_in6 *)&mcast_addr;
-    if ((ret = ev_ipv6_addr(multicast_addr, 0, mcast_addr_6)) == 0)
-    {
-        struct sockaddr_in6 *src_addr_6 = (struct sockaddr_in6 *)&src_addr;
-        if ((ret = ev_ipv6_addr(source_addr, 0, src_addr_6)) != 0)
-        {
-            return ret;
-        }
-
-        return _ev_udp_set_source_membership6_unix(
-            udp, mcast_addr_6, interface_addr, src_addr_6, membership);
-    }
-
-    return ret;
-}
-
-int ev_udp_set_multicast_loop(ev_udp_t *udp, int on)
-{
-    return _ev_udp_set_ttl_unix(udp, on, IP_MULTICAST_LOOP,
-                                IPV6_MULTICAST_LOOP);
-}
-
-int ev_udp_set_multicast_ttl(ev_udp_t *udp, int ttl)
-{
-    return _ev_udp_set_ttl_unix(udp, ttl, IP_MULTICAST_TTL,
-                                IPV6_MULTICAST_HOPS);
-}
-
-int ev_udp_set_multicast_interface(ev_udp_t *udp, const char *interface_addr)
-{
-    int                     ret;
-    struct sockaddr_storage addr_st;
-    struct sockaddr_in     *addr_4 = (struct sockaddr_in *)&addr_st;
-    struct sockaddr_in6    *addr_6 = (struct sockaddr_in6 *)&addr_st;
-
-    int is_ipv6 = udp->base.data.flags & EV_HANDLE_UDP_IPV6;
-    if ((ret = ev__udp_interface_addr_to_sockaddr(&addr_st, interface_addr,
-                                                  is_ipv6)) != 0)
-    {
-        return ret;
-    }
-
-    int       level;
-    int       optname;
-    void     *optval;
-    socklen_t optlen;
-
-    if (addr_st.ss_family == AF_INET)
-    {
-        level = IPPROTO_IP;
-        optname = IP_MULTICAST_IF;
-        optval = &addr_4->sin_addr;
-        optlen = sizeof(addr_4->sin_addr);
-    }
-    else if (addr_st.ss_family == AF_INET6)
-    {
-        level = IPPROTO_IPV6;
-        optname = IPV6_MULTICAST_IF;
-        optval = &addr_6->sin6_scope_id;
-        optlen = sizeof(addr_6->sin6_scope_id);
-    }
-    else
-    {
-        EV_ABORT();
-    }
-
-    if (setsockopt(udp->sock, level, optname, optval, optlen) != 0)
-    {
-        ret = errno;
-        return ev__translate_sys_error(ret);
-    }
-
-    return 0;
-}
-
-int ev_udp_set_broadcast(ev_udp_t *udp, int on)
-{
-    int err;
-    if (setsockopt(udp->sock, SOL_SOCKET, SO_BROADCAST, &on, sizeof(on)) != 0)
-    {
-        err = errno;
-        return ev__translate_sys_error(err);
-    }
-
-    return 0;
-}
-
-int ev_udp_set_ttl(ev_udp_t *udp, int ttl)
-{
-    if (ttl < 1 || ttl > 255)
-    {
-        return EV_EINVAL;
-    }
-
-#if defined(__MVS__)
-    /* zOS does not support setting ttl for IPv4 */
-    if (!(udp->base.data.flags & EV_HANDLE_UDP_IPV6))
-    {
-        return EV_ENOTSUP;
-    }
-#endif
-
-    return _ev_udp_set_ttl_unix(udp, ttl, IP_TTL, IPV6_UNICAST_HOPS);
-}
+#define _GNU_SOURCE
+#include <sys/socket.h>
+#include <netinet/udp.h>
+#if defined(__linux__)
+#   include <linux/filter.h>
+#endif
+#include <unistd.h>
+#include <string.h>
+#include <limits.h>
+
+/**
+ * @brief Control message buffer for one received datagram.
+ */
+typedef union ev_udp_recv_cmsg
+{
+    char buf[CMSG_SPACE(sizeof(int)) +                 /* UDP_GRO */
+             CMSG_SPACE(sizeof(struct in6_pktinfo)) + /* IP(V6)_PKTINFO */
+             CMSG_SPACE(sizeof(struct timespec)) +    /* SO_TIMESTAMPNS */
+             CMSG_SPACE(sizeof(uint32_t))];           /* SO_RXQ_OVFL */
+    struct cmsghdr align; /**< Alignment */
+} ev_udp_recv_cmsg_t;
+
+/**
+ * @brief Context of #ev_udp_set_recv_info().
+ */
+typedef struct ev_udp_recv_meta
+{
+    unsigned           flags; /**< #ev_udp_recv_info_flags_t */
+    ev_udp_recv_info_t info;  /**< Ancillary data for #ev_udp_recv() */
+    ev_udp_recv_cmsg_t ctrl;  /**< Control message for #ev_udp_recv() */
+} ev_udp_recv_meta_t;
+
+/**
+ * @brief Context of #ev_udp_recv_batch_start().
+ *
+ * Arrays and payload buffers are allocated together after this structure.
+ */
+typedef struct ev_udp_recv_batch
+{
+    ev_udp_recv_batch_cb cb;       /**< Batch read callback */
+    void                *arg;      /**< User defined argument */
+    size_t               capacity; /**< Max datagrams per recvmmsg */
+    size_t               msg_size; /**< Buffer size of each datagram */
+    int                  busy;     /**< In callback */
+    int                  stopped;  /**< Stopped in callback */
+
+    struct sockaddr_storage *addrs; /**< Peer addresses */
+    struct mmsghdr          *hdrs;  /**< Message headers */
+    struct iovec            *iovs;  /**< Payload vectors */
+    ev_udp_datagram_t       *msgs;  /**< Datagrams for user */
+    ev_udp_recv_cmsg_t      *ctrls; /**< Control messages */
+    ev_udp_recv_info_t      *infos; /**< Ancillary data */
+    uint8_t                 *data;  /**< Payload buffers */
+} ev_udp_recv_batch_t;
+
+/**
+ * @brief Buffer slot of #ev_udp_recv_start().
+ */
+typedef struct ev_udp_recv_slot
+{
+    ev_list_node_t          node; /**< #ev_udp_recv_ring_t::free_list */
+    ev_udp_datagram_t       msg;  /**< Datagram for user */
+    struct sockaddr_storage addr; /**< Peer address */
+    ev_udp_recv_cmsg_t      ctrl; /**< Control message */
+    ev_udp_recv_info_t      info; /**< Ancillary data */
+} ev_udp_recv_slot_t;
+
+/**
+ * @brief Context of #ev_udp_recv_start().
+ *
+ * Slots and payload buffers are allocated together after this structure. The
+ * context outlives #ev_udp_recv_stop() until every borrowed buffer is
+ * returned.
+ */
+typedef struct ev_udp_recv_ring
+{
+    ev_udp_recv_ring_cb cb;        /**< Continuous read callback */
+    void               *arg;       /**< User defined argument */
+    size_t              buf_size;  /**< Size of each buffer */
+    size_t              borrowed;  /**< Buffers not in free list */
+    int                 busy;      /**< In callback */
+    int                 stopped;   /**< Stopped by user */
+    ev_list_t           free_list; /**< #ev_udp_recv_slot_t::node */
+} ev_udp_recv_ring_t;
+
+static void _ev_udp_close_unix(ev_udp_t *udp)
+{
+    if (udp->sock != EV_OS_SOCKET_INVALID)
+    {
+        ev__nonblock_io_del(udp->base.loop, &udp->backend.io,
+                            EPOLLIN | EPOLLOUT);
+        close(udp->sock);
+        udp->sock = EV_OS_SOCKET_INVALID;
+    }
+}
+
+static void _ev_udp_smart_deactive(ev_udp_t *udp)
+{
+    size_t io_sz = 0;
+
+    io_sz += ev_list_size(&udp->send_list);
+    io_sz += ev_list_size(&udp->recv_list);
+    io_sz += udp->backend.rbatch != NULL;
+    io_sz += udp->backend.rring != NULL && !udp->backend.rring->stopped;
+
+    if (io_sz == 0)
+    {
+        ev__handle_deactive(&udp->base);
+    }
+}
+
+static void _ev_udp_w_user_callback_unix(ev_udp_t *udp, ev_udp_write_t *req,
+                                         ssize_t size)
+{
+    _ev_udp_smart_deactive(udp);
+    ev__write_exit(&req->base);
+    ev__handle_exit(&req->handle, NULL);
+
+    req->usr_cb(udp, size, req->usr_cb_arg);
+    ev__loop_free(udp->base.loop, req);
+}
+
+static void _ev_udp_r_user_callback_unix(ev_udp_t *udp, ev_udp_read_t *req,
+                                         const struct sockaddr *addr,
+                                         ssize_t                size)
+{
+    _ev_udp_smart_deactive(udp);
+    ev__read_exit(&req->base);
+    ev__handle_exit(&req->handle, NULL);
+
+    req->usr_cb(udp, addr, size, req->usr_cb_arg);
+    ev__loop_free(udp->base.loop, req);
+}
+
+static void _ev_udp_cancel_all_w_unix(ev_udp_t *udp, int err)
+{
+    ev_list_node_t *it;
+    while ((it = ev_list_pop_front(&udp->send_list)) != NULL)
+    {
+        ev_udp_write_t *req = EV_CONTAINER_OF(it, ev_udp_write_t, base.node);
+        _ev_udp_w_user_callback_unix(udp, req, err);
+    }
+}
+
+static void _ev_udp_cancel_all_r_unix(ev_udp_t *udp, int err)
+{
+    ev_list_node_t *it;
+    while ((it = ev_list_pop_front(&udp->recv_list)) != NULL)
+    {
+        ev_udp_read_t *req = EV_CONTAINER_OF(it, ev_udp_read_t, base.node);
+        _ev_udp_r_user_callback_unix(udp, req, NULL, err);
+    }
+}
+
+/**
+ * @brief Detach batch receive context, it is released once it is not in use.
+ */
+static ev_udp_recv_batch_t *_ev_udp_recv_batch_detach_unix(ev_udp_t *udp)
+{
+    ev_udp_recv_batch_t *batch = udp->backend.rbatch;
+    udp->backend.rbatch = NULL;
+
+    if (batch->busy)
+    {
+        batch->stopped = 1;
+        return batch;
+    }
+    ev__loop_free(udp->base.loop, batch);
+    return NULL;
+}
+
+static void _ev_udp_cancel_batch_r_unix(ev_udp_t *udp, int err)
+{
+    ev_udp_recv_batch_t *batch = udp->backend.rbatch;
+    if (batch == NULL)
+    {
+        return;
+    }
+
+    ev_udp_recv_batch_cb cb = batch->cb;
+    void                *arg = batch->arg;
+    _ev_udp_recv_batch_detach_unix(udp);
+    _ev_udp_smart_deactive(udp);
+    cb(udp, NULL, 0, err, arg);
+}
+
+/**
+ * @brief Release ring if it is stopped and no buffer is in use.
+ */
+static void _ev_udp_recv_ring_try_free_unix(ev_udp_t *udp)
+{
+    ev_udp_recv_ring_t *ring = udp->backend.rring;
+    if (ring->stopped && !ring->busy && ring->borrowed == 0)
+    {
+        udp->backend.rring = NULL;
+        ev__loop_free(udp->base.loop, ring);
+    }
+}
+
+/**
+ * @brief Stop ring as #ev_udp_recv_stop() does and report \p err.
+ *
+ * Borrowed buffers stay valid, the ring is released once all of them are
+ * returned or the handle is closed.
+ */
+static void _ev_udp_cancel_ring_r_unix(ev_udp_t *udp, int err)
+{
+    ev_udp_recv_ring_t *ring = udp->backend.rring;
+    if (ring == NULL || ring->stopped)
+    {
+        return;
+    }
+
+    ev_udp_recv_ring_cb cb = ring->cb;
+    void               *arg = ring->arg;
+    ring->stopped = 1;
+    _ev_udp_recv_ring_try_free_unix(udp);
+
+    _ev_udp_smart_deactive(udp);
+    cb(udp, NULL, err, arg);
+}
+
+static void _ev_udp_abort_unix(ev_udp_t *udp, int err)
+{
+    _ev_udp_close_unix(udp);
+    _ev_udp_cancel_all_w_unix(udp, err);
+    _ev_udp_cancel_all_r_unix(udp, err);
+    _ev_udp_cancel_batch_r_unix(udp, err);
+    _ev_udp_cancel_ring_r_unix(udp, err);
+}
+
+static void _ev_udp_on_close_unix(ev_handle_t *handle)
+{
+    ev_udp_t *udp = EV_CONTAINER_OF(handle, ev_udp_t, base);
+    ev_loop_t *loop = udp->base.loop;
+    ev_udp_cb  close_cb = udp->close_cb;
+    void      *close_arg = udp->close_arg;
+
+    _ev_udp_abort_unix(udp, EV_ECANCELED);
+    if (udp->backend.rring != NULL)
+    {
+        /* Borrowed buffers die with the handle */
+        ev__loop_free(loop, udp->backend.rring);
+        udp->backend.rring = NULL;
+    }
+    if (udp->backend.rmeta != NULL)
+    {
+        ev__loop_free(loop, udp->backend.rmeta);
+        udp->backend.rmeta = NULL;
+    }
+    if (!(udp->base.data.flags & EV_HANDLE_INPLACE))
+    {
+        ev__loop_free(loop, udp);
+    }
+
+    if (close_cb != NULL)
+    {
+        close_cb(udp, close_arg);
+    }
+}
+
+/**
+ * @return bool
+ */
+static int _ev_udp_is_connected_unix(ev_os_socket_t sock)
+{
+    struct sockaddr_storage addr;
+    socklen_t               addrlen = sizeof(addr);
+
+    if (getpeername(sock, (struct sockaddr *)&addr, &addrlen) != 0)
+    {
+        return 0;
+    }
+    return addrlen > 0;
+}
+
+static int _ev_udp_set_flags_unix(ev_udp_t *udp, unsigned flags)
+{
+    int err;
+    if (flags & EV_UDP_IPV6_ONLY)
+    {
+        int yes = 1;
+        if (setsockopt(udp->sock, IPPROTO_IPV6, IPV6_V6ONLY, &yes,
+                       sizeof(yes)) == -1)
+        {
+            err = errno;
+            return ev__translate_sys_error(err);
+        }
+    }
+
+    if (flags & EV_UDP_REUSEADDR)
+    {
+        if ((err = ev__reuse_unix(udp->sock)) != 0)
+        {
+            return err;
+        }
+    }
+
+    if (flags & EV_UDP_REUSEPORT)
+    {
+#if defined(SO_REUSEPORT)
+        int yes = 1;
+        if (setsockopt(udp->sock, SOL_SOCKET, SO_REUSEPORT, &yes,
+                       sizeof(yes)) == -1)
+        {
+            err = errno;
+            return ev__translate_sys_error(err);
+        }
+#else
+        return EV_ENOSYS;
+#endif
+    }
+
+    return 0;
+}
+
+static int _ev_udp_disconnect_unix(ev_udp_t *udp)
+{
+    struct sockaddr addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sa_family = AF_UNSPEC;
+
+    int r;
+    do
+    {
+        r = connect(udp->sock, &addr, sizeof(addr));
+    } while (r == -1 && errno == EINTR);
+
+    if (r == -1 && errno != EAFNOSUPPORT)
+    {
+        r = errno;
+        return ev__translate_sys_error(r);
+    }
+
+    udp->base.data.flags &= ~EV_HANDLE_UDP_CONNECTED;
+    return 0;
+}
+
+/**
+ * @brief Max datagrams flushed by one sendmmsg().
+ */
+#define EV_UDP_SENDMMSG_MAX 64
+
+/**
+ * @brief Control message buffer for one datagram.
+ */
+typedef union ev_udp_cmsg
+{
+    char           buf[CMSG_SPACE(sizeof(uint16_t))]; /**< UDP_SEGMENT */
+    struct cmsghdr align;                              /**< Alignment */
+} ev_udp_cmsg_t;
+
+/**
+ * @brief Bytes of segmented request \p req carried by one message.
+ */
+static size_t _ev_udp_segment_step_unix(ev_udp_t *udp, ev_udp_write_t *req)
+{
+#if defined(UDP_SEGMENT)
+    if (g_ev_loop_unix_ctx.udp_gso &&
+        !(udp->base.data.flags & EV_HANDLE_UDP_NO_GSO))
+    {
+        size_t nseg = EV_UDP_GSO_MAX_SIZE / req->seg_size;
+        if (nseg > EV_UDP_GSO_MAX_SEGMENTS)
+        {
+            nseg = EV_UDP_GSO_MAX_SEGMENTS;
+        }
+        return nseg != 0 ? nseg * req->seg_size : req->seg_size;
+    }
+#else
+    (void)udp;
+#endif
+    return req->seg_size;
+}
+
+/**
+ * @brief Fill message headers from the head of send queue.
+ *
+ * A segmented request may take several messages, each carrying as many
+ * segments as one UDP_SEGMENT send allows, or a single segment if GSO is not
+ * available. Already sent bytes are tracked by #ev_write_t::size.
+ *
+ * @return  Number of messages.
+ */
+static size_t _ev_udp_fill_mmsghdr_unix(ev_udp_t *udp, ev_udp_write_t **reqs,
+                                        struct mmsghdr *hdrs,
+                                        struct iovec   *iovs,
+                                        ev_udp_cmsg_t  *ctrls)
+{
+    size_t          nmsg = 0;
+    ev_list_node_t *it = ev_list_begin(&udp->send_list);
+
+    for (; it != NULL && nmsg < EV_UDP_SENDMMSG_MAX; it = ev_list_next(it))
+    {
+        ev_udp_write_t *req = EV_CONTAINER_OF(it, ev_udp_write_t, base.node);
+        size_t          offset = req->base.size;
+        size_t          step =
+            req->seg_size != 0 ? _ev_udp_segment_step_unix(udp, req) : 0;
+
+        do
+        {
+            struct msghdr *hdr = &hdrs[nmsg].msg_hdr;
+            memset(hdr, 0, sizeof(*hdr));
+            hdrs[nmsg].msg_len = 0;
+            reqs[nmsg] = req;
+
+            if (req->backend.peer_addr.ss_family != AF_UNSPEC)
+            {
+                hdr->msg_name = &req->backend.peer_addr;
+                hdr->msg_namelen = ev__get_addr_len(
+                    (struct sockaddr *)&req->backend.peer_addr);
+            }
+
+            if (req->seg_size == 0)
+            {
+                hdr->msg_iov = (struct iovec *)req->base.bufs;
+                hdr->msg_iovlen = req->base.nbuf;
+                nmsg++;
+                break;
+            }
+
+            size_t len = req->base.capacity - offset;
+            len = len < step ? len : step;
+            iovs[nmsg].iov_base = (uint8_t *)req->base.bufs[0].data + offset;
+            iovs[nmsg].iov_len = len;
+            hdr->msg_iov = &iovs[nmsg];
+            hdr->msg_iovlen = 1;
+            offset += len;
+
+#if defined(UDP_SEGMENT)
+            if (step != req->seg_size && len > req->seg_size)
+            {
+                hdr->msg_control = ctrls[nmsg].buf;
+                hdr->msg_controllen = sizeof(ctrls[nmsg].buf);
+
+                struct cmsghdr *cmsg = CMSG_FIRSTHDR(hdr);
+                cmsg->cmsg_level = SOL_UDP;
+                cmsg->cmsg_type = UDP_SEGMENT;
+                cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+                *(uint16_t *)CMSG_DATA(cmsg) = (uint16_t)req->seg_size;
+            }
+#else
+            (void)ctrls;
+#endif
+            nmsg++;
+        } while (offset < req->base.capacity && nmsg < EV_UDP_SENDMMSG_MAX);
+    }
+
+    return nmsg;
+}
+
+static void _ev_udp_finish_write_unix(ev_udp_t *udp, ev_udp_write_t *req,
+                                      ssize_t size)
+{
+    ev_list_erase(&udp->send_list, &req->base.node);
+    _ev_udp_w_user_callback_unix(udp, req, size);
+}
+
+static int _ev_udp_on_io_write_unix(ev_udp_t *udp)
+{
+    int             ret;
+    size_t          i, nmsg;
+    ev_udp_write_t *reqs[EV_UDP_SENDMMSG_MAX];
+    struct mmsghdr  hdrs[EV_UDP_SENDMMSG_MAX];
+    struct iovec    iovs[EV_UDP_SENDMMSG_MAX];
+    ev_udp_cmsg_t   ctrls[EV_UDP_SENDMMSG_MAX];
+
+    while ((nmsg = _ev_udp_fill_mmsghdr_unix(udp, reqs, hdrs, iovs, ctrls)) !=
+           0)
+    {
+        do
+        {
+            ret = sendmmsg(udp->sock, hdrs, nmsg, MSG_DONTWAIT);
+        } while (ret < 0 && errno == EINTR);
+
+        if (ret < 0)
+        {
+            int err = errno;
+            if (err == EAGAIN || err == EWOULDBLOCK)
+            {
+                return 0;
+            }
+
+            /*
+             * ENOBUFS does not clear once the socket is writable again, so
+             * waiting for EPOLLOUT would spin. It is reported below like any
+             * other error, the datagram is dropped as the network would.
+             */
+
+            /* Route without checksum offload rejects GSO, fall back */
+            if (err == EIO && hdrs[0].msg_hdr.msg_control != NULL)
+            {
+                udp->base.data.flags |= EV_HANDLE_UDP_NO_GSO;
+                continue;
+            }
+
+            /* Error belongs to the first datagram, the rest is retried */
+            _ev_udp_finish_write_unix(udp, reqs[0],
+                                      ev__translate_sys_error(err));
+            if (udp->sock == EV_OS_SOCKET_INVALID)
+            {
+                return 0;
+            }
+            continue;
+        }
+
+        for (i = 0; i < (size_t)ret; i++)
+        {
+            ev_udp_write_t *req = reqs[i];
+            req->base.size += hdrs[i].msg_len;
+            if (req->seg_size != 0 && req->base.size < req->base.capacity)
+            {
+                continue;
+            }
+            _ev_udp_finish_write_unix(udp, req, req->base.size);
+
+            /* Remaining requests are cancelled by close */
+            if (udp->sock == EV_OS_SOCKET_INVALID)
+            {
+                return 0;
+            }
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @return  Enabled #ev_udp_recv_info_flags_t.
+ */
+static unsigned _ev_udp_recv_info_flags_unix(ev_udp_t *udp)
+{
+    return udp->backend.rmeta != NULL ? udp->backend.rmeta->flags : 0;
+}
+
+/**
+ * @brief Parse control messages.
+ * @param[in] hdr       Received message.
+ * @param[in] flags     Enabled #ev_udp_recv_info_flags_t.
+ * @param[out] info     Ancillary data. Ignored if \p flags is 0.
+ * @return              GRO segment size, 0 if datagrams are not coalesced.
+ */
+static size_t _ev_udp_parse_cmsg_unix(struct msghdr *hdr, unsigned flags,
+                                      ev_udp_recv_info_t *info)
+{
+    size_t          seg_size = 0;
+    struct cmsghdr *cmsg = CMSG_FIRSTHDR(hdr);
+
+    if (flags != 0)
+    {
+        info->flags = 0;
+    }
+
+    for (; cmsg != NULL; cmsg = CMSG_NXTHDR(hdr, cmsg))
+    {
+#if defined(UDP_GRO)
+        if (cmsg->cmsg_level == SOL_UDP && cmsg->cmsg_type == UDP_GRO)
+        {
+            int val;
+            memcpy(&val, CMSG_DATA(cmsg), sizeof(val));
+            seg_size = val;
+            continue;
+        }
+#endif
+        if (flags == 0)
+        {
+            continue;
+        }
+#if defined(IP_PKTINFO)
+        if (cmsg->cmsg_level == IPPROTO_IP && cmsg->cmsg_type == IP_PKTINFO)
+        {
+            struct in_pktinfo   pi;
+            struct sockaddr_in *addr = (struct sockaddr_in *)&info->dst_addr;
+            memcpy(&pi, CMSG_DATA(cmsg), sizeof(pi));
+            memset(addr, 0, sizeof(*addr));
+            addr->sin_family = AF_INET;
+            addr->sin_addr = pi.ipi_addr;
+            info->ifindex = pi.ipi_ifindex;
+            info->flags |= EV_UDP_RECV_PKTINFO;
+            continue;
+        }
+#endif
+#if defined(IPV6_PKTINFO)
+        if (cmsg->cmsg_level == IPPROTO_IPV6 && cmsg->cmsg_type == IPV6_PKTINFO)
+        {
+            struct in6_pktinfo   pi;
+            struct sockaddr_in6 *addr = (struct sockaddr_in6 *)&info->dst_addr;
+            memcpy(&pi, CMSG_DATA(cmsg), sizeof(pi));
+            memset(addr, 0, sizeof(*addr));
+            addr->sin6_family = AF_INET6;
+            addr->sin6_addr = pi.ipi6_addr;
+            info->ifindex = pi.ipi6_ifindex;
+            info->flags |= EV_UDP_RECV_PKTINFO;
+            continue;
+        }
+#endif
+#if defined(SO_TIMESTAMPNS)
+        if (cmsg->cmsg_level == SOL_SOCKET &&
+            cmsg->cmsg_type == SCM_TIMESTAMPNS)
+        {
+            struct timespec ts;
+            memcpy(&ts, CMSG_DATA(cmsg), sizeof(ts));
+            info->timestamp = (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+            info->flags |= EV_UDP_RECV_TIMESTAMP;
+            continue;
+        }
+#endif
+#if defined(SO_RXQ_OVFL)
+        if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SO_RXQ_OVFL)
+        {
+            memcpy(&info->drops, CMSG_DATA(cmsg), sizeof(info->drops));
+            info->flags |= EV_UDP_RECV_DROPS;
+            continue;
+        }
+#endif
+    }
+
+    /* Kernel omits the counter until the first drop */
+    if ((flags & EV_UDP_RECV_DROPS) && !(info->flags & EV_UDP_RECV_DROPS))
+    {
+        info->drops = 0;
+        info->flags |= EV_UDP_RECV_DROPS;
+    }
+
+    return seg_size;
+}
+
+static int _ev_udp_do_recvmsg_unix(ev_udp_t *udp, ev_udp_read_t *req)
+{
+    struct msghdr hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    memset(&req->addr, 0, sizeof(req->addr));
+
+    hdr.msg_name = &req->addr;
+    hdr.msg_namelen = sizeof(req->addr);
+    hdr.msg_iov = (struct iovec *)req->base.data.bufs;
+    hdr.msg_iovlen = req->base.data.nbuf;
+
+    unsigned flags = _ev_udp_recv_info_flags_unix(udp);
+    if (flags != 0)
+    {
+        hdr.msg_control = udp->backend.rmeta->ctrl.buf;
+        hdr.msg_controllen = sizeof(udp->backend.rmeta->ctrl);
+    }
+
+    ssize_t read_size;
+    do
+    {
+        read_size = recvmsg(udp->sock, &hdr, 0);
+    } while (read_size < 0 && errno == EINTR);
+
+    if (read_size < 0)
+    {
+        int err = errno;
+        if (err == EAGAIN || err == EWOULDBLOCK)
+        {
+            return EV_EAGAIN;
+        }
+        return ev__translate_sys_error(err);
+    }
+
+    if (flags != 0)
+    {
+        _ev_udp_parse_cmsg_unix(&hdr, flags, &udp->backend.rmeta->info);
+    }
+
+    req->base.data.size += read_size;
+    return 0;
+}
+
+static int _ev_udp_on_io_read_unix(ev_udp_t *udp)
+{
+    int             ret = 0;
+    ev_list_node_t *it;
+    while ((it = ev_list_begin(&udp->recv_list)) != NULL)
+    {
+        ev_udp_read_t *req = EV_CONTAINER_OF(it, ev_udp_read_t, base.node);
+
+        if ((ret = _ev_udp_do_recvmsg_unix(udp, req)) != 0)
+        {
+            break;
+        }
+
+        ev_list_erase(&udp->recv_list, it);
+        _ev_udp_r_user_callback_unix(udp, req, (struct sockaddr *)&req->addr,
+                                     req->base.data.size);
+    }
+
+    if (ret == EV_EAGAIN)
+    {
+        ret = 0;
+    }
+    return ret;
+}
+
+static int _ev_udp_on_io_read_batch_unix(ev_udp_t *udp)
+{
+    int                  ret;
+    size_t               i;
+    ev_udp_recv_batch_t *batch = udp->backend.rbatch;
+
+    for (;;)
+    {
+        for (i = 0; i < batch->capacity; i++)
+        {
+            batch->hdrs[i].msg_hdr.msg_namelen = sizeof(batch->addrs[i]);
+            batch->hdrs[i].msg_hdr.msg_controllen = sizeof(batch->ctrls[i]);
+            batch->hdrs[i].msg_hdr.msg_flags = 0;
+            batch->hdrs[i].msg_len = 0;
+        }
+
+        do
+        {
+            ret = recvmmsg(udp->sock, batch->hdrs, batch->capacity,
+                           MSG_DONTWAIT, NULL);
+        } while (ret < 0 && errno == EINTR);
+
+        if (ret < 0)
+        {
+            int err = errno;
+            if (err == EAGAIN || err == EWOULDBLOCK)
+            {
+                return 0;
+            }
+            return ev__translate_sys_error(err);
+        }
+
+        unsigned flags = _ev_udp_recv_info_flags_unix(udp);
+        for (i = 0; i < (size_t)ret; i++)
+        {
+            batch->msgs[i].size = batch->hdrs[i].msg_len;
+            batch->msgs[i].seg_size = _ev_udp_parse_cmsg_unix(
+                &batch->hdrs[i].msg_hdr, flags, &batch->infos[i]);
+            batch->msgs[i].info = flags != 0 ? &batch->infos[i] : NULL;
+        }
+
+        batch->busy = 1;
+        batch->cb(udp, batch->msgs, ret, 0, batch->arg);
+        batch->busy = 0;
+
+        if (batch->stopped)
+        {
+            ev__loop_free(udp->base.loop, batch);
+            return 0;
+        }
+
+        /* Socket queue is drained, or handle is closed in callback */
+        if ((size_t)ret < batch->capacity || udp->sock == EV_OS_SOCKET_INVALID)
+        {
+            return 0;
+        }
+    }
+}
+
+/**
+ * @brief Max datagrams read by one recvmmsg() in continuous receive.
+ */
+#define EV_UDP_RECVMMSG_MAX 64
+
+static int _ev_udp_on_io_read_ring_unix(ev_udp_t *udp)
+{
+    int                 ret;
+    size_t              i, nmsg;
+    ev_list_node_t     *it;
+    ev_udp_recv_ring_t *ring = udp->backend.rring;
+    ev_udp_recv_slot_t *slots[EV_UDP_RECVMMSG_MAX];
+    struct mmsghdr      hdrs[EV_UDP_RECVMMSG_MAX];
+    struct iovec        iovs[EV_UDP_RECVMMSG_MAX];
+
+    while (!ring->stopped && ev_list_size(&ring->free_list) != 0)
+    {
+        it = ev_list_begin(&ring->free_list);
+        for (nmsg = 0; it != NULL && nmsg < EV_UDP_RECVMMSG_MAX; nmsg++)
+        {
+            ev_udp_recv_slot_t *slot =
+                EV_CONTAINER_OF(it, ev_udp_recv_slot_t, node);
+            it = ev_list_next(it);
+
+            slots[nmsg] = slot;
+            iovs[nmsg].iov_base = slot->msg.data;
+            iovs[nmsg].iov_len = ring->buf_size;
+            memset(&hdrs[nmsg], 0, sizeof(hdrs[nmsg]));
+            hdrs[nmsg].msg_hdr.msg_name = &slot->addr;
+            hdrs[nmsg].msg_hdr.msg_namelen = sizeof(slot->addr);
+            hdrs[nmsg].msg_hdr.msg_iov = &iovs[nmsg];
+            hdrs[nmsg].msg_hdr.msg_iovlen = 1;
+            hdrs[nmsg].msg_hdr.msg_control = slot->ctrl.buf;
+            hdrs[nmsg].msg_hdr.msg_controllen = sizeof(slot->ctrl);
+        }
+
+        do
+        {
+            ret = recvmmsg(udp->sock, hdrs, nmsg, MSG_DONTWAIT, NULL);
+        } while (ret < 0 && errno == EINTR);
+
+        if (ret < 0)
+        {
+            int err = errno;
+            if (err == EAGAIN || err == EWOULDBLOCK)
+            {
+                return 0;
+            }
+            return ev__translate_sys_error(err);
+        }
+
+        /* Lend all received buffers before calling back */
+        for (i = 0; i < (size_t)ret; i++)
+        {
+            ev_list_erase(&ring->free_list, &slots[i]->node);
+            ring->borrowed++;
+        }
+
+        ring->busy = 1;
+        for (i = 0; i < (size_t)ret; i++)
+        {
+            ev_udp_recv_slot_t *slot = slots[i];
+            if (ring->stopped || udp->sock == EV_OS_SOCKET_INVALID)
+            {
+                /* Undelivered datagrams are dropped */
+                ev_list_push_back(&ring->free_list, &slot->node);
+                ring->borrowed--;
+                continue;
+            }
+
+            unsigned flags = _ev_udp_recv_info_flags_unix(udp);
+            slot->msg.size = hdrs[i].msg_len;
+            slot->msg.seg_size =
+                _ev_udp_parse_cmsg_unix(&hdrs[i].msg_hdr, flags, &slot->info);
+            slot->msg.info = flags != 0 ? &slot->info : NULL;
+            ring->cb(udp, &slot->msg, 0, ring->arg);
+        }
+        ring->busy = 0;
+
+        if (ring->stopped)
+        {
+            _ev_udp_recv_ring_try_free_unix(udp);
+            return 0;
+        }
+        if (udp->sock == EV_OS_SOCKET_INVALID || (size_t)ret < nmsg)
+        {
+            return 0;
+        }
+    }
+
+    /* All buffers are borrowed, wait for return */
+    if (!ring->stopped)
+    {
+        ev__nonblock_io_del(udp->base.loop, &udp->backend.io, EPOLLIN);
+    }
+    return 0;
+}
+
+static void _ev_udp_on_io_unix(ev_nonblock_io_t *io, unsigned evts, void *arg)
+{
+    (void)arg;
+    int       ret;
+    ev_udp_t *udp = EV_CONTAINER_OF(io, ev_udp_t, backend.io);
+
+    if (evts & EPOLLOUT)
+    {
+        if ((ret = _ev_udp_on_io_write_unix(udp)) != 0)
+        {
+            goto err;
+        }
+
+        /* Closed in callback */
+        if (udp->sock == EV_OS_SOCKET_INVALID)
+        {
+            return;
+        }
+
+        if (ev_list_size(&udp->send_list) == 0)
+        {
+            ev__nonblock_io_del(udp->base.loop, &udp->backend.io, EPOLLOUT);
+        }
+    }
+
+    if ((evts & EPOLLIN) && udp->backend.rbatch != NULL)
+    {
+        if ((ret = _ev_udp_on_io_read_batch_unix(udp)) != 0)
+        {
+            goto err;
+        }
+    }
+    else if ((evts & EPOLLIN) && udp->backend.rring != NULL &&
+             !udp->backend.rring->stopped)
+    {
+        if ((ret = _ev_udp_on_io_read_ring_unix(udp)) != 0)
+        {
+            goto err;
+        }
+    }
+    else if (evts & EPOLLIN)
+    {
+        if ((ret = _ev_udp_on_io_read_unix(udp)) != 0)
+        {
+            goto err;
+        }
+
+        if (ev_list_size(&udp->recv_list) == 0 && udp->backend.rbatch == NULL)
+        {
+            ev__nonblock_io_del(udp->base.loop, &udp->backend.io, EPOLLIN);
+        }
+    }
+
+    return;
+
+err:
+    _ev_udp_abort_unix(udp, ret);
+}
+
+static int _ev_udp_maybe_deferred_socket_unix(ev_udp_t *udp, int domain)
+{
+    if (udp->sock != EV_OS_SOCKET_INVALID)
+    {
+        return 0;
+    }
+
+    if ((udp->sock = socket(domain, SOCK_DGRAM, 0)) < 0)
+    {
+        int ret = errno;
+        return ev__translate_sys_error(ret);
+    }
+
+    ev__nonblock_io_init(&udp->backend.io, udp->sock, _ev_udp_on_io_unix, NULL);
+
+    return 0;
+}
+
+static int _ev_udp_do_connect_unix(ev_udp_t *udp, const struct sockaddr *addr)
+{
+    int       ret;
+    socklen_t addrlen = ev__get_addr_len(addr);
+    if (addrlen == (socklen_t)-1)
+    {
+        return EV_EINVAL;
+    }
+
+    if ((ret = _ev_udp_maybe_deferred_socket_unix(udp, addr->sa_family)) != 0)
+    {
+        return ret;
+    }
+
+    do
+    {
+        ret = connect(udp->sock, addr, addrlen);
+    } while (ret == -1 && errno == EINTR);
+
+    if (ret != 0)
+    {
+        ret = errno;
+        return ev__translate_sys_error(ret);
+    }
+
+    udp->base.data.flags |= EV_HANDLE_UDP_CONNECTED;
+    return 0;
+}
+
+static int _ev_udp_maybe_deferred_bind_unix(ev_udp_t *udp, int domain,
+                                            int flags)
+{
+    int ret = _ev_udp_maybe_deferred_socket_unix(udp, domain);
+    if (ret != 0)
+    {
+        return ret;
+    }
+
+    if (udp->base.data.flags & EV_HANDLE_UDP_BOUND)
+    {
+        return 0;
+    }
+
+    struct sockaddr_storage addr;
+    struct sockaddr_in     *addr4 = (struct sockaddr_in *)&addr;
+    struct sockaddr_in6    *addr6 = (struct sockaddr_in6 *)&addr;
+
+    switch (domain)
+    {
+    case AF_INET: {
+        memset(addr4, 0, sizeof(*addr4));
+        addr4->sin_family = AF_INET;
+        addr4->sin_addr.s_addr = INADDR_ANY;
+        return ev_udp_bind(udp, (struct sockaddr *)addr4, flags);
+    }
+
+    case AF_INET6: {
+        memset(addr6, 0, sizeof(*addr6));
+        addr6->sin6_family = AF_INET6;
+        addr6->sin6_addr = in6addr_any;
+        return ev_udp_bind(udp, (struct sockaddr *)addr6, flags);
+    }
+
+    default:
+        break;
+    }
+
+    EV_ABORT();
+}
+
+static int _ev_udp_convert_interface_addr4_unix(
+    struct ip_mreq *dst, const struct sockaddr_in *multicast_addr,
+    const char *interface_addr)
+{
+    int ret;
+    memset(dst, 0, sizeof(*dst));
+
+    if (interface_addr != NULL)
+    {
+        if ((ret = inet_pton(AF_INET, interface_addr,
+                             &dst->imr_interface.s_addr)) != 1)
+        {
+            int ret = errno;
+            return ev__translate_sys_error(ret);
+        }
+    }
+    else
+    {
+        dst->imr_interface.s_addr = htonl(INADDR_ANY);
+    }
+
+    dst->imr_multiaddr.s_addr = multicast_addr->sin_addr.s_addr;
+
+    return 0;
+}
+
+static int _ev_udp_setmembership4_unix(ev_udp_t           *udp,
+                                       struct sockaddr_in *multicast_addr,
+                                       const char         *interface_addr,
+                                       ev_udp_membership_t membership)
+{
+    int ret;
+
+    struct ip_mreq mreq;
+    if ((ret = _ev_udp_convert_interface_addr4_unix(&mreq, multicast_addr,
+                                                    interface_addr)) != 0)
+    {
+        return ret;
+    }
+
+    int optname = membership == EV_UDP_ENTER_GROUP ? IP_ADD_MEMBERSHIP
+                                                   : IP_DROP_MEMBERSHIP;
+    if (setsockopt(udp->sock, IPPROTO_IP, optname, &mreq, sizeof(mreq)) != 0)
+    {
+        ret = errno;
+        return ev__translate_sys_error(ret);
+    }
+
+    return 0;
+}
+
+static void _ev_udp_convert_interface_addr6_unix(
+    struct ipv6_mreq *dst, struct sockaddr_in6 *multicast_addr,
+    const char *interface_addr)
+{
+    memset(dst, 0, sizeof(*dst));
+
+    if (interface_addr != 0)
+    {
+        struct sockaddr_in6 addr6;
+        ev_ipv6_addr(interface_addr, 0, &addr6);
+
+        dst->ipv6mr_interface = addr6.sin6_scope_id;
+    }
+    else
+    {
+        dst->ipv6mr_interface = 0;
+    }
+    dst->ipv6mr_multiaddr = multicast_addr->sin6_addr;
+}
+
+static int _ev_udp_setmembership6_unix(ev_udp_t            *udp,
+                                       struct sockaddr_in6 *multicast_addr,
+                                       const char          *interface_addr,
+                                       ev_udp_membership_t  membership)
+{
+    int              ret;
+    struct ipv6_mreq mreq;
+    _ev_udp_convert_interface_addr6_unix(&mreq, multicast_addr, interface_addr);
+
+    int optname = membership == EV_UDP_ENTER_GROUP ? IPV6_ADD_MEMBERSHIP
+                                                   : IPV6_DROP_MEMBERSHIP;
+    if (setsockopt(udp->sock, IPPROTO_IPV6, optname, &mreq, sizeof(mreq)) != 0)
+    {
+        ret = errno;
+        return ev__translate_sys_error(ret);
+    }
+
+    return 0;
+}
+
+static int _ev_udp_convert_source_interface_addr4_unix(
+    struct ip_mreq_source *dst, const char *interface_addr,
+    const struct sockaddr_in *multicast_addr,
+    const struct sockaddr_in *source_addr)
+{
+    int ret;
+    memset(dst, 0, sizeof(*dst));
+
+    if (interface_addr != NULL)
+    {
+        if ((ret = inet_pton(AF_INET, interface_addr,
+                             &dst->imr_interface.s_addr)) != 1)
+        {
+            ret = errno;
+            return ev__translate_sys_error(ret);
+        }
+    }
+    else
+    {
+        dst->imr_interface.s_addr = htonl(INADDR_ANY);
+    }
+
+    dst->imr_multiaddr.s_addr = multicast_addr->sin_addr.s_addr;
+    dst->imr_sourceaddr.s_addr = source_addr->sin_addr.s_addr;
+
+    return 0;
+}
+
+static int _ev_udp_set_source_membership4_unix(
+    ev_udp_t *udp, const struct sockaddr_in *multicast_addr,
+    const char *interface_addr, const struct sockaddr_in *source_addr,
+    ev_udp_membership_t membership)
+{
+    int ret = _ev_udp_maybe_deferred_bind_unix(udp, AF_INET, EV_UDP_REUSEADDR);
+    if (ret != 0)
+    {
+        return ret;
+    }
+
+    struct ip_mreq_source mreq;
+    if ((ret = _ev_udp_convert_source_interface_addr4_unix(
+             &mreq, interface_addr, multicast_addr, source_addr)) != 0)
+    {
+        return ret;
+    }
+
+    int optname = membership == EV_UDP_ENTER_GROUP ? IP_ADD_SOURCE_MEMBERSHIP
+                                                   : IP_DROP_SOURCE_MEMBERSHIP;
+    if (setsockopt(udp->sock, IPPROTO_IP, optname, &mreq, sizeof(mreq)) != 0)
+    {
+        ret = errno;
+        return ev__translate_sys_error(ret);
+    }
+
+    return 0;
+}
+
+static int _ev_udp_convert_source_interface_addr6_unix(
+    struct group_source_req *dst, const char *interface_addr,
+    const struct sockaddr_in6 *multicast_addr,
+    const struct sockaddr_in6 *source_addr)
+{
+    int                 ret;
+    struct sockaddr_in6 addr_6;
+
+    memset(dst, 0, sizeof(*dst));
+
+    if (interface_addr != NULL)
+    {
+        if ((ret = ev_ipv6_addr(interface_addr, 0, &addr_6)) != 0)
+        {
+            return ret;
+        }
+        dst->gsr_interface = addr_6.sin6_scope_id;
+    }
+    else
+    {
+        dst->gsr_interface = 0;
+    }
+
+    memcpy(&dst->gsr_group, multicast_addr, sizeof(*multicast_addr));
+    memcpy(&dst->gsr_source, source_addr, sizeof(*source_addr));
+
+    return 0;
+}
+
+static int _ev_udp_set_source_membership6_unix(
+    ev_udp_t *udp, const struct sockaddr_in6 *multicast_addr,
+    const char *interface_addr, const struct sockaddr_in6 *source_addr,
+    ev_udp_membership_t membership)
+{
+    int ret = _ev_udp_maybe_deferred_bind_unix(udp, AF_INET6, EV_UDP_REUSEADDR);
+    if (ret != 0)
+    {
+        return ret;
+    }
+
+    struct group_source_req mreq;
+    if ((ret = _ev_udp_convert_source_interface_addr6_unix(
+             &mreq, interface_addr, multicast_addr, source_addr)) != 0)
+    {
+        return ret;
+    }
+
+    int optname = membership == EV_UDP_ENTER_GROUP ? MCAST_JOIN_SOURCE_GROUP
+                                                   : MCAST_LEAVE_SOURCE_GROUP;
+    if (setsockopt(udp->sock, IPPROTO_IPV6, optname, &mreq, sizeof(mreq)) != 0)
+    {
+        ret = errno;
+        return ev__translate_sys_error(ret);
+    }
+
+    return 0;
+}
+
+static int _ev_udp_set_ttl_unix(ev_udp_t *udp, int ttl, int option4,
+                                int option6)
+{
+    int level;
+    int option;
+    if (udp->base.data.flags & EV_HANDLE_UDP_IPV6)
+    {
+        level = IPPROTO_IPV6;
+        option = option6;
+    }
+    else
+    {
+        level = IPPROTO_IP;
+        option = option4;
+    }
+
+    void     *optval = &ttl;
+    socklen_t optlen = sizeof(ttl);
+
+    /**
+     * On Solaris and derivatives such as SmartOS, the length of socket options
+     * is sizeof(int) for IPV6_MULTICAST_LOOP and sizeof(char) for
+     * IP_MULTICAST_LOOP, so hardcode the size of the option in the IPv6 case,
+     * and use the general uv__setsockopt_maybe_char call otherwise.
+     */
+#if defined(__sun) || defined(_AIX) || defined(__OpenBSD__) ||                 \
+    defined(__MVS__) || defined(__QNX__)
+    char char_val = ttl;
+    if (!(udp->base.data.flags & EV_HANDLE_UDP_IPV6))
+    {
+        optval = &char_val;
+        optlen = sizeof(char_val);
+    }
+#endif
+
+    if (setsockopt(udp->sock, level, option, optval, optlen) != 0)
+    {
+        int ret = errno;
+        return ev__translate_sys_error(ret);
+    }
+
+    return 0;
+}
+
+EV_LOCAL int ev__udp_recv(ev_udp_t *udp, ev_udp_read_t *req)
+{
+    (void)req;
+    if (udp->backend.rbatch != NULL || udp->backend.rring != NULL)
+    {
+        return EV_EBUSY;
+    }
+
+    if (ev_list_size(&udp->recv_list) == 1)
+    {
+        ev__nonblock_io_add(udp->base.loop, &udp->backend.io, EPOLLIN);
+    }
+
+    ev__handle_active(&udp->base);
+
+    return 0;
+}
+
+EV_LOCAL int ev__udp_send(ev_udp_t *udp, ev_udp_write_t *req,
+                          const struct sockaddr *addr, socklen_t addrlen)
+{
+    int ret;
+
+    if (addr == NULL)
+    {
+        req->backend.peer_addr.ss_family = AF_UNSPEC;
+    }
+    else
+    {
+        if ((ret = _ev_udp_maybe_deferred_bind_unix(udp, addr->sa_family, 0)) !=
+            0)
+        {
+            return ret;
+        }
+
+        if (addrlen == (socklen_t)-1)
+        {
+            return EV_EINVAL;
+        }
+
+        memcpy(&req->backend.peer_addr, addr, addrlen);
+    }
+
+    if (ev_list_size(&udp->send_list) == 1)
+    {
+        ev__nonblock_io_add(udp->base.loop, &udp->backend.io, EPOLLOUT);
+    }
+
+    ev__handle_active(&udp->base);
+
+    return 0;
+}
+
+static int _ev_udp_init_unix(ev_loop_t *loop, ev_udp_t *udp, int domain)
+{
+    int err;
+
+    udp->sock = EV_OS_SOCKET_INVALID;
+    if (domain != AF_UNSPEC)
+    {
+        if ((err = _ev_udp_maybe_deferred_socket_unix(udp, domain)) != 0)
+        {
+            return err;
+        }
+    }
+
+    ev__handle_init(loop, &udp->base, EV_ROLE_EV_UDP);
+    ev_list_init(&udp->send_list);
+    ev_list_init(&udp->recv_list);
+    udp->backend.rbatch = NULL;
+    udp->backend.rring = NULL;
+    udp->backend.rmeta = NULL;
+
+    return 0;
+}
+
+size_t ev_udp_size(void)
+{
+    return sizeof(ev_udp_t);
+}
+
+int ev_udp_init(ev_loop_t *loop, ev_udp_t **udp, int domain)
+{
+    int err;
+    if (domain != AF_INET && domain != AF_INET6 && domain != AF_UNSPEC)
+    {
+        return EV_EINVAL;
+    }
+
+    ev_udp_t *new_udp =
+        ev__loop_malloc(loop, EV_ALLOCATOR_TYPE_UDP, sizeof(ev_udp_t));
+    if (new_udp == NULL)
+    {
+        return EV_ENOMEM;
+    }
+
+    if ((err = _ev_udp_init_unix(loop, new_udp, domain)) != 0)
+    {
+        ev__loop_free(loop, new_udp);
+        return err;
+    }
+
+    *udp = new_udp;
+    return 0;
+}
+
+int ev_udp_init_inplace(ev_loop_t *loop, ev_udp_t **udp, int domain, void *mem)
+{
+    int       err;
+    ev_udp_t *new_udp = mem;
+    if (domain != AF_INET && domain != AF_INET6 && domain != AF_UNSPEC)
+    {
+        return EV_EINVAL;
+    }
+
+    if ((err = _ev_udp_init_unix(loop, new_udp, domain)) != 0)
+    {
+        return err;
+    }
+    new_udp->base.data.flags |= EV_HANDLE_INPLACE;
+
+    *udp = new_udp;
+    return 0;
+}
+
+int ev_udp_open(ev_udp_t *udp, ev_os_socket_t sock)
+{
+    int err;
+    if (udp->sock != EV_OS_SOCKET_INVALID)
+    {
+        return EV_EBUSY;
+    }
+
+    if ((err = ev__nonblock(sock, 1)) != 0)
+    {
+        return err;
+    }
+
+    if (_ev_udp_is_connected_unix(sock))
+    {
+        udp->base.data.flags |= EV_HANDLE_UDP_CONNECTED;
+    }
+
+    return 0;
+}
+
+void ev_udp_exit(ev_udp_t *udp, ev_udp_cb close_cb, void *close_arg)
+{
+    _ev_udp_close_unix(udp);
+    udp->close_cb = close_cb;
+    udp->close_arg = close_arg;
+    ev__handle_exit(&udp->base, _ev_udp_on_close_unix);
+}
+
+int ev_udp_bind(ev_udp_t *udp, const struct sockaddr *addr, unsigned flags)
+{
+    int       ret;
+    socklen_t addrlen = ev__get_addr_len(addr);
+    if (addrlen == (socklen_t)-1)
+    {
+        return EV_EINVAL;
+    }
+
+    if ((ret = _ev_udp_maybe_deferred_socket_unix(udp, addr->sa_family)) != 0)
+    {
+        return ret;
+    }
+
+    if ((ret = _ev_udp_set_flags_unix(udp, flags)) != 0)
+    {
+        return ret;
+    }
+
+    if (bind(udp->sock, addr, addrlen) < 0)
+    {
+        ret = errno;
+        if (ret == EAFNOSUPPORT)
+        {
+            return EV_EINVAL;
+        }
+        return ev__translate_sys_error(ret);
+    }
+
+    if (addr->sa_family == AF_INET6)
+    {
+        udp->base.data.flags |= EV_HANDLE_UDP_IPV6;
+    }
+
+    udp->base.data.flags |= EV_HANDLE_UDP_BOUND;
+    return 0;
+}
+
+int ev_udp_connect(ev_udp_t *udp, const struct sockaddr *addr)
+{
+    if (addr == NULL)
+    {
+        if (!(udp->base.data.flags & EV_HANDLE_UDP_CONNECTED))
+        {
+            return EV_ENOTCONN;
+        }
+        return _ev_udp_disconnect_unix(udp);
+    }
+
+    return _ev_udp_do_connect_unix(udp, addr);
+}
+
+int ev_udp_getsockname(ev_udp_t *udp, struct sockaddr *name, size_t *len)
+{
+    socklen_t wrap_len = *len;
+    if (getsockname(udp->sock, name, &wrap_len) != 0)
+    {
+        int err = errno;
+        return ev__translate_sys_error(err);
+    }
+
+    *len = wrap_len;
+    return 0;
+}
+
+int ev_udp_getpeername(ev_udp_t *udp, struct sockaddr *name, size_t *len)
+{
+    socklen_t wrap_len = *len;
+    if (getpeername(udp->sock, name, &wrap_len) != 0)
+    {
+        int err = errno;
+        return ev__translate_sys_error(err);
+    }
+
+    *len = wrap_len;
+    return 0;
+}
+
+int ev_udp_recv_batch_start(ev_udp_t *udp, size_t batch, size_t msg_size,
+                            ev_udp_recv_batch_cb cb, void *arg)
+{
+    size_t i;
+    if (udp->sock == EV_OS_SOCKET_INVALID)
+    {
+        return EV_EPIPE;
+    }
+    if (batch == 0 || batch > UIO_MAXIOV || msg_size == 0)
+    {
+        return EV_EINVAL;
+    }
+    if (udp->backend.rbatch != NULL || udp->backend.rring != NULL ||
+        ev_list_size(&udp->recv_list) != 0)
+    {
+        return EV_EBUSY;
+    }
+
+    size_t unit_sz = sizeof(struct sockaddr_storage) + sizeof(struct mmsghdr) +
+                     sizeof(struct iovec) + sizeof(ev_udp_datagram_t) +
+                     sizeof(ev_udp_recv_cmsg_t) + sizeof(ev_udp_recv_info_t);
+    if (msg_size > (SIZE_MAX - sizeof(ev_udp_recv_batch_t)) / batch - unit_sz)
+    {
+        return EV_ENOMEM;
+    }
+
+    ev_udp_recv_batch_t *ctx =
+        ev__loop_malloc(udp->base.loop, EV_ALLOCATOR_TYPE_UDP,
+                        sizeof(ev_udp_recv_batch_t) +
+                            batch * (unit_sz + msg_size));
+    if (ctx == NULL)
+    {
+        return EV_ENOMEM;
+    }
+
+    ctx->cb = cb;
+    ctx->arg = arg;
+    ctx->capacity = batch;
+    ctx->msg_size = msg_size;
+    ctx->busy = 0;
+    ctx->stopped = 0;
+    ctx->addrs = (struct sockaddr_storage *)(ctx + 1);
+    ctx->hdrs = (struct mmsghdr *)(ctx->addrs + batch);
+    ctx->iovs = (struct iovec *)(ctx->hdrs + batch);
+    ctx->msgs = (ev_udp_datagram_t *)(ctx->iovs + batch);
+    ctx->ctrls = (ev_udp_recv_cmsg_t *)(ctx->msgs + batch);
+    ctx->infos = (ev_udp_recv_info_t *)(ctx->ctrls + batch);
+    ctx->data = (uint8_t *)(ctx->infos + batch);
+
+    memset(ctx->hdrs, 0, sizeof(struct mmsghdr) * batch);
+    for (i = 0; i < batch; i++)
+    {
+        ctx->iovs[i].iov_base = ctx->data + i * msg_size;
+        ctx->iovs[i].iov_len = msg_size;
+        ctx->hdrs[i].msg_hdr.msg_name = &ctx->addrs[i];
+        ctx->hdrs[i].msg_hdr.msg_iov = &ctx->iovs[i];
+        ctx->hdrs[i].msg_hdr.msg_iovlen = 1;
+        ctx->hdrs[i].msg_hdr.msg_control = ctx->ctrls[i].buf;
+        ctx->msgs[i].addr = (struct sockaddr *)&ctx->addrs[i];
+        ctx->msgs[i].data = ctx->iovs[i].iov_base;
+        ctx->msgs[i].size = 0;
+        ctx->msgs[i].seg_size = 0;
+        ctx->msgs[i].info = NULL;
+    }
+
+    udp->backend.rbatch = ctx;
+    ev__nonblock_io_add(udp->base.loop, &udp->backend.io, EPOLLIN);
+    ev__handle_active(&udp->base);
+
+    return 0;
+}
+
+int ev_udp_recv_batch_stop(ev_udp_t *udp)
+{
+    if (udp->backend.rbatch == NULL)
+    {
+        return EV_ENOENT;
+    }
+
+    _ev_udp_recv_batch_detach_unix(udp);
+    if (udp->sock != EV_OS_SOCKET_INVALID)
+    {
+        ev__nonblock_io_del(udp->base.loop, &udp->backend.io, EPOLLIN);
+    }
+    _ev_udp_smart_deactive(udp);
+
+    return 0;
+}
+
+int ev_udp_recv_start(ev_udp_t *udp, size_t nbuf, size_t buf_size,
+                      ev_udp_recv_ring_cb cb, void *arg)
+{
+    size_t i;
+    if (udp->sock == EV_OS_SOCKET_INVALID)
+    {
+        return EV_EPIPE;
+    }
+    if (nbuf == 0 || buf_size == 0)
+    {
+        return EV_EINVAL;
+    }
+    /* A stopped ring is busy until all buffers are returned */
+    if (udp->backend.rbatch != NULL || udp->backend.rring != NULL ||
+        ev_list_size(&udp->recv_list) != 0)
+    {
+        return EV_EBUSY;
+    }
+    if (buf_size > (SIZE_MAX - sizeof(ev_udp_recv_ring_t)) / nbuf -
+                       sizeof(ev_udp_recv_slot_t))
+    {
+        return EV_ENOMEM;
+    }
+
+    ev_udp_recv_ring_t *ring = ev__loop_malloc(
+        udp->base.loop, EV_ALLOCATOR_TYPE_UDP,
+        sizeof(ev_udp_recv_ring_t) +
+            nbuf * (sizeof(ev_udp_recv_slot_t) + buf_size));
+    if (ring == NULL)
+    {
+        return EV_ENOMEM;
+    }
+
+    ring->cb = cb;
+    ring->arg = arg;
+    ring->buf_size = buf_size;
+    ring->borrowed = 0;
+    ring->busy = 0;
+    ring->stopped = 0;
+    ev_list_init(&ring->free_list);
+
+    ev_udp_recv_slot_t *slots = (ev_udp_recv_slot_t *)(ring + 1);
+    uint8_t            *data = (uint8_t *)(slots + nbuf);
+    for (i = 0; i < nbuf; i++)
+    {
+        slots[i].msg.addr = (struct sockaddr *)&slots[i].addr;
+        slots[i].msg.data = data + i * buf_size;
+        slots[i].msg.size = 0;
+        slots[i].msg.seg_size = 0;
+        slots[i].msg.info = NULL;
+        ev_list_push_back(&ring->free_list, &slots[i].node);
+    }
+
+    udp->backend.rring = ring;
+    ev__nonblock_io_add(udp->base.loop, &udp->backend.io, EPOLLIN);
+    ev__handle_active(&udp->base);
+
+    return 0;
+}
+
+int ev_udp_recv_stop(ev_udp_t *udp)
+{
+    ev_udp_recv_ring_t *ring = udp->backend.rring;
+    if (ring == NULL || ring->stopped)
+    {
+        return EV_ENOENT;
+    }
+
+    ring->stopped = 1;
+    if (udp->sock != EV_OS_SOCKET_INVALID)
+    {
+        ev__nonblock_io_del(udp->base.loop, &udp->backend.io, EPOLLIN);
+    }
+    _ev_udp_smart_deactive(udp);
+    _ev_udp_recv_ring_try_free_unix(udp);
+
+    return 0;
+}
+
+void ev_udp_recv_release(ev_udp_t *udp, ev_udp_datagram_t *msg)
+{
+    ev_udp_recv_ring_t *ring = udp->backend.rring;
+    ev_udp_recv_slot_t *slot = EV_CONTAINER_OF(msg, ev_udp_recv_slot_t, msg);
+
+    if (ring == NULL)
+    {
+        /* Handle is closed, buffer is already released */
+        return;
+    }
+
+    ev_list_push_back(&ring->free_list, &slot->node);
+    ring->borrowed--;
+
+    if (ring->stopped)
+    {
+        _ev_udp_recv_ring_try_free_unix(udp);
+        return;
+    }
+
+    /* Ring was exhausted, resume reading */
+    if (ev_list_size(&ring->free_list) == 1 &&
+        udp->sock != EV_OS_SOCKET_INVALID)
+    {
+        ev__nonblock_io_add(udp->base.loop, &udp->backend.io, EPOLLIN);
+    }
+}
+
+/**
+ * @brief Toggle socket option for one #ev_udp_recv_info_flags_t.
+ */
+static int _ev_udp_set_recv_info_opt_unix(ev_udp_t *udp, int family,
+                                          unsigned flag, unsigned flags)
+{
+    int level = SOL_SOCKET;
+    int optname;
+    int on = (flags & flag) != 0;
+
+    switch (flag)
+    {
+    case EV_UDP_RECV_PKTINFO:
+        if (family == AF_INET6)
+        {
+            level = IPPROTO_IPV6;
+            optname = IPV6_RECVPKTINFO;
+        }
+        else
+        {
+            level = IPPROTO_IP;
+            optname = IP_PKTINFO;
+        }
+        break;
+#if defined(SO_TIMESTAMPNS)
+    case EV_UDP_RECV_TIMESTAMP:
+        optname = SO_TIMESTAMPNS;
+        break;
+#endif
+#if defined(SO_RXQ_OVFL)
+    case EV_UDP_RECV_DROPS:
+        optname = SO_RXQ_OVFL;
+        break;
+#endif
+    default:
+        return on ? EV_ENOSYS : 0;
+    }
+
+    if (setsockopt(udp->sock, level, optname, &on, sizeof(on)) != 0)
+    {
+        int err = errno;
+        return ev__translate_sys_error(err);
+    }
+    return 0;
+}
+
+int ev_udp_set_recv_info(ev_udp_t *udp, unsigned flags)
+{
+    int                     ret;
+    unsigned                flag, prev;
+    struct sockaddr_storage addr;
+    socklen_t               addr_len = sizeof(addr);
+    unsigned                all =
+        EV_UDP_RECV_PKTINFO | EV_UDP_RECV_TIMESTAMP | EV_UDP_RECV_DROPS;
+
+    if (flags & ~all)
+    {
+        return EV_EINVAL;
+    }
+    if (udp->sock == EV_OS_SOCKET_INVALID)
+    {
+        return EV_EBADF;
+    }
+
+    /* Handle flags only know the family of addresses passed to bind */
+    if (getsockname(udp->sock, (struct sockaddr *)&addr, &addr_len) != 0)
+    {
+        int err = errno;
+        return ev__translate_sys_error(err);
+    }
+
+    if (udp->backend.rmeta == NULL)
+    {
+        if (flags == 0)
+        {
+            return 0;
+        }
+        udp->backend.rmeta = ev__loop_malloc(
+            udp->base.loop, EV_ALLOCATOR_TYPE_UDP, sizeof(ev_udp_recv_meta_t));
+        if (udp->backend.rmeta == NULL)
+        {
+            return EV_ENOMEM;
+        }
+        udp->backend.rmeta->flags = 0;
+    }
+
+    prev = udp->backend.rmeta->flags;
+    for (flag = EV_UDP_RECV_PKTINFO; flag <= EV_UDP_RECV_DROPS; flag <<= 1)
+    {
+        ret = _ev_udp_set_recv_info_opt_unix(udp, addr.ss_family, flag, flags);
+        if (ret != 0)
+        {
+            goto err_rollback;
+        }
+    }
+
+    udp->backend.rmeta->flags = flags;
+    return 0;
+
+err_rollback:
+    while ((flag >>= 1) >= EV_UDP_RECV_PKTINFO)
+    {
+        _ev_udp_set_recv_info_opt_unix(udp, addr.ss_family, flag, prev);
+    }
+    return ret;
+}
+
+const ev_udp_recv_info_t *ev_udp_recv_info(ev_udp_t *udp)
+{
+    if (_ev_udp_recv_info_flags_unix(udp) == 0)
+    {
+        return NULL;
+    }
+    return &udp->backend.rmeta->info;
+}
+
+static int _ev_udp_opt_native_unix(ev_udp_t *udp, ev_udp_opt_t opt,
+                                   int *level, int *name)
+{
+    *level = SOL_SOCKET;
+    switch (opt)
+    {
+    case EV_UDP_OPT_SNDBUF:
+        *name = SO_SNDBUF;
+        return 0;
+    case EV_UDP_OPT_RCVBUF:
+        *name = SO_RCVBUF;
+        return 0;
+#if defined(SO_SNDBUFFORCE)
+    case EV_UDP_OPT_SNDBUFFORCE:
+        *name = SO_SNDBUFFORCE;
+        return 0;
+#endif
+#if defined(SO_RCVBUFFORCE)
+    case EV_UDP_OPT_RCVBUFFORCE:
+        *name = SO_RCVBUFFORCE;
+        return 0;
+#endif
+    case EV_UDP_OPT_TOS:
+        if (udp->base.data.flags & EV_HANDLE_UDP_IPV6)
+        {
+            *level = IPPROTO_IPV6;
+            *name = IPV6_TCLASS;
+        }
+        else
+        {
+            *level = IPPROTO_IP;
+            *name = IP_TOS;
+        }
+        return 0;
+    default:
+        return EV_ENOSYS;
+    }
+}
+
+int ev_udp_setopt(ev_udp_t *udp, ev_udp_opt_t opt, int val)
+{
+    int ret, level, name;
+    if ((ret = _ev_udp_opt_native_unix(udp, opt, &level, &name)) != 0)
+    {
+        return ret;
+    }
+
+    if (setsockopt(udp->sock, level, name, &val, sizeof(val)) != 0)
+    {
+        ret = errno;
+        return ev__translate_sys_error(ret);
+    }
+    return 0;
+}
+
+int ev_udp_getopt(ev_udp_t *udp, ev_udp_opt_t opt, int *val)
+{
+    int ret, level, name;
+    if ((ret = _ev_udp_opt_native_unix(udp, opt, &level, &name)) != 0)
+    {
+        return ret;
+    }
+
+    /* Read back the effective value */
+    if (opt == EV_UDP_OPT_SNDBUFFORCE)
+    {
+        name = SO_SNDBUF;
+    }
+    else if (opt == EV_UDP_OPT_RCVBUFFORCE)
+    {
+        name = SO_RCVBUF;
+    }
+
+    socklen_t len = sizeof(*val);
+    if (getsockopt(udp->sock, level, name, val, &len) != 0)
+    {
+        ret = errno;
+        return ev__translate_sys_error(ret);
+    }
+    return 0;
+}
+
+int ev_udp_set_reuseport_cbpf(ev_udp_t *udp, const void *insns, size_t ninsn)
+{
+    if (insns == NULL || ninsn == 0 || ninsn > USHRT_MAX)
+    {
+        return EV_EINVAL;
+    }
+
+#if defined(SO_ATTACH_REUSEPORT_CBPF)
+    struct sock_fprog prog;
+    prog.len = (unsigned short)ninsn;
+    prog.filter = (struct sock_filter *)insns;
+
+    if (setsockopt(udp->sock, SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &prog,
+                   sizeof(prog)) != 0)
+    {
+        int err = errno;
+        return ev__translate_sys_error(err);
+    }
+    return 0;
+#else
+    (void)udp;
+    return EV_ENOSYS;
+#endif
+}
+
+int ev_udp_set_reuseport_cpu(ev_udp_t *udp, unsigned group_size)
+{
+    if (group_size == 0)
+    {
+        return EV_EINVAL;
+    }
+
+#if defined(SO_ATTACH_REUSEPORT_CBPF)
+    struct sock_filter insns[] = {
+        /* A = current CPU */
+        { BPF_LD | BPF_W | BPF_ABS, 0, 0, (uint32_t)(SKF_AD_OFF + SKF_AD_CPU) },
+        /* A = A % group_size */
+        { BPF_ALU | BPF_MOD | BPF_K, 0, 0, group_size },
+        /* return A */
+        { BPF_RET | BPF_A, 0, 0, 0 },
+    };
+    return ev_udp_set_reuseport_cbpf(udp, insns, ARRAY_SIZE(insns));
+#else
+    (void)udp;
+    return EV_ENOSYS;
+#endif
+}
+
+int ev_udp_set_gro(ev_udp_t *udp, int on)
+{
+#if defined(UDP_GRO)
+    if (setsockopt(udp->sock, SOL_UDP, UDP_GRO, &on, sizeof(on)) != 0)
+    {
+        int err = errno;
+        return err == ENOPROTOOPT ? EV_ENOSYS : ev__translate_sys_error(err);
+    }
+    return 0;
+#else
+    (void)on;
+    return EV_ENOSYS;
+#endif
+}
+
+int ev_udp_set_membership(ev_udp_t *udp, const char *multicast_addr,
+                          const char         *interface_addr,
+                          ev_udp_membership_t membership)
+{
+    int                     ret;
+    struct sockaddr_storage addr;
+
+    if (membership != EV_UDP_LEAVE_GROUP && membership != EV_UDP_ENTER_GROUP)
+    {
+        return EV_EINVAL;
+    }
+
+    struct sockaddr_in *addr_4 = (struct sockaddr_in *)&addr;
+    memset(addr_4, 0, sizeof(*addr_4));
+
+    if (ev_ipv4_addr(multicast_addr, 0, addr_4) == 0)
+    {
+        if ((ret = _ev_udp_maybe_deferred_bind_unix(udp, AF_INET,
+                                                    EV_UDP_REUSEADDR)) != 0)
+        {
+            return ret;
+        }
+
+        return _ev_udp_setmembership4_unix(udp, addr_4, interface_addr,
+                                           membership);
+    }
+
+    struct sockaddr_in6 *addr_6 = (struct sockaddr_in6 *)&addr;
+    memset(addr_6, 0, sizeof(*addr_6));
+
+    if (ev_ipv6_addr(multicast_addr, 0, addr_6) == 0)
+    {
+        if ((ret = _ev_udp_maybe_deferred_bind_unix(udp, AF_INET6,
+                                                    EV_UDP_REUSEADDR)) != 0)
+        {
+            return ret;
+        }
+
+        return _ev_udp_setmembership6_unix(udp, addr_6, interface_addr,
+                                           membership);
+    }
+
+    return EV_EINVAL;
+}
+
+int ev_udp_set_source_membership(ev_udp_t *udp, const char *multicast_addr,
+                                 const char         *interface_addr,
+                                 const char         *source_addr,
+                                 ev_udp_membership_t membership)
+{
+    int                     ret;
+    struct sockaddr_storage mcast_addr;
+    struct sockaddr_storage src_addr;
+
+    if (membership != EV_UDP_LEAVE_GROUP && membership != EV_UDP_ENTER_GROUP)
+    {
+        return EV_EINVAL;
+    }
+
+    struct sockaddr_in *mcast_addr_4 = (struct sockaddr_in *)&mcast_addr;
+    if ((ret = ev_ipv4_addr(multicast_addr, 0, mcast_addr_4)) == 0)
+    {
+        struct sockaddr_in *src_addr_4 = (struct sockaddr_in *)&src_addr;
+        if ((ret = ev_ipv4_addr(source_addr, 0, src_addr_4)) != 0)
+        {
+            return ret;
+        }
+
+        return _ev_udp_set_source_membership4_unix(
+            udp, mcast_addr_4, interface_addr, src_addr_4, membership);
+    }
+
+    struct sockaddr_in6 *mcast_addr_6 = (struct sockaddr_in6 *)&mcast_addr;
+    if ((ret = ev_ipv6_addr(multicast_addr, 0, mcast_addr_6)) == 0)
+    {
+        struct sockaddr_in6 *src_addr_6 = (struct sockaddr_in6 *)&src_addr;
+        if ((ret = ev_ipv6_addr(source_addr, 0, src_addr_6)) != 0)
+        {
+            return ret;
+        }
+
+        return _ev_udp_set_source_membership6_unix(
+            udp, mcast_addr_6, interface_addr, src_addr_6, membership);
+    }
+
+    return ret;
+}
+
+int ev_udp_set_multicast_loop(ev_udp_t *udp, int on)
+{
+    return _ev_udp_set_ttl_unix(udp, on, IP_MULTICAST_LOOP,
+                                IPV6_MULTICAST_LOOP);
+}
+
+int ev_udp_set_multicast_ttl(ev_udp_t *udp, int ttl)
+{
+    return _ev_udp_set_ttl_unix(udp, ttl, IP_MULTICAST_TTL,
+                                IPV6_MULTICAST_HOPS);
+}
+
+int ev_udp_set_multicast_interface(ev_udp_t *udp, const char *interface_addr)
+{
+    int                     ret;
+    struct sockaddr_storage addr_st;
+    struct sockaddr_in     *addr_4 = (struct sockaddr_in *)&addr_st;
+    struct sockaddr_in6    *addr_6 = (struct sockaddr_in6 *)&addr_st;
+
+    int is_ipv6 = udp->base.data.flags & EV_HANDLE_UDP_IPV6;
+    if ((ret = ev__udp_interface_addr_to_sockaddr(&addr_st, interface_addr,
+                                                  is_ipv6)) != 0)
+    {
+        return ret;
+    }
+
+    int       level;
+    int       optname;
+    void     *optval;
+    socklen_t optlen;
+
+    if (addr_st.ss_family == AF_INET)
+    {
+        level = IPPROTO_IP;
+        optname = IP_MULTICAST_IF;
+        optval = &addr_4->sin_addr;
+        optlen = sizeof(addr_4->sin_addr);
+    }
+    else if (addr_st.ss_family == AF_INET6)
+    {
+        level = IPPROTO_IPV6;
+        optname = IPV6_MULTICAST_IF;
+        optval = &addr_6->sin6_scope_id;
+        optlen = sizeof(addr_6->sin6_scope_id);
+    }
+    else
+    {
+        EV_ABORT();
+    }
+
+    if (setsockopt(udp->sock, level, optname, optval, optlen) != 0)
+    {
+        ret = errno;
+        return ev__translate_sys_error(ret);
+    }
+
+    return 0;
+}
+
+int ev_udp_set_broadcast(ev_udp_t *udp, int on)
+{
+    int err;
+    if (setsockopt(udp->sock, SOL_SOCKET, SO_BROADCAST, &on, sizeof(on)) != 0)
+    {
+        err = errno;
+        return ev__translate_sys_error(err);
+    }
+
+    return 0;
+}
+
+int ev_udp_set_ttl(ev_udp_t *udp, int ttl)
+{
+    if (ttl < 1 || ttl > 255)
+    {
+        return EV_EINVAL;
+    }
+
+#if defined(__MVS__)
+    /* zOS does not support setting ttl for IPv4 */
+    if (!(udp->base.data.flags & EV_HANDLE_UDP_IPV6))
+    {
+        return EV_ENOTSUP;
+    }
+#endif
+
+    return _ev_udp_set_ttl_unix(udp, ttl, IP_TTL, IPV6_UNICAST_HOPS);
+}
@@ -12,9 +12,13 @@ static void _async_on_iocp_win(ev_iocp_t* iocp, size_t transferred, void* arg)
 static void _ev_async_on_close_win(ev_handle_t* handle)
 {
     ev_async_t* async = EV_CONTAINER_OF(handle, ev_async_t, base);
+    ev_loop_t* loop = async->base.loop;
     ev_async_cb close_cb = async->close_cb;
     void* close_arg = async->close_arg;
-    ev_free(async);
+    if (!(async->base.data.flags & EV_HANDLE_INPLACE))
+    {
+        ev__loop_free(loop, async);
+    }
 
     if (close_cb != NULL)
     {
@@ -35,7 +39,10 @@ static void _ev_asyc_exit_win(ev_async_t* handle, ev_async_cb close_cb,
     else
     {
         ev__handle_exit(&handle->base, NULL);
-        ev_free(handle);
+        if (!(handle->base.data.flags & EV_HANDLE_INPLACE))
+        {
+            ev__loop_free(handle->base.loop, handle);
+        }
     }
 }
 
@@ -44,24 +51,48 @@ EV_LOCAL void ev__async_exit_force(ev_async_t* handle)
     _ev_asyc_exit_win(handle, NULL, NULL);
 }
 
+static void _ev_async_init_win(ev_loop_t* loop, ev_async_t* handle,
+    ev_async_cb activate_cb, void* activate_arg)
+{
+    handle->activate_cb = activate_cb;
+    handle->activate_arg = activate_arg;
+    handle->close_cb = NULL;
+    handle->close_arg = NULL;
+    handle->backend.async_sent = 0;
+
+    ev__iocp_init(&handle->backend.io, _async_on_iocp_win, NULL);
+    ev__handle_init(loop, &handle->base, EV_ROLE_EV_ASYNC);
+    ev__handle_active(&handle->base);
+}
+
+size_t ev_async_size(void)
+{
+    return sizeof(ev_async_t);
+}
+
 int ev_async_init(ev_loop_t *loop, ev_async_t **handle,
     ev_async_cb activate_cb, void *activate_arg)
 {
-    ev_async_t* new_handle = ev_malloc(sizeof(ev_async_t));
+    ev_async_t* new_handle =
+        ev__loop_malloc(loop, EV_ALLOCATOR_TYPE_MISC, sizeof(ev_async_t));
     if (new_handle == NULL)
     {
         return EV_ENOMEM;
     }
 
-    new_handle->activate_cb = activate_cb;
-    new_handle->activate_arg = activate_arg;
-    new_handle->close_cb = NULL;
-    new_handle->close_arg = NULL;
-    new_handle->backend.async_sent = 0;
+    _ev_async_init_win(loop, new_handle, activate_cb, activate_arg);
+
+    *handle = new_handle;
+    return 0;
+}
+
+int ev_async_init_inplace(ev_loop_t *loop, ev_async_t **handle,
+    ev_async_cb activate_cb, void *activate_arg, void *mem)
+{
+    ev_async_t* new_handle = mem;
 
-    ev__iocp_init(&new_handle->backend.io, _async_on_iocp_win, NULL);
-    ev__handle_init(loop, &new_handle->base, EV_ROLE_EV_ASYNC);
-    ev__handle_active(&new_handle->base);
+    _ev_async_init_win(loop, new_handle, activate_cb, activate_arg);
+    new_handle->base.data.flags |= EV_HANDLE_INPLACE;
 
     *handle = new_handle;
     return 0;
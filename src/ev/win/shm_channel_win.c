@@ -0,0 +1,45 @@
+int ev_shm_channel_init(ev_loop_t *loop, ev_shm_channel_t **chan,
+                        const char *key, size_t size,
+                        ev_shm_channel_recv_cb cb, void *arg)
+{
+    (void)loop;
+    (void)chan;
+    (void)key;
+    (void)size;
+    (void)cb;
+    (void)arg;
+    return EV_ENOSYS;
+}
+
+int ev_shm_channel_open(ev_loop_t *loop, ev_shm_channel_t **chan,
+                        const char *key)
+{
+    (void)loop;
+    (void)chan;
+    (void)key;
+    return EV_ENOSYS;
+}
+
+void ev_shm_channel_exit(ev_shm_channel_t *chan, ev_shm_channel_cb close_cb,
+                         void *close_arg)
+{
+    (void)chan;
+    (void)close_cb;
+    (void)close_arg;
+}
+
+int ev_shm_channel_send(ev_shm_channel_t *chan, const void *data, size_t size)
+{
+    (void)chan;
+    (void)data;
+    (void)size;
+    return EV_ENOSYS;
+}
+
+EV_LOCAL int ev__shm_channel_doorbell(ev_shm_channel_t *chan,
+                                      ev_os_socket_t   *fd)
+{
+    (void)chan;
+    (void)fd;
+    return EV_ENOSYS;
+}
@@ -0,0 +1,53 @@
+#include "test.h"
+
+struct test_a1c7
+{
+    ev_loop_t  *s_loop;
+    ev_timer_t *s_timer;
+};
+
+struct test_a1c7 g_test_a1c7;
+
+TEST_FIXTURE_SETUP(allocator)
+{
+    memset(&g_test_a1c7, 0, sizeof(g_test_a1c7));
+    ASSERT_EQ_INT(ev_loop_init(&g_test_a1c7.s_loop), 0);
+}
+
+TEST_FIXTURE_TEARDOWN(allocator)
+{
+    ASSERT_EQ_INT(ev_loop_run(g_test_a1c7.s_loop, EV_LOOP_MODE_DEFAULT,
+                              EV_INFINITE_TIMEOUT),
+                  0);
+    ASSERT_EQ_INT(ev_loop_exit(g_test_a1c7.s_loop), 0);
+}
+
+TEST_F(allocator, stat)
+{
+    ev_allocator_stat_t stat_1, stat_2;
+
+    ASSERT_EQ_INT(ev_allocator_stat(EV_ALLOCATOR_TYPE_MAX, &stat_1), EV_EINVAL);
+
+    int ret = ev_allocator_stat(EV_ALLOCATOR_TYPE_TIMER, &stat_1);
+#if !defined(TEST_ALLOCATOR_STAT)
+    if (ret == EV_ENOSYS)
+    {
+        return;
+    }
+#endif
+    ASSERT_EQ_INT(ret, 0);
+
+    ASSERT_EQ_INT(ev_timer_init(g_test_a1c7.s_loop, &g_test_a1c7.s_timer), 0);
+    ASSERT_EQ_INT(ev_allocator_stat(EV_ALLOCATOR_TYPE_TIMER, &stat_2), 0);
+    ASSERT_EQ_UINT64(stat_2.alloc_count, stat_1.alloc_count + 1);
+    ASSERT_GT_SIZE(stat_2.live_bytes, stat_1.live_bytes);
+    ASSERT_GE_SIZE(stat_2.peak_bytes, stat_2.live_bytes);
+
+    ev_timer_exit(g_test_a1c7.s_timer, NULL, NULL);
+    ASSERT_EQ_INT(ev_loop_run(g_test_a1c7.s_loop, EV_LOOP_MODE_DEFAULT,
+                              EV_INFINITE_TIMEOUT),
+                  0);
+    ASSERT_EQ_INT(ev_allocator_stat(EV_ALLOCATOR_TYPE_TIMER, &stat_2), 0);
+    ASSERT_EQ_UINT64(stat_2.free_count, stat_1.free_count + 1);
+    ASSERT_EQ_SIZE(stat_2.live_bytes, stat_1.live_bytes);
+}
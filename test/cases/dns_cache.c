@@ -0,0 +1,210 @@
+#include "ev.h"
+#include "test.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+struct test_a3d1
+{
+    ev_loop_t       *loop;
+    ev_getaddrinfo_t reqs[3];
+    struct addrinfo  hints;
+
+    const struct addrinfo *res[3];
+    int                    status[3];
+    int                    family[3]; /**< Family of first result */
+    int                    port[3];   /**< Port of first result */
+    int                    cnt_done;
+
+    size_t cnt_alloc; /**< Allocations, each lookup not cached takes one */
+    size_t cnt_free;  /**< Releases */
+};
+
+struct test_a3d1 g_test_a3d1;
+
+static void _test_a3d1_on_resolve(ev_getaddrinfo_t *req,
+                                  const struct addrinfo *res, int status)
+{
+    size_t idx = req - g_test_a3d1.reqs;
+    ASSERT_LT_SIZE(idx, 3);
+
+    g_test_a3d1.res[idx] = res;
+    g_test_a3d1.status[idx] = status;
+    g_test_a3d1.cnt_done++;
+
+    /* Result is only valid inside callback */
+    if (res != NULL && res->ai_family == AF_INET)
+    {
+        const struct sockaddr_in *addr =
+            (const struct sockaddr_in *)res->ai_addr;
+        g_test_a3d1.family[idx] = res->ai_family;
+        g_test_a3d1.port[idx] = ntohs(addr->sin_port);
+    }
+}
+
+static void *_test_a3d1_realloc(void *ptr, size_t size, void *arg)
+{
+    (void)arg;
+    if (ptr == NULL && size != 0)
+    {
+        g_test_a3d1.cnt_alloc++;
+    }
+    else if (ptr != NULL && size == 0)
+    {
+        g_test_a3d1.cnt_free++;
+        free(ptr);
+        return NULL;
+    }
+    return realloc(ptr, size);
+}
+
+static void _test_a3d1_resolve(size_t idx, const char *host)
+{
+    ASSERT_EQ_INT(ev_getaddrinfo(g_test_a3d1.loop, &g_test_a3d1.reqs[idx], host,
+                                 "80", &g_test_a3d1.hints,
+                                 _test_a3d1_on_resolve),
+                  0);
+}
+
+static void _test_a3d1_resolve_wait(size_t idx, const char *host)
+{
+    _test_a3d1_resolve(idx, host);
+    ASSERT_EQ_INT(ev_loop_run(g_test_a3d1.loop, EV_LOOP_MODE_DEFAULT,
+                              EV_INFINITE_TIMEOUT),
+                  0);
+}
+
+TEST_FIXTURE_SETUP(dns)
+{
+    memset(&g_test_a3d1, 0, sizeof(g_test_a3d1));
+    g_test_a3d1.hints.ai_family = AF_INET;
+    g_test_a3d1.hints.ai_socktype = SOCK_STREAM;
+    ASSERT_EQ_INT(ev_loop_init(&g_test_a3d1.loop), 0);
+    ASSERT_EQ_INT(ev_loop_replace_allocator(g_test_a3d1.loop,
+                                            _test_a3d1_realloc, NULL),
+                  0);
+}
+
+TEST_FIXTURE_TEARDOWN(dns)
+{
+    ASSERT_EQ_INT(ev_loop_run(g_test_a3d1.loop, EV_LOOP_MODE_DEFAULT,
+                              EV_INFINITE_TIMEOUT),
+                  0);
+    ASSERT_EQ_INT(ev_loop_exit(g_test_a3d1.loop), 0);
+}
+
+TEST_F(dns, cache)
+{
+    /* Concurrent lookups share one result */
+    _test_a3d1_resolve(0, "localhost");
+    _test_a3d1_resolve(1, "localhost");
+    ASSERT_EQ_INT(g_test_a3d1.cnt_done, 0);
+    ASSERT_EQ_INT(ev_loop_run(g_test_a3d1.loop, EV_LOOP_MODE_DEFAULT,
+                              EV_INFINITE_TIMEOUT),
+                  0);
+    ASSERT_EQ_INT(g_test_a3d1.cnt_done, 2);
+    ASSERT_EQ_INT(g_test_a3d1.status[0], 0);
+    ASSERT_EQ_INT(g_test_a3d1.status[1], 0);
+    ASSERT_NE_PTR(g_test_a3d1.res[0], NULL);
+    ASSERT_EQ_PTR(g_test_a3d1.res[0], g_test_a3d1.res[1]);
+
+    /* Answered from cache */
+    _test_a3d1_resolve(2, "localhost");
+    ASSERT_EQ_INT(g_test_a3d1.cnt_done, 2);
+    ASSERT_EQ_INT(ev_loop_run(g_test_a3d1.loop, EV_LOOP_MODE_DEFAULT,
+                              EV_INFINITE_TIMEOUT),
+                  0);
+    ASSERT_EQ_INT(g_test_a3d1.cnt_done, 3);
+    ASSERT_EQ_PTR(g_test_a3d1.res[2], g_test_a3d1.res[0]);
+}
+
+TEST_F(dns, cache_disabled)
+{
+    ev_getaddrinfo_set_ttl(g_test_a3d1.loop, 0, 0);
+
+    _test_a3d1_resolve(0, "localhost");
+    ASSERT_EQ_INT(ev_loop_run(g_test_a3d1.loop, EV_LOOP_MODE_DEFAULT,
+                              EV_INFINITE_TIMEOUT),
+                  0);
+    ASSERT_EQ_INT(g_test_a3d1.status[0], 0);
+
+    /* Resolved again, which needs a new cache entry */
+    size_t cnt_alloc = g_test_a3d1.cnt_alloc;
+    _test_a3d1_resolve(1, "localhost");
+    ASSERT_GT_SIZE(g_test_a3d1.cnt_alloc, cnt_alloc);
+    ASSERT_EQ_INT(ev_loop_run(g_test_a3d1.loop, EV_LOOP_MODE_DEFAULT,
+                              EV_INFINITE_TIMEOUT),
+                  0);
+    ASSERT_EQ_INT(g_test_a3d1.cnt_done, 2);
+    ASSERT_EQ_INT(g_test_a3d1.status[1], 0);
+    ASSERT_EQ_INT(g_test_a3d1.family[1], AF_INET);
+    ASSERT_EQ_INT(g_test_a3d1.port[1], 80);
+}
+
+TEST_F(dns, negative_cache)
+{
+    /* Never touch network */
+    g_test_a3d1.hints.ai_flags = AI_NUMERICHOST;
+
+    _test_a3d1_resolve(0, "not.a.number");
+    ASSERT_EQ_INT(ev_loop_run(g_test_a3d1.loop, EV_LOOP_MODE_DEFAULT,
+                              EV_INFINITE_TIMEOUT),
+                  0);
+    ASSERT_EQ_INT(g_test_a3d1.status[0], EV_ENOENT);
+    ASSERT_EQ_PTR(g_test_a3d1.res[0], NULL);
+
+    /* Answered from cache, nothing is allocated */
+    size_t cnt_alloc = g_test_a3d1.cnt_alloc;
+    _test_a3d1_resolve(1, "not.a.number");
+    ASSERT_EQ_SIZE(g_test_a3d1.cnt_alloc, cnt_alloc);
+    ASSERT_EQ_INT(ev_loop_run(g_test_a3d1.loop, EV_LOOP_MODE_DEFAULT,
+                              EV_INFINITE_TIMEOUT),
+                  0);
+    ASSERT_EQ_INT(g_test_a3d1.cnt_done, 2);
+    ASSERT_EQ_INT(g_test_a3d1.status[1], EV_ENOENT);
+}
+
+TEST_F(dns, cache_replace_allocator)
+{
+    g_test_a3d1.hints.ai_flags = AI_NUMERICHOST;
+    _test_a3d1_resolve_wait(0, "127.0.0.1");
+    ASSERT_EQ_INT(g_test_a3d1.status[0], 0);
+
+    /* Cache is released by the allocator it comes from */
+    size_t cnt_free = g_test_a3d1.cnt_free;
+    ASSERT_EQ_INT(ev_loop_replace_allocator(g_test_a3d1.loop, NULL, NULL), 0);
+    ASSERT_GT_SIZE(g_test_a3d1.cnt_free, cnt_free);
+
+    /* Not cached any more */
+    ASSERT_EQ_INT(ev_loop_replace_allocator(g_test_a3d1.loop,
+                                            _test_a3d1_realloc, NULL),
+                  0);
+    size_t cnt_alloc = g_test_a3d1.cnt_alloc;
+    _test_a3d1_resolve_wait(1, "127.0.0.1");
+    ASSERT_GT_SIZE(g_test_a3d1.cnt_alloc, cnt_alloc);
+    ASSERT_EQ_INT(g_test_a3d1.status[1], 0);
+}
+
+TEST_F(dns, cache_evict_oldest)
+{
+    size_t i;
+    char   host[32];
+    g_test_a3d1.hints.ai_flags = AI_NUMERICHOST;
+
+    _test_a3d1_resolve_wait(0, "127.0.0.1");
+    ASSERT_EQ_INT(g_test_a3d1.status[0], 0);
+
+    /* Fill the cache, oldest entry is evicted */
+    for (i = 0; i < 1024; i++)
+    {
+        snprintf(host, sizeof(host), "10.0.%u.%u", (unsigned)(i / 256),
+                 (unsigned)(i % 256));
+        _test_a3d1_resolve_wait(1, host);
+        ASSERT_EQ_INT(g_test_a3d1.status[1], 0);
+    }
+
+    size_t cnt_alloc = g_test_a3d1.cnt_alloc;
+    _test_a3d1_resolve_wait(2, "127.0.0.1");
+    ASSERT_GT_SIZE(g_test_a3d1.cnt_alloc, cnt_alloc);
+    ASSERT_EQ_INT(g_test_a3d1.status[2], 0);
+}
@@ -0,0 +1,75 @@
+#include "ev.h"
+#include "test.h"
+#include <stdlib.h>
+#include <string.h>
+
+struct test_5a31
+{
+    ev_loop_t  *s_loop;
+    ev_timer_t *s_timer;
+    ev_tcp_t   *s_tcp;
+
+    size_t cnt_alloc;
+    size_t cnt_free;
+};
+
+struct test_5a31 g_test_5a31;
+
+static void *_loop_realloc_5a31(void *ptr, size_t size, void *arg)
+{
+    struct test_5a31 *ctx = arg;
+
+    if (ptr == NULL && size != 0)
+    {
+        ctx->cnt_alloc++;
+    }
+    else if (ptr != NULL && size == 0)
+    {
+        ctx->cnt_free++;
+        free(ptr);
+        return NULL;
+    }
+
+    return realloc(ptr, size);
+}
+
+TEST_FIXTURE_SETUP(loop)
+{
+    memset(&g_test_5a31, 0, sizeof(g_test_5a31));
+    ASSERT_EQ_INT(ev_loop_init(&g_test_5a31.s_loop), 0);
+}
+
+TEST_FIXTURE_TEARDOWN(loop)
+{
+    ASSERT_EQ_INT(ev_loop_run(g_test_5a31.s_loop, EV_LOOP_MODE_DEFAULT,
+                              EV_INFINITE_TIMEOUT),
+                  0);
+    ASSERT_EQ_INT(ev_loop_exit(g_test_5a31.s_loop), 0);
+}
+
+TEST_F(loop, allocator)
+{
+    ASSERT_EQ_INT(ev_loop_replace_allocator(g_test_5a31.s_loop,
+                                            _loop_realloc_5a31, &g_test_5a31),
+                  0);
+
+    ASSERT_EQ_INT(ev_timer_init(g_test_5a31.s_loop, &g_test_5a31.s_timer), 0);
+    ASSERT_EQ_INT(ev_tcp_init(g_test_5a31.s_loop, &g_test_5a31.s_tcp), 0);
+    ASSERT_EQ_SIZE(g_test_5a31.cnt_alloc, 2);
+
+    /* Allocator cannot be changed as long as handles exist. */
+    ASSERT_EQ_INT(
+        ev_loop_replace_allocator(g_test_5a31.s_loop, NULL, NULL), EV_EBUSY);
+
+    ev_timer_exit(g_test_5a31.s_timer, NULL, NULL);
+    ev_tcp_exit(g_test_5a31.s_tcp, NULL, NULL);
+    ASSERT_EQ_INT(ev_loop_run(g_test_5a31.s_loop, EV_LOOP_MODE_DEFAULT,
+                              EV_INFINITE_TIMEOUT),
+                  0);
+    ASSERT_EQ_SIZE(g_test_5a31.cnt_free, 2);
+
+    ASSERT_EQ_INT(ev_loop_replace_allocator(g_test_5a31.s_loop, NULL, NULL), 0);
+
+    /* Overflowed size is never passed to allocator */
+    ASSERT_EQ_PTR(ev_calloc(SIZE_MAX / 2 + 1, 2), NULL);
+}
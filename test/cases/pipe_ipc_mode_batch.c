@@ -0,0 +1,146 @@
+#include "ev.h"
+#include "test.h"
+#include "utils/sockpair.h"
+#include <string.h>
+
+#define TEST_2f7b_FRAME_NUM  256
+#define TEST_2f7b_HANDLE_IDX 100
+
+struct test_2f7b
+{
+    ev_loop_t *loop;
+    ev_pipe_t *s_pipe;
+    ev_pipe_t *c_pipe;
+
+    ev_tcp_t *s_tcp; /**< Transferred to peer */
+    ev_tcp_t *c_tcp;
+    ev_tcp_t *d_tcp; /**< Receive transferred handle */
+
+    ev_pipe_read_req_t r_req;
+    uint8_t            wdata[TEST_2f7b_FRAME_NUM][64];
+    uint8_t            rdata[64];
+
+    size_t cnt_wcb;
+    size_t cnt_rcb;
+};
+
+struct test_2f7b g_test_2f7b;
+
+static size_t _test_2f7b_frame_size(size_t idx)
+{
+    return idx % sizeof(g_test_2f7b.wdata[0]) + 1;
+}
+
+static void _test_2f7b_on_write(ev_pipe_t *pipe, ssize_t size, void *arg)
+{
+    (void)pipe;
+    size_t idx = (size_t)(uintptr_t)arg;
+
+    /* Completed in order */
+    ASSERT_EQ_SIZE(idx, g_test_2f7b.cnt_wcb);
+    ASSERT_EQ_SSIZE(size, _test_2f7b_frame_size(idx));
+    g_test_2f7b.cnt_wcb++;
+}
+
+static void _test_2f7b_on_read(ev_pipe_read_req_t *req, ssize_t size);
+
+static void _test_2f7b_read_next(void)
+{
+    ev_buf_t buf = ev_buf_make(g_test_2f7b.rdata, sizeof(g_test_2f7b.rdata));
+    ASSERT_EQ_INT(ev_pipe_read(g_test_2f7b.c_pipe, &g_test_2f7b.r_req, &buf, 1,
+                               _test_2f7b_on_read),
+                  0);
+}
+
+static void _test_2f7b_on_read(ev_pipe_read_req_t *req, ssize_t size)
+{
+    size_t idx = g_test_2f7b.cnt_rcb++;
+
+    /* Frame boundary is kept */
+    ASSERT_EQ_SSIZE(size, _test_2f7b_frame_size(idx));
+    ASSERT_EQ_INT(memcmp(g_test_2f7b.rdata, g_test_2f7b.wdata[idx], size), 0);
+
+    if (idx == TEST_2f7b_HANDLE_IDX)
+    {
+        ASSERT_EQ_INT(ev_pipe_accept(g_test_2f7b.c_pipe, req, EV_ROLE_EV_TCP,
+                                     g_test_2f7b.d_tcp),
+                      0);
+    }
+    else
+    {
+        ASSERT_EQ_INT(ev_pipe_accept(g_test_2f7b.c_pipe, req, EV_ROLE_EV_TCP,
+                                     g_test_2f7b.d_tcp),
+                      EV_ENOENT);
+    }
+
+    if (g_test_2f7b.cnt_rcb < TEST_2f7b_FRAME_NUM)
+    {
+        _test_2f7b_read_next();
+    }
+}
+
+TEST_FIXTURE_SETUP(pipe)
+{
+    size_t i;
+    memset(&g_test_2f7b, 0, sizeof(g_test_2f7b));
+    for (i = 0; i < TEST_2f7b_FRAME_NUM; i++)
+    {
+        memset(g_test_2f7b.wdata[i], (int)i, sizeof(g_test_2f7b.wdata[i]));
+    }
+
+    ASSERT_EQ_INT(ev_loop_init(&g_test_2f7b.loop), 0);
+    ASSERT_EQ_INT(ev_pipe_init(g_test_2f7b.loop, &g_test_2f7b.s_pipe, 1), 0);
+    ASSERT_EQ_INT(ev_pipe_init(g_test_2f7b.loop, &g_test_2f7b.c_pipe, 1), 0);
+
+    int          rwflags = EV_PIPE_NONBLOCK | EV_PIPE_IPC;
+    ev_os_pipe_t fds[2] = { EV_OS_PIPE_INVALID, EV_OS_PIPE_INVALID };
+    ASSERT_EQ_INT(ev_pipe_make(fds, rwflags, rwflags), 0);
+    ASSERT_EQ_INT(ev_pipe_open(g_test_2f7b.s_pipe, fds[0]), 0);
+    ASSERT_EQ_INT(ev_pipe_open(g_test_2f7b.c_pipe, fds[1]), 0);
+
+    ASSERT_EQ_INT(ev_tcp_init(g_test_2f7b.loop, &g_test_2f7b.s_tcp), 0);
+    ASSERT_EQ_INT(ev_tcp_init(g_test_2f7b.loop, &g_test_2f7b.c_tcp), 0);
+    test_sockpair(g_test_2f7b.loop, g_test_2f7b.s_tcp, g_test_2f7b.c_tcp);
+    ASSERT_EQ_INT(ev_tcp_init(g_test_2f7b.loop, &g_test_2f7b.d_tcp), 0);
+}
+
+TEST_FIXTURE_TEARDOWN(pipe)
+{
+    ev_pipe_exit(g_test_2f7b.s_pipe, NULL, NULL);
+    ev_pipe_exit(g_test_2f7b.c_pipe, NULL, NULL);
+    ev_tcp_exit(g_test_2f7b.s_tcp, NULL, NULL);
+    ev_tcp_exit(g_test_2f7b.c_tcp, NULL, NULL);
+    ev_tcp_exit(g_test_2f7b.d_tcp, NULL, NULL);
+    ASSERT_EQ_INT(ev_loop_run(g_test_2f7b.loop, EV_LOOP_MODE_DEFAULT,
+                              EV_INFINITE_TIMEOUT),
+                  0);
+    ASSERT_EQ_INT(ev_loop_exit(g_test_2f7b.loop), 0);
+}
+
+TEST_F(pipe, ipc_mode_batch)
+{
+    size_t i;
+    for (i = 0; i < TEST_2f7b_FRAME_NUM; i++)
+    {
+        ev_buf_t buf =
+            ev_buf_make(g_test_2f7b.wdata[i], _test_2f7b_frame_size(i));
+        ev_role_t role =
+            i == TEST_2f7b_HANDLE_IDX ? EV_ROLE_EV_TCP : EV_ROLE_UNKNOWN;
+        void *handle = i == TEST_2f7b_HANDLE_IDX ? g_test_2f7b.s_tcp : NULL;
+        ASSERT_EQ_INT(ev_pipe_write_ex(g_test_2f7b.s_pipe, &buf, 1, role,
+                                       handle, _test_2f7b_on_write,
+                                       (void *)(uintptr_t)i),
+                      0);
+    }
+    ASSERT_EQ_INT(ev_loop_run(g_test_2f7b.loop, EV_LOOP_MODE_DEFAULT,
+                              EV_INFINITE_TIMEOUT),
+                  0);
+    ASSERT_EQ_SIZE(g_test_2f7b.cnt_wcb, TEST_2f7b_FRAME_NUM);
+
+    /* Frames are all pending, and read one by one */
+    _test_2f7b_read_next();
+    ASSERT_EQ_INT(ev_loop_run(g_test_2f7b.loop, EV_LOOP_MODE_DEFAULT,
+                              EV_INFINITE_TIMEOUT),
+                  0);
+    ASSERT_EQ_SIZE(g_test_2f7b.cnt_rcb, TEST_2f7b_FRAME_NUM);
+}
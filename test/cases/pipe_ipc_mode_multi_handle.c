@@ -0,0 +1,231 @@
+#include "ev.h"
+#include "test.h"
+#include "utils/sockpair.h"
+#include <string.h>
+
+#define TEST_4b8e_HANDLE_NUM 8
+
+struct test_4b8e
+{
+    ev_loop_t *loop;
+    ev_pipe_t *s_pipe;
+    ev_pipe_t *c_pipe;
+
+    ev_tcp_t *s_tcp[TEST_4b8e_HANDLE_NUM]; /**< Transferred to peer */
+    ev_tcp_t *c_tcp[TEST_4b8e_HANDLE_NUM];
+    ev_tcp_t *d_tcp[TEST_4b8e_HANDLE_NUM]; /**< Receive transferred handles */
+
+    ev_pipe_read_req_t r_req[2];
+    char               rdata[2][16];
+    uint8_t            tcp_rdata[TEST_4b8e_HANDLE_NUM];
+
+    size_t cnt_pipe_rcb;
+    size_t cnt_tcp_rcb;
+    size_t cnt_discard;
+};
+
+struct test_4b8e g_test_4b8e;
+
+static void _test_4b8e_on_write(ev_pipe_t *pipe, ssize_t size, void *arg)
+{
+    (void)pipe;
+    (void)arg;
+    ASSERT_EQ_SSIZE(size, 5);
+}
+
+static void _test_4b8e_on_read(ev_pipe_read_req_t *req, ssize_t size)
+{
+    size_t i;
+    ASSERT_EQ_SSIZE(size, 5);
+
+    if (g_test_4b8e.cnt_pipe_rcb++ != 0)
+    {
+        /* Following frame carries no handle */
+        ASSERT_EQ_PTR(req, &g_test_4b8e.r_req[1]);
+        ASSERT_EQ_SIZE(req->handle.num, 0);
+        ASSERT_EQ_INT(ev_pipe_accept(g_test_4b8e.c_pipe, req, EV_ROLE_EV_TCP,
+                                     g_test_4b8e.d_tcp[0]),
+                      EV_ENOENT);
+        return;
+    }
+
+    ASSERT_EQ_PTR(req, &g_test_4b8e.r_req[0]);
+    ASSERT_EQ_SIZE(req->handle.num, TEST_4b8e_HANDLE_NUM);
+    for (i = 0; i < TEST_4b8e_HANDLE_NUM; i++)
+    {
+        ASSERT_EQ_INT(ev_pipe_accept(g_test_4b8e.c_pipe, req, EV_ROLE_EV_TCP,
+                                     g_test_4b8e.d_tcp[i]),
+                      0);
+    }
+    ASSERT_EQ_INT(ev_pipe_accept(g_test_4b8e.c_pipe, req, EV_ROLE_EV_TCP,
+                                 g_test_4b8e.d_tcp[0]),
+                  EV_ENOENT);
+}
+
+static void _test_4b8e_on_read_discard(ev_pipe_read_req_t *req, ssize_t size)
+{
+    ASSERT_EQ_SSIZE(size, 5);
+    ASSERT_EQ_SIZE(req->handle.num, TEST_4b8e_HANDLE_NUM);
+
+    /* Failed accept leaves the handle in request */
+    ASSERT_EQ_INT(ev_pipe_accept(g_test_4b8e.c_pipe, req, EV_ROLE_EV_PIPE,
+                                 g_test_4b8e.d_tcp[0]),
+                  EV_EINVAL);
+    ASSERT_EQ_SIZE(req->handle.pos, 0);
+    ASSERT_EQ_INT(ev_pipe_accept(g_test_4b8e.c_pipe, req, EV_ROLE_EV_TCP,
+                                 g_test_4b8e.d_tcp[0]),
+                  0);
+
+    /* Rest of handles are closed */
+    ev_pipe_discard(req);
+    ASSERT_EQ_SIZE(req->handle.pos, TEST_4b8e_HANDLE_NUM);
+    ASSERT_EQ_INT(ev_pipe_accept(g_test_4b8e.c_pipe, req, EV_ROLE_EV_TCP,
+                                 g_test_4b8e.d_tcp[1]),
+                  EV_ENOENT);
+    ev_pipe_discard(req);
+    g_test_4b8e.cnt_discard++;
+}
+
+static void _test_4b8e_on_tcp_read(ev_tcp_t *sock, ssize_t size, void *arg)
+{
+    size_t idx = (size_t)(uintptr_t)arg;
+    ASSERT_EQ_PTR(sock, g_test_4b8e.c_tcp[idx]);
+    ASSERT_EQ_SSIZE(size, 1);
+
+    /* Handles are accepted in sending order */
+    ASSERT_EQ_SIZE(g_test_4b8e.tcp_rdata[idx], idx);
+    g_test_4b8e.cnt_tcp_rcb++;
+}
+
+TEST_FIXTURE_SETUP(pipe)
+{
+    size_t i;
+    memset(&g_test_4b8e, 0, sizeof(g_test_4b8e));
+
+    ASSERT_EQ_INT(ev_loop_init(&g_test_4b8e.loop), 0);
+    ASSERT_EQ_INT(ev_pipe_init(g_test_4b8e.loop, &g_test_4b8e.s_pipe, 1), 0);
+    ASSERT_EQ_INT(ev_pipe_init(g_test_4b8e.loop, &g_test_4b8e.c_pipe, 1), 0);
+
+    int          rwflags = EV_PIPE_NONBLOCK | EV_PIPE_IPC;
+    ev_os_pipe_t fds[2] = { EV_OS_PIPE_INVALID, EV_OS_PIPE_INVALID };
+    ASSERT_EQ_INT(ev_pipe_make(fds, rwflags, rwflags), 0);
+    ASSERT_EQ_INT(ev_pipe_open(g_test_4b8e.s_pipe, fds[0]), 0);
+    ASSERT_EQ_INT(ev_pipe_open(g_test_4b8e.c_pipe, fds[1]), 0);
+
+    for (i = 0; i < TEST_4b8e_HANDLE_NUM; i++)
+    {
+        ASSERT_EQ_INT(ev_tcp_init(g_test_4b8e.loop, &g_test_4b8e.s_tcp[i]), 0);
+        ASSERT_EQ_INT(ev_tcp_init(g_test_4b8e.loop, &g_test_4b8e.c_tcp[i]), 0);
+        test_sockpair(g_test_4b8e.loop, g_test_4b8e.s_tcp[i],
+                      g_test_4b8e.c_tcp[i]);
+        ASSERT_EQ_INT(ev_tcp_init(g_test_4b8e.loop, &g_test_4b8e.d_tcp[i]), 0);
+    }
+}
+
+TEST_FIXTURE_TEARDOWN(pipe)
+{
+    size_t i;
+    ev_pipe_exit(g_test_4b8e.s_pipe, NULL, NULL);
+    ev_pipe_exit(g_test_4b8e.c_pipe, NULL, NULL);
+    for (i = 0; i < TEST_4b8e_HANDLE_NUM; i++)
+    {
+        ev_tcp_exit(g_test_4b8e.s_tcp[i], NULL, NULL);
+        ev_tcp_exit(g_test_4b8e.c_tcp[i], NULL, NULL);
+        ev_tcp_exit(g_test_4b8e.d_tcp[i], NULL, NULL);
+    }
+    ASSERT_EQ_INT(ev_loop_run(g_test_4b8e.loop, EV_LOOP_MODE_DEFAULT,
+                              EV_INFINITE_TIMEOUT),
+                  0);
+    ASSERT_EQ_INT(ev_loop_exit(g_test_4b8e.loop), 0);
+}
+
+TEST_F(pipe, ipc_mode_multi_handle)
+{
+    size_t   i;
+    void    *handles[EV_PIPE_IPC_HANDLE_MAX + 1];
+    ev_buf_t buf = ev_buf_make("multi", 5);
+    for (i = 0; i < ARRAY_SIZE(handles); i++)
+    {
+        handles[i] = g_test_4b8e.s_tcp[i % TEST_4b8e_HANDLE_NUM];
+    }
+
+    ASSERT_EQ_INT(ev_pipe_write_handles(g_test_4b8e.s_pipe, &buf, 1,
+                                        EV_ROLE_EV_TCP, handles,
+                                        ARRAY_SIZE(handles),
+                                        _test_4b8e_on_write, NULL),
+                  EV_E2BIG);
+
+    int ret = ev_pipe_write_handles(g_test_4b8e.s_pipe, &buf, 1,
+                                    EV_ROLE_EV_TCP, handles,
+                                    TEST_4b8e_HANDLE_NUM, _test_4b8e_on_write,
+                                    NULL);
+#if defined(_WIN32)
+    ASSERT_EQ_INT(ret, EV_E2BIG);
+    return;
+#endif
+    ASSERT_EQ_INT(ret, 0);
+    ASSERT_EQ_INT(ev_pipe_write(g_test_4b8e.s_pipe, &buf, 1,
+                                _test_4b8e_on_write, NULL),
+                  0);
+
+    for (i = 0; i < ARRAY_SIZE(g_test_4b8e.r_req); i++)
+    {
+        ev_buf_t rbuf =
+            ev_buf_make(g_test_4b8e.rdata[i], sizeof(g_test_4b8e.rdata[i]));
+        ASSERT_EQ_INT(ev_pipe_read(g_test_4b8e.c_pipe, &g_test_4b8e.r_req[i],
+                                   &rbuf, 1, _test_4b8e_on_read),
+                      0);
+    }
+    ASSERT_EQ_INT(ev_loop_run(g_test_4b8e.loop, EV_LOOP_MODE_DEFAULT,
+                              EV_INFINITE_TIMEOUT),
+                  0);
+    ASSERT_EQ_SIZE(g_test_4b8e.cnt_pipe_rcb, 2);
+
+    /* Each accepted socket talks to the peer of the one sent at same index */
+    for (i = 0; i < TEST_4b8e_HANDLE_NUM; i++)
+    {
+        uint8_t  val = (uint8_t)i;
+        ev_buf_t wbuf = ev_buf_make(&val, 1);
+        ASSERT_EQ_SSIZE(ev_tcp_try_write(g_test_4b8e.d_tcp[i], &wbuf, 1), 1);
+
+        ev_buf_t rbuf = ev_buf_make(&g_test_4b8e.tcp_rdata[i], 1);
+        ASSERT_EQ_INT(ev_tcp_read(g_test_4b8e.c_tcp[i], &rbuf, 1,
+                                  _test_4b8e_on_tcp_read, (void *)(uintptr_t)i),
+                      0);
+    }
+    ASSERT_EQ_INT(ev_loop_run(g_test_4b8e.loop, EV_LOOP_MODE_DEFAULT,
+                              EV_INFINITE_TIMEOUT),
+                  0);
+    ASSERT_EQ_SIZE(g_test_4b8e.cnt_tcp_rcb, TEST_4b8e_HANDLE_NUM);
+}
+
+TEST_F(pipe, ipc_mode_multi_handle_discard)
+{
+    size_t   i;
+    void    *handles[TEST_4b8e_HANDLE_NUM];
+    ev_buf_t buf = ev_buf_make("multi", 5);
+    for (i = 0; i < ARRAY_SIZE(handles); i++)
+    {
+        handles[i] = g_test_4b8e.s_tcp[i];
+    }
+
+    int ret = ev_pipe_write_handles(g_test_4b8e.s_pipe, &buf, 1,
+                                    EV_ROLE_EV_TCP, handles,
+                                    ARRAY_SIZE(handles), _test_4b8e_on_write,
+                                    NULL);
+#if defined(_WIN32)
+    ASSERT_EQ_INT(ret, EV_E2BIG);
+    return;
+#endif
+    ASSERT_EQ_INT(ret, 0);
+
+    ev_buf_t rbuf =
+        ev_buf_make(g_test_4b8e.rdata[0], sizeof(g_test_4b8e.rdata[0]));
+    ASSERT_EQ_INT(ev_pipe_read(g_test_4b8e.c_pipe, &g_test_4b8e.r_req[0], &rbuf,
+                               1, _test_4b8e_on_read_discard),
+                  0);
+    ASSERT_EQ_INT(ev_loop_run(g_test_4b8e.loop, EV_LOOP_MODE_DEFAULT,
+                              EV_INFINITE_TIMEOUT),
+                  0);
+    ASSERT_EQ_SIZE(g_test_4b8e.cnt_discard, 1);
+}
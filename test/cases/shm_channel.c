@@ -0,0 +1,247 @@
+#include "ev.h"
+#include "test.h"
+#include <string.h>
+
+#if !defined(_WIN32)
+#include <sys/mman.h>
+#endif
+
+#define TEST_6d1e_KEY      "/6d1e0c4a"
+#define TEST_6d1e_MSG_NUM  1000
+#define TEST_6d1e_MSG_SIZE 100
+
+struct test_6d1e
+{
+    ev_loop_t        *loop;
+    ev_pipe_t        *s_pipe;
+    ev_pipe_t        *c_pipe;
+    ev_shm_channel_t *receiver;
+    ev_shm_channel_t *sender;
+
+    ev_pipe_read_req_t r_req;
+    uint8_t            rdata[16];
+    uint8_t            wdata[TEST_6d1e_MSG_SIZE];
+
+    int    cnt_accept;
+    size_t cnt_recv;
+    size_t cnt_again;
+    int    cnt_broken;
+};
+
+struct test_6d1e g_test_6d1e;
+
+static void _test_6d1e_fill(uint8_t *buf, size_t idx)
+{
+    memset(buf, (int)(idx & 0xff), TEST_6d1e_MSG_SIZE);
+}
+
+static void _test_6d1e_on_recv(ev_shm_channel_t *chan, const void *data,
+                               ssize_t size, void *arg)
+{
+    uint8_t expect[TEST_6d1e_MSG_SIZE];
+    ASSERT_EQ_PTR(arg, &g_test_6d1e);
+    ASSERT_EQ_SSIZE(size, sizeof(expect));
+
+    /* Messages arrive in order */
+    _test_6d1e_fill(expect, g_test_6d1e.cnt_recv);
+    ASSERT_EQ_INT(memcmp(data, expect, sizeof(expect)), 0);
+
+    if (++g_test_6d1e.cnt_recv == TEST_6d1e_MSG_NUM)
+    {
+        ev_shm_channel_exit(chan, NULL, NULL);
+        g_test_6d1e.receiver = NULL;
+    }
+}
+
+static void _test_6d1e_on_recv_broken(ev_shm_channel_t *chan,
+                                      const void *data, ssize_t size,
+                                      void *arg)
+{
+    (void)chan;
+    (void)arg;
+    ASSERT_EQ_PTR(data, NULL);
+    ASSERT_EQ_SSIZE(size, EV_EPROTO);
+    g_test_6d1e.cnt_broken++;
+}
+
+static void _test_6d1e_on_write(ev_pipe_t *pipe, ssize_t size, void *arg)
+{
+    (void)pipe;
+    (void)arg;
+    ASSERT_EQ_SSIZE(size, 1);
+}
+
+static void _test_6d1e_on_read(ev_pipe_read_req_t *req, ssize_t size)
+{
+    ASSERT_EQ_SSIZE(size, 1);
+    ASSERT_EQ_INT(ev_pipe_accept(g_test_6d1e.c_pipe, req, EV_ROLE_EV_TCP, NULL),
+                  EV_EINVAL);
+    ASSERT_EQ_INT(ev_pipe_accept(g_test_6d1e.c_pipe, req,
+                                 EV_ROLE_EV_SHM_CHANNEL, g_test_6d1e.sender),
+                  0);
+
+    /* Handle is taken by first accept */
+    ASSERT_EQ_INT(ev_pipe_accept(g_test_6d1e.c_pipe, req,
+                                 EV_ROLE_EV_SHM_CHANNEL, g_test_6d1e.sender),
+                  EV_ENOENT);
+    g_test_6d1e.cnt_accept++;
+}
+
+/**
+ * @brief Share doorbell of receiver with sender over IPC pipe.
+ */
+static void _test_6d1e_attach(void)
+{
+    ev_buf_t buf = ev_buf_make("d", 1);
+    ASSERT_EQ_INT(ev_pipe_write_ex(g_test_6d1e.s_pipe, &buf, 1,
+                                   EV_ROLE_EV_SHM_CHANNEL, g_test_6d1e.receiver,
+                                   _test_6d1e_on_write, NULL),
+                  0);
+    buf = ev_buf_make(g_test_6d1e.rdata, sizeof(g_test_6d1e.rdata));
+    ASSERT_EQ_INT(ev_pipe_read(g_test_6d1e.c_pipe, &g_test_6d1e.r_req, &buf, 1,
+                               _test_6d1e_on_read),
+                  0);
+    while (g_test_6d1e.cnt_accept == 0)
+    {
+        ev_loop_run(g_test_6d1e.loop, EV_LOOP_MODE_NOWAIT, 0);
+    }
+}
+
+TEST_FIXTURE_SETUP(shm)
+{
+    memset(&g_test_6d1e, 0, sizeof(g_test_6d1e));
+    ASSERT_EQ_INT(ev_loop_init(&g_test_6d1e.loop), 0);
+    ASSERT_EQ_INT(ev_pipe_init(g_test_6d1e.loop, &g_test_6d1e.s_pipe, 1), 0);
+    ASSERT_EQ_INT(ev_pipe_init(g_test_6d1e.loop, &g_test_6d1e.c_pipe, 1), 0);
+
+    int          rwflags = EV_PIPE_NONBLOCK | EV_PIPE_IPC;
+    ev_os_pipe_t fds[2] = { EV_OS_PIPE_INVALID, EV_OS_PIPE_INVALID };
+    ASSERT_EQ_INT(ev_pipe_make(fds, rwflags, rwflags), 0);
+    ASSERT_EQ_INT(ev_pipe_open(g_test_6d1e.s_pipe, fds[0]), 0);
+    ASSERT_EQ_INT(ev_pipe_open(g_test_6d1e.c_pipe, fds[1]), 0);
+
+#if !defined(_WIN32)
+    /* Left by a crashed run */
+    shm_unlink(TEST_6d1e_KEY);
+#endif
+}
+
+TEST_FIXTURE_TEARDOWN(shm)
+{
+    if (g_test_6d1e.receiver != NULL)
+    {
+        ev_shm_channel_exit(g_test_6d1e.receiver, NULL, NULL);
+    }
+    if (g_test_6d1e.sender != NULL)
+    {
+        ev_shm_channel_exit(g_test_6d1e.sender, NULL, NULL);
+    }
+    ev_pipe_exit(g_test_6d1e.s_pipe, NULL, NULL);
+    ev_pipe_exit(g_test_6d1e.c_pipe, NULL, NULL);
+    ASSERT_EQ_INT(ev_loop_run(g_test_6d1e.loop, EV_LOOP_MODE_DEFAULT,
+                              EV_INFINITE_TIMEOUT),
+                  0);
+    ASSERT_EQ_INT(ev_loop_exit(g_test_6d1e.loop), 0);
+}
+
+TEST_F(shm, channel)
+{
+    int ret = ev_shm_channel_init(g_test_6d1e.loop, &g_test_6d1e.receiver,
+                                  TEST_6d1e_KEY, 1000, _test_6d1e_on_recv,
+                                  &g_test_6d1e);
+#if defined(_WIN32)
+    ASSERT_EQ_INT(ret, EV_ENOSYS);
+    return;
+#endif
+    ASSERT_EQ_INT(ret, 0);
+    ASSERT_EQ_INT(ev_shm_channel_open(g_test_6d1e.loop, &g_test_6d1e.sender,
+                                      TEST_6d1e_KEY),
+                  0);
+
+    /* Only sender can send, and only after doorbell is attached */
+    ASSERT_EQ_INT(ev_shm_channel_send(g_test_6d1e.receiver, "", 0), EV_EINVAL);
+    ASSERT_EQ_INT(ev_shm_channel_send(g_test_6d1e.sender, "", 0), EV_ENOTCONN);
+
+    /* Share doorbell over IPC pipe */
+    ev_buf_t buf = ev_buf_make("d", 1);
+    ASSERT_EQ_INT(ev_pipe_write_ex(g_test_6d1e.s_pipe, &buf, 1,
+                                   EV_ROLE_EV_SHM_CHANNEL, g_test_6d1e.sender,
+                                   _test_6d1e_on_write, NULL),
+                  EV_EINVAL);
+    _test_6d1e_attach();
+
+    /* Ring is 1024 bytes, half of it is the limit of one message */
+    ASSERT_EQ_INT(ev_shm_channel_send(g_test_6d1e.sender, g_test_6d1e.rdata,
+                                      600),
+                  EV_E2BIG);
+
+    size_t idx = 0;
+    while (idx < TEST_6d1e_MSG_NUM)
+    {
+        _test_6d1e_fill(g_test_6d1e.wdata, idx);
+        ret = ev_shm_channel_send(g_test_6d1e.sender, g_test_6d1e.wdata,
+                                  sizeof(g_test_6d1e.wdata));
+        if (ret == EV_EAGAIN)
+        {
+            g_test_6d1e.cnt_again++;
+            ev_loop_run(g_test_6d1e.loop, EV_LOOP_MODE_NOWAIT, 0);
+            continue;
+        }
+        ASSERT_EQ_INT(ret, 0);
+        idx++;
+    }
+    ASSERT_EQ_INT(ev_loop_run(g_test_6d1e.loop, EV_LOOP_MODE_DEFAULT,
+                              EV_INFINITE_TIMEOUT),
+                  0);
+
+    ASSERT_EQ_SIZE(g_test_6d1e.cnt_recv, TEST_6d1e_MSG_NUM);
+    ASSERT_GT_SIZE(g_test_6d1e.cnt_again, 0);
+}
+
+TEST_F(shm, channel_broken)
+{
+    int ret = ev_shm_channel_init(g_test_6d1e.loop, &g_test_6d1e.receiver,
+                                  TEST_6d1e_KEY, 1000,
+                                  _test_6d1e_on_recv_broken, &g_test_6d1e);
+#if defined(_WIN32)
+    ASSERT_EQ_INT(ret, EV_ENOSYS);
+    return;
+#endif
+    ASSERT_EQ_INT(ret, 0);
+    ASSERT_EQ_INT(ev_shm_channel_open(g_test_6d1e.loop, &g_test_6d1e.sender,
+                                      TEST_6d1e_KEY),
+                  0);
+    _test_6d1e_attach();
+
+    memset(g_test_6d1e.wdata, 0xa5, sizeof(g_test_6d1e.wdata));
+    ASSERT_EQ_INT(ev_shm_channel_send(g_test_6d1e.sender, g_test_6d1e.wdata,
+                                      sizeof(g_test_6d1e.wdata)),
+                  0);
+
+    /* Peer overwrites length prefix of the message */
+    ev_shmem_t *shm;
+    ASSERT_EQ_INT(ev_shmem_open(&shm, TEST_6d1e_KEY), 0);
+    uint8_t *addr = ev_shmem_addr(shm);
+    size_t   pos = sizeof(uint32_t);
+    while (memcmp(addr + pos, g_test_6d1e.wdata, sizeof(g_test_6d1e.wdata)) !=
+           0)
+    {
+        pos++;
+        ASSERT_LE_SIZE(pos + sizeof(g_test_6d1e.wdata), ev_shmem_size(shm));
+    }
+    uint32_t size = 0x10000;
+    memcpy(addr + pos - sizeof(size), &size, sizeof(size));
+    ev_shmem_exit(shm);
+
+    while (g_test_6d1e.cnt_broken == 0)
+    {
+        ev_loop_run(g_test_6d1e.loop, EV_LOOP_MODE_NOWAIT, 0);
+    }
+
+    /* Nothing more is received from a broken channel */
+    ASSERT_EQ_INT(ev_shm_channel_send(g_test_6d1e.sender, g_test_6d1e.wdata,
+                                      sizeof(g_test_6d1e.wdata)),
+                  0);
+    ev_loop_run(g_test_6d1e.loop, EV_LOOP_MODE_NOWAIT, 0);
+    ASSERT_EQ_INT(g_test_6d1e.cnt_broken, 1);
+}
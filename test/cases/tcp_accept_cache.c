@@ -0,0 +1,103 @@
+#include "ev.h"
+#include "test.h"
+#include <string.h>
+
+struct test_3c7e
+{
+    ev_loop_t *loop;
+    ev_tcp_t  *l_sock;
+    ev_tcp_t  *s_sock;
+    ev_tcp_t  *c_sock;
+    int        cnt_accept;
+    int        cnt_connect;
+};
+
+struct test_3c7e g_test_3c7e;
+
+static void _test_3c7e_on_accept(ev_tcp_t *lisn, ev_tcp_t *conn, int stat,
+                                 void *arg)
+{
+    (void)lisn;
+    (void)arg;
+    ASSERT_EQ_INT(stat, 0);
+    g_test_3c7e.cnt_accept++;
+    ev_tcp_exit(conn, NULL, NULL);
+}
+
+static void _test_3c7e_on_connect(ev_tcp_t *sock, int stat, void *arg)
+{
+    (void)arg;
+    ASSERT_EQ_INT(stat, 0);
+    g_test_3c7e.cnt_connect++;
+    ev_tcp_exit(sock, NULL, NULL);
+}
+
+TEST_FIXTURE_SETUP(tcp)
+{
+    memset(&g_test_3c7e, 0, sizeof(g_test_3c7e));
+    ASSERT_EQ_INT(ev_loop_init(&g_test_3c7e.loop), 0);
+    ASSERT_EQ_INT(ev_tcp_init(g_test_3c7e.loop, &g_test_3c7e.l_sock), 0);
+}
+
+TEST_FIXTURE_TEARDOWN(tcp)
+{
+    ASSERT_EQ_INT(ev_loop_run(g_test_3c7e.loop, EV_LOOP_MODE_DEFAULT,
+                              EV_INFINITE_TIMEOUT),
+                  0);
+    ASSERT_EQ_INT(ev_loop_exit(g_test_3c7e.loop), 0);
+}
+
+TEST_F(tcp, accept_cache)
+{
+    struct sockaddr_storage addr;
+    size_t                  addr_sz = sizeof(addr);
+
+    ASSERT_EQ_INT(ev_ip_addr("127.0.0.1", 0, (struct sockaddr *)&addr,
+                             sizeof(addr)),
+                  0);
+    ASSERT_EQ_INT(
+        ev_tcp_bind(g_test_3c7e.l_sock, (struct sockaddr *)&addr, sizeof(addr)),
+        0);
+
+    /* Only a listen socket hands out handles */
+    ASSERT_EQ_INT(ev_tcp_init_accept(g_test_3c7e.l_sock, &g_test_3c7e.s_sock),
+                  EV_EINVAL);
+    ASSERT_EQ_INT(ev_tcp_listen(g_test_3c7e.l_sock, 16), 0);
+    ASSERT_EQ_INT(ev_tcp_getsockname(g_test_3c7e.l_sock,
+                                     (struct sockaddr *)&addr, &addr_sz),
+                  0);
+    ASSERT_EQ_INT(ev_tcp_accept_cache(g_test_3c7e.l_sock, 1), 0);
+
+    ASSERT_EQ_INT(ev_tcp_init_accept(g_test_3c7e.l_sock, &g_test_3c7e.s_sock),
+                  0);
+    ASSERT_EQ_INT(ev_tcp_accept(g_test_3c7e.l_sock, g_test_3c7e.s_sock,
+                                _test_3c7e_on_accept, NULL),
+                  0);
+
+    ASSERT_EQ_INT(ev_tcp_init(g_test_3c7e.loop, &g_test_3c7e.c_sock), 0);
+    ASSERT_EQ_INT(ev_tcp_connect(g_test_3c7e.c_sock, (struct sockaddr *)&addr,
+                                 addr_sz, _test_3c7e_on_connect, NULL),
+                  0);
+
+    while (g_test_3c7e.cnt_accept == 0 || g_test_3c7e.cnt_connect == 0)
+    {
+        ev_loop_run(g_test_3c7e.loop, EV_LOOP_MODE_ONCE, EV_INFINITE_TIMEOUT);
+    }
+    /* Make sure the endgame of both handles is done */
+    ev_loop_run(g_test_3c7e.loop, EV_LOOP_MODE_NOWAIT, 0);
+
+    /* The closed handle is handed out again */
+    ev_tcp_t *conn = NULL;
+    ASSERT_EQ_INT(ev_tcp_init_accept(g_test_3c7e.l_sock, &conn), 0);
+    ASSERT_EQ_PTR(conn, g_test_3c7e.s_sock);
+
+    /* Cache is empty, so a new handle is allocated */
+    ev_tcp_t *conn2 = NULL;
+    ASSERT_EQ_INT(ev_tcp_init_accept(g_test_3c7e.l_sock, &conn2), 0);
+    ASSERT_NE_PTR(conn2, conn);
+
+    /* Connection handles outlive the listen socket */
+    ev_tcp_exit(g_test_3c7e.l_sock, NULL, NULL);
+    ev_tcp_exit(conn, NULL, NULL);
+    ev_tcp_exit(conn2, NULL, NULL);
+}
@@ -0,0 +1,169 @@
+#include "ev.h"
+#include "test.h"
+#include <string.h>
+#if !defined(_WIN32)
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+#define TEST_d2a9_CLIENT_CNT 2
+#define TEST_d2a9_FILL_MAX   64
+
+struct test_d2a9
+{
+    ev_loop_t *loop;
+    ev_tcp_t  *l_sock;
+    ev_tcp_t  *c_sock[TEST_d2a9_CLIENT_CNT];
+    int        cnt_emfile;
+    int        cnt_connect;
+
+#if !defined(_WIN32)
+    struct rlimit limit;   /**< Original fd limit */
+    int           limited; /**< Whether \p limit need to be restored */
+    int           fill[TEST_d2a9_FILL_MAX];
+    size_t        fill_num;
+#endif
+};
+
+struct test_d2a9 g_test_d2a9;
+
+static void _test_d2a9_on_connection(ev_tcp_t *lisn, ev_tcp_t *conn, int stat,
+                                     void *arg)
+{
+    (void)lisn;
+    (void)arg;
+    ASSERT_EQ_PTR(conn, NULL);
+    ASSERT_EQ_INT(stat, EV_EMFILE);
+    g_test_d2a9.cnt_emfile++;
+}
+
+static void _test_d2a9_on_connect(ev_tcp_t *sock, int stat, void *arg)
+{
+    (void)sock;
+    (void)arg;
+    ASSERT_EQ_INT(stat, 0);
+    g_test_d2a9.cnt_connect++;
+}
+
+#if !defined(_WIN32)
+static void _test_d2a9_restore_fd_limit(void)
+{
+    size_t i;
+    for (i = 0; i < g_test_d2a9.fill_num; i++)
+    {
+        close(g_test_d2a9.fill[i]);
+    }
+    g_test_d2a9.fill_num = 0;
+
+    if (g_test_d2a9.limited)
+    {
+        ASSERT_EQ_INT(setrlimit(RLIMIT_NOFILE, &g_test_d2a9.limit), 0);
+        g_test_d2a9.limited = 0;
+    }
+}
+
+/**
+ * @brief Lower fd limit and take every fd below it.
+ */
+static void _test_d2a9_exhaust_fd(void)
+{
+    int fd = dup(0);
+    ASSERT_NE_INT(fd, -1);
+    close(fd);
+
+    ASSERT_EQ_INT(getrlimit(RLIMIT_NOFILE, &g_test_d2a9.limit), 0);
+    struct rlimit limit = g_test_d2a9.limit;
+    limit.rlim_cur = (rlim_t)fd + TEST_d2a9_FILL_MAX / 2;
+    ASSERT_EQ_INT(setrlimit(RLIMIT_NOFILE, &limit), 0);
+    g_test_d2a9.limited = 1;
+
+    while ((fd = dup(0)) != -1)
+    {
+        ASSERT_LT_SIZE(g_test_d2a9.fill_num, TEST_d2a9_FILL_MAX);
+        g_test_d2a9.fill[g_test_d2a9.fill_num++] = fd;
+    }
+}
+#endif
+
+TEST_FIXTURE_SETUP(tcp)
+{
+    size_t i;
+    memset(&g_test_d2a9, 0, sizeof(g_test_d2a9));
+    ASSERT_EQ_INT(ev_loop_init(&g_test_d2a9.loop), 0);
+    ASSERT_EQ_INT(ev_tcp_init(g_test_d2a9.loop, &g_test_d2a9.l_sock), 0);
+    for (i = 0; i < TEST_d2a9_CLIENT_CNT; i++)
+    {
+        ASSERT_EQ_INT(ev_tcp_init(g_test_d2a9.loop, &g_test_d2a9.c_sock[i]), 0);
+    }
+}
+
+TEST_FIXTURE_TEARDOWN(tcp)
+{
+    size_t i;
+#if !defined(_WIN32)
+    _test_d2a9_restore_fd_limit();
+#endif
+
+    ev_tcp_exit(g_test_d2a9.l_sock, NULL, NULL);
+    for (i = 0; i < TEST_d2a9_CLIENT_CNT; i++)
+    {
+        ev_tcp_exit(g_test_d2a9.c_sock[i], NULL, NULL);
+    }
+    ASSERT_EQ_INT(ev_loop_run(g_test_d2a9.loop, EV_LOOP_MODE_DEFAULT,
+                              EV_INFINITE_TIMEOUT),
+                  0);
+    ASSERT_EQ_INT(ev_loop_exit(g_test_d2a9.loop), 0);
+}
+
+TEST_F(tcp, accept_emfile)
+{
+#if defined(_WIN32)
+    return;
+#else
+    size_t                  i;
+    struct sockaddr_storage addr;
+    size_t                  addr_sz = sizeof(addr);
+
+    ASSERT_EQ_INT(ev_ip_addr("127.0.0.1", 0, (struct sockaddr *)&addr,
+                             sizeof(addr)),
+                  0);
+    ASSERT_EQ_INT(
+        ev_tcp_bind(g_test_d2a9.l_sock, (struct sockaddr *)&addr, sizeof(addr)),
+        0);
+    ASSERT_EQ_INT(ev_tcp_listen(g_test_d2a9.l_sock, TEST_d2a9_CLIENT_CNT), 0);
+    ASSERT_EQ_INT(ev_tcp_getsockname(g_test_d2a9.l_sock,
+                                     (struct sockaddr *)&addr, &addr_sz),
+                  0);
+
+    /* Connections wait in backlog until accepting starts */
+    for (i = 0; i < TEST_d2a9_CLIENT_CNT; i++)
+    {
+        ASSERT_EQ_INT(ev_tcp_connect(g_test_d2a9.c_sock[i],
+                                     (struct sockaddr *)&addr, addr_sz,
+                                     _test_d2a9_on_connect, NULL),
+                      0);
+    }
+    while (g_test_d2a9.cnt_connect < TEST_d2a9_CLIENT_CNT)
+    {
+        ev_loop_run(g_test_d2a9.loop, EV_LOOP_MODE_NOWAIT, 0);
+    }
+
+    _test_d2a9_exhaust_fd();
+    ASSERT_EQ_INT(ev_tcp_accept_start(g_test_d2a9.l_sock, 0,
+                                      _test_d2a9_on_connection, &g_test_d2a9),
+                  0);
+    while (g_test_d2a9.cnt_emfile == 0)
+    {
+        ev_loop_run(g_test_d2a9.loop, EV_LOOP_MODE_NOWAIT, 0);
+    }
+
+    /* Pending connections are dropped, so the listener does not spin */
+    for (i = 0; i < 100; i++)
+    {
+        ev_loop_run(g_test_d2a9.loop, EV_LOOP_MODE_NOWAIT, 0);
+    }
+    ASSERT_LE_INT(g_test_d2a9.cnt_emfile, TEST_d2a9_CLIENT_CNT);
+
+    _test_d2a9_restore_fd_limit();
+#endif
+}
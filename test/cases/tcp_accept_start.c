@@ -0,0 +1,102 @@
+#include "ev.h"
+#include "test.h"
+#include <string.h>
+
+#define TEST_d93a_CLIENT_CNT 8
+
+struct test_d93a
+{
+    ev_loop_t *loop;
+    ev_tcp_t  *l_sock;
+    ev_tcp_t  *c_sock[TEST_d93a_CLIENT_CNT];
+    int        cnt_accept;
+    int        cnt_connect;
+};
+
+struct test_d93a g_test_d93a;
+
+static void _test_d93a_on_connection(ev_tcp_t *lisn, ev_tcp_t *conn, int stat,
+                                     void *arg)
+{
+    ASSERT_EQ_PTR(arg, &g_test_d93a);
+    ASSERT_EQ_INT(stat, 0);
+    ASSERT_NE_PTR(conn, NULL);
+    g_test_d93a.cnt_accept++;
+    ev_tcp_exit(conn, NULL, NULL);
+
+    if (g_test_d93a.cnt_accept == TEST_d93a_CLIENT_CNT)
+    {
+        ASSERT_EQ_INT(ev_tcp_accept_stop(lisn), 0);
+    }
+}
+
+static void _test_d93a_on_connect(ev_tcp_t *sock, int stat, void *arg)
+{
+    (void)arg;
+    ASSERT_EQ_INT(stat, 0);
+    g_test_d93a.cnt_connect++;
+    ev_tcp_exit(sock, NULL, NULL);
+}
+
+TEST_FIXTURE_SETUP(tcp)
+{
+    memset(&g_test_d93a, 0, sizeof(g_test_d93a));
+    ASSERT_EQ_INT(ev_loop_init(&g_test_d93a.loop), 0);
+    ASSERT_EQ_INT(ev_tcp_init(g_test_d93a.loop, &g_test_d93a.l_sock), 0);
+}
+
+TEST_FIXTURE_TEARDOWN(tcp)
+{
+    ev_tcp_exit(g_test_d93a.l_sock, NULL, NULL);
+    ASSERT_EQ_INT(ev_loop_run(g_test_d93a.loop, EV_LOOP_MODE_DEFAULT,
+                              EV_INFINITE_TIMEOUT),
+                  0);
+    ASSERT_EQ_INT(ev_loop_exit(g_test_d93a.loop), 0);
+}
+
+TEST_F(tcp, accept_start)
+{
+    int                     i;
+    struct sockaddr_storage addr;
+    size_t                  addr_sz = sizeof(addr);
+
+    ASSERT_EQ_INT(ev_ip_addr("127.0.0.1", 0, (struct sockaddr *)&addr,
+                             sizeof(addr)),
+                  0);
+    ASSERT_EQ_INT(
+        ev_tcp_bind(g_test_d93a.l_sock, (struct sockaddr *)&addr, sizeof(addr)),
+        0);
+
+    /* Not listening yet */
+    ASSERT_EQ_INT(ev_tcp_accept_start(g_test_d93a.l_sock, 0,
+                                      _test_d93a_on_connection, &g_test_d93a),
+                  EV_EINVAL);
+
+    ASSERT_EQ_INT(ev_tcp_listen(g_test_d93a.l_sock, TEST_d93a_CLIENT_CNT), 0);
+    ASSERT_EQ_INT(ev_tcp_getsockname(g_test_d93a.l_sock,
+                                     (struct sockaddr *)&addr, &addr_sz),
+                  0);
+    ASSERT_EQ_INT(ev_tcp_accept_start(g_test_d93a.l_sock, 4,
+                                      _test_d93a_on_connection, &g_test_d93a),
+                  0);
+    ASSERT_EQ_INT(ev_tcp_accept_start(g_test_d93a.l_sock, 4,
+                                      _test_d93a_on_connection, &g_test_d93a),
+                  EV_EALREADY);
+
+    for (i = 0; i < TEST_d93a_CLIENT_CNT; i++)
+    {
+        ASSERT_EQ_INT(ev_tcp_init(g_test_d93a.loop, &g_test_d93a.c_sock[i]), 0);
+        ASSERT_EQ_INT(ev_tcp_connect(g_test_d93a.c_sock[i],
+                                     (struct sockaddr *)&addr, addr_sz,
+                                     _test_d93a_on_connect, NULL),
+                      0);
+    }
+
+    while (g_test_d93a.cnt_accept < TEST_d93a_CLIENT_CNT ||
+           g_test_d93a.cnt_connect < TEST_d93a_CLIENT_CNT)
+    {
+        ev_loop_run(g_test_d93a.loop, EV_LOOP_MODE_ONCE, EV_INFINITE_TIMEOUT);
+    }
+
+    ASSERT_EQ_INT(g_test_d93a.cnt_accept, TEST_d93a_CLIENT_CNT);
+}
@@ -0,0 +1,139 @@
+#include "ev.h"
+#include "test.h"
+#include "utils/sockpair.h"
+#include <string.h>
+
+struct test_7f14
+{
+    ev_loop_t        *loop;
+    ev_tcp_t         *s_sock;
+    ev_tcp_t         *c_sock;
+    ev_tcp_t         *u_sock;
+    ev_tcp_sampler_t *sampler;
+    int               cnt_sample;
+
+    char     send_buf[4096];
+    ev_buf_t send_bufs;
+    char     recv_buf[4096];
+    ev_buf_t recv_bufs;
+    size_t   recv_pos;
+};
+
+struct test_7f14 g_test_7f14;
+
+static uint64_t _test_7f14_hist_sum(const uint64_t *hist)
+{
+    size_t   i;
+    uint64_t sum = 0;
+    for (i = 0; i < EV_TCP_INFO_HIST_SIZE; i++)
+    {
+        sum += hist[i];
+    }
+    return sum;
+}
+
+static void _test_7f14_on_write(ev_tcp_t *sock, ssize_t size, void *arg)
+{
+    (void)sock;
+    (void)arg;
+    ASSERT_EQ_SSIZE(size, sizeof(g_test_7f14.send_buf));
+}
+
+static void _test_7f14_on_read(ev_tcp_t *sock, ssize_t size, void *arg)
+{
+    (void)arg;
+    ASSERT_GT_SSIZE(size, 0);
+    g_test_7f14.recv_pos += size;
+
+    if (g_test_7f14.recv_pos == sizeof(g_test_7f14.recv_buf))
+    {
+        return;
+    }
+
+    g_test_7f14.recv_bufs =
+        ev_buf_make(g_test_7f14.recv_buf + g_test_7f14.recv_pos,
+                    sizeof(g_test_7f14.recv_buf) - g_test_7f14.recv_pos);
+    ASSERT_EQ_INT(
+        ev_tcp_read(sock, &g_test_7f14.recv_bufs, 1, _test_7f14_on_read, NULL),
+        0);
+}
+
+static void _test_7f14_on_sample(ev_tcp_sampler_t         *sampler,
+                                 const ev_tcp_info_stat_t *stat, void *arg)
+{
+    ASSERT_EQ_PTR(arg, &g_test_7f14);
+    ASSERT_EQ_UINT64(stat->sock_cnt, 2);
+    ASSERT_EQ_UINT64(_test_7f14_hist_sum(stat->rtt), 2);
+
+    if (++g_test_7f14.cnt_sample == 2)
+    {
+        ev_tcp_sampler_exit(sampler);
+    }
+}
+
+TEST_FIXTURE_SETUP(tcp)
+{
+    memset(&g_test_7f14, 0, sizeof(g_test_7f14));
+    ASSERT_EQ_INT(ev_loop_init(&g_test_7f14.loop), 0);
+    ASSERT_EQ_INT(ev_tcp_init(g_test_7f14.loop, &g_test_7f14.s_sock), 0);
+    ASSERT_EQ_INT(ev_tcp_init(g_test_7f14.loop, &g_test_7f14.c_sock), 0);
+    ASSERT_EQ_INT(ev_tcp_init(g_test_7f14.loop, &g_test_7f14.u_sock), 0);
+    test_sockpair(g_test_7f14.loop, g_test_7f14.s_sock, g_test_7f14.c_sock);
+}
+
+TEST_FIXTURE_TEARDOWN(tcp)
+{
+    ev_tcp_exit(g_test_7f14.s_sock, NULL, NULL);
+    ev_tcp_exit(g_test_7f14.c_sock, NULL, NULL);
+    ev_tcp_exit(g_test_7f14.u_sock, NULL, NULL);
+    ASSERT_EQ_INT(ev_loop_run(g_test_7f14.loop, EV_LOOP_MODE_DEFAULT,
+                              EV_INFINITE_TIMEOUT),
+                  0);
+    ASSERT_EQ_INT(ev_loop_exit(g_test_7f14.loop), 0);
+}
+
+TEST_F(tcp, get_info)
+{
+    ev_tcp_info_t info;
+    int           ret = ev_tcp_get_info(g_test_7f14.s_sock, &info);
+#if defined(_WIN32)
+    ASSERT_EQ_INT(ret, EV_ENOSYS);
+    return;
+#endif
+    ASSERT_EQ_INT(ret, 0);
+    ASSERT_EQ_INT(ev_tcp_get_info(g_test_7f14.u_sock, &info), EV_ENOTCONN);
+
+    g_test_7f14.send_bufs =
+        ev_buf_make(g_test_7f14.send_buf, sizeof(g_test_7f14.send_buf));
+    ASSERT_EQ_INT(ev_tcp_write(g_test_7f14.s_sock, &g_test_7f14.send_bufs, 1,
+                               _test_7f14_on_write, NULL),
+                  0);
+    g_test_7f14.recv_bufs =
+        ev_buf_make(g_test_7f14.recv_buf, sizeof(g_test_7f14.recv_buf));
+    ASSERT_EQ_INT(ev_tcp_read(g_test_7f14.c_sock, &g_test_7f14.recv_bufs, 1,
+                              _test_7f14_on_read, NULL),
+                  0);
+    ASSERT_EQ_INT(ev_loop_run(g_test_7f14.loop, EV_LOOP_MODE_DEFAULT,
+                              EV_INFINITE_TIMEOUT),
+                  0);
+
+    ASSERT_EQ_INT(ev_tcp_get_info(g_test_7f14.s_sock, &info), 0);
+    ASSERT_GT_UINT64(info.snd_mss, 0);
+
+    /* Unconnected socket is skipped */
+    ev_tcp_info_stat_t stat;
+    ev_tcp_info_collect(g_test_7f14.loop, &stat);
+    ASSERT_EQ_UINT64(stat.sock_cnt, 2);
+    ASSERT_EQ_UINT64(_test_7f14_hist_sum(stat.snd_cwnd), 2);
+
+    ASSERT_EQ_INT(ev_tcp_sampler_init(g_test_7f14.loop, &g_test_7f14.sampler,
+                                      0, _test_7f14_on_sample, &g_test_7f14),
+                  EV_EINVAL);
+    ASSERT_EQ_INT(ev_tcp_sampler_init(g_test_7f14.loop, &g_test_7f14.sampler,
+                                      10, _test_7f14_on_sample, &g_test_7f14),
+                  0);
+    ASSERT_EQ_INT(ev_loop_run(g_test_7f14.loop, EV_LOOP_MODE_DEFAULT,
+                              EV_INFINITE_TIMEOUT),
+                  0);
+    ASSERT_EQ_INT(g_test_7f14.cnt_sample, 2);
+}
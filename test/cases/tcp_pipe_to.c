@@ -0,0 +1,156 @@
+#include "ev.h"
+#include "test.h"
+#include "utils/random.h"
+#include "utils/sockpair.h"
+#include <string.h>
+
+#define TEST_9c4a_DATA_SIZE (4 * 1024 * 1024)
+
+struct test_9c4a
+{
+    ev_loop_t *loop;
+    ev_pipe_t *pipe_r;
+    ev_pipe_t *pipe_w;
+    ev_tcp_t  *s_sock;
+    ev_tcp_t  *c_sock;
+    int        w_closed;
+
+    int      cnt_pipe;
+    int      pipe_stat;
+    uint64_t pipe_size;
+
+    uint8_t  send_data[TEST_9c4a_DATA_SIZE];
+    ev_buf_t send_buf;
+
+    uint8_t  recv_data[TEST_9c4a_DATA_SIZE];
+    ev_buf_t recv_buf;
+    size_t   recv_pos;
+};
+
+struct test_9c4a *g_test_9c4a = NULL;
+
+static void _test_9c4a_on_write(ev_pipe_t *pipe, ssize_t size, void *arg)
+{
+    (void)arg;
+    ASSERT_EQ_SSIZE(size, TEST_9c4a_DATA_SIZE);
+
+    /* Source sees end of file */
+    ev_pipe_exit(pipe, NULL, NULL);
+    g_test_9c4a->w_closed = 1;
+}
+
+static void _test_9c4a_on_pipe(void *src, void *dst, uint64_t size, int stat,
+                               void *arg)
+{
+    (void)arg;
+    ASSERT_EQ_PTR(src, g_test_9c4a->pipe_r);
+    ASSERT_EQ_PTR(dst, g_test_9c4a->s_sock);
+
+    g_test_9c4a->cnt_pipe++;
+    g_test_9c4a->pipe_stat = stat;
+    g_test_9c4a->pipe_size = size;
+}
+
+static void _test_9c4a_on_read(ev_tcp_t *sock, ssize_t size, void *arg)
+{
+    (void)arg;
+    ASSERT_GT_SSIZE(size, 0);
+    g_test_9c4a->recv_pos += size;
+
+    if (g_test_9c4a->recv_pos == sizeof(g_test_9c4a->recv_data))
+    {
+        return;
+    }
+
+    g_test_9c4a->recv_buf =
+        ev_buf_make(g_test_9c4a->recv_data + g_test_9c4a->recv_pos,
+                    sizeof(g_test_9c4a->recv_data) - g_test_9c4a->recv_pos);
+    ASSERT_EQ_INT(
+        ev_tcp_read(sock, &g_test_9c4a->recv_buf, 1, _test_9c4a_on_read, NULL),
+        0);
+}
+
+TEST_FIXTURE_SETUP(tcp)
+{
+    g_test_9c4a = ev_calloc(1, sizeof(*g_test_9c4a));
+    test_random(g_test_9c4a->send_data, sizeof(g_test_9c4a->send_data));
+
+    ASSERT_EQ_INT(ev_loop_init(&g_test_9c4a->loop), 0);
+    ASSERT_EQ_INT(ev_pipe_init(g_test_9c4a->loop, &g_test_9c4a->pipe_r, 0), 0);
+    ASSERT_EQ_INT(ev_pipe_init(g_test_9c4a->loop, &g_test_9c4a->pipe_w, 0), 0);
+
+    int rwflags = EV_PIPE_READABLE | EV_PIPE_WRITABLE | EV_PIPE_NONBLOCK;
+    ev_os_pipe_t fds[2];
+    ASSERT_EQ_INT(ev_pipe_make(fds, rwflags, rwflags), 0);
+    ASSERT_EQ_INT(ev_pipe_open(g_test_9c4a->pipe_r, fds[0]), 0);
+    ASSERT_EQ_INT(ev_pipe_open(g_test_9c4a->pipe_w, fds[1]), 0);
+
+    ASSERT_EQ_INT(ev_tcp_init(g_test_9c4a->loop, &g_test_9c4a->s_sock), 0);
+    ASSERT_EQ_INT(ev_tcp_init(g_test_9c4a->loop, &g_test_9c4a->c_sock), 0);
+    test_sockpair(g_test_9c4a->loop, g_test_9c4a->s_sock, g_test_9c4a->c_sock);
+}
+
+TEST_FIXTURE_TEARDOWN(tcp)
+{
+    if (!g_test_9c4a->w_closed)
+    {
+        ev_pipe_exit(g_test_9c4a->pipe_w, NULL, NULL);
+    }
+    ev_pipe_exit(g_test_9c4a->pipe_r, NULL, NULL);
+    ev_tcp_exit(g_test_9c4a->s_sock, NULL, NULL);
+    ev_tcp_exit(g_test_9c4a->c_sock, NULL, NULL);
+    ASSERT_EQ_INT(ev_loop_run(g_test_9c4a->loop, EV_LOOP_MODE_DEFAULT,
+                              EV_INFINITE_TIMEOUT),
+                  0);
+    ASSERT_EQ_INT(ev_loop_exit(g_test_9c4a->loop), 0);
+
+    ev_free(g_test_9c4a);
+    g_test_9c4a = NULL;
+}
+
+TEST_F(tcp, pipe_to)
+{
+    ev_tcp_pipe_opts_t opts;
+    memset(&opts, 0, sizeof(opts));
+    opts.cb = _test_9c4a_on_pipe;
+
+    int ret = ev_tcp_pipe_to_ex(EV_ROLE_EV_PIPE, g_test_9c4a->pipe_r,
+                                EV_ROLE_EV_TCP, g_test_9c4a->s_sock, &opts);
+#if defined(_WIN32)
+    ASSERT_EQ_INT(ret, EV_ENOSYS);
+    return;
+#endif
+    ASSERT_EQ_INT(ret, 0);
+
+    /* Destination is owned by the pipe until it finishes */
+    ev_buf_t buf = ev_buf_make(g_test_9c4a->send_data, 1);
+    ASSERT_EQ_INT(ev_tcp_write(g_test_9c4a->s_sock, &buf, 1, NULL, NULL),
+                  EV_EBUSY);
+    ASSERT_EQ_INT(ev_tcp_pipe_to(g_test_9c4a->c_sock, g_test_9c4a->s_sock,
+                                 NULL),
+                  EV_EBUSY);
+
+    g_test_9c4a->send_buf =
+        ev_buf_make(g_test_9c4a->send_data, sizeof(g_test_9c4a->send_data));
+    ASSERT_EQ_INT(ev_pipe_write(g_test_9c4a->pipe_w, &g_test_9c4a->send_buf, 1,
+                                _test_9c4a_on_write, NULL),
+                  0);
+
+    g_test_9c4a->recv_buf = ev_buf_make(g_test_9c4a->recv_data,
+                                        sizeof(g_test_9c4a->recv_data));
+    ASSERT_EQ_INT(ev_tcp_read(g_test_9c4a->c_sock, &g_test_9c4a->recv_buf, 1,
+                              _test_9c4a_on_read, NULL),
+                  0);
+
+    ASSERT_EQ_INT(ev_loop_run(g_test_9c4a->loop, EV_LOOP_MODE_DEFAULT,
+                              EV_INFINITE_TIMEOUT),
+                  0);
+
+    ASSERT_EQ_INT(g_test_9c4a->cnt_pipe, 1);
+    ASSERT_EQ_INT(g_test_9c4a->pipe_stat, 0);
+    ASSERT_EQ_UINT64(g_test_9c4a->pipe_size, TEST_9c4a_DATA_SIZE);
+    ASSERT_EQ_SIZE(g_test_9c4a->recv_pos, sizeof(g_test_9c4a->recv_data));
+    ASSERT_EQ_INT(memcmp(g_test_9c4a->send_data, g_test_9c4a->recv_data,
+                         sizeof(g_test_9c4a->recv_data)),
+                  0);
+}
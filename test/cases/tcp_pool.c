@@ -0,0 +1,138 @@
+#include "ev.h"
+#include "test.h"
+#include <string.h>
+
+struct test_0e6b
+{
+    ev_loop_t     *loop;
+    ev_tcp_t      *l_sock;
+    ev_tcp_pool_t *pool;
+    ev_tcp_t      *conns[4];
+    int            cnt_accept;
+    int            cnt_close;
+
+    ev_tcp_t *socks[3];
+    int       cnt_acquire;
+
+    struct sockaddr_storage addr;
+    size_t                  addr_sz;
+};
+
+struct test_0e6b g_test_0e6b;
+
+static void _test_0e6b_on_connection(ev_tcp_t *lisn, ev_tcp_t *conn, int stat,
+                                     void *arg)
+{
+    (void)lisn;
+    (void)arg;
+    ASSERT_EQ_INT(stat, 0);
+    g_test_0e6b.conns[g_test_0e6b.cnt_accept++] = conn;
+}
+
+static void _test_0e6b_on_close(ev_tcp_t *sock, void *arg)
+{
+    (void)sock;
+    (void)arg;
+    g_test_0e6b.cnt_close++;
+}
+
+static void _test_0e6b_on_acquire(ev_tcp_pool_t *pool, ev_tcp_t *sock,
+                                  int stat, void *arg)
+{
+    ASSERT_EQ_PTR(pool, g_test_0e6b.pool);
+    ASSERT_EQ_PTR(arg, &g_test_0e6b);
+    ASSERT_EQ_INT(stat, 0);
+    ASSERT_NE_PTR(sock, NULL);
+    g_test_0e6b.socks[g_test_0e6b.cnt_acquire++] = sock;
+}
+
+static void _test_0e6b_acquire(void)
+{
+    ASSERT_EQ_INT(ev_tcp_pool_acquire(g_test_0e6b.pool,
+                                      (struct sockaddr *)&g_test_0e6b.addr,
+                                      g_test_0e6b.addr_sz,
+                                      _test_0e6b_on_acquire, &g_test_0e6b),
+                  0);
+}
+
+static void _test_0e6b_run_until(int *cnt, int val)
+{
+    while (*cnt < val)
+    {
+        ev_loop_run(g_test_0e6b.loop, EV_LOOP_MODE_ONCE, EV_INFINITE_TIMEOUT);
+    }
+}
+
+TEST_FIXTURE_SETUP(tcp)
+{
+    memset(&g_test_0e6b, 0, sizeof(g_test_0e6b));
+    ASSERT_EQ_INT(ev_loop_init(&g_test_0e6b.loop), 0);
+    ASSERT_EQ_INT(ev_tcp_init(g_test_0e6b.loop, &g_test_0e6b.l_sock), 0);
+}
+
+TEST_FIXTURE_TEARDOWN(tcp)
+{
+    int i;
+    for (i = g_test_0e6b.cnt_close; i < g_test_0e6b.cnt_accept; i++)
+    {
+        ev_tcp_exit(g_test_0e6b.conns[i], NULL, NULL);
+    }
+    ev_tcp_exit(g_test_0e6b.l_sock, NULL, NULL);
+    ASSERT_EQ_INT(ev_loop_run(g_test_0e6b.loop, EV_LOOP_MODE_DEFAULT,
+                              EV_INFINITE_TIMEOUT),
+                  0);
+    ASSERT_EQ_INT(ev_loop_exit(g_test_0e6b.loop), 0);
+}
+
+TEST_F(tcp, pool)
+{
+    ev_tcp_pool_opts_t opts;
+    memset(&opts, 0, sizeof(opts));
+    opts.max_idle = 2;
+    opts.max_per_host = 1;
+
+    g_test_0e6b.addr_sz = sizeof(g_test_0e6b.addr);
+    ASSERT_EQ_INT(ev_ip_addr("127.0.0.1", 0,
+                             (struct sockaddr *)&g_test_0e6b.addr,
+                             sizeof(g_test_0e6b.addr)),
+                  0);
+    ASSERT_EQ_INT(ev_tcp_bind(g_test_0e6b.l_sock,
+                              (struct sockaddr *)&g_test_0e6b.addr,
+                              sizeof(g_test_0e6b.addr)),
+                  0);
+    ASSERT_EQ_INT(ev_tcp_listen(g_test_0e6b.l_sock, 4), 0);
+    ASSERT_EQ_INT(ev_tcp_getsockname(g_test_0e6b.l_sock,
+                                     (struct sockaddr *)&g_test_0e6b.addr,
+                                     &g_test_0e6b.addr_sz),
+                  0);
+    ASSERT_EQ_INT(ev_tcp_accept_start(g_test_0e6b.l_sock, 0,
+                                      _test_0e6b_on_connection, NULL),
+                  0);
+    ASSERT_EQ_INT(ev_tcp_pool_init(g_test_0e6b.loop, &g_test_0e6b.pool, &opts),
+                  0);
+
+    /* Callback is never called inside ev_tcp_pool_acquire() */
+    _test_0e6b_acquire();
+    ASSERT_EQ_INT(g_test_0e6b.cnt_acquire, 0);
+    _test_0e6b_run_until(&g_test_0e6b.cnt_acquire, 1);
+
+    /* Only one connection per host, so this one waits for release */
+    _test_0e6b_acquire();
+    ev_tcp_pool_release(g_test_0e6b.pool, g_test_0e6b.socks[0], 1);
+    _test_0e6b_run_until(&g_test_0e6b.cnt_acquire, 2);
+    ASSERT_EQ_PTR(g_test_0e6b.socks[1], g_test_0e6b.socks[0]);
+    _test_0e6b_run_until(&g_test_0e6b.cnt_accept, 1);
+    ASSERT_EQ_INT(g_test_0e6b.cnt_accept, 1);
+
+    /* Idle connection closed by peer is never handed out */
+    ev_tcp_pool_release(g_test_0e6b.pool, g_test_0e6b.socks[1], 1);
+    ev_tcp_exit(g_test_0e6b.conns[0], _test_0e6b_on_close, NULL);
+    _test_0e6b_run_until(&g_test_0e6b.cnt_close, 1);
+    _test_0e6b_acquire();
+    _test_0e6b_run_until(&g_test_0e6b.cnt_acquire, 3);
+    ASSERT_NE_PTR(g_test_0e6b.socks[2], g_test_0e6b.socks[0]);
+    _test_0e6b_run_until(&g_test_0e6b.cnt_accept, 2);
+
+    ev_tcp_pool_release(g_test_0e6b.pool, g_test_0e6b.socks[2], 0);
+    ev_tcp_pool_exit(g_test_0e6b.pool);
+}
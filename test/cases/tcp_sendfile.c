@@ -0,0 +1,218 @@
+#include "ev.h"
+#include "test.h"
+#include "utils/file.h"
+#include "utils/random.h"
+#include "utils/sockpair.h"
+#include <string.h>
+
+#define TEST_51f0_FILE_SIZE   (4 * 1024 * 1024)
+#define TEST_51f0_FILE_OFFSET 1000
+#define TEST_51f0_SEND_SIZE   (TEST_51f0_FILE_SIZE - TEST_51f0_FILE_OFFSET)
+#define TEST_51f0_SHORT_SIZE  100
+
+static const char *s_test_51f0_path = "4e1f8a0c-51f0-4c57-9b1e-tcp-sendfile";
+
+struct test_51f0
+{
+    ev_loop_t *loop;
+    ev_tcp_t  *s_sock;
+    ev_tcp_t  *c_sock;
+    ev_file_t  file;
+
+    char     head[16];
+    char     tail[16];
+    ev_buf_t head_buf;
+    ev_buf_t tail_buf;
+    int      cnt_write;
+    ssize_t  write_ret[3];
+
+    uint8_t  file_data[TEST_51f0_FILE_SIZE];
+    uint8_t  recv_data[16 + TEST_51f0_SEND_SIZE + 16];
+    ev_buf_t recv_buf;
+    size_t   recv_pos;
+    size_t   recv_want;
+};
+
+struct test_51f0 *g_test_51f0 = NULL;
+
+static void _test_51f0_on_write(ev_tcp_t *sock, ssize_t size, void *arg)
+{
+    (void)sock;
+    /* Callbacks are called in submit order */
+    ASSERT_EQ_INT((int)(intptr_t)arg, g_test_51f0->cnt_write);
+    ASSERT_EQ_SSIZE(size, g_test_51f0->cnt_write == 1 ? TEST_51f0_SEND_SIZE
+                                                       : 16);
+    g_test_51f0->cnt_write++;
+}
+
+static void _test_51f0_on_write_short(ev_tcp_t *sock, ssize_t size, void *arg)
+{
+    (void)sock;
+    ASSERT_EQ_INT((int)(intptr_t)arg, g_test_51f0->cnt_write);
+    g_test_51f0->write_ret[g_test_51f0->cnt_write++] = size;
+}
+
+static void _test_51f0_on_read(ev_tcp_t *sock, ssize_t size, void *arg)
+{
+    (void)arg;
+    ASSERT_GT_SSIZE(size, 0);
+    g_test_51f0->recv_pos += size;
+
+    if (g_test_51f0->recv_pos == g_test_51f0->recv_want)
+    {
+        return;
+    }
+
+    g_test_51f0->recv_buf =
+        ev_buf_make(g_test_51f0->recv_data + g_test_51f0->recv_pos,
+                    g_test_51f0->recv_want - g_test_51f0->recv_pos);
+    ASSERT_EQ_INT(ev_tcp_read(sock, &g_test_51f0->recv_buf, 1,
+                              _test_51f0_on_read, NULL),
+                  0);
+}
+
+TEST_FIXTURE_SETUP(tcp)
+{
+    g_test_51f0 = ev_calloc(1, sizeof(*g_test_51f0));
+    g_test_51f0->recv_want = sizeof(g_test_51f0->recv_data);
+    test_random(g_test_51f0->file_data, sizeof(g_test_51f0->file_data));
+
+    ev_fs_remove(NULL, NULL, s_test_51f0_path, 0, NULL);
+    test_write_file(s_test_51f0_path, g_test_51f0->file_data,
+                    sizeof(g_test_51f0->file_data));
+    ASSERT_EQ_INT(ev_file_open(NULL, &g_test_51f0->file, NULL,
+                               s_test_51f0_path, EV_FS_O_RDONLY, 0, NULL),
+                  0);
+
+    ASSERT_EQ_INT(ev_loop_init(&g_test_51f0->loop), 0);
+    ASSERT_EQ_INT(ev_tcp_init(g_test_51f0->loop, &g_test_51f0->s_sock), 0);
+    ASSERT_EQ_INT(ev_tcp_init(g_test_51f0->loop, &g_test_51f0->c_sock), 0);
+    test_sockpair(g_test_51f0->loop, g_test_51f0->s_sock, g_test_51f0->c_sock);
+}
+
+TEST_FIXTURE_TEARDOWN(tcp)
+{
+    ev_tcp_exit(g_test_51f0->s_sock, NULL, NULL);
+    ev_tcp_exit(g_test_51f0->c_sock, NULL, NULL);
+    ASSERT_EQ_INT(ev_loop_run(g_test_51f0->loop, EV_LOOP_MODE_DEFAULT,
+                              EV_INFINITE_TIMEOUT),
+                  0);
+    ASSERT_EQ_INT(ev_loop_exit(g_test_51f0->loop), 0);
+
+    ev_file_close(&g_test_51f0->file, NULL);
+    ev_fs_remove(NULL, NULL, s_test_51f0_path, 0, NULL);
+
+    ev_free(g_test_51f0);
+    g_test_51f0 = NULL;
+}
+
+TEST_F(tcp, sendfile)
+{
+    memset(g_test_51f0->head, 'h', sizeof(g_test_51f0->head));
+    memset(g_test_51f0->tail, 't', sizeof(g_test_51f0->tail));
+    g_test_51f0->head_buf =
+        ev_buf_make(g_test_51f0->head, sizeof(g_test_51f0->head));
+    g_test_51f0->tail_buf =
+        ev_buf_make(g_test_51f0->tail, sizeof(g_test_51f0->tail));
+
+    ASSERT_EQ_INT(ev_tcp_write(g_test_51f0->s_sock, &g_test_51f0->head_buf, 1,
+                               _test_51f0_on_write, (void *)0),
+                  0);
+    int ret = ev_tcp_sendfile(g_test_51f0->s_sock, &g_test_51f0->file,
+                              TEST_51f0_FILE_OFFSET, TEST_51f0_SEND_SIZE,
+                              _test_51f0_on_write, (void *)1);
+#if defined(_WIN32)
+    ASSERT_EQ_INT(ret, EV_ENOSYS);
+    return;
+#endif
+    ASSERT_EQ_INT(ret, 0);
+    ASSERT_EQ_INT(ev_tcp_write(g_test_51f0->s_sock, &g_test_51f0->tail_buf, 1,
+                               _test_51f0_on_write, (void *)2),
+                  0);
+
+    g_test_51f0->recv_buf = ev_buf_make(g_test_51f0->recv_data,
+                                        sizeof(g_test_51f0->recv_data));
+    ASSERT_EQ_INT(ev_tcp_read(g_test_51f0->c_sock, &g_test_51f0->recv_buf, 1,
+                              _test_51f0_on_read, NULL),
+                  0);
+
+    ASSERT_EQ_INT(ev_loop_run(g_test_51f0->loop, EV_LOOP_MODE_DEFAULT,
+                              EV_INFINITE_TIMEOUT),
+                  0);
+
+    ASSERT_EQ_INT(g_test_51f0->cnt_write, 3);
+    ASSERT_EQ_SIZE(g_test_51f0->recv_pos, sizeof(g_test_51f0->recv_data));
+
+    /* Data arrives in submit order */
+    uint8_t *pos = g_test_51f0->recv_data;
+    ASSERT_EQ_INT(memcmp(pos, g_test_51f0->head, 16), 0);
+    pos += 16;
+    ASSERT_EQ_INT(memcmp(pos, g_test_51f0->file_data + TEST_51f0_FILE_OFFSET,
+                         TEST_51f0_SEND_SIZE),
+                  0);
+    pos += TEST_51f0_SEND_SIZE;
+    ASSERT_EQ_INT(memcmp(pos, g_test_51f0->tail, 16), 0);
+}
+
+TEST_F(tcp, sendfile_short_file)
+{
+    ev_tcp_t *sock = NULL;
+    ASSERT_EQ_INT(ev_tcp_init(g_test_51f0->loop, &sock), 0);
+    int ret = ev_tcp_sendfile(sock, &g_test_51f0->file, 0, 1,
+                              _test_51f0_on_write_short, NULL);
+    ev_tcp_exit(sock, NULL, NULL);
+#if defined(_WIN32)
+    ASSERT_EQ_INT(ret, EV_ENOSYS);
+    return;
+#endif
+    ASSERT_EQ_INT(ret, EV_ENOTCONN);
+
+    memset(g_test_51f0->head, 'h', sizeof(g_test_51f0->head));
+    memset(g_test_51f0->tail, 't', sizeof(g_test_51f0->tail));
+    g_test_51f0->head_buf =
+        ev_buf_make(g_test_51f0->head, sizeof(g_test_51f0->head));
+    g_test_51f0->tail_buf =
+        ev_buf_make(g_test_51f0->tail, sizeof(g_test_51f0->tail));
+
+    /* File ends before the requested range does */
+    ASSERT_EQ_INT(ev_tcp_write(g_test_51f0->s_sock, &g_test_51f0->head_buf, 1,
+                               _test_51f0_on_write_short, (void *)0),
+                  0);
+    ASSERT_EQ_INT(ev_tcp_sendfile(g_test_51f0->s_sock, &g_test_51f0->file,
+                                  TEST_51f0_FILE_SIZE - TEST_51f0_SHORT_SIZE,
+                                  TEST_51f0_SHORT_SIZE * 2,
+                                  _test_51f0_on_write_short, (void *)1),
+                  0);
+    ASSERT_EQ_INT(ev_tcp_write(g_test_51f0->s_sock, &g_test_51f0->tail_buf, 1,
+                               _test_51f0_on_write_short, (void *)2),
+                  0);
+
+    g_test_51f0->recv_want = 16 + TEST_51f0_SHORT_SIZE + 16;
+    g_test_51f0->recv_buf =
+        ev_buf_make(g_test_51f0->recv_data, g_test_51f0->recv_want);
+    ASSERT_EQ_INT(ev_tcp_read(g_test_51f0->c_sock, &g_test_51f0->recv_buf, 1,
+                              _test_51f0_on_read, NULL),
+                  0);
+
+    ASSERT_EQ_INT(ev_loop_run(g_test_51f0->loop, EV_LOOP_MODE_DEFAULT,
+                              EV_INFINITE_TIMEOUT),
+                  0);
+
+    /* Only the file request fails, the stream keeps going */
+    ASSERT_EQ_INT(g_test_51f0->cnt_write, 3);
+    ASSERT_EQ_SSIZE(g_test_51f0->write_ret[0], 16);
+    ASSERT_EQ_SSIZE(g_test_51f0->write_ret[1], EV_EOF);
+    ASSERT_EQ_SSIZE(g_test_51f0->write_ret[2], 16);
+    ASSERT_EQ_SIZE(g_test_51f0->recv_pos, g_test_51f0->recv_want);
+
+    uint8_t *pos = g_test_51f0->recv_data;
+    ASSERT_EQ_INT(memcmp(pos, g_test_51f0->head, 16), 0);
+    pos += 16;
+    ASSERT_EQ_INT(memcmp(pos,
+                         g_test_51f0->file_data + TEST_51f0_FILE_SIZE -
+                             TEST_51f0_SHORT_SIZE,
+                         TEST_51f0_SHORT_SIZE),
+                  0);
+    pos += TEST_51f0_SHORT_SIZE;
+    ASSERT_EQ_INT(memcmp(pos, g_test_51f0->tail, 16), 0);
+}
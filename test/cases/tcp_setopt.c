@@ -0,0 +1,118 @@
+#include "ev.h"
+#include "test.h"
+#include <string.h>
+
+struct test_6b15
+{
+    ev_loop_t *loop;
+    ev_tcp_t  *l_sock;
+    ev_tcp_t  *s_sock;
+    ev_tcp_t  *c_sock;
+    int        cnt_accept;
+    int        cnt_connect;
+};
+
+struct test_6b15 g_test_6b15;
+
+static void _test_6b15_on_accept(ev_tcp_t *lisn, ev_tcp_t *conn, int stat,
+                                 void *arg)
+{
+    (void)lisn;
+    (void)arg;
+    ASSERT_EQ_INT(stat, 0);
+    g_test_6b15.cnt_accept++;
+
+    /* Inherited from listen socket */
+    int val = 0;
+    ASSERT_EQ_INT(ev_tcp_getopt(conn, EV_TCP_OPT_NODELAY, &val), 0);
+    ASSERT_NE_INT(val, 0);
+    ASSERT_EQ_INT(ev_tcp_getopt(conn, EV_TCP_OPT_KEEPALIVE, &val), 0);
+    ASSERT_NE_INT(val, 0);
+}
+
+static void _test_6b15_on_connect(ev_tcp_t *sock, int stat, void *arg)
+{
+    (void)arg;
+    ASSERT_EQ_INT(stat, 0);
+    g_test_6b15.cnt_connect++;
+
+    /* Applied when the socket is created */
+    int val = 0;
+    ASSERT_EQ_INT(ev_tcp_getopt(sock, EV_TCP_OPT_NODELAY, &val), 0);
+    ASSERT_NE_INT(val, 0);
+}
+
+TEST_FIXTURE_SETUP(tcp)
+{
+    memset(&g_test_6b15, 0, sizeof(g_test_6b15));
+    ASSERT_EQ_INT(ev_loop_init(&g_test_6b15.loop), 0);
+    ASSERT_EQ_INT(ev_tcp_init(g_test_6b15.loop, &g_test_6b15.l_sock), 0);
+    ASSERT_EQ_INT(ev_tcp_init(g_test_6b15.loop, &g_test_6b15.s_sock), 0);
+    ASSERT_EQ_INT(ev_tcp_init(g_test_6b15.loop, &g_test_6b15.c_sock), 0);
+}
+
+TEST_FIXTURE_TEARDOWN(tcp)
+{
+    ev_tcp_exit(g_test_6b15.l_sock, NULL, NULL);
+    ev_tcp_exit(g_test_6b15.s_sock, NULL, NULL);
+    ev_tcp_exit(g_test_6b15.c_sock, NULL, NULL);
+    ASSERT_EQ_INT(ev_loop_run(g_test_6b15.loop, EV_LOOP_MODE_DEFAULT,
+                              EV_INFINITE_TIMEOUT),
+                  0);
+    ASSERT_EQ_INT(ev_loop_exit(g_test_6b15.loop), 0);
+}
+
+TEST_F(tcp, setopt)
+{
+    int                     val = 0;
+    struct sockaddr_storage addr;
+    size_t                  addr_sz = sizeof(addr);
+
+    ASSERT_EQ_INT(ev_tcp_setopt(g_test_6b15.l_sock, (ev_tcp_opt_t)-1, 1),
+                  EV_EINVAL);
+
+    /* No socket yet, value is saved */
+    ASSERT_EQ_INT(ev_tcp_getopt(g_test_6b15.l_sock, EV_TCP_OPT_NODELAY, &val),
+                  EV_EBADF);
+    ASSERT_EQ_INT(ev_tcp_setopt(g_test_6b15.l_sock, EV_TCP_OPT_NODELAY, 1), 0);
+    ASSERT_EQ_INT(ev_tcp_getopt(g_test_6b15.l_sock, EV_TCP_OPT_NODELAY, &val),
+                  0);
+    ASSERT_EQ_INT(val, 1);
+    ASSERT_EQ_INT(ev_tcp_setopt(g_test_6b15.l_sock, EV_TCP_OPT_KEEPALIVE, 1),
+                  0);
+
+    /* Listen socket only option, applied by ev_tcp_listen() */
+    int ret = ev_tcp_setopt(g_test_6b15.l_sock, EV_TCP_OPT_DEFER_ACCEPT, 0);
+    if (ret != EV_ENOSYS)
+    {
+        ASSERT_EQ_INT(ret, 0);
+    }
+
+    ASSERT_EQ_INT(ev_ip_addr("127.0.0.1", 0, (struct sockaddr *)&addr,
+                             sizeof(addr)),
+                  0);
+    ASSERT_EQ_INT(
+        ev_tcp_bind(g_test_6b15.l_sock, (struct sockaddr *)&addr, sizeof(addr)),
+        0);
+    ASSERT_EQ_INT(ev_tcp_listen(g_test_6b15.l_sock, 1), 0);
+    ASSERT_EQ_INT(ev_tcp_getsockname(g_test_6b15.l_sock,
+                                     (struct sockaddr *)&addr, &addr_sz),
+                  0);
+    ASSERT_EQ_INT(ev_tcp_getopt(g_test_6b15.l_sock, EV_TCP_OPT_NODELAY, &val),
+                  0);
+    ASSERT_NE_INT(val, 0);
+
+    ASSERT_EQ_INT(ev_tcp_accept(g_test_6b15.l_sock, g_test_6b15.s_sock,
+                                _test_6b15_on_accept, NULL),
+                  0);
+
+    ASSERT_EQ_INT(ev_tcp_setopt(g_test_6b15.c_sock, EV_TCP_OPT_NODELAY, 1), 0);
+    ASSERT_EQ_INT(ev_tcp_connect(g_test_6b15.c_sock, (struct sockaddr *)&addr,
+                                 addr_sz, _test_6b15_on_connect, NULL),
+                  0);
+
+    while (g_test_6b15.cnt_accept == 0 || g_test_6b15.cnt_connect == 0)
+    {
+        ev_loop_run(g_test_6b15.loop, EV_LOOP_MODE_ONCE, EV_INFINITE_TIMEOUT);
+    }
+}
@@ -0,0 +1,153 @@
+#include "ev.h"
+#include "test.h"
+#include "utils/sockpair.h"
+#include <string.h>
+
+struct test_b41d
+{
+    ev_loop_t *loop;
+    ev_tcp_t  *s_sock;
+    ev_tcp_t  *c_sock;
+
+    char     send_buf[2][64];
+    ev_buf_t send_bufs[2];
+    int      cnt_write;
+
+    char     recv_buf[128];
+    ev_buf_t recv_bufs;
+    size_t   recv_pos;
+
+    ssize_t write_err; /**< Result of write to a reset connection */
+};
+
+struct test_b41d g_test_b41d;
+
+static void _test_b41d_on_write(ev_tcp_t *sock, ssize_t size, void *arg)
+{
+    (void)sock;
+    (void)arg;
+    ASSERT_EQ_SSIZE(size, sizeof(g_test_b41d.send_buf[1]));
+    g_test_b41d.cnt_write++;
+}
+
+static void _test_b41d_on_write_fail(ev_tcp_t *sock, ssize_t size, void *arg)
+{
+    (void)sock;
+    (void)arg;
+    g_test_b41d.write_err = size;
+    g_test_b41d.cnt_write++;
+}
+
+static void _test_b41d_on_read(ev_tcp_t *sock, ssize_t size, void *arg)
+{
+    (void)arg;
+    ASSERT_GT_SSIZE(size, 0);
+    g_test_b41d.recv_pos += size;
+
+    if (g_test_b41d.recv_pos == sizeof(g_test_b41d.recv_buf))
+    {
+        return;
+    }
+
+    g_test_b41d.recv_bufs =
+        ev_buf_make(g_test_b41d.recv_buf + g_test_b41d.recv_pos,
+                    sizeof(g_test_b41d.recv_buf) - g_test_b41d.recv_pos);
+    ASSERT_EQ_INT(
+        ev_tcp_read(sock, &g_test_b41d.recv_bufs, 1, _test_b41d_on_read, NULL),
+        0);
+}
+
+TEST_FIXTURE_SETUP(tcp)
+{
+    memset(&g_test_b41d, 0, sizeof(g_test_b41d));
+    ASSERT_EQ_INT(ev_loop_init(&g_test_b41d.loop), 0);
+    ASSERT_EQ_INT(ev_tcp_init(g_test_b41d.loop, &g_test_b41d.s_sock), 0);
+    ASSERT_EQ_INT(ev_tcp_init(g_test_b41d.loop, &g_test_b41d.c_sock), 0);
+    test_sockpair(g_test_b41d.loop, g_test_b41d.s_sock, g_test_b41d.c_sock);
+}
+
+TEST_FIXTURE_TEARDOWN(tcp)
+{
+    ev_tcp_exit(g_test_b41d.s_sock, NULL, NULL);
+    if (g_test_b41d.c_sock != NULL)
+    {
+        ev_tcp_exit(g_test_b41d.c_sock, NULL, NULL);
+    }
+    ASSERT_EQ_INT(ev_loop_run(g_test_b41d.loop, EV_LOOP_MODE_DEFAULT,
+                              EV_INFINITE_TIMEOUT),
+                  0);
+    ASSERT_EQ_INT(ev_loop_exit(g_test_b41d.loop), 0);
+}
+
+TEST_F(tcp, try_write)
+{
+    memset(g_test_b41d.send_buf[0], 'a', sizeof(g_test_b41d.send_buf[0]));
+    memset(g_test_b41d.send_buf[1], 'b', sizeof(g_test_b41d.send_buf[1]));
+    g_test_b41d.send_bufs[0] =
+        ev_buf_make(g_test_b41d.send_buf[0], sizeof(g_test_b41d.send_buf[0]));
+    g_test_b41d.send_bufs[1] =
+        ev_buf_make(g_test_b41d.send_buf[1], sizeof(g_test_b41d.send_buf[1]));
+
+    ssize_t ret =
+        ev_tcp_try_write(g_test_b41d.s_sock, &g_test_b41d.send_bufs[0], 1);
+#if defined(_WIN32)
+    ASSERT_EQ_SSIZE(ret, EV_ENOSYS);
+    return;
+#endif
+    ASSERT_EQ_SSIZE(ret, sizeof(g_test_b41d.send_buf[0]));
+
+    /* Callback is never called inside ev_tcp_write() */
+    ASSERT_EQ_INT(ev_tcp_write(g_test_b41d.s_sock, &g_test_b41d.send_bufs[1], 1,
+                               _test_b41d_on_write, NULL),
+                  0);
+    ASSERT_EQ_INT(g_test_b41d.cnt_write, 0);
+
+    g_test_b41d.recv_bufs =
+        ev_buf_make(g_test_b41d.recv_buf, sizeof(g_test_b41d.recv_buf));
+    ASSERT_EQ_INT(ev_tcp_read(g_test_b41d.c_sock, &g_test_b41d.recv_bufs, 1,
+                              _test_b41d_on_read, NULL),
+                  0);
+
+    ASSERT_EQ_INT(ev_loop_run(g_test_b41d.loop, EV_LOOP_MODE_DEFAULT,
+                              EV_INFINITE_TIMEOUT),
+                  0);
+
+    ASSERT_EQ_INT(g_test_b41d.cnt_write, 1);
+    ASSERT_EQ_INT(memcmp(g_test_b41d.recv_buf, g_test_b41d.send_buf,
+                         sizeof(g_test_b41d.recv_buf)),
+                  0);
+}
+
+TEST_F(tcp, try_write_fail_deferred)
+{
+    ev_buf_t buf = ev_buf_make("x", 1);
+
+#if defined(_WIN32)
+    ASSERT_EQ_SSIZE(ev_tcp_try_write(g_test_b41d.s_sock, &buf, 1), EV_ENOSYS);
+    return;
+#endif
+
+    /* Peer closes with data unread, so the connection is reset */
+    ASSERT_EQ_SSIZE(ev_tcp_try_write(g_test_b41d.s_sock, &buf, 1), 1);
+    ev_tcp_exit(g_test_b41d.c_sock, NULL, NULL);
+    g_test_b41d.c_sock = NULL;
+    ev_loop_run(g_test_b41d.loop, EV_LOOP_MODE_NOWAIT, 0);
+
+    ssize_t ret;
+    while ((ret = ev_tcp_try_write(g_test_b41d.s_sock, &buf, 1)) >= 0)
+    {
+        ev_loop_run(g_test_b41d.loop, EV_LOOP_MODE_NOWAIT, 0);
+    }
+
+    /* Failure of the inline send is reported through the callback */
+    ASSERT_EQ_INT(ev_tcp_write(g_test_b41d.s_sock, &buf, 1,
+                               _test_b41d_on_write_fail, NULL),
+                  0);
+    ASSERT_EQ_INT(g_test_b41d.cnt_write, 0);
+
+    ASSERT_EQ_INT(ev_loop_run(g_test_b41d.loop, EV_LOOP_MODE_DEFAULT,
+                              EV_INFINITE_TIMEOUT),
+                  0);
+    ASSERT_EQ_INT(g_test_b41d.cnt_write, 1);
+    ASSERT_LT_SSIZE(g_test_b41d.write_err, 0);
+}
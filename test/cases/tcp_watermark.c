@@ -0,0 +1,141 @@
+#include "ev.h"
+#include "test.h"
+#include "utils/sockpair.h"
+#include <string.h>
+
+#define TEST_f2c8_WRITE_CNT  16
+#define TEST_f2c8_WRITE_SIZE (256 * 1024)
+#define TEST_f2c8_HIGH       (1024 * 1024)
+#define TEST_f2c8_LOW        (64 * 1024)
+
+struct test_f2c8
+{
+    ev_loop_t *loop;
+    ev_tcp_t  *s_sock;
+    ev_tcp_t  *c_sock;
+
+    uint8_t  send_buf[TEST_f2c8_WRITE_SIZE];
+    ev_buf_t send_bufs[TEST_f2c8_WRITE_CNT];
+    size_t   cnt_write;
+    int      cnt_high;
+    int      cnt_low;
+
+    uint8_t  recv_buf[64 * 1024];
+    ev_buf_t recv_bufs;
+    size_t   recv_total;
+};
+
+struct test_f2c8 *g_test_f2c8 = NULL;
+
+static void _test_f2c8_on_watermark(ev_tcp_t *sock, int high, void *arg)
+{
+    ASSERT_EQ_PTR(arg, g_test_f2c8);
+    ssize_t queued = ev_tcp_write_queue_size(sock);
+    if (high)
+    {
+        ASSERT_EQ_INT(g_test_f2c8->cnt_high, g_test_f2c8->cnt_low);
+        ASSERT_GE_SSIZE(queued, TEST_f2c8_HIGH);
+        g_test_f2c8->cnt_high++;
+    }
+    else
+    {
+        ASSERT_EQ_INT(g_test_f2c8->cnt_high, g_test_f2c8->cnt_low + 1);
+        ASSERT_LE_SSIZE(queued, TEST_f2c8_LOW);
+        g_test_f2c8->cnt_low++;
+    }
+}
+
+static void _test_f2c8_on_write(ev_tcp_t *sock, ssize_t size, void *arg)
+{
+    (void)sock;
+    (void)arg;
+    ASSERT_EQ_SSIZE(size, TEST_f2c8_WRITE_SIZE);
+    g_test_f2c8->cnt_write++;
+}
+
+static void _test_f2c8_on_read(ev_tcp_t *sock, ssize_t size, void *arg)
+{
+    (void)arg;
+    ASSERT_GT_SSIZE(size, 0);
+    g_test_f2c8->recv_total += size;
+
+    if (g_test_f2c8->recv_total == TEST_f2c8_WRITE_CNT * TEST_f2c8_WRITE_SIZE)
+    {
+        return;
+    }
+
+    g_test_f2c8->recv_bufs =
+        ev_buf_make(g_test_f2c8->recv_buf, sizeof(g_test_f2c8->recv_buf));
+    ASSERT_EQ_INT(ev_tcp_read(sock, &g_test_f2c8->recv_bufs, 1,
+                              _test_f2c8_on_read, NULL),
+                  0);
+}
+
+TEST_FIXTURE_SETUP(tcp)
+{
+    g_test_f2c8 = ev_calloc(1, sizeof(*g_test_f2c8));
+    ASSERT_EQ_INT(ev_loop_init(&g_test_f2c8->loop), 0);
+    ASSERT_EQ_INT(ev_tcp_init(g_test_f2c8->loop, &g_test_f2c8->s_sock), 0);
+    ASSERT_EQ_INT(ev_tcp_init(g_test_f2c8->loop, &g_test_f2c8->c_sock), 0);
+    test_sockpair(g_test_f2c8->loop, g_test_f2c8->s_sock, g_test_f2c8->c_sock);
+}
+
+TEST_FIXTURE_TEARDOWN(tcp)
+{
+    ev_tcp_exit(g_test_f2c8->s_sock, NULL, NULL);
+    ev_tcp_exit(g_test_f2c8->c_sock, NULL, NULL);
+    ASSERT_EQ_INT(ev_loop_run(g_test_f2c8->loop, EV_LOOP_MODE_DEFAULT,
+                              EV_INFINITE_TIMEOUT),
+                  0);
+    ASSERT_EQ_INT(ev_loop_exit(g_test_f2c8->loop), 0);
+
+    ev_free(g_test_f2c8);
+    g_test_f2c8 = NULL;
+}
+
+TEST_F(tcp, watermark)
+{
+    size_t i;
+    int    ret = ev_tcp_set_watermark(g_test_f2c8->s_sock, TEST_f2c8_LOW,
+                                      TEST_f2c8_HIGH, _test_f2c8_on_watermark,
+                                      g_test_f2c8);
+    if (ret == EV_ENOSYS)
+    {
+        return;
+    }
+    ASSERT_EQ_INT(ret, 0);
+    ASSERT_EQ_INT(ev_tcp_set_watermark(g_test_f2c8->s_sock, 2, 1, NULL, NULL),
+                  EV_EINVAL);
+
+    /* Nobody reads, so data piles up in write queue */
+    ASSERT_EQ_INT(
+        ev_tcp_setopt(g_test_f2c8->s_sock, EV_TCP_OPT_SNDBUF, 64 * 1024), 0);
+    ASSERT_EQ_INT(
+        ev_tcp_setopt(g_test_f2c8->c_sock, EV_TCP_OPT_RCVBUF, 64 * 1024), 0);
+    for (i = 0; i < TEST_f2c8_WRITE_CNT; i++)
+    {
+        g_test_f2c8->send_bufs[i] =
+            ev_buf_make(g_test_f2c8->send_buf, sizeof(g_test_f2c8->send_buf));
+        ASSERT_EQ_INT(ev_tcp_write(g_test_f2c8->s_sock,
+                                   &g_test_f2c8->send_bufs[i], 1,
+                                   _test_f2c8_on_write, NULL),
+                      0);
+    }
+    ASSERT_EQ_INT(g_test_f2c8->cnt_high, 1);
+    ASSERT_GE_SSIZE(ev_tcp_write_queue_size(g_test_f2c8->s_sock),
+                    TEST_f2c8_HIGH);
+
+    g_test_f2c8->recv_bufs =
+        ev_buf_make(g_test_f2c8->recv_buf, sizeof(g_test_f2c8->recv_buf));
+    ASSERT_EQ_INT(ev_tcp_read(g_test_f2c8->c_sock, &g_test_f2c8->recv_bufs, 1,
+                              _test_f2c8_on_read, NULL),
+                  0);
+
+    ASSERT_EQ_INT(ev_loop_run(g_test_f2c8->loop, EV_LOOP_MODE_DEFAULT,
+                              EV_INFINITE_TIMEOUT),
+                  0);
+
+    ASSERT_EQ_SIZE(g_test_f2c8->cnt_write, TEST_f2c8_WRITE_CNT);
+    ASSERT_EQ_INT(g_test_f2c8->cnt_low, 1);
+    ASSERT_EQ_SSIZE(ev_tcp_write_queue_size(g_test_f2c8->s_sock), 0);
+}
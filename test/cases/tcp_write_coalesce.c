@@ -0,0 +1,105 @@
+#include "ev.h"
+#include "test.h"
+#include "utils/random.h"
+#include "utils/sockpair.h"
+#include <string.h>
+
+#define TEST_8e02_WRITE_CNT  64
+#define TEST_8e02_WRITE_SIZE 100
+
+struct test_8e02
+{
+    ev_loop_t *loop;
+    ev_tcp_t  *s_sock;
+    ev_tcp_t  *c_sock;
+
+    char     send_buf[TEST_8e02_WRITE_CNT][TEST_8e02_WRITE_SIZE];
+    ev_buf_t send_bufs[TEST_8e02_WRITE_CNT];
+    size_t   cnt_write;
+
+    char     recv_buf[TEST_8e02_WRITE_CNT * TEST_8e02_WRITE_SIZE];
+    ev_buf_t recv_bufs;
+    size_t   recv_pos;
+};
+
+struct test_8e02 g_test_8e02;
+
+static void _test_8e02_on_write(ev_tcp_t *sock, ssize_t size, void *arg)
+{
+    (void)sock;
+    /* Callbacks must be called in submit order */
+    ASSERT_EQ_SIZE((size_t)arg, g_test_8e02.cnt_write);
+    ASSERT_EQ_SSIZE(size, TEST_8e02_WRITE_SIZE);
+    g_test_8e02.cnt_write++;
+}
+
+static void _test_8e02_on_read(ev_tcp_t *sock, ssize_t size, void *arg)
+{
+    (void)arg;
+    ASSERT_GT_SSIZE(size, 0);
+    g_test_8e02.recv_pos += size;
+
+    if (g_test_8e02.recv_pos == sizeof(g_test_8e02.recv_buf))
+    {
+        return;
+    }
+
+    g_test_8e02.recv_bufs =
+        ev_buf_make(g_test_8e02.recv_buf + g_test_8e02.recv_pos,
+                    sizeof(g_test_8e02.recv_buf) - g_test_8e02.recv_pos);
+    ASSERT_EQ_INT(
+        ev_tcp_read(sock, &g_test_8e02.recv_bufs, 1, _test_8e02_on_read, NULL),
+        0);
+}
+
+TEST_FIXTURE_SETUP(tcp)
+{
+    memset(&g_test_8e02, 0, sizeof(g_test_8e02));
+    ASSERT_EQ_INT(ev_loop_init(&g_test_8e02.loop), 0);
+    ASSERT_EQ_INT(ev_tcp_init(g_test_8e02.loop, &g_test_8e02.s_sock), 0);
+    ASSERT_EQ_INT(ev_tcp_init(g_test_8e02.loop, &g_test_8e02.c_sock), 0);
+    test_sockpair(g_test_8e02.loop, g_test_8e02.s_sock, g_test_8e02.c_sock);
+}
+
+TEST_FIXTURE_TEARDOWN(tcp)
+{
+    ev_tcp_exit(g_test_8e02.s_sock, NULL, NULL);
+    ev_tcp_exit(g_test_8e02.c_sock, NULL, NULL);
+    ASSERT_EQ_INT(ev_loop_run(g_test_8e02.loop, EV_LOOP_MODE_DEFAULT,
+                              EV_INFINITE_TIMEOUT),
+                  0);
+    ASSERT_EQ_INT(ev_loop_exit(g_test_8e02.loop), 0);
+}
+
+TEST_F(tcp, write_coalesce)
+{
+    size_t i;
+    test_random(g_test_8e02.send_buf, sizeof(g_test_8e02.send_buf));
+
+    /* Queue many small writes before the loop gets a chance to send them */
+    for (i = 0; i < TEST_8e02_WRITE_CNT; i++)
+    {
+        g_test_8e02.send_bufs[i] =
+            ev_buf_make(g_test_8e02.send_buf[i], TEST_8e02_WRITE_SIZE);
+        ASSERT_EQ_INT(ev_tcp_write(g_test_8e02.s_sock,
+                                   &g_test_8e02.send_bufs[i], 1,
+                                   _test_8e02_on_write, (void *)i),
+                      0);
+    }
+
+    g_test_8e02.recv_bufs =
+        ev_buf_make(g_test_8e02.recv_buf, sizeof(g_test_8e02.recv_buf));
+    ASSERT_EQ_INT(ev_tcp_read(g_test_8e02.c_sock, &g_test_8e02.recv_bufs, 1,
+                              _test_8e02_on_read, NULL),
+                  0);
+
+    ASSERT_EQ_INT(ev_loop_run(g_test_8e02.loop, EV_LOOP_MODE_DEFAULT,
+                              EV_INFINITE_TIMEOUT),
+                  0);
+
+    ASSERT_EQ_SIZE(g_test_8e02.cnt_write, TEST_8e02_WRITE_CNT);
+    ASSERT_EQ_SIZE(g_test_8e02.recv_pos, sizeof(g_test_8e02.recv_buf));
+    ASSERT_EQ_INT(memcmp(g_test_8e02.send_buf, g_test_8e02.recv_buf,
+                         sizeof(g_test_8e02.recv_buf)),
+                  0);
+}
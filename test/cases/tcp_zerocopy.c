@@ -0,0 +1,118 @@
+#include "ev.h"
+#include "test.h"
+#include "utils/random.h"
+#include "utils/sockpair.h"
+#include <string.h>
+
+#define TEST_7a29_WRITE_CNT  8
+#define TEST_7a29_WRITE_SIZE (64 * 1024)
+
+struct test_7a29
+{
+    ev_loop_t *loop;
+    ev_tcp_t  *s_sock;
+    ev_tcp_t  *c_sock;
+
+    uint8_t  send_buf[TEST_7a29_WRITE_CNT][TEST_7a29_WRITE_SIZE];
+    ev_buf_t send_bufs[TEST_7a29_WRITE_CNT];
+    size_t   cnt_write;
+
+    uint8_t  recv_buf[TEST_7a29_WRITE_CNT * TEST_7a29_WRITE_SIZE];
+    ev_buf_t recv_bufs;
+    size_t   recv_pos;
+};
+
+struct test_7a29 *g_test_7a29 = NULL;
+
+static void _test_7a29_on_write(ev_tcp_t *sock, ssize_t size, void *arg)
+{
+    (void)sock;
+    /* Callbacks are called in submit order */
+    ASSERT_EQ_SIZE((size_t)arg, g_test_7a29->cnt_write);
+    ASSERT_EQ_SSIZE(size, TEST_7a29_WRITE_SIZE);
+    g_test_7a29->cnt_write++;
+}
+
+static void _test_7a29_on_read(ev_tcp_t *sock, ssize_t size, void *arg)
+{
+    (void)arg;
+    ASSERT_GT_SSIZE(size, 0);
+    g_test_7a29->recv_pos += size;
+
+    if (g_test_7a29->recv_pos == sizeof(g_test_7a29->recv_buf))
+    {
+        return;
+    }
+
+    g_test_7a29->recv_bufs =
+        ev_buf_make(g_test_7a29->recv_buf + g_test_7a29->recv_pos,
+                    sizeof(g_test_7a29->recv_buf) - g_test_7a29->recv_pos);
+    ASSERT_EQ_INT(ev_tcp_read(sock, &g_test_7a29->recv_bufs, 1,
+                              _test_7a29_on_read, NULL),
+                  0);
+}
+
+TEST_FIXTURE_SETUP(tcp)
+{
+    g_test_7a29 = ev_calloc(1, sizeof(*g_test_7a29));
+    ASSERT_EQ_INT(ev_loop_init(&g_test_7a29->loop), 0);
+    ASSERT_EQ_INT(ev_tcp_init(g_test_7a29->loop, &g_test_7a29->s_sock), 0);
+    ASSERT_EQ_INT(ev_tcp_init(g_test_7a29->loop, &g_test_7a29->c_sock), 0);
+    test_sockpair(g_test_7a29->loop, g_test_7a29->s_sock, g_test_7a29->c_sock);
+}
+
+TEST_FIXTURE_TEARDOWN(tcp)
+{
+    ev_tcp_exit(g_test_7a29->s_sock, NULL, NULL);
+    ev_tcp_exit(g_test_7a29->c_sock, NULL, NULL);
+    ASSERT_EQ_INT(ev_loop_run(g_test_7a29->loop, EV_LOOP_MODE_DEFAULT,
+                              EV_INFINITE_TIMEOUT),
+                  0);
+    ASSERT_EQ_INT(ev_loop_exit(g_test_7a29->loop), 0);
+
+    ev_free(g_test_7a29);
+    g_test_7a29 = NULL;
+}
+
+TEST_F(tcp, zerocopy)
+{
+    size_t i;
+    int    ret = ev_tcp_set_zerocopy(g_test_7a29->s_sock, 1);
+    if (ret == EV_ENOSYS)
+    {
+        return;
+    }
+    ASSERT_EQ_INT(ret, 0);
+
+    test_random(g_test_7a29->send_buf, sizeof(g_test_7a29->send_buf));
+    for (i = 0; i < TEST_7a29_WRITE_CNT; i++)
+    {
+        g_test_7a29->send_bufs[i] =
+            ev_buf_make(g_test_7a29->send_buf[i], TEST_7a29_WRITE_SIZE);
+        ASSERT_EQ_INT(ev_tcp_write(g_test_7a29->s_sock,
+                                   &g_test_7a29->send_bufs[i], 1,
+                                   _test_7a29_on_write, (void *)i),
+                      0);
+    }
+
+    /* Cannot disable with pending write requests */
+    ASSERT_EQ_INT(ev_tcp_set_zerocopy(g_test_7a29->s_sock, 0), EV_EBUSY);
+
+    g_test_7a29->recv_bufs =
+        ev_buf_make(g_test_7a29->recv_buf, sizeof(g_test_7a29->recv_buf));
+    ASSERT_EQ_INT(ev_tcp_read(g_test_7a29->c_sock, &g_test_7a29->recv_bufs, 1,
+                              _test_7a29_on_read, NULL),
+                  0);
+
+    ASSERT_EQ_INT(ev_loop_run(g_test_7a29->loop, EV_LOOP_MODE_DEFAULT,
+                              EV_INFINITE_TIMEOUT),
+                  0);
+
+    ASSERT_EQ_SIZE(g_test_7a29->cnt_write, TEST_7a29_WRITE_CNT);
+    ASSERT_EQ_SIZE(g_test_7a29->recv_pos, sizeof(g_test_7a29->recv_buf));
+    ASSERT_EQ_INT(memcmp(g_test_7a29->send_buf, g_test_7a29->recv_buf,
+                         sizeof(g_test_7a29->recv_buf)),
+                  0);
+
+    ASSERT_EQ_INT(ev_tcp_set_zerocopy(g_test_7a29->s_sock, 0), 0);
+}
@@ -0,0 +1,95 @@
+#include "test.h"
+#include <string.h>
+
+#define TEST_5c2e_TIMEOUT 20
+
+struct test_5c2e
+{
+    ev_loop_t       *loop;
+    ev_idle_timer_t *idle;
+    ev_timer_t      *touch_timer;
+
+    ev_idle_token_t tokens[3];
+    int             cnt_touch;
+    int             order[3];
+    int             cnt_expire;
+};
+
+struct test_5c2e g_test_5c2e;
+
+static void _test_5c2e_on_expire(ev_idle_token_t *token, void *arg)
+{
+    ASSERT_EQ_PTR(token->owner, NULL);
+    g_test_5c2e.order[g_test_5c2e.cnt_expire++] = (int)(intptr_t)arg;
+
+    if (token == &g_test_5c2e.tokens[0])
+    {
+        /* Safe to destroy manager in callback */
+        ev_idle_timer_exit(g_test_5c2e.idle);
+    }
+}
+
+static void _test_5c2e_on_touch(ev_timer_t *timer, void *arg)
+{
+    (void)arg;
+    ev_idle_timer_touch(&g_test_5c2e.tokens[0]);
+
+    if (++g_test_5c2e.cnt_touch == 3)
+    {
+        ev_timer_exit(timer, NULL, NULL);
+    }
+}
+
+TEST_FIXTURE_SETUP(timer)
+{
+    size_t i;
+    memset(&g_test_5c2e, 0, sizeof(g_test_5c2e));
+    for (i = 0; i < ARRAY_SIZE(g_test_5c2e.tokens); i++)
+    {
+        g_test_5c2e.tokens[i] = (ev_idle_token_t)EV_IDLE_TOKEN_INIT;
+    }
+
+    ASSERT_EQ_INT(ev_loop_init(&g_test_5c2e.loop), 0);
+    ASSERT_EQ_INT(ev_timer_init(g_test_5c2e.loop, &g_test_5c2e.touch_timer), 0);
+    ASSERT_EQ_INT(ev_idle_timer_init(g_test_5c2e.loop, &g_test_5c2e.idle, 0),
+                  EV_EINVAL);
+    ASSERT_EQ_INT(ev_idle_timer_init(g_test_5c2e.loop, &g_test_5c2e.idle,
+                                     TEST_5c2e_TIMEOUT),
+                  0);
+}
+
+TEST_FIXTURE_TEARDOWN(timer)
+{
+    ASSERT_EQ_INT(ev_loop_run(g_test_5c2e.loop, EV_LOOP_MODE_DEFAULT,
+                              EV_INFINITE_TIMEOUT),
+                  0);
+    ASSERT_EQ_INT(ev_loop_exit(g_test_5c2e.loop), 0);
+}
+
+TEST_F(timer, idle)
+{
+    size_t i;
+    for (i = 0; i < ARRAY_SIZE(g_test_5c2e.tokens); i++)
+    {
+        ev_idle_timer_add(g_test_5c2e.idle, &g_test_5c2e.tokens[i],
+                          _test_5c2e_on_expire, (void *)(intptr_t)i);
+    }
+    ev_idle_timer_remove(&g_test_5c2e.tokens[2]);
+    ASSERT_EQ_PTR(g_test_5c2e.tokens[2].owner, NULL);
+
+    /* Keep token 0 alive for a while */
+    ASSERT_EQ_INT(ev_timer_start(g_test_5c2e.touch_timer, TEST_5c2e_TIMEOUT / 2,
+                                 TEST_5c2e_TIMEOUT / 2, _test_5c2e_on_touch,
+                                 NULL),
+                  0);
+
+    ASSERT_EQ_INT(ev_loop_run(g_test_5c2e.loop, EV_LOOP_MODE_DEFAULT,
+                              EV_INFINITE_TIMEOUT),
+                  0);
+
+    /* Removed token never expires, and active token expires last */
+    ASSERT_EQ_INT(g_test_5c2e.cnt_touch, 3);
+    ASSERT_EQ_INT(g_test_5c2e.cnt_expire, 2);
+    ASSERT_EQ_INT(g_test_5c2e.order[0], 1);
+    ASSERT_EQ_INT(g_test_5c2e.order[1], 0);
+}
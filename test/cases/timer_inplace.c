@@ -0,0 +1,143 @@
+#include "test.h"
+
+struct test_e4b0
+{
+    ev_loop_t *s_loop;
+    void      *s_block; /**< One block for all handles. */
+
+    ev_timer_t *s_timer;
+    ev_tcp_t   *s_tcp;
+
+    int f_on_timer;
+    int f_on_timer_close;
+    int f_on_tcp_close;
+
+    void *s_timer_mem; /**< Released in close callback. */
+    void *s_tcp_mem;   /**< Released in close callback. */
+};
+
+struct test_e4b0 g_test_e4b0;
+
+static size_t _align_size_e4b0(size_t size)
+{
+    return ALIGN_ADDR(size, sizeof(void *) * 2);
+}
+
+TEST_FIXTURE_SETUP(timer)
+{
+    memset(&g_test_e4b0, 0, sizeof(g_test_e4b0));
+    ASSERT_EQ_INT(ev_loop_init(&g_test_e4b0.s_loop), 0);
+
+    size_t timer_sz = _align_size_e4b0(ev_timer_size());
+    g_test_e4b0.s_block = ev_malloc(timer_sz + ev_tcp_size());
+    ASSERT_NE_PTR(g_test_e4b0.s_block, NULL);
+}
+
+TEST_FIXTURE_TEARDOWN(timer)
+{
+    ASSERT_EQ_INT(ev_loop_exit(g_test_e4b0.s_loop), 0);
+    ev_free(g_test_e4b0.s_block);
+}
+
+static void _on_timer_e4b0(ev_timer_t *timer, void *arg)
+{
+    (void)timer;
+    (void)arg;
+    g_test_e4b0.f_on_timer = 1;
+}
+
+static void _on_timer_close_e4b0(ev_timer_t *timer, void *arg)
+{
+    (void)timer;
+    (void)arg;
+    g_test_e4b0.f_on_timer_close = 1;
+}
+
+static void _on_tcp_close_e4b0(ev_tcp_t *sock, void *arg)
+{
+    (void)sock;
+    (void)arg;
+    g_test_e4b0.f_on_tcp_close = 1;
+}
+
+TEST_F(timer, inplace)
+{
+    char  *block = g_test_e4b0.s_block;
+    size_t timer_sz = _align_size_e4b0(ev_timer_size());
+
+    ASSERT_EQ_INT(ev_timer_init_inplace(g_test_e4b0.s_loop,
+                                        &g_test_e4b0.s_timer, block),
+                  0);
+    ASSERT_EQ_PTR(g_test_e4b0.s_timer, block);
+    ASSERT_EQ_INT(ev_tcp_init_inplace(g_test_e4b0.s_loop, &g_test_e4b0.s_tcp,
+                                      block + timer_sz),
+                  0);
+    ASSERT_EQ_PTR(g_test_e4b0.s_tcp, block + timer_sz);
+
+    ASSERT_EQ_INT(
+        ev_timer_start(g_test_e4b0.s_timer, 1, 0, _on_timer_e4b0, NULL), 0);
+    ASSERT_EQ_INT(ev_loop_run(g_test_e4b0.s_loop, EV_LOOP_MODE_DEFAULT,
+                              EV_INFINITE_TIMEOUT),
+                  0);
+    ASSERT_EQ_INT(g_test_e4b0.f_on_timer, 1);
+
+    ev_timer_exit(g_test_e4b0.s_timer, _on_timer_close_e4b0, NULL);
+    ev_tcp_exit(g_test_e4b0.s_tcp, _on_tcp_close_e4b0, NULL);
+    ASSERT_EQ_INT(ev_loop_run(g_test_e4b0.s_loop, EV_LOOP_MODE_DEFAULT,
+                              EV_INFINITE_TIMEOUT),
+                  0);
+    ASSERT_EQ_INT(g_test_e4b0.f_on_timer_close, 1);
+    ASSERT_EQ_INT(g_test_e4b0.f_on_tcp_close, 1);
+}
+
+static void _on_timer_close_free_e4b0(ev_timer_t *timer, void *arg)
+{
+    (void)arg;
+    ASSERT_EQ_PTR(timer, g_test_e4b0.s_timer_mem);
+
+    /* Wipe the handle so any later access to it is caught */
+    memset(timer, 0, ev_timer_size());
+    ev_free(timer);
+    g_test_e4b0.s_timer_mem = NULL;
+    g_test_e4b0.f_on_timer_close = 1;
+}
+
+static void _on_tcp_close_free_e4b0(ev_tcp_t *sock, void *arg)
+{
+    (void)arg;
+    ASSERT_EQ_PTR(sock, g_test_e4b0.s_tcp_mem);
+
+    memset(sock, 0, ev_tcp_size());
+    ev_free(sock);
+    g_test_e4b0.s_tcp_mem = NULL;
+    g_test_e4b0.f_on_tcp_close = 1;
+}
+
+TEST_F(timer, inplace_free_in_close_cb)
+{
+    g_test_e4b0.s_timer_mem = ev_malloc(ev_timer_size());
+    ASSERT_NE_PTR(g_test_e4b0.s_timer_mem, NULL);
+    g_test_e4b0.s_tcp_mem = ev_malloc(ev_tcp_size());
+    ASSERT_NE_PTR(g_test_e4b0.s_tcp_mem, NULL);
+
+    ASSERT_EQ_INT(ev_timer_init_inplace(g_test_e4b0.s_loop,
+                                        &g_test_e4b0.s_timer,
+                                        g_test_e4b0.s_timer_mem),
+                  0);
+    ASSERT_EQ_INT(ev_tcp_init_inplace(g_test_e4b0.s_loop, &g_test_e4b0.s_tcp,
+                                      g_test_e4b0.s_tcp_mem),
+                  0);
+    ASSERT_EQ_INT(
+        ev_timer_start(g_test_e4b0.s_timer, 1, 0, _on_timer_e4b0, NULL), 0);
+
+    ev_timer_exit(g_test_e4b0.s_timer, _on_timer_close_free_e4b0, NULL);
+    ev_tcp_exit(g_test_e4b0.s_tcp, _on_tcp_close_free_e4b0, NULL);
+    ASSERT_EQ_INT(ev_loop_run(g_test_e4b0.s_loop, EV_LOOP_MODE_DEFAULT,
+                              EV_INFINITE_TIMEOUT),
+                  0);
+    ASSERT_EQ_INT(g_test_e4b0.f_on_timer, 0);
+    ASSERT_EQ_INT(g_test_e4b0.f_on_timer_close, 1);
+    ASSERT_EQ_INT(g_test_e4b0.f_on_tcp_close, 1);
+    ASSERT_EQ_PTR(g_test_e4b0.s_timer_mem, NULL);
+    ASSERT_EQ_PTR(g_test_e4b0.s_tcp_mem, NULL);
+}
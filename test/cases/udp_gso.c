@@ -0,0 +1,146 @@
+#include "test.h"
+#include <string.h>
+
+#define TEST_4d6a_SEG_SIZE 1000
+#define TEST_4d6a_SEG_CNT  11
+
+struct test_4d6a
+{
+    ev_loop_t *loop;
+    ev_udp_t  *client;
+    ev_udp_t  *server;
+
+    uint8_t w_buf[TEST_4d6a_SEG_SIZE * (TEST_4d6a_SEG_CNT - 1) + 500];
+    int     cnt_send;
+
+    size_t r_pos;
+    size_t cnt_seg;
+    size_t cnt_coalesced;
+};
+
+struct test_4d6a g_test_4d6a;
+
+static void _test_4d6a_on_send(ev_udp_t *udp, ssize_t size, void *arg)
+{
+    (void)udp;
+    (void)arg;
+    ASSERT_EQ_SSIZE(size, sizeof(g_test_4d6a.w_buf));
+    g_test_4d6a.cnt_send++;
+}
+
+static void _test_4d6a_on_recv(ev_udp_t *udp, ev_udp_datagram_t *msgs,
+                               size_t nmsg, int stat, void *arg)
+{
+    size_t i;
+    (void)arg;
+    ASSERT_EQ_INT(stat, 0);
+
+    for (i = 0; i < nmsg; i++)
+    {
+        ASSERT_LE_SIZE(g_test_4d6a.r_pos + msgs[i].size,
+                       sizeof(g_test_4d6a.w_buf));
+        ASSERT_EQ_INT(memcmp(g_test_4d6a.w_buf + g_test_4d6a.r_pos,
+                             msgs[i].data, msgs[i].size),
+                      0);
+        g_test_4d6a.r_pos += msgs[i].size;
+
+        if (msgs[i].seg_size == 0)
+        {
+            ASSERT_LE_SIZE(msgs[i].size, TEST_4d6a_SEG_SIZE);
+            g_test_4d6a.cnt_seg++;
+            continue;
+        }
+
+        ASSERT_EQ_SIZE(msgs[i].seg_size, TEST_4d6a_SEG_SIZE);
+        g_test_4d6a.cnt_seg +=
+            (msgs[i].size + msgs[i].seg_size - 1) / msgs[i].seg_size;
+        g_test_4d6a.cnt_coalesced++;
+    }
+
+    if (g_test_4d6a.r_pos == sizeof(g_test_4d6a.w_buf))
+    {
+        ASSERT_EQ_INT(ev_udp_recv_batch_stop(udp), 0);
+    }
+}
+
+static void _test_4d6a_run(int gro)
+{
+    struct sockaddr_in addr;
+    ASSERT_EQ_INT(ev_ipv4_addr("127.0.0.1", 0, &addr), 0);
+    ASSERT_EQ_INT(ev_udp_bind(g_test_4d6a.server, (struct sockaddr *)&addr, 0),
+                  0);
+    size_t namelen = sizeof(addr);
+    ASSERT_EQ_INT(ev_udp_getsockname(g_test_4d6a.server,
+                                     (struct sockaddr *)&addr, &namelen),
+                  0);
+
+    ASSERT_EQ_INT(ev_udp_send_gso(g_test_4d6a.client, g_test_4d6a.w_buf, 0,
+                                  TEST_4d6a_SEG_SIZE, (struct sockaddr *)&addr,
+                                  _test_4d6a_on_send, NULL),
+                  EV_EINVAL);
+    int ret = ev_udp_send_gso(g_test_4d6a.client, g_test_4d6a.w_buf,
+                              sizeof(g_test_4d6a.w_buf), TEST_4d6a_SEG_SIZE,
+                              (struct sockaddr *)&addr, _test_4d6a_on_send,
+                              NULL);
+#if defined(_WIN32)
+    ASSERT_EQ_INT(ret, EV_ENOSYS);
+    return;
+#endif
+    ASSERT_EQ_INT(ret, 0);
+
+    if (gro)
+    {
+        /* Without kernel support datagrams arrive one by one */
+        if ((ret = ev_udp_set_gro(g_test_4d6a.server, 1)) != EV_ENOSYS)
+        {
+            ASSERT_EQ_INT(ret, 0);
+        }
+    }
+    ASSERT_EQ_INT(ev_udp_recv_batch_start(g_test_4d6a.server, 4, 65535,
+                                          _test_4d6a_on_recv, NULL),
+                  0);
+
+    ASSERT_EQ_INT(ev_loop_run(g_test_4d6a.loop, EV_LOOP_MODE_DEFAULT,
+                              EV_INFINITE_TIMEOUT),
+                  0);
+    ASSERT_EQ_INT(g_test_4d6a.cnt_send, 1);
+    ASSERT_EQ_SIZE(g_test_4d6a.r_pos, sizeof(g_test_4d6a.w_buf));
+    ASSERT_EQ_SIZE(g_test_4d6a.cnt_seg, TEST_4d6a_SEG_CNT);
+}
+
+TEST_FIXTURE_SETUP(udp)
+{
+    size_t i;
+    memset(&g_test_4d6a, 0, sizeof(g_test_4d6a));
+    for (i = 0; i < sizeof(g_test_4d6a.w_buf); i++)
+    {
+        g_test_4d6a.w_buf[i] = (uint8_t)(i % 251);
+    }
+
+    ASSERT_EQ_INT(ev_loop_init(&g_test_4d6a.loop), 0);
+    ASSERT_EQ_INT(ev_udp_init(g_test_4d6a.loop, &g_test_4d6a.client, AF_INET),
+                  0);
+    ASSERT_EQ_INT(ev_udp_init(g_test_4d6a.loop, &g_test_4d6a.server, AF_INET),
+                  0);
+}
+
+TEST_FIXTURE_TEARDOWN(udp)
+{
+    ev_udp_exit(g_test_4d6a.client, NULL, NULL);
+    ev_udp_exit(g_test_4d6a.server, NULL, NULL);
+    ASSERT_EQ_INT(ev_loop_run(g_test_4d6a.loop, EV_LOOP_MODE_DEFAULT,
+                              EV_INFINITE_TIMEOUT),
+                  0);
+    ASSERT_EQ_INT(ev_loop_exit(g_test_4d6a.loop), 0);
+}
+
+TEST_F(udp, gso)
+{
+    _test_4d6a_run(0);
+    ASSERT_EQ_SIZE(g_test_4d6a.cnt_coalesced, 0);
+}
+
+TEST_F(udp, gro)
+{
+    _test_4d6a_run(1);
+}
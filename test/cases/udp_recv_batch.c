@@ -0,0 +1,123 @@
+#include "test.h"
+#include <string.h>
+
+#define TEST_9b47_MSG_CNT 20
+#define TEST_9b47_BATCH   8
+
+struct test_9b47
+{
+    ev_loop_t *loop;
+    ev_udp_t  *client;
+    ev_udp_t  *server;
+
+    size_t seq[TEST_9b47_MSG_CNT];
+    size_t cnt_send;
+    size_t cnt_recv;
+    size_t cnt_cb;
+};
+
+struct test_9b47 g_test_9b47;
+
+static void _test_9b47_on_recv(ev_udp_t *udp, ev_udp_datagram_t *msgs,
+                               size_t nmsg, int stat, void *arg)
+{
+    size_t i;
+    ASSERT_EQ_PTR(arg, &g_test_9b47);
+    ASSERT_EQ_INT(stat, 0);
+    ASSERT_LE_SIZE(nmsg, TEST_9b47_BATCH);
+    g_test_9b47.cnt_cb++;
+
+    for (i = 0; i < nmsg; i++)
+    {
+        ASSERT_EQ_SIZE(msgs[i].size, sizeof(size_t));
+        ASSERT_EQ_INT(msgs[i].addr->sa_family, AF_INET);
+
+        size_t seq;
+        memcpy(&seq, msgs[i].data, sizeof(seq));
+        ASSERT_EQ_SIZE(seq, g_test_9b47.cnt_recv);
+        g_test_9b47.cnt_recv++;
+    }
+
+    if (g_test_9b47.cnt_recv == TEST_9b47_MSG_CNT)
+    {
+        /* Safe to stop in callback */
+        ASSERT_EQ_INT(ev_udp_recv_batch_stop(udp), 0);
+    }
+}
+
+static void _test_9b47_on_send(ev_udp_t *udp, ssize_t size, void *arg)
+{
+    (void)udp;
+    (void)arg;
+    ASSERT_EQ_SSIZE(size, sizeof(size_t));
+    g_test_9b47.cnt_send++;
+}
+
+TEST_FIXTURE_SETUP(udp)
+{
+    memset(&g_test_9b47, 0, sizeof(g_test_9b47));
+    ASSERT_EQ_INT(ev_loop_init(&g_test_9b47.loop), 0);
+    ASSERT_EQ_INT(ev_udp_init(g_test_9b47.loop, &g_test_9b47.client, AF_INET),
+                  0);
+    ASSERT_EQ_INT(ev_udp_init(g_test_9b47.loop, &g_test_9b47.server, AF_INET),
+                  0);
+}
+
+TEST_FIXTURE_TEARDOWN(udp)
+{
+    ev_udp_exit(g_test_9b47.client, NULL, NULL);
+    ev_udp_exit(g_test_9b47.server, NULL, NULL);
+    ASSERT_EQ_INT(ev_loop_run(g_test_9b47.loop, EV_LOOP_MODE_DEFAULT,
+                              EV_INFINITE_TIMEOUT),
+                  0);
+    ASSERT_EQ_INT(ev_loop_exit(g_test_9b47.loop), 0);
+}
+
+TEST_F(udp, recv_batch)
+{
+    size_t             i;
+    struct sockaddr_in addr;
+    ASSERT_EQ_INT(ev_ipv4_addr("127.0.0.1", 0, &addr), 0);
+    ASSERT_EQ_INT(ev_udp_bind(g_test_9b47.server, (struct sockaddr *)&addr, 0),
+                  0);
+
+    int ret = ev_udp_recv_batch_start(g_test_9b47.server, TEST_9b47_BATCH,
+                                      64, _test_9b47_on_recv, &g_test_9b47);
+#if defined(_WIN32)
+    ASSERT_EQ_INT(ret, EV_ENOSYS);
+    return;
+#endif
+    ASSERT_EQ_INT(ret, 0);
+    ASSERT_EQ_INT(ev_udp_recv_batch_start(g_test_9b47.server, TEST_9b47_BATCH,
+                                          64, _test_9b47_on_recv, NULL),
+                  EV_EBUSY);
+
+    size_t namelen = sizeof(addr);
+    ASSERT_EQ_INT(ev_udp_getsockname(g_test_9b47.server,
+                                     (struct sockaddr *)&addr, &namelen),
+                  0);
+    ASSERT_EQ_INT(ev_udp_connect(g_test_9b47.client, (struct sockaddr *)&addr),
+                  0);
+
+    for (i = 0; i < TEST_9b47_MSG_CNT; i++)
+    {
+        g_test_9b47.seq[i] = i;
+        ev_buf_t buf = ev_buf_make(&g_test_9b47.seq[i], sizeof(size_t));
+        ASSERT_EQ_INT(ev_udp_send(g_test_9b47.client, &buf, 1, NULL,
+                                  _test_9b47_on_send, NULL),
+                      0);
+    }
+
+    ASSERT_EQ_INT(ev_loop_run(g_test_9b47.loop, EV_LOOP_MODE_DEFAULT,
+                              EV_INFINITE_TIMEOUT),
+                  0);
+    ASSERT_EQ_SIZE(g_test_9b47.cnt_send, TEST_9b47_MSG_CNT);
+    ASSERT_EQ_SIZE(g_test_9b47.cnt_recv, TEST_9b47_MSG_CNT);
+    ASSERT_LT_SIZE(g_test_9b47.cnt_cb, TEST_9b47_MSG_CNT);
+    ASSERT_EQ_INT(ev_udp_recv_batch_stop(g_test_9b47.server), EV_ENOENT);
+
+    /* Size of batch context does not fit in size_t */
+    ASSERT_EQ_INT(ev_udp_recv_batch_start(g_test_9b47.server, TEST_9b47_BATCH,
+                                          SIZE_MAX, _test_9b47_on_recv, NULL),
+                  EV_ENOMEM);
+}
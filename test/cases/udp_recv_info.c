@@ -0,0 +1,149 @@
+#include "test.h"
+#include <string.h>
+#include <time.h>
+
+#define TEST_c6e3_FLAGS                                                        \
+    (EV_UDP_RECV_PKTINFO | EV_UDP_RECV_TIMESTAMP | EV_UDP_RECV_DROPS)
+
+struct test_c6e3
+{
+    ev_loop_t *loop;
+    ev_udp_t  *client;
+    ev_udp_t  *server;
+
+    uint64_t w_data;
+    uint64_t r_data;
+    time_t   t_begin;
+    int      cnt_recv;
+};
+
+struct test_c6e3 g_test_c6e3;
+
+static void _test_c6e3_check_info(const ev_udp_recv_info_t *info)
+{
+    ASSERT_NE_PTR(info, NULL);
+    ASSERT_EQ_UINT64(info->flags, TEST_c6e3_FLAGS);
+
+    char ip[64];
+    ASSERT_EQ_INT(info->dst_addr.ss_family, AF_INET);
+    ASSERT_EQ_INT(ev_ipv4_name((struct sockaddr_in *)&info->dst_addr, NULL, ip,
+                               sizeof(ip)),
+                  0);
+    ASSERT_EQ_STR(ip, "127.0.0.1");
+    ASSERT_GT_UINT64(info->ifindex, 0);
+
+    uint64_t sec = info->timestamp / 1000000000;
+    ASSERT_GE_UINT64(sec, (uint64_t)g_test_c6e3.t_begin);
+    ASSERT_LE_UINT64(sec, (uint64_t)time(NULL));
+
+    ASSERT_EQ_UINT64(info->drops, 0);
+}
+
+static void _test_c6e3_on_send(ev_udp_t *udp, ssize_t size, void *arg)
+{
+    (void)udp;
+    (void)arg;
+    ASSERT_EQ_SSIZE(size, sizeof(g_test_c6e3.w_data));
+}
+
+static void _test_c6e3_on_recv(ev_udp_t *udp, const struct sockaddr *addr,
+                               ssize_t size, void *arg)
+{
+    (void)addr;
+    (void)arg;
+    ASSERT_EQ_SSIZE(size, sizeof(g_test_c6e3.r_data));
+    _test_c6e3_check_info(ev_udp_recv_info(udp));
+    g_test_c6e3.cnt_recv++;
+}
+
+static void _test_c6e3_on_recv_ring(ev_udp_t *udp, ev_udp_datagram_t *msg,
+                                    int stat, void *arg)
+{
+    (void)arg;
+    ASSERT_EQ_INT(stat, 0);
+    _test_c6e3_check_info(msg->info);
+    g_test_c6e3.cnt_recv++;
+
+    ev_udp_recv_release(udp, msg);
+    ASSERT_EQ_INT(ev_udp_recv_stop(udp), 0);
+}
+
+static void _test_c6e3_send(void)
+{
+    struct sockaddr_in addr;
+    size_t             namelen = sizeof(addr);
+    ASSERT_EQ_INT(ev_udp_getsockname(g_test_c6e3.server,
+                                     (struct sockaddr *)&addr, &namelen),
+                  0);
+
+    ev_buf_t buf = ev_buf_make(&g_test_c6e3.w_data, sizeof(g_test_c6e3.w_data));
+    ASSERT_EQ_INT(ev_udp_send(g_test_c6e3.client, &buf, 1,
+                              (struct sockaddr *)&addr, _test_c6e3_on_send,
+                              NULL),
+                  0);
+}
+
+TEST_FIXTURE_SETUP(udp)
+{
+    memset(&g_test_c6e3, 0, sizeof(g_test_c6e3));
+    g_test_c6e3.t_begin = time(NULL);
+
+    ASSERT_EQ_INT(ev_loop_init(&g_test_c6e3.loop), 0);
+    ASSERT_EQ_INT(ev_udp_init(g_test_c6e3.loop, &g_test_c6e3.client, AF_INET),
+                  0);
+    ASSERT_EQ_INT(ev_udp_init(g_test_c6e3.loop, &g_test_c6e3.server, AF_INET),
+                  0);
+
+    struct sockaddr_in addr;
+    ASSERT_EQ_INT(ev_ipv4_addr("127.0.0.1", 0, &addr), 0);
+    ASSERT_EQ_INT(ev_udp_bind(g_test_c6e3.server, (struct sockaddr *)&addr, 0),
+                  0);
+}
+
+TEST_FIXTURE_TEARDOWN(udp)
+{
+    ev_udp_exit(g_test_c6e3.client, NULL, NULL);
+    ev_udp_exit(g_test_c6e3.server, NULL, NULL);
+    ASSERT_EQ_INT(ev_loop_run(g_test_c6e3.loop, EV_LOOP_MODE_DEFAULT,
+                              EV_INFINITE_TIMEOUT),
+                  0);
+    ASSERT_EQ_INT(ev_loop_exit(g_test_c6e3.loop), 0);
+}
+
+TEST_F(udp, recv_info)
+{
+    ASSERT_EQ_PTR(ev_udp_recv_info(g_test_c6e3.server), NULL);
+    ASSERT_EQ_INT(ev_udp_set_recv_info(g_test_c6e3.server, 0x80), EV_EINVAL);
+
+    int ret = ev_udp_set_recv_info(g_test_c6e3.server, TEST_c6e3_FLAGS);
+#if defined(_WIN32)
+    ASSERT_EQ_INT(ret, EV_ENOSYS);
+    return;
+#endif
+    ASSERT_EQ_INT(ret, 0);
+
+    /* Single receive */
+    ev_buf_t buf = ev_buf_make(&g_test_c6e3.r_data, sizeof(g_test_c6e3.r_data));
+    ASSERT_EQ_INT(ev_udp_recv(g_test_c6e3.server, &buf, 1, _test_c6e3_on_recv,
+                              NULL),
+                  0);
+    _test_c6e3_send();
+    ASSERT_EQ_INT(ev_loop_run(g_test_c6e3.loop, EV_LOOP_MODE_DEFAULT,
+                              EV_INFINITE_TIMEOUT),
+                  0);
+    ASSERT_EQ_INT(g_test_c6e3.cnt_recv, 1);
+
+    /* Continuous receive */
+    ASSERT_EQ_INT(ev_udp_recv_start(g_test_c6e3.server, 2, 64,
+                                    _test_c6e3_on_recv_ring, NULL),
+                  0);
+    _test_c6e3_send();
+    ASSERT_EQ_INT(ev_loop_run(g_test_c6e3.loop, EV_LOOP_MODE_DEFAULT,
+                              EV_INFINITE_TIMEOUT),
+                  0);
+    ASSERT_EQ_INT(g_test_c6e3.cnt_recv, 2);
+
+    /* Disabled */
+    ASSERT_EQ_INT(ev_udp_set_recv_info(g_test_c6e3.server, 0), 0);
+    ASSERT_EQ_PTR(ev_udp_recv_info(g_test_c6e3.server), NULL);
+}
@@ -0,0 +1,267 @@
+#include "test.h"
+#include <string.h>
+
+#define TEST_b15f_MSG_CNT 10
+#define TEST_b15f_BUF_CNT 4
+
+struct test_b15f
+{
+    ev_loop_t  *loop;
+    ev_udp_t   *client;
+    ev_udp_t   *server;
+    ev_timer_t *timer;
+
+    size_t seq[TEST_b15f_MSG_CNT];
+    size_t cnt_recv;
+
+    ev_udp_datagram_t *held[TEST_b15f_BUF_CNT];
+    size_t             cnt_held;
+    size_t             cnt_release;
+
+    ev_udp_t *peer; /**< Peer of server, closed to make server read fail */
+    int       recv_err;
+};
+
+struct test_b15f g_test_b15f;
+
+static void _test_b15f_on_send(ev_udp_t *udp, ssize_t size, void *arg)
+{
+    (void)udp;
+    (void)arg;
+    ASSERT_EQ_SSIZE(size, sizeof(size_t));
+}
+
+static void _test_b15f_on_recv(ev_udp_t *udp, ev_udp_datagram_t *msg,
+                               int stat, void *arg)
+{
+    ASSERT_EQ_PTR(arg, &g_test_b15f);
+    ASSERT_EQ_INT(stat, 0);
+    ASSERT_EQ_SIZE(msg->size, sizeof(size_t));
+
+    size_t seq;
+    memcpy(&seq, msg->data, sizeof(seq));
+    ASSERT_EQ_SIZE(seq, g_test_b15f.cnt_recv);
+    g_test_b15f.cnt_recv++;
+
+    /* Hold buffers until the ring is exhausted */
+    if (g_test_b15f.cnt_release == 0)
+    {
+        ASSERT_LT_SIZE(g_test_b15f.cnt_held, TEST_b15f_BUF_CNT);
+        g_test_b15f.held[g_test_b15f.cnt_held++] = msg;
+        return;
+    }
+
+    ev_udp_recv_release(udp, msg);
+    if (g_test_b15f.cnt_recv == TEST_b15f_MSG_CNT)
+    {
+        ASSERT_EQ_INT(ev_udp_recv_stop(udp), 0);
+    }
+}
+
+static void _test_b15f_on_timer(ev_timer_t *timer, void *arg)
+{
+    size_t i;
+    (void)arg;
+    ev_timer_exit(timer, NULL, NULL);
+
+    /* Nothing is received while every buffer is borrowed */
+    ASSERT_EQ_SIZE(g_test_b15f.cnt_held, TEST_b15f_BUF_CNT);
+    ASSERT_EQ_SIZE(g_test_b15f.cnt_recv, TEST_b15f_BUF_CNT);
+
+    for (i = 0; i < g_test_b15f.cnt_held; i++)
+    {
+        ev_udp_recv_release(g_test_b15f.server, g_test_b15f.held[i]);
+        g_test_b15f.cnt_release++;
+    }
+}
+
+static void _test_b15f_on_recv_err(ev_udp_t *udp, ev_udp_datagram_t *msg,
+                                   int stat, void *arg)
+{
+    (void)udp;
+    (void)arg;
+    if (stat != 0)
+    {
+        ASSERT_EQ_PTR(msg, NULL);
+        g_test_b15f.recv_err = stat;
+        return;
+    }
+
+    ASSERT_LT_SIZE(g_test_b15f.cnt_held, TEST_b15f_BUF_CNT);
+    g_test_b15f.held[g_test_b15f.cnt_held++] = msg;
+    g_test_b15f.cnt_recv++;
+}
+
+static void _test_b15f_on_server_send(ev_udp_t *udp, ssize_t size, void *arg)
+{
+    (void)udp;
+    (void)size;
+    (void)arg;
+}
+
+static void _test_b15f_on_peer_send(ev_udp_t *udp, ssize_t size, void *arg)
+{
+    (void)arg;
+    ASSERT_EQ_SSIZE(size, sizeof(size_t));
+    if (g_test_b15f.cnt_recv == 0)
+    {
+        return;
+    }
+
+    /* Second datagram is queued, the next send of server is refused */
+    ev_udp_exit(udp, NULL, NULL);
+    ev_buf_t buf = ev_buf_make(&g_test_b15f.seq[0], sizeof(size_t));
+    ASSERT_EQ_INT(ev_udp_send(g_test_b15f.server, &buf, 1, NULL,
+                              _test_b15f_on_server_send, NULL),
+                  0);
+}
+
+TEST_FIXTURE_SETUP(udp)
+{
+    memset(&g_test_b15f, 0, sizeof(g_test_b15f));
+    ASSERT_EQ_INT(ev_loop_init(&g_test_b15f.loop), 0);
+    ASSERT_EQ_INT(ev_timer_init(g_test_b15f.loop, &g_test_b15f.timer), 0);
+    ASSERT_EQ_INT(ev_udp_init(g_test_b15f.loop, &g_test_b15f.client, AF_INET),
+                  0);
+    ASSERT_EQ_INT(ev_udp_init(g_test_b15f.loop, &g_test_b15f.server, AF_INET),
+                  0);
+}
+
+TEST_FIXTURE_TEARDOWN(udp)
+{
+    ev_udp_exit(g_test_b15f.client, NULL, NULL);
+    ev_udp_exit(g_test_b15f.server, NULL, NULL);
+    ASSERT_EQ_INT(ev_loop_run(g_test_b15f.loop, EV_LOOP_MODE_DEFAULT,
+                              EV_INFINITE_TIMEOUT),
+                  0);
+    ASSERT_EQ_INT(ev_loop_exit(g_test_b15f.loop), 0);
+}
+
+TEST_F(udp, recv_ring)
+{
+    size_t             i;
+    struct sockaddr_in addr;
+    ASSERT_EQ_INT(ev_ipv4_addr("127.0.0.1", 0, &addr), 0);
+    ASSERT_EQ_INT(ev_udp_bind(g_test_b15f.server, (struct sockaddr *)&addr, 0),
+                  0);
+
+    int ret = ev_udp_recv_start(g_test_b15f.server, TEST_b15f_BUF_CNT, 64,
+                                _test_b15f_on_recv, &g_test_b15f);
+#if defined(_WIN32)
+    ASSERT_EQ_INT(ret, EV_ENOSYS);
+    ev_timer_exit(g_test_b15f.timer, NULL, NULL);
+    return;
+#endif
+    ASSERT_EQ_INT(ret, 0);
+
+    ev_buf_t buf = ev_buf_make(g_test_b15f.seq, sizeof(size_t));
+    ASSERT_EQ_INT(ev_udp_recv(g_test_b15f.server, &buf, 1, NULL, NULL),
+                  EV_EBUSY);
+    ASSERT_EQ_INT(ev_udp_recv_batch_start(g_test_b15f.server, 1, 64, NULL,
+                                          NULL),
+                  EV_EBUSY);
+
+    size_t namelen = sizeof(addr);
+    ASSERT_EQ_INT(ev_udp_getsockname(g_test_b15f.server,
+                                     (struct sockaddr *)&addr, &namelen),
+                  0);
+    for (i = 0; i < TEST_b15f_MSG_CNT; i++)
+    {
+        g_test_b15f.seq[i] = i;
+        buf = ev_buf_make(&g_test_b15f.seq[i], sizeof(size_t));
+        ASSERT_EQ_INT(ev_udp_send(g_test_b15f.client, &buf, 1,
+                                  (struct sockaddr *)&addr, _test_b15f_on_send,
+                                  NULL),
+                      0);
+    }
+    ASSERT_EQ_INT(ev_timer_start(g_test_b15f.timer, 50, 0, _test_b15f_on_timer,
+                                 NULL),
+                  0);
+
+    ASSERT_EQ_INT(ev_loop_run(g_test_b15f.loop, EV_LOOP_MODE_DEFAULT,
+                              EV_INFINITE_TIMEOUT),
+                  0);
+    ASSERT_EQ_SIZE(g_test_b15f.cnt_recv, TEST_b15f_MSG_CNT);
+    ASSERT_EQ_SIZE(g_test_b15f.cnt_release, TEST_b15f_BUF_CNT);
+    ASSERT_EQ_INT(ev_udp_recv_stop(g_test_b15f.server), EV_ENOENT);
+
+    /* Ring is released, so receive can start again */
+    ASSERT_EQ_INT(ev_udp_recv_start(g_test_b15f.server, 1, 64,
+                                    _test_b15f_on_recv, &g_test_b15f),
+                  0);
+    ASSERT_EQ_INT(ev_udp_recv_stop(g_test_b15f.server), 0);
+
+    /* Size of ring does not fit in size_t */
+    ASSERT_EQ_INT(ev_udp_recv_start(g_test_b15f.server, 2, SIZE_MAX,
+                                    _test_b15f_on_recv, &g_test_b15f),
+                  EV_ENOMEM);
+}
+
+TEST_F(udp, recv_ring_error)
+{
+    size_t             i;
+    struct sockaddr_in addr;
+    ev_timer_exit(g_test_b15f.timer, NULL, NULL);
+    ASSERT_EQ_INT(ev_udp_init(g_test_b15f.loop, &g_test_b15f.peer, AF_INET),
+                  0);
+
+    ASSERT_EQ_INT(ev_ipv4_addr("127.0.0.1", 0, &addr), 0);
+    ASSERT_EQ_INT(ev_udp_bind(g_test_b15f.server, (struct sockaddr *)&addr, 0),
+                  0);
+    ASSERT_EQ_INT(ev_udp_bind(g_test_b15f.peer, (struct sockaddr *)&addr, 0),
+                  0);
+
+    int ret = ev_udp_recv_start(g_test_b15f.server, TEST_b15f_BUF_CNT, 64,
+                                _test_b15f_on_recv_err, NULL);
+#if defined(_WIN32)
+    ASSERT_EQ_INT(ret, EV_ENOSYS);
+    ev_udp_exit(g_test_b15f.peer, NULL, NULL);
+    return;
+#endif
+    ASSERT_EQ_INT(ret, 0);
+
+    /* Connected, so server gets ICMP errors from peer */
+    size_t namelen = sizeof(addr);
+    ASSERT_EQ_INT(ev_udp_getsockname(g_test_b15f.peer, (struct sockaddr *)&addr,
+                                     &namelen),
+                  0);
+    ASSERT_EQ_INT(ev_udp_connect(g_test_b15f.server, (struct sockaddr *)&addr),
+                  0);
+    namelen = sizeof(addr);
+    ASSERT_EQ_INT(ev_udp_getsockname(g_test_b15f.server,
+                                     (struct sockaddr *)&addr, &namelen),
+                  0);
+    ASSERT_EQ_INT(ev_udp_connect(g_test_b15f.peer, (struct sockaddr *)&addr),
+                  0);
+
+    for (i = 0; i < 2; i++)
+    {
+        g_test_b15f.seq[i] = i;
+        ev_buf_t buf = ev_buf_make(&g_test_b15f.seq[i], sizeof(size_t));
+        ASSERT_EQ_INT(ev_udp_send(g_test_b15f.peer, &buf, 1, NULL,
+                                  _test_b15f_on_peer_send, NULL),
+                      0);
+
+        while (g_test_b15f.cnt_recv == 0)
+        {
+            ev_loop_run(g_test_b15f.loop, EV_LOOP_MODE_ONCE, 10);
+        }
+    }
+
+    /* Read error stops the ring and deactivates server */
+    ASSERT_EQ_INT(ev_loop_run(g_test_b15f.loop, EV_LOOP_MODE_DEFAULT,
+                              EV_INFINITE_TIMEOUT),
+                  0);
+    ASSERT_EQ_INT(g_test_b15f.recv_err, EV_ECONNREFUSED);
+    ASSERT_EQ_INT(ev_udp_recv_stop(g_test_b15f.server), EV_ENOENT);
+
+    /* Borrowed buffers are still valid */
+    ASSERT_GE_SIZE(g_test_b15f.cnt_held, 1);
+    for (i = 0; i < g_test_b15f.cnt_held; i++)
+    {
+        size_t seq;
+        memcpy(&seq, g_test_b15f.held[i]->data, sizeof(seq));
+        ASSERT_EQ_SIZE(seq, i);
+        ev_udp_recv_release(g_test_b15f.server, g_test_b15f.held[i]);
+    }
+}
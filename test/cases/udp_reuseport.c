@@ -0,0 +1,161 @@
+#include "test.h"
+#include <string.h>
+
+#define TEST_85a9_CLIENT_CNT 16
+
+struct test_85a9
+{
+    ev_loop_t *loop;
+    ev_udp_t  *servers[2];
+    ev_udp_t  *clients[TEST_85a9_CLIENT_CNT];
+
+    uint32_t magic;
+    size_t   cnt_recv[2];
+    size_t   cnt_total;
+};
+
+struct test_85a9 g_test_85a9;
+
+static void _test_85a9_on_send(ev_udp_t *udp, ssize_t size, void *arg)
+{
+    (void)udp;
+    (void)arg;
+    ASSERT_EQ_SSIZE(size, sizeof(g_test_85a9.magic));
+}
+
+static void _test_85a9_on_recv(ev_udp_t *udp, ev_udp_datagram_t *msg,
+                               int stat, void *arg)
+{
+    size_t i;
+    size_t idx = (size_t)(uintptr_t)arg;
+    ASSERT_EQ_INT(stat, 0);
+    ASSERT_EQ_SIZE(msg->size, sizeof(g_test_85a9.magic));
+    ev_udp_recv_release(udp, msg);
+
+    g_test_85a9.cnt_recv[idx]++;
+    if (++g_test_85a9.cnt_total == TEST_85a9_CLIENT_CNT)
+    {
+        for (i = 0; i < ARRAY_SIZE(g_test_85a9.servers); i++)
+        {
+            ASSERT_EQ_INT(ev_udp_recv_stop(g_test_85a9.servers[i]), 0);
+        }
+    }
+}
+
+TEST_FIXTURE_SETUP(udp)
+{
+    size_t i;
+    memset(&g_test_85a9, 0, sizeof(g_test_85a9));
+    g_test_85a9.magic = 0x85a9;
+
+    ASSERT_EQ_INT(ev_loop_init(&g_test_85a9.loop), 0);
+    for (i = 0; i < ARRAY_SIZE(g_test_85a9.servers); i++)
+    {
+        ASSERT_EQ_INT(
+            ev_udp_init(g_test_85a9.loop, &g_test_85a9.servers[i], AF_INET), 0);
+    }
+    for (i = 0; i < ARRAY_SIZE(g_test_85a9.clients); i++)
+    {
+        ASSERT_EQ_INT(
+            ev_udp_init(g_test_85a9.loop, &g_test_85a9.clients[i], AF_INET), 0);
+    }
+}
+
+TEST_FIXTURE_TEARDOWN(udp)
+{
+    size_t i;
+    for (i = 0; i < ARRAY_SIZE(g_test_85a9.servers); i++)
+    {
+        ev_udp_exit(g_test_85a9.servers[i], NULL, NULL);
+    }
+    for (i = 0; i < ARRAY_SIZE(g_test_85a9.clients); i++)
+    {
+        ev_udp_exit(g_test_85a9.clients[i], NULL, NULL);
+    }
+    ASSERT_EQ_INT(ev_loop_run(g_test_85a9.loop, EV_LOOP_MODE_DEFAULT,
+                              EV_INFINITE_TIMEOUT),
+                  0);
+    ASSERT_EQ_INT(ev_loop_exit(g_test_85a9.loop), 0);
+}
+
+TEST_F(udp, setopt)
+{
+    int       val = 0;
+    ev_udp_t *udp = g_test_85a9.servers[0];
+
+    ASSERT_EQ_INT(ev_udp_setopt(udp, EV_UDP_OPT_RCVBUF, 65536), 0);
+    ASSERT_EQ_INT(ev_udp_getopt(udp, EV_UDP_OPT_RCVBUF, &val), 0);
+    ASSERT_GE_INT(val, 65536);
+
+    ASSERT_EQ_INT(ev_udp_setopt(udp, EV_UDP_OPT_SNDBUF, 65536), 0);
+    ASSERT_EQ_INT(ev_udp_getopt(udp, EV_UDP_OPT_SNDBUF, &val), 0);
+    ASSERT_GE_INT(val, 65536);
+
+    int ret = ev_udp_setopt(udp, EV_UDP_OPT_TOS, 46 << 2);
+#if defined(_WIN32)
+    ASSERT_EQ_INT(ret, EV_ENOSYS);
+    return;
+#endif
+    ASSERT_EQ_INT(ret, 0);
+    ASSERT_EQ_INT(ev_udp_getopt(udp, EV_UDP_OPT_TOS, &val), 0);
+    ASSERT_EQ_INT(val, 46 << 2);
+
+    /* Needs CAP_NET_ADMIN */
+    if ((ret = ev_udp_setopt(udp, EV_UDP_OPT_RCVBUFFORCE, 1 << 20)) != EV_EPERM)
+    {
+        ASSERT_EQ_INT(ret, 0);
+        ASSERT_EQ_INT(ev_udp_getopt(udp, EV_UDP_OPT_RCVBUFFORCE, &val), 0);
+        ASSERT_GE_INT(val, 1 << 20);
+    }
+}
+
+TEST_F(udp, reuseport)
+{
+    size_t             i;
+    struct sockaddr_in addr;
+    ASSERT_EQ_INT(ev_ipv4_addr("127.0.0.1", 0, &addr), 0);
+
+    int ret = ev_udp_bind(g_test_85a9.servers[0], (struct sockaddr *)&addr,
+                          EV_UDP_REUSEPORT);
+#if defined(_WIN32)
+    ASSERT_EQ_INT(ret, EV_ENOSYS);
+    return;
+#endif
+    ASSERT_EQ_INT(ret, 0);
+
+    size_t namelen = sizeof(addr);
+    ASSERT_EQ_INT(ev_udp_getsockname(g_test_85a9.servers[0],
+                                     (struct sockaddr *)&addr, &namelen),
+                  0);
+    ASSERT_EQ_INT(ev_udp_bind(g_test_85a9.servers[1], (struct sockaddr *)&addr,
+                              EV_UDP_REUSEPORT),
+                  0);
+    ASSERT_EQ_INT(ev_udp_set_reuseport_cpu(g_test_85a9.servers[1], 0),
+                  EV_EINVAL);
+    ASSERT_EQ_INT(ev_udp_set_reuseport_cpu(g_test_85a9.servers[1], 2), 0);
+
+    for (i = 0; i < ARRAY_SIZE(g_test_85a9.servers); i++)
+    {
+        ASSERT_EQ_INT(ev_udp_recv_start(g_test_85a9.servers[i], 4, 64,
+                                        _test_85a9_on_recv, (void *)i),
+                      0);
+    }
+
+    /* Each client has its own source port */
+    for (i = 0; i < ARRAY_SIZE(g_test_85a9.clients); i++)
+    {
+        ev_buf_t buf =
+            ev_buf_make(&g_test_85a9.magic, sizeof(g_test_85a9.magic));
+        ASSERT_EQ_INT(ev_udp_send(g_test_85a9.clients[i], &buf, 1,
+                                  (struct sockaddr *)&addr, _test_85a9_on_send,
+                                  NULL),
+                      0);
+    }
+
+    ASSERT_EQ_INT(ev_loop_run(g_test_85a9.loop, EV_LOOP_MODE_DEFAULT,
+                              EV_INFINITE_TIMEOUT),
+                  0);
+    ASSERT_EQ_SIZE(g_test_85a9.cnt_total, TEST_85a9_CLIENT_CNT);
+    ASSERT_EQ_SIZE(g_test_85a9.cnt_recv[0] + g_test_85a9.cnt_recv[1],
+                   TEST_85a9_CLIENT_CNT);
+}
@@ -0,0 +1,124 @@
+#include "test.h"
+#include <string.h>
+
+#define TEST_e2c8_MSG_CNT 100
+#define TEST_e2c8_BAD_IDX 50
+
+struct test_e2c8
+{
+    ev_loop_t *loop;
+    ev_udp_t  *client;
+    ev_udp_t  *server;
+
+    size_t            seq[TEST_e2c8_MSG_CNT];
+    uint8_t           big[70000];
+    ev_udp_datagram_t msgs[TEST_e2c8_MSG_CNT];
+    size_t            cnt_send;
+    size_t            cnt_send_err;
+
+    size_t   r_seq;
+    ev_buf_t r_buf;
+    size_t   cnt_recv;
+};
+
+struct test_e2c8 g_test_e2c8;
+
+static void _test_e2c8_on_send(ev_udp_t *udp, ssize_t size, void *arg)
+{
+    (void)udp;
+    ASSERT_EQ_PTR(arg, &g_test_e2c8);
+
+    if (size == EV_EMSGSIZE)
+    {
+        g_test_e2c8.cnt_send_err++;
+        return;
+    }
+    ASSERT_EQ_SSIZE(size, sizeof(size_t));
+    g_test_e2c8.cnt_send++;
+}
+
+static void _test_e2c8_on_recv(ev_udp_t *udp, const struct sockaddr *addr,
+                               ssize_t size, void *arg)
+{
+    (void)addr;
+    (void)arg;
+    ASSERT_EQ_SSIZE(size, sizeof(size_t));
+
+    /* Oversized datagram is never sent */
+    size_t expect = g_test_e2c8.cnt_recv;
+    if (expect >= TEST_e2c8_BAD_IDX)
+    {
+        expect++;
+    }
+    ASSERT_EQ_SIZE(g_test_e2c8.r_seq, expect);
+
+    if (++g_test_e2c8.cnt_recv == TEST_e2c8_MSG_CNT - 1)
+    {
+        return;
+    }
+    ASSERT_EQ_INT(
+        ev_udp_recv(udp, &g_test_e2c8.r_buf, 1, _test_e2c8_on_recv, NULL), 0);
+}
+
+TEST_FIXTURE_SETUP(udp)
+{
+    memset(&g_test_e2c8, 0, sizeof(g_test_e2c8));
+    ASSERT_EQ_INT(ev_loop_init(&g_test_e2c8.loop), 0);
+    ASSERT_EQ_INT(ev_udp_init(g_test_e2c8.loop, &g_test_e2c8.client, AF_INET),
+                  0);
+    ASSERT_EQ_INT(ev_udp_init(g_test_e2c8.loop, &g_test_e2c8.server, AF_INET),
+                  0);
+}
+
+TEST_FIXTURE_TEARDOWN(udp)
+{
+    ev_udp_exit(g_test_e2c8.client, NULL, NULL);
+    ev_udp_exit(g_test_e2c8.server, NULL, NULL);
+    ASSERT_EQ_INT(ev_loop_run(g_test_e2c8.loop, EV_LOOP_MODE_DEFAULT,
+                              EV_INFINITE_TIMEOUT),
+                  0);
+    ASSERT_EQ_INT(ev_loop_exit(g_test_e2c8.loop), 0);
+}
+
+TEST_F(udp, send_batch)
+{
+    size_t             i;
+    struct sockaddr_in addr;
+    ASSERT_EQ_INT(ev_ipv4_addr("127.0.0.1", 0, &addr), 0);
+    ASSERT_EQ_INT(ev_udp_bind(g_test_e2c8.server, (struct sockaddr *)&addr, 0),
+                  0);
+    size_t namelen = sizeof(addr);
+    ASSERT_EQ_INT(ev_udp_getsockname(g_test_e2c8.server,
+                                     (struct sockaddr *)&addr, &namelen),
+                  0);
+
+    for (i = 0; i < TEST_e2c8_MSG_CNT; i++)
+    {
+        g_test_e2c8.seq[i] = i;
+        g_test_e2c8.msgs[i].addr = (struct sockaddr *)&addr;
+        g_test_e2c8.msgs[i].data = &g_test_e2c8.seq[i];
+        g_test_e2c8.msgs[i].size = sizeof(size_t);
+    }
+    g_test_e2c8.msgs[TEST_e2c8_BAD_IDX].data = g_test_e2c8.big;
+    g_test_e2c8.msgs[TEST_e2c8_BAD_IDX].size = sizeof(g_test_e2c8.big);
+
+    ASSERT_EQ_SSIZE(ev_udp_send_batch(g_test_e2c8.client, g_test_e2c8.msgs, 0,
+                                      _test_e2c8_on_send, &g_test_e2c8),
+                    EV_EINVAL);
+    ASSERT_EQ_SSIZE(ev_udp_send_batch(g_test_e2c8.client, g_test_e2c8.msgs,
+                                      TEST_e2c8_MSG_CNT, _test_e2c8_on_send,
+                                      &g_test_e2c8),
+                    TEST_e2c8_MSG_CNT);
+
+    g_test_e2c8.r_buf = ev_buf_make(&g_test_e2c8.r_seq, sizeof(size_t));
+    ASSERT_EQ_INT(ev_udp_recv(g_test_e2c8.server, &g_test_e2c8.r_buf, 1,
+                              _test_e2c8_on_recv, NULL),
+                  0);
+
+    ASSERT_EQ_INT(ev_loop_run(g_test_e2c8.loop, EV_LOOP_MODE_DEFAULT,
+                              EV_INFINITE_TIMEOUT),
+                  0);
+    ASSERT_EQ_SIZE(g_test_e2c8.cnt_send, TEST_e2c8_MSG_CNT - 1);
+    ASSERT_EQ_SIZE(g_test_e2c8.cnt_send_err, 1);
+    ASSERT_EQ_SIZE(g_test_e2c8.cnt_recv, TEST_e2c8_MSG_CNT - 1);
+}
@@ -1,6 +1,6 @@
-#include "__init__.h"
-
-void register_types(void)
-{
-    test_register_ssize_t();
-}
+#include "__init__.h"
+
+void register_types(void)
+{
+    test_register_ssize_t();
+}
@@ -1,15 +1,15 @@
-#ifndef __TEST_TYPE_INIT_H__
-#define __TEST_TYPE_INIT_H__
-
-#include "ssize_t.h"
-
-#ifdef __cplusplus
-extern "C" {
-#endif
-
-void register_types(void);
-
-#ifdef __cplusplus
-}
-#endif
-#endif
+#ifndef __TEST_TYPE_INIT_H__
+#define __TEST_TYPE_INIT_H__
+
+#include "ssize_t.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void register_types(void);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
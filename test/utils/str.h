@@ -1,12 +1,12 @@
-#ifndef __TEST_STR_H__
-#define __TEST_STR_H__
-#ifdef __cplusplus
-extern "C" {
-#endif
-
-char* _eolcheck_strtok(char* str, const char* delim, char** saveptr);
-
-#ifdef __cplusplus
-}
-#endif
-#endif
+#ifndef __TEST_STR_H__
+#define __TEST_STR_H__
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+char* _eolcheck_strtok(char* str, const char* delim, char** saveptr);
+
+#ifdef __cplusplus
+}
+#endif
+#endif